@@ -67,13 +67,36 @@ namespace helios::core
         }
 
 
+        // Render loop : records and submits the frames on a dedicated thread, so rendering tick N overlaps with updating tick N + 1 on the main thread.
+        std::atomic<bool> isRendering{true};
+
+        std::thread renderThread([&]()
+        {
+            MSG renderThreadMessage{};
+            while (isRendering.load(std::memory_order_acquire))
+            {
+                // Windows created from the render thread (i.e ImGui platform windows) receive their messages on this thread.
+                while (::PeekMessageW(&renderThreadMessage, nullptr, 0, 0, PM_REMOVE))
+                {
+                    ::TranslateMessage(&renderThreadMessage);
+                    ::DispatchMessageW(&renderThreadMessage);
+                }
+
+                engine->OnRender();
+            }
+        });
+
         // Main game loop
         bool quitLoop{false};
 
+        const HANDLE updateConsumedEvent = engine->GetUpdateConsumedEvent();
+
         MSG message{};
         while (!quitLoop)
         {
-            sTimer.Tick();
+            // Sleep until either a message arrives or the render thread has picked up the previous update. Messages keep being processed while waiting,
+            // as the render thread may send messages to the window (i.e when presenting / resizing the swap chain).
+            const DWORD waitResult = ::MsgWaitForMultipleObjectsEx(1u, &updateConsumedEvent, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
 
             while (::PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE))
             {
@@ -91,10 +114,18 @@ namespace helios::core
                 break;
             }
 
-            engine->OnUpdate();
-            engine->OnRender();
+            if (waitResult == WAIT_OBJECT_0)
+            {
+                sTimer.Tick();
+                engine->OnUpdate();
+            }
         }
 
+        isRendering.store(false, std::memory_order_release);
+        engine->OnQuit();
+
+        renderThread.join();
+
         engine->OnDestroy();
 
         ::UnregisterClassW(WINDOW_CLASS_NAME, instance);
@@ -186,9 +217,12 @@ namespace helios::core
         Engine *engine = reinterpret_cast<Engine *>(GetWindowLongPtr(windowHandle, GWLP_USERDATA));
 
         // Handle ImGUI messages.
-        if (ImGui_ImplWin32_WndProcHandler(windowHandle, message, wParam, lParam))
         {
-            return true;
+            std::lock_guard<std::mutex> imGuiInputLockGuard(sImGuiInputMutex);
+            if (ImGui_ImplWin32_WndProcHandler(windowHandle, message, wParam, lParam))
+            {
+                return true;
+            }
         }
 
         switch (message)
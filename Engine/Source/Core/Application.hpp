@@ -38,6 +38,12 @@ namespace helios::core
             return sIsFullScreen;
         }
 
+        // ImGui's input is fed from the window procedure (main thread) while frames are built on the render thread : both are serialized with this mutex.
+        static inline std::mutex &GetImGuiInputMutex()
+        {
+            return sImGuiInputMutex;
+        }
+
     private:
         // The Application class is only accesible via its static member functions.
         Application() = default;
@@ -65,6 +71,8 @@ namespace helios::core
         static inline bool sIsFullScreen{false};
 
         static inline Timer sTimer{};
+
+        static inline std::mutex sImGuiInputMutex{};
     };
 
 } // namespace helios::core
@@ -8,5 +8,42 @@ namespace helios::core
 		mAspectRatio = static_cast<float>(config.dimensions.x) / static_cast<float>(config.dimensions.y);
 
 		helios::utility::ResourceManager::LocateAssetsDirectory();
+
+		mUpdateConsumedEvent = ::CreateEvent(NULL, FALSE, TRUE, NULL);
+		if (!mUpdateConsumedEvent)
+		{
+			ErrorMessage(L"Failed to create update consumed event");
+		}
+	}
+
+	Engine::~Engine()
+	{
+		::CloseHandle(mUpdateConsumedEvent);
+	}
+
+	void Engine::SignalUpdateConsumed()
+	{
+		::SetEvent(mUpdateConsumedEvent);
+	}
+
+	void Engine::ExecuteOnRenderThread(std::function<void()> task)
+	{
+		std::lock_guard<std::mutex> renderThreadTasksLockGuard(mRenderThreadTasksMutex);
+		mRenderThreadTasks.push_back(std::move(task));
+	}
+
+	void Engine::ExecuteRenderThreadTasks()
+	{
+		std::vector<std::function<void()>> renderThreadTasks{};
+
+		{
+			std::lock_guard<std::mutex> renderThreadTasksLockGuard(mRenderThreadTasksMutex);
+			renderThreadTasks.swap(mRenderThreadTasks);
+		}
+
+		for (std::function<void()>& task : renderThreadTasks)
+		{
+			task();
+		}
 	}
 }
\ No newline at end of file
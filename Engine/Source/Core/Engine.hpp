@@ -12,23 +12,41 @@ namespace helios::core
 
 	// The Base Engine class is passed into the Application static classes Run method.
 	// All SandBoxes / Test Environment's are to derive from the Engine class.
+	// OnInit, OnUpdate, OnDestroy and the window events (OnKeyAction / OnResize) are called from the main thread, while OnRender is called in a loop from a dedicated render thread.
+	// The update of tick N + 1 runs while the render thread records and submits tick N : the update side hands over the data required for rendering a tick (i.e a scene snapshot)
+	// and the render thread signals once it has picked it up (SignalUpdateConsumed), which lets the main thread run the next update.
 	class Engine
 	{
 	public:
 		Engine() = delete;
 		Engine(Config& config);
+		virtual ~Engine();
 
 		virtual void OnInit() = 0;
 		virtual void OnUpdate() = 0;
 		virtual void OnRender() = 0;
 		virtual void OnDestroy() = 0;
 
+		// Called from the main thread when the application quits, before waiting for the render thread to exit : OnRender must not block (i.e wait for a new update) after this.
+		virtual void OnQuit() = 0;
+
 		virtual void OnKeyAction(uint8_t keycode, bool isKeyDown) = 0;
 		virtual void OnResize() = 0;
 
 		Uint2 GetDimensions() const { return mDimensions; }
 		std::wstring GetTitle() const { return mTitle; };
 
+		// Auto reset event, signalled once the render thread has picked up the last update (initially signalled).
+		HANDLE GetUpdateConsumedEvent() const { return mUpdateConsumedEvent; }
+
+	protected:
+		void SignalUpdateConsumed();
+
+		// GPU resources are only used from the render thread, so window events (handled on the main thread) that affect them are forwarded as tasks,
+		// which the render thread executes (in order) when calling ExecuteRenderThreadTasks at the start of a frame.
+		void ExecuteOnRenderThread(std::function<void()> task);
+		void ExecuteRenderThreadTasks();
+
 	protected:
 		Uint2 mDimensions{};
 		std::wstring mTitle{};
@@ -38,5 +56,11 @@ namespace helios::core
 		uint64_t mFrameIndex{};
 
 		std::unique_ptr<gfx::Device> mDevice{};
+
+	private:
+		HANDLE mUpdateConsumedEvent{};
+
+		std::mutex mRenderThreadTasksMutex{};
+		std::vector<std::function<void()>> mRenderThreadTasks{};
 	};
 }
\ No newline at end of file
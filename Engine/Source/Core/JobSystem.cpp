@@ -0,0 +1,225 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+namespace helios::core
+{
+	static constexpr uint32_t INVALID_WORKER_INDEX = UINT32_MAX;
+
+	// Lets a thread know if it is a worker of a particular job system (and which one), so it can push to / pop from its own deque.
+	static thread_local JobSystem* tJobSystem{ nullptr };
+	static thread_local uint32_t tWorkerIndex{ INVALID_WORKER_INDEX };
+
+	JobSystem::JobSystem(uint32_t workerCount)
+	{
+		if (workerCount == 0u)
+		{
+			workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+		}
+
+		for (uint32_t i = 0; i < workerCount; ++i)
+		{
+			mWorkerQueues.push_back(std::make_unique<WorkerQueue>());
+		}
+
+		// All queues must exist before any worker starts stealing.
+		for (uint32_t i = 0; i < workerCount; ++i)
+		{
+			mWorkers.emplace_back([this, i]() { WorkerLoop(i); });
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> sleepLockGuard(mSleepMutex);
+			mIsShuttingDown.store(true);
+		}
+
+		mSleepConditionVariable.notify_all();
+
+		for (std::thread& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	JobSystem& JobSystem::Get()
+	{
+		static JobSystem jobSystem{};
+		return jobSystem;
+	}
+
+	void JobSystem::Schedule(std::function<void()> job, JobCounter* counter, JobCounter* dependency)
+	{
+		if (counter)
+		{
+			counter->mValue.fetch_add(1u, std::memory_order_acq_rel);
+		}
+
+		std::function<void()> wrappedJob = [this, job = std::move(job), counter]()
+		{
+			job();
+
+			if (counter)
+			{
+				DecrementCounter(counter);
+			}
+		};
+
+		if (dependency)
+		{
+			std::lock_guard<std::mutex> dependencyLockGuard(dependency->mMutex);
+
+			if (!dependency->IsComplete())
+			{
+				dependency->mContinuations.push_back(std::move(wrappedJob));
+				return;
+			}
+		}
+
+		Enqueue(std::move(wrappedJob));
+	}
+
+	void JobSystem::DecrementCounter(JobCounter* counter)
+	{
+		std::vector<std::function<void()>> continuations{};
+
+		{
+			// The mutex is held while decrementing, so that a thread waiting on the counter (which may destroy it right after) can synchronize with this thread (see Wait).
+			std::lock_guard<std::mutex> counterLockGuard(counter->mMutex);
+
+			if (counter->mValue.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+			{
+				continuations.swap(counter->mContinuations);
+			}
+		}
+
+		for (std::function<void()>& continuation : continuations)
+		{
+			Enqueue(std::move(continuation));
+		}
+	}
+
+	void JobSystem::Enqueue(std::function<void()> job)
+	{
+		const uint32_t queueIndex = tJobSystem == this ? tWorkerIndex : mNextQueueIndex.fetch_add(1u, std::memory_order_relaxed) % static_cast<uint32_t>(mWorkerQueues.size());
+
+		// The count is incremented before the job is published : otherwise, another thread could pop the job and decrement the count first (underflowing it).
+		mQueuedJobCount.fetch_add(1u, std::memory_order_release);
+
+		{
+			std::lock_guard<std::mutex> queueLockGuard(mWorkerQueues[queueIndex]->mutex);
+			mWorkerQueues[queueIndex]->jobs.push_back(std::move(job));
+		}
+
+		// Taking the sleep mutex ensures a worker that just found no jobs is either already waiting (and gets notified) or will see the new job count.
+		{
+			std::lock_guard<std::mutex> sleepLockGuard(mSleepMutex);
+		}
+
+		mSleepConditionVariable.notify_one();
+	}
+
+	bool JobSystem::TryExecuteJob()
+	{
+		const uint32_t queueCount = static_cast<uint32_t>(mWorkerQueues.size());
+		const bool isWorker = tJobSystem == this;
+
+		std::function<void()> job{};
+
+		// Pop from the back of the worker's own deque.
+		if (isWorker)
+		{
+			WorkerQueue& workerQueue = *mWorkerQueues[tWorkerIndex];
+
+			std::lock_guard<std::mutex> queueLockGuard(workerQueue.mutex);
+			if (!workerQueue.jobs.empty())
+			{
+				job = std::move(workerQueue.jobs.back());
+				workerQueue.jobs.pop_back();
+			}
+		}
+
+		// Steal from the front of the other deques.
+		if (!job)
+		{
+			const uint32_t startIndex = isWorker ? tWorkerIndex + 1u : mNextQueueIndex.load(std::memory_order_relaxed);
+
+			for (uint32_t i = 0; i < queueCount && !job; ++i)
+			{
+				WorkerQueue& victimQueue = *mWorkerQueues[(startIndex + i) % queueCount];
+
+				std::lock_guard<std::mutex> queueLockGuard(victimQueue.mutex);
+				if (!victimQueue.jobs.empty())
+				{
+					job = std::move(victimQueue.jobs.front());
+					victimQueue.jobs.pop_front();
+				}
+			}
+		}
+
+		if (!job)
+		{
+			return false;
+		}
+
+		mQueuedJobCount.fetch_sub(1u, std::memory_order_acq_rel);
+
+		job();
+
+		return true;
+	}
+
+	void JobSystem::WorkerLoop(uint32_t workerIndex)
+	{
+		tJobSystem = this;
+		tWorkerIndex = workerIndex;
+
+		while (true)
+		{
+			if (TryExecuteJob())
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> sleepLock(mSleepMutex);
+			mSleepConditionVariable.wait(sleepLock, [&]() { return mQueuedJobCount.load(std::memory_order_acquire) > 0u || mIsShuttingDown.load(); });
+
+			// Remaining jobs are executed before shutting down.
+			if (mIsShuttingDown.load() && mQueuedJobCount.load(std::memory_order_acquire) == 0u)
+			{
+				return;
+			}
+		}
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		while (!counter.IsComplete())
+		{
+			if (!TryExecuteJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// The thread that completed the counter may still hold the counter's mutex : wait for it to release it, so the counter can be safely destroyed after returning.
+		std::lock_guard<std::mutex> counterLockGuard(counter.mMutex);
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& function)
+	{
+		batchSize = std::max(batchSize, 1u);
+
+		JobCounter counter{};
+
+		for (uint64_t begin = 0; begin < count; begin += batchSize)
+		{
+			const uint32_t end = static_cast<uint32_t>(std::min<uint64_t>(count, begin + batchSize));
+			Schedule([&function, begin = static_cast<uint32_t>(begin), end]() { function(begin, end); }, &counter);
+		}
+
+		Wait(counter);
+	}
+}
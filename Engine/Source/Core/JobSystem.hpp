@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace helios::core
+{
+	class JobSystem;
+
+	// Counts the number of incomplete jobs associated with it. Jobs can be scheduled to start only once a counter reaches zero (see JobSystem::Schedule).
+	// A counter must outlive all the jobs that reference it : use JobSystem::Wait (rather than polling IsComplete) before destroying it.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+
+		JobCounter(const JobCounter& other) = delete;
+		JobCounter& operator=(const JobCounter& other) = delete;
+
+		bool IsComplete() const { return mValue.load(std::memory_order_acquire) == 0u; }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> mValue{};
+
+		// Jobs waiting for the counter to reach zero. Guarded by the mutex, which is also held while checking the value when adding a continuation.
+		mutable std::mutex mMutex{};
+		std::vector<std::function<void()>> mContinuations{};
+	};
+
+	// Fixed size pool of worker threads. Each worker owns a deque of jobs : the owner pushes / pops at the back (LIFO, cache friendly for nested jobs),
+	// while idle workers steal from the front of other workers' deques (FIFO, so the oldest / usually largest pieces of work are stolen first).
+	// Threads that wait on a counter execute jobs meanwhile instead of blocking, so jobs can schedule and wait on other jobs without deadlocking the pool.
+	class JobSystem
+	{
+	public:
+		// By default, one worker per hardware thread except for the main thread.
+		explicit JobSystem(uint32_t workerCount = 0u);
+		~JobSystem();
+
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem& operator=(const JobSystem& other) = delete;
+
+		// Engine wide job system, created on first use.
+		static JobSystem& Get();
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(mWorkers.size()); }
+
+		// counter (optional) is incremented immediately, and decremented once the job has executed.
+		// dependency (optional) : the job only starts once the dependency counter reaches zero.
+		void Schedule(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		// Returns a future for the result of the job. Prefer JobSystem::Wait(future) over future.wait(), so the waiting thread helps execute jobs.
+		template <typename Function>
+		auto ScheduleTask(Function&& function) -> std::future<std::invoke_result_t<Function>>;
+
+		// Executes other jobs until the counter / future is complete.
+		void Wait(const JobCounter& counter);
+
+		template <typename T>
+		void Wait(const std::future<T>& future);
+
+		// Splits [0, count) into batches of (at most) batchSize elements, executes function(begin, end) for each batch in parallel, and waits for all batches to complete.
+		void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& function);
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex mutex{};
+			std::deque<std::function<void()>> jobs{};
+		};
+
+		void WorkerLoop(uint32_t workerIndex);
+
+		// Pushes the job to the calling worker's deque (or to a worker chosen round robin for non worker threads), and wakes up a sleeping worker.
+		void Enqueue(std::function<void()> job);
+
+		// Pops a job from the calling worker's deque, or steals one from another worker. Returns false if no job was found.
+		bool TryExecuteJob();
+
+		void DecrementCounter(JobCounter* counter);
+
+	private:
+		std::vector<std::unique_ptr<WorkerQueue>> mWorkerQueues{};
+		std::vector<std::thread> mWorkers{};
+
+		std::atomic<uint32_t> mNextQueueIndex{};
+
+		// Workers sleep on the condition variable while there are no queued jobs.
+		std::atomic<uint64_t> mQueuedJobCount{};
+		std::mutex mSleepMutex{};
+		std::condition_variable mSleepConditionVariable{};
+
+		std::atomic<bool> mIsShuttingDown{};
+	};
+
+	template <typename Function>
+	auto JobSystem::ScheduleTask(Function&& function) -> std::future<std::invoke_result_t<Function>>
+	{
+		using ResultType = std::invoke_result_t<Function>;
+
+		// std::function requires the callable to be copy constructible, hence the shared packaged task.
+		std::shared_ptr<std::packaged_task<ResultType()>> task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Function>(function));
+		std::future<ResultType> future = task->get_future();
+
+		Schedule([task]() { (*task)(); });
+
+		return future;
+	}
+
+	template <typename T>
+	void JobSystem::Wait(const std::future<T>& future)
+	{
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			if (!TryExecuteJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace helios::core
+{
+	// Lock free handoff of snapshots from a single producer thread (i.e the update thread) to a single consumer thread (i.e the render thread).
+	// Snapshots are double buffered between the producer and the consumer, with a third 'ready' slot holding the latest published snapshot :
+	// publishing swaps the producer's slot with the ready slot, and acquiring swaps the consumer's slot with the ready slot (if it holds a newer snapshot).
+	// Hence, neither side ever waits for the other to finish reading / writing a snapshot, and the consumer always gets the latest published snapshot.
+	// The slots are reused, so snapshots holding containers keep their capacity across publishes.
+	template <typename T>
+	class SnapshotBuffer
+	{
+	public:
+		SnapshotBuffer() = default;
+
+		SnapshotBuffer(const SnapshotBuffer& other) = delete;
+		SnapshotBuffer& operator=(const SnapshotBuffer& other) = delete;
+
+		// Producer : the slot written into until the next call to Publish. Holds an older snapshot (not necessarily the last published one), so it has to be fully overwritten.
+		T& GetWriteSnapshot() { return mSlots[mWriteSlotIndex]; }
+
+		// Producer : makes the write snapshot available to the consumer. Returns the snapshot's sequence number (starting at 1).
+		uint64_t Publish()
+		{
+			const uint64_t sequence = ++mWriteSequence;
+			mSequences[mWriteSlotIndex] = sequence;
+
+			// Release : the snapshot's contents are visible to the consumer that acquires the slot.
+			const uint32_t previousReadySlot = mReadySlot.exchange(mWriteSlotIndex | NEW_SNAPSHOT_BIT, std::memory_order_acq_rel);
+			mWriteSlotIndex = previousReadySlot & SLOT_INDEX_MASK;
+
+			mPublishedSequence.store(sequence, std::memory_order_release);
+			mPublishedSequence.notify_one();
+
+			return sequence;
+		}
+
+		// Consumer : returns the latest published snapshot (which remains valid until the next call to Acquire), or nullptr if none has been published yet.
+		// If no snapshot was published since the last call, the previously acquired snapshot is returned again.
+		const T* Acquire()
+		{
+			if (mReadySlot.load(std::memory_order_relaxed) & NEW_SNAPSHOT_BIT)
+			{
+				const uint32_t previousReadySlot = mReadySlot.exchange(mReadSlotIndex, std::memory_order_acq_rel);
+				mReadSlotIndex = previousReadySlot & SLOT_INDEX_MASK;
+				mReadSequence = mSequences[mReadSlotIndex];
+			}
+
+			return mReadSequence != 0u ? &mSlots[mReadSlotIndex] : nullptr;
+		}
+
+		// Consumer : blocks until a snapshot newer than the last acquired one is published, or the buffer is closed (in which case false is returned).
+		bool WaitForNewSnapshot() const
+		{
+			uint64_t publishedSequence = mPublishedSequence.load(std::memory_order_acquire);
+			while (publishedSequence <= mReadSequence && !mIsClosed.load(std::memory_order_acquire))
+			{
+				mPublishedSequence.wait(publishedSequence, std::memory_order_acquire);
+				publishedSequence = mPublishedSequence.load(std::memory_order_acquire);
+			}
+
+			return !mIsClosed.load(std::memory_order_acquire);
+		}
+
+		// Can be called from any thread : wakes up the consumer if it is waiting for a new snapshot, and makes further waits return immediately.
+		void Close()
+		{
+			mIsClosed.store(true, std::memory_order_release);
+
+			// Bumping the sequence wakes up the waiting consumer (the wait only returns once the value changes).
+			mPublishedSequence.fetch_add(1u, std::memory_order_acq_rel);
+			mPublishedSequence.notify_all();
+		}
+
+		// Consumer : sequence number of the last acquired snapshot (0 if none).
+		uint64_t GetAcquiredSequence() const { return mReadSequence; }
+
+	private:
+		static constexpr uint32_t SLOT_COUNT = 3u;
+		static constexpr uint32_t SLOT_INDEX_MASK = 0x3u;
+		static constexpr uint32_t NEW_SNAPSHOT_BIT = 0x4u;
+
+		std::array<T, SLOT_COUNT> mSlots{};
+
+		// Sequence number of the snapshot held in each slot. Written by the producer before publishing the slot, read by the consumer after acquiring it.
+		std::array<uint64_t, SLOT_COUNT> mSequences{};
+
+		// Index of the ready slot, with NEW_SNAPSHOT_BIT set if it has not been acquired yet.
+		std::atomic<uint32_t> mReadySlot{ 2u };
+
+		std::atomic<uint64_t> mPublishedSequence{};
+		std::atomic<bool> mIsClosed{};
+
+		// Only accessed by the producer.
+		uint32_t mWriteSlotIndex{ 0u };
+		uint64_t mWriteSequence{};
+
+		// Only accessed by the consumer.
+		uint32_t mReadSlotIndex{ 1u };
+		uint64_t mReadSequence{};
+	};
+}
@@ -71,52 +71,73 @@ namespace helios::editor
 	{
 		if (mShowUI)
 		{
-			ImGui_ImplDX12_NewFrame();
-			ImGui_ImplWin32_NewFrame();
-			ImGui::NewFrame();
+			{
+				std::lock_guard<std::mutex> imGuiInputLockGuard(core::Application::GetImGuiInputMutex());
 
-			ImGui::DockSpaceOverViewport(ImGui::GetWindowViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+				ImGui_ImplDX12_NewFrame();
+				ImGui_ImplWin32_NewFrame();
+				ImGui::NewFrame();
+			}
 
-			// Render main menu bar
-			if (ImGui::BeginMainMenuBar())
+			// The UI edits the scene state that the update thread produces snapshots from (see Scene::mSceneMutex).
 			{
-				if (ImGui::BeginMenu("Helios Editor"))
+				std::lock_guard<std::mutex> sceneLockGuard(scene->mSceneMutex);
+
+				ImGui::DockSpaceOverViewport(ImGui::GetWindowViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+
+				// Render main menu bar
+				if (ImGui::BeginMainMenuBar())
 				{
-					ImGui::EndMenu();
+					if (ImGui::BeginMenu("Helios Editor"))
+					{
+						ImGui::EndMenu();
+					}
+
+					ImGui::EndMainMenuBar();
 				}
 
-				ImGui::EndMainMenuBar();
-			}
+				ImGui::ShowMetricsWindow();
+
+				// Set clear color & other scene properties.
+				RendererProperties(clearColor, postProcessBufferData);
 
-			ImGui::ShowMetricsWindow();
+				// Render camera UI.
+				RenderSceneProperties(scene);
 
-			// Set clear color & other scene properties.
-			RendererProperties(clearColor, postProcessBufferData);
+				// Render scene hierarchy UI.
+				RenderSceneHierarchy(scene->mModels);
 
-			// Render camera UI.
-			RenderSceneProperties(scene);
+				// Render Light property menu.
+				RenderLightProperties(scene->mLights);
 
-			// Render scene hierarchy UI.
-			RenderSceneHierarchy(scene->mModels);
+				// Render deferred pass rt's.
+				RenderDeferredGPass(device, deferredPassRTs);
 
-			// Render Light property menu.
-			RenderLightProperties(scene->mLights);
+				// Render shadow pass data.
+				RenderShadowPass(device, shadowPass);
 
-			// Render deferred pass rt's.
-			RenderDeferredGPass(device, deferredPassRTs);
+				// Render scene viewport (After all post processing).
+				// All add model to model list if a path is dragged into scene viewport.
+				RenderSceneViewport(device, renderTarget, scene);
 
-			// Render shadow pass data.
-			RenderShadowPass(device, shadowPass);
+				// Render content browser panel.
+				RenderContentBrowser();
 
-			// Render scene viewport (After all post processing).
-			// All add model to model list if a path is dragged into scene viewport.
-			RenderSceneViewport(device, renderTarget, scene);
+				// Render Log Window.
+				RenderLogWindow();
 
-			// Render content browser panel.
-			RenderContentBrowser();
+				// Render GPU memory statistics.
+				RenderMemoryStatistics(device);
 
-			// Render Log Window.
-			RenderLogWindow();
+				RenderFrameStatistics(device);
+			}
+
+			// The dropped model is loaded without holding the scene lock (which would stall the update thread for the whole load), and is only added to the scene under it.
+			if (mDroppedModelCreationDesc.has_value())
+			{
+				scene->AddModel(device, *mDroppedModelCreationDesc);
+				mDroppedModelCreationDesc.reset();
+			}
 
 			// Render and update handles.
 			ImGui::Render();
@@ -135,9 +156,18 @@ namespace helios::editor
 	{
 		ImGui::Begin("Scene Hierarchy");
 		
-		for (auto& model : models)
+		for (uint32_t modelIndex = 0u; modelIndex < models.size(); ++modelIndex)
 		{
-			if (ImGui::TreeNode(WstringToString(model->GetName()).c_str()))
+			const std::unique_ptr<helios::scene::Model>& model = models[modelIndex];
+
+			ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_None;
+			if (mSelectedModelIndex == modelIndex)
+			{
+				ImGui::SetNextItemOpen(true);
+				treeNodeFlags |= ImGuiTreeNodeFlags_Selected;
+			}
+
+			if (ImGui::TreeNodeEx(WstringToString(model->GetName()).c_str(), treeNodeFlags))
 			{
 				// Scale uniformally along all axises.
 				ImGui::SliderFloat("Scale", &model->GetTransform()->data.scale.x, 0.1f, 15.0f);
@@ -178,6 +208,40 @@ namespace helios::editor
 			ImGui::TreePop();
 		}
 
+		if (ImGui::TreeNode("Draw Recording"))
+		{
+			// The main thread records draws along with the job system's workers.
+			int recordingThreadCount = static_cast<int>(scene->mRecordingThreadCount);
+			ImGui::SliderInt("Recording Threads", &recordingThreadCount, 1, static_cast<int>(core::JobSystem::Get().GetWorkerCount() + 1u));
+			scene->mRecordingThreadCount = static_cast<uint32_t>(recordingThreadCount);
+
+			ImGui::Text("Mesh Draws : %u", scene->GetMeshDrawCount());
+			ImGui::Text("Chunks Per Pass : %u", scene->GetRecordingChunkCount());
+			ImGui::Text("CPU Record Time : %.3f ms", scene->mRecordingCpuTime);
+
+			ImGui::Checkbox("Draw Sorting", &scene->mVisibility.mDrawSortingEnabled);
+			ImGui::Text("Material Changes : %u", scene->mVisibility.mDrawSortStateChanges.materialChangeCount);
+
+			ImGui::Checkbox("Frustum Culling", &scene->mVisibility.mFrustumCullingEnabled);
+			ImGui::Text("Visible Mesh Draws : %u", scene->mVisibility.mVisibleMeshDrawCount);
+
+			ImGui::Checkbox("Occlusion Culling", &scene->mVisibility.mOcclusionCullingEnabled);
+			ImGui::Text("Occluded Mesh Draws : %u (%u occluder triangles)", scene->mVisibility.mOccludedMeshDrawCount, scene->mVisibility.mOccluderTriangleCount);
+
+			const scene::ShadowCasterCullingStatistics& shadowCasterCullingStatistics = scene->mVisibility.mShadowCasterCullingStatistics;
+			ImGui::Checkbox("Shadow Caster Culling", &scene->mVisibility.mShadowCasterCullingEnabled);
+			ImGui::Text("Shadow Casters : %u / %u (%u outside the light frustum, %u without visible receivers)", shadowCasterCullingStatistics.visibleCount,
+				shadowCasterCullingStatistics.casterCount, shadowCasterCullingStatistics.outsideLightFrustumCount, shadowCasterCullingStatistics.noVisibleReceiverCount);
+
+			const scene::BoundingVolumeHierarchy& meshBvh = scene->mVisibility.GetMeshBvh();
+			ImGui::Text("Mesh BVH : %u nodes | SAH cost %.2f (%.2f when built) | %u nodes refit | %u builds", meshBvh.GetNodeCount(), meshBvh.GetSahCost(),
+				meshBvh.GetBuildSahCost(), scene->mVisibility.mMeshBvhRefitNodeCount, scene->mVisibility.mMeshBvhBuildCount);
+
+			ImGui::Text("CPU Culling Time : %.3f ms", scene->mVisibility.mCullingCpuTime);
+
+			ImGui::TreePop();
+		}
+
 	
 
 		ImGui::End();
@@ -322,6 +386,188 @@ namespace helios::editor
 	}
 	*/
 
+	void Editor::RenderFrameStatistics(gfx::Device* device) const
+	{
+		ImGui::Begin("Frame Statistics");
+
+		int maxFrameLatency = static_cast<int>(device->GetMaxFrameLatency());
+		ImGui::SliderInt("Max Frame Latency", &maxFrameLatency, 1, static_cast<int>(gfx::Device::NUMBER_OF_FRAMES - 1u));
+		device->SetMaxFrameLatency(static_cast<uint32_t>(maxFrameLatency));
+
+		const gfx::FrameStatistics& frameStatistics = device->GetFrameStatistics();
+
+		ImGui::Text("Frame : %llu", device->GetFrameNumber());
+		ImGui::Text("CPU Frame Time : %.3f ms", frameStatistics.cpuFrameTime);
+		ImGui::Text("GPU Wait Time : %.3f ms", frameStatistics.gpuWaitTime);
+		ImGui::Text("CPU / GPU Overlap : %.1f%%", frameStatistics.GetCpuGpuOverlap() * 100.0);
+		ImGui::Text("Frames In Flight : %u", frameStatistics.framesInFlight);
+
+		if (ImGui::TreeNode("Queue Scheduling"))
+		{
+			const gfx::QueueSchedulerStatistics queueSchedulerStatistics = device->GetQueueSchedulerStatistics();
+
+			ImGui::Text("Submissions : %llu", queueSchedulerStatistics.submissionCount);
+			ImGui::Text("GPU Queue Waits : %llu", queueSchedulerStatistics.waitCount);
+			ImGui::Text("Skipped Queue Waits : %llu", queueSchedulerStatistics.skippedWaitCount);
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Command Streams"))
+		{
+			const gfx::CommandStreamStatistics& commandStreamStatistics = frameStatistics.commandStreamStatistics;
+
+			ImGui::Text("Recorded Commands : %llu", commandStreamStatistics.recordedCommandCount);
+			ImGui::Text("Filtered Commands : %llu", commandStreamStatistics.filteredCommandCount);
+			ImGui::Text("Recorded Size : %.1f KB", static_cast<float>(commandStreamStatistics.recordedByteSize) / 1024.0f);
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Resource Barriers"))
+		{
+			const gfx::ResourceBarrierStatistics& resourceBarrierStatistics = frameStatistics.commandStreamStatistics.resourceBarrierStatistics;
+
+			ImGui::Text("Transitions : %llu", resourceBarrierStatistics.transitionCount);
+			ImGui::Text("Split Transitions : %llu", resourceBarrierStatistics.splitTransitionCount);
+			ImGui::Text("Resolved Transitions : %llu", resourceBarrierStatistics.resolvedTransitionCount);
+			ImGui::Text("UAV Barriers : %llu", resourceBarrierStatistics.uavBarrierCount);
+			ImGui::Text("Aliasing Barriers : %llu", resourceBarrierStatistics.aliasingBarrierCount);
+			ImGui::Text("Batches : %llu", resourceBarrierStatistics.barrierBatchCount);
+
+			// Transitions that were not recorded, or recorded from the tracked state instead of the one given by the caller.
+			ImGui::Text("Redundant Transitions : %llu", resourceBarrierStatistics.redundantTransitionCount);
+			ImGui::Text("Merged Transitions : %llu", resourceBarrierStatistics.mergedTransitionCount);
+			ImGui::Text("Corrected Transitions : %llu", resourceBarrierStatistics.correctedTransitionCount);
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Mip Map Generation"))
+		{
+			const gfx::MipMapGenerationStatistics mipMapGenerationStatistics = device->GetMipMapGenerator()->GetStatistics();
+
+			ImGui::Text("Textures : %llu", mipMapGenerationStatistics.textureCount);
+			ImGui::Text("Dispatches : %llu", mipMapGenerationStatistics.dispatchCount);
+			ImGui::Text("Single Pass Dispatches : %llu", mipMapGenerationStatistics.singlePassDispatchCount);
+
+			// Each dispatch used to be executed and flushed separately.
+			ImGui::Text("Submissions : %llu", mipMapGenerationStatistics.submissionCount);
+			ImGui::Text("Flushes Saved : %llu", mipMapGenerationStatistics.dispatchCount - mipMapGenerationStatistics.submissionCount);
+
+			ImGui::TreePop();
+		}
+
+		ImGui::End();
+	}
+
+	void Editor::RenderMemoryStatistics(gfx::Device* device) const
+	{
+		static constexpr float BYTES_TO_MB = 1.0f / (1024.0f * 1024.0f);
+
+		// Statistics are only calculated when the window is visible, as querying the block statistics is not cheap.
+		if (!ImGui::Begin("GPU Memory Statistics"))
+		{
+			ImGui::End();
+			return;
+		}
+
+		const gfx::MemoryStatisticsSnapshot snapshot = device->GetMemoryAllocator()->GetMemoryStatistics();
+
+		if (ImGui::Button("Dump to JSON"))
+		{
+			const std::wstring jsonFilePath = utility::ResourceManager::GetProjectRootDirectory() + L"MemoryStatistics.json";
+
+			std::ofstream jsonFile(WstringToString(jsonFilePath));
+			jsonFile << gfx::MemoryStatisticsSnapshotToJson(snapshot);
+
+			core::LogMessage(L"Dumped memory statistics to : " + jsonFilePath, core::LogMessageTypes::Info);
+		}
+
+		ImGui::Separator();
+
+		const auto renderBudget = [&](const char* label, const gfx::MemoryBudget& budget)
+		{
+			const float usage = budget.budgetInBytes == 0u ? 0.0f : static_cast<float>(budget.usageInBytes) / static_cast<float>(budget.budgetInBytes);
+			const std::string overlay = std::to_string(static_cast<uint32_t>(budget.usageInBytes * BYTES_TO_MB)) + " / " + std::to_string(static_cast<uint32_t>(budget.budgetInBytes * BYTES_TO_MB)) + " MB";
+
+			ImGui::Text("%s", label);
+			ImGui::ProgressBar(usage, ImVec2(-1.0f, 0.0f), overlay.c_str());
+		};
+
+		renderBudget("Local (Video) Memory Budget", snapshot.localBudget);
+		renderBudget("Non Local (System) Memory Budget", snapshot.nonLocalBudget);
+
+		ImGui::Separator();
+
+		ImGui::Text("Blocks : %u (%.2f MB)", snapshot.blockStatistics.blockCount, snapshot.blockStatistics.blockBytes * BYTES_TO_MB);
+		ImGui::Text("Allocations : %u (%.2f MB)", snapshot.blockStatistics.allocationCount, snapshot.blockStatistics.allocationBytes * BYTES_TO_MB);
+		ImGui::Text("Unused Ranges : %u, Fragmentation : %.1f%%", snapshot.blockStatistics.unusedRangeCount, snapshot.blockStatistics.GetFragmentation() * 100.0);
+
+		ImGui::Separator();
+
+		if (ImGui::TreeNodeEx("Categories", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			for (uint32_t categoryIndex : std::views::iota(0u, static_cast<uint32_t>(gfx::MemoryCategory::Count)))
+			{
+				ImGui::Text("%-16s %4u allocations %10.2f MB", gfx::MemoryCategoryToString(static_cast<gfx::MemoryCategory>(categoryIndex)), snapshot.categoryAllocationCounts[categoryIndex],
+					snapshot.categorySizesInBytes[categoryIndex] * BYTES_TO_MB);
+			}
+
+			ImGui::Text("%-16s %4u allocations %10.2f MB", "Total", snapshot.GetTotalAllocationCount(), snapshot.GetTotalSizeInBytes() * BYTES_TO_MB);
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Residency"))
+		{
+			const gfx::ResidencyStatistics residencyStatistics = device->GetResidencyManager()->GetStatistics();
+
+			ImGui::Text("Resident : %u / %u resources (%.2f MB), Evicted : %.2f MB", residencyStatistics.residentResourceCount, residencyStatistics.resourceCount,
+				residencyStatistics.residentBytes * BYTES_TO_MB, residencyStatistics.evictedBytes * BYTES_TO_MB);
+			ImGui::Text("Last Frame : %u evictions, %u made resident", residencyStatistics.frameEvictionCount, residencyStatistics.frameMakeResidentCount);
+			ImGui::Text("Total : %llu evictions (%.2f MB), %llu made resident (%.2f MB)", residencyStatistics.totalEvictionCount, residencyStatistics.totalEvictedBytes * BYTES_TO_MB,
+				residencyStatistics.totalMakeResidentCount, residencyStatistics.totalMadeResidentBytes * BYTES_TO_MB);
+			ImGui::Text("Churn : %llu (%.2f MB), Churn Ratio : %.1f%%", residencyStatistics.churnCount, residencyStatistics.churnBytes * BYTES_TO_MB, residencyStatistics.GetChurnRatio() * 100.0);
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Command Allocators"))
+		{
+			const std::array<std::pair<const char*, gfx::CommandQueue*>, 3u> commandQueues
+			{
+				std::pair{ "Graphics", device->GetGraphicsCommandQueue() },
+				std::pair{ "Compute", device->GetComputeCommandQueue() },
+				std::pair{ "Copy", device->GetCopyCommandQueue() },
+			};
+
+			for (const auto& [name, commandQueue] : commandQueues)
+			{
+				const gfx::CommandAllocatorPoolStatistics commandAllocatorPoolStatistics = commandQueue->GetCommandAllocatorPoolStatistics();
+
+				ImGui::Text("%-8s : %llu allocators in %llu batches (max %llu per batch, %llu retired), %llu batch resets, %llu unsubmitted, %llu command lists", name,
+					commandAllocatorPoolStatistics.allocatorCount, commandAllocatorPoolStatistics.batchCount, commandAllocatorPoolStatistics.maxAllocatorsPerBatch,
+					commandAllocatorPoolStatistics.retiredBatchCount, commandAllocatorPoolStatistics.batchResetCount, commandAllocatorPoolStatistics.unsubmittedAllocatorCount,
+					commandQueue->GetCommandListCount());
+			}
+
+			ImGui::TreePop();
+		}
+
+		if (ImGui::TreeNode("Resources"))
+		{
+			for (const gfx::MemoryResourceRecord& resource : snapshot.resources)
+			{
+				ImGui::Text("%10.2f MB  %-16s %s", resource.sizeInBytes * BYTES_TO_MB, gfx::MemoryCategoryToString(resource.category), resource.name.c_str());
+			}
+
+			ImGui::TreePop();
+		}
+
+		ImGui::End();
+	}
+
 	void Editor::RenderLogWindow()
 	{
 		ImGui::Begin("Console Log");
@@ -376,13 +622,22 @@ namespace helios::editor
 		ImGui::End();
 	};
 
-	void Editor::RenderSceneViewport(const gfx::Device* device, const gfx::RenderTarget* renderTarget, scene::Scene* scene) const
+	void Editor::RenderSceneViewport(const gfx::Device* device, const gfx::RenderTarget* renderTarget, scene::Scene* scene)
 	{
 		const gfx::DescriptorHandle& rtvSrvHandle = device->GetSrvCbvUavDescriptor()->GetDescriptorHandleFromIndex(gfx::RenderTarget::GetRenderTextureSRVIndex(renderTarget));
 
 		ImGui::Begin("View Port");
 		ImGui::Image((ImTextureID)(rtvSrvHandle.cpuDescriptorHandle.ptr), ImGui::GetWindowViewport()->WorkSize);
 
+		if (ImGui::IsItemClicked(ImGuiMouseButton_Left))
+		{
+			const ImVec2 imageMin = ImGui::GetItemRectMin();
+			const ImVec2 imageSize = ImGui::GetItemRectSize();
+			const ImVec2 mousePosition = ImGui::GetMousePos();
+
+			mSelectedModelIndex = scene->PickModel((mousePosition.x - imageMin.x) / imageSize.x, (mousePosition.y - imageMin.y) / imageSize.y);
+		}
+
 		if (ImGui::BeginDragDropTarget())
 		{
 			if (const ImGuiPayload* payLoad = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ASSET_ITEM", ImGuiCond_Once))
@@ -406,7 +661,8 @@ namespace helios::editor
 						.modelName = modelPathWStr.substr(lastSlash + 1, lastDot - lastSlash - 1) + std::to_wstring(modelNumber++),
 					};
 
-					scene->AddModel(device, modelCreationDesc);
+					// Loaded by Render once the scene lock is released.
+					mDroppedModelCreationDesc = modelCreationDesc;
 				}
 			}
 
@@ -46,8 +46,15 @@ namespace helios::editor
 
 		void RenderLogWindow();
 
-		// Accepts the pay load (accepts data which is dragged in from content browser to the scene view port, and loads the model (if path belongs to a .gltf file).
-		void RenderSceneViewport(const gfx::Device* device, const gfx::RenderTarget* renderTarget, scene::Scene* scene) const;
+		// Displays per category / per resource GPU memory usage, budgets and fragmentation. Statistics can be dumped to a JSON file on demand.
+		void RenderMemoryStatistics(gfx::Device* device) const;
+
+		// Displays the CPU frame time, the time spent waiting on the GPU and the number of frames in flight, and allows tuning the max frame latency.
+		void RenderFrameStatistics(gfx::Device* device) const;
+
+		// Accepts the pay load (accepts data which is dragged in from content browser to the scene view port, and queues the model for loading (if path belongs to a .gltf file).
+		// Clicking on the viewport selects the model under the cursor (see Scene::PickModel).
+		void RenderSceneViewport(const gfx::Device* device, const gfx::RenderTarget* renderTarget, scene::Scene* scene);
 
 		// Handle drag and drop of models into viewport at run time.
 		void RenderContentBrowser();
@@ -62,5 +69,11 @@ namespace helios::editor
 		// Path to .ini file.
 		std::string mIniFilePath{};
 
+		// Model picked in the scene viewport, whose node is opened and highlighted in the scene hierarchy.
+		std::optional<uint32_t> mSelectedModelIndex{};
+
+		// Model dropped into the scene viewport, loaded by Render after the scene state is edited.
+		std::optional<scene::ModelCreationDesc> mDroppedModelCreationDesc{};
+
 	};
 }
\ No newline at end of file
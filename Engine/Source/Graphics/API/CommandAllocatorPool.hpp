@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace helios::gfx
+{
+	struct CommandAllocatorPoolStatistics
+	{
+		uint64_t allocatorCount{};
+		uint64_t batchCount{};
+
+		// Number of times a retired batch was reused (all its allocators being reset at once).
+		uint64_t batchResetCount{};
+
+		// Largest number of allocators used by a single batch.
+		uint64_t maxAllocatorsPerBatch{};
+
+		// Allocators whose command lists are not submitted yet, and batches waiting for their fence value to complete.
+		uint64_t unsubmittedAllocatorCount{};
+		uint64_t retiredBatchCount{};
+	};
+
+	// Command allocators cannot be reset while the command lists allocated from them are in flight. Rather than tracking a fence value per allocator,
+	// each thread acquires allocators from its own open 'batch', which holds the allocators the thread used since the batch was last retired (i.e in a frame).
+	// RetireBatches retires the open batches with the largest fence value submitted so far, and a retired batch is reused (and all its allocators are reset
+	// at once) when its fence value completes.
+	// Submitting only updates a pool wide count (of the command lists not submitted yet) and fence value, so command lists can be acquired, recorded and
+	// submitted from any thread : the batches are only retired while no command list is waiting for submission, so the fence value covers all of them.
+	template <typename Allocator>
+	class CommandAllocatorPool
+	{
+	public:
+		CommandAllocatorPool(std::function<Allocator()> createFunction, std::function<void(Allocator&)> resetFunction)
+			: mCreateFunction(std::move(createFunction)), mResetFunction(std::move(resetFunction))
+		{
+		}
+
+		CommandAllocatorPool(const CommandAllocatorPool& other) = delete;
+		CommandAllocatorPool& operator=(const CommandAllocatorPool& other) = delete;
+
+		// completedFenceValue is used to check if a retired batch can be reused. Allocator is expected to be a (ref counted) handle, hence returned by value.
+		// The command list of the allocator must be submitted (see Submit), else the batches are never retired.
+		Allocator Acquire(uint64_t completedFenceValue)
+		{
+			ThreadAllocators& threadAllocators = GetThreadAllocators();
+			AllocatorBatch& openBatch = threadAllocators.openBatch;
+
+			// Note : Counted under the thread's lock, so RetireBatches never sees the count at 0 while the allocator is in the open batch but not counted yet.
+			std::lock_guard<std::mutex> lockGuard(threadAllocators.mutex);
+			mUnsubmittedCount.fetch_add(1u, std::memory_order_acq_rel);
+
+			if (openBatch.usedCount == 0u && !threadAllocators.retiredBatches.empty() && threadAllocators.retiredBatches.front().fenceValue <= completedFenceValue)
+			{
+				openBatch = std::move(threadAllocators.retiredBatches.front());
+				threadAllocators.retiredBatches.pop_front();
+
+				for (Allocator& allocator : openBatch.allocators)
+				{
+					mResetFunction(allocator);
+				}
+
+				openBatch.fenceValue = 0u;
+				mBatchResetCount.fetch_add(1u, std::memory_order_relaxed);
+			}
+			else if (openBatch.usedCount == 0u && openBatch.allocators.empty())
+			{
+				mBatchCount.fetch_add(1u, std::memory_order_relaxed);
+			}
+
+			if (openBatch.usedCount == openBatch.allocators.size())
+			{
+				openBatch.allocators.push_back(mCreateFunction());
+				mAllocatorCount.fetch_add(1u, std::memory_order_relaxed);
+
+				uint64_t maxAllocatorsPerBatch = mMaxAllocatorsPerBatch.load(std::memory_order_relaxed);
+				while (openBatch.allocators.size() > maxAllocatorsPerBatch && !mMaxAllocatorsPerBatch.compare_exchange_weak(maxAllocatorsPerBatch, openBatch.allocators.size(), std::memory_order_relaxed))
+				{
+				}
+			}
+
+			return openBatch.allocators[openBatch.usedCount++];
+		}
+
+		// To be called (from any thread) after submitting commandListCount command lists whose allocators were acquired from the pool, with the fence value
+		// signalled after the submission.
+		void Submit(uint32_t commandListCount, uint64_t fenceValue)
+		{
+			uint64_t submittedFenceValue = mSubmittedFenceValue.load(std::memory_order_relaxed);
+			while (fenceValue > submittedFenceValue && !mSubmittedFenceValue.compare_exchange_weak(submittedFenceValue, fenceValue, std::memory_order_relaxed))
+			{
+			}
+
+			// Note : Released after the fence value, so RetireBatches sees the fence value of every submission it sees the count of.
+			mUnsubmittedCount.fetch_sub(commandListCount, std::memory_order_acq_rel);
+		}
+
+		// Retires the open batch of every thread with the largest fence value submitted so far, if all the command lists acquired from the pool have been
+		// submitted. To be called at the end of every frame (so the batches hold the allocators of a frame), and after waiting for a submission (i.e of an
+		// upload, so the allocators are reused before the next frame). The batches stay open (until the next call) while a command list is not submitted yet.
+		void RetireBatches()
+		{
+			std::shared_lock<std::shared_mutex> sharedLock(mThreadAllocatorsMutex);
+
+			for (auto& [threadId, threadAllocators] : mThreadAllocators)
+			{
+				std::lock_guard<std::mutex> lockGuard(threadAllocators->mutex);
+
+				AllocatorBatch& openBatch = threadAllocators->openBatch;
+				if (openBatch.usedCount == 0u || mUnsubmittedCount.load(std::memory_order_acquire) != 0u)
+				{
+					continue;
+				}
+
+				// The fence values are non decreasing, so only the front of the retired batches has to be checked.
+				openBatch.usedCount = 0u;
+				openBatch.fenceValue = mSubmittedFenceValue.load(std::memory_order_relaxed);
+				threadAllocators->retiredBatches.push_back(std::move(openBatch));
+				openBatch = {};
+			}
+		}
+
+		CommandAllocatorPoolStatistics GetStatistics() const
+		{
+			uint64_t retiredBatchCount{};
+
+			{
+				std::shared_lock<std::shared_mutex> sharedLock(mThreadAllocatorsMutex);
+				for (const auto& [threadId, threadAllocators] : mThreadAllocators)
+				{
+					std::lock_guard<std::mutex> lockGuard(threadAllocators->mutex);
+					retiredBatchCount += threadAllocators->retiredBatches.size();
+				}
+			}
+
+			return CommandAllocatorPoolStatistics
+			{
+				.allocatorCount = mAllocatorCount.load(std::memory_order_relaxed),
+				.batchCount = mBatchCount.load(std::memory_order_relaxed),
+				.batchResetCount = mBatchResetCount.load(std::memory_order_relaxed),
+				.maxAllocatorsPerBatch = mMaxAllocatorsPerBatch.load(std::memory_order_relaxed),
+				.unsubmittedAllocatorCount = mUnsubmittedCount.load(std::memory_order_relaxed),
+				.retiredBatchCount = retiredBatchCount,
+			};
+		}
+
+	private:
+		struct AllocatorBatch
+		{
+			std::vector<Allocator> allocators{};
+			uint32_t usedCount{};
+
+			// The largest fence value submitted when the batch was retired.
+			uint64_t fenceValue{};
+		};
+
+		// Only accessed by the owning thread, and by RetireBatches / GetStatistics, so the lock is hardly ever contended.
+		struct ThreadAllocators
+		{
+			mutable std::mutex mutex{};
+
+			AllocatorBatch openBatch{};
+
+			// Retired in fence value order, so only the front has to be checked.
+			std::deque<AllocatorBatch> retiredBatches{};
+		};
+
+		ThreadAllocators& GetThreadAllocators()
+		{
+			const std::thread::id threadId = std::this_thread::get_id();
+
+			{
+				std::shared_lock<std::shared_mutex> sharedLock(mThreadAllocatorsMutex);
+				if (auto it = mThreadAllocators.find(threadId); it != mThreadAllocators.end())
+				{
+					return *it->second;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> uniqueLock(mThreadAllocatorsMutex);
+			std::unique_ptr<ThreadAllocators>& threadAllocators = mThreadAllocators[threadId];
+			if (!threadAllocators)
+			{
+				threadAllocators = std::make_unique<ThreadAllocators>();
+			}
+
+			return *threadAllocators;
+		}
+
+	private:
+		std::function<Allocator()> mCreateFunction{};
+		std::function<void(Allocator&)> mResetFunction{};
+
+		// The thread allocators are heap allocated, so references to them remain valid when the map is rehashed.
+		mutable std::shared_mutex mThreadAllocatorsMutex{};
+		std::unordered_map<std::thread::id, std::unique_ptr<ThreadAllocators>> mThreadAllocators{};
+
+		// Command lists acquired but not submitted yet, and the largest fence value they were submitted with.
+		std::atomic<uint32_t> mUnsubmittedCount{};
+		std::atomic<uint64_t> mSubmittedFenceValue{};
+
+		std::atomic<uint64_t> mAllocatorCount{};
+		std::atomic<uint64_t> mBatchCount{};
+		std::atomic<uint64_t> mBatchResetCount{};
+		std::atomic<uint64_t> mMaxAllocatorsPerBatch{};
+	};
+}
@@ -3,7 +3,7 @@
 namespace helios::gfx
 {
 	CommandQueue::CommandQueue(ID3D12Device5* const device, D3D12_COMMAND_LIST_TYPE commandListType, std::wstring_view commandQueueName) 
-		: mCommandListType(commandListType)
+		: mCommandListType(commandListType), mCommandAllocatorPool([this]() { return CreateCommandAllocator(); }, [](wrl::ComPtr<ID3D12CommandAllocator>& commandAllocator) { ThrowIfFailed(commandAllocator->Reset()); })
 	{
 		mDevice = device;
 
@@ -20,7 +20,7 @@ namespace helios::gfx
 		mCommandQueue->SetName(commandQueueName.data());
 
 		// Create command queue sync objects.
-		ThrowIfFailed(mDevice->CreateFence(mFenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+		ThrowIfFailed(mDevice->CreateFence(mFenceValue.load(), D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
 		std::wstring fenceName = commandQueueName.data() + std::wstring(L" Fence");
 		mFence->SetName(fenceName.data());
 
@@ -34,48 +34,23 @@ namespace helios::gfx
 	
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> CommandQueue::GetCommandList(const gfx::PipelineState* pipelineState)
 	{
-		// Check if there is command allocator (that allocates the list) is not in flight -> if so it can be reused.
-		// Other wise a new command allocator has to be created.
-
-		wrl::ComPtr<ID3D12GraphicsCommandList1> commandList;
-		wrl::ComPtr<ID3D12CommandAllocator> commandAllocator;
-
-		if (!mCommandAllocatorQueue.empty() && IsFenceComplete(mCommandAllocatorQueue.front().fenceValue))
-		{
-			commandAllocator = mCommandAllocatorQueue.front().commandAllocator;
-			mCommandAllocatorQueue.pop();
-
-			ThrowIfFailed(commandAllocator->Reset());
-		}
-		else
-		{
-			commandAllocator = CreateCommandAllocator();
-		}
-
-		// Check if there are any command list in the queue, hence create a new one.
-		if (!mCommandListQueue.empty())
+		// Reuse a command list from the free list if possible, other wise create a new one.
+		wrl::ComPtr<ID3D12GraphicsCommandList1> commandList{};
+		if (std::optional<wrl::ComPtr<ID3D12GraphicsCommandList1>> freeCommandList = mCommandListFreeList.Pop(); freeCommandList.has_value())
 		{
-			commandList = mCommandListQueue.front();
-			mCommandListQueue.pop();
-
-			if (pipelineState)
-			{
-				ThrowIfFailed(commandList->Reset(commandAllocator.Get(), pipelineState->pipelineStateObject.Get()));
-			}
-			else
-			{
-				ThrowIfFailed(commandList->Reset(commandAllocator.Get(), nullptr));
-			}
+			commandList = std::move(*freeCommandList);
 		}
 		else
 		{
-			commandList = CreateCommandList(commandAllocator.Get(), pipelineState);
+			commandList = CreateCommandList();
+			mCommandListCount.fetch_add(1u, std::memory_order_relaxed);
 		}
 
-		// Create association between the command list and allocator so we can find out which command allocater the list was
-		// allocated from.
+		// The allocator pool only hands out allocators that are not in flight (and have been reset). The allocator is taken from the open batch of this thread,
+		// which is retired at the end of the frame (see EndFrame).
+		wrl::ComPtr<ID3D12CommandAllocator> commandAllocator = mCommandAllocatorPool.Acquire(GetCompletedFenceValue());
 
-		ThrowIfFailed(commandList->SetPrivateDataInterface(__uuidof(ID3D12CommandAllocator), commandAllocator.Get()));
+		ThrowIfFailed(commandList->Reset(commandAllocator.Get(), pipelineState ? pipelineState->pipelineStateObject.Get() : nullptr));
 
 		return commandList;
 	}
@@ -93,21 +68,21 @@ namespace helios::gfx
 			commandListVec.push_back(list);
 		}
 
-		mCommandQueue->ExecuteCommandLists(static_cast<UINT>(commandListVec.size()), commandListVec.data());
-		uint64_t fenceValue = Signal();
-
-		ID3D12CommandAllocator* commandAllocator{ nullptr };
-		UINT dataSize = sizeof(ID3D12CommandAllocator);
+		uint64_t fenceValue{};
 
-		for (auto& list : commandList)
 		{
-			ThrowIfFailed(list->GetPrivateData(__uuidof(ID3D12CommandAllocator), &dataSize, &commandAllocator));
+			std::lock_guard<std::mutex> submissionLockGuard(mSubmissionMutex);
 
+			mCommandQueue->ExecuteCommandLists(static_cast<UINT>(commandListVec.size()), commandListVec.data());
+			fenceValue = SignalFence();
+		}
 
-			mCommandAllocatorQueue.emplace(CommandAllocator{ .fenceValue = fenceValue, .commandAllocator = commandAllocator });
-			mCommandListQueue.emplace(list);
+		// The allocators of the command lists can be reused once the fence value of this submission completes.
+		mCommandAllocatorPool.Submit(static_cast<uint32_t>(commandList.size()), fenceValue);
 
-			commandAllocator->Release();
+		for (auto& list : commandList)
+		{
+			mCommandListFreeList.Push(list);
 		}
 
 		return fenceValue;
@@ -115,13 +90,27 @@ namespace helios::gfx
 
 	void CommandQueue::ExecuteAndFlush(ID3D12GraphicsCommandList1* commandList)
 	{
-		std::array<ID3D12GraphicsCommandList1*, 1> commandLists{ std::move(commandList) };
-		uint64_t signalValue = ExecuteCommandLists(commandLists);
-		FlushQueue();
+		std::array<ID3D12GraphicsCommandList1*, 1> commandLists{ commandList };
+		const uint64_t fenceValue = ExecuteCommandLists(commandLists);
+		WaitForFenceValue(fenceValue);
+
+		// The allocators are retired right away, so subsequent flushes (i.e of uploads while loading) reuse them rather than growing the batches.
+		mCommandAllocatorPool.RetireBatches();
+	}
+
+	void CommandQueue::EndFrame()
+	{
+		mCommandAllocatorPool.RetireBatches();
 	}
 
 	// Return fence value to for signal.
 	uint64_t CommandQueue::Signal()
+	{
+		std::lock_guard<std::mutex> submissionLockGuard(mSubmissionMutex);
+		return SignalFence();
+	}
+
+	uint64_t CommandQueue::SignalFence()
 	{
 		uint64_t fenceValueForSignal = ++mFenceValue;
 		ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), fenceValueForSignal));
@@ -138,11 +127,19 @@ namespace helios::gfx
 	{
 		if (!IsFenceComplete(fenceValue))
 		{
+			// The fence event is an auto reset event shared by all threads, so only one thread can wait on it at a time.
+			std::lock_guard<std::mutex> fenceEventLockGuard(mFenceEventMutex);
 			ThrowIfFailed(mFence->SetEventOnCompletion(fenceValue, mFenceEvent));
 			::WaitForSingleObject(mFenceEvent, static_cast<DWORD>(std::chrono::milliseconds::max().count()));
 		}
 	}
 
+	void CommandQueue::WaitOnGpu(const CommandQueue* signallingQueue, uint64_t fenceValue)
+	{
+		std::lock_guard<std::mutex> submissionLockGuard(mSubmissionMutex);
+		ThrowIfFailed(mCommandQueue->Wait(signallingQueue->mFence.Get(), fenceValue));
+	}
+
 	void CommandQueue::FlushQueue()
 	{
 		uint64_t fenceValue = Signal();
@@ -157,10 +154,11 @@ namespace helios::gfx
 		return commandAllocator;
 	}
 
-	wrl::ComPtr<ID3D12GraphicsCommandList1> CommandQueue::CreateCommandList(ID3D12CommandAllocator* commandAllocator, const gfx::PipelineState* pipelineState)
+	wrl::ComPtr<ID3D12GraphicsCommandList1> CommandQueue::CreateCommandList()
 	{
+		// The command list is created closed (and without an allocator), as it is reset with an allocator from the pool before recording.
 		wrl::ComPtr<ID3D12GraphicsCommandList1> commandList;
-		ThrowIfFailed(mDevice->CreateCommandList(0u, mCommandListType, commandAllocator, pipelineState ? pipelineState->pipelineStateObject.Get() : nullptr, IID_PPV_ARGS(&commandList)));
+		ThrowIfFailed(mDevice->CreateCommandList1(0u, mCommandListType, D3D12_COMMAND_LIST_FLAG_NONE, IID_PPV_ARGS(&commandList)));
 
 		return commandList;
 	}
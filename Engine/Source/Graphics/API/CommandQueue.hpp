@@ -1,19 +1,15 @@
 #pragma once
 
 #include "PipelineState.hpp"
+#include "CommandAllocatorPool.hpp"
+
+#include "Utility/ConcurrentFreeList.hpp"
 
 namespace helios::gfx
 {
-	// note(rtarun9) : since command allocators cannot be reset until they are no longer 'in flight', we store a fence value along with the command allocator,
-	// to keep track if the commands have been executed by a command queue or not.
-	struct CommandAllocator
-	{
-		uint64_t fenceValue{};
-		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
-	};
-
-	// Command Queue abstraction : has a  circular queue for command list and allocators.
+	// Command Queue abstraction : has a pool of command allocators (see CommandAllocatorPool) and a free list of command lists.
 	// Has interfaces related to synchronization.
+	// Command lists can be acquired, recorded and submitted from any thread.
 	class CommandQueue
 	{
 	public:
@@ -32,18 +28,35 @@ namespace helios::gfx
 
 		void ExecuteAndFlush(ID3D12GraphicsCommandList1* commandList);
 
+		// To be called once all command lists of the frame have been submitted : retires the command allocators used in the frame (see CommandAllocatorPool).
+		void EndFrame();
+
 		// Return value that the fence will be signalled with when GPU commands finish executing.
 		[[nodiscard]]
 		uint64_t Signal();
 
 		bool IsFenceComplete(uint64_t fenceValue);
 		void WaitForFenceValue(uint64_t fenceValue);
+
+		// GPU side wait : work submitted to this queue afterwards only starts once the fence of the signalling queue reaches fenceValue (the CPU does not block).
+		void WaitOnGpu(const CommandQueue* signallingQueue, uint64_t fenceValue);
+
 		void FlushQueue();
 
+		// All work submitted to the queue so far is complete once the fence reaches the last signalled value.
+		uint64_t GetLastSignaledFenceValue() const { return mFenceValue; }
+		uint64_t GetCompletedFenceValue() const { return mFence->GetCompletedValue(); }
+
+		CommandAllocatorPoolStatistics GetCommandAllocatorPoolStatistics() const { return mCommandAllocatorPool.GetStatistics(); }
+		uint64_t GetCommandListCount() const { return mCommandListCount.load(std::memory_order_relaxed); }
+
 	private:
 		// Helper functions to create command list / command allocator if none are available in the queue.
 		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CreateCommandAllocator();
-		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> CreateCommandList(ID3D12CommandAllocator* commandAllocator, const gfx::PipelineState* pipelineState = nullptr);
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> CreateCommandList();
+
+		// Same as Signal, but mSubmissionMutex must already be held.
+		uint64_t SignalFence();
 
 	private:
 		D3D12_COMMAND_LIST_TYPE mCommandListType{D3D12_COMMAND_LIST_TYPE_DIRECT};
@@ -55,11 +68,17 @@ namespace helios::gfx
 		Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue{};
 		
 		// Synchronization objects.
+		// Submissions (and the signals following them) are serialized, so fence values are signalled in submission order.
 		Microsoft::WRL::ComPtr<ID3D12Fence> mFence{};
 		HANDLE mFenceEvent{};
-		uint64_t mFenceValue{};
+		std::atomic<uint64_t> mFenceValue{};
+		std::mutex mSubmissionMutex{};
+		std::mutex mFenceEventMutex{};
+
+		CommandAllocatorPool<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mCommandAllocatorPool;
 
-		std::queue<CommandAllocator> mCommandAllocatorQueue{};
-		std::queue<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1>> mCommandListQueue{};
+		// Command lists can be reset as soon as they have been submitted, so they are pushed back to the free list right after submission.
+		ConcurrentFreeList<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1>> mCommandListFreeList{};
+		std::atomic<uint64_t> mCommandListCount{};
 	};
 }
\ No newline at end of file
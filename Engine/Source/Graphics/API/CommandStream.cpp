@@ -0,0 +1,385 @@
+#include "CommandStream.hpp"
+
+#include <algorithm>
+
+#include "ResourceStateTracker.hpp"
+#include "Utility/ConcurrentFreeList.hpp"
+
+namespace helios::gfx
+{
+	namespace
+	{
+		// Chunks of all streams are recycled through this pool, so recording does not allocate once the pool is warmed up.
+		ConcurrentFreeList<std::unique_ptr<std::byte[]>>& GetChunkPool()
+		{
+			static ConcurrentFreeList<std::unique_ptr<std::byte[]>> chunkPool{};
+			return chunkPool;
+		}
+	}
+
+	const char* CommandTypeToString(CommandType commandType)
+	{
+		switch (commandType)
+		{
+			case CommandType::SetDescriptorHeaps:
+			{
+				return "SetDescriptorHeaps";
+			}break;
+
+			case CommandType::SetRootSignature:
+			{
+				return "SetRootSignature";
+			}break;
+
+			case CommandType::SetPipelineState:
+			{
+				return "SetPipelineState";
+			}break;
+
+			case CommandType::SetRootConstants:
+			{
+				return "SetRootConstants";
+			}break;
+
+			case CommandType::SetIndexBuffer:
+			{
+				return "SetIndexBuffer";
+			}break;
+
+			case CommandType::SetPrimitiveTopology:
+			{
+				return "SetPrimitiveTopology";
+			}break;
+
+			case CommandType::SetViewport:
+			{
+				return "SetViewport";
+			}break;
+
+			case CommandType::SetRenderTargets:
+			{
+				return "SetRenderTargets";
+			}break;
+
+			case CommandType::ClearRenderTarget:
+			{
+				return "ClearRenderTarget";
+			}break;
+
+			case CommandType::ClearDepthStencil:
+			{
+				return "ClearDepthStencil";
+			}break;
+
+			case CommandType::ResourceBarrier:
+			{
+				return "ResourceBarrier";
+			}break;
+
+			case CommandType::Draw:
+			{
+				return "Draw";
+			}break;
+
+			case CommandType::DrawIndexed:
+			{
+				return "DrawIndexed";
+			}break;
+
+			case CommandType::ExecuteIndirect:
+			{
+				return "ExecuteIndirect";
+			}break;
+
+			case CommandType::Dispatch:
+			{
+				return "Dispatch";
+			}break;
+
+			case CommandType::CopyResource:
+			{
+				return "CopyResource";
+			}break;
+		}
+
+		return "Unknown";
+	}
+
+	CommandStream::CommandStream() = default;
+
+	CommandStream::~CommandStream()
+	{
+		for (Chunk& chunk : mChunks)
+		{
+			GetChunkPool().Push(std::move(chunk.data));
+		}
+	}
+
+	void CommandStream::Record(const SetDescriptorHeapsCommand& command)
+	{
+		if (!IsRedundant(mTrackedState.descriptorHeaps, command))
+		{
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const SetRootSignatureCommand& command)
+	{
+		const uint32_t bindPointIndex = static_cast<uint32_t>(command.bindPoint);
+
+		if (!IsRedundant(mTrackedState.rootSignatures[bindPointIndex], command))
+		{
+			// Changing the root signature invalidates the root arguments bound to it.
+			mTrackedState.rootConstants[bindPointIndex].reset();
+
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const SetPipelineStateCommand& command)
+	{
+		if (!IsRedundant(mTrackedState.pipelineState, command))
+		{
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const SetRootConstantsCommand& command, std::span<const uint32_t> values)
+	{
+		values = values.first(std::min<size_t>(values.size(), MAX_ROOT_CONSTANTS));
+
+		TrackedRootConstants rootConstants
+		{
+			.command = command,
+		};
+
+		rootConstants.command.valueCount = static_cast<uint32_t>(values.size());
+		std::copy(values.begin(), values.end(), rootConstants.values.begin());
+
+		if (!IsRedundant(mTrackedState.rootConstants[static_cast<uint32_t>(command.bindPoint)], rootConstants))
+		{
+			Write(rootConstants.command, values);
+		}
+	}
+
+	void CommandStream::Record(const SetIndexBufferCommand& command)
+	{
+		if (!IsRedundant(mTrackedState.indexBuffer, command))
+		{
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const SetPrimitiveTopologyCommand& command)
+	{
+		if (!IsRedundant(mTrackedState.primitiveTopology, command))
+		{
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const SetViewportCommand& command)
+	{
+		if (!IsRedundant(mTrackedState.viewport, command))
+		{
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const SetRenderTargetsCommand& command)
+	{
+		if (!IsRedundant(mTrackedState.renderTargets, command))
+		{
+			Write(command);
+		}
+	}
+
+	void CommandStream::Record(const ClearRenderTargetCommand& command)
+	{
+		FlushResourceBarriers();
+		Write(command);
+	}
+
+	void CommandStream::Record(const ClearDepthStencilCommand& command)
+	{
+		FlushResourceBarriers();
+		Write(command);
+	}
+
+	void CommandStream::Record(const ResourceBarrierCommand& command)
+	{
+		GetOrCreateResourceStateTracker().AddResourceBarrier(command);
+	}
+
+	void CommandStream::Record(const DrawCommand& command)
+	{
+		if (command.vertexCountPerInstance == 0u || command.instanceCount == 0u)
+		{
+			mStatistics.filteredCommandCount++;
+			return;
+		}
+
+		FlushResourceBarriers();
+		Write(command);
+	}
+
+	void CommandStream::Record(const DrawIndexedCommand& command)
+	{
+		if (command.indexCountPerInstance == 0u || command.instanceCount == 0u)
+		{
+			mStatistics.filteredCommandCount++;
+			return;
+		}
+
+		FlushResourceBarriers();
+		Write(command);
+	}
+
+	void CommandStream::Record(const ExecuteIndirectCommand& command)
+	{
+		if (command.maxCommandCount == 0u)
+		{
+			mStatistics.filteredCommandCount++;
+			return;
+		}
+
+		FlushResourceBarriers();
+		Write(command);
+
+		// The command signature may set the root arguments of either bind point.
+		for (std::optional<TrackedRootConstants>& rootConstants : mTrackedState.rootConstants)
+		{
+			rootConstants.reset();
+		}
+
+		mTrackedState.indexBuffer.reset();
+	}
+
+	void CommandStream::Record(const DispatchCommand& command)
+	{
+		if (command.threadGroupCountX == 0u || command.threadGroupCountY == 0u || command.threadGroupCountZ == 0u)
+		{
+			mStatistics.filteredCommandCount++;
+			return;
+		}
+
+		FlushResourceBarriers();
+		Write(command);
+	}
+
+	void CommandStream::Record(const CopyResourceCommand& command)
+	{
+		FlushResourceBarriers();
+		Write(command);
+	}
+
+	void CommandStream::TransitionResource(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount)
+	{
+		GetOrCreateResourceStateTracker().TransitionResource(resource, state, subresource, subresourceCount);
+	}
+
+	void CommandStream::BeginResourceTransition(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount)
+	{
+		GetOrCreateResourceStateTracker().BeginResourceTransition(resource, state, subresource, subresourceCount);
+	}
+
+	void CommandStream::FlushResourceBarriers()
+	{
+		if (!mResourceStateTracker || mResourceStateTracker->GetPendingBarriers().empty())
+		{
+			return;
+		}
+
+		for (const ResourceBarrierCommand& barrier : mResourceStateTracker->GetPendingBarriers())
+		{
+			Write(barrier);
+		}
+
+		mResourceStateTracker->ClearPendingBarriers();
+	}
+
+	void CommandStream::EndResourceTransitions()
+	{
+		if (mResourceStateTracker)
+		{
+			mResourceStateTracker->EndResourceTransitions();
+			FlushResourceBarriers();
+		}
+	}
+
+	void CommandStream::RecordResolvedBarriers(std::span<const ResourceBarrierCommand> barriers)
+	{
+		for (const ResourceBarrierCommand& barrier : barriers)
+		{
+			Write(barrier);
+		}
+
+		if (!barriers.empty())
+		{
+			mStatistics.resourceBarrierStatistics.resolvedTransitionCount += barriers.size();
+			mStatistics.resourceBarrierStatistics.barrierBatchCount++;
+		}
+	}
+
+	void CommandStream::Clear()
+	{
+		for (Chunk& chunk : mChunks)
+		{
+			chunk.usedSize = 0u;
+		}
+
+		mCurrentChunkIndex = 0u;
+		mCommandCount = 0u;
+	}
+
+	void CommandStream::InvalidateState()
+	{
+		mTrackedState = {};
+	}
+
+	CommandStreamStatistics CommandStream::GetStatistics() const
+	{
+		CommandStreamStatistics statistics = mStatistics;
+		if (mResourceStateTracker)
+		{
+			statistics.resourceBarrierStatistics += mResourceStateTracker->GetStatistics();
+		}
+
+		return statistics;
+	}
+
+	std::byte* CommandStream::Allocate(size_t size)
+	{
+		if (!mChunks.empty() && mChunks[mCurrentChunkIndex].usedSize + size > CHUNK_SIZE)
+		{
+			mCurrentChunkIndex++;
+		}
+
+		if (mCurrentChunkIndex == mChunks.size())
+		{
+			std::optional<std::unique_ptr<std::byte[]>> chunkData = GetChunkPool().Pop();
+
+			mChunks.push_back(Chunk
+			{
+				.data = chunkData.has_value() ? std::move(*chunkData) : std::make_unique<std::byte[]>(CHUNK_SIZE),
+			});
+		}
+
+		Chunk& chunk = mChunks[mCurrentChunkIndex];
+
+		std::byte* const memory = chunk.data.get() + chunk.usedSize;
+		chunk.usedSize += size;
+
+		return memory;
+	}
+
+	ResourceStateTracker& CommandStream::GetOrCreateResourceStateTracker()
+	{
+		if (!mResourceStateTracker)
+		{
+			mResourceStateTracker = std::make_unique<ResourceStateTracker>();
+		}
+
+		return *mResourceStateTracker;
+	}
+}
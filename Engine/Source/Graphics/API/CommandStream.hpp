@@ -0,0 +1,518 @@
+#pragma once
+
+// The contexts translate the recorded commands into the D3D12 command list (see Context::TranslateCommandStream).
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace helios::gfx
+{
+	// Handles are opaque to the stream : for D3D12, they are interface pointers, GPU virtual addresses and CPU descriptor handles.
+	using CommandHandle = uint64_t;
+
+	enum class CommandType : uint32_t
+	{
+		SetDescriptorHeaps,
+		SetRootSignature,
+		SetPipelineState,
+		SetRootConstants,
+		SetIndexBuffer,
+		SetPrimitiveTopology,
+		SetViewport,
+		SetRenderTargets,
+		ClearRenderTarget,
+		ClearDepthStencil,
+		ResourceBarrier,
+		Draw,
+		DrawIndexed,
+		ExecuteIndirect,
+		Dispatch,
+		CopyResource,
+	};
+
+	static constexpr uint32_t COMMAND_TYPE_COUNT = static_cast<uint32_t>(CommandType::CopyResource) + 1u;
+
+	const char* CommandTypeToString(CommandType commandType);
+
+	enum class PipelineBindPoint : uint32_t
+	{
+		Graphics,
+		Compute,
+	};
+
+	enum class BarrierType : uint32_t
+	{
+		Transition,
+		Aliasing,
+		UnorderedAccess,
+	};
+
+	// Split transitions are recorded as a begin barrier (after the last use of the resource in its state before) and an end barrier (before its first use in
+	// the state after), so the GPU can perform the transition while the work in between executes. The resource can't be used in between.
+	enum class BarrierSplit : uint32_t
+	{
+		None,
+		Begin,
+		End,
+	};
+
+	// Matches D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES.
+	static constexpr uint32_t ALL_SUBRESOURCES = UINT32_MAX;
+
+	static constexpr uint32_t PIPELINE_BIND_POINT_COUNT = 2u;
+	static constexpr uint32_t MAX_DESCRIPTOR_HEAPS = 2u;
+	static constexpr uint32_t MAX_ROOT_CONSTANTS = 64u;
+	static constexpr uint32_t MAX_RENDER_TARGETS = 8u;
+
+	// Commands are POD, and are compared (defaulted operator==) to filter out redundant state changes.
+	struct SetDescriptorHeapsCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetDescriptorHeaps;
+
+		uint32_t descriptorHeapCount{};
+		std::array<CommandHandle, MAX_DESCRIPTOR_HEAPS> descriptorHeaps{};
+
+		bool operator==(const SetDescriptorHeapsCommand& other) const = default;
+	};
+
+	struct SetRootSignatureCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetRootSignature;
+
+		PipelineBindPoint bindPoint{};
+		CommandHandle rootSignature{};
+
+		bool operator==(const SetRootSignatureCommand& other) const = default;
+	};
+
+	// The pipeline state is shared by the graphics and compute bind points.
+	struct SetPipelineStateCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetPipelineState;
+
+		CommandHandle pipelineState{};
+
+		bool operator==(const SetPipelineStateCommand& other) const = default;
+	};
+
+	// The valueCount values are stored right after the command in the stream (see CommandStream::GetRootConstants), rather than in a fixed size array.
+	struct SetRootConstantsCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetRootConstants;
+
+		PipelineBindPoint bindPoint{};
+		uint32_t rootParameterIndex{};
+		uint32_t valueCount{};
+
+		bool operator==(const SetRootConstantsCommand& other) const = default;
+	};
+
+	struct SetIndexBufferCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetIndexBuffer;
+
+		CommandHandle bufferLocation{};
+		uint32_t sizeInBytes{};
+		uint32_t format{};
+
+		bool operator==(const SetIndexBufferCommand& other) const = default;
+	};
+
+	struct SetPrimitiveTopologyCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetPrimitiveTopology;
+
+		uint32_t primitiveTopology{};
+
+		bool operator==(const SetPrimitiveTopologyCommand& other) const = default;
+	};
+
+	// The scissor rect always covers the entire render target.
+	struct SetViewportCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetViewport;
+
+		float topLeftX{};
+		float topLeftY{};
+		float width{};
+		float height{};
+		float minDepth{};
+		float maxDepth{};
+
+		bool operator==(const SetViewportCommand& other) const = default;
+	};
+
+	struct SetRenderTargetsCommand
+	{
+		static constexpr CommandType TYPE = CommandType::SetRenderTargets;
+
+		uint32_t renderTargetCount{};
+
+		// If true, renderTargets[0] is the start of a contiguous range of renderTargetCount descriptors.
+		uint32_t isSingleHandleToDescriptorRange{};
+
+		std::array<CommandHandle, MAX_RENDER_TARGETS> renderTargets{};
+
+		// 0 if no depth stencil is bound.
+		CommandHandle depthStencil{};
+
+		bool operator==(const SetRenderTargetsCommand& other) const = default;
+	};
+
+	struct ClearRenderTargetCommand
+	{
+		static constexpr CommandType TYPE = CommandType::ClearRenderTarget;
+
+		CommandHandle renderTarget{};
+		std::array<float, 4> color{};
+	};
+
+	struct ClearDepthStencilCommand
+	{
+		static constexpr CommandType TYPE = CommandType::ClearDepthStencil;
+
+		CommandHandle depthStencil{};
+		float depth{};
+	};
+
+	// Consecutive barriers are translated into a single (batched) call.
+	// For aliasing barriers, the states are unused, and a null resource means any resource placed in the same memory may have been in use.
+	// For UAV barriers, the states are unused, and a null resource means all unordered access writes must complete before the next ones.
+	// The subresource and split are only used by transitions.
+	struct ResourceBarrierCommand
+	{
+		static constexpr CommandType TYPE = CommandType::ResourceBarrier;
+
+		BarrierType barrierType{};
+		uint32_t stateBefore{};
+		uint32_t stateAfter{};
+		CommandHandle resource{};
+		CommandHandle resourceAfter{};
+		uint32_t subresource{ ALL_SUBRESOURCES };
+		BarrierSplit split{};
+	};
+
+	struct DrawCommand
+	{
+		static constexpr CommandType TYPE = CommandType::Draw;
+
+		uint32_t vertexCountPerInstance{};
+		uint32_t instanceCount{};
+		uint32_t startVertexLocation{};
+		uint32_t startInstanceLocation{};
+	};
+
+	struct DrawIndexedCommand
+	{
+		static constexpr CommandType TYPE = CommandType::DrawIndexed;
+
+		uint32_t indexCountPerInstance{};
+		uint32_t instanceCount{};
+		uint32_t startIndexLocation{};
+		int32_t baseVertexLocation{};
+		uint32_t startInstanceLocation{};
+	};
+
+	// Executes up to maxCommandCount commands whose arguments are read by the GPU from the argument buffer, laid out as described by the command signature
+	// (see IndirectDrawArguments). If a count buffer is set, the command count is the minimum of maxCommandCount and the count it holds.
+	// The root arguments and index buffer set by the commands are undefined afterwards (as per the D3D12 specification), so they are no longer tracked.
+	struct ExecuteIndirectCommand
+	{
+		static constexpr CommandType TYPE = CommandType::ExecuteIndirect;
+
+		CommandHandle commandSignature{};
+		uint32_t maxCommandCount{};
+		CommandHandle argumentBuffer{};
+		uint64_t argumentBufferOffset{};
+
+		// 0 if the command count is maxCommandCount.
+		CommandHandle countBuffer{};
+		uint64_t countBufferOffset{};
+	};
+
+	struct DispatchCommand
+	{
+		static constexpr CommandType TYPE = CommandType::Dispatch;
+
+		uint32_t threadGroupCountX{};
+		uint32_t threadGroupCountY{};
+		uint32_t threadGroupCountZ{};
+	};
+
+	struct CopyResourceCommand
+	{
+		static constexpr CommandType TYPE = CommandType::CopyResource;
+
+		CommandHandle destination{};
+		CommandHandle source{};
+	};
+
+	// Precedes every command in the stream. size includes the header itself, so the next command starts size bytes after the header.
+	struct CommandHeader
+	{
+		CommandType type{};
+		uint32_t size{};
+	};
+
+	// Barriers recorded through the resource state tracking of the streams (see ResourceStateTracker). Transitions are counted per (sub)resource.
+	struct ResourceBarrierStatistics
+	{
+		uint64_t transitionCount{};
+
+		// Transitions recorded as a begin / end barrier pair (counted once).
+		uint64_t splitTransitionCount{};
+
+		uint64_t uavBarrierCount{};
+		uint64_t aliasingBarrierCount{};
+
+		// Barriers executed by a single call.
+		uint64_t barrierBatchCount{};
+
+		// Requested states the resource already was in, and transitions folded into a transition of the same batch (i.e A -> B followed by B -> C, or a split
+		// transition without work in between).
+		uint64_t redundantTransitionCount{};
+		uint64_t mergedTransitionCount{};
+
+		// Transitions whose state before (given by the caller) was not the tracked state of the resource, which were recorded from the tracked state instead.
+		uint64_t correctedTransitionCount{};
+
+		// Transitions recorded on submission, for the resources whose state at the start of the stream only became known then.
+		uint64_t resolvedTransitionCount{};
+
+		ResourceBarrierStatistics& operator+=(const ResourceBarrierStatistics& other)
+		{
+			transitionCount += other.transitionCount;
+			splitTransitionCount += other.splitTransitionCount;
+			uavBarrierCount += other.uavBarrierCount;
+			aliasingBarrierCount += other.aliasingBarrierCount;
+			barrierBatchCount += other.barrierBatchCount;
+			redundantTransitionCount += other.redundantTransitionCount;
+			mergedTransitionCount += other.mergedTransitionCount;
+			correctedTransitionCount += other.correctedTransitionCount;
+			resolvedTransitionCount += other.resolvedTransitionCount;
+
+			return *this;
+		}
+	};
+
+	struct CommandStreamStatistics
+	{
+		uint64_t recordedCommandCount{};
+
+		// Commands that were not recorded, as they set state that was already set (or would have no effect, i.e empty draws / dispatches).
+		uint64_t filteredCommandCount{};
+
+		uint64_t recordedByteSize{};
+
+		ResourceBarrierStatistics resourceBarrierStatistics{};
+
+		CommandStreamStatistics& operator+=(const CommandStreamStatistics& other)
+		{
+			recordedCommandCount += other.recordedCommandCount;
+			filteredCommandCount += other.filteredCommandCount;
+			recordedByteSize += other.recordedByteSize;
+			resourceBarrierStatistics += other.resourceBarrierStatistics;
+
+			return *this;
+		}
+	};
+
+	class ResourceStateTracker;
+
+	// Compact, backend neutral stream of recorded commands. Commands are written back to back into fixed size chunks (arena memory), which are recycled
+	// through a (lock free) pool shared by all streams : a stream is recorded by one thread at a time, but streams can be recorded by any thread.
+	// The state set by the recorded commands is tracked, so commands that would set the same state again are filtered out at record time.
+	// The state of the resources is tracked as well (see ResourceStateTracker) : barriers are batched until the next work command.
+	class CommandStream
+	{
+	public:
+		CommandStream();
+		~CommandStream();
+
+		CommandStream(const CommandStream& other) = delete;
+		CommandStream& operator=(const CommandStream& other) = delete;
+
+		void Record(const SetDescriptorHeapsCommand& command);
+		void Record(const SetRootSignatureCommand& command);
+		void Record(const SetPipelineStateCommand& command);
+		// valueCount is set from values. Values beyond MAX_ROOT_CONSTANTS (the size of the root constants in the root signature) are ignored.
+		void Record(const SetRootConstantsCommand& command, std::span<const uint32_t> values);
+		void Record(const SetIndexBufferCommand& command);
+		void Record(const SetPrimitiveTopologyCommand& command);
+		void Record(const SetViewportCommand& command);
+		void Record(const SetRenderTargetsCommand& command);
+		void Record(const ClearRenderTargetCommand& command);
+		void Record(const ClearDepthStencilCommand& command);
+		// The state before of transitions is only used if the resource was not used by the stream yet (see ResourceStateTracker::AddResourceBarrier).
+		void Record(const ResourceBarrierCommand& command);
+		void Record(const DrawCommand& command);
+		void Record(const DrawIndexedCommand& command);
+		void Record(const ExecuteIndirectCommand& command);
+		void Record(const DispatchCommand& command);
+		void Record(const CopyResourceCommand& command);
+
+		// Transitions the (sub)resource from its tracked state. subresourceCount is only used if a single subresource is transitioned.
+		void TransitionResource(CommandHandle resource, uint32_t state, uint32_t subresource = ALL_SUBRESOURCES, uint32_t subresourceCount = 1u);
+
+		// To be called after the last use of the (sub)resource in its current state : the transition is ended by the next TransitionResource call to the same
+		// state. Recorded as a regular transition if no work is recorded in between.
+		void BeginResourceTransition(CommandHandle resource, uint32_t state, uint32_t subresource = ALL_SUBRESOURCES, uint32_t subresourceCount = 1u);
+
+		// Records the pending barriers (work commands do so automatically).
+		void FlushResourceBarriers();
+
+		// Ends the split transitions in flight and records the pending barriers. Required before the stream is submitted (and resolved, see ResourceStateRegistry).
+		void EndResourceTransitions();
+
+		// Records barriers as is (i.e the barriers resolved on submission), bypassing the resource state tracking.
+		void RecordResolvedBarriers(std::span<const ResourceBarrierCommand> barriers);
+
+		// Null if no barrier was recorded yet.
+		ResourceStateTracker* GetResourceStateTracker() { return mResourceStateTracker.get(); }
+
+		// Calls function(const CommandHeader&) for each command in recording order. GetCommand returns the command following the header.
+		template <typename Function>
+		void ForEachCommand(Function&& function) const
+		{
+			for (const Chunk& chunk : mChunks)
+			{
+				size_t offset{};
+				while (offset < chunk.usedSize)
+				{
+					const CommandHeader& header = *std::launder(reinterpret_cast<const CommandHeader*>(chunk.data.get() + offset));
+					function(header);
+
+					offset += header.size;
+				}
+			}
+		}
+
+		template <typename T>
+		static const T& GetCommand(const CommandHeader& header)
+		{
+			return *std::launder(reinterpret_cast<const T*>(reinterpret_cast<const std::byte*>(&header) + sizeof(CommandHeader)));
+		}
+
+		// The values of a SetRootConstants command, which follow it in the stream.
+		static std::span<const uint32_t> GetRootConstants(const CommandHeader& header)
+		{
+			const SetRootConstantsCommand& command = GetCommand<SetRootConstantsCommand>(header);
+			return { reinterpret_cast<const uint32_t*>(reinterpret_cast<const std::byte*>(&command) + sizeof(SetRootConstantsCommand)), command.valueCount };
+		}
+
+		// Removes the recorded commands (i.e once translated), keeping the chunks for further recording. The tracked state is kept, as it is still set.
+		void Clear();
+
+		// To be called when the state may have been changed outside of the stream : the next state commands are recorded even if redundant.
+		void InvalidateState();
+
+		uint32_t GetCommandCount() const { return mCommandCount; }
+		bool IsEmpty() const { return mCommandCount == 0u; }
+
+		// Backend command list the stream is translated into (i.e the command list of a D3D12 context, which commands may also be recorded into directly).
+		// If null, the backend translates the stream into a command list of its own when executing it.
+		void SetTranslationTarget(CommandHandle commandList) { mTranslationTarget = commandList; }
+		CommandHandle GetTranslationTarget() const { return mTranslationTarget; }
+
+		// Accumulated over the lifetime of the stream (not reset by Clear).
+		CommandStreamStatistics GetStatistics() const;
+
+	public:
+		static constexpr size_t CHUNK_SIZE = 16u * 1024u;
+		static constexpr size_t COMMAND_ALIGNMENT = 8u;
+
+	private:
+		struct Chunk
+		{
+			std::unique_ptr<std::byte[]> data{};
+			size_t usedSize{};
+		};
+
+		// The values beyond valueCount are 0, so the defaulted comparison only compares the set values.
+		struct TrackedRootConstants
+		{
+			SetRootConstantsCommand command{};
+			std::array<uint32_t, MAX_ROOT_CONSTANTS> values{};
+
+			bool operator==(const TrackedRootConstants& other) const = default;
+		};
+
+		// State set by the recorded commands (nullopt if unknown).
+		struct TrackedState
+		{
+			std::optional<SetDescriptorHeapsCommand> descriptorHeaps{};
+			std::array<std::optional<SetRootSignatureCommand>, PIPELINE_BIND_POINT_COUNT> rootSignatures{};
+			std::optional<SetPipelineStateCommand> pipelineState{};
+			std::array<std::optional<TrackedRootConstants>, PIPELINE_BIND_POINT_COUNT> rootConstants{};
+			std::optional<SetIndexBufferCommand> indexBuffer{};
+			std::optional<SetPrimitiveTopologyCommand> primitiveTopology{};
+			std::optional<SetViewportCommand> viewport{};
+			std::optional<SetRenderTargetsCommand> renderTargets{};
+		};
+
+		// Returns true (and counts the command as filtered) if the command sets the state that is already set, else tracks the new state.
+		template <typename T>
+		bool IsRedundant(std::optional<T>& trackedState, const T& command)
+		{
+			if (trackedState.has_value() && *trackedState == command)
+			{
+				mStatistics.filteredCommandCount++;
+				return true;
+			}
+
+			trackedState = command;
+			return false;
+		}
+
+		// values (i.e root constants) are written right after the command.
+		template <typename T>
+		void Write(const T& command, std::span<const uint32_t> values = {})
+		{
+			static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= COMMAND_ALIGNMENT && sizeof(T) % alignof(uint32_t) == 0u);
+			static_assert(sizeof(CommandHeader) + sizeof(T) + sizeof(uint32_t) * MAX_ROOT_CONSTANTS + COMMAND_ALIGNMENT <= CHUNK_SIZE);
+
+			const size_t commandSize = (sizeof(CommandHeader) + sizeof(T) + values.size_bytes() + COMMAND_ALIGNMENT - 1u) & ~(COMMAND_ALIGNMENT - 1u);
+
+			std::byte* const memory = Allocate(commandSize);
+			new (memory) CommandHeader{ .type = T::TYPE, .size = static_cast<uint32_t>(commandSize) };
+			new (memory + sizeof(CommandHeader)) T(command);
+
+			if (!values.empty())
+			{
+				std::memcpy(memory + sizeof(CommandHeader) + sizeof(T), values.data(), values.size_bytes());
+			}
+
+			mCommandCount++;
+			mStatistics.recordedCommandCount++;
+			mStatistics.recordedByteSize += commandSize;
+		}
+
+		std::byte* Allocate(size_t size);
+
+		ResourceStateTracker& GetOrCreateResourceStateTracker();
+
+	private:
+		std::vector<Chunk> mChunks{};
+
+		// Index of the chunk commands are written into (chunks after it are empty).
+		size_t mCurrentChunkIndex{};
+
+		uint32_t mCommandCount{};
+
+		CommandHandle mTranslationTarget{};
+
+		TrackedState mTrackedState{};
+
+		CommandStreamStatistics mStatistics{};
+
+		// Created on the first barrier (streams that record none do not track resource states).
+		std::unique_ptr<ResourceStateTracker> mResourceStateTracker{};
+	};
+}
@@ -8,41 +8,61 @@ namespace helios::gfx
 	ComputeContext::ComputeContext(Device* device, const gfx::PipelineState* pipelineState) : mDevice(*device)
 	{
 		mCommandList = device->GetComputeCommandQueue()->GetCommandList(pipelineState);
+		mCommandStream.SetTranslationTarget(ToCommandHandle(mCommandList.Get()));
 
 		// As all compute context's require to set the descriptor heap before hand, the user has option to set them manually (for explicitness) or just let the constructor take care of this.
 		SetDescriptorHeaps(mDevice.GetSrvCbvUavDescriptor());
 
-		mCommandList->SetComputeRootSignature(PipelineState::rootSignature.Get());
+		mCommandStream.Record(SetRootSignatureCommand
+		{
+			.bindPoint = PipelineBindPoint::Compute,
+			.rootSignature = ToCommandHandle(PipelineState::rootSignature.Get()),
+		});
 	}
 
 	void ComputeContext::Dispatch(uint32_t threadGroupX, uint32_t threadGroupY, uint32_t threadGroupZ) const
 	{
-		mCommandList->Dispatch(threadGroupX, threadGroupY, threadGroupZ);
+		mCommandStream.Record(DispatchCommand
+		{
+			.threadGroupCountX = threadGroupX,
+			.threadGroupCountY = threadGroupY,
+			.threadGroupCountZ = threadGroupZ,
+		});
 	}
 
 	void ComputeContext::SetDescriptorHeaps(const Descriptor* const descriptor) const
 	{
-		std::array<ID3D12DescriptorHeap*, 1>  descriptorHeaps
+		mCommandStream.Record(SetDescriptorHeapsCommand
 		{
-			descriptor->GetDescriptorHeap(),
-		};
-
-		mCommandList->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
+			.descriptorHeapCount = 1u,
+			.descriptorHeaps = { ToCommandHandle(descriptor->GetDescriptorHeap()) },
+		});
 	}
 
 	void ComputeContext::SetComputeRootSignature(PipelineState* pipelineState) const
 	{
-		mCommandList->SetComputeRootSignature(pipelineState->rootSignature.Get());
+		mCommandStream.Record(SetRootSignatureCommand
+		{
+			.bindPoint = PipelineBindPoint::Compute,
+			.rootSignature = ToCommandHandle(pipelineState->rootSignature.Get()),
+		});
 	}
 
-	void ComputeContext::Set32BitComputeConstants(const void* renderResources) const
+	void ComputeContext::Set32BitComputeConstants(const void* renderResources, uint32_t valueCount) const
 	{
-		mCommandList->SetComputeRoot32BitConstants(0u, NUMBER_32_BIT_CONSTANTS, renderResources, 0u);
+		std::array<uint32_t, NUMBER_32_BIT_CONSTANTS> values{};
+		std::memcpy(values.data(), renderResources, sizeof(uint32_t) * valueCount);
+
+		mCommandStream.Record(SetRootConstantsCommand{ .bindPoint = PipelineBindPoint::Compute }, std::span(values).first(valueCount));
 	}
 
 	void ComputeContext::SetComputePipelineState(PipelineState* pipelineState) const
 	{
-		mCommandList->SetComputeRootSignature(pipelineState->rootSignature.Get());
-		mCommandList->SetPipelineState(pipelineState->pipelineStateObject.Get());
+		SetComputeRootSignature(pipelineState);
+
+		mCommandStream.Record(SetPipelineStateCommand
+		{
+			.pipelineState = ToCommandHandle(pipelineState->pipelineStateObject.Get()),
+		});
 	}
 }
\ No newline at end of file
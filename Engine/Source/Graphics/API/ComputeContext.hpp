@@ -20,7 +20,15 @@ namespace helios::gfx
 		void SetDescriptorHeaps(const Descriptor* descriptor) const;
 
 		void SetComputeRootSignature(PipelineState* pipelineState) const;
-		void Set32BitComputeConstants(const void* renderResources) const;
+		// Records sizeof(T) / 4 root constants, rather than the whole range of the root signature.
+		template <typename T>
+		void Set32BitComputeConstants(const T* renderResources) const
+		{
+			static_assert(sizeof(T) % sizeof(uint32_t) == 0u && sizeof(T) <= sizeof(uint32_t) * NUMBER_32_BIT_CONSTANTS);
+			Set32BitComputeConstants(renderResources, static_cast<uint32_t>(sizeof(T) / sizeof(uint32_t)));
+		}
+
+		void Set32BitComputeConstants(const void* renderResources, uint32_t valueCount) const;
 
 		void SetComputePipelineState(PipelineState* pipelineState) const;
 
@@ -1,23 +1,113 @@
+
 #include "Context.hpp"
 
+#include "D3D12RenderBackend.hpp"
+#include "ResourceStateTracker.hpp"
+
 namespace helios::gfx
 {
+	// The resource state tracker only depends on the STL, so it can't use the D3D12 values directly.
+	static_assert(READ_ONLY_RESOURCE_STATES == static_cast<uint32_t>(D3D12_RESOURCE_STATE_GENERIC_READ | D3D12_RESOURCE_STATE_DEPTH_READ));
+	static_assert(ALL_SUBRESOURCES == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+	ID3D12GraphicsCommandList1* const Context::GetCommandList() const
+	{
+		mCommandStream.FlushResourceBarriers();
+		TranslateCommandStream();
+		mCommandStream.InvalidateState();
+
+		return mCommandList.Get();
+	}
+
+	void Context::TransitionResource(ID3D12Resource* const resource, D3D12_RESOURCE_STATES newState, uint32_t subresource)
+	{
+		mCommandStream.TransitionResource(ToCommandHandle(resource), static_cast<uint32_t>(newState), subresource, subresource == ALL_SUBRESOURCES ? 1u : GetSubresourceCount(resource));
+	}
+
+	void Context::BeginResourceTransition(ID3D12Resource* const resource, D3D12_RESOURCE_STATES newState, uint32_t subresource)
+	{
+		mCommandStream.BeginResourceTransition(ToCommandHandle(resource), static_cast<uint32_t>(newState), subresource, subresource == ALL_SUBRESOURCES ? 1u : GetSubresourceCount(resource));
+	}
+
 	void Context::AddResourceBarrier(ID3D12Resource* const resource, D3D12_RESOURCE_STATES previousState, D3D12_RESOURCE_STATES newState)
 	{
-		mResourceBarriers.push_back({ CD3DX12_RESOURCE_BARRIER::Transition(resource, previousState, newState) });
+		mCommandStream.Record(ResourceBarrierCommand
+		{
+			.barrierType = BarrierType::Transition,
+			.stateBefore = static_cast<uint32_t>(previousState),
+			.stateAfter = static_cast<uint32_t>(newState),
+			.resource = ToCommandHandle(resource),
+		});
 	}
 
 	void Context::AddResourceBarrier(std::span<const RenderTarget*> renderTargets, D3D12_RESOURCE_STATES previousState, D3D12_RESOURCE_STATES newState)
 	{
 		for (const auto& rt : renderTargets)
 		{
-			mResourceBarriers.emplace_back(CD3DX12_RESOURCE_BARRIER::Transition(rt->renderTexture->allocation->resource.Get(), previousState, newState));
+			AddResourceBarrier(rt->renderTexture->allocation->resource.Get(), previousState, newState);
 		}
 	}
 
+	void Context::AddAliasingBarrier(ID3D12Resource* const resourceBefore, ID3D12Resource* const resourceAfter)
+	{
+		mCommandStream.Record(ResourceBarrierCommand
+		{
+			.barrierType = BarrierType::Aliasing,
+			.resource = ToCommandHandle(resourceBefore),
+			.resourceAfter = ToCommandHandle(resourceAfter),
+		});
+	}
+
+	void Context::AddUavBarrier(ID3D12Resource* const resource)
+	{
+		mCommandStream.Record(ResourceBarrierCommand
+		{
+			.barrierType = BarrierType::UnorderedAccess,
+			.resource = ToCommandHandle(resource),
+		});
+	}
+
 	void Context::ExecuteResourceBarriers()
 	{
-		mCommandList->ResourceBarrier(static_cast<UINT>(mResourceBarriers.size()), mResourceBarriers.data());
-		mResourceBarriers.clear();
+		mCommandStream.FlushResourceBarriers();
+	}
+
+	void Context::TrackResidency(const Allocation* allocation) const
+	{
+		if (allocation && allocation->residencyHandle)
+		{
+			mResidencyIds.push_back(*allocation->residencyHandle);
+		}
+	}
+
+	void Context::TrackResidency(const Buffer* buffer) const
+	{
+		if (buffer)
+		{
+			TrackResidency(buffer->allocation.get());
+		}
+	}
+
+	void Context::TrackResidency(const Texture* texture) const
+	{
+		if (texture)
+		{
+			TrackResidency(texture->allocation.get());
+		}
+	}
+
+	uint32_t Context::GetSubresourceCount(ID3D12Resource* const resource)
+	{
+		const D3D12_RESOURCE_DESC resourceDesc = resource->GetDesc();
+
+		// Note : The depth of 3D textures is not a subresource dimension (and plane slices are not used by the engine).
+		const uint32_t arraySize = resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1u : resourceDesc.DepthOrArraySize;
+		return resourceDesc.MipLevels * arraySize;
+	}
+
+	void Context::TranslateCommandStream() const
+	{
+		D3D12RenderBackend::TranslateCommandStream(mCommandList.Get(), mCommandStream, mTranslatedResourceBarriers);
+		mCommandStream.Clear();
 	}
-}
\ No newline at end of file
+}
@@ -3,37 +3,79 @@
 #include "PipelineState.hpp"
 #include "Resources.hpp"
 #include "Descriptor.hpp"
-
+#include "CommandStream.hpp"
 
 namespace helios::gfx
 {
 	// Base class for Context (i.e wrapper for command list). Provides batching of resource barriers for optimal performance.
 	// It uses a GraphicsCOmmandList and is can execute commands of any type (copy, compute, graphics, etc).
+	// Commands are not recorded into the command list directly, but into a (backend neutral) CommandStream that filters out redundant state changes.
+	// The stream is translated into the command list when the command list is accessed, and on submission (by the D3D12RenderBackend, as the command list is the
+	// translation target of the stream).
 
 	// Source : https://docs.microsoft.com/en-us/windows/win32/direct3d12/recording-command-lists-and-bundles.
 	class Context
 	{
 	public:
-		ID3D12GraphicsCommandList1* const GetCommandList() const { return mCommandList.Get(); }
+		// Translates the commands recorded so far, so commands recorded directly into the returned command list are executed after them.
+		// As the state of the command list may be changed by the caller, redundant state changes recorded afterwards are not filtered out until set again.
+		ID3D12GraphicsCommandList1* const GetCommandList() const;
+
+		// Note : Mutable access, as the device resolves the resource states of the stream on submission (see ResourceStateRegistry).
+		CommandStream& GetCommandStream() const { return mCommandStream; }
+		CommandStreamStatistics GetCommandStreamStatistics() const { return mCommandStream.GetStatistics(); }
 
 		// Core functionalities to be inherited by Graphics/Compute context.
 
 		// Resource related functions : 
+		// Transitions the (sub)resource from the state the stream tracks it in (see ResourceStateTracker). Redundant transitions are skipped.
+		void TransitionResource(ID3D12Resource* const resource, D3D12_RESOURCE_STATES newState, uint32_t subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+		// Begins a split transition after the last use of the (sub)resource in its current state. It is ended by the next TransitionResource call to the same
+		// state (which must happen before the next use of the resource), so the GPU can transition it while the work in between executes.
+		void BeginResourceTransition(ID3D12Resource* const resource, D3D12_RESOURCE_STATES newState, uint32_t subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+		// The previous state is only used if the resource was not used by the context yet, the tracked state is used otherwise.
 		void AddResourceBarrier(ID3D12Resource* const resource, D3D12_RESOURCE_STATES previousState, D3D12_RESOURCE_STATES newState);
 		void AddResourceBarrier(std::span<const RenderTarget*> renderTargets, D3D12_RESOURCE_STATES previousState, D3D12_RESOURCE_STATES newState);
+
+		// Required before the first use of a resource that shares memory with other resources (see TransientResourcePool).
+		// A null resourceBefore means any resource placed in the same memory may have been in use.
+		void AddAliasingBarrier(ID3D12Resource* const resourceBefore, ID3D12Resource* const resourceAfter);
+
+		// Required between dispatches where the latter reads (or writes) what the former wrote through a UAV, without a state transition in between.
+		// A null resource means all unordered access writes must complete.
+		void AddUavBarrier(ID3D12Resource* const resource);
 	
-		// Execute all resource barriers.
+		// Execute all resource barriers. Barriers are also executed (in a single batch) before the next draw / dispatch / copy / clear.
 		void ExecuteResourceBarriers();
+
+		// Resources used by the recorded commands are made resident (if evicted) before the context is executed (see ResidencyManager).
+		// Resources accessed through the bindless descriptor heap are not visible to the context, so they have to be tracked explicitly.
+		void TrackResidency(const Allocation* allocation) const;
+		void TrackResidency(const Buffer* buffer) const;
+		void TrackResidency(const Texture* texture) const;
+
+		std::span<const uint64_t> GetResidencyIds() const { return mResidencyIds; }
 	
 	protected:
 		Context() = default;
 
+		void TranslateCommandStream() const;
+
+		static CommandHandle ToCommandHandle(const void* pointer) { return reinterpret_cast<CommandHandle>(pointer); }
+
+		static uint32_t GetSubresourceCount(ID3D12Resource* const resource);
+
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList1> mCommandList{};
 
-		// Resource barriers are quite heavy, and executing them in a single call (batched) is very efficient.
-		// The resource barriers are executed when the ExecuteResourceBarriers() call is invoked, which must happen before command list is sent over to the
-		// device for execution, or be batched as much as possible.
+		// Mutable as the bind calls are const.
+		mutable CommandStream mCommandStream{};
+
+		// Scratch memory used to batch consecutive barriers of the stream when translating it.
+		mutable std::vector<D3D12_RESOURCE_BARRIER> mTranslatedResourceBarriers{};
 
-		std::vector<CD3DX12_RESOURCE_BARRIER> mResourceBarriers{};
+		// Mutable as tracking happens in the (const) bind calls.
+		mutable std::vector<uint64_t> mResidencyIds{};
 	};
 }
\ No newline at end of file
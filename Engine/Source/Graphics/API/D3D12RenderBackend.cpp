@@ -0,0 +1,258 @@
+#include "D3D12RenderBackend.hpp"
+
+namespace helios::gfx
+{
+	D3D12RenderBackend::D3D12RenderBackend(CommandQueue* const graphicsCommandQueue, CommandQueue* const computeCommandQueue, CommandQueue* const copyCommandQueue)
+		: mCommandQueues{ graphicsCommandQueue, computeCommandQueue, copyCommandQueue }
+	{
+	}
+
+	uint64_t D3D12RenderBackend::ExecuteCommandStreams(QueueType queueType, std::span<const CommandStream* const> commandStreams, std::span<const QueueWait> queueWaits)
+	{
+		CommandQueue* const commandQueue = GetCommandQueue(queueType);
+
+		// Command lists acquired for the streams without a translation target, kept alive until executed.
+		std::vector<wrl::ComPtr<ID3D12GraphicsCommandList1>> acquiredCommandLists{};
+
+		std::vector<ID3D12GraphicsCommandList1*> commandLists{};
+		for (const CommandStream* const commandStream : commandStreams)
+		{
+			ID3D12GraphicsCommandList1* commandList = FromCommandHandle<ID3D12GraphicsCommandList1>(commandStream->GetTranslationTarget());
+			if (!commandList)
+			{
+				commandList = acquiredCommandLists.emplace_back(commandQueue->GetCommandList()).Get();
+			}
+
+			TranslateCommandStream(commandList, *commandStream, mTranslatedResourceBarriers);
+			commandLists.push_back(commandList);
+		}
+
+		// Note : The waits are issued before the execution, as ID3D12CommandQueue::Wait only applies to the work submitted to the queue afterwards.
+		for (const QueueWait& queueWait : queueWaits)
+		{
+			commandQueue->WaitOnGpu(GetCommandQueue(queueWait.signallingQueue), queueWait.fenceValue);
+		}
+
+		return commandQueue->ExecuteCommandLists(commandLists);
+	}
+
+	uint64_t D3D12RenderBackend::GetCompletedFenceValue(QueueType queueType) const
+	{
+		return GetCommandQueue(queueType)->GetCompletedFenceValue();
+	}
+
+	void D3D12RenderBackend::WaitForFenceValue(QueueType queueType, uint64_t fenceValue)
+	{
+		GetCommandQueue(queueType)->WaitForFenceValue(fenceValue);
+	}
+
+	void D3D12RenderBackend::TranslateCommandStream(ID3D12GraphicsCommandList1* const commandList, const CommandStream& commandStream, std::vector<D3D12_RESOURCE_BARRIER>& resourceBarriers)
+	{
+		const auto flushResourceBarriers = [&]()
+		{
+			if (!resourceBarriers.empty())
+			{
+				commandList->ResourceBarrier(static_cast<UINT>(resourceBarriers.size()), resourceBarriers.data());
+				resourceBarriers.clear();
+			}
+		};
+
+		commandStream.ForEachCommand([&](const CommandHeader& header)
+		{
+			if (header.type != CommandType::ResourceBarrier)
+			{
+				flushResourceBarriers();
+			}
+
+			switch (header.type)
+			{
+				case CommandType::SetDescriptorHeaps:
+				{
+					const SetDescriptorHeapsCommand& command = CommandStream::GetCommand<SetDescriptorHeapsCommand>(header);
+
+					std::array<ID3D12DescriptorHeap*, MAX_DESCRIPTOR_HEAPS> descriptorHeaps{};
+					for (uint32_t i : std::views::iota(0u, command.descriptorHeapCount))
+					{
+						descriptorHeaps[i] = FromCommandHandle<ID3D12DescriptorHeap>(command.descriptorHeaps[i]);
+					}
+
+					commandList->SetDescriptorHeaps(command.descriptorHeapCount, descriptorHeaps.data());
+				}break;
+
+				case CommandType::SetRootSignature:
+				{
+					const SetRootSignatureCommand& command = CommandStream::GetCommand<SetRootSignatureCommand>(header);
+
+					if (command.bindPoint == PipelineBindPoint::Graphics)
+					{
+						commandList->SetGraphicsRootSignature(FromCommandHandle<ID3D12RootSignature>(command.rootSignature));
+					}
+					else
+					{
+						commandList->SetComputeRootSignature(FromCommandHandle<ID3D12RootSignature>(command.rootSignature));
+					}
+				}break;
+
+				case CommandType::SetPipelineState:
+				{
+					const SetPipelineStateCommand& command = CommandStream::GetCommand<SetPipelineStateCommand>(header);
+					commandList->SetPipelineState(FromCommandHandle<ID3D12PipelineState>(command.pipelineState));
+				}break;
+
+				case CommandType::SetRootConstants:
+				{
+					const SetRootConstantsCommand& command = CommandStream::GetCommand<SetRootConstantsCommand>(header);
+					const std::span<const uint32_t> values = CommandStream::GetRootConstants(header);
+
+					if (command.bindPoint == PipelineBindPoint::Graphics)
+					{
+						commandList->SetGraphicsRoot32BitConstants(command.rootParameterIndex, command.valueCount, values.data(), 0u);
+					}
+					else
+					{
+						commandList->SetComputeRoot32BitConstants(command.rootParameterIndex, command.valueCount, values.data(), 0u);
+					}
+				}break;
+
+				case CommandType::SetIndexBuffer:
+				{
+					const SetIndexBufferCommand& command = CommandStream::GetCommand<SetIndexBufferCommand>(header);
+
+					const D3D12_INDEX_BUFFER_VIEW indexBufferView
+					{
+						.BufferLocation = command.bufferLocation,
+						.SizeInBytes = command.sizeInBytes,
+						.Format = static_cast<DXGI_FORMAT>(command.format),
+					};
+
+					commandList->IASetIndexBuffer(&indexBufferView);
+				}break;
+
+				case CommandType::SetPrimitiveTopology:
+				{
+					const SetPrimitiveTopologyCommand& command = CommandStream::GetCommand<SetPrimitiveTopologyCommand>(header);
+					commandList->IASetPrimitiveTopology(static_cast<D3D12_PRIMITIVE_TOPOLOGY>(command.primitiveTopology));
+				}break;
+
+				case CommandType::SetViewport:
+				{
+					const SetViewportCommand& command = CommandStream::GetCommand<SetViewportCommand>(header);
+
+					const D3D12_VIEWPORT viewport
+					{
+						.TopLeftX = command.topLeftX,
+						.TopLeftY = command.topLeftY,
+						.Width = command.width,
+						.Height = command.height,
+						.MinDepth = command.minDepth,
+						.MaxDepth = command.maxDepth,
+					};
+
+					static constexpr D3D12_RECT scissorRect
+					{
+						.left = 0u,
+						.top = 0u,
+						.right = LONG_MAX,
+						.bottom = LONG_MAX
+					};
+
+					commandList->RSSetViewports(1u, &viewport);
+					commandList->RSSetScissorRects(1u, &scissorRect);
+				}break;
+
+				case CommandType::SetRenderTargets:
+				{
+					const SetRenderTargetsCommand& command = CommandStream::GetCommand<SetRenderTargetsCommand>(header);
+
+					std::array<D3D12_CPU_DESCRIPTOR_HANDLE, MAX_RENDER_TARGETS> renderTargets{};
+					for (uint32_t i : std::views::iota(0u, command.renderTargetCount))
+					{
+						renderTargets[i].ptr = static_cast<SIZE_T>(command.renderTargets[i]);
+					}
+
+					const D3D12_CPU_DESCRIPTOR_HANDLE depthStencil{ .ptr = static_cast<SIZE_T>(command.depthStencil) };
+
+					commandList->OMSetRenderTargets(command.renderTargetCount, command.renderTargetCount != 0u ? renderTargets.data() : nullptr, command.isSingleHandleToDescriptorRange ? TRUE : FALSE, command.depthStencil != 0u ? &depthStencil : nullptr);
+				}break;
+
+				case CommandType::ClearRenderTarget:
+				{
+					const ClearRenderTargetCommand& command = CommandStream::GetCommand<ClearRenderTargetCommand>(header);
+					commandList->ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE{ .ptr = static_cast<SIZE_T>(command.renderTarget) }, command.color.data(), 0u, nullptr);
+				}break;
+
+				case CommandType::ClearDepthStencil:
+				{
+					const ClearDepthStencilCommand& command = CommandStream::GetCommand<ClearDepthStencilCommand>(header);
+					commandList->ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE{ .ptr = static_cast<SIZE_T>(command.depthStencil) }, D3D12_CLEAR_FLAG_DEPTH, command.depth, 1, 0u, nullptr);
+				}break;
+
+				case CommandType::ResourceBarrier:
+				{
+					const ResourceBarrierCommand& command = CommandStream::GetCommand<ResourceBarrierCommand>(header);
+
+					switch (command.barrierType)
+					{
+						case BarrierType::Transition:
+						{
+							D3D12_RESOURCE_BARRIER_FLAGS flags{ D3D12_RESOURCE_BARRIER_FLAG_NONE };
+							if (command.split == BarrierSplit::Begin)
+							{
+								flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+							}
+							else if (command.split == BarrierSplit::End)
+							{
+								flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+							}
+
+							resourceBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(FromCommandHandle<ID3D12Resource>(command.resource), static_cast<D3D12_RESOURCE_STATES>(command.stateBefore), static_cast<D3D12_RESOURCE_STATES>(command.stateAfter), command.subresource, flags));
+						}break;
+
+						case BarrierType::Aliasing:
+						{
+							resourceBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(FromCommandHandle<ID3D12Resource>(command.resource), FromCommandHandle<ID3D12Resource>(command.resourceAfter)));
+						}break;
+
+						case BarrierType::UnorderedAccess:
+						{
+							resourceBarriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(FromCommandHandle<ID3D12Resource>(command.resource)));
+						}break;
+					}
+				}break;
+
+				case CommandType::Draw:
+				{
+					const DrawCommand& command = CommandStream::GetCommand<DrawCommand>(header);
+					commandList->DrawInstanced(command.vertexCountPerInstance, command.instanceCount, command.startVertexLocation, command.startInstanceLocation);
+				}break;
+
+				case CommandType::DrawIndexed:
+				{
+					const DrawIndexedCommand& command = CommandStream::GetCommand<DrawIndexedCommand>(header);
+					commandList->DrawIndexedInstanced(command.indexCountPerInstance, command.instanceCount, command.startIndexLocation, command.baseVertexLocation, command.startInstanceLocation);
+				}break;
+
+				case CommandType::ExecuteIndirect:
+				{
+					const ExecuteIndirectCommand& command = CommandStream::GetCommand<ExecuteIndirectCommand>(header);
+					commandList->ExecuteIndirect(FromCommandHandle<ID3D12CommandSignature>(command.commandSignature), command.maxCommandCount, FromCommandHandle<ID3D12Resource>(command.argumentBuffer),
+						command.argumentBufferOffset, FromCommandHandle<ID3D12Resource>(command.countBuffer), command.countBufferOffset);
+				}break;
+
+				case CommandType::Dispatch:
+				{
+					const DispatchCommand& command = CommandStream::GetCommand<DispatchCommand>(header);
+					commandList->Dispatch(command.threadGroupCountX, command.threadGroupCountY, command.threadGroupCountZ);
+				}break;
+
+				case CommandType::CopyResource:
+				{
+					const CopyResourceCommand& command = CommandStream::GetCommand<CopyResourceCommand>(header);
+					commandList->CopyResource(FromCommandHandle<ID3D12Resource>(command.destination), FromCommandHandle<ID3D12Resource>(command.source));
+				}break;
+			}
+		});
+
+		flushResourceBarriers();
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+#include "CommandQueue.hpp"
+
+namespace helios::gfx
+{
+	// D3D12 implementation of the RenderBackend : command handles are pointers to the D3D12 objects (or the CPU descriptor handles of the views), and command
+	// streams are translated into the command list of their context (see CommandStream::SetTranslationTarget), or into a command list of the queue otherwise.
+	// The command queues are owned by the Device.
+	class D3D12RenderBackend final : public RenderBackend
+	{
+	public:
+		D3D12RenderBackend(CommandQueue* const graphicsCommandQueue, CommandQueue* const computeCommandQueue, CommandQueue* const copyCommandQueue);
+
+		D3D12RenderBackend(const D3D12RenderBackend& other) = delete;
+		D3D12RenderBackend& operator=(const D3D12RenderBackend& other) = delete;
+
+		// The command streams are not cleared, as they are const : the caller clears them once executed.
+		uint64_t ExecuteCommandStreams(QueueType queueType, std::span<const CommandStream* const> commandStreams, std::span<const QueueWait> queueWaits) override;
+
+		uint64_t GetCompletedFenceValue(QueueType queueType) const override;
+		void WaitForFenceValue(QueueType queueType, uint64_t fenceValue) override;
+
+		// Consecutive barriers of the stream are batched into a single ResourceBarrier call. resourceBarriers is scratch memory, so it can be reused across calls.
+		static void TranslateCommandStream(ID3D12GraphicsCommandList1* const commandList, const CommandStream& commandStream, std::vector<D3D12_RESOURCE_BARRIER>& resourceBarriers);
+
+		static CommandHandle ToCommandHandle(const void* pointer) { return reinterpret_cast<CommandHandle>(pointer); }
+
+		template <typename T>
+		static T* FromCommandHandle(CommandHandle handle) { return reinterpret_cast<T*>(handle); }
+
+	private:
+		CommandQueue* GetCommandQueue(QueueType queueType) const { return mCommandQueues[static_cast<uint32_t>(queueType)]; }
+
+	private:
+		// Indexed by the queue type.
+		std::array<CommandQueue*, QUEUE_TYPE_COUNT> mCommandQueues{};
+
+		// Executions are serialized by the caller, so the scratch memory is shared by all of them.
+		std::vector<D3D12_RESOURCE_BARRIER> mTranslatedResourceBarriers{};
+	};
+}
@@ -69,4 +69,28 @@ namespace helios::gfx
 	{
 		Offset(mCurrentDescriptorHandle, offset);
 	}
+
+	uint32_t Descriptor::AllocateDescriptorIndex()
+	{
+		std::lock_guard<std::mutex> descriptorAllocationLockGuard(mDescriptorAllocationMutex);
+
+		if (!mFreeDescriptorIndices.empty())
+		{
+			uint32_t index = mFreeDescriptorIndices.back();
+			mFreeDescriptorIndices.pop_back();
+
+			return index;
+		}
+
+		uint32_t index = GetCurrentDescriptorIndex();
+		OffsetCurrentHandle();
+
+		return index;
+	}
+
+	void Descriptor::FreeDescriptorIndex(uint32_t index)
+	{
+		std::lock_guard<std::mutex> descriptorAllocationLockGuard(mDescriptorAllocationMutex);
+		mFreeDescriptorIndices.push_back(index);
+	}
 }
@@ -43,11 +43,20 @@ namespace helios::gfx
 
 		void OffsetCurrentHandle(uint32_t offset = 1u);
 
+		// Returns a previously freed index if available, otherwise returns the current descriptor index and offsets the current handle.
+		uint32_t AllocateDescriptorIndex();
+
+		// The index will be reused by AllocateDescriptorIndex, so the GPU must no longer reference it (see Device::DeferredRelease).
+		void FreeDescriptorIndex(uint32_t index);
+
 	private:
 		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mDescriptorHeap{};
 		uint32_t mDescriptorSize{};
 
 		DescriptorHandle mDescriptorHandleFromStart{};
 		DescriptorHandle mCurrentDescriptorHandle{};
+
+		std::vector<uint32_t> mFreeDescriptorIndices{};
+		std::mutex mDescriptorAllocationMutex{};
 	};
 }
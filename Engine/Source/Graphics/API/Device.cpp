@@ -39,6 +39,9 @@ namespace helios::gfx
 		mGraphicsCommandQueue->FlushQueue();
 		mComputeCommandQueue->FlushQueue();
 
+		// All queues are idle, so everything that has been released can be destroyed.
+		mDeferredReleaseQueue.Execute();
+
 		RenderTarget::DestroyResources();
 	}
 
@@ -130,16 +133,19 @@ namespace helios::gfx
 
 		// Create memory allocator.
 		mMemoryAllocator = std::make_unique<MemoryAllocator>(mDevice.Get(), mAdapter.Get());
+		mResidencyManager = std::make_unique<ResidencyManager>(mDevice.Get(), mMemoryAllocator.get(), NUMBER_OF_FRAMES);
 
 		// Create the command queue's.
 		mGraphicsCommandQueue = std::make_unique<CommandQueue>(mDevice.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT, L"Graphics Command Queue");
 		mComputeCommandQueue = std::make_unique<CommandQueue>(mDevice.Get(), D3D12_COMMAND_LIST_TYPE_COMPUTE, L"Compute Command Queue");
 		mCopyCommandQueue = std::make_unique<CommandQueue>(mDevice.Get(), D3D12_COMMAND_LIST_TYPE_COPY, L"Copy Command Queue");
+
+		mRenderBackend = std::make_unique<D3D12RenderBackend>(mGraphicsCommandQueue.get(), mComputeCommandQueue.get(), mCopyCommandQueue.get());
 		
 		// Create the descriptor heaps.
 		// note(rtarun9) : srvCbvUav descriptor count will be very high, because of mip maps.
 		mRtvDescriptor = std::make_unique<Descriptor>(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, D3D12_DESCRIPTOR_HEAP_FLAG_NONE, 50u, L"RTV Descriptor");
-		mDsvDescriptor = std::make_unique<Descriptor>(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, D3D12_DESCRIPTOR_HEAP_FLAG_NONE, 15u, L"DSV Descriptor");
+		mDsvDescriptor = std::make_unique<Descriptor>(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, D3D12_DESCRIPTOR_HEAP_FLAG_NONE, 30u, L"DSV Descriptor");
 		mSrvCbvUavDescriptor = std::make_unique<Descriptor>(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 8192u, L"SRV_CBV_UAV Descriptor");
 		mSamplerDescriptor = std::make_unique<Descriptor>(mDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE, 1000u, L"Sampler Descriptor");
 
@@ -216,6 +222,7 @@ namespace helios::gfx
 			mBackBuffers[i].backBufferResource->SetName(L"SwapChain BackBuffer");
 
 			mBackBuffers[i].backBufferDescriptorHandle = rtvHandle;
+			mBackBuffers[i].resourceStateHandle = mMemoryAllocator->GetResourceStateRegistry()->RegisterResource(reinterpret_cast<CommandHandle>(backBuffer.Get()), static_cast<uint32_t>(D3D12_RESOURCE_STATE_PRESENT));
 
 			mRtvDescriptor->Offset(rtvHandle);
 		}
@@ -228,15 +235,15 @@ namespace helios::gfx
 
 	void Device::ResizeBuffers()
 	{
+		// The swap chain's back buffers can only be resized once they are no longer referenced by the GPU, hence the graphics queue has to be waited upon.
+		// Other resources that are resized (render targets, etc) are released through the deferred release queue, so the other queues need not be flushed.
 		mGraphicsCommandQueue->FlushQueue();
-		mCopyCommandQueue->FlushQueue();
-		mComputeCommandQueue->FlushQueue();
 
 		// Resize the swap chain's back buffer.
 		for (int i  : std::views::iota(0u, NUMBER_OF_FRAMES))
 		{
+			mBackBuffers[i].resourceStateHandle.reset();
 			mBackBuffers[i].backBufferResource.Reset();
-			mFrameFenceValues[i] = mFrameFenceValues[mCurrentBackBufferIndex];
 		}
 
 		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
@@ -254,42 +261,149 @@ namespace helios::gfx
 
 	void Device::EndFrame()
 	{
+		// All command lists of the frame have been submitted by now, so the command allocators used in the frame are retired (and reused once the frame completes).
+		mGraphicsCommandQueue->EndFrame();
+		mComputeCommandQueue->EndFrame();
+		mCopyCommandQueue->EndFrame();
 	}
 
-	void Device::ExecuteContext(std::span<std::unique_ptr<GraphicsContext>> graphicsContext)
+	QueueSubmission Device::ExecuteContext(std::span<std::unique_ptr<GraphicsContext>> graphicsContext, std::span<const QueueSubmission> dependencies)
 	{
-		std::vector<ID3D12GraphicsCommandList1*> commandLists{};
-		for (auto& list : graphicsContext)
+		std::vector<Context*> contexts{};
+		for (auto& context : graphicsContext)
 		{
-			commandLists.push_back(list->GetCommandList());
+			contexts.push_back(context.get());
 		}
 
-		mFrameFenceValues[mCurrentBackBufferIndex] = mGraphicsCommandQueue->ExecuteCommandLists(commandLists);
+		return ExecuteContexts(QueueType::Graphics, contexts, dependencies);
 	}
 
-	void Device::ExecuteContext(std::span<std::unique_ptr<ComputeContext>> computeContext)
+	QueueSubmission Device::ExecuteContext(std::span<std::unique_ptr<ComputeContext>> computeContext, std::span<const QueueSubmission> dependencies)
 	{
-		std::vector<ID3D12GraphicsCommandList1*> commandLists{};
-		for (auto& list : computeContext)
+		std::vector<Context*> contexts{};
+		for (auto& context : computeContext)
 		{
-			commandLists.push_back(list->GetCommandList());
+			contexts.push_back(context.get());
 		}
 
-		// Execute commands recorded into the graphics context.
-		mFrameFenceValues[mCurrentBackBufferIndex] = mComputeCommandQueue->ExecuteCommandLists(commandLists);
+		return ExecuteContexts(QueueType::Compute, contexts, dependencies);
 	}
 
 	// Forward argument in a 'span compatible format' other overload.
-	void Device::ExecuteContext(std::unique_ptr<GraphicsContext> graphicsContext)
+	QueueSubmission Device::ExecuteContext(std::unique_ptr<GraphicsContext> graphicsContext, std::span<const QueueSubmission> dependencies)
 	{
 		std::array<std::unique_ptr<GraphicsContext>, 1u> context{ std::move(graphicsContext) };
-		ExecuteContext(context);
+		return ExecuteContext(context, dependencies);
 	}
 
-	void Device::ExecuteContext(std::unique_ptr<ComputeContext> computeContext)
+	QueueSubmission Device::ExecuteContext(std::unique_ptr<ComputeContext> computeContext, std::span<const QueueSubmission> dependencies)
 	{
 		std::array<std::unique_ptr<ComputeContext>, 1u> context{ std::move(computeContext) };
-		ExecuteContext(context);
+		return ExecuteContext(context, dependencies);
+	}
+
+	QueueSubmission Device::ExecuteContexts(QueueType queueType, std::span<Context* const> contexts, std::span<const QueueSubmission> dependencies)
+	{
+		if (contexts.empty())
+		{
+			return QueueSubmission{};
+		}
+
+		std::vector<CommandStream*> commandStreams{};
+		std::vector<uint64_t> residencyIds{};
+		for (Context* const context : contexts)
+		{
+			context->GetCommandStream().EndResourceTransitions();
+
+			commandStreams.push_back(&context->GetCommandStream());
+			residencyIds.insert(residencyIds.end(), context->GetResidencyIds().begin(), context->GetResidencyIds().end());
+		}
+
+		CommandQueue* commandQueue = GetCommandQueue(queueType);
+
+		mResidencyManager->MakeResident(residencyIds, commandQueue);
+
+		QueueSubmission queueSubmission
+		{
+			.queueType = queueType,
+		};
+
+		{
+			std::lock_guard<std::mutex> queueSchedulerLockGuard(mQueueSchedulerMutex);
+
+			// Note : Resolved under the lock, as the state the resources are left in by the previous submissions depends on the order of submission.
+			const ResolvedTransitions resolvedTransitions = mMemoryAllocator->GetResourceStateRegistry()->ResolvePendingTransitions(queueType, commandStreams);
+			const std::vector<ResourceBarrierCommand>& prologueBarriers = resolvedTransitions.prologueBarriers;
+
+			// The transitions the compute / copy command lists cannot execute are executed on the graphics queue first, which the submission waits for.
+			std::vector<QueueSubmission> submissionDependencies(dependencies.begin(), dependencies.end());
+			if (!resolvedTransitions.graphicsPrologueBarriers.empty())
+			{
+				std::unique_ptr<GraphicsContext> graphicsPrologueContext = GetGraphicsContext();
+				graphicsPrologueContext->GetCommandStream().RecordResolvedBarriers(resolvedTransitions.graphicsPrologueBarriers);
+				mCommandStreamStatistics += graphicsPrologueContext->GetCommandStreamStatistics();
+
+				const std::array<const CommandStream*, 1u> graphicsPrologueCommandStreams{ &graphicsPrologueContext->GetCommandStream() };
+
+				const QueueSubmission graphicsPrologueSubmission
+				{
+					.queueType = QueueType::Graphics,
+					.fenceValue = mRenderBackend->ExecuteCommandStreams(QueueType::Graphics, graphicsPrologueCommandStreams, {}),
+				};
+
+				mQueueScheduler.RecordSignal(QueueType::Graphics, graphicsPrologueSubmission.fenceValue);
+				mFrameContexts[mFrameNumber % NUMBER_OF_FRAMES].fenceValues[static_cast<uint32_t>(QueueType::Graphics)] = graphicsPrologueSubmission.fenceValue;
+
+				submissionDependencies.push_back(graphicsPrologueSubmission);
+			}
+
+			// Context has no virtual destructor, so the prologue context is owned through its actual type.
+			std::unique_ptr<GraphicsContext> prologueGraphicsContext{};
+			std::unique_ptr<ComputeContext> prologueComputeContext{};
+
+			std::vector<const CommandStream*> submittedCommandStreams{};
+			if (!prologueBarriers.empty())
+			{
+				Context* prologueContext{};
+				if (queueType == QueueType::Compute)
+				{
+					prologueComputeContext = GetComputeContext();
+					prologueContext = prologueComputeContext.get();
+				}
+				else
+				{
+					prologueGraphicsContext = GetGraphicsContext();
+					prologueContext = prologueGraphicsContext.get();
+				}
+
+				prologueContext->GetCommandStream().RecordResolvedBarriers(prologueBarriers);
+				mCommandStreamStatistics += prologueContext->GetCommandStreamStatistics();
+
+				submittedCommandStreams.push_back(&prologueContext->GetCommandStream());
+			}
+
+			for (CommandStream* const commandStream : commandStreams)
+			{
+				submittedCommandStreams.push_back(commandStream);
+				mCommandStreamStatistics += commandStream->GetStatistics();
+			}
+
+			const std::vector<QueueWait> queueWaits = mQueueScheduler.ResolveDependencies(queueType, submissionDependencies);
+
+			queueSubmission.fenceValue = mRenderBackend->ExecuteCommandStreams(queueType, submittedCommandStreams, queueWaits);
+			mQueueScheduler.RecordSignal(queueType, queueSubmission.fenceValue);
+
+			// The streams have been translated into the command lists of the contexts.
+			for (CommandStream* const commandStream : commandStreams)
+			{
+				commandStream->Clear();
+			}
+
+			// Note : Written under the lock, as contexts are submitted from several threads (and Present advances the frame under the same lock).
+			mFrameContexts[mFrameNumber % NUMBER_OF_FRAMES].fenceValues[static_cast<uint32_t>(queueType)] = queueSubmission.fenceValue;
+		}
+
+		return queueSubmission;
 	}
 
 	void Device::Present()
@@ -299,58 +413,171 @@ namespace helios::gfx
 
 		ThrowIfFailed(mSwapChain->Present(syncInterval, presentFlags));
 
+		// All work of the frame (and that could reference objects released this frame) has been submitted by now.
+		DeferredExecutionQueue::FenceValues frameFenceValues{};
+
+		{
+			std::lock_guard<std::mutex> queueSchedulerLockGuard(mQueueSchedulerMutex);
+
+			FrameContext& frameContext = mFrameContexts[mFrameNumber % NUMBER_OF_FRAMES];
+			frameContext.frameNumber = mFrameNumber;
+			frameContext.fenceValues = GetLastSignaledFenceValues();
+			frameFenceValues = frameContext.fenceValues;
+
+			mFrameNumber++;
+		}
+
+		mDeferredReleaseQueue.TagPendingFunctions(frameFenceValues);
+
 		mCurrentBackBufferIndex = mSwapChain->GetCurrentBackBufferIndex();
 
-		mGraphicsCommandQueue->WaitForFenceValue(mFrameFenceValues[mCurrentBackBufferIndex]);
+		Buffer::sFrameNumber.store(mFrameNumber, std::memory_order_release);
+
+		// The frame being recorded next can only start once at most mMaxFrameLatency frames are in flight.
+		// As mMaxFrameLatency < NUMBER_OF_FRAMES, the frame context (and the constant buffer versions / back buffer) of the frame waited upon are reused by the next frame at the earliest.
+		const std::chrono::high_resolution_clock::time_point waitStartTime = std::chrono::high_resolution_clock::now();
+
+		if (mFrameNumber > mMaxFrameLatency)
+		{
+			const FrameContext& completedFrameContext = mFrameContexts[(mFrameNumber - mMaxFrameLatency - 1u) % NUMBER_OF_FRAMES];
+
+			for (uint32_t queueIndex = 0u; queueIndex < QUEUE_TYPE_COUNT; ++queueIndex)
+			{
+				mRenderBackend->WaitForFenceValue(static_cast<QueueType>(queueIndex), completedFrameContext.fenceValues[queueIndex]);
+			}
+		}
+
+		const std::chrono::high_resolution_clock::time_point waitEndTime = std::chrono::high_resolution_clock::now();
+
+		mFrameStatistics.gpuWaitTime = std::chrono::duration<double, std::milli>(waitEndTime - waitStartTime).count();
+		mFrameStatistics.cpuFrameTime = std::chrono::duration<double, std::milli>(waitEndTime - mLastPresentTime).count();
+		mLastPresentTime = waitEndTime;
+
+		mFrameStatistics.framesInFlight = 0u;
+		for (const FrameContext& inFlightFrameContext : mFrameContexts)
+		{
+			if (inFlightFrameContext.frameNumber < mFrameNumber && mRenderBackend->GetCompletedFenceValue(QueueType::Graphics) < inFlightFrameContext.fenceValues[0])
+			{
+				mFrameStatistics.framesInFlight++;
+			}
+		}
+
+		const DeferredExecutionQueue::FenceValues completedFenceValues = GetCompletedFenceValues();
+
+		mDeferredReleaseQueue.ExecuteCompletedFunctions(completedFenceValues);
+
+		{
+			std::lock_guard<std::mutex> queueSchedulerLockGuard(mQueueSchedulerMutex);
+			mQueueScheduler.SetCompletedFenceValues(completedFenceValues);
+
+			mFrameStatistics.commandStreamStatistics = std::exchange(mCommandStreamStatistics, {});
+		}
+
+		// Resources not used in the last NUMBER_OF_FRAMES frames are no longer referenced by the GPU, and can be evicted.
+		mResidencyManager->EndFrame();
+	}
+
+	void Device::DeferredRelease(std::unique_ptr<Allocation> allocation)
+	{
+		if (!allocation)
+		{
+			return;
+		}
+
+		// std::function requires the callable to be copy constructible.
+		std::shared_ptr<Allocation> sharedAllocation = std::move(allocation);
+		mDeferredReleaseQueue.PushFunction([sharedAllocation]() { sharedAllocation->Reset(); });
+	}
+
+	void Device::DeferredRelease(Descriptor* descriptor, uint32_t descriptorIndex)
+	{
+		mDeferredReleaseQueue.PushFunction([=]() { descriptor->FreeDescriptorIndex(descriptorIndex); });
+	}
+
+	CommandQueue* Device::GetCommandQueue(QueueType queueType) const
+	{
+		switch (queueType)
+		{
+			case QueueType::Compute:
+			{
+				return mComputeCommandQueue.get();
+			}break;
+
+			case QueueType::Copy:
+			{
+				return mCopyCommandQueue.get();
+			}break;
+
+			default:
+			{
+				return mGraphicsCommandQueue.get();
+			}break;
+		}
+	}
+
+	QueueSchedulerStatistics Device::GetQueueSchedulerStatistics() const
+	{
+		std::lock_guard<std::mutex> queueSchedulerLockGuard(mQueueSchedulerMutex);
+		return mQueueScheduler.GetStatistics();
+	}
+
+	DeferredExecutionQueue::FenceValues Device::GetLastSignaledFenceValues() const
+	{
+		return DeferredExecutionQueue::FenceValues
+		{
+			mGraphicsCommandQueue->GetLastSignaledFenceValue(),
+			mComputeCommandQueue->GetLastSignaledFenceValue(),
+			mCopyCommandQueue->GetLastSignaledFenceValue(),
+		};
+	}
+
+	DeferredExecutionQueue::FenceValues Device::GetCompletedFenceValues() const
+	{
+		return DeferredExecutionQueue::FenceValues
+		{
+			mGraphicsCommandQueue->GetCompletedFenceValue(),
+			mComputeCommandQueue->GetCompletedFenceValue(),
+			mCopyCommandQueue->GetCompletedFenceValue(),
+		};
 	}
 
 	uint32_t Device::CreateSrv(const SrvCreationDesc& srvCreationDesc, ID3D12Resource* resource) const
 	{
-		uint32_t srvIndex = mSrvCbvUavDescriptor->GetCurrentDescriptorIndex();
-		mDevice->CreateShaderResourceView(resource, &srvCreationDesc.srvDesc, mSrvCbvUavDescriptor->GetCurrentDescriptorHandle().cpuDescriptorHandle);
-		
-		mSrvCbvUavDescriptor->OffsetCurrentHandle();
+		uint32_t srvIndex = mSrvCbvUavDescriptor->AllocateDescriptorIndex();
+		mDevice->CreateShaderResourceView(resource, &srvCreationDesc.srvDesc, mSrvCbvUavDescriptor->GetDescriptorHandleFromIndex(srvIndex).cpuDescriptorHandle);
 
 		return srvIndex;
 	}
 
 	uint32_t Device::CreateRtv(const RtvCreationDesc& rtvCreationDesc, ID3D12Resource* resource) const
 	{
-		uint32_t rtvIndex = mRtvDescriptor->GetCurrentDescriptorIndex();
-		mDevice->CreateRenderTargetView(resource, nullptr,  mRtvDescriptor->GetCurrentDescriptorHandle().cpuDescriptorHandle);
-		
-		mRtvDescriptor->OffsetCurrentHandle();
+		uint32_t rtvIndex = mRtvDescriptor->AllocateDescriptorIndex();
+		mDevice->CreateRenderTargetView(resource, nullptr, mRtvDescriptor->GetDescriptorHandleFromIndex(rtvIndex).cpuDescriptorHandle);
 
 		return rtvIndex;
 	}
 
 	uint32_t Device::CreateDsv(const DsvCreationDesc& dsvCreationDesc, ID3D12Resource* resource) const
 	{
-		uint32_t dsvIndex = mDsvDescriptor->GetCurrentDescriptorIndex();
-		mDevice->CreateDepthStencilView(resource, &dsvCreationDesc.dsvDesc, mDsvDescriptor->GetCurrentDescriptorHandle().cpuDescriptorHandle);
-
-		mDsvDescriptor->OffsetCurrentHandle();
+		uint32_t dsvIndex = mDsvDescriptor->AllocateDescriptorIndex();
+		mDevice->CreateDepthStencilView(resource, &dsvCreationDesc.dsvDesc, mDsvDescriptor->GetDescriptorHandleFromIndex(dsvIndex).cpuDescriptorHandle);
 
 		return dsvIndex;
 	}
 
 	uint32_t Device::CreateUav(const UavCreationDesc& uavCreationDesc, ID3D12Resource* resource) const
 	{
-		uint32_t uavIndex = mSrvCbvUavDescriptor->GetCurrentDescriptorIndex();
-		mDevice->CreateUnorderedAccessView(resource, nullptr, &uavCreationDesc.uavDesc, mSrvCbvUavDescriptor->GetCurrentDescriptorHandle().cpuDescriptorHandle);
-
-		mSrvCbvUavDescriptor->OffsetCurrentHandle();
+		uint32_t uavIndex = mSrvCbvUavDescriptor->AllocateDescriptorIndex();
+		mDevice->CreateUnorderedAccessView(resource, nullptr, &uavCreationDesc.uavDesc, mSrvCbvUavDescriptor->GetDescriptorHandleFromIndex(uavIndex).cpuDescriptorHandle);
 
 		return uavIndex;
 	}
 
 	uint32_t Device::CreateCbv(const CbvCreationDesc& cbvCreationDesc) const
 	{
-		uint32_t cbvIndex = mSrvCbvUavDescriptor->GetCurrentDescriptorIndex();
+		uint32_t cbvIndex = mSrvCbvUavDescriptor->AllocateDescriptorIndex();
 
-		mDevice->CreateConstantBufferView(&cbvCreationDesc.cbvDesc, mSrvCbvUavDescriptor->GetCurrentDescriptorHandle().cpuDescriptorHandle);
-
-		mSrvCbvUavDescriptor->OffsetCurrentHandle();
+		mDevice->CreateConstantBufferView(&cbvCreationDesc.cbvDesc, mSrvCbvUavDescriptor->GetDescriptorHandleFromIndex(cbvIndex).cpuDescriptorHandle);
 
 		return cbvIndex;
 	}
@@ -420,6 +647,12 @@ namespace helios::gfx
 
 		texture.allocation = mMemoryAllocator->CreateTextureResourceAllocation(textureCreationDesc);
 
+		// Render targets / depth stencil textures are used every frame, so they are not considered for eviction.
+		if (textureCreationDesc.usage != TextureUsage::RenderTarget && textureCreationDesc.usage != TextureUsage::DepthStencil)
+		{
+			mResidencyManager->RegisterAllocation(texture.allocation.get());
+		}
+
 		texture.dimensions = textureCreationDesc.dimensions;
 
 		uint32_t mipLevels = textureCreationDesc.mipLevels;
@@ -505,6 +738,9 @@ namespace helios::gfx
 			};
 
 			texture.dsvIndex = CreateDsv(dsvCreationDesc, texture.allocation->resource.Get());
+
+			dsvCreationDesc.dsvDesc.Flags = D3D12_DSV_FLAG_READ_ONLY_DEPTH;
+			texture.readOnlyDsvIndex = CreateDsv(dsvCreationDesc, texture.allocation->resource.Get());
 		}
 		
 		// Create RTV (if applicable).
@@ -606,9 +842,16 @@ namespace helios::gfx
 			stbi_image_free(hdrTextureData);
 		}
 
-		// Generate mip maps.
+		// Generate mip maps (or defer their generation to the submission of the batch, so the textures of a model are processed by a single submission).
 		texture.textureName = textureCreationDesc.name;
-		mMipMapGenerator->GenerateMips(&texture);
+		if (textureCreationDesc.mipMapGenerationBatch)
+		{
+			textureCreationDesc.mipMapGenerationBatch->AddTexture(texture.GetResource());
+		}
+		else
+		{
+			mMipMapGenerator->GenerateMips(&texture);
+		}
 
 		core::LogMessage(L"Created texture : " + texture.textureName, core::LogMessageTypes::Info);
 
@@ -630,10 +873,7 @@ namespace helios::gfx
 	void Device::ResizeRenderTarget(RenderTarget* renderTarget)
 	{
 		D3D12_RESOURCE_DESC resourceDesc = renderTarget->renderTexture->GetResource()->GetDesc();
-		resourceDesc.Width = core::Application::GetClientDimensions().x;
-		resourceDesc.Height = core::Application::GetClientDimensions().y;
 
-		// Recreate RTV.
 		TextureCreationDesc textureCreationDesc
 		{
 			.usage = gfx::TextureUsage::RenderTarget,
@@ -642,20 +882,67 @@ namespace helios::gfx
 			.name = renderTarget->renderTargetName
 		};
 
-		renderTarget->renderTexture->allocation->Reset();
+		ResizeTexture(renderTarget->renderTexture.get(), textureCreationDesc);
+	}
+
+	void Device::ResizeTexture(Texture* texture, TextureCreationDesc& textureCreationDesc)
+	{
+		// Frames in flight may still reference the old resource and its descriptors, so they are released only once the GPU is done with them.
+		// New descriptors are created (rather than overwriting the existing ones), hence the texture's descriptor indices can change.
+		DeferredRelease(std::move(texture->allocation));
+		DeferredRelease(mSrvCbvUavDescriptor.get(), texture->srvIndex);
 
 		// Recreate allocation.
-		renderTarget->renderTexture->allocation = mMemoryAllocator->CreateTextureResourceAllocation(textureCreationDesc);
+		texture->allocation = mMemoryAllocator->CreateTextureResourceAllocation(textureCreationDesc);
+		texture->dimensions = textureCreationDesc.dimensions;
+
+		D3D12_RESOURCE_DESC resourceDesc = texture->GetResource()->GetDesc();
+
+		// Depth textures are viewed as R32_FLOAT by SRV's (same as in CreateTexture).
+		DXGI_FORMAT srvFormat{ resourceDesc.Format };
+		if (resourceDesc.Format == DXGI_FORMAT_D32_FLOAT)
+		{
+			srvFormat = DXGI_FORMAT_R32_FLOAT;
+		}
 
-		DescriptorHandle rtvHandle = mRtvDescriptor->GetDescriptorHandleFromIndex(renderTarget->renderTexture->rtvIndex);
-		mDevice->CreateRenderTargetView(renderTarget->renderTexture->GetResource(), nullptr, rtvHandle.cpuDescriptorHandle);
+		// Recreate RTV / DSV.
+		if (textureCreationDesc.usage == TextureUsage::RenderTarget)
+		{
+			DeferredRelease(mRtvDescriptor.get(), texture->rtvIndex);
+
+			texture->rtvIndex = CreateRtv(RtvCreationDesc{}, texture->GetResource());
+		}
+		else if (textureCreationDesc.usage == TextureUsage::DepthStencil)
+		{
+			DeferredRelease(mDsvDescriptor.get(), texture->dsvIndex);
+			DeferredRelease(mDsvDescriptor.get(), texture->readOnlyDsvIndex);
+
+			DsvCreationDesc dsvCreationDesc
+			{
+				.dsvDesc
+				{
+					.Format = DXGI_FORMAT_D32_FLOAT,
+					.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
+					.Flags = D3D12_DSV_FLAG_NONE,
+					.Texture2D
+					{
+						.MipSlice = 0u
+					},
+				}
+			};
+
+			texture->dsvIndex = CreateDsv(dsvCreationDesc, texture->GetResource());
+
+			dsvCreationDesc.dsvDesc.Flags = D3D12_DSV_FLAG_READ_ONLY_DEPTH;
+			texture->readOnlyDsvIndex = CreateDsv(dsvCreationDesc, texture->GetResource());
+		}
 
 		// ReCreate SRV.
 		SrvCreationDesc srvCreationDesc
 		{
 			.srvDesc
 			{
-				.Format = resourceDesc.Format,
+				.Format = srvFormat,
 				.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
 				.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
 				.Texture2D
@@ -665,9 +952,8 @@ namespace helios::gfx
 				}
 			}
 		};
-		
-		DescriptorHandle srvHandle = mSrvCbvUavDescriptor->GetDescriptorHandleFromIndex(renderTarget->renderTexture->srvIndex);
-		mDevice->CreateShaderResourceView(renderTarget->renderTexture->GetResource(), &srvCreationDesc.srvDesc, srvHandle.cpuDescriptorHandle);
+
+		texture->srvIndex = CreateSrv(srvCreationDesc, texture->GetResource());
 	}
 
 	PipelineState Device::CreatePipelineState(const GraphicsPipelineStateCreationDesc& graphicsPipelineStateCreationDesc) const
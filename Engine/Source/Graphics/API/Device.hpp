@@ -7,9 +7,42 @@
 #include "PipelineState.hpp"
 #include "ComputeContext.hpp"
 #include "MipMapGenerator.hpp"
+#include "ResidencyManager.hpp"
+#include "QueueScheduler.hpp"
+#include "D3D12RenderBackend.hpp"
 
 namespace helios::gfx
 {
+	// State of a frame that the CPU has recorded ahead of the GPU. The other per frame resources are keyed by the frame's fences :
+	// CPU written data (constant buffers) is versioned per frame (see Buffer::Update), command allocators are retired with the fence values of their command lists (see CommandAllocatorPool),
+	// and resources released during the frame are destroyed through the deferred release queue.
+	struct FrameContext
+	{
+		uint64_t frameNumber{};
+
+		// Fence values (graphics, compute and copy queue) signalled by the frame's last submission.
+		DeferredExecutionQueue::FenceValues fenceValues{};
+	};
+
+	// Measured in Device::Present (times in milliseconds).
+	struct FrameStatistics
+	{
+		// Time between the end of the last two Present calls.
+		double cpuFrameTime{};
+
+		// Time the CPU was blocked waiting for an earlier frame to complete on the GPU.
+		double gpuWaitTime{};
+
+		// Frames submitted but not yet completed by the GPU, once Present returns.
+		uint32_t framesInFlight{};
+
+		// Commands recorded (and filtered out) by the contexts executed during the frame.
+		CommandStreamStatistics commandStreamStatistics{};
+
+		// Fraction of the CPU frame time spent recording (rather than waiting for the GPU) : close to 1 when the CPU and GPU work overlap.
+		double GetCpuGpuOverlap() const { return cpuFrameTime > 0.0 ? 1.0 - std::min(gpuWaitTime / cpuFrameTime, 1.0) : 0.0; }
+	};
+
 	// Abstraction for creating / destroying various graphics resources.
 	// Encapsulates most renderer resources / objects in use : the swap chain, descriptor heaps, command queue's, etc.
 	// Inspired from : https://alextardif.com/DX12Tutorial.html.
@@ -38,14 +71,17 @@ namespace helios::gfx
 
 		CommandQueue* GetGraphicsCommandQueue() const { return mGraphicsCommandQueue.get(); }
 		CommandQueue* GetComputeCommandQueue() const { return mComputeCommandQueue.get(); }
+		CommandQueue* GetCopyCommandQueue() const { return mCopyCommandQueue.get(); }
+		CommandQueue* GetCommandQueue(QueueType queueType) const;
 
 		MemoryAllocator* GetMemoryAllocator() const { return mMemoryAllocator.get(); }
+		ResidencyManager* GetResidencyManager() const { return mResidencyManager.get(); }
 		BackBuffer* GetCurrentBackBuffer() { return &mBackBuffers[mCurrentBackBufferIndex]; }
 		
 		std::unique_ptr<GraphicsContext> const  GetGraphicsContext(const gfx::PipelineState* pipelineState = nullptr) { return std::move(std::make_unique<GraphicsContext>(this, pipelineState)); }
 		std::unique_ptr<ComputeContext> const GetComputeContext(const gfx::PipelineState* pipelineState = nullptr) { return std::move(std::make_unique<ComputeContext>(this, pipelineState)); }
 		
-		MipMapGenerator* GetMipMapGenerator()  { return mMipMapGenerator.get(); }
+		MipMapGenerator* GetMipMapGenerator() const { return mMipMapGenerator.get(); }
 		
 		// Misc getters for resources and their contents.
 		DescriptorHandle const GetTextureSrvDescriptorHandle(const Texture* texture) { return mSrvCbvUavDescriptor->GetDescriptorHandleFromIndex(texture->srvIndex); }
@@ -62,14 +98,25 @@ namespace helios::gfx
 		void BeginFrame();
 		void EndFrame();
 
-		void ExecuteContext(std::span<std::unique_ptr<GraphicsContext>> graphicsContext);
-		void ExecuteContext(std::span<std::unique_ptr<ComputeContext>> computeContext);
+		// The submission only starts executing once its dependencies (submissions to any queue) have completed. Cross queue dependencies are resolved by the QueueScheduler into
+		// GPU side waits, so the CPU never blocks : compute work can be submitted asynchronously and overlap with the graphics queue.
+		// The returned submission can be used as a dependency of later submissions. Executing no contexts returns an empty submission.
+		QueueSubmission ExecuteContext(std::span<std::unique_ptr<GraphicsContext>> graphicsContext, std::span<const QueueSubmission> dependencies = {});
+		QueueSubmission ExecuteContext(std::span<std::unique_ptr<ComputeContext>> computeContext, std::span<const QueueSubmission> dependencies = {});
 
-		void ExecuteContext(std::unique_ptr<GraphicsContext> graphicsContext);
-		void ExecuteContext(std::unique_ptr<ComputeContext> computeContext);
+		QueueSubmission ExecuteContext(std::unique_ptr<GraphicsContext> graphicsContext, std::span<const QueueSubmission> dependencies = {});
+		QueueSubmission ExecuteContext(std::unique_ptr<ComputeContext> computeContext, std::span<const QueueSubmission> dependencies = {});
 	
 		void Present();
 
+		// Number of frames the GPU can be executing while the CPU records the next frame, in [1, NUMBER_OF_FRAMES - 1].
+		void SetMaxFrameLatency(uint32_t maxFrameLatency) { mMaxFrameLatency = std::clamp(maxFrameLatency, 1u, NUMBER_OF_FRAMES - 1u); }
+		uint32_t GetMaxFrameLatency() const { return mMaxFrameLatency; }
+
+		uint64_t GetFrameNumber() const { return mFrameNumber; }
+		const FrameStatistics& GetFrameStatistics() const { return mFrameStatistics; }
+		QueueSchedulerStatistics GetQueueSchedulerStatistics() const;
+
 		// Helper creation functions.
 		uint32_t CreateSrv(const SrvCreationDesc& srvCreationDesc, ID3D12Resource* resource) const;
 		uint32_t CreateRtv(const RtvCreationDesc& rtvCreationDesc, ID3D12Resource* resource) const;
@@ -93,14 +140,31 @@ namespace helios::gfx
 		// Resource resizing operations.
 		void ResizeRenderTarget(RenderTarget* renderTarget);
 
+		// Recreates the texture's allocation from the creation desc (new dimensions and / or placement) along with its views.
+		// The old allocation and descriptors are released using the deferred release queue, so the descriptor indices of the texture change.
+		void ResizeTexture(Texture* texture, TextureCreationDesc& textureCreationDesc);
+
+		// Released objects are destroyed / reused only once all command queues have completed the work submitted until the end of the current frame.
+		void DeferredRelease(std::unique_ptr<Allocation> allocation);
+		void DeferredRelease(Descriptor* descriptor, uint32_t descriptorIndex);
+
 		// VSync related functions.
 		void EnableVSync() { mVSync = true; }
 		void DisableVSync() { mVSync = false; }
 
 	public:
 		// Number of SwapChain back buffers.
-		static constexpr uint8_t NUMBER_OF_FRAMES = 3u;
+		static constexpr uint32_t NUMBER_OF_FRAMES = MAX_FRAMES_IN_FLIGHT;
 		static constexpr DXGI_FORMAT SWAPCHAIN_FORMAT = DXGI_FORMAT_R10G10B10A2_UNORM;
+	private:
+		// Fence values of the graphics, compute and copy queue (in that order), used to key the deferred release queue.
+		DeferredExecutionQueue::FenceValues GetLastSignaledFenceValues() const;
+		DeferredExecutionQueue::FenceValues GetCompletedFenceValues() const;
+
+		// The resource states the streams of the contexts expect at their start are resolved on submission (see ResourceStateRegistry) : the barriers
+		// required by the first context are executed by a prologue command list.
+		QueueSubmission ExecuteContexts(QueueType queueType, std::span<Context* const> contexts, std::span<const QueueSubmission> dependencies);
+
 	private:
 		Microsoft::WRL::ComPtr<ID3D12Device5> mDevice{};
 		Microsoft::WRL::ComPtr<ID3D12DebugDevice2> mDebugDevice{};
@@ -120,9 +184,16 @@ namespace helios::gfx
 		uint32_t mCurrentBackBufferIndex{};
 		std::array<BackBuffer, NUMBER_OF_FRAMES> mBackBuffers{};
 
-		std::array<uint64_t, NUMBER_OF_FRAMES> mFrameFenceValues{};
+		// Indexed by frame number % NUMBER_OF_FRAMES.
+		std::array<FrameContext, NUMBER_OF_FRAMES> mFrameContexts{};
+		uint64_t mFrameNumber{};
+		uint32_t mMaxFrameLatency{ NUMBER_OF_FRAMES - 1u };
+
+		FrameStatistics mFrameStatistics{};
+		std::chrono::high_resolution_clock::time_point mLastPresentTime{};
 
 		std::unique_ptr<MemoryAllocator> mMemoryAllocator{};
+		std::unique_ptr<ResidencyManager> mResidencyManager{};
 
 		std::unique_ptr<Descriptor> mRtvDescriptor{};
 		std::unique_ptr<Descriptor> mDsvDescriptor{};
@@ -133,8 +204,20 @@ namespace helios::gfx
 		std::unique_ptr<CommandQueue> mComputeCommandQueue{};
 		std::unique_ptr<CommandQueue> mCopyCommandQueue{};
 
+		// Contexts are submitted (and the frames waited upon) through the render backend interface, which is implemented over the command queues.
+		std::unique_ptr<RenderBackend> mRenderBackend{};
+
+		// Guards the scheduler along with the submissions it resolves, so signals are recorded in submission order.
+		QueueScheduler mQueueScheduler{};
+		mutable std::mutex mQueueSchedulerMutex{};
+
+		// Accumulated on submission until the end of the frame (guarded by mQueueSchedulerMutex).
+		CommandStreamStatistics mCommandStreamStatistics{};
+
 		std::unique_ptr<MipMapGenerator> mMipMapGenerator{};
 
+		DeferredExecutionQueue mDeferredReleaseQueue{};
+
 		// Mutex is used primarily to prevent race conditions where more than one resource has the same index.
 		mutable std::recursive_mutex mResourceMutex{};
 	};
@@ -149,10 +232,28 @@ namespace helios::gfx
 
 		buffer.sizeInBytes = numberComponents * sizeof(T);
 
-		ResourceCreationDesc resourceCreationDesc = ResourceCreationDesc::CreateBufferResourceCreationDesc(buffer.sizeInBytes);
+		// Constant buffers hold one version of the data per frame in flight (see Buffer::Update).
+		if (bufferCreationDesc.usage == BufferUsage::ConstantBuffer)
+		{
+			buffer.versionSizeInBytes = (buffer.sizeInBytes + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1u) & ~static_cast<size_t>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1u);
+		}
+
+		ResourceCreationDesc resourceCreationDesc = ResourceCreationDesc::CreateBufferResourceCreationDesc(bufferCreationDesc.usage == BufferUsage::ConstantBuffer ? buffer.versionSizeInBytes * MAX_FRAMES_IN_FLIGHT : buffer.sizeInBytes);
 
 
-		buffer.allocation = mMemoryAllocator->CreateBufferResourceAllocation(bufferCreationDesc, resourceCreationDesc);
+		// Note : Upload buffers can't allow unordered access, so the flag is only set on the buffer's own resource.
+		ResourceCreationDesc bufferResourceCreationDesc = resourceCreationDesc;
+		if (bufferCreationDesc.usage == BufferUsage::UAVBuffer)
+		{
+			bufferResourceCreationDesc.resourceDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+		}
+
+		buffer.allocation = mMemoryAllocator->CreateBufferResourceAllocation(bufferCreationDesc, bufferResourceCreationDesc);
+
+		if (bufferCreationDesc.usage == BufferUsage::IndexBuffer || bufferCreationDesc.usage == BufferUsage::StructuredBuffer || bufferCreationDesc.usage == BufferUsage::UAVBuffer)
+		{
+			mResidencyManager->RegisterAllocation(buffer.allocation.get());
+		}
 
 		std::lock_guard<std::recursive_mutex> resourceLockGuard(mResourceMutex);
 		// Currently, not using a backing storage for upload context's and such. Simply using D3D12MA to create a upload buffer, copy the data onto the upload buffer,
@@ -178,7 +279,7 @@ namespace helios::gfx
 			uploadAllocation->Reset();
 		}
 
-		if (bufferCreationDesc.usage == BufferUsage::StructuredBuffer)
+		if (bufferCreationDesc.usage == BufferUsage::StructuredBuffer || bufferCreationDesc.usage == BufferUsage::UAVBuffer)
 		{
 			SrvCreationDesc srvCreationDesc
 			{
@@ -197,20 +298,43 @@ namespace helios::gfx
 			};
 
 			buffer.srvIndex = CreateSrv(srvCreationDesc, buffer.allocation->resource.Get());
+
+			if (bufferCreationDesc.usage == BufferUsage::UAVBuffer)
+			{
+				UavCreationDesc uavCreationDesc
+				{
+					.uavDesc
+					{
+						.Format = DXGI_FORMAT_UNKNOWN,
+						.ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
+						.Buffer
+						{
+							.FirstElement = 0u,
+							.NumElements = numberComponents,
+							.StructureByteStride = static_cast<UINT>(sizeof(T))
+						}
+					}
+				};
+
+				buffer.uavIndex = CreateUav(uavCreationDesc, buffer.allocation->resource.Get());
+			}
 		}
 
 		else if (bufferCreationDesc.usage == BufferUsage::ConstantBuffer)
 		{
-			CbvCreationDesc cbvCreationDesc
+			for (uint32_t version : std::views::iota(0u, MAX_FRAMES_IN_FLIGHT))
 			{
-				.cbvDesc
+				CbvCreationDesc cbvCreationDesc
 				{
-					.BufferLocation = buffer.allocation->resource->GetGPUVirtualAddress(),
-					.SizeInBytes = static_cast<UINT>(buffer.sizeInBytes)
-				}
-			};
+					.cbvDesc
+					{
+						.BufferLocation = buffer.allocation->resource->GetGPUVirtualAddress() + version * buffer.versionSizeInBytes,
+						.SizeInBytes = static_cast<UINT>(buffer.versionSizeInBytes)
+					}
+				};
 
-			buffer.cbvIndex = CreateCbv(cbvCreationDesc);
+				buffer.cbvIndices[version] = CreateCbv(cbvCreationDesc);
+			}
 		}
 
 		buffer.bufferName = bufferCreationDesc.name;
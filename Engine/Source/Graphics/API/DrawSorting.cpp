@@ -0,0 +1,250 @@
+#include "DrawSorting.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace helios::gfx
+{
+	static constexpr uint32_t DRAW_SORT_KEY_MATERIAL_SHIFT = DRAW_SORT_KEY_DEPTH_BITS;
+	static constexpr uint32_t DRAW_SORT_KEY_PIPELINE_SHIFT = DRAW_SORT_KEY_MATERIAL_SHIFT + DRAW_SORT_KEY_MATERIAL_BITS;
+	static constexpr uint32_t DRAW_SORT_KEY_PASS_SHIFT = DRAW_SORT_KEY_PIPELINE_SHIFT + DRAW_SORT_KEY_PIPELINE_BITS;
+
+	static constexpr uint32_t RADIX_BITS = 8u;
+	static constexpr uint32_t RADIX_BUCKET_COUNT = 1u << RADIX_BITS;
+	static constexpr uint32_t RADIX_PASS_COUNT = 64u / RADIX_BITS;
+
+	static constexpr uint64_t GetFieldMask(uint32_t bitCount)
+	{
+		return (uint64_t{ 1u } << bitCount) - 1u;
+	}
+
+	uint64_t MakeDrawSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, float depth)
+	{
+		// A truncated field would sort the draw with another pass / pipeline / material (rather than fail visibly), so this is checked in all builds.
+		if (pass > GetFieldMask(DRAW_SORT_KEY_PASS_BITS) || pipeline > GetFieldMask(DRAW_SORT_KEY_PIPELINE_BITS) || material > GetFieldMask(DRAW_SORT_KEY_MATERIAL_BITS))
+		{
+			throw std::runtime_error("Draw sort key : the pass, pipeline or material does not fit in the bits of its field.");
+		}
+
+		// Note : Also sorts -0.0f (whose sign bit is set) and NaN's as 0.
+		const uint32_t depthBits = depth > 0.0f ? std::bit_cast<uint32_t>(depth) : 0u;
+
+		return ((pass & GetFieldMask(DRAW_SORT_KEY_PASS_BITS)) << DRAW_SORT_KEY_PASS_SHIFT) |
+			((pipeline & GetFieldMask(DRAW_SORT_KEY_PIPELINE_BITS)) << DRAW_SORT_KEY_PIPELINE_SHIFT) |
+			((material & GetFieldMask(DRAW_SORT_KEY_MATERIAL_BITS)) << DRAW_SORT_KEY_MATERIAL_SHIFT) | depthBits;
+	}
+
+	uint32_t GetDrawSortKeyPass(uint64_t sortKey)
+	{
+		return static_cast<uint32_t>((sortKey >> DRAW_SORT_KEY_PASS_SHIFT) & GetFieldMask(DRAW_SORT_KEY_PASS_BITS));
+	}
+
+	uint32_t GetDrawSortKeyPipeline(uint64_t sortKey)
+	{
+		return static_cast<uint32_t>((sortKey >> DRAW_SORT_KEY_PIPELINE_SHIFT) & GetFieldMask(DRAW_SORT_KEY_PIPELINE_BITS));
+	}
+
+	uint32_t GetDrawSortKeyMaterial(uint64_t sortKey)
+	{
+		return static_cast<uint32_t>((sortKey >> DRAW_SORT_KEY_MATERIAL_SHIFT) & GetFieldMask(DRAW_SORT_KEY_MATERIAL_BITS));
+	}
+
+	float GetDrawSortKeyDepth(uint64_t sortKey)
+	{
+		return std::bit_cast<float>(static_cast<uint32_t>(sortKey & GetFieldMask(DRAW_SORT_KEY_DEPTH_BITS)));
+	}
+
+	const char* DrawSortImplementationToString(DrawSortImplementation drawSortImplementation)
+	{
+		switch (drawSortImplementation)
+		{
+		case DrawSortImplementation::StdSort:
+		{
+			return "StdSort";
+		}break;
+
+		case DrawSortImplementation::Radix:
+		{
+			return "Radix";
+		}break;
+
+		case DrawSortImplementation::ParallelRadix:
+		{
+			return "ParallelRadix";
+		}break;
+		}
+
+		return "Unknown";
+	}
+
+	// Calls function(blockIndex, begin, end) for each block of blockSize packets (the last one may be smaller), in parallel if there is more than one block.
+	template <typename Function>
+	static void ForEachBlock(uint32_t packetCount, uint32_t blockSize, uint32_t blockCount, const Function& function)
+	{
+		const auto executeBlock = [&](uint32_t blockIndex)
+		{
+			function(blockIndex, blockIndex * blockSize, std::min((blockIndex + 1u) * blockSize, packetCount));
+		};
+
+		if (blockCount == 1u)
+		{
+			executeBlock(0u);
+			return;
+		}
+
+		core::JobSystem::Get().ParallelFor(blockCount, 1u, [&](uint32_t blockIndexBegin, uint32_t blockIndexEnd)
+		{
+			for (uint32_t blockIndex = blockIndexBegin; blockIndex < blockIndexEnd; ++blockIndex)
+			{
+				executeBlock(blockIndex);
+			}
+		});
+	}
+
+	// Least significant digit first : each pass is a stable counting sort of the packets by one byte of the key, so the order of the previous passes is kept
+	// among the packets sharing the byte. Within a pass, each block counts its packets per bucket, and then scatters them from the offset of its buckets (the
+	// blocks before it having their packets placed first), so the blocks are sorted in parallel and the pass stays stable.
+	static void RadixSortDrawPackets(std::vector<DrawPacket>& drawPackets, std::vector<DrawPacket>& scratch, bool isParallel)
+	{
+		const uint32_t packetCount = static_cast<uint32_t>(drawPackets.size());
+
+		const uint32_t maximumBlockCount = isParallel ? core::JobSystem::Get().GetWorkerCount() + 1u : 1u;
+		const uint32_t blockCount = std::clamp(packetCount / PARALLEL_RADIX_SORT_MIN_BLOCK_SIZE, 1u, maximumBlockCount);
+		const uint32_t blockSize = (packetCount + blockCount - 1u) / blockCount;
+
+		// The bits set in some keys but not in others : the bytes without any are skipped.
+		std::vector<uint64_t> blockAndBits(blockCount, ~uint64_t{});
+		std::vector<uint64_t> blockOrBits(blockCount, uint64_t{});
+
+		ForEachBlock(packetCount, blockSize, blockCount, [&](uint32_t blockIndex, uint32_t begin, uint32_t end)
+		{
+			uint64_t andBits = ~uint64_t{};
+			uint64_t orBits{};
+			for (uint32_t i = begin; i < end; ++i)
+			{
+				andBits &= drawPackets[i].sortKey;
+				orBits |= drawPackets[i].sortKey;
+			}
+
+			blockAndBits[blockIndex] = andBits;
+			blockOrBits[blockIndex] = orBits;
+		});
+
+		uint64_t andBits = ~uint64_t{};
+		uint64_t orBits{};
+		for (uint32_t blockIndex = 0u; blockIndex < blockCount; ++blockIndex)
+		{
+			andBits &= blockAndBits[blockIndex];
+			orBits |= blockOrBits[blockIndex];
+		}
+
+		const uint64_t varyingBits = andBits ^ orBits;
+
+		scratch.resize(packetCount);
+
+		std::vector<std::array<uint32_t, RADIX_BUCKET_COUNT>> blockOffsets(blockCount);
+
+		DrawPacket* source = drawPackets.data();
+		DrawPacket* destination = scratch.data();
+
+		for (uint32_t radixPass = 0u; radixPass < RADIX_PASS_COUNT; ++radixPass)
+		{
+			const uint32_t shift = radixPass * RADIX_BITS;
+			if (((varyingBits >> shift) & GetFieldMask(RADIX_BITS)) == 0u)
+			{
+				continue;
+			}
+
+			ForEachBlock(packetCount, blockSize, blockCount, [&](uint32_t blockIndex, uint32_t begin, uint32_t end)
+			{
+				std::array<uint32_t, RADIX_BUCKET_COUNT>& counts = blockOffsets[blockIndex];
+				counts.fill(0u);
+
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					++counts[(source[i].sortKey >> shift) & (RADIX_BUCKET_COUNT - 1u)];
+				}
+			});
+
+			// The counts are turned into the offsets the blocks scatter their packets from : bucket major, then block order.
+			uint32_t offset{};
+			for (uint32_t bucket = 0u; bucket < RADIX_BUCKET_COUNT; ++bucket)
+			{
+				for (uint32_t blockIndex = 0u; blockIndex < blockCount; ++blockIndex)
+				{
+					const uint32_t count = blockOffsets[blockIndex][bucket];
+					blockOffsets[blockIndex][bucket] = offset;
+					offset += count;
+				}
+			}
+
+			ForEachBlock(packetCount, blockSize, blockCount, [&](uint32_t blockIndex, uint32_t begin, uint32_t end)
+			{
+				std::array<uint32_t, RADIX_BUCKET_COUNT>& offsets = blockOffsets[blockIndex];
+
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					destination[offsets[(source[i].sortKey >> shift) & (RADIX_BUCKET_COUNT - 1u)]++] = source[i];
+				}
+			});
+
+			std::swap(source, destination);
+		}
+
+		// After an odd number of passes, the sorted packets are in the scratch buffer.
+		if (source != drawPackets.data())
+		{
+			drawPackets.swap(scratch);
+		}
+	}
+
+	void SortDrawPackets(std::vector<DrawPacket>& drawPackets, std::vector<DrawPacket>& scratch, DrawSortImplementation drawSortImplementation)
+	{
+		if (drawPackets.size() < 2u)
+		{
+			return;
+		}
+
+		switch (drawSortImplementation)
+		{
+		case DrawSortImplementation::StdSort:
+		{
+			std::stable_sort(drawPackets.begin(), drawPackets.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.sortKey < b.sortKey; });
+		}break;
+
+		case DrawSortImplementation::Radix:
+		{
+			RadixSortDrawPackets(drawPackets, scratch, false);
+		}break;
+
+		case DrawSortImplementation::ParallelRadix:
+		{
+			RadixSortDrawPackets(drawPackets, scratch, true);
+		}break;
+		}
+	}
+
+	DrawSortStateChanges CountDrawSortStateChanges(std::span<const DrawPacket> drawPackets)
+	{
+		DrawSortStateChanges stateChanges{};
+
+		for (size_t i = 0u; i < drawPackets.size(); ++i)
+		{
+			const uint64_t sortKey = drawPackets[i].sortKey;
+
+			// The first packet sets all state, and changing a field changes the state it selects (i.e materials are per pipeline).
+			const bool isFirst = i == 0u;
+			const uint64_t changedBits = isFirst ? ~uint64_t{} : sortKey ^ drawPackets[i - 1u].sortKey;
+
+			stateChanges.passChangeCount += (changedBits >> DRAW_SORT_KEY_PASS_SHIFT) != 0u ? 1u : 0u;
+			stateChanges.pipelineChangeCount += (changedBits >> DRAW_SORT_KEY_PIPELINE_SHIFT) != 0u ? 1u : 0u;
+			stateChanges.materialChangeCount += (changedBits >> DRAW_SORT_KEY_MATERIAL_SHIFT) != 0u ? 1u : 0u;
+		}
+
+		return stateChanges;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace helios::gfx
+{
+	// Layout of the 64 bit sort key of a draw, from the most significant bits : the pass, the pipeline state, the material, then the depth.
+	// Sorting the keys in ascending order groups the draws by pass, then by pipeline state and material (so consecutive draws rarely change state), and orders
+	// the draws sharing them front to back (so the depth test rejects more of the pixels hidden by the draws recorded before them).
+	static constexpr uint32_t DRAW_SORT_KEY_PASS_BITS = 4u;
+	static constexpr uint32_t DRAW_SORT_KEY_PIPELINE_BITS = 8u;
+	static constexpr uint32_t DRAW_SORT_KEY_MATERIAL_BITS = 20u;
+	static constexpr uint32_t DRAW_SORT_KEY_DEPTH_BITS = 32u;
+
+	static_assert(DRAW_SORT_KEY_PASS_BITS + DRAW_SORT_KEY_PIPELINE_BITS + DRAW_SORT_KEY_MATERIAL_BITS + DRAW_SORT_KEY_DEPTH_BITS == 64u);
+
+	// The pass, pipeline and material must fit in the bits of their field (throws std::runtime_error otherwise). depth is any value growing with the distance to
+	// the viewer (i.e the clip space depth) : the bits of a non negative float sort as the float itself, so it is not quantized. Negative depths sort as 0.
+	uint64_t MakeDrawSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, float depth);
+
+	uint32_t GetDrawSortKeyPass(uint64_t sortKey);
+	uint32_t GetDrawSortKeyPipeline(uint64_t sortKey);
+	uint32_t GetDrawSortKeyMaterial(uint64_t sortKey);
+	float GetDrawSortKeyDepth(uint64_t sortKey);
+
+	// A draw to be recorded : drawIndex refers to the caller's draws (i.e the draw index of a mesh, see Scene::RenderModels).
+	struct DrawPacket
+	{
+		uint64_t sortKey{};
+		uint32_t drawIndex{};
+		uint32_t padding{};
+	};
+
+	// StdSort (std::stable_sort) is the reference the radix sorts must match exactly. ParallelRadix splits the packets into blocks sorted by the job system,
+	// unless there are too few packets for it to pay off (see PARALLEL_RADIX_SORT_MIN_BLOCK_SIZE).
+	enum class DrawSortImplementation : uint32_t
+	{
+		StdSort,
+		Radix,
+		ParallelRadix,
+	};
+
+	const char* DrawSortImplementationToString(DrawSortImplementation drawSortImplementation);
+
+	// Each block of the parallel radix sort has at least this many packets.
+	static constexpr uint32_t PARALLEL_RADIX_SORT_MIN_BLOCK_SIZE = 8192u;
+
+	// Stable sort by key (draws with the same key stay in the order they were added). The radix sorts make a pass over the packets per byte of the key, skipping
+	// the bytes that are the same in all keys (i.e the pass, or the pipeline if there is a single one). scratch is resized to the packet count, and kept by the
+	// caller so its memory is reused every frame.
+	void SortDrawPackets(std::vector<DrawPacket>& drawPackets, std::vector<DrawPacket>& scratch, DrawSortImplementation drawSortImplementation = DrawSortImplementation::ParallelRadix);
+
+	// Number of state changes (i.e pipeline / material) when recording the packets in order.
+	struct DrawSortStateChanges
+	{
+		uint32_t passChangeCount{};
+		uint32_t pipelineChangeCount{};
+		uint32_t materialChangeCount{};
+	};
+
+	DrawSortStateChanges CountDrawSortStateChanges(std::span<const DrawPacket> drawPackets);
+}
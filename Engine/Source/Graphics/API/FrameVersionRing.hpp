@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace helios::gfx
+{
+	// Selects the version (copy) of per frame CPU written data, i.e a constant buffer, to write. The first write in a frame advances to the version after the
+	// last written one, which is not read by any of the (at most VersionCount - 1) frames still in flight. Later writes within the same frame overwrite that version.
+	// GetVersion returns the last written version, so data that is not written every frame remains valid.
+	template <uint32_t VersionCount>
+	class FrameVersionRing
+	{
+	public:
+		// frameNumber is the number of the frame being recorded by the CPU. Returns the version to write.
+		uint32_t Advance(uint64_t frameNumber)
+		{
+			if (mVersionFrameNumber != frameNumber)
+			{
+				mVersion = (mVersion + 1u) % VersionCount;
+				mVersionFrameNumber = frameNumber;
+			}
+
+			return mVersion;
+		}
+
+		uint32_t GetVersion() const { return mVersion; }
+
+	private:
+		uint32_t mVersion{};
+		uint64_t mVersionFrameNumber{ UINT64_MAX };
+	};
+}
@@ -11,6 +11,7 @@ namespace helios::gfx
 	GraphicsContext::GraphicsContext(Device* device, const gfx::PipelineState* pipelineState) : mDevice(*device)
 	{
 		mCommandList = device->GetGraphicsCommandQueue()->GetCommandList(pipelineState);
+		mCommandStream.SetTranslationTarget(ToCommandHandle(mCommandList.Get()));
 
 		// As all graphics context's require to set the descriptor heap before hand, the user has option to set them manually (for explicitness) or just let the constructor take care of this.
 		std::array<gfx::Descriptor*, 2> descriptors
@@ -21,195 +22,270 @@ namespace helios::gfx
 
 		SetDescriptorHeaps(descriptors);
 
-		mCommandList->SetGraphicsRootSignature(PipelineState::rootSignature.Get());
+		mCommandStream.Record(SetRootSignatureCommand
+		{
+			.bindPoint = PipelineBindPoint::Graphics,
+			.rootSignature = ToCommandHandle(PipelineState::rootSignature.Get()),
+		});
 	}
 
 	void GraphicsContext::ClearRenderTargetView(BackBuffer* const backBuffer, std::span<const float, 4> color)
 	{
-		mCommandList->ClearRenderTargetView(backBuffer->backBufferDescriptorHandle.cpuDescriptorHandle, color.data(), 0u, nullptr);
+		ClearRenderTargetView(backBuffer->backBufferDescriptorHandle.cpuDescriptorHandle, color);
 	}
 
 	void GraphicsContext::ClearRenderTargetView(std::span<const RenderTarget*> renderTargets, std::span<const float, 4> color)
 	{
 		for (const auto& rt : renderTargets)
 		{
-			mCommandList->ClearRenderTargetView(mDevice.GetRtvDescriptor()->GetDescriptorHandleFromIndex(RenderTarget::GetRenderTextureRTVIndex(rt)).cpuDescriptorHandle, color.data(), 0u, nullptr);
+			ClearRenderTargetView(GetRtvDescriptorHandle(rt), color);
 		}
 	}
 
 	void GraphicsContext::ClearRenderTargetView(RenderTarget* renderTargets, std::span<const float, 4> color)
 	{
-			mCommandList->ClearRenderTargetView(mDevice.GetRtvDescriptor()->GetDescriptorHandleFromIndex(RenderTarget::GetRenderTextureRTVIndex(renderTargets)).cpuDescriptorHandle, color.data(), 0u, nullptr);
+		ClearRenderTargetView(GetRtvDescriptorHandle(renderTargets), color);
 	}
+
 	void GraphicsContext::ClearDepthStencilView(Texture* const depthStencilTexture, float depth)
 	{
-		DescriptorHandle dsvDescriptorHandle = mDevice.GetDsvDescriptor()->GetDescriptorHandleFromIndex(gfx::Texture::GetDsvIndex((depthStencilTexture)));
-
-		mCommandList->ClearDepthStencilView(dsvDescriptorHandle.cpuDescriptorHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 1, 0u, nullptr);
+		mCommandStream.Record(ClearDepthStencilCommand
+		{
+			.depthStencil = GetDsvDescriptorHandle(depthStencilTexture).ptr,
+			.depth = depth,
+		});
 	}
 
 	void GraphicsContext::SetDescriptorHeaps(std::array<gfx::Descriptor*, 2> descriptors) const
 	{
-		std::array<ID3D12DescriptorHeap*, 2>  descriptorHeaps
+		mCommandStream.Record(SetDescriptorHeapsCommand
 		{
-			descriptors[0]->GetDescriptorHeap(),
-			descriptors[1]->GetDescriptorHeap(),
-		};
-
-		mCommandList->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
+			.descriptorHeapCount = 2u,
+			.descriptorHeaps =
+			{
+				ToCommandHandle(descriptors[0]->GetDescriptorHeap()),
+				ToCommandHandle(descriptors[1]->GetDescriptorHeap()),
+			},
+		});
 	}
 
 	void GraphicsContext::SetGraphicsPipelineState(PipelineState* pipelineState) const
 	{
-		mCommandList->SetPipelineState(pipelineState->pipelineStateObject.Get());
+		SetPipelineStateObject(pipelineState);
 	}
 
 	void GraphicsContext::SetComputePipelineState(PipelineState* pipelineState) const
 	{
-		mCommandList->SetComputeRootSignature(pipelineState->rootSignature.Get());
-		mCommandList->SetPipelineState(pipelineState->pipelineStateObject.Get());
+		SetComputeRootSignature(pipelineState);
+		SetPipelineStateObject(pipelineState);
 	}
 
 	void GraphicsContext::SetGraphicsRootSignature(PipelineState* pipelineState) const
 	{
-		mCommandList->SetGraphicsRootSignature(pipelineState->rootSignature.Get());
+		mCommandStream.Record(SetRootSignatureCommand
+		{
+			.bindPoint = PipelineBindPoint::Graphics,
+			.rootSignature = ToCommandHandle(pipelineState->rootSignature.Get()),
+		});
 	}
 
 	void GraphicsContext::SetComputeRootSignature(PipelineState* pipelineState) const
 	{
-		mCommandList->SetComputeRootSignature(pipelineState->rootSignature.Get());
+		mCommandStream.Record(SetRootSignatureCommand
+		{
+			.bindPoint = PipelineBindPoint::Compute,
+			.rootSignature = ToCommandHandle(pipelineState->rootSignature.Get()),
+		});
 	}
 
 	void GraphicsContext::SetPipelineStateObject(PipelineState* pipelineState) const
 	{
-		mCommandList->SetPipelineState(pipelineState->pipelineStateObject.Get());
+		mCommandStream.Record(SetPipelineStateCommand
+		{
+			.pipelineState = ToCommandHandle(pipelineState->pipelineStateObject.Get()),
+		});
 	}
 
 	void GraphicsContext::SetIndexBuffer(Buffer* const buffer) const
 	{
-		D3D12_INDEX_BUFFER_VIEW indexBufferView
+		mCommandStream.Record(SetIndexBufferCommand
 		{
-			.BufferLocation = buffer->allocation->resource->GetGPUVirtualAddress(),
-			.SizeInBytes = static_cast<UINT>(buffer->sizeInBytes),
-			.Format = DXGI_FORMAT_R32_UINT,
-		};
+			.bufferLocation = buffer->allocation->resource->GetGPUVirtualAddress(),
+			.sizeInBytes = static_cast<uint32_t>(buffer->sizeInBytes),
+			.format = static_cast<uint32_t>(DXGI_FORMAT_R32_UINT),
+		});
 
-		mCommandList->IASetIndexBuffer(&indexBufferView);
+		TrackResidency(buffer);
 	}
 
-	void GraphicsContext::Set32BitGraphicsConstants(const void* renderResources) const
+	void GraphicsContext::Set32BitGraphicsConstants(const void* renderResources, uint32_t valueCount) const
 	{
-		mCommandList->SetGraphicsRoot32BitConstants(0u, NUMBER_32_BIT_CONSTANTS, renderResources, 0u);
+		std::array<uint32_t, NUMBER_32_BIT_CONSTANTS> values{};
+		std::memcpy(values.data(), renderResources, sizeof(uint32_t) * valueCount);
+
+		mCommandStream.Record(SetRootConstantsCommand{ .bindPoint = PipelineBindPoint::Graphics }, std::span(values).first(valueCount));
 	}
 
 	void GraphicsContext::SetDefaultViewportAndScissor() const
 	{
-		D3D12_VIEWPORT viewport
+		mCommandStream.Record(SetViewportCommand
 		{
-			.TopLeftX = 0.0f,
-			.TopLeftY = 0.0f,
-			.Width = static_cast<float>(core::Application::GetClientDimensions().x),
-			.Height = static_cast<float>(core::Application::GetClientDimensions().y),
-			.MinDepth = 0.0f,
-			.MaxDepth = 1.0f
-		};
-
-		static D3D12_RECT scissorRect
-		{
-			.left = 0u,
-			.top = 0u,
-			.right = LONG_MAX,
-			.bottom = LONG_MAX
-		};
-
-		mCommandList->RSSetViewports(1u, &viewport);
-		mCommandList->RSSetScissorRects(1u, &scissorRect);
+			.topLeftX = 0.0f,
+			.topLeftY = 0.0f,
+			.width = static_cast<float>(core::Application::GetClientDimensions().x),
+			.height = static_cast<float>(core::Application::GetClientDimensions().y),
+			.minDepth = 0.0f,
+			.maxDepth = 1.0f
+		});
 	}
 
 	void GraphicsContext::SetViewportAndScissor(const D3D12_VIEWPORT& viewport) const
 	{
-		static D3D12_RECT scissorRect
+		mCommandStream.Record(SetViewportCommand
 		{
-			.left = 0u,
-			.top = 0u,
-			.right = LONG_MAX,
-			.bottom = LONG_MAX
-		};
-
-		mCommandList->RSSetViewports(1u, &viewport);
-		mCommandList->RSSetScissorRects(1u, &scissorRect);
+			.topLeftX = viewport.TopLeftX,
+			.topLeftY = viewport.TopLeftY,
+			.width = viewport.Width,
+			.height = viewport.Height,
+			.minDepth = viewport.MinDepth,
+			.maxDepth = viewport.MaxDepth
+		});
 	}
 
 	// Specifies how the pipeline interprets vertex data bound to the input assembler stage.
 	// i.e if topology type is POINTLIST, vertex data is interpreted as list of points.
 	void GraphicsContext::SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY primitiveTopology) const
 	{
-		mCommandList->IASetPrimitiveTopology(primitiveTopology);
+		mCommandStream.Record(SetPrimitiveTopologyCommand
+		{
+			.primitiveTopology = static_cast<uint32_t>(primitiveTopology),
+		});
 	}
 
 	void GraphicsContext::SetRenderTarget(BackBuffer* renderTarget, const Texture* depthStencilTexture) const
 	{
-		
-		if (!depthStencilTexture)
+		mCommandStream.Record(SetRenderTargetsCommand
 		{
-			mCommandList->OMSetRenderTargets(1u, &renderTarget->backBufferDescriptorHandle.cpuDescriptorHandle, FALSE, nullptr);
-		}
-		else
-		{
-			DescriptorHandle dsvDescriptorHandle = mDevice.GetDsvDescriptor()->GetDescriptorHandleFromIndex(Texture::GetDsvIndex(depthStencilTexture));
-			mCommandList->OMSetRenderTargets(1u, &renderTarget->backBufferDescriptorHandle.cpuDescriptorHandle, FALSE, &dsvDescriptorHandle.cpuDescriptorHandle);
-		}
+			.renderTargetCount = 1u,
+			.renderTargets = { renderTarget->backBufferDescriptorHandle.cpuDescriptorHandle.ptr },
+			.depthStencil = depthStencilTexture ? GetDsvDescriptorHandle(depthStencilTexture).ptr : 0u,
+		});
 	}
 
-	void GraphicsContext::SetRenderTarget(std::span<const RenderTarget*> renderTargets, const Texture* depthStencilTexture) const
+	void GraphicsContext::SetRenderTarget(std::span<const RenderTarget*> renderTargets, const Texture* depthStencilTexture, DepthStencilAccess depthStencilAccess) const
 	{
-		DescriptorHandle dsvDescriptorHandle = mDevice.GetDsvDescriptor()->GetDescriptorHandleFromIndex(Texture::GetDsvIndex(depthStencilTexture));
+		SetRenderTargetsCommand command
+		{
+			.renderTargetCount = static_cast<uint32_t>(std::min<size_t>(renderTargets.size(), MAX_RENDER_TARGETS)),
+			.isSingleHandleToDescriptorRange = 1u,
+			.depthStencil = depthStencilTexture ? GetDsvDescriptorHandle(depthStencilTexture, depthStencilAccess).ptr : 0u,
+		};
 
-		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> rtvHandles{};
-		for (const auto& rt : renderTargets)
+		for (uint32_t i : std::views::iota(0u, command.renderTargetCount))
 		{
-			rtvHandles.emplace_back(mDevice.GetRtvDescriptor()->GetDescriptorHandleFromIndex(RenderTarget::GetRenderTextureRTVIndex(rt)).cpuDescriptorHandle);
+			command.renderTargets[i] = GetRtvDescriptorHandle(renderTargets[i]).ptr;
 		}
 
-		mCommandList->OMSetRenderTargets(static_cast<UINT>(renderTargets.size()), rtvHandles.data(), TRUE, &dsvDescriptorHandle.cpuDescriptorHandle);
+		mCommandStream.Record(command);
 	}
 
-	void GraphicsContext::SetRenderTarget(RenderTarget* renderTarget, const Texture* depthStencilTexture) const
+	void GraphicsContext::SetRenderTarget(RenderTarget* renderTarget, const Texture* depthStencilTexture, DepthStencilAccess depthStencilAccess) const
 	{
-		DescriptorHandle dsvDescriptorHandle = mDevice.GetDsvDescriptor()->GetDescriptorHandleFromIndex(Texture::GetDsvIndex(depthStencilTexture));
-		D3D12_CPU_DESCRIPTOR_HANDLE rtHandle = mDevice.GetRtvDescriptor()->GetDescriptorHandleFromIndex(RenderTarget::GetRenderTextureRTVIndex(renderTarget)).cpuDescriptorHandle;
-		mCommandList->OMSetRenderTargets(1u, &rtHandle, FALSE, &dsvDescriptorHandle.cpuDescriptorHandle);
+		mCommandStream.Record(SetRenderTargetsCommand
+		{
+			.renderTargetCount = 1u,
+			.renderTargets = { GetRtvDescriptorHandle(renderTarget).ptr },
+			.depthStencil = depthStencilTexture ? GetDsvDescriptorHandle(depthStencilTexture, depthStencilAccess).ptr : 0u,
+		});
 	}
 
 	void GraphicsContext::SetRenderTarget(const Texture* depthStencilTexture) const
 	{
-		DescriptorHandle dsvDescriptorHandle = mDevice.GetDsvDescriptor()->GetDescriptorHandleFromIndex(Texture::GetDsvIndex(depthStencilTexture));
-		mCommandList->OMSetRenderTargets(0u, nullptr, FALSE, &dsvDescriptorHandle.cpuDescriptorHandle);
+		mCommandStream.Record(SetRenderTargetsCommand
+		{
+			.depthStencil = GetDsvDescriptorHandle(depthStencilTexture).ptr,
+		});
 	}
 
 	void GraphicsContext::DrawInstanceIndexed(uint32_t indicesCount, uint32_t instanceCount) const
 	{
-		mCommandList->DrawIndexedInstanced(indicesCount, instanceCount, 0u, 0u, 0u);
+		mCommandStream.Record(DrawIndexedCommand
+		{
+			.indexCountPerInstance = indicesCount,
+			.instanceCount = instanceCount,
+		});
 	}
 
 	void GraphicsContext::DrawIndexed(uint32_t indicesCount, uint32_t instanceCount) const
 	{
-		mCommandList->DrawInstanced(indicesCount, instanceCount, 0u, 0u);
+		mCommandStream.Record(DrawCommand
+		{
+			.vertexCountPerInstance = indicesCount,
+			.instanceCount = instanceCount,
+		});
+	}
+
+	void GraphicsContext::ExecuteIndirect(ID3D12CommandSignature* const commandSignature, uint32_t maxCommandCount, ID3D12Resource* const argumentBuffer, uint64_t argumentBufferOffset,
+		ID3D12Resource* const countBuffer, uint64_t countBufferOffset) const
+	{
+		mCommandStream.Record(ExecuteIndirectCommand
+		{
+			.commandSignature = ToCommandHandle(commandSignature),
+			.maxCommandCount = maxCommandCount,
+			.argumentBuffer = ToCommandHandle(argumentBuffer),
+			.argumentBufferOffset = argumentBufferOffset,
+			.countBuffer = ToCommandHandle(countBuffer),
+			.countBufferOffset = countBufferOffset,
+		});
 	}
 
 	void GraphicsContext::Dispatch(uint32_t threadGroupX, uint32_t threadGroupY, uint32_t threadGroupZ) const
 	{
-		mCommandList->Dispatch(threadGroupX, threadGroupY, threadGroupZ);
+		mCommandStream.Record(DispatchCommand
+		{
+			.threadGroupCountX = threadGroupX,
+			.threadGroupCountY = threadGroupY,
+			.threadGroupCountZ = threadGroupZ,
+		});
 	}
 
-	void GraphicsContext::Set32BitComputeConstants(const void* renderResources) const
+	void GraphicsContext::Set32BitComputeConstants(const void* renderResources, uint32_t valueCount) const
 	{
-		mCommandList->SetComputeRoot32BitConstants(0u, NUMBER_32_BIT_CONSTANTS, renderResources, 0u);
+		std::array<uint32_t, NUMBER_32_BIT_CONSTANTS> values{};
+		std::memcpy(values.data(), renderResources, sizeof(uint32_t) * valueCount);
+
+		mCommandStream.Record(SetRootConstantsCommand{ .bindPoint = PipelineBindPoint::Compute }, std::span(values).first(valueCount));
 	}
 	 
 	void GraphicsContext::CopyResource(ID3D12Resource* source, ID3D12Resource* destination)
 	{
-		mCommandList->CopyResource(destination, source);
+		mCommandStream.Record(CopyResourceCommand
+		{
+			.destination = ToCommandHandle(destination),
+			.source = ToCommandHandle(source),
+		});
 	}
-}
 
+	void GraphicsContext::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE rtvDescriptorHandle, std::span<const float, 4> color)
+	{
+		ClearRenderTargetCommand command
+		{
+			.renderTarget = rtvDescriptorHandle.ptr,
+		};
+
+		std::copy(color.begin(), color.end(), command.color.begin());
+
+		mCommandStream.Record(command);
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GraphicsContext::GetRtvDescriptorHandle(const RenderTarget* renderTarget) const
+	{
+		return mDevice.GetRtvDescriptor()->GetDescriptorHandleFromIndex(RenderTarget::GetRenderTextureRTVIndex(renderTarget)).cpuDescriptorHandle;
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GraphicsContext::GetDsvDescriptorHandle(const Texture* depthStencilTexture, DepthStencilAccess depthStencilAccess) const
+	{
+		const uint32_t dsvIndex = depthStencilAccess == DepthStencilAccess::ReadOnly ? Texture::GetReadOnlyDsvIndex(depthStencilTexture) : Texture::GetDsvIndex(depthStencilTexture);
+		return mDevice.GetDsvDescriptor()->GetDescriptorHandleFromIndex(dsvIndex).cpuDescriptorHandle;
+	}
+}
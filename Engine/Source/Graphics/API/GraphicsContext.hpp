@@ -6,6 +6,14 @@ namespace helios::gfx
 {
 	class Device;
 
+	// A read only depth stencil view can be bound while the depth texture is in the DEPTH_READ state (along with shader resource states), so passes can depth test
+	// against the depth of a previous pass while sampling it, without copying it. The pipelines used must not write depth.
+	enum class DepthStencilAccess
+	{
+		ReadWrite,
+		ReadOnly,
+	};
+
 	// Wrapper class for Graphics CommandList, which provides a set of easy and simple functions to record commands for execution by GPU.
 	// The command queue will contain a queue of command list, which can be passed into the GraphicsContext's constructor to create a GraphicsContext object.
 	// Note : Can be used for some compute stuff as well for convenience, though you should probably switch to ComputeContext for using the Compute pipeline.
@@ -33,7 +41,16 @@ namespace helios::gfx
 		void SetPipelineStateObject(PipelineState* constpipelineState) const;
 
 		void SetIndexBuffer(Buffer* const buffer) const;
-		void Set32BitGraphicsConstants(const void* renderResources) const;
+
+		// Only the sizeof(T) / 4 values of the render resources are recorded (see SetRootConstantsCommand).
+		template <typename T>
+		void Set32BitGraphicsConstants(const T* renderResources) const
+		{
+			static_assert(sizeof(T) % sizeof(uint32_t) == 0u && sizeof(T) <= sizeof(uint32_t) * NUMBER_32_BIT_CONSTANTS);
+			Set32BitGraphicsConstants(renderResources, static_cast<uint32_t>(sizeof(T) / sizeof(uint32_t)));
+		}
+
+		void Set32BitGraphicsConstants(const void* renderResources, uint32_t valueCount) const;
 
 		void SetDefaultViewportAndScissor() const;
 		void SetViewportAndScissor(const D3D12_VIEWPORT& viewport) const;
@@ -41,21 +58,42 @@ namespace helios::gfx
 		void SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY primitiveTopology) const;
 
 		void SetRenderTarget(BackBuffer* const renderTarget, const Texture* depthStencilTexture) const;
-		void SetRenderTarget(std::span<const RenderTarget*> renderTargets, const Texture* depthStencilTexture) const;
-		void SetRenderTarget(RenderTarget* renderTarget, const Texture* depthStencilTexture) const;
+		// The depth stencil texture can be null.
+		void SetRenderTarget(std::span<const RenderTarget*> renderTargets, const Texture* depthStencilTexture, DepthStencilAccess depthStencilAccess = DepthStencilAccess::ReadWrite) const;
+		void SetRenderTarget(RenderTarget* renderTarget, const Texture* depthStencilTexture, DepthStencilAccess depthStencilAccess = DepthStencilAccess::ReadWrite) const;
 		void SetRenderTarget(const Texture* depthStencilTexture) const;
 
 		// Draw functions.
 		void DrawInstanceIndexed(uint32_t indicesCount, uint32_t instanceCount = 1u) const;
 		void DrawIndexed(uint32_t indicesCount, uint32_t instanceCount = 1u) const;
 
+		// Executes up to maxCommandCount commands read from the argument buffer (see ExecuteIndirectCommand), i.e the draws of an IndirectDrawBuffer.
+		// The argument (and count) buffer must be in the indirect argument state, which the GENERIC_READ state of upload heap buffers includes.
+		void ExecuteIndirect(ID3D12CommandSignature* const commandSignature, uint32_t maxCommandCount, ID3D12Resource* const argumentBuffer, uint64_t argumentBufferOffset = 0u,
+			ID3D12Resource* const countBuffer = nullptr, uint64_t countBufferOffset = 0u) const;
+
 		// Compute functions (as graphics context can be used for compute as well).
 		void Dispatch(uint32_t threadGroupX, uint32_t threadGroupY, uint32_t threadGroupZ) const;
-		void Set32BitComputeConstants(const void* renderResources) const;
+
+		// As Set32BitGraphicsConstants, for the compute bind point.
+		template <typename T>
+		void Set32BitComputeConstants(const T* renderResources) const
+		{
+			static_assert(sizeof(T) % sizeof(uint32_t) == 0u && sizeof(T) <= sizeof(uint32_t) * NUMBER_32_BIT_CONSTANTS);
+			Set32BitComputeConstants(renderResources, static_cast<uint32_t>(sizeof(T) / sizeof(uint32_t)));
+		}
+
+		void Set32BitComputeConstants(const void* renderResources, uint32_t valueCount) const;
 		
 		// Copy related calls.
 		void CopyResource(ID3D12Resource* source, ID3D12Resource* destination);
 
+	private:
+		void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE rtvDescriptorHandle, std::span<const float, 4> color);
+
+		D3D12_CPU_DESCRIPTOR_HANDLE GetRtvDescriptorHandle(const RenderTarget* renderTarget) const;
+		D3D12_CPU_DESCRIPTOR_HANDLE GetDsvDescriptorHandle(const Texture* depthStencilTexture, DepthStencilAccess depthStencilAccess = DepthStencilAccess::ReadWrite) const;
+
 	private:
 		static constexpr uint32_t NUMBER_32_BIT_CONSTANTS = 64;
 
@@ -0,0 +1,56 @@
+#include "IndirectDraw.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace helios::gfx
+{
+	IndirectDrawStream::IndirectDrawStream(uint32_t drawDataStride) : mDrawDataStride(drawDataStride)
+	{
+	}
+
+	void IndirectDrawStream::Clear()
+	{
+		mArguments.clear();
+		mDrawData.clear();
+	}
+
+	void IndirectDrawStream::Reserve(uint32_t drawCount)
+	{
+		mArguments.reserve(drawCount);
+		mDrawData.reserve(static_cast<size_t>(drawCount) * mDrawDataStride);
+	}
+
+	uint32_t IndirectDrawStream::AddDraw(const IndexBufferView& indexBufferView, const DrawIndexedArguments& drawIndexedArguments, const void* drawData, size_t drawDataSize)
+	{
+		const uint32_t drawIndex = GetDrawCount();
+
+		mArguments.push_back(IndirectDrawArguments
+		{
+			.indexBufferView = indexBufferView,
+			.drawIndex = drawIndex,
+			.drawIndexedArguments = drawIndexedArguments,
+		});
+
+		const size_t drawDataOffset = mDrawData.size();
+		mDrawData.resize(drawDataOffset + mDrawDataStride);
+
+		std::memcpy(mDrawData.data() + drawDataOffset, drawData, std::min<size_t>(drawDataSize, mDrawDataStride));
+
+		return drawIndex;
+	}
+
+	void RecordIndirectDraws(CommandStream& commandStream, uint32_t drawDataBufferIndex, const ExecuteIndirectCommand& executeIndirectCommand)
+	{
+		if (executeIndirectCommand.maxCommandCount == 0u)
+		{
+			return;
+		}
+
+		const std::array<uint32_t, 2u> indirectDrawRenderResources{ drawDataBufferIndex, 0u };
+
+		commandStream.Record(SetRootConstantsCommand{ .bindPoint = PipelineBindPoint::Graphics }, indirectDrawRenderResources);
+		commandStream.Record(executeIndirectCommand);
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+// The indirect arguments and draw data are uploaded and executed by the IndirectDrawBuffer.
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "CommandStream.hpp"
+
+namespace helios::gfx
+{
+	// Matches D3D12_INDEX_BUFFER_VIEW.
+	struct IndexBufferView
+	{
+		uint64_t bufferLocation{};
+		uint32_t sizeInBytes{};
+		uint32_t format{};
+	};
+
+	// Matches D3D12_DRAW_INDEXED_ARGUMENTS.
+	struct DrawIndexedArguments
+	{
+		uint32_t indexCountPerInstance{};
+		uint32_t instanceCount{};
+		uint32_t startIndexLocation{};
+		int32_t baseVertexLocation{};
+		uint32_t startInstanceLocation{};
+	};
+
+	// The arguments of a draw executed by ExecuteIndirect, in the order of the argument descs of the command signature : the index buffer view, the draw
+	// index (written into the root constants), then the draw. Shaders read the draw data of the draw at the draw index.
+	// Note : ExecuteIndirect expects the arguments tightly packed. The index buffer view (8 byte aligned) comes first, so there is no padding in between.
+	struct IndirectDrawArguments
+	{
+		IndexBufferView indexBufferView{};
+		uint32_t drawIndex{};
+		DrawIndexedArguments drawIndexedArguments{};
+	};
+
+	static_assert(sizeof(IndirectDrawArguments) == 40u && offsetof(IndirectDrawArguments, drawIndex) == 16u && offsetof(IndirectDrawArguments, drawIndexedArguments) == 20u);
+
+	// Draws to be executed by a single ExecuteIndirect : the argument stream, and the draw data (i.e the root constants each draw would have set) laid out as
+	// a structured buffer, with drawDataStride bytes per draw.
+	// Rather than recording an index buffer, root constants and a draw per mesh, the CPU only writes the draws into these arrays, which are then copied into
+	// GPU visible memory as is.
+	// Not thread safe.
+	class IndirectDrawStream
+	{
+	public:
+		explicit IndirectDrawStream(uint32_t drawDataStride);
+
+		// Removes the draws, keeping the memory for the next frame.
+		void Clear();
+
+		void Reserve(uint32_t drawCount);
+
+		// Returns the draw index of the draw. drawDataSize must be at most the draw data stride (the rest of the draw data is zeroed).
+		uint32_t AddDraw(const IndexBufferView& indexBufferView, const DrawIndexedArguments& drawIndexedArguments, const void* drawData, size_t drawDataSize);
+
+		template <typename T>
+		uint32_t AddDraw(const IndexBufferView& indexBufferView, const DrawIndexedArguments& drawIndexedArguments, const T& drawData)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+
+			return AddDraw(indexBufferView, drawIndexedArguments, &drawData, sizeof(T));
+		}
+
+		std::span<const IndirectDrawArguments> GetArguments() const { return mArguments; }
+		std::span<const std::byte> GetDrawData() const { return mDrawData; }
+
+		uint32_t GetDrawCount() const { return static_cast<uint32_t>(mArguments.size()); }
+		uint32_t GetDrawDataStride() const { return mDrawDataStride; }
+
+	private:
+		uint32_t mDrawDataStride{};
+
+		std::vector<IndirectDrawArguments> mArguments{};
+		std::vector<std::byte> mDrawData{};
+	};
+
+	// Records the root constants of the draws (the draw data buffer index, as IndirectDrawRenderResources : the draw index is set per draw by the command
+	// signature), then the ExecuteIndirect. Nothing is recorded if maxCommandCount is 0.
+	void RecordIndirectDraws(CommandStream& commandStream, uint32_t drawDataBufferIndex, const ExecuteIndirectCommand& executeIndirectCommand);
+}
@@ -0,0 +1,166 @@
+
+
+#include "IndirectDrawBuffer.hpp"
+
+#include "D3D12RenderBackend.hpp"
+#include "Device.hpp"
+#include "GraphicsContext.hpp"
+#include "PipelineState.hpp"
+
+namespace helios::gfx
+{
+	IndirectDrawBuffer::IndirectDrawBuffer(const Device* device, uint32_t drawDataStride, std::wstring_view name) : mDrawDataStride(drawDataStride), mName(name)
+	{
+		// Same order as IndirectDrawArguments.
+		const std::array<D3D12_INDIRECT_ARGUMENT_DESC, 3u> indirectArgumentDescs
+		{
+			D3D12_INDIRECT_ARGUMENT_DESC
+			{
+				.Type = D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW,
+			},
+			D3D12_INDIRECT_ARGUMENT_DESC
+			{
+				.Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT,
+				.Constant
+				{
+					.RootParameterIndex = 0u,
+					.DestOffsetIn32BitValues = static_cast<UINT>(offsetof(IndirectDrawRenderResources, drawIndex) / sizeof(uint32_t)),
+					.Num32BitValuesToSet = 1u,
+				},
+			},
+			D3D12_INDIRECT_ARGUMENT_DESC
+			{
+				.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED,
+			},
+		};
+
+		const D3D12_COMMAND_SIGNATURE_DESC commandSignatureDesc
+		{
+			.ByteStride = static_cast<UINT>(sizeof(IndirectDrawArguments)),
+			.NumArgumentDescs = static_cast<UINT>(indirectArgumentDescs.size()),
+			.pArgumentDescs = indirectArgumentDescs.data(),
+			.NodeMask = 0u,
+		};
+
+		// The root signature is required as the command signature changes root arguments.
+		ThrowIfFailed(device->GetDevice()->CreateCommandSignature(&commandSignatureDesc, PipelineState::rootSignature.Get(), IID_PPV_ARGS(&mCommandSignature)));
+		mCommandSignature->SetName((mName + L" Command Signature").c_str());
+	}
+
+	void IndirectDrawBuffer::Upload(Device* device, const IndirectDrawStream& indirectDrawStream)
+	{
+		mVersionIndex = static_cast<uint32_t>(device->GetFrameNumber() % MAX_FRAMES_IN_FLIGHT);
+		mDrawCount = indirectDrawStream.GetDrawCount();
+
+		Version& version = mVersions[mVersionIndex];
+
+		if (mDrawCount > version.drawCapacity)
+		{
+			// Frames in flight may still execute the draws of the old version.
+			if (version.argumentAllocation)
+			{
+				device->DeferredRelease(std::move(version.argumentAllocation));
+				device->DeferredRelease(std::move(version.drawDataAllocation));
+				device->DeferredRelease(device->GetSrvCbvUavDescriptor(), version.argumentBufferIndex);
+				device->DeferredRelease(device->GetSrvCbvUavDescriptor(), version.drawDataBufferIndex);
+			}
+
+			version.drawCapacity = static_cast<uint32_t>(static_cast<float>(mDrawCount) * DRAW_CAPACITY_GROWTH_FACTOR);
+
+			const BufferCreationDesc argumentBufferCreationDesc
+			{
+				.usage = BufferUsage::UploadBuffer,
+				.name = mName + L" Argument Buffer " + std::to_wstring(mVersionIndex),
+			};
+
+			version.argumentAllocation = device->GetMemoryAllocator()->CreateBufferResourceAllocation(argumentBufferCreationDesc,
+				ResourceCreationDesc::CreateBufferResourceCreationDesc(static_cast<uint64_t>(version.drawCapacity) * sizeof(IndirectDrawArguments)));
+
+			const BufferCreationDesc drawDataBufferCreationDesc
+			{
+				.usage = BufferUsage::UploadBuffer,
+				.name = mName + L" Draw Data Buffer " + std::to_wstring(mVersionIndex),
+			};
+
+			version.drawDataAllocation = device->GetMemoryAllocator()->CreateBufferResourceAllocation(drawDataBufferCreationDesc,
+				ResourceCreationDesc::CreateBufferResourceCreationDesc(static_cast<uint64_t>(version.drawCapacity) * mDrawDataStride));
+
+			// The arguments are also read by the occlusion culling shader (see HiZCullingPass).
+			const SrvCreationDesc argumentSrvCreationDesc
+			{
+				.srvDesc
+				{
+					.Format = DXGI_FORMAT_UNKNOWN,
+					.ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+					.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+					.Buffer
+					{
+						.FirstElement = 0u,
+						.NumElements = version.drawCapacity,
+						.StructureByteStride = static_cast<UINT>(sizeof(IndirectDrawArguments)),
+					}
+				}
+			};
+
+			version.argumentBufferIndex = device->CreateSrv(argumentSrvCreationDesc, version.argumentAllocation->resource.Get());
+
+			const SrvCreationDesc srvCreationDesc
+			{
+				.srvDesc
+				{
+					.Format = DXGI_FORMAT_UNKNOWN,
+					.ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+					.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+					.Buffer
+					{
+						.FirstElement = 0u,
+						.NumElements = version.drawCapacity,
+						.StructureByteStride = mDrawDataStride,
+					}
+				}
+			};
+
+			version.drawDataBufferIndex = device->CreateSrv(srvCreationDesc, version.drawDataAllocation->resource.Get());
+		}
+
+		if (mDrawCount != 0u)
+		{
+			version.argumentAllocation->Update(indirectDrawStream.GetArguments().data(), indirectDrawStream.GetArguments().size_bytes());
+			version.drawDataAllocation->Update(indirectDrawStream.GetDrawData().data(), indirectDrawStream.GetDrawData().size_bytes());
+		}
+	}
+
+	void IndirectDrawBuffer::ExecuteIndirect(const GraphicsContext* graphicsContext) const
+	{
+		if (mDrawCount == 0u)
+		{
+			return;
+		}
+
+		RecordIndirectDraws(graphicsContext->GetCommandStream(), GetDrawDataBufferIndex(), ExecuteIndirectCommand
+		{
+			.commandSignature = D3D12RenderBackend::ToCommandHandle(mCommandSignature.Get()),
+			.maxCommandCount = mDrawCount,
+			.argumentBuffer = D3D12RenderBackend::ToCommandHandle(mVersions[mVersionIndex].argumentAllocation->resource.Get()),
+		});
+	}
+
+	void IndirectDrawBuffer::ExecuteIndirect(const GraphicsContext* graphicsContext, ID3D12Resource* const argumentBuffer, uint64_t argumentBufferOffset,
+		ID3D12Resource* const countBuffer, uint64_t countBufferOffset) const
+	{
+		if (mDrawCount == 0u)
+		{
+			return;
+		}
+
+		RecordIndirectDraws(graphicsContext->GetCommandStream(), GetDrawDataBufferIndex(), ExecuteIndirectCommand
+		{
+			.commandSignature = D3D12RenderBackend::ToCommandHandle(mCommandSignature.Get()),
+			.maxCommandCount = mDrawCount,
+			.argumentBuffer = D3D12RenderBackend::ToCommandHandle(argumentBuffer),
+			.argumentBufferOffset = argumentBufferOffset,
+			.countBuffer = D3D12RenderBackend::ToCommandHandle(countBuffer),
+			.countBufferOffset = countBufferOffset,
+		});
+	}
+}
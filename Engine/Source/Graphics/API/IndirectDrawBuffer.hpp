@@ -0,0 +1,62 @@
+#pragma once
+
+#include "IndirectDraw.hpp"
+#include "Resources.hpp"
+
+namespace helios::gfx
+{
+	class Device;
+	class GraphicsContext;
+
+	// GPU side of an IndirectDrawStream : the arguments and draw data are written into upload buffers (with a version per frame in flight, as for constant
+	// buffers, see Buffer::Update), and all draws are executed by a single ExecuteIndirect.
+	// The command signature sets the index buffer and the draw index (IndirectDrawRenderResources::drawIndex) per draw, so the only per draw work left for the
+	// CPU is writing the draw into the stream. Shaders read the draw data from the structured buffer IndirectDrawRenderResources::drawDataBufferIndex.
+	// Note : The buffers are not transitioned, as upload heap buffers are always in the GENERIC_READ state (which includes the indirect argument state).
+	class IndirectDrawBuffer
+	{
+	public:
+		IndirectDrawBuffer(const Device* device, uint32_t drawDataStride, std::wstring_view name);
+
+		// Copies the draws into the version of the buffers of the frame being recorded. If they do not fit, the version is recreated (with room to grow),
+		// and the old one released once the frames in flight are done with it.
+		void Upload(Device* device, const IndirectDrawStream& indirectDrawStream);
+
+		// Records the draws last uploaded, along with their root constants (see RecordIndirectDraws). The pipeline state, render targets etc must be set.
+		void ExecuteIndirect(const GraphicsContext* graphicsContext) const;
+
+		// Records the subset of the draws last uploaded whose arguments were written by the GPU into argumentBuffer (i.e the draws kept by a culling shader),
+		// their count (at most GetDrawCount()) being read from countBuffer. Both must be in the indirect argument state.
+		void ExecuteIndirect(const GraphicsContext* graphicsContext, ID3D12Resource* const argumentBuffer, uint64_t argumentBufferOffset, ID3D12Resource* const countBuffer,
+			uint64_t countBufferOffset) const;
+
+		// SRV indices of the arguments (a structured buffer of IndirectDrawArguments) and of the draw data of the draws last uploaded.
+		uint32_t GetArgumentBufferIndex() const { return mVersions[mVersionIndex].argumentBufferIndex; }
+		uint32_t GetDrawDataBufferIndex() const { return mVersions[mVersionIndex].drawDataBufferIndex; }
+
+		uint32_t GetDrawCount() const { return mDrawCount; }
+
+	private:
+		struct Version
+		{
+			std::unique_ptr<Allocation> argumentAllocation{};
+			std::unique_ptr<Allocation> drawDataAllocation{};
+			uint32_t argumentBufferIndex{ UINT32_MAX };
+			uint32_t drawDataBufferIndex{ UINT32_MAX };
+			uint32_t drawCapacity{};
+		};
+
+	private:
+		// Versions are recreated with this many times the required capacity, so they are not recreated every time the draw count grows.
+		static constexpr float DRAW_CAPACITY_GROWTH_FACTOR = 1.5f;
+
+		Microsoft::WRL::ComPtr<ID3D12CommandSignature> mCommandSignature{};
+
+		std::array<Version, MAX_FRAMES_IN_FLIGHT> mVersions{};
+		uint32_t mVersionIndex{};
+		uint32_t mDrawCount{};
+
+		uint32_t mDrawDataStride{};
+		std::wstring mName{};
+	};
+}
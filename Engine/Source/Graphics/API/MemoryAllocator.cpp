@@ -8,7 +8,7 @@ using namespace Microsoft::WRL;
 
 namespace helios::gfx
 {
-    MemoryAllocator::MemoryAllocator(ID3D12Device *device, IDXGIAdapter *adapter)
+    MemoryAllocator::MemoryAllocator(ID3D12Device *device, IDXGIAdapter *adapter) : mDevice(device)
     {
         // Create D3D12MA adapter.
         D3D12MA::ALLOCATOR_DESC allocatorDesc
@@ -18,6 +18,116 @@ namespace helios::gfx
         };
 
         ThrowIfFailed(D3D12MA::CreateAllocator(&allocatorDesc, &mAllocator));
+
+        mMemoryStatistics = std::make_shared<MemoryStatistics>();
+        mResourceStateRegistry = std::make_shared<ResourceStateRegistry>();
+
+        if constexpr (USE_TLSF_HEAP_POOLS)
+        {
+            CreatePlacedResourceHeapPools();
+        }
+    }
+
+    void MemoryAllocator::CreatePlacedResourceHeapPools()
+    {
+        mPlacedResourceHeapPools = std::make_shared<PlacedResourceHeapPools>();
+
+        static constexpr std::array<D3D12_HEAP_FLAGS, static_cast<size_t>(PlacedResourcePoolType::Count)> heapFlags
+        {
+            D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        };
+
+        static constexpr std::array<std::wstring_view, static_cast<size_t>(PlacedResourcePoolType::Count)> heapNames
+        {
+            L"TLSF Buffer Heap",
+            L"TLSF Texture Heap",
+            L"TLSF Render Target Heap",
+        };
+
+        for (size_t i = 0; i < mPlacedResourceHeapPools->pools.size(); ++i)
+        {
+            PlacedResourceHeapPool& pool = mPlacedResourceHeapPools->pools[i];
+
+            // The callbacks are invoked by the TLSF pool with the pools mutex held.
+            auto onBlockCreated = [device = mDevice, &pool, heapFlag = heapFlags[i], heapName = heapNames[i]](uint32_t blockIndex, uint64_t sizeInBytes)
+            {
+                D3D12_HEAP_DESC heapDesc
+                {
+                    .SizeInBytes = sizeInBytes,
+                    .Properties
+                    {
+                        .Type = D3D12_HEAP_TYPE_DEFAULT,
+                    },
+                    .Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+                    .Flags = heapFlag,
+                };
+
+                if (blockIndex >= pool.heaps.size())
+                {
+                    pool.heaps.resize(blockIndex + 1u);
+                }
+
+                ThrowIfFailed(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&pool.heaps[blockIndex])));
+                pool.heaps[blockIndex]->SetName((std::wstring(heapName) + L" " + std::to_wstring(blockIndex)).c_str());
+            };
+
+            auto onBlockDestroyed = [&pool](uint32_t blockIndex, uint64_t sizeInBytes)
+            {
+                pool.heaps[blockIndex].Reset();
+            };
+
+            pool.heapPool = std::make_unique<TlsfHeapPool>(TLSF_HEAP_BLOCK_SIZE, std::move(onBlockCreated), std::move(onBlockDestroyed));
+        }
+    }
+
+    std::unique_ptr<Allocation> MemoryAllocator::CreatePlacedResourceAllocation(const PlacedResourcePoolType &poolType, const D3D12_RESOURCE_DESC &resourceDesc, const D3D12_RESOURCE_STATES &resourceState,
+        const D3D12_CLEAR_VALUE *optimizedClearValue, std::wstring_view name, const MemoryCategory &memoryCategory)
+    {
+        Allocation allocation{};
+
+        const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = mDevice->GetResourceAllocationInfo(0u, 1u, &resourceDesc);
+        const uint64_t alignment = std::max<uint64_t>(allocationInfo.Alignment, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+        PlacedResourceHeapPool& pool = mPlacedResourceHeapPools->pools[static_cast<size_t>(poolType)];
+
+        std::optional<TlsfHeapPoolAllocation> placement{};
+        ID3D12Heap* heap{};
+
+        {
+            std::lock_guard<std::mutex> placedResourceLockGuard(mPlacedResourceHeapPools->mutex);
+
+            placement = pool.heapPool->Allocate(allocationInfo.SizeInBytes, alignment);
+            if (!placement.has_value())
+            {
+                ErrorMessage(L"Failed to find a heap range for placed resource : " + std::wstring(name));
+            }
+
+            // The heap cannot be destroyed while the range just allocated from it is in use, so it is safe to use outside of the lock.
+            heap = pool.heaps[placement->blockIndex].Get();
+        }
+
+        ThrowIfFailed(mDevice->CreatePlacedResource(heap, placement->allocation.offset, &resourceDesc, resourceState, optimizedClearValue, IID_PPV_ARGS(&allocation.resource)));
+        allocation.resource->SetName(name.data());
+
+        // The handle holds a weak reference to the pools, as static resources can outlive the memory allocator (in which case the heaps are already released).
+        std::weak_ptr<PlacedResourceHeapPools> placedResourceHeapPools = mPlacedResourceHeapPools;
+        allocation.placementHandle = std::shared_ptr<void>(new TlsfHeapPoolAllocation(placement.value()), [placedResourceHeapPools, poolType](TlsfHeapPoolAllocation* placement)
+        {
+            if (std::shared_ptr<PlacedResourceHeapPools> pools = placedResourceHeapPools.lock())
+            {
+                std::lock_guard<std::mutex> placedResourceLockGuard(pools->mutex);
+                pools->pools[static_cast<size_t>(poolType)].heapPool->Free(*placement);
+            }
+
+            delete placement;
+        });
+
+        allocation.statisticsHandle = mMemoryStatistics->RegisterAllocation(WstringToString(name), memoryCategory, placement->allocation.sizeInBytes);
+        allocation.resourceStateHandle = mResourceStateRegistry->RegisterResource(reinterpret_cast<CommandHandle>(allocation.resource.Get()), static_cast<uint32_t>(resourceState));
+
+        return std::move(std::make_unique<Allocation>(allocation));
     }
 
     std::unique_ptr<Allocation> MemoryAllocator::CreateBufferResourceAllocation(
@@ -28,6 +138,7 @@ namespace helios::gfx
         D3D12_RESOURCE_STATES resourceState{D3D12_RESOURCE_STATE_COMMON};
         D3D12_HEAP_TYPE heapType{D3D12_HEAP_TYPE_DEFAULT};
         bool isCpuVisible{};
+        MemoryCategory memoryCategory{};
 
         switch (bufferCreationDesc.usage)
             {
@@ -37,17 +148,25 @@ namespace helios::gfx
                 resourceState = D3D12_RESOURCE_STATE_GENERIC_READ;
                 heapType = D3D12_HEAP_TYPE_UPLOAD;
                 isCpuVisible = true;
+                memoryCategory = bufferCreationDesc.usage == BufferUsage::UploadBuffer ? MemoryCategory::Staging : MemoryCategory::ConstantBuffer;
             }break;
 
             case BufferUsage::IndexBuffer:
             case BufferUsage::StructuredBuffer: 
+            case BufferUsage::UAVBuffer:
             {
                 resourceState = D3D12_RESOURCE_STATE_COMMON;
                 heapType = D3D12_HEAP_TYPE_DEFAULT;
                 isCpuVisible = false;
+                memoryCategory = MemoryCategory::Mesh;
             }break;
         };
 
+        if (USE_TLSF_HEAP_POOLS && heapType == D3D12_HEAP_TYPE_DEFAULT)
+        {
+            return CreatePlacedResourceAllocation(PlacedResourcePoolType::Buffer, resourceCreationDesc.resourceDesc, resourceState, nullptr, bufferCreationDesc.name, memoryCategory);
+        }
+
         D3D12MA::ALLOCATION_DESC allocationDesc{.HeapType = heapType};
 
         ThrowIfFailed(mAllocator->CreateResource(&allocationDesc, &resourceCreationDesc.resourceDesc, resourceState, nullptr, &allocation.allocation, IID_PPV_ARGS(&allocation.resource)));
@@ -61,19 +180,14 @@ namespace helios::gfx
 
         allocation.resource->SetName(bufferCreationDesc.name.c_str());
         allocation.allocation->SetResource(allocation.resource.Get());
+        allocation.statisticsHandle = mMemoryStatistics->RegisterAllocation(WstringToString(bufferCreationDesc.name), memoryCategory, allocation.allocation->GetSize());
+        allocation.resourceStateHandle = mResourceStateRegistry->RegisterResource(reinterpret_cast<CommandHandle>(allocation.resource.Get()), static_cast<uint32_t>(resourceState));
 
         return std::move(std::make_unique<Allocation>(allocation));
     }
 
-    std::unique_ptr<Allocation> MemoryAllocator::CreateTextureResourceAllocation(TextureCreationDesc &textureCreationDesc)
+    ResourceCreationDesc MemoryAllocator::CreateTextureResourceCreationDesc(TextureCreationDesc &textureCreationDesc)
     {
-        Allocation allocation{};
-
-        D3D12_RESOURCE_STATES resourceState{D3D12_RESOURCE_STATE_COMMON};
-        D3D12_HEAP_TYPE heapType{D3D12_HEAP_TYPE_DEFAULT};
-
-        D3D12MA::ALLOCATION_DESC allocationDesc{.HeapType = heapType};
-
         DXGI_FORMAT format{textureCreationDesc.format};
         DXGI_FORMAT dsFormat{};
 
@@ -122,17 +236,12 @@ namespace helios::gfx
         {
             resourceCreationDesc.resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
             resourceCreationDesc.resourceDesc.Format = dsFormat;
-            allocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
-            resourceState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
         }
         break;
 
         case TextureUsage::RenderTarget: 
         {
             resourceCreationDesc.resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
-            allocationDesc.ExtraHeapFlags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
-            allocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
-            resourceState = D3D12_RESOURCE_STATE_COMMON;
         }
         break;
 
@@ -144,6 +253,55 @@ namespace helios::gfx
         case TextureUsage::UAVTexture:
         {
             resourceCreationDesc.resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+        break;
+        };
+
+        return resourceCreationDesc;
+    }
+
+    std::unique_ptr<Allocation> MemoryAllocator::CreateTextureResourceAllocation(TextureCreationDesc &textureCreationDesc)
+    {
+        Allocation allocation{};
+
+        D3D12_RESOURCE_STATES resourceState{D3D12_RESOURCE_STATE_COMMON};
+        D3D12_HEAP_TYPE heapType{D3D12_HEAP_TYPE_DEFAULT};
+
+        D3D12MA::ALLOCATION_DESC allocationDesc{.HeapType = heapType};
+
+        ResourceCreationDesc resourceCreationDesc = CreateTextureResourceCreationDesc(textureCreationDesc);
+
+        const DXGI_FORMAT format{resourceCreationDesc.resourceDesc.Format};
+
+        switch (textureCreationDesc.usage)
+        {
+        case TextureUsage::DepthStencil: 
+        {
+            allocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
+            resourceState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+        }
+        break;
+
+        case TextureUsage::RenderTarget: 
+        {
+            allocationDesc.ExtraHeapFlags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+            allocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
+            resourceState = D3D12_RESOURCE_STATE_COMMON;
+        }
+        break;
+
+        // Note : Scene textures are committed, so that the residency manager can evict them individually.
+        case TextureUsage::TextureFromPath:
+        case TextureUsage::TextureFromData:
+        case TextureUsage::HDRTextureFromPath:
+        {
+            allocationDesc.Flags |= D3D12MA::ALLOCATION_FLAG_COMMITTED;
+            resourceState = D3D12_RESOURCE_STATE_COMMON;
+        }
+        break;
+
+        default:
+        {
             resourceState = D3D12_RESOURCE_STATE_COMMON;
         }
         break;
@@ -163,7 +321,7 @@ namespace helios::gfx
         {
             D3D12_DEPTH_STENCIL_VALUE dsValue{.Depth = 1.0f, .Stencil = 1u};
 
-            optimizedClearValue = {.Format = dsFormat, .DepthStencil = dsValue};
+            optimizedClearValue = {.Format = format, .DepthStencil = dsValue};
         }
 
         std::lock_guard<std::recursive_mutex> resourceAllocationLockGuard(mResourceAllocationMutex);
@@ -173,10 +331,135 @@ namespace helios::gfx
             resourceState = textureCreationDesc.optionalInitialState;
         }
 
+        // Transient resources are placed inside a heap allocation shared with other resources, in which case the allocation is owned by the transient resource pool.
+        // Their memory is accounted for by the heap allocation, so they are not registered with the memory statistics.
+        if (textureCreationDesc.aliasingAllocation)
+        {
+            ThrowIfFailed(
+                mAllocator->CreateAliasingResource(textureCreationDesc.aliasingAllocation, textureCreationDesc.aliasingOffset, &resourceCreationDesc.resourceDesc, resourceState, optimizedClearValue.has_value() ? &optimizedClearValue.value() : nullptr, IID_PPV_ARGS(&allocation.resource)));
+            allocation.resource->SetName(textureCreationDesc.name.c_str());
+            allocation.resourceStateHandle = mResourceStateRegistry->RegisterResource(reinterpret_cast<CommandHandle>(allocation.resource.Get()), static_cast<uint32_t>(resourceState));
+            return std::move(std::make_unique<Allocation>(allocation));
+        }
+
+        const bool isRenderTexture = textureCreationDesc.usage == TextureUsage::RenderTarget || textureCreationDesc.usage == TextureUsage::DepthStencil;
+        const MemoryCategory memoryCategory = isRenderTexture ? MemoryCategory::RenderTarget : MemoryCategory::Texture;
+
+        if constexpr (USE_TLSF_HEAP_POOLS)
+        {
+            return CreatePlacedResourceAllocation(isRenderTexture ? PlacedResourcePoolType::RenderTarget : PlacedResourcePoolType::Texture, resourceCreationDesc.resourceDesc, resourceState,
+                optimizedClearValue.has_value() ? &optimizedClearValue.value() : nullptr, textureCreationDesc.name, memoryCategory);
+        }
+
         ThrowIfFailed(
             mAllocator->CreateResource(&allocationDesc, &resourceCreationDesc.resourceDesc, resourceState, optimizedClearValue.has_value() ? &optimizedClearValue.value() : nullptr, &allocation.allocation, IID_PPV_ARGS(&allocation.resource)));
         allocation.resource->SetName(textureCreationDesc.name.c_str());
         allocation.allocation->SetResource(allocation.resource.Get());
+
+        allocation.statisticsHandle = mMemoryStatistics->RegisterAllocation(WstringToString(textureCreationDesc.name), memoryCategory, allocation.allocation->GetSize());
+        allocation.resourceStateHandle = mResourceStateRegistry->RegisterResource(reinterpret_cast<CommandHandle>(allocation.resource.Get()), static_cast<uint32_t>(resourceState));
+
         return std::move(std::make_unique<Allocation>(allocation));
     }
+
+    D3D12_RESOURCE_ALLOCATION_INFO MemoryAllocator::GetTextureAllocationInfo(TextureCreationDesc &textureCreationDesc)
+    {
+        ResourceCreationDesc resourceCreationDesc = CreateTextureResourceCreationDesc(textureCreationDesc);
+
+        return mDevice->GetResourceAllocationInfo(0u, 1u, &resourceCreationDesc.resourceDesc);
+    }
+
+    std::unique_ptr<Allocation> MemoryAllocator::CreateAliasingHeapAllocation(uint64_t sizeInBytes, std::wstring_view name)
+    {
+        Allocation allocation{};
+
+        // Render targets and depth stencil textures can share a heap on all resource heap tiers, as long as it is restricted to only RT / DS textures.
+        D3D12MA::ALLOCATION_DESC allocationDesc
+        {
+            .Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED,
+            .HeapType = D3D12_HEAP_TYPE_DEFAULT,
+            .ExtraHeapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        };
+
+        D3D12_RESOURCE_ALLOCATION_INFO allocationInfo
+        {
+            .SizeInBytes = sizeInBytes,
+            .Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+        };
+
+        std::lock_guard<std::recursive_mutex> resourceAllocationLockGuard(mResourceAllocationMutex);
+
+        ThrowIfFailed(mAllocator->AllocateMemory(&allocationDesc, &allocationInfo, &allocation.allocation));
+        allocation.allocation->SetName(name.data());
+        allocation.statisticsHandle = mMemoryStatistics->RegisterAllocation(WstringToString(name), MemoryCategory::RenderTarget, allocation.allocation->GetSize());
+
+        return std::move(std::make_unique<Allocation>(allocation));
+    }
+
+    MemoryStatisticsSnapshot MemoryAllocator::GetMemoryStatistics()
+    {
+        D3D12MA::TotalStatistics totalStatistics{};
+        D3D12MA::Budget localBudget{};
+        D3D12MA::Budget nonLocalBudget{};
+
+        {
+            std::lock_guard<std::recursive_mutex> resourceAllocationLockGuard(mResourceAllocationMutex);
+
+            mAllocator->CalculateStatistics(&totalStatistics);
+            mAllocator->GetBudget(&localBudget, &nonLocalBudget);
+        }
+
+        const D3D12MA::DetailedStatistics& total = totalStatistics.Total;
+
+        MemoryBlockStatistics blockStatistics
+        {
+            .blockCount = total.Stats.BlockCount,
+            .allocationCount = total.Stats.AllocationCount,
+            .blockBytes = total.Stats.BlockBytes,
+            .allocationBytes = total.Stats.AllocationBytes,
+            .unusedRangeCount = total.UnusedRangeCount,
+            .largestUnusedRangeBytes = total.UnusedRangeCount > 0u ? total.UnusedRangeSizeMax : 0u,
+        };
+
+        // The TLSF heaps are created directly on the device, so D3D12MA does not know about them.
+        if (mPlacedResourceHeapPools)
+        {
+            std::lock_guard<std::mutex> placedResourceLockGuard(mPlacedResourceHeapPools->mutex);
+
+            for (const PlacedResourceHeapPool& pool : mPlacedResourceHeapPools->pools)
+            {
+                const TlsfStatistics tlsfStatistics = pool.heapPool->GetStatistics();
+
+                blockStatistics.blockCount += pool.heapPool->GetBlockCount();
+                blockStatistics.allocationCount += tlsfStatistics.allocationCount;
+                blockStatistics.blockBytes += tlsfStatistics.capacityInBytes;
+                blockStatistics.allocationBytes += tlsfStatistics.usedBytes;
+                blockStatistics.unusedRangeCount += tlsfStatistics.freeBlockCount;
+                blockStatistics.largestUnusedRangeBytes = std::max(blockStatistics.largestUnusedRangeBytes, tlsfStatistics.largestFreeBlockBytes);
+            }
+        }
+
+        mMemoryStatistics->SetBlockStatistics(blockStatistics);
+
+        mMemoryStatistics->SetBudgets({ .usageInBytes = localBudget.UsageBytes, .budgetInBytes = localBudget.BudgetBytes },
+                                      { .usageInBytes = nonLocalBudget.UsageBytes, .budgetInBytes = nonLocalBudget.BudgetBytes });
+
+        return mMemoryStatistics->GetSnapshot();
+    }
+
+    MemoryBudget MemoryAllocator::GetLocalBudget()
+    {
+        D3D12MA::Budget localBudget{};
+
+        {
+            std::lock_guard<std::recursive_mutex> resourceAllocationLockGuard(mResourceAllocationMutex);
+            mAllocator->GetBudget(&localBudget, nullptr);
+        }
+
+        return MemoryBudget
+        {
+            .usageInBytes = localBudget.UsageBytes,
+            .budgetInBytes = localBudget.BudgetBytes,
+        };
+    }
 } // namespace helios::gfx
\ No newline at end of file
@@ -3,23 +3,79 @@
 
 
 #include "Resources.hpp"
+#include "TlsfAllocator.hpp"
 
 namespace helios::gfx
 {
-	// Memory allocator handles allocation of GPU memory. As of now, D3D12 memory allocator is used.
-	// note (rtarun9) : The plan is to write a custom allocator in the future, but D3D12MA will be used for now.
+	// Memory allocator handles allocation of GPU memory. By default, D3D12 memory allocator is used.
+	// If USE_TLSF_HEAP_POOLS is set, default heap buffers / textures / render targets are instead placed in ID3D12Heap's sub allocated by the in house TLSF allocator (see TlsfAllocator.hpp).
+	// Upload / constant buffers and aliased transient resources always go through D3D12MA.
 	class MemoryAllocator
 	{
 	public:
+		static constexpr bool USE_TLSF_HEAP_POOLS = false;
+		static constexpr uint64_t TLSF_HEAP_BLOCK_SIZE = 64u * 1024u * 1024u;
+
 		MemoryAllocator(ID3D12Device* device, IDXGIAdapter* adapter);
 	
 		// While both the CreateXResourceAllocation can be merged, it leads to a bit strange / awkward code, so seperating it for now.
 		std::unique_ptr<Allocation> CreateBufferResourceAllocation(const BufferCreationDesc& bufferCreationDesc, const ResourceCreationDesc& resourceCreationDesc);
 		std::unique_ptr<Allocation> CreateTextureResourceAllocation(TextureCreationDesc& textureCreationDesc);
 
+		// Used by the transient resource pool : query the size / alignment a texture would need, and create a heap in which multiple such textures can be placed.
+		D3D12_RESOURCE_ALLOCATION_INFO GetTextureAllocationInfo(TextureCreationDesc& textureCreationDesc);
+		std::unique_ptr<Allocation> CreateAliasingHeapAllocation(uint64_t sizeInBytes, std::wstring_view name);
+
+		// Queries the block statistics and budgets from D3D12MA, and returns them along with the per category / per resource sizes of all live allocations.
+		// Note : Calculating block statistics is not cheap, so avoid calling this every frame when the data is not displayed.
+		MemoryStatisticsSnapshot GetMemoryStatistics();
+
+		// Cheap to query (unlike the full statistics), used by the residency manager every frame.
+		MemoryBudget GetLocalBudget();
+
+		// Holds the state of all the resources created by the allocator between submissions (see Device::ExecuteContext).
+		ResourceStateRegistry* GetResourceStateRegistry() const { return mResourceStateRegistry.get(); }
+
+	private:
+		// Each pool has its own heaps, as resource heap tier 1 hardware does not allow buffers, textures and RT / DS textures to share a heap.
+		enum class PlacedResourcePoolType : uint32_t
+		{
+			Buffer,
+			Texture,
+			RenderTarget,
+			Count
+		};
+
+		// Note : The heaps are declared before the TLSF pool, as the pool destructor releases them through its block destroyed callback.
+		struct PlacedResourceHeapPool
+		{
+			std::vector<Microsoft::WRL::ComPtr<ID3D12Heap>> heaps{};
+			std::unique_ptr<TlsfHeapPool> heapPool{};
+		};
+
+		// Shared with the placement handles of the allocations, which may outlive the memory allocator.
+		struct PlacedResourceHeapPools
+		{
+			std::mutex mutex{};
+			std::array<PlacedResourceHeapPool, static_cast<size_t>(PlacedResourcePoolType::Count)> pools{};
+		};
+
 	private:
+		ResourceCreationDesc CreateTextureResourceCreationDesc(TextureCreationDesc& textureCreationDesc);
+
+		void CreatePlacedResourceHeapPools();
+		std::unique_ptr<Allocation> CreatePlacedResourceAllocation(const PlacedResourcePoolType& poolType, const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_RESOURCE_STATES& resourceState,
+			const D3D12_CLEAR_VALUE* optimizedClearValue, std::wstring_view name, const MemoryCategory& memoryCategory);
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device> mDevice{};
 		Microsoft::WRL::ComPtr<D3D12MA::Allocator> mAllocator{};
 		std::recursive_mutex mResourceAllocationMutex{};
+
+		std::shared_ptr<MemoryStatistics> mMemoryStatistics{};
+		std::shared_ptr<ResourceStateRegistry> mResourceStateRegistry{};
+
+		std::shared_ptr<PlacedResourceHeapPools> mPlacedResourceHeapPools{};
 	};
 
 }
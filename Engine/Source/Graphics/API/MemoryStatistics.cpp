@@ -0,0 +1,245 @@
+#include "MemoryStatistics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace helios::gfx
+{
+	const char* MemoryCategoryToString(const MemoryCategory& memoryCategory)
+	{
+		switch (memoryCategory)
+		{
+		case MemoryCategory::Texture:
+		{
+			return "Texture";
+		}break;
+
+		case MemoryCategory::Mesh:
+		{
+			return "Mesh";
+		}break;
+
+		case MemoryCategory::RenderTarget:
+		{
+			return "RenderTarget";
+		}break;
+
+		case MemoryCategory::ConstantBuffer:
+		{
+			return "ConstantBuffer";
+		}break;
+
+		case MemoryCategory::Staging:
+		{
+			return "Staging";
+		}break;
+
+		case MemoryCategory::Count:
+		{
+			return "Unknown";
+		}break;
+		}
+
+		return "Unknown";
+	}
+
+	double MemoryBlockStatistics::GetFragmentation() const
+	{
+		const uint64_t unusedBytes = blockBytes - std::min(blockBytes, allocationBytes);
+		if (unusedBytes == 0u)
+		{
+			return 0.0;
+		}
+
+		return 1.0 - static_cast<double>(std::min(largestUnusedRangeBytes, unusedBytes)) / static_cast<double>(unusedBytes);
+	}
+
+	uint64_t MemoryStatisticsSnapshot::GetTotalSizeInBytes() const
+	{
+		uint64_t totalSizeInBytes{};
+		for (const uint64_t& categorySize : categorySizesInBytes)
+		{
+			totalSizeInBytes += categorySize;
+		}
+
+		return totalSizeInBytes;
+	}
+
+	uint32_t MemoryStatisticsSnapshot::GetTotalAllocationCount() const
+	{
+		uint32_t totalAllocationCount{};
+		for (const uint32_t& categoryAllocationCount : categoryAllocationCounts)
+		{
+			totalAllocationCount += categoryAllocationCount;
+		}
+
+		return totalAllocationCount;
+	}
+
+	MemoryStatisticsHandle MemoryStatistics::RegisterAllocation(std::string_view name, const MemoryCategory& category, uint64_t sizeInBytes)
+	{
+		uint64_t allocationId{};
+
+		{
+			std::lock_guard<std::mutex> lockGuard(mMutex);
+
+			allocationId = mNextAllocationId++;
+			mResourceRecords[allocationId] = MemoryResourceRecord
+			{
+				.name = std::string(name),
+				.category = category,
+				.sizeInBytes = sizeInBytes
+			};
+		}
+
+		// The statistics object may be destroyed before the last allocation (i.e static resources), hence the weak reference.
+		std::weak_ptr<MemoryStatistics> memoryStatistics = weak_from_this();
+
+		return MemoryStatisticsHandle(new uint64_t(allocationId), [memoryStatistics](const uint64_t* allocationId)
+		{
+			if (std::shared_ptr<MemoryStatistics> statistics = memoryStatistics.lock())
+			{
+				statistics->UnregisterAllocation(*allocationId);
+			}
+
+			delete allocationId;
+		});
+	}
+
+	void MemoryStatistics::UnregisterAllocation(uint64_t allocationId)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		mResourceRecords.erase(allocationId);
+	}
+
+	void MemoryStatistics::SetBlockStatistics(const MemoryBlockStatistics& blockStatistics)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		mBlockStatistics = blockStatistics;
+	}
+
+	void MemoryStatistics::SetBudgets(const MemoryBudget& localBudget, const MemoryBudget& nonLocalBudget)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		mLocalBudget = localBudget;
+		mNonLocalBudget = nonLocalBudget;
+	}
+
+	MemoryStatisticsSnapshot MemoryStatistics::GetSnapshot() const
+	{
+		MemoryStatisticsSnapshot snapshot{};
+
+		{
+			std::lock_guard<std::mutex> lockGuard(mMutex);
+
+			snapshot.resources.reserve(mResourceRecords.size());
+			for (const auto& [allocationId, resourceRecord] : mResourceRecords)
+			{
+				const size_t categoryIndex = static_cast<size_t>(resourceRecord.category);
+
+				snapshot.categorySizesInBytes[categoryIndex] += resourceRecord.sizeInBytes;
+				snapshot.categoryAllocationCounts[categoryIndex]++;
+				snapshot.resources.push_back(resourceRecord);
+			}
+
+			snapshot.blockStatistics = mBlockStatistics;
+			snapshot.localBudget = mLocalBudget;
+			snapshot.nonLocalBudget = mNonLocalBudget;
+		}
+
+		std::sort(snapshot.resources.begin(), snapshot.resources.end(), [](const MemoryResourceRecord& a, const MemoryResourceRecord& b)
+		{
+			if (a.sizeInBytes != b.sizeInBytes)
+			{
+				return a.sizeInBytes > b.sizeInBytes;
+			}
+
+			return a.name < b.name;
+		});
+
+		return snapshot;
+	}
+
+	static std::string EscapeJsonString(std::string_view string)
+	{
+		std::string result{};
+		result.reserve(string.size());
+
+		for (const char& c : string)
+		{
+			switch (c)
+			{
+			case '"':
+			{
+				result += "\\\"";
+			}break;
+
+			case '\\':
+			{
+				result += "\\\\";
+			}break;
+
+			default:
+			{
+				if (static_cast<unsigned char>(c) < 0x20u)
+				{
+					char escaped[8]{};
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+					result += escaped;
+				}
+				else
+				{
+					result += c;
+				}
+			}break;
+			}
+		}
+
+		return result;
+	}
+
+	std::string MemoryStatisticsSnapshotToJson(const MemoryStatisticsSnapshot& snapshot)
+	{
+		std::string json{ "{\n" };
+
+		json += "  \"totalSizeInBytes\": " + std::to_string(snapshot.GetTotalSizeInBytes()) + ",\n";
+		json += "  \"totalAllocationCount\": " + std::to_string(snapshot.GetTotalAllocationCount()) + ",\n";
+
+		json += "  \"categories\": {\n";
+		for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); ++i)
+		{
+			json += "    \"" + std::string(MemoryCategoryToString(static_cast<MemoryCategory>(i))) + "\": { \"sizeInBytes\": " + std::to_string(snapshot.categorySizesInBytes[i]) +
+				", \"allocationCount\": " + std::to_string(snapshot.categoryAllocationCounts[i]) + " }";
+			json += i + 1 < static_cast<size_t>(MemoryCategory::Count) ? ",\n" : "\n";
+		}
+		json += "  },\n";
+
+		char fragmentation[32]{};
+		std::snprintf(fragmentation, sizeof(fragmentation), "%.4f", snapshot.blockStatistics.GetFragmentation());
+
+		json += "  \"blocks\": { \"blockCount\": " + std::to_string(snapshot.blockStatistics.blockCount) +
+			", \"allocationCount\": " + std::to_string(snapshot.blockStatistics.allocationCount) +
+			", \"blockBytes\": " + std::to_string(snapshot.blockStatistics.blockBytes) +
+			", \"allocationBytes\": " + std::to_string(snapshot.blockStatistics.allocationBytes) +
+			", \"unusedRangeCount\": " + std::to_string(snapshot.blockStatistics.unusedRangeCount) +
+			", \"largestUnusedRangeBytes\": " + std::to_string(snapshot.blockStatistics.largestUnusedRangeBytes) +
+			", \"fragmentation\": " + fragmentation + " },\n";
+
+		json += "  \"localBudget\": { \"usageInBytes\": " + std::to_string(snapshot.localBudget.usageInBytes) + ", \"budgetInBytes\": " + std::to_string(snapshot.localBudget.budgetInBytes) + " },\n";
+		json += "  \"nonLocalBudget\": { \"usageInBytes\": " + std::to_string(snapshot.nonLocalBudget.usageInBytes) + ", \"budgetInBytes\": " + std::to_string(snapshot.nonLocalBudget.budgetInBytes) + " },\n";
+
+		json += "  \"resources\": [\n";
+		for (size_t i = 0; i < snapshot.resources.size(); ++i)
+		{
+			const MemoryResourceRecord& resource = snapshot.resources[i];
+
+			json += "    { \"name\": \"" + EscapeJsonString(resource.name) + "\", \"category\": \"" + MemoryCategoryToString(resource.category) + "\", \"sizeInBytes\": " + std::to_string(resource.sizeInBytes) + " }";
+			json += i + 1 < snapshot.resources.size() ? ",\n" : "\n";
+		}
+		json += "  ]\n";
+
+		json += "}\n";
+
+		return json;
+	}
+}
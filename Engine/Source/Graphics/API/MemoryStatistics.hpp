@@ -0,0 +1,101 @@
+#pragma once
+
+// The MemoryAllocator registers every allocation it makes and pushes the backend (D3D12MA) block / budget statistics into this layer.
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace helios::gfx
+{
+	enum class MemoryCategory : uint32_t
+	{
+		Texture,
+		Mesh,
+		RenderTarget,
+		ConstantBuffer,
+		Staging,
+		Count
+	};
+
+	const char* MemoryCategoryToString(const MemoryCategory& memoryCategory);
+
+	// Budget vs usage of a memory segment, as reported by the adapter.
+	struct MemoryBudget
+	{
+		uint64_t usageInBytes{};
+		uint64_t budgetInBytes{};
+	};
+
+	// Statistics of the memory blocks (heaps) the backend allocator has created, and of the allocations placed within them.
+	struct MemoryBlockStatistics
+	{
+		uint32_t blockCount{};
+		uint32_t allocationCount{};
+		uint64_t blockBytes{};
+		uint64_t allocationBytes{};
+		uint32_t unusedRangeCount{};
+		uint64_t largestUnusedRangeBytes{};
+
+		// 0.0 if all unused memory within blocks is a single contiguous range, approaches 1.0 as the unused memory is split into many small ranges.
+		double GetFragmentation() const;
+	};
+
+	struct MemoryResourceRecord
+	{
+		std::string name{};
+		MemoryCategory category{};
+		uint64_t sizeInBytes{};
+	};
+
+	struct MemoryStatisticsSnapshot
+	{
+		std::array<uint64_t, static_cast<size_t>(MemoryCategory::Count)> categorySizesInBytes{};
+		std::array<uint32_t, static_cast<size_t>(MemoryCategory::Count)> categoryAllocationCounts{};
+
+		// Sorted by size (largest first).
+		std::vector<MemoryResourceRecord> resources{};
+
+		MemoryBlockStatistics blockStatistics{};
+		MemoryBudget localBudget{};
+		MemoryBudget nonLocalBudget{};
+
+		uint64_t GetTotalSizeInBytes() const;
+		uint32_t GetTotalAllocationCount() const;
+	};
+
+	// The allocation remains registered until all copies of the handle are destroyed / reset.
+	// The handle shares ownership semantics with the Allocation struct (which uses ComPtr's), so no explicit unregister call is needed.
+	using MemoryStatisticsHandle = std::shared_ptr<const uint64_t>;
+
+	class MemoryStatistics : public std::enable_shared_from_this<MemoryStatistics>
+	{
+	public:
+		// Must be called on a MemoryStatistics object owned by a std::shared_ptr (handles only hold a weak reference to it).
+		MemoryStatisticsHandle RegisterAllocation(std::string_view name, const MemoryCategory& category, uint64_t sizeInBytes);
+
+		void SetBlockStatistics(const MemoryBlockStatistics& blockStatistics);
+		void SetBudgets(const MemoryBudget& localBudget, const MemoryBudget& nonLocalBudget);
+
+		MemoryStatisticsSnapshot GetSnapshot() const;
+
+	private:
+		void UnregisterAllocation(uint64_t allocationId);
+
+	private:
+		mutable std::mutex mMutex{};
+
+		std::unordered_map<uint64_t, MemoryResourceRecord> mResourceRecords{};
+		uint64_t mNextAllocationId{ 1u };
+
+		MemoryBlockStatistics mBlockStatistics{};
+		MemoryBudget mLocalBudget{};
+		MemoryBudget mNonLocalBudget{};
+	};
+
+	std::string MemoryStatisticsSnapshotToJson(const MemoryStatisticsSnapshot& snapshot);
+}
@@ -0,0 +1,66 @@
+#include "MipMapGenerationPlan.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "SinglePassDownsampler.hpp"
+
+namespace helios::gfx
+{
+	uint32_t GetFullMipChainLevelCount(uint32_t width, uint32_t height)
+	{
+		return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+	}
+
+	uint32_t GetMipMapGenerationDispatchMipCount(const MipMapGenerationTexture& texture, uint32_t sourceMipLevel)
+	{
+		const uint32_t sourceWidth = texture.width >> sourceMipLevel;
+		const uint32_t sourceHeight = texture.height >> sourceMipLevel;
+
+		const uint32_t destinationWidth = std::max(sourceWidth >> 1u, 1u);
+		const uint32_t destinationHeight = std::max(sourceHeight >> 1u, 1u);
+
+		// Number of times the destination mip can be halved until one of its dimensions is odd (a dimension of 1 being ignored until both are 1).
+		const uint32_t halvingCount = static_cast<uint32_t>(std::countr_zero((destinationWidth == 1u ? destinationHeight : destinationWidth) |
+			(destinationHeight == 1u ? destinationWidth : destinationHeight)));
+
+		const uint32_t mipCount = std::min(4u, halvingCount + 1u);
+
+		return sourceMipLevel + mipCount >= texture.mipLevels ? texture.mipLevels - sourceMipLevel - 1u : mipCount;
+	}
+
+	uint32_t GetMipMapGenerationDispatchCount(const MipMapGenerationTexture& texture)
+	{
+		uint32_t dispatchCount{};
+		for (uint32_t sourceMipLevel = 0u; sourceMipLevel + 1u < texture.mipLevels; ++dispatchCount)
+		{
+			sourceMipLevel += GetMipMapGenerationDispatchMipCount(texture, sourceMipLevel);
+		}
+
+		return dispatchCount;
+	}
+
+	MipMapGenerationFlushes CountMipMapGenerationFlushes(std::span<const MipMapGenerationTexture> textures)
+	{
+		MipMapGenerationFlushes flushes{};
+
+		for (const MipMapGenerationTexture& texture : textures)
+		{
+			if (texture.mipLevels <= 1u)
+			{
+				continue;
+			}
+
+			const uint32_t dispatchCount = GetMipMapGenerationDispatchCount(texture);
+
+			flushes.textureCount++;
+			flushes.dispatchCount += dispatchCount;
+			flushes.perDispatchFlushCount += dispatchCount;
+			flushes.singlePassDownsampleDispatchCount += IsSinglePassDownsampleSupported(texture.width, texture.height, texture.mipLevels) ? 1u : dispatchCount;
+		}
+
+		flushes.batchFlushCount = flushes.textureCount > 0u ? 1u : 0u;
+
+		return flushes;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace helios::gfx
+{
+	// Dimensions of a texture whose mips are generated (all mips, from mip 0).
+	struct MipMapGenerationTexture
+	{
+		uint32_t width{};
+		uint32_t height{};
+		uint32_t mipLevels{};
+	};
+
+	// Same as Model::LoadMaterials : the full mip chain of a texture.
+	uint32_t GetFullMipChainLevelCount(uint32_t width, uint32_t height);
+
+	// Number of mips generated by the dispatch of GenerateMipsCS.hlsl reading sourceMipLevel : up to 4, as long as the destination mips are exactly half of the
+	// mip before them (an odd dimension requires sampling more texels, which is left to the next dispatch).
+	uint32_t GetMipMapGenerationDispatchMipCount(const MipMapGenerationTexture& texture, uint32_t sourceMipLevel);
+
+	// Dispatches of GenerateMipsCS.hlsl generating the mip chain of a texture (see GetMipMapGenerationDispatchMipCount).
+	uint32_t GetMipMapGenerationDispatchCount(const MipMapGenerationTexture& texture);
+
+	// The compute queue flushes (CPU waits) of generating the mips of a set of textures (i.e the textures of a model) : before MipMapGenerationBatch, every dispatch
+	// was executed and flushed on its own, whereas a batch records the dispatches of all of its textures into a single submission.
+	struct MipMapGenerationFlushes
+	{
+		uint32_t textureCount{};
+		uint32_t dispatchCount{};
+
+		uint32_t perDispatchFlushCount{};
+		uint32_t batchFlushCount{};
+
+		// Dispatches of the batch if the format of the textures supports the single pass downsampler (one dispatch per texture it supports, see
+		// IsSinglePassDownsampleSupported).
+		uint32_t singlePassDownsampleDispatchCount{};
+	};
+
+	MipMapGenerationFlushes CountMipMapGenerationFlushes(std::span<const MipMapGenerationTexture> textures);
+}
@@ -8,6 +8,18 @@
 
 namespace helios::gfx
 {
+	void MipMapGenerationBatch::AddTexture(ID3D12Resource* resource)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		mTextures.emplace_back(resource);
+	}
+
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> MipMapGenerationBatch::TakeTextures()
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		return std::exchange(mTextures, {});
+	}
+
 	MipMapGenerator::MipMapGenerator(gfx::Device* device): mDevice(*device)
 	{
 		ComputePipelineStateCreationDesc pipelineCreationDesc
@@ -16,224 +28,421 @@ namespace helios::gfx
 			.pipelineName = L"Mip Map Generation Pipeline"
 		};
 
-		mMipMapPipelineState = std::make_unique<gfx::PipelineState>(device->GetDevice(), pipelineCreationDesc);	
+		mMipMapPipelineState = std::make_unique<gfx::PipelineState>(device->GetDevice(), pipelineCreationDesc);
 
-		// Create mip map buffer.
-		gfx::BufferCreationDesc mipMapBufferCreationDesc
+		ComputePipelineStateCreationDesc singlePassDownsamplePipelineCreationDesc
 		{
-			.usage = gfx::BufferUsage::ConstantBuffer,
-			.name = L"Mip Map Buffer",
+			.csShaderPath = L"Shaders/MipMapGeneration/SinglePassDownsampleCS.cso",
+			.pipelineName = L"Single Pass Downsample Pipeline"
 		};
 
-		mMipMapBuffer = std::make_unique<gfx::Buffer>(mDevice.CreateBuffer<MipMapGenerationBuffer>(mipMapBufferCreationDesc, std::span<MipMapGenerationBuffer, 0u>{}));
+		mSinglePassDownsamplePipelineState = std::make_unique<gfx::PipelineState>(device->GetDevice(), singlePassDownsamplePipelineCreationDesc);
+
+		// The counters start (and are left by each dispatch) at 0.
+		const std::vector<uint32_t> counters(SINGLE_PASS_DOWNSAMPLE_COUNTER_COUNT, 0u);
 
+		mSinglePassDownsampleCounterBuffer = device->CreateBuffer<uint32_t>(BufferCreationDesc
+		{
+			.usage = BufferUsage::UAVBuffer,
+			.name = L"Single Pass Downsample Counter Buffer"
+		}, counters);
 	}
 
 	void MipMapGenerator::GenerateMips(gfx::Texture* texture)
 	{
-		D3D12_RESOURCE_DESC sourceResourceDesc = texture->GetResource()->GetDesc();
-		if (sourceResourceDesc.MipLevels <= 1)
-		{
-			return;
-		}
+		MipMapGenerationBatch mipMapGenerationBatch{};
+		mipMapGenerationBatch.AddTexture(texture->GetResource());
 
+		GenerateMips(mipMapGenerationBatch);
+	}
 
-		SrvCreationDesc srvCreationDesc
+	void MipMapGenerator::GenerateMips(MipMapGenerationBatch& mipMapGenerationBatch)
+	{
+		struct BatchTexture
 		{
-			.srvDesc
-			{
-				.Format = sourceResourceDesc.Format,
-				.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
-				.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-				.Texture2D
-				{
-					.MipLevels = sourceResourceDesc.MipLevels
-				}
-			}
+			Microsoft::WRL::ComPtr<ID3D12Resource> resource{};
+			D3D12_RESOURCE_DESC resourceDesc{};
+			uint32_t sourceMipSrvIndex{};
+			uint32_t sourceMipLevel{};
 		};
 
-		uint32_t sourceMipSrvIndex = mDevice.CreateSrv(srvCreationDesc, texture->GetResource());
-
-
-		// Main reference : https://www.3dgep.com/learning-directx-12-4/#CommandListGenerateMips_UAV.
-		for (uint32_t srcMipLevel = 0; srcMipLevel < sourceResourceDesc.MipLevels - 1u;)
+		std::vector<BatchTexture> textures{};
+		std::vector<BatchTexture> singlePassTextures{};
+		for (Microsoft::WRL::ComPtr<ID3D12Resource>& resource : mipMapGenerationBatch.TakeTextures())
 		{
-			uint64_t sourceWidth = sourceResourceDesc.Width >> srcMipLevel;
-			uint64_t sourceHeight = sourceResourceDesc.Height >> srcMipLevel;
-
-			uint32_t destinationWidth = std::max<uint32_t>((uint32_t)sourceWidth >> 1u, 1u);
-			uint32_t destinationHeight = std::max<uint32_t>((uint32_t)sourceHeight >> 1u, 1u);
-
-			TextureDimensionType dimensionType{};
-			if (sourceHeight % 2 == 0 && sourceWidth % 2 == 0)
+			const D3D12_RESOURCE_DESC resourceDesc = resource->GetDesc();
+			if (resourceDesc.MipLevels <= 1)
 			{
-				dimensionType = TextureDimensionType::HeightWidthEven;
+				continue;
 			}
-			else if (sourceHeight % 2 != 0 && sourceWidth % 2 == 0)
+
+			if (IsSinglePassDownsampleEligible(resourceDesc))
 			{
-				dimensionType = TextureDimensionType::HeightOddWidthEven;
+				singlePassTextures.push_back(BatchTexture
+				{
+					.resource = std::move(resource),
+					.resourceDesc = resourceDesc,
+				});
+
+				continue;
 			}
-			else if (sourceHeight % 2 == 0 && sourceWidth % 2 != 0)
+
+			SrvCreationDesc srvCreationDesc
 			{
-				dimensionType = TextureDimensionType::HeightEvenWidthOdd;
-			}
-			else
+				.srvDesc
+				{
+					.Format = resourceDesc.Format,
+					.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
+					.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+					.Texture2D
+					{
+						.MipLevels = resourceDesc.MipLevels
+					}
+				}
+			};
+
+			const uint32_t sourceMipSrvIndex = mDevice.CreateSrv(srvCreationDesc, resource.Get());
+
+			textures.push_back(BatchTexture
 			{
-				dimensionType = TextureDimensionType::HeightWidthOdd;
-			}
+				.resource = std::move(resource),
+				.resourceDesc = resourceDesc,
+				.sourceMipSrvIndex = sourceMipSrvIndex,
+			});
+		}
+
+		if (textures.empty() && singlePassTextures.empty())
+		{
+			return;
+		}
 
-			// At a single compute shader dispatch, we can generate atmost 4 mip maps.
-			// The code below checks for in this loop iteration, how many levels can we compute, so as to have subsequent mip level dimension
-			// be exactly half : exactly 50 % decrease in mip dimension.
-			// i.e number of times mip can be halved until we reach a mip level where one dimension is odd.
-			// If dimension is odd, texture needs to be sampled multiple times, which will be handled in a new dispatch.
-			DWORD mipCount{};
-			// Value of temp not required.
-			_BitScanForward64(&mipCount, (destinationWidth == 1u ? destinationHeight : destinationWidth) | (destinationHeight == 1u ? destinationWidth : destinationHeight));
-			mipCount = std::min<uint32_t>(4, mipCount + 1);
-			mipCount = (srcMipLevel + mipCount) >= sourceResourceDesc.MipLevels ? sourceResourceDesc.MipLevels - srcMipLevel - 1u : mipCount;
-
-			// NOTE : UAV's have a limited set of formats they can use.
-			// Refer : https://docs.microsoft.com/en-us/windows/win32/direct3d12/typed-unordered-access-view-loads.
-			std::array<uint32_t, 4u> mipUavs{};
-			for (uint32_t uav : std::views::iota(0u, static_cast<uint32_t>(mipCount)))
+		std::unique_ptr<ComputeContext> computeContext = mDevice.GetComputeContext();
+
+		// Note : Textures are created in the common state, and are expected to be in it again once their mips are generated.
+		for (const BatchTexture& texture : textures)
+		{
+			computeContext->TransitionResource(texture.resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+		}
+		for (const BatchTexture& texture : singlePassTextures)
+		{
+			computeContext->TransitionResource(texture.resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+		}
+		computeContext->ExecuteResourceBarriers();
+
+		uint64_t dispatchCount{};
+
+		for (const BatchTexture& texture : singlePassTextures)
+		{
+			std::array<uint32_t, SPD_MAX_MIP_COUNT + 1u> mipUavs{};
+			const uint32_t mipCount = GetDownsampleMipCount(texture.resourceDesc.MipLevels);
+
+			for (uint32_t mipLevel : std::views::iota(0u, mipCount + 1u))
 			{
 				UavCreationDesc uavCreationDesc
 				{
 					.uavDesc
 					{
-						.Format = gfx::Texture::GetNonSRGBFormat(sourceResourceDesc.Format),
+						.Format = gfx::Texture::GetNonSRGBFormat(texture.resourceDesc.Format),
 						.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D,
 						.Texture2D
 						{
-							.MipSlice = uav + 1 + srcMipLevel,
+							.MipSlice = mipLevel,
 							.PlaneSlice = 0u
 						}
 					}
 				};
 
-				//  Reading from a SRV/UAV mapped to a null resource will return black and writing to a UAV mapped to a null resource will have no effect (from 3DGEP).
-				mipUavs[uav] = mDevice.CreateUav(uavCreationDesc, texture->GetResource());
+				mipUavs[mipLevel] = mDevice.CreateUav(uavCreationDesc, texture.resource.Get());
 			}
 
-			MipMapGenerationBuffer mipMapGenerationBufferData
-			{
-				.isSRGB = gfx::Texture::IsTextureSRGB(sourceResourceDesc.Format),
-				.sourceMipLevel = srcMipLevel,
-				.texelSize = {1.0f / destinationWidth, 1.0f / destinationHeight},
-				.numberMipLevels = static_cast<uint32_t>(mipCount),
-				.dimensionType = dimensionType,
-			};
+			RecordSinglePassDownsample(computeContext.get(), texture.resourceDesc, std::span(mipUavs.data(), mipCount + 1u), DownsampleReduction::Average);
+			dispatchCount++;
+		}
 
-			mMipMapBuffer->Update(&mipMapGenerationBufferData);
+		computeContext->SetComputePipelineState(mMipMapPipelineState.get());
+
+		// Main reference : https://www.3dgep.com/learning-directx-12-4/#CommandListGenerateMips_UAV.
+		bool hasDispatched = true;
+		while (hasDispatched)
+		{
+			hasDispatched = false;
 
-			MipMapGenerationRenderResources renderResources
+			for (BatchTexture& texture : textures)
 			{
-				.sourceMipIndex = sourceMipSrvIndex,
-				.outputMip1Index = mipUavs[0],
-				.outputMip2Index = mipUavs[1],
-				.outputMip3Index = mipUavs[2],
-				.outputMip4Index = mipUavs[3],
-				.mipMapGenerationBufferIndex = Buffer::GetCbvIndex(mMipMapBuffer.get()),
-			};
+				if (texture.sourceMipLevel >= texture.resourceDesc.MipLevels - 1u)
+				{
+					continue;
+				}
+
+				MipMapGenerationDispatch dispatch = GetDispatch(texture.resourceDesc, texture.sourceMipLevel);
 
-			std::unique_ptr<ComputeContext> computeContext = mDevice.GetComputeContext();
+				// NOTE : UAV's have a limited set of formats they can use.
+				// Refer : https://docs.microsoft.com/en-us/windows/win32/direct3d12/typed-unordered-access-view-loads.
+				std::array<uint32_t, 4u> mipUavs{};
+				for (uint32_t uav : std::views::iota(0u, dispatch.renderResources.numberMipLevels))
+				{
+					UavCreationDesc uavCreationDesc
+					{
+						.uavDesc
+						{
+							.Format = gfx::Texture::GetNonSRGBFormat(texture.resourceDesc.Format),
+							.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D,
+							.Texture2D
+							{
+								.MipSlice = uav + 1 + texture.sourceMipLevel,
+								.PlaneSlice = 0u
+							}
+						}
+					};
 
-			computeContext->SetComputePipelineState(mMipMapPipelineState.get());
-			computeContext->Set32BitComputeConstants(&renderResources);
+					//  Reading from a SRV/UAV mapped to a null resource will return black and writing to a UAV mapped to a null resource will have no effect (from 3DGEP).
+					mipUavs[uav] = mDevice.CreateUav(uavCreationDesc, texture.resource.Get());
+				}
 
-			computeContext->Dispatch(std::max((uint32_t)std::ceil(destinationWidth / 8.0f), 1u), std::max((uint32_t)std::ceil(destinationHeight / 8.0f), 1u), 1);
+				dispatch.renderResources.sourceMipIndex = texture.sourceMipSrvIndex;
+				dispatch.renderResources.outputMip1Index = mipUavs[0];
+				dispatch.renderResources.outputMip2Index = mipUavs[1];
+				dispatch.renderResources.outputMip3Index = mipUavs[2];
+				dispatch.renderResources.outputMip4Index = mipUavs[3];
 
-			mDevice.GetComputeCommandQueue()->ExecuteAndFlush(computeContext->GetCommandList());
+				computeContext->Set32BitComputeConstants(&dispatch.renderResources);
+				computeContext->Dispatch(dispatch.threadGroupCountX, dispatch.threadGroupCountY, 1u);
 
-			srcMipLevel += static_cast<uint32_t>(mipCount);
+				texture.sourceMipLevel += dispatch.renderResources.numberMipLevels;
+
+				// The next dispatch of this texture reads the last mip written by this one.
+				if (texture.sourceMipLevel < texture.resourceDesc.MipLevels - 1u)
+				{
+					computeContext->AddUavBarrier(texture.resource.Get());
+				}
+
+				dispatchCount++;
+				hasDispatched = true;
+			}
+
+			computeContext->ExecuteResourceBarriers();
+		}
+
+		for (const BatchTexture& texture : textures)
+		{
+			computeContext->TransitionResource(texture.resource.Get(), D3D12_RESOURCE_STATE_COMMON);
 		}
+		for (const BatchTexture& texture : singlePassTextures)
+		{
+			computeContext->TransitionResource(texture.resource.Get(), D3D12_RESOURCE_STATE_COMMON);
+		}
+		computeContext->ExecuteResourceBarriers();
+
+		ExecuteAndWait(std::move(computeContext), textures.size() + singlePassTextures.size(), dispatchCount);
 	}
 
 	void MipMapGenerator::GenerateMips(gfx::Texture* texture, std::uint32_t srvIndex, std::span<uint32_t> uavIndices)
 	{
-
 		D3D12_RESOURCE_DESC sourceResourceDesc = texture->GetResource()->GetDesc();
 		if (sourceResourceDesc.MipLevels <= 1)
 		{
 			return;
 		}
 
-		uint32_t sourceMipSrvIndex = srvIndex;
+		std::unique_ptr<ComputeContext> computeContext = mDevice.GetComputeContext();
+		computeContext->SetComputePipelineState(mMipMapPipelineState.get());
+
+		uint64_t dispatchCount{};
 
-		// Main reference : https://www.3dgep.com/learning-directx-12-4/#CommandListGenerateMips_UAV.
 		for (uint32_t srcMipLevel = 0; srcMipLevel < sourceResourceDesc.MipLevels - 1u;)
 		{
-			uint64_t sourceWidth = sourceResourceDesc.Width >> srcMipLevel;
-			uint64_t sourceHeight = sourceResourceDesc.Height >> srcMipLevel;
+			MipMapGenerationDispatch dispatch = GetDispatch(sourceResourceDesc, srcMipLevel);
 
-			uint32_t destinationWidth = std::max<uint32_t>((uint32_t)sourceWidth >> 1u, 1u);
-			uint32_t destinationHeight = std::max<uint32_t>((uint32_t)sourceHeight >> 1u, 1u);
+			dispatch.renderResources.sourceMipIndex = srvIndex;
+			dispatch.renderResources.outputMip1Index = uavIndices[0];
+			dispatch.renderResources.outputMip2Index = uavIndices[1];
+			dispatch.renderResources.outputMip3Index = uavIndices[2];
+			dispatch.renderResources.outputMip4Index = uavIndices[3];
 
-			TextureDimensionType dimensionType{};
-			if (sourceHeight % 2 == 0 && sourceWidth % 2 == 0)
-			{
-				dimensionType = TextureDimensionType::HeightWidthEven;
-			}
-			else if (sourceHeight % 2 != 0 && sourceWidth % 2 == 0)
-			{
-				dimensionType = TextureDimensionType::HeightOddWidthEven;
-			}
-			else if (sourceHeight % 2 == 0 && sourceWidth % 2 != 0)
+			// The previous dispatch wrote the mip this one reads.
+			if (srcMipLevel > 0u)
 			{
-				dimensionType = TextureDimensionType::HeightEvenWidthOdd;
-			}
-			else
-			{
-				dimensionType = TextureDimensionType::HeightWidthOdd;
+				computeContext->AddUavBarrier(texture->GetResource());
+				computeContext->ExecuteResourceBarriers();
 			}
 
-			// At a single compute shader dispatch, we can generate atmost 4 mip maps.
-			// The code below checks for in this loop iteration, how many levels can we compute, so as to have subsequent mip level dimension
-			// be exactly half : exactly 50 % decrease in mip dimension.
-			// i.e number of times mip can be halved until we reach a mip level where one dimension is odd.
-			// If dimension is odd, texture needs to be sampled multiple times, which will be handled in a new dispatch.
-			DWORD mipCount{};
-			// Value of temp not required.
-			_BitScanForward64(&mipCount, (destinationWidth == 1u ? destinationHeight : destinationWidth) | (destinationHeight == 1u ? destinationWidth : destinationHeight));
-			mipCount = std::min<uint32_t>(4, mipCount + 1);
-			mipCount = (srcMipLevel + mipCount) >= sourceResourceDesc.MipLevels ? sourceResourceDesc.MipLevels - srcMipLevel - 1u : mipCount;
-
-			// NOTE : UAV's have a limited set of formats they can use.
-			// Refer : https://docs.microsoft.com/en-us/windows/win32/direct3d12/typed-unordered-access-view-loads.
-		
-			MipMapGenerationBuffer mipMapGenerationBufferData
-			{
-				.isSRGB = gfx::Texture::IsTextureSRGB(sourceResourceDesc.Format),
-				.sourceMipLevel = srcMipLevel,
-				.texelSize = {1.0f / destinationWidth, 1.0f / destinationHeight},
-				.numberMipLevels = static_cast<uint32_t>(mipCount),
-				.dimensionType = dimensionType,
-			};
+			computeContext->Set32BitComputeConstants(&dispatch.renderResources);
+			computeContext->Dispatch(dispatch.threadGroupCountX, dispatch.threadGroupCountY, 1u);
+
+			srcMipLevel += dispatch.renderResources.numberMipLevels;
+			dispatchCount++;
+		}
+
+		ExecuteAndWait(std::move(computeContext), 1u, dispatchCount);
+	}
+
+	void MipMapGenerator::RecordSinglePassDownsample(ComputeContext* computeContext, const D3D12_RESOURCE_DESC& resourceDesc, std::span<const uint32_t> mipUavIndices, DownsampleReduction downsampleReduction)
+	{
+		const SinglePassDownsampleDispatch dispatch = PrepareSinglePassDownsample(computeContext, resourceDesc, mipUavIndices, downsampleReduction);
+
+		computeContext->SetComputePipelineState(mSinglePassDownsamplePipelineState.get());
+		computeContext->Set32BitComputeConstants(&dispatch.renderResources);
+		computeContext->Dispatch(dispatch.threadGroupCountX, dispatch.threadGroupCountY, 1u);
+	}
+
+	void MipMapGenerator::RecordSinglePassDownsample(GraphicsContext* graphicsContext, const D3D12_RESOURCE_DESC& resourceDesc, std::span<const uint32_t> mipUavIndices, DownsampleReduction downsampleReduction)
+	{
+		const SinglePassDownsampleDispatch dispatch = PrepareSinglePassDownsample(graphicsContext, resourceDesc, mipUavIndices, downsampleReduction);
 
-			mMipMapBuffer->Update(&mipMapGenerationBufferData);
+		graphicsContext->SetComputePipelineState(mSinglePassDownsamplePipelineState.get());
+		graphicsContext->Set32BitComputeConstants(&dispatch.renderResources);
+		graphicsContext->Dispatch(dispatch.threadGroupCountX, dispatch.threadGroupCountY, 1u);
+	}
+
+	MipMapGenerator::SinglePassDownsampleDispatch MipMapGenerator::PrepareSinglePassDownsample(Context* context, const D3D12_RESOURCE_DESC& resourceDesc, std::span<const uint32_t> mipUavIndices,
+		DownsampleReduction downsampleReduction)
+	{
+		const uint32_t width = static_cast<uint32_t>(resourceDesc.Width);
+		const uint32_t height = resourceDesc.Height;
+		const uint32_t mipCount = static_cast<uint32_t>(mipUavIndices.size()) - 1u;
 
-			MipMapGenerationRenderResources renderResources
+		if (mipUavIndices.size() < 2u || mipCount > SPD_MAX_MIP_COUNT || width > SPD_MAX_DIMENSION || height > SPD_MAX_DIMENSION)
+		{
+			ErrorMessage(L"Texture is not supported by the single pass downsampler.");
+		}
+
+		std::array<uint32_t, SPD_MAX_MIP_COUNT + 1u> mipIndices{};
+		std::ranges::copy(mipUavIndices, mipIndices.begin());
+
+		// A counter is reused once all counters have been used : the barrier makes sure the previous dispatch using it (which resets it) has completed.
+		const uint32_t counterIndex = mSinglePassDownsampleCounterIndex.fetch_add(1u) % SINGLE_PASS_DOWNSAMPLE_COUNTER_COUNT;
+		if (counterIndex == 0u)
+		{
+			context->AddUavBarrier(mSinglePassDownsampleCounterBuffer.allocation->resource.Get());
+			context->ExecuteResourceBarriers();
+		}
+
+		context->TrackResidency(&mSinglePassDownsampleCounterBuffer);
+
+		const std::array<uint32_t, 2u> threadGroupCount = GetDownsampleThreadGroupCount(width, height);
+
+		{
+			std::lock_guard<std::mutex> statisticsLockGuard(mStatisticsMutex);
+			mStatistics.singlePassDispatchCount++;
+		}
+
+		return SinglePassDownsampleDispatch
+		{
+			.renderResources
 			{
-				.sourceMipIndex = sourceMipSrvIndex,
-				.outputMip1Index = uavIndices[0],
-				.outputMip2Index = uavIndices[1],
-				.outputMip3Index = uavIndices[2],
-				.outputMip4Index = uavIndices[3],
-				.mipMapGenerationBufferIndex = Buffer::GetCbvIndex(mMipMapBuffer.get()),
-			};
+				.mip0Index = mipIndices[0],
+				.mip1Index = mipIndices[1],
+				.mip2Index = mipIndices[2],
+				.mip3Index = mipIndices[3],
+				.mip4Index = mipIndices[4],
+				.mip5Index = mipIndices[5],
+				.mip6Index = mipIndices[6],
+				.mip7Index = mipIndices[7],
+				.mip8Index = mipIndices[8],
+				.mip9Index = mipIndices[9],
+				.mip10Index = mipIndices[10],
+				.mip11Index = mipIndices[11],
+				.mip12Index = mipIndices[12],
+				.counterBufferIndex = gfx::Buffer::GetUavIndex(&mSinglePassDownsampleCounterBuffer),
+				.counterIndex = counterIndex,
+				.width = width,
+				.height = height,
+				.mipCount = mipCount,
+				.reduction = static_cast<uint32_t>(downsampleReduction),
+				.isSRGB = gfx::Texture::IsTextureSRGB(resourceDesc.Format),
+			},
+			.threadGroupCountX = threadGroupCount[0],
+			.threadGroupCountY = threadGroupCount[1],
+		};
+	}
 
-			std::unique_ptr<ComputeContext> computeContext = mDevice.GetComputeContext();
+	MipMapGenerationStatistics MipMapGenerator::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> statisticsLockGuard(mStatisticsMutex);
+		return mStatistics;
+	}
 
-			computeContext->SetComputePipelineState(mMipMapPipelineState.get());
-			computeContext->Set32BitComputeConstants(&renderResources);
+	MipMapGenerator::MipMapGenerationDispatch MipMapGenerator::GetDispatch(const D3D12_RESOURCE_DESC& resourceDesc, uint32_t sourceMipLevel)
+	{
+		uint64_t sourceWidth = resourceDesc.Width >> sourceMipLevel;
+		uint64_t sourceHeight = resourceDesc.Height >> sourceMipLevel;
 
-			computeContext->Dispatch(std::max((uint32_t)std::ceil(destinationWidth / 8.0f), 1u), std::max((uint32_t)std::ceil(destinationHeight / 8.0f), 1u), 1);
+		uint32_t destinationWidth = std::max<uint32_t>((uint32_t)sourceWidth >> 1u, 1u);
+		uint32_t destinationHeight = std::max<uint32_t>((uint32_t)sourceHeight >> 1u, 1u);
 
-			mDevice.GetComputeCommandQueue()->ExecuteAndFlush(computeContext->GetCommandList());
+		TextureDimensionType dimensionType{};
+		if (sourceHeight % 2 == 0 && sourceWidth % 2 == 0)
+		{
+			dimensionType = TextureDimensionType::HeightWidthEven;
+		}
+		else if (sourceHeight % 2 != 0 && sourceWidth % 2 == 0)
+		{
+			dimensionType = TextureDimensionType::HeightOddWidthEven;
+		}
+		else if (sourceHeight % 2 == 0 && sourceWidth % 2 != 0)
+		{
+			dimensionType = TextureDimensionType::HeightEvenWidthOdd;
+		}
+		else
+		{
+			dimensionType = TextureDimensionType::HeightWidthOdd;
+		}
+
+		// At a single compute shader dispatch, we can generate atmost 4 mip maps (see GetMipMapGenerationDispatchMipCount).
+		const uint32_t mipCount = GetMipMapGenerationDispatchMipCount(MipMapGenerationTexture
+		{
+			.width = static_cast<uint32_t>(resourceDesc.Width),
+			.height = resourceDesc.Height,
+			.mipLevels = resourceDesc.MipLevels,
+		}, sourceMipLevel);
 
-			srcMipLevel += static_cast<uint32_t>(mipCount);
+		return MipMapGenerationDispatch
+		{
+			.renderResources
+			{
+				.isSRGB = gfx::Texture::IsTextureSRGB(resourceDesc.Format),
+				.sourceMipLevel = sourceMipLevel,
+				.numberMipLevels = mipCount,
+				.dimensionType = static_cast<uint32_t>(dimensionType),
+				.texelSizeX = 1.0f / destinationWidth,
+				.texelSizeY = 1.0f / destinationHeight,
+			},
+			.threadGroupCountX = std::max((uint32_t)std::ceil(destinationWidth / 8.0f), 1u),
+			.threadGroupCountY = std::max((uint32_t)std::ceil(destinationHeight / 8.0f), 1u),
+		};
+	}
+
+	bool MipMapGenerator::IsSinglePassDownsampleEligible(const D3D12_RESOURCE_DESC& resourceDesc) const
+	{
+		if (resourceDesc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || resourceDesc.DepthOrArraySize != 1u ||
+			!IsSinglePassDownsampleSupported(static_cast<uint32_t>(resourceDesc.Width), resourceDesc.Height, resourceDesc.MipLevels))
+		{
+			return false;
+		}
+
+		D3D12_FEATURE_DATA_FORMAT_SUPPORT formatSupport
+		{
+			.Format = gfx::Texture::GetNonSRGBFormat(resourceDesc.Format)
+		};
+
+		if (FAILED(mDevice.GetDevice()->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &formatSupport, sizeof(formatSupport))))
+		{
+			return false;
 		}
+
+		return (formatSupport.Support2 & D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD) && (formatSupport.Support2 & D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE);
+	}
+
+	void MipMapGenerator::ExecuteAndWait(std::unique_ptr<ComputeContext> computeContext, uint64_t textureCount, uint64_t dispatchCount)
+	{
+		const QueueSubmission submission = mDevice.ExecuteContext(std::move(computeContext));
+		mDevice.GetComputeCommandQueue()->WaitForFenceValue(submission.fenceValue);
+
+		std::lock_guard<std::mutex> statisticsLockGuard(mStatisticsMutex);
+
+		mStatistics.textureCount += textureCount;
+		mStatistics.dispatchCount += dispatchCount;
+		mStatistics.submissionCount++;
 	}
 }
 
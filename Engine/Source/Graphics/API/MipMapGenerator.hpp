@@ -1,10 +1,42 @@
 #pragma once
 
 #include "ComputeContext.hpp"
+#include "GraphicsContext.hpp"
+#include "MipMapGenerationPlan.hpp"
 #include "PipelineState.hpp"
 #include "Resources.hpp"
+#include "SinglePassDownsampler.hpp"
+
 namespace helios::gfx
 {
+	// Textures whose mips are generated together, by a single submission (see MipMapGenerator::GenerateMips(MipMapGenerationBatch&)).
+	// Textures can be added from multiple threads (i.e by the jobs loading the materials of a model).
+	class MipMapGenerationBatch
+	{
+	public:
+		// The resource is kept alive until the batch is submitted.
+		void AddTexture(ID3D12Resource* resource);
+
+		// Returns the textures added so far, leaving the batch empty.
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> TakeTextures();
+
+	private:
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mTextures{};
+		std::mutex mMutex{};
+	};
+
+	struct MipMapGenerationStatistics
+	{
+		uint64_t textureCount{};
+		uint64_t dispatchCount{};
+
+		// Dispatches generating the entire mip chain of a texture (see SinglePassDownsampleCS.hlsl).
+		uint64_t singlePassDispatchCount{};
+
+		// Compute queue submissions the CPU waited for : one per batch (rather than one per dispatch).
+		uint64_t submissionCount{};
+	};
+
 	// The device abstraction will have an object of this type.
 	// Handles generation of mip maps for a given texture.
 	class MipMapGenerator
@@ -12,18 +44,72 @@ namespace helios::gfx
 	public:
 		MipMapGenerator(gfx::Device* device);
 
+		// Same as generating the mips of a batch with a single texture.
 		void GenerateMips(gfx::Texture* texture);
 
-		// Use this overload if UAV, SRV's and the mip map buffer are already created.
+		// The dispatches of all textures in the batch are recorded into a single compute context, which is executed (and waited for) once.
+		// Textures supported by the single pass downsampler (see IsSinglePassDownsampleSupported) have their entire mip chain generated by one dispatch.
+		// The dispatches of the other textures are interleaved : each round dispatches the next (up to 4) mips of every texture, followed by
+		// the UAV barriers the next round depends on.
+		void GenerateMips(MipMapGenerationBatch& mipMapGenerationBatch);
+
+		// Use this overload if UAV and SRV's are already created.
 		// Useful for cases where mips are created for the same texture over and over again (such as in the Bloom render pass).
 		void GenerateMips(gfx::Texture* texture, std::uint32_t srvIndex, std::span<uint32_t> uavIndices);
 
+		// Records a single pass downsample of mip 0 into mips [1, mipUavIndices.size() - 1] (the UAV indices of mip 0 onwards). The texture must be in the unordered access state.
+		// Also used for depth pyramids (with the Min / Max reductions). The dispatch is recorded into the given context, so the caller decides when it is executed.
+		void RecordSinglePassDownsample(ComputeContext* computeContext, const D3D12_RESOURCE_DESC& resourceDesc, std::span<const uint32_t> mipUavIndices, DownsampleReduction downsampleReduction);
+
+		// Same as above, for textures written and read by the graphics queue within a frame (i.e the depth pyramid of the HiZCullingPass, built between draws).
+		void RecordSinglePassDownsample(GraphicsContext* graphicsContext, const D3D12_RESOURCE_DESC& resourceDesc, std::span<const uint32_t> mipUavIndices, DownsampleReduction downsampleReduction);
+
+		// The shader reads mip 0 through a (non sRGB) UAV, so the format must support typed UAV loads.
+		bool IsSinglePassDownsampleEligible(const D3D12_RESOURCE_DESC& resourceDesc) const;
+
+		MipMapGenerationStatistics GetStatistics() const;
+
+	private:
+		// Per dispatch constants (except the descriptor indices) of the dispatch generating the mips following sourceMipLevel.
+		struct MipMapGenerationDispatch
+		{
+			MipMapGenerationRenderResources renderResources{};
+			uint32_t threadGroupCountX{};
+			uint32_t threadGroupCountY{};
+		};
+
+		static MipMapGenerationDispatch GetDispatch(const D3D12_RESOURCE_DESC& resourceDesc, uint32_t sourceMipLevel);
+
+		struct SinglePassDownsampleDispatch
+		{
+			SinglePassDownsampleRenderResources renderResources{};
+			uint32_t threadGroupCountX{};
+			uint32_t threadGroupCountY{};
+		};
+
+		// Shared by the RecordSinglePassDownsample overloads : picks the counter of the dispatch (recording the barrier its reuse requires into the context).
+		SinglePassDownsampleDispatch PrepareSinglePassDownsample(Context* context, const D3D12_RESOURCE_DESC& resourceDesc, std::span<const uint32_t> mipUavIndices,
+			DownsampleReduction downsampleReduction);
+
+		// Executes the compute context and waits for it to complete, so the textures can be used by any queue afterwards.
+		void ExecuteAndWait(std::unique_ptr<ComputeContext> computeContext, uint64_t textureCount, uint64_t dispatchCount);
+
 	private:
 		std::unique_ptr<gfx::PipelineState> mMipMapPipelineState{};
-		std::unique_ptr<gfx::Buffer> mMipMapBuffer{};
+		std::unique_ptr<gfx::PipelineState> mSinglePassDownsamplePipelineState{};
+
+		// Global atomic counters of the single pass downsample dispatches (one per dispatch in flight, used round robin).
+		static constexpr uint32_t SINGLE_PASS_DOWNSAMPLE_COUNTER_COUNT = 256u;
+
+		gfx::Buffer mSinglePassDownsampleCounterBuffer{};
+		std::atomic<uint32_t> mSinglePassDownsampleCounterIndex{};
+
+		MipMapGenerationStatistics mStatistics{};
+		mutable std::mutex mStatisticsMutex{};
 
 		gfx::Device& mDevice;
 	};
 
 }
 
+
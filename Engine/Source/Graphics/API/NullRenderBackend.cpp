@@ -0,0 +1,293 @@
+#include "NullRenderBackend.hpp"
+
+#include <algorithm>
+
+namespace helios::gfx
+{
+	namespace
+	{
+		static constexpr uint32_t OBJECT_TYPE_SHIFT = 56u;
+	}
+
+	CommandHandle NullRenderBackend::CreateObject(BackendObjectType backendObjectType, std::string_view name)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		const CommandHandle handle = (static_cast<uint64_t>(backendObjectType) + 1u) << OBJECT_TYPE_SHIFT | mNextObjectIndex++;
+		mObjects.emplace(handle, ObjectRecord
+		{
+			.backendObjectType = backendObjectType,
+			.name = std::string(name),
+		});
+
+		mStatistics.liveObjectCount = mObjects.size();
+
+		return handle;
+	}
+
+	void NullRenderBackend::ReleaseObject(CommandHandle handle)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		if (mObjects.erase(handle) == 0u)
+		{
+			mStatistics.invalidHandleCount++;
+		}
+
+		mResourceStates.erase(handle);
+
+		mStatistics.liveObjectCount = mObjects.size();
+	}
+
+	uint64_t NullRenderBackend::ExecuteCommandStreams(QueueType queueType, std::span<const CommandStream* const> commandStreams, std::span<const QueueWait> queueWaits)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		for (const QueueWait& queueWait : queueWaits)
+		{
+			if (queueWait.waitingQueue != queueType || queueWait.fenceValue > mFenceValues[static_cast<uint32_t>(queueWait.signallingQueue)])
+			{
+				mStatistics.invalidWaitCount++;
+			}
+		}
+
+		RecordedSubmission recordedSubmission
+		{
+			.queueType = queueType,
+			.fenceValue = ++mFenceValues[static_cast<uint32_t>(queueType)],
+			.commandStreamCount = static_cast<uint32_t>(commandStreams.size()),
+			.queueWaits = std::vector<QueueWait>(queueWaits.begin(), queueWaits.end()),
+		};
+
+		for (const CommandStream* commandStream : commandStreams)
+		{
+			commandStream->ForEachCommand([&](const CommandHeader& header)
+			{
+				ValidateCommand(header);
+				mStatistics.commandCounts[static_cast<uint32_t>(header.type)]++;
+			});
+
+			recordedSubmission.commandCount += commandStream->GetCommandCount();
+
+			mStatistics.invalidBarrierCount += mSplitBarriers.size();
+			mSplitBarriers.clear();
+		}
+
+		mStatistics.submissionCount++;
+		mStatistics.queueWaitCount += queueWaits.size();
+
+		const uint64_t fenceValue = recordedSubmission.fenceValue;
+		mRecordedSubmissions.push_back(std::move(recordedSubmission));
+
+		return fenceValue;
+	}
+
+	uint64_t NullRenderBackend::GetCompletedFenceValue(QueueType queueType) const
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		return mFenceValues[static_cast<uint32_t>(queueType)];
+	}
+
+	NullRenderBackendStatistics NullRenderBackend::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		return mStatistics;
+	}
+
+	std::vector<RecordedSubmission> NullRenderBackend::GetRecordedSubmissions() const
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		return mRecordedSubmissions;
+	}
+
+	void NullRenderBackend::ClearRecordedSubmissions()
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		mRecordedSubmissions.clear();
+	}
+
+	void NullRenderBackend::ValidateHandle(CommandHandle handle, BackendObjectType expectedObjectType, bool isOptional)
+	{
+		if (handle == 0u && isOptional)
+		{
+			return;
+		}
+
+		const auto object = mObjects.find(handle);
+		if (object == mObjects.end() || object->second.backendObjectType != expectedObjectType)
+		{
+			mStatistics.invalidHandleCount++;
+		}
+	}
+
+	void NullRenderBackend::ValidateResourceHandle(CommandHandle handle, bool isOptional)
+	{
+		if (handle == 0u && isOptional)
+		{
+			return;
+		}
+
+		const auto object = mObjects.find(handle);
+		if (object == mObjects.end() || (object->second.backendObjectType != BackendObjectType::Buffer && object->second.backendObjectType != BackendObjectType::Texture))
+		{
+			mStatistics.invalidHandleCount++;
+		}
+	}
+
+	void NullRenderBackend::ValidateCommand(const CommandHeader& header)
+	{
+		switch (header.type)
+		{
+			case CommandType::SetDescriptorHeaps:
+			{
+				const SetDescriptorHeapsCommand& command = CommandStream::GetCommand<SetDescriptorHeapsCommand>(header);
+				for (uint32_t i = 0u; i < command.descriptorHeapCount; ++i)
+				{
+					ValidateHandle(command.descriptorHeaps[i], BackendObjectType::DescriptorHeap);
+				}
+			}break;
+
+			case CommandType::SetRootSignature:
+			{
+				ValidateHandle(CommandStream::GetCommand<SetRootSignatureCommand>(header).rootSignature, BackendObjectType::RootSignature);
+			}break;
+
+			case CommandType::SetPipelineState:
+			{
+				ValidateHandle(CommandStream::GetCommand<SetPipelineStateCommand>(header).pipelineState, BackendObjectType::PipelineState);
+			}break;
+
+			case CommandType::SetIndexBuffer:
+			{
+				ValidateHandle(CommandStream::GetCommand<SetIndexBufferCommand>(header).bufferLocation, BackendObjectType::Buffer);
+			}break;
+
+			case CommandType::SetRenderTargets:
+			{
+				const SetRenderTargetsCommand& command = CommandStream::GetCommand<SetRenderTargetsCommand>(header);
+				for (uint32_t i = 0u; i < command.renderTargetCount; ++i)
+				{
+					ValidateHandle(command.renderTargets[i], BackendObjectType::RenderTargetView);
+				}
+
+				ValidateHandle(command.depthStencil, BackendObjectType::DepthStencilView, true);
+			}break;
+
+			case CommandType::ClearRenderTarget:
+			{
+				ValidateHandle(CommandStream::GetCommand<ClearRenderTargetCommand>(header).renderTarget, BackendObjectType::RenderTargetView);
+			}break;
+
+			case CommandType::ClearDepthStencil:
+			{
+				ValidateHandle(CommandStream::GetCommand<ClearDepthStencilCommand>(header).depthStencil, BackendObjectType::DepthStencilView);
+			}break;
+
+			case CommandType::ResourceBarrier:
+			{
+				const ResourceBarrierCommand& command = CommandStream::GetCommand<ResourceBarrierCommand>(header);
+
+				// Aliasing and UAV barriers allow null resources (any resource placed in the same memory / any unordered access).
+				const bool isResourceOptional = command.barrierType != BarrierType::Transition;
+				ValidateResourceHandle(command.resource, isResourceOptional);
+				ValidateResourceHandle(command.resourceAfter, true);
+
+				if (command.barrierType == BarrierType::Transition)
+				{
+					ValidateTransition(command);
+				}
+			}break;
+
+			case CommandType::ExecuteIndirect:
+			{
+				const ExecuteIndirectCommand& command = CommandStream::GetCommand<ExecuteIndirectCommand>(header);
+				ValidateHandle(command.commandSignature, BackendObjectType::CommandSignature);
+				ValidateHandle(command.argumentBuffer, BackendObjectType::Buffer);
+				ValidateHandle(command.countBuffer, BackendObjectType::Buffer, true);
+			}break;
+
+			case CommandType::CopyResource:
+			{
+				const CopyResourceCommand& command = CommandStream::GetCommand<CopyResourceCommand>(header);
+				ValidateResourceHandle(command.destination);
+				ValidateResourceHandle(command.source);
+			}break;
+
+			default:
+			{
+			}break;
+		}
+	}
+
+	void NullRenderBackend::ValidateTransition(const ResourceBarrierCommand& command)
+	{
+		const auto isSameSubresource = [&](const ResourceBarrierCommand& splitBarrier)
+		{
+			return splitBarrier.resource == command.resource && (splitBarrier.subresource == command.subresource || splitBarrier.subresource == ALL_SUBRESOURCES || command.subresource == ALL_SUBRESOURCES);
+		};
+
+		auto splitBarrier = std::find_if(mSplitBarriers.begin(), mSplitBarriers.end(), isSameSubresource);
+
+		if (command.split == BarrierSplit::End)
+		{
+			const bool isMatchingBegin = splitBarrier != mSplitBarriers.end() && splitBarrier->subresource == command.subresource &&
+				splitBarrier->stateBefore == command.stateBefore && splitBarrier->stateAfter == command.stateAfter;
+
+			if (!isMatchingBegin)
+			{
+				mStatistics.invalidBarrierCount++;
+				return;
+			}
+
+			mSplitBarriers.erase(splitBarrier);
+		}
+		else if (splitBarrier != mSplitBarriers.end())
+		{
+			mStatistics.invalidBarrierCount++;
+			return;
+		}
+
+		ResourceState& resourceState = mResourceStates[command.resource];
+
+		if (command.subresource == ALL_SUBRESOURCES)
+		{
+			bool isStateValid = resourceState.state == UNKNOWN_RESOURCE_STATE || resourceState.state == command.stateBefore;
+			if (!resourceState.subresourceStates.empty())
+			{
+				isStateValid = std::all_of(resourceState.subresourceStates.begin(), resourceState.subresourceStates.end(), [&](const auto& subresourceState) { return subresourceState.second == command.stateBefore; });
+			}
+
+			if (!isStateValid)
+			{
+				mStatistics.invalidBarrierCount++;
+			}
+
+			if (command.split == BarrierSplit::Begin)
+			{
+				mSplitBarriers.push_back(command);
+				return;
+			}
+
+			resourceState.state = command.stateAfter;
+			resourceState.subresourceStates.clear();
+		}
+		else
+		{
+			auto subresourceState = resourceState.subresourceStates.find(command.subresource);
+			const uint32_t state = subresourceState != resourceState.subresourceStates.end() ? subresourceState->second : resourceState.state;
+
+			if (state != UNKNOWN_RESOURCE_STATE && state != command.stateBefore)
+			{
+				mStatistics.invalidBarrierCount++;
+			}
+
+			if (command.split == BarrierSplit::Begin)
+			{
+				mSplitBarriers.push_back(command);
+				return;
+			}
+
+			resourceState.subresourceStates[command.subresource] = command.stateAfter;
+		}
+	}
+}
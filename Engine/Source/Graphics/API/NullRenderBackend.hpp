@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "RenderBackend.hpp"
+#include "ResourceStateTracker.hpp"
+
+namespace helios::gfx
+{
+	struct NullRenderBackendStatistics
+	{
+		uint64_t liveObjectCount{};
+		uint64_t submissionCount{};
+		uint64_t queueWaitCount{};
+
+		// Indexed by the command type.
+		std::array<uint64_t, COMMAND_TYPE_COUNT> commandCounts{};
+
+		// Commands referring to handles that are null (where not allowed), released, or of the wrong object type.
+		uint64_t invalidHandleCount{};
+
+		// Waits on fence values the signalling queue has not been submitted with yet (which would hang the waiting queue on a GPU).
+		uint64_t invalidWaitCount{};
+
+		// Transitions whose state before is not the state the executed barriers left the (sub)resource in, split transitions that are not ended in the
+		// same command stream (or ended with different states), and transitions of (sub)resources whose split transition is in flight.
+		uint64_t invalidBarrierCount{};
+	};
+
+	// Executions of command streams, as recorded by the NullRenderBackend.
+	struct RecordedSubmission
+	{
+		QueueType queueType{};
+		uint64_t fenceValue{};
+		uint32_t commandStreamCount{};
+		uint32_t commandCount{};
+		std::vector<QueueWait> queueWaits{};
+	};
+
+	// Backend without a GPU : objects are fake (but unique) handles, and executing command streams validates and records them.
+	// Submissions complete immediately, so the CPU side runs as if the GPU was infinitely fast.
+	class NullRenderBackend final : public RenderBackend
+	{
+	public:
+		NullRenderBackend() = default;
+
+		NullRenderBackend(const NullRenderBackend& other) = delete;
+		NullRenderBackend& operator=(const NullRenderBackend& other) = delete;
+
+		// Objects can be created and released from any thread.
+		CommandHandle CreateObject(BackendObjectType backendObjectType, std::string_view name);
+		void ReleaseObject(CommandHandle handle);
+
+		// The translation target of the streams is ignored (there is no command list to translate into).
+		uint64_t ExecuteCommandStreams(QueueType queueType, std::span<const CommandStream* const> commandStreams, std::span<const QueueWait> queueWaits) override;
+
+		uint64_t GetCompletedFenceValue(QueueType queueType) const override;
+		void WaitForFenceValue([[maybe_unused]] QueueType queueType, [[maybe_unused]] uint64_t fenceValue) override {}
+
+		NullRenderBackendStatistics GetStatistics() const;
+
+		// Submissions are recorded until cleared.
+		std::vector<RecordedSubmission> GetRecordedSubmissions() const;
+		void ClearRecordedSubmissions();
+
+	private:
+		struct ObjectRecord
+		{
+			BackendObjectType backendObjectType{};
+			std::string name{};
+		};
+
+		// Counts the handle as invalid if it does not refer to a live object of the expected type. Null handles are valid only if isOptional is set.
+		void ValidateHandle(CommandHandle handle, BackendObjectType expectedObjectType, bool isOptional = false);
+
+		// Resources (buffers / textures) can be used wherever one of the two is expected (i.e in barriers or copies).
+		void ValidateResourceHandle(CommandHandle handle, bool isOptional = false);
+
+		void ValidateCommand(const CommandHeader& header);
+
+		// The state of a resource is the state before of its first transition, until executed barriers change it.
+		void ValidateTransition(const ResourceBarrierCommand& command);
+
+	private:
+		mutable std::mutex mMutex{};
+
+		// Handles are never reused (the object index only grows), and the object type is encoded in their upper bits for debugging.
+		uint64_t mNextObjectIndex{ 1u };
+		std::unordered_map<CommandHandle, ObjectRecord> mObjects{};
+
+		std::array<uint64_t, QUEUE_TYPE_COUNT> mFenceValues{};
+
+		NullRenderBackendStatistics mStatistics{};
+		std::vector<RecordedSubmission> mRecordedSubmissions{};
+
+		// The backend does not know the subresource count of the resources : transitions of all subresources are validated against the subresources
+		// transitioned individually if there are any (else against the state of the resource).
+		struct ResourceState
+		{
+			uint32_t state{ UNKNOWN_RESOURCE_STATE };
+			std::unordered_map<uint32_t, uint32_t> subresourceStates{};
+		};
+
+		std::unordered_map<CommandHandle, ResourceState> mResourceStates{};
+
+		// Begin barriers of the split transitions in flight in the command stream being executed.
+		std::vector<ResourceBarrierCommand> mSplitBarriers{};
+	};
+}
@@ -57,7 +57,7 @@ namespace helios::gfx
 		D3D12_DEPTH_STENCIL_DESC depthStencilDesc
 		{
 			.DepthEnable = pipelineStateCreationDesc.depthFormat == DXGI_FORMAT_UNKNOWN ? FALSE : TRUE,
-			.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
+			.DepthWriteMask = pipelineStateCreationDesc.depthWriteMask,
 			.DepthFunc = pipelineStateCreationDesc.depthComparisonFunc,
 			.StencilEnable = FALSE,
 			.StencilReadMask = D3D12_DEFAULT_STENCIL_READ_MASK,
@@ -92,6 +92,7 @@ namespace helios::gfx
 		}
 
 		psoDesc.RasterizerState.CullMode = pipelineStateCreationDesc.cullMode;
+		psoDesc.RasterizerState.DepthClipEnable = pipelineStateCreationDesc.depthClipEnable;
 
 		// Set RTV formats.
 		for (uint32_t i : std::views::iota(0u, pipelineStateCreationDesc.rtvCount))
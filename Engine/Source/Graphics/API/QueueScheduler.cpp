@@ -0,0 +1,169 @@
+#include "QueueScheduler.hpp"
+
+#include <algorithm>
+
+namespace helios::gfx
+{
+	const char* QueueTypeToString(QueueType queueType)
+	{
+		switch (queueType)
+		{
+			case QueueType::Graphics:
+			{
+				return "Graphics";
+			}break;
+
+			case QueueType::Compute:
+			{
+				return "Compute";
+			}break;
+
+			case QueueType::Copy:
+			{
+				return "Copy";
+			}break;
+		}
+
+		return "Unknown";
+	}
+
+	std::vector<QueueWait> QueueScheduler::ResolveDependencies(QueueType queueType, std::span<const QueueSubmission> dependencies)
+	{
+		FenceValues& knownFenceValues = mKnownFenceValues[static_cast<uint32_t>(queueType)];
+
+		// Largest fence value required from each of the other queues (0 if no wait is required).
+		FenceValues requiredFenceValues{};
+
+		for (const QueueSubmission& dependency : dependencies)
+		{
+			const uint32_t signallingQueueIndex = static_cast<uint32_t>(dependency.queueType);
+
+			if (dependency.fenceValue == 0u || dependency.queueType == queueType)
+			{
+				continue;
+			}
+
+			if (dependency.fenceValue <= std::max(knownFenceValues[signallingQueueIndex], mCompletedFenceValues[signallingQueueIndex]))
+			{
+				mStatistics.skippedWaitCount++;
+				continue;
+			}
+
+			// Multiple dependencies on the same queue are merged into a single wait.
+			if (requiredFenceValues[signallingQueueIndex] != 0u)
+			{
+				mStatistics.skippedWaitCount++;
+			}
+
+			requiredFenceValues[signallingQueueIndex] = std::max(requiredFenceValues[signallingQueueIndex], dependency.fenceValue);
+		}
+
+		std::array<FenceValues, QUEUE_TYPE_COUNT> candidateKnownFenceValues{};
+		for (uint32_t signallingQueueIndex = 0u; signallingQueueIndex < QUEUE_TYPE_COUNT; ++signallingQueueIndex)
+		{
+			if (requiredFenceValues[signallingQueueIndex] != 0u)
+			{
+				candidateKnownFenceValues[signallingQueueIndex] = GetKnownFenceValues(static_cast<QueueType>(signallingQueueIndex), requiredFenceValues[signallingQueueIndex]);
+			}
+		}
+
+		// A wait is redundant if another wait implies it (i.e the other queue had already waited for the fence value before signalling).
+		// Implication is acyclic (a signal cannot both precede and follow another one), so the remaining waits imply all the redundant ones.
+		std::vector<QueueWait> queueWaits{};
+
+		for (uint32_t signallingQueueIndex = 0u; signallingQueueIndex < QUEUE_TYPE_COUNT; ++signallingQueueIndex)
+		{
+			const uint64_t requiredFenceValue = requiredFenceValues[signallingQueueIndex];
+			if (requiredFenceValue == 0u)
+			{
+				continue;
+			}
+
+			bool isImplied{ false };
+			for (uint32_t otherQueueIndex = 0u; otherQueueIndex < QUEUE_TYPE_COUNT; ++otherQueueIndex)
+			{
+				if (otherQueueIndex != signallingQueueIndex && requiredFenceValues[otherQueueIndex] != 0u && candidateKnownFenceValues[otherQueueIndex][signallingQueueIndex] >= requiredFenceValue)
+				{
+					isImplied = true;
+				}
+			}
+
+			if (isImplied)
+			{
+				mStatistics.skippedWaitCount++;
+				continue;
+			}
+
+			queueWaits.push_back(QueueWait
+			{
+				.waitingQueue = queueType,
+				.signallingQueue = static_cast<QueueType>(signallingQueueIndex),
+				.fenceValue = requiredFenceValue,
+			});
+		}
+
+		// The waiting queue now knows everything the signalling queues knew when signalling the awaited fence values.
+		for (uint32_t signallingQueueIndex = 0u; signallingQueueIndex < QUEUE_TYPE_COUNT; ++signallingQueueIndex)
+		{
+			if (requiredFenceValues[signallingQueueIndex] == 0u)
+			{
+				continue;
+			}
+
+			for (uint32_t queueIndex = 0u; queueIndex < QUEUE_TYPE_COUNT; ++queueIndex)
+			{
+				knownFenceValues[queueIndex] = std::max(knownFenceValues[queueIndex], candidateKnownFenceValues[signallingQueueIndex][queueIndex]);
+			}
+		}
+
+		mStatistics.waitCount += queueWaits.size();
+
+		return queueWaits;
+	}
+
+	void QueueScheduler::RecordSignal(QueueType queueType, uint64_t fenceValue)
+	{
+		const uint32_t queueIndex = static_cast<uint32_t>(queueType);
+
+		FenceValues& knownFenceValues = mKnownFenceValues[queueIndex];
+		knownFenceValues[queueIndex] = std::max(knownFenceValues[queueIndex], fenceValue);
+
+		mSignalRecords[queueIndex].push_back(SignalRecord
+		{
+			.fenceValue = fenceValue,
+			.knownFenceValues = knownFenceValues,
+		});
+
+		mStatistics.submissionCount++;
+	}
+
+	void QueueScheduler::SetCompletedFenceValues(const FenceValues& completedFenceValues)
+	{
+		for (uint32_t queueIndex = 0u; queueIndex < QUEUE_TYPE_COUNT; ++queueIndex)
+		{
+			mCompletedFenceValues[queueIndex] = std::max(mCompletedFenceValues[queueIndex], completedFenceValues[queueIndex]);
+
+			// The last completed record is kept, as it is still the one looked up for fence values signalled (outside of the scheduler) after it.
+			std::deque<SignalRecord>& signalRecords = mSignalRecords[queueIndex];
+			while (signalRecords.size() > 1u && signalRecords[1].fenceValue <= mCompletedFenceValues[queueIndex])
+			{
+				signalRecords.pop_front();
+			}
+		}
+	}
+
+	QueueScheduler::FenceValues QueueScheduler::GetKnownFenceValues(QueueType queueType, uint64_t fenceValue) const
+	{
+		const uint32_t queueIndex = static_cast<uint32_t>(queueType);
+		const std::deque<SignalRecord>& signalRecords = mSignalRecords[queueIndex];
+
+		// Queues can signal outside of the scheduler (i.e uploads), in which case the last record before fenceValue is used.
+		// As knowledge only grows over time, it is a lower bound of what is known at fenceValue.
+		auto signalRecord = std::upper_bound(signalRecords.begin(), signalRecords.end(), fenceValue, [](uint64_t value, const SignalRecord& record) { return value < record.fenceValue; });
+
+		FenceValues knownFenceValues = signalRecord == signalRecords.begin() ? FenceValues{} : std::prev(signalRecord)->knownFenceValues;
+		knownFenceValues[queueIndex] = std::max(knownFenceValues[queueIndex], fenceValue);
+
+		return knownFenceValues;
+	}
+}
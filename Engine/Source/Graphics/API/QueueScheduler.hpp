@@ -0,0 +1,91 @@
+#pragma once
+
+// The Device drives it on submission, and performs the actual (GPU side) ID3D12CommandQueue::Wait calls.
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace helios::gfx
+{
+	enum class QueueType : uint32_t
+	{
+		Graphics,
+		Compute,
+		Copy,
+	};
+
+	static constexpr uint32_t QUEUE_TYPE_COUNT = 3u;
+
+	const char* QueueTypeToString(QueueType queueType);
+
+	// Identifies the work of a submission : it is complete once the fence of the queue reaches fenceValue.
+	// A default constructed submission (fence value 0) has no work, and can be used as a dependency that is always satisfied.
+	struct QueueSubmission
+	{
+		QueueType queueType{ QueueType::Graphics };
+		uint64_t fenceValue{};
+	};
+
+	// The waiting queue must not execute its next submission until the fence of the signalling queue reaches fenceValue.
+	struct QueueWait
+	{
+		QueueType waitingQueue{};
+		QueueType signallingQueue{};
+		uint64_t fenceValue{};
+	};
+
+	struct QueueSchedulerStatistics
+	{
+		uint64_t submissionCount{};
+		uint64_t waitCount{};
+
+		// Cross queue dependencies that did not require a wait, as they were already implied by earlier waits (directly or through other queues) or had completed.
+		uint64_t skippedWaitCount{};
+	};
+
+	// Resolves the dependencies of a submission into the minimal set of cross queue waits.
+	// Each queue keeps track of the fence values of the other queues that are known to be reached before its next submission executes (i.e a vector clock).
+	// The knowledge of a queue at each of its signals is recorded, so waiting on a signal also imports everything the signalling queue had waited for before it.
+	// Dependencies on the same queue never require a wait, as the submissions of a queue are executed in order.
+	// Not thread safe : resolving the dependencies and the submission itself must be serialized by the caller, so the recorded signals are in submission order.
+	class QueueScheduler
+	{
+	public:
+		using FenceValues = std::array<uint64_t, QUEUE_TYPE_COUNT>;
+
+		// Returns the waits queueType has to perform before its next submission. The waits are considered performed once returned.
+		// Dependencies must have been submitted already (waiting on a fence value that is never signalled would hang the waiting queue).
+		std::vector<QueueWait> ResolveDependencies(QueueType queueType, std::span<const QueueSubmission> dependencies);
+
+		// To be called once queueType has signalled fenceValue after the submission (the waits returned by ResolveDependencies must be performed before it).
+		void RecordSignal(QueueType queueType, uint64_t fenceValue);
+
+		// Dependencies on completed fence values are skipped, and the signal history older than them is released.
+		void SetCompletedFenceValues(const FenceValues& completedFenceValues);
+
+		QueueSchedulerStatistics GetStatistics() const { return mStatistics; }
+
+	private:
+		struct SignalRecord
+		{
+			uint64_t fenceValue{};
+			FenceValues knownFenceValues{};
+		};
+
+		// Fence values known to be reached when the fence of queueType reaches fenceValue.
+		FenceValues GetKnownFenceValues(QueueType queueType, uint64_t fenceValue) const;
+
+	private:
+		// Indexed by the queue type : the fence values (of each queue) reached before the queue's next submission executes.
+		std::array<FenceValues, QUEUE_TYPE_COUNT> mKnownFenceValues{};
+
+		// Indexed by the queue type, in signal order.
+		std::array<std::deque<SignalRecord>, QUEUE_TYPE_COUNT> mSignalRecords{};
+
+		FenceValues mCompletedFenceValues{};
+
+		QueueSchedulerStatistics mStatistics{};
+	};
+}
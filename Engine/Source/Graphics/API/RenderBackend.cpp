@@ -0,0 +1,52 @@
+#include "RenderBackend.hpp"
+
+namespace helios::gfx
+{
+	const char* BackendObjectTypeToString(BackendObjectType backendObjectType)
+	{
+		switch (backendObjectType)
+		{
+			case BackendObjectType::Buffer:
+			{
+				return "Buffer";
+			}break;
+
+			case BackendObjectType::Texture:
+			{
+				return "Texture";
+			}break;
+
+			case BackendObjectType::RenderTargetView:
+			{
+				return "RenderTargetView";
+			}break;
+
+			case BackendObjectType::DepthStencilView:
+			{
+				return "DepthStencilView";
+			}break;
+
+			case BackendObjectType::DescriptorHeap:
+			{
+				return "DescriptorHeap";
+			}break;
+
+			case BackendObjectType::RootSignature:
+			{
+				return "RootSignature";
+			}break;
+
+			case BackendObjectType::PipelineState:
+			{
+				return "PipelineState";
+			}break;
+
+			case BackendObjectType::CommandSignature:
+			{
+				return "CommandSignature";
+			}break;
+		}
+
+		return "Unknown";
+	}
+}
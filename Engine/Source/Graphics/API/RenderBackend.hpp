@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "CommandStream.hpp"
+#include "QueueScheduler.hpp"
+
+namespace helios::gfx
+{
+	// Objects the command streams refer to through (opaque) command handles (as created by the NullRenderBackend).
+	enum class BackendObjectType : uint32_t
+	{
+		Buffer,
+		Texture,
+		RenderTargetView,
+		DepthStencilView,
+		DescriptorHeap,
+		RootSignature,
+		PipelineState,
+		CommandSignature,
+	};
+
+	static constexpr uint32_t BACKEND_OBJECT_TYPE_COUNT = static_cast<uint32_t>(BackendObjectType::CommandSignature) + 1u;
+
+	const char* BackendObjectTypeToString(BackendObjectType backendObjectType);
+
+	// Thin interface between the (backend neutral) recording of passes and the graphics API : recorded command streams are executed on a queue, after waiting
+	// for the submissions of other queues they depend on (as resolved by the QueueScheduler). The Device submits the contexts through it (see D3D12RenderBackend).
+	// Objects are created by the implementations, as the handles they translate depend on them (pointers to the D3D12 objects, fake handles for the null backend).
+	// Executions are serialized by the caller (as for the QueueScheduler).
+	class RenderBackend
+	{
+	public:
+		virtual ~RenderBackend() = default;
+
+		// Returns the fence value signalled by queueType once the command streams have executed.
+		virtual uint64_t ExecuteCommandStreams(QueueType queueType, std::span<const CommandStream* const> commandStreams, std::span<const QueueWait> queueWaits) = 0;
+
+		virtual uint64_t GetCompletedFenceValue(QueueType queueType) const = 0;
+		virtual void WaitForFenceValue(QueueType queueType, uint64_t fenceValue) = 0;
+	};
+}
@@ -0,0 +1,176 @@
+#include "RenderGraph.hpp"
+
+#include "Device.hpp"
+#include "GraphicsContext.hpp"
+#include "ComputeContext.hpp"
+
+namespace helios::gfx
+{
+	D3D12_RESOURCE_STATES ToD3D12ResourceStates(RenderGraphResourceState state)
+	{
+		static constexpr std::array<std::pair<RenderGraphResourceState, D3D12_RESOURCE_STATES>, 8u> STATE_MAPPINGS
+		{
+			std::pair{ RenderGraphResourceState::RenderTarget, D3D12_RESOURCE_STATE_RENDER_TARGET },
+			std::pair{ RenderGraphResourceState::UnorderedAccess, D3D12_RESOURCE_STATE_UNORDERED_ACCESS },
+			std::pair{ RenderGraphResourceState::DepthWrite, D3D12_RESOURCE_STATE_DEPTH_WRITE },
+			std::pair{ RenderGraphResourceState::DepthRead, D3D12_RESOURCE_STATE_DEPTH_READ },
+			std::pair{ RenderGraphResourceState::NonPixelShaderResource, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE },
+			std::pair{ RenderGraphResourceState::PixelShaderResource, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE },
+			std::pair{ RenderGraphResourceState::CopyDestination, D3D12_RESOURCE_STATE_COPY_DEST },
+			std::pair{ RenderGraphResourceState::CopySource, D3D12_RESOURCE_STATE_COPY_SOURCE },
+		};
+
+		// Common (and present) is 0 in both.
+		D3D12_RESOURCE_STATES resourceStates{ D3D12_RESOURCE_STATE_COMMON };
+		for (const auto& [flag, d3d12State] : STATE_MAPPINGS)
+		{
+			if ((state & flag) != RenderGraphResourceState::Common)
+			{
+				resourceStates |= d3d12State;
+			}
+		}
+
+		return resourceStates;
+	}
+
+	uint32_t RenderGraph::ImportResource(const RenderGraphResourceDesc& resourceDesc, ID3D12Resource* const resource)
+	{
+		mResources.push_back(resource);
+		return mRenderGraphDesc.AddResource(resourceDesc);
+	}
+
+	uint32_t RenderGraph::AddGraphicsPass(const RenderGraphPassDesc& passDesc, GraphicsPassCallback callback, PassPrologueCallback prologue)
+	{
+		return AddPass(passDesc, Pass
+		{
+			.graphicsCallback = std::move(callback),
+			.prologue = std::move(prologue),
+		});
+	}
+
+	uint32_t RenderGraph::AddPass(const RenderGraphPassDesc& passDesc, Pass pass)
+	{
+		mPasses.push_back(std::move(pass));
+		return mRenderGraphDesc.AddPass(passDesc);
+	}
+
+	void RenderGraph::RecordBarriers(Context* const context, std::span<const RenderGraphBarrier> barriers) const
+	{
+		for (const RenderGraphBarrier& barrier : barriers)
+		{
+			if (barrier.barrierType == RenderGraphBarrierType::UnorderedAccess)
+			{
+				context->AddUavBarrier(mResources[barrier.resourceIndex]);
+			}
+			else
+			{
+				context->AddResourceBarrier(mResources[barrier.resourceIndex], ToD3D12ResourceStates(barrier.stateBefore), ToD3D12ResourceStates(barrier.stateAfter));
+			}
+		}
+
+		// Also executes the barriers added by the pass prologue, so they are part of the same batch.
+		context->ExecuteResourceBarriers();
+	}
+
+	QueueSubmission RenderGraph::Execute(Device* const device, std::span<const QueueSubmission> externalDependencies, const RenderGraphCompileOptions& compileOptions)
+	{
+		mCompiledRenderGraph = CompileRenderGraph(mRenderGraphDesc, compileOptions);
+		if (!mCompiledRenderGraph.error.empty())
+		{
+			ErrorMessage(L"Failed to compile render graph : " + StringToWString(mCompiledRenderGraph.error));
+		}
+
+		std::vector<QueueSubmission> queueSubmissions{};
+		std::array<bool, QUEUE_TYPE_COUNT> isQueueSubmittedTo{};
+		QueueSubmission lastGraphicsSubmission{};
+
+		for (const RenderGraphSubmission& submission : mCompiledRenderGraph.submissions)
+		{
+			std::vector<QueueSubmission> dependencies{};
+			for (const uint32_t dependency : submission.dependencies)
+			{
+				dependencies.push_back(queueSubmissions[dependency]);
+			}
+
+			// The later submissions of the queue execute after the first one, so only the first one has to wait.
+			bool& isSubmittedTo = isQueueSubmittedTo[static_cast<uint32_t>(submission.queueType)];
+			if (!isSubmittedTo)
+			{
+				dependencies.insert(dependencies.end(), externalDependencies.begin(), externalDependencies.end());
+				isSubmittedTo = true;
+			}
+
+			// Note : The compiler only ever places passes on the graphics and compute queues.
+			if (submission.queueType == QueueType::Compute)
+			{
+				std::vector<std::unique_ptr<ComputeContext>> computeContexts{};
+
+				for (const RenderGraphCommandList& commandList : submission.commandLists)
+				{
+					computeContexts.push_back(device->GetComputeContext());
+					ComputeContext* computeContext = computeContexts.back().get();
+
+					for (const uint32_t passIndex : commandList.passes)
+					{
+						const CompiledRenderGraphPass& compiledPass = mCompiledRenderGraph.passes[passIndex];
+						const Pass& pass = mPasses[compiledPass.passIndex];
+
+						if (pass.prologue)
+						{
+							pass.prologue(computeContext);
+						}
+
+						RecordBarriers(computeContext, compiledPass.beginBarriers);
+						pass.computeCallback(computeContext);
+						RecordBarriers(computeContext, compiledPass.endBarriers);
+					}
+				}
+
+				queueSubmissions.push_back(device->ExecuteContext(computeContexts, dependencies));
+			}
+			else
+			{
+				std::vector<std::unique_ptr<GraphicsContext>> graphicsContexts{};
+
+				for (const RenderGraphCommandList& commandList : submission.commandLists)
+				{
+					graphicsContexts.push_back(device->GetGraphicsContext());
+
+					for (const uint32_t passIndex : commandList.passes)
+					{
+						const CompiledRenderGraphPass& compiledPass = mCompiledRenderGraph.passes[passIndex];
+						const Pass& pass = mPasses[compiledPass.passIndex];
+
+						if (pass.prologue)
+						{
+							pass.prologue(graphicsContexts.back().get());
+						}
+
+						RecordBarriers(graphicsContexts.back().get(), compiledPass.beginBarriers);
+
+						if (pass.graphicsCallback)
+						{
+							pass.graphicsCallback(graphicsContexts);
+						}
+						else
+						{
+							pass.graphicsComputeCallback(graphicsContexts.back().get());
+						}
+
+						RecordBarriers(graphicsContexts.back().get(), compiledPass.endBarriers);
+					}
+				}
+
+				queueSubmissions.push_back(device->ExecuteContext(graphicsContexts, dependencies));
+				lastGraphicsSubmission = queueSubmissions.back();
+			}
+		}
+
+		mLastRenderGraphDesc = std::move(mRenderGraphDesc);
+		mRenderGraphDesc = {};
+		mResources.clear();
+		mPasses.clear();
+
+		return lastGraphicsSubmission;
+	}
+}
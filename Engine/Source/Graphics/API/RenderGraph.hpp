@@ -0,0 +1,76 @@
+#pragma once
+
+#include "RenderGraphCompiler.hpp"
+#include "QueueScheduler.hpp"
+
+namespace helios::gfx
+{
+	class Device;
+	class Context;
+	class GraphicsContext;
+	class ComputeContext;
+
+	D3D12_RESOURCE_STATES ToD3D12ResourceStates(RenderGraphResourceState state);
+
+	// Records the passes of a frame with the barriers, queues and submissions chosen by CompileRenderGraph (see RenderGraphCompiler.hpp), so passes only declare
+	// the states they access resources in.
+	// Usage (every frame) : import the resources (in the states they rest in between frames), add the passes in the order their results are consumed, and call Execute().
+	class RenderGraph
+	{
+	public:
+		// Graphics passes may append contexts (i.e to record draws in parallel) : the end barriers of the pass (and the following passes of the command list) are
+		// recorded into the last context.
+		using GraphicsPassCallback = std::function<void(std::vector<std::unique_ptr<GraphicsContext>>& graphicsContexts)>;
+
+		// Recorded before the begin barriers of a pass, i.e for the aliasing barriers of the resources that become active in the pass (see TransientResourcePool).
+		using PassPrologueCallback = std::function<void(Context* context)>;
+
+		uint32_t ImportResource(const RenderGraphResourceDesc& resourceDesc, ID3D12Resource* const resource);
+
+		uint32_t AddGraphicsPass(const RenderGraphPassDesc& passDesc, GraphicsPassCallback callback, PassPrologueCallback prologue = {});
+
+		// Async compute passes run on the graphics queue if the compiler moves them there, so the callback must accept both a ComputeContext* and a GraphicsContext*
+		// (i.e a generic lambda, as both provide the compute functions).
+		template <typename ComputePassCallback>
+		uint32_t AddComputePass(const RenderGraphPassDesc& passDesc, ComputePassCallback callback, PassPrologueCallback prologue = {})
+		{
+			return AddPass(passDesc, Pass
+			{
+				.computeCallback = [callback](ComputeContext* computeContext) { callback(computeContext); },
+				.graphicsComputeCallback = [callback](GraphicsContext* graphicsContext) { callback(graphicsContext); },
+				.prologue = std::move(prologue),
+			});
+		}
+
+		// Compiles and records the passes, and submits them. The first submission of each queue waits for externalDependencies (i.e resources generated asynchronously).
+		// Returns the last graphics submission, after which all resources are in their final state.
+		QueueSubmission Execute(Device* const device, std::span<const QueueSubmission> externalDependencies = {}, const RenderGraphCompileOptions& compileOptions = {});
+
+		// The graph of the last Execute() call (the resources and passes are cleared once executed).
+		const CompiledRenderGraph& GetCompiledRenderGraph() const { return mCompiledRenderGraph; }
+		std::string GenerateReport() const { return GenerateRenderGraphReport(mLastRenderGraphDesc, mCompiledRenderGraph); }
+
+	private:
+		struct Pass
+		{
+			GraphicsPassCallback graphicsCallback{};
+
+			std::function<void(ComputeContext*)> computeCallback{};
+			std::function<void(GraphicsContext*)> graphicsComputeCallback{};
+
+			PassPrologueCallback prologue{};
+		};
+
+		uint32_t AddPass(const RenderGraphPassDesc& passDesc, Pass pass);
+
+		void RecordBarriers(Context* const context, std::span<const RenderGraphBarrier> barriers) const;
+
+	private:
+		RenderGraphDesc mRenderGraphDesc{};
+		std::vector<ID3D12Resource*> mResources{};
+		std::vector<Pass> mPasses{};
+
+		RenderGraphDesc mLastRenderGraphDesc{};
+		CompiledRenderGraph mCompiledRenderGraph{};
+	};
+}
@@ -0,0 +1,1128 @@
+#include "RenderGraphCompiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <queue>
+#include <span>
+#include <utility>
+
+namespace helios::gfx
+{
+	static constexpr uint32_t NO_PASS = UINT32_MAX;
+
+	static constexpr RenderGraphResourceState WRITE_STATES = RenderGraphResourceState::RenderTarget | RenderGraphResourceState::UnorderedAccess |
+		RenderGraphResourceState::DepthWrite | RenderGraphResourceState::CopyDestination;
+
+	static constexpr RenderGraphResourceState GRAPHICS_ONLY_STATES = RenderGraphResourceState::RenderTarget | RenderGraphResourceState::DepthWrite |
+		RenderGraphResourceState::DepthRead | RenderGraphResourceState::PixelShaderResource;
+
+	static constexpr RenderGraphResourceState COPY_STATES = RenderGraphResourceState::CopySource | RenderGraphResourceState::CopyDestination;
+
+	std::string RenderGraphResourceStateToString(RenderGraphResourceState state)
+	{
+		if (state == RenderGraphResourceState::Common)
+		{
+			return "Common";
+		}
+
+		static constexpr std::array<std::pair<RenderGraphResourceState, const char*>, 8u> STATE_NAMES
+		{
+			std::pair{ RenderGraphResourceState::RenderTarget, "RenderTarget" },
+			std::pair{ RenderGraphResourceState::UnorderedAccess, "UnorderedAccess" },
+			std::pair{ RenderGraphResourceState::DepthWrite, "DepthWrite" },
+			std::pair{ RenderGraphResourceState::DepthRead, "DepthRead" },
+			std::pair{ RenderGraphResourceState::NonPixelShaderResource, "NonPixelShaderResource" },
+			std::pair{ RenderGraphResourceState::PixelShaderResource, "PixelShaderResource" },
+			std::pair{ RenderGraphResourceState::CopyDestination, "CopyDestination" },
+			std::pair{ RenderGraphResourceState::CopySource, "CopySource" },
+		};
+
+		std::string result{};
+		for (const auto& [flag, name] : STATE_NAMES)
+		{
+			if ((state & flag) != RenderGraphResourceState::Common)
+			{
+				result += result.empty() ? name : std::string("|") + name;
+			}
+		}
+
+		return result;
+	}
+
+	bool IsReadOnlyState(RenderGraphResourceState state)
+	{
+		return (state & WRITE_STATES) == RenderGraphResourceState::Common;
+	}
+
+	bool IsStateSupportedByQueue(RenderGraphResourceState state, QueueType queueType)
+	{
+		switch (queueType)
+		{
+			case QueueType::Graphics:
+			{
+				return true;
+			}break;
+
+			case QueueType::Compute:
+			{
+				return (state & GRAPHICS_ONLY_STATES) == RenderGraphResourceState::Common;
+			}break;
+
+			case QueueType::Copy:
+			{
+				return (state & COPY_STATES) == state;
+			}break;
+		}
+
+		return false;
+	}
+
+	RenderGraphPassDesc& RenderGraphPassDesc::Read(uint32_t resourceIndex, RenderGraphResourceState state)
+	{
+		reads.push_back(RenderGraphResourceAccess{ .resourceIndex = resourceIndex, .state = state });
+		return *this;
+	}
+
+	RenderGraphPassDesc& RenderGraphPassDesc::Write(uint32_t resourceIndex, RenderGraphResourceState state)
+	{
+		writes.push_back(RenderGraphResourceAccess{ .resourceIndex = resourceIndex, .state = state });
+		return *this;
+	}
+
+	uint32_t RenderGraphDesc::AddResource(const RenderGraphResourceDesc& resourceDesc)
+	{
+		resources.push_back(resourceDesc);
+		return static_cast<uint32_t>(resources.size() - 1u);
+	}
+
+	uint32_t RenderGraphDesc::AddPass(const RenderGraphPassDesc& passDesc)
+	{
+		passes.push_back(passDesc);
+		return static_cast<uint32_t>(passes.size() - 1u);
+	}
+
+	// An access of a pass, with all reads of a resource combined.
+	struct PassAccess
+	{
+		uint32_t resourceIndex{};
+		RenderGraphResourceState state{};
+		bool isWrite{};
+	};
+
+	// Data dependencies (the pass reads / partially overwrites what the other pass wrote) keep the other pass alive, while order dependencies
+	// (the pass overwrites what the other pass read) only order them.
+	struct PassDependency
+	{
+		uint32_t passIndex{};
+		bool isData{};
+	};
+
+	struct CompilationPass
+	{
+		std::vector<PassAccess> accesses{};
+		std::vector<PassDependency> dependencies{};
+
+		bool isKept{};
+		QueueType queueType{};
+
+		// Position in the execution order (NO_PASS if culled).
+		uint32_t executionIndex{ NO_PASS };
+	};
+
+	// Returns an error message, or an empty string if all accesses are valid.
+	static std::string GatherAccesses(const RenderGraphDesc& renderGraphDesc, std::vector<CompilationPass>& passes)
+	{
+		for (uint32_t passIndex = 0u; passIndex < renderGraphDesc.passes.size(); ++passIndex)
+		{
+			const RenderGraphPassDesc& passDesc = renderGraphDesc.passes[passIndex];
+			std::vector<PassAccess>& accesses = passes[passIndex].accesses;
+			accesses.reserve(passDesc.reads.size() + passDesc.writes.size());
+
+			for (const bool isWrite : { false, true })
+			{
+				for (const RenderGraphResourceAccess& access : isWrite ? passDesc.writes : passDesc.reads)
+				{
+					if (access.resourceIndex >= renderGraphDesc.resources.size())
+					{
+						return "Pass '" + passDesc.name + "' accesses the invalid resource index " + std::to_string(access.resourceIndex);
+					}
+
+					const std::string& resourceName = renderGraphDesc.resources[access.resourceIndex].name;
+
+					if (!isWrite && !IsReadOnlyState(access.state))
+					{
+						return "Pass '" + passDesc.name + "' reads '" + resourceName + "' in the write state " + RenderGraphResourceStateToString(access.state);
+					}
+
+					if (isWrite && ((access.state & WRITE_STATES) != access.state || std::popcount(static_cast<uint32_t>(access.state)) != 1))
+					{
+						return "Pass '" + passDesc.name + "' writes '" + resourceName + "' in the state " + RenderGraphResourceStateToString(access.state) + ", which is not a single write state";
+					}
+
+					auto existingAccess = std::find_if(accesses.begin(), accesses.end(), [&](const PassAccess& passAccess) { return passAccess.resourceIndex == access.resourceIndex; });
+					if (existingAccess == accesses.end())
+					{
+						accesses.push_back(PassAccess{ .resourceIndex = access.resourceIndex, .state = access.state, .isWrite = isWrite });
+					}
+					else if (isWrite || existingAccess->isWrite)
+					{
+						return "Pass '" + passDesc.name + "' writes '" + resourceName + "' along with another access of it";
+					}
+					else
+					{
+						existingAccess->state = existingAccess->state | access.state;
+					}
+				}
+			}
+		}
+
+		return {};
+	}
+
+	static void BuildDependencies(const RenderGraphDesc& renderGraphDesc, std::vector<CompilationPass>& passes)
+	{
+		std::vector<uint32_t> lastWriters(renderGraphDesc.resources.size(), NO_PASS);
+		std::vector<std::vector<uint32_t>> readersSinceWrite(renderGraphDesc.resources.size());
+
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			std::vector<PassDependency>& dependencies = passes[passIndex].dependencies;
+
+			for (const PassAccess& access : passes[passIndex].accesses)
+			{
+				const uint32_t lastWriter = lastWriters[access.resourceIndex];
+
+				if (lastWriter != NO_PASS)
+				{
+					dependencies.push_back(PassDependency{ .passIndex = lastWriter, .isData = true });
+				}
+
+				if (access.isWrite)
+				{
+					for (const uint32_t reader : readersSinceWrite[access.resourceIndex])
+					{
+						dependencies.push_back(PassDependency{ .passIndex = reader, .isData = false });
+					}
+
+					lastWriters[access.resourceIndex] = passIndex;
+					readersSinceWrite[access.resourceIndex].clear();
+				}
+				else
+				{
+					readersSinceWrite[access.resourceIndex].push_back(passIndex);
+				}
+			}
+
+			// A pass may depend on another pass through several resources : the dependency is a data dependency if any of them is.
+			std::sort(dependencies.begin(), dependencies.end(), [](const PassDependency& a, const PassDependency& b)
+			{
+				return a.passIndex != b.passIndex ? a.passIndex < b.passIndex : a.isData > b.isData;
+			});
+
+			dependencies.erase(std::unique(dependencies.begin(), dependencies.end(), [](const PassDependency& a, const PassDependency& b) { return a.passIndex == b.passIndex; }), dependencies.end());
+		}
+	}
+
+	static void CullPasses(const RenderGraphDesc& renderGraphDesc, const RenderGraphCompileOptions& compileOptions, std::vector<CompilationPass>& passes)
+	{
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			CompilationPass& pass = passes[passIndex];
+
+			pass.isKept = !compileOptions.isCullingEnabled || renderGraphDesc.passes[passIndex].hasSideEffects ||
+				std::any_of(pass.accesses.begin(), pass.accesses.end(), [&](const PassAccess& access) { return access.isWrite && renderGraphDesc.resources[access.resourceIndex].isOutput; });
+		}
+
+		// Dependencies always refer to earlier passes, so a single backwards sweep visits every pass after all the passes depending on it.
+		for (uint32_t passIndex = static_cast<uint32_t>(passes.size()); passIndex-- > 0u;)
+		{
+			if (!passes[passIndex].isKept)
+			{
+				continue;
+			}
+
+			for (const PassDependency& dependency : passes[passIndex].dependencies)
+			{
+				if (dependency.isData)
+				{
+					passes[dependency.passIndex].isKept = true;
+				}
+			}
+		}
+	}
+
+	// Topological sort (Kahn's algorithm) of the kept passes. Ready compute passes are scheduled first, so the graphics queue has work to overlap them with,
+	// and ties are broken by the declaration order.
+	static std::vector<uint32_t> OrderPasses(std::vector<CompilationPass>& passes)
+	{
+		std::vector<std::vector<uint32_t>> dependents(passes.size());
+		std::vector<uint32_t> remainingDependencyCounts(passes.size());
+
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			if (!passes[passIndex].isKept)
+			{
+				continue;
+			}
+
+			for (const PassDependency& dependency : passes[passIndex].dependencies)
+			{
+				if (passes[dependency.passIndex].isKept)
+				{
+					dependents[dependency.passIndex].push_back(passIndex);
+					remainingDependencyCounts[passIndex]++;
+				}
+			}
+		}
+
+		const auto GetPriority = [&](uint32_t passIndex) { return std::pair{ passes[passIndex].queueType == QueueType::Compute ? 0u : 1u, passIndex }; };
+		const auto HasLowerPriority = [&](uint32_t a, uint32_t b) { return GetPriority(a) > GetPriority(b); };
+
+		std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(HasLowerPriority)> readyPasses(HasLowerPriority);
+
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			if (passes[passIndex].isKept && remainingDependencyCounts[passIndex] == 0u)
+			{
+				readyPasses.push(passIndex);
+			}
+		}
+
+		std::vector<uint32_t> executionOrder{};
+
+		while (!readyPasses.empty())
+		{
+			const uint32_t passIndex = readyPasses.top();
+			readyPasses.pop();
+
+			passes[passIndex].executionIndex = static_cast<uint32_t>(executionOrder.size());
+			executionOrder.push_back(passIndex);
+
+			for (const uint32_t dependent : dependents[passIndex])
+			{
+				if (--remainingDependencyCounts[dependent] == 0u)
+				{
+					readyPasses.push(dependent);
+				}
+			}
+		}
+
+		return executionOrder;
+	}
+
+	// Places the transitions of every resource (see CompileRenderGraph). Returns the async compute passes that have to run on the graphics queue instead.
+	static std::vector<uint32_t> PlaceBarriers(const RenderGraphDesc& renderGraphDesc, const std::vector<CompilationPass>& passes, const std::vector<uint32_t>& executionOrder,
+		std::vector<CompiledRenderGraphPass>& compiledPasses)
+	{
+		struct ResourceAccess
+		{
+			uint32_t executionIndex{};
+			RenderGraphResourceState state{};
+			bool isWrite{};
+		};
+
+		// Accesses [begin, end) of a resource : a single write, or consecutive reads. Every access of a segment depends on every access of the previous segment.
+		struct AccessSegment
+		{
+			size_t begin{};
+			size_t end{};
+		};
+
+		// The accesses of all resources in a single allocation (grouped by resource, in execution order).
+		std::vector<uint32_t> resourceAccessOffsets(renderGraphDesc.resources.size() + 1u);
+		for (const uint32_t passIndex : executionOrder)
+		{
+			for (const PassAccess& access : passes[passIndex].accesses)
+			{
+				resourceAccessOffsets[access.resourceIndex + 1u]++;
+			}
+		}
+
+		for (size_t resourceIndex = 1u; resourceIndex < resourceAccessOffsets.size(); ++resourceIndex)
+		{
+			resourceAccessOffsets[resourceIndex] += resourceAccessOffsets[resourceIndex - 1u];
+		}
+
+		std::vector<ResourceAccess> resourceAccesses(resourceAccessOffsets.back());
+		std::vector<uint32_t> resourceAccessCounts(renderGraphDesc.resources.size());
+
+		for (uint32_t executionIndex = 0u; executionIndex < executionOrder.size(); ++executionIndex)
+		{
+			for (const PassAccess& access : passes[executionOrder[executionIndex]].accesses)
+			{
+				resourceAccesses[resourceAccessOffsets[access.resourceIndex] + resourceAccessCounts[access.resourceIndex]++] =
+					ResourceAccess{ .executionIndex = executionIndex, .state = access.state, .isWrite = access.isWrite };
+			}
+		}
+
+		std::vector<uint32_t> demotedPasses{};
+
+		const auto GetQueueType = [&](uint32_t executionIndex) { return compiledPasses[executionIndex].queueType; };
+
+		const auto Demote = [&](uint32_t executionIndex)
+		{
+			if (GetQueueType(executionIndex) != QueueType::Graphics)
+			{
+				demotedPasses.push_back(executionOrder[executionIndex]);
+			}
+		};
+
+		const auto IsTransitionSupported = [&](uint32_t executionIndex, RenderGraphResourceState stateBefore, RenderGraphResourceState stateAfter)
+		{
+			return IsStateSupportedByQueue(stateBefore, GetQueueType(executionIndex)) && IsStateSupportedByQueue(stateAfter, GetQueueType(executionIndex));
+		};
+
+		// The passes that complete before a pass starts are its dependencies, and the previous pass of its queue.
+		std::vector<uint32_t> previousQueueExecutionIndices(executionOrder.size());
+		std::array<uint32_t, QUEUE_TYPE_COUNT> lastQueueExecutionIndices{};
+		lastQueueExecutionIndices.fill(NO_PASS);
+
+		for (uint32_t executionIndex = 0u; executionIndex < executionOrder.size(); ++executionIndex)
+		{
+			uint32_t& lastQueueExecutionIndex = lastQueueExecutionIndices[static_cast<uint32_t>(GetQueueType(executionIndex))];
+
+			previousQueueExecutionIndices[executionIndex] = lastQueueExecutionIndex;
+			lastQueueExecutionIndex = executionIndex;
+		}
+
+		// Searches the predecessors of b (transitively) for a. Passes executing before a can't lead to it, so the search is limited to [a, b].
+		std::vector<uint32_t> visitMarks(executionOrder.size(), NO_PASS);
+		std::vector<uint32_t> searchStack{};
+		uint32_t searchIndex{};
+
+		const auto HappensBefore = [&](uint32_t a, uint32_t b)
+		{
+			if (a == b || GetQueueType(a) == GetQueueType(b))
+			{
+				return a <= b;
+			}
+
+			searchIndex++;
+			searchStack.assign(1u, b);
+			visitMarks[b] = searchIndex;
+
+			while (!searchStack.empty())
+			{
+				const uint32_t executionIndex = searchStack.back();
+				searchStack.pop_back();
+
+				const auto VisitPredecessor = [&](uint32_t predecessor)
+				{
+					if (predecessor != NO_PASS && predecessor > a && visitMarks[predecessor] != searchIndex)
+					{
+						visitMarks[predecessor] = searchIndex;
+						searchStack.push_back(predecessor);
+					}
+
+					return predecessor == a;
+				};
+
+				for (const PassDependency& dependency : passes[executionOrder[executionIndex]].dependencies)
+				{
+					if (passes[dependency.passIndex].isKept && VisitPredecessor(passes[dependency.passIndex].executionIndex))
+					{
+						return true;
+					}
+				}
+
+				if (VisitPredecessor(previousQueueExecutionIndices[executionIndex]))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		};
+
+		// The last graphics pass (or the last pass, if there is none) performs the final transitions of the resources no pass accesses.
+		uint32_t lastGraphicsExecutionIndex = executionOrder.empty() ? NO_PASS : static_cast<uint32_t>(executionOrder.size() - 1u);
+		for (uint32_t executionIndex = 0u; executionIndex < executionOrder.size(); ++executionIndex)
+		{
+			if (GetQueueType(executionIndex) == QueueType::Graphics)
+			{
+				lastGraphicsExecutionIndex = executionIndex;
+			}
+		}
+
+		for (uint32_t resourceIndex = 0u; resourceIndex < renderGraphDesc.resources.size(); ++resourceIndex)
+		{
+			const std::span<const ResourceAccess> accesses(resourceAccesses.data() + resourceAccessOffsets[resourceIndex], resourceAccessCounts[resourceIndex]);
+			const RenderGraphResourceDesc& resourceDesc = renderGraphDesc.resources[resourceIndex];
+
+			const auto DemoteSegment = [&](const AccessSegment& segment)
+			{
+				for (size_t accessIndex = segment.begin; accessIndex < segment.end; ++accessIndex)
+				{
+					Demote(accesses[accessIndex].executionIndex);
+				}
+			};
+
+			// If the first access of a segment completes before all others start, it can transition the resource before them (and similarly, the last access after them).
+			// Accesses on a single queue always do, and accesses on other queues may wait for it (directly or not).
+			const auto TryTransitionBefore = [&](const AccessSegment& segment, RenderGraphResourceState stateBefore, RenderGraphResourceState stateAfter)
+			{
+				const uint32_t executionIndex = accesses[segment.begin].executionIndex;
+				const bool isFirst = std::all_of(accesses.begin() + segment.begin, accesses.begin() + segment.end, [&](const ResourceAccess& access) { return HappensBefore(executionIndex, access.executionIndex); });
+
+				if (!isFirst || !IsTransitionSupported(executionIndex, stateBefore, stateAfter))
+				{
+					return false;
+				}
+
+				compiledPasses[executionIndex].beginBarriers.push_back(RenderGraphBarrier{ .resourceIndex = resourceIndex, .stateBefore = stateBefore, .stateAfter = stateAfter });
+				return true;
+			};
+
+			const auto TryTransitionAfter = [&](const AccessSegment& segment, RenderGraphResourceState stateBefore, RenderGraphResourceState stateAfter)
+			{
+				if (segment.begin == segment.end)
+				{
+					return false;
+				}
+
+				const uint32_t executionIndex = accesses[segment.end - 1u].executionIndex;
+				const bool isLast = std::all_of(accesses.begin() + segment.begin, accesses.begin() + segment.end, [&](const ResourceAccess& access) { return HappensBefore(access.executionIndex, executionIndex); });
+
+				if (!isLast || !IsTransitionSupported(executionIndex, stateBefore, stateAfter))
+				{
+					return false;
+				}
+
+				compiledPasses[executionIndex].endBarriers.push_back(RenderGraphBarrier{ .resourceIndex = resourceIndex, .stateBefore = stateBefore, .stateAfter = stateAfter });
+				return true;
+			};
+
+			RenderGraphResourceState currentState = resourceDesc.initialState;
+
+			// An empty previous segment stands for the work before the graph.
+			AccessSegment previousSegment{};
+
+			while (previousSegment.end < accesses.size())
+			{
+				AccessSegment segment{ .begin = previousSegment.end, .end = previousSegment.end + 1u };
+				RenderGraphResourceState segmentState = accesses[segment.begin].state;
+
+				if (!accesses[segment.begin].isWrite)
+				{
+					while (segment.end < accesses.size() && !accesses[segment.end].isWrite)
+					{
+						segmentState = segmentState | accesses[segment.end].state;
+						segment.end++;
+					}
+				}
+
+				// Accesses on other queues than the previous segment wait for it, so either side of the wait can perform the transition : the start of the segment is
+				// preferred, so the previous segment's queue does not wait for the transition (i.e a compute write can overlap the graphics work after the previous reads).
+				// Reads can be performed in a combined read state that includes all of them.
+				const bool isTransitionRequired = accesses[segment.begin].isWrite ? currentState != segmentState : !IsReadOnlyState(currentState) || (currentState & segmentState) != segmentState;
+
+				if (isTransitionRequired && !TryTransitionBefore(segment, currentState, segmentState) && !TryTransitionAfter(previousSegment, currentState, segmentState))
+				{
+					// Moving all the async compute accesses involved to the graphics queue always makes the transition possible.
+					DemoteSegment(segment);
+					DemoteSegment(previousSegment);
+				}
+				else if (!isTransitionRequired && segmentState == RenderGraphResourceState::UnorderedAccess && previousSegment.begin != previousSegment.end)
+				{
+					// Consecutive unordered access writes (the previous segment can only be a write, as reads are never in the unordered access state).
+					compiledPasses[accesses[segment.begin].executionIndex].beginBarriers.push_back(RenderGraphBarrier{ .barrierType = RenderGraphBarrierType::UnorderedAccess, .resourceIndex = resourceIndex });
+				}
+
+				if (isTransitionRequired)
+				{
+					currentState = segmentState;
+				}
+
+				previousSegment = segment;
+			}
+
+			if (currentState == resourceDesc.finalState)
+			{
+				continue;
+			}
+
+			if (accesses.empty())
+			{
+				if (lastGraphicsExecutionIndex != NO_PASS)
+				{
+					if (!IsTransitionSupported(lastGraphicsExecutionIndex, currentState, resourceDesc.finalState))
+					{
+						Demote(lastGraphicsExecutionIndex);
+					}
+
+					compiledPasses[lastGraphicsExecutionIndex].endBarriers.push_back(RenderGraphBarrier{ .resourceIndex = resourceIndex, .stateBefore = currentState, .stateAfter = resourceDesc.finalState });
+				}
+			}
+			else if (!TryTransitionAfter(previousSegment, currentState, resourceDesc.finalState))
+			{
+				DemoteSegment(previousSegment);
+			}
+		}
+
+		std::sort(demotedPasses.begin(), demotedPasses.end());
+		demotedPasses.erase(std::unique(demotedPasses.begin(), demotedPasses.end()), demotedPasses.end());
+
+		return demotedPasses;
+	}
+
+	static void GroupPasses(const std::vector<CompilationPass>& passes, const std::vector<uint32_t>& executionOrder, const RenderGraphCompileOptions& compileOptions,
+		CompiledRenderGraph& compiledRenderGraph)
+	{
+		static constexpr uint32_t NO_SUBMISSION = UINT32_MAX;
+
+		// Submissions in creation order, and the order they are closed (submitted) in. A submission is closed before any submission depending on it is created.
+		std::vector<RenderGraphSubmission> submissions{};
+		std::vector<uint32_t> closedSubmissions{};
+
+		std::array<uint32_t, QUEUE_TYPE_COUNT> openSubmissions{};
+		openSubmissions.fill(NO_SUBMISSION);
+
+		std::vector<uint32_t> passSubmissions(executionOrder.size(), NO_SUBMISSION);
+
+		const auto CloseSubmission = [&](QueueType queueType)
+		{
+			uint32_t& openSubmission = openSubmissions[static_cast<uint32_t>(queueType)];
+			if (openSubmission != NO_SUBMISSION)
+			{
+				closedSubmissions.push_back(openSubmission);
+				openSubmission = NO_SUBMISSION;
+			}
+		};
+
+		for (uint32_t executionIndex = 0u; executionIndex < executionOrder.size(); ++executionIndex)
+		{
+			const CompilationPass& pass = passes[executionOrder[executionIndex]];
+
+			std::vector<uint32_t> dependencies{};
+			for (const PassDependency& dependency : pass.dependencies)
+			{
+				const CompilationPass& dependencyPass = passes[dependency.passIndex];
+				if (dependencyPass.isKept && dependencyPass.queueType != pass.queueType)
+				{
+					dependencies.push_back(passSubmissions[dependencyPass.executionIndex]);
+				}
+			}
+
+			std::sort(dependencies.begin(), dependencies.end());
+			dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+			// The work this pass depends on has to be submitted (and signalled) before it.
+			for (const uint32_t dependency : dependencies)
+			{
+				if (openSubmissions[static_cast<uint32_t>(submissions[dependency].queueType)] == dependency)
+				{
+					CloseSubmission(submissions[dependency].queueType);
+				}
+			}
+
+			// Waits happen before a submission executes, so a new dependency starts a new submission.
+			uint32_t& openSubmission = openSubmissions[static_cast<uint32_t>(pass.queueType)];
+			if (openSubmission != NO_SUBMISSION && !std::includes(submissions[openSubmission].dependencies.begin(), submissions[openSubmission].dependencies.end(), dependencies.begin(), dependencies.end()))
+			{
+				CloseSubmission(pass.queueType);
+			}
+
+			if (openSubmission == NO_SUBMISSION)
+			{
+				openSubmission = static_cast<uint32_t>(submissions.size());
+				submissions.push_back(RenderGraphSubmission{ .queueType = pass.queueType, .dependencies = std::move(dependencies) });
+			}
+
+			std::vector<RenderGraphCommandList>& commandLists = submissions[openSubmission].commandLists;
+			if (commandLists.empty() || commandLists.back().passes.size() >= std::max(compileOptions.maxPassesPerCommandList, 1u))
+			{
+				commandLists.emplace_back();
+			}
+
+			commandLists.back().passes.push_back(executionIndex);
+			passSubmissions[executionIndex] = openSubmission;
+		}
+
+		for (const QueueType queueType : { QueueType::Compute, QueueType::Copy, QueueType::Graphics })
+		{
+			CloseSubmission(queueType);
+		}
+
+		std::vector<uint32_t> submissionIndices(submissions.size());
+		for (uint32_t closedIndex = 0u; closedIndex < closedSubmissions.size(); ++closedIndex)
+		{
+			submissionIndices[closedSubmissions[closedIndex]] = closedIndex;
+		}
+
+		for (const uint32_t submission : closedSubmissions)
+		{
+			RenderGraphSubmission& renderGraphSubmission = submissions[submission];
+			for (uint32_t& dependency : renderGraphSubmission.dependencies)
+			{
+				dependency = submissionIndices[dependency];
+			}
+
+			compiledRenderGraph.statistics.crossQueueDependencyCount += static_cast<uint32_t>(renderGraphSubmission.dependencies.size());
+			compiledRenderGraph.statistics.commandListCount += static_cast<uint32_t>(renderGraphSubmission.commandLists.size());
+
+			compiledRenderGraph.submissions.push_back(std::move(renderGraphSubmission));
+		}
+
+		compiledRenderGraph.statistics.submissionCount = static_cast<uint32_t>(compiledRenderGraph.submissions.size());
+	}
+
+	// The end barriers of a pass and the begin barriers of the next pass of the same command list are executed back to back, so they form a single batch.
+	static void MergeBarrierBatches(CompiledRenderGraph& compiledRenderGraph)
+	{
+		for (const RenderGraphSubmission& submission : compiledRenderGraph.submissions)
+		{
+			for (const RenderGraphCommandList& commandList : submission.commandLists)
+			{
+				for (size_t passIndex = 1u; passIndex < commandList.passes.size(); ++passIndex)
+				{
+					CompiledRenderGraphPass& previousPass = compiledRenderGraph.passes[commandList.passes[passIndex - 1u]];
+					CompiledRenderGraphPass& pass = compiledRenderGraph.passes[commandList.passes[passIndex]];
+
+					if (!previousPass.endBarriers.empty())
+					{
+						pass.beginBarriers.insert(pass.beginBarriers.begin(), previousPass.endBarriers.begin(), previousPass.endBarriers.end());
+						previousPass.endBarriers.clear();
+					}
+				}
+			}
+		}
+	}
+
+	static void ComputeBarrierStatistics(const RenderGraphDesc& renderGraphDesc, const std::vector<CompilationPass>& passes, const std::vector<uint32_t>& executionOrder,
+		RenderGraphCompileStatistics& statistics)
+	{
+		// Without combining / placing transitions, every access transitions the resource into its state (if it is not in it already) at the start of its pass.
+		std::vector<RenderGraphResourceState> naiveStates(renderGraphDesc.resources.size());
+		for (uint32_t resourceIndex = 0u; resourceIndex < renderGraphDesc.resources.size(); ++resourceIndex)
+		{
+			naiveStates[resourceIndex] = renderGraphDesc.resources[resourceIndex].initialState;
+		}
+
+		for (const uint32_t passIndex : executionOrder)
+		{
+			uint32_t passTransitionCount{};
+			for (const PassAccess& access : passes[passIndex].accesses)
+			{
+				if (naiveStates[access.resourceIndex] != access.state)
+				{
+					naiveStates[access.resourceIndex] = access.state;
+					passTransitionCount++;
+				}
+			}
+
+			statistics.naiveBarrierCount += passTransitionCount;
+			statistics.naiveBarrierBatchCount += passTransitionCount != 0u ? 1u : 0u;
+		}
+
+		uint32_t finalTransitionCount{};
+		for (uint32_t resourceIndex = 0u; resourceIndex < renderGraphDesc.resources.size(); ++resourceIndex)
+		{
+			finalTransitionCount += naiveStates[resourceIndex] != renderGraphDesc.resources[resourceIndex].finalState ? 1u : 0u;
+		}
+
+		statistics.naiveBarrierCount += finalTransitionCount;
+		statistics.naiveBarrierBatchCount += finalTransitionCount != 0u ? 1u : 0u;
+	}
+
+	CompiledRenderGraph CompileRenderGraph(const RenderGraphDesc& renderGraphDesc, const RenderGraphCompileOptions& compileOptions)
+	{
+		CompiledRenderGraph compiledRenderGraph{};
+
+		std::vector<CompilationPass> passes(renderGraphDesc.passes.size());
+
+		compiledRenderGraph.error = GatherAccesses(renderGraphDesc, passes);
+		if (!compiledRenderGraph.error.empty())
+		{
+			return compiledRenderGraph;
+		}
+
+		BuildDependencies(renderGraphDesc, passes);
+		CullPasses(renderGraphDesc, compileOptions, passes);
+
+		RenderGraphCompileStatistics& statistics = compiledRenderGraph.statistics;
+
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			CompilationPass& pass = passes[passIndex];
+
+			const bool isAsyncCompute = renderGraphDesc.passes[passIndex].queue == RenderGraphPassQueue::AsyncCompute && compileOptions.isAsyncComputeEnabled;
+			const bool isComputeQueueSupported = std::all_of(pass.accesses.begin(), pass.accesses.end(), [](const PassAccess& access) { return IsStateSupportedByQueue(access.state, QueueType::Compute); });
+
+			pass.queueType = isAsyncCompute && isComputeQueueSupported ? QueueType::Compute : QueueType::Graphics;
+
+			statistics.passCount += pass.isKept ? 1u : 0u;
+			statistics.culledPassCount += pass.isKept ? 0u : 1u;
+			statistics.demotedPassCount += pass.isKept && isAsyncCompute && !isComputeQueueSupported ? 1u : 0u;
+		}
+
+		// Moving a pass to the graphics queue may change the order (and so the barriers), so the passes are scheduled again until all transitions are supported.
+		// Passes only ever move to the graphics queue, so this terminates.
+		std::vector<uint32_t> executionOrder{};
+		while (true)
+		{
+			executionOrder = OrderPasses(passes);
+
+			compiledRenderGraph.passes.clear();
+			for (const uint32_t passIndex : executionOrder)
+			{
+				compiledRenderGraph.passes.push_back(CompiledRenderGraphPass{ .passIndex = passIndex, .queueType = passes[passIndex].queueType });
+			}
+
+			const std::vector<uint32_t> demotedPasses = PlaceBarriers(renderGraphDesc, passes, executionOrder, compiledRenderGraph.passes);
+			if (demotedPasses.empty())
+			{
+				break;
+			}
+
+			for (const uint32_t passIndex : demotedPasses)
+			{
+				passes[passIndex].queueType = QueueType::Graphics;
+			}
+
+			statistics.demotedPassCount += static_cast<uint32_t>(demotedPasses.size());
+		}
+
+		if (executionOrder.empty())
+		{
+			for (const RenderGraphResourceDesc& resourceDesc : renderGraphDesc.resources)
+			{
+				if (resourceDesc.initialState != resourceDesc.finalState)
+				{
+					compiledRenderGraph.error = "No pass is left to transition '" + resourceDesc.name + "' into its final state";
+					return compiledRenderGraph;
+				}
+			}
+		}
+
+		for (const CompiledRenderGraphPass& pass : compiledRenderGraph.passes)
+		{
+			statistics.asyncComputePassCount += pass.queueType == QueueType::Compute ? 1u : 0u;
+		}
+
+		GroupPasses(passes, executionOrder, compileOptions, compiledRenderGraph);
+		MergeBarrierBatches(compiledRenderGraph);
+
+		for (const CompiledRenderGraphPass& pass : compiledRenderGraph.passes)
+		{
+			statistics.barrierCount += static_cast<uint32_t>(pass.beginBarriers.size() + pass.endBarriers.size());
+			statistics.barrierBatchCount += (pass.beginBarriers.empty() ? 0u : 1u) + (pass.endBarriers.empty() ? 0u : 1u);
+		}
+
+		ComputeBarrierStatistics(renderGraphDesc, passes, executionOrder, statistics);
+
+		return compiledRenderGraph;
+	}
+
+	bool ValidateCompiledRenderGraph(const RenderGraphDesc& renderGraphDesc, const CompiledRenderGraph& compiledRenderGraph, std::string* error)
+	{
+		const auto Fail = [&](const std::string& message)
+		{
+			if (error)
+			{
+				*error = message;
+			}
+
+			return false;
+		};
+
+		if (!compiledRenderGraph.error.empty())
+		{
+			return Fail("The graph did not compile : " + compiledRenderGraph.error);
+		}
+
+		const std::vector<CompiledRenderGraphPass>& passes = compiledRenderGraph.passes;
+		const std::vector<RenderGraphSubmission>& submissions = compiledRenderGraph.submissions;
+
+		// Every kept pass is part of exactly one submission of its queue, and the passes of a queue are submitted in execution order.
+		std::vector<uint32_t> passSubmissions(passes.size(), UINT32_MAX);
+		std::array<uint32_t, QUEUE_TYPE_COUNT> lastQueuePasses{};
+		lastQueuePasses.fill(UINT32_MAX);
+
+		// Vector clocks : the number of submissions of each queue known to have completed before a submission executes.
+		std::vector<std::array<uint32_t, QUEUE_TYPE_COUNT>> knownSubmissionCounts(submissions.size());
+		std::vector<uint32_t> queueOrdinals(submissions.size());
+		std::array<uint32_t, QUEUE_TYPE_COUNT> queueSubmissionCounts{};
+		std::array<uint32_t, QUEUE_TYPE_COUNT> lastQueueSubmissions{};
+		lastQueueSubmissions.fill(UINT32_MAX);
+
+		for (uint32_t submissionIndex = 0u; submissionIndex < submissions.size(); ++submissionIndex)
+		{
+			const RenderGraphSubmission& submission = submissions[submissionIndex];
+			const uint32_t queueIndex = static_cast<uint32_t>(submission.queueType);
+
+			queueOrdinals[submissionIndex] = queueSubmissionCounts[queueIndex]++;
+
+			// A queue executes its submissions in order, so a submission knows everything the previous one on its queue knew.
+			std::array<uint32_t, QUEUE_TYPE_COUNT>& knownCounts = knownSubmissionCounts[submissionIndex];
+			if (lastQueueSubmissions[queueIndex] != UINT32_MAX)
+			{
+				knownCounts = knownSubmissionCounts[lastQueueSubmissions[queueIndex]];
+			}
+			lastQueueSubmissions[queueIndex] = submissionIndex;
+
+			for (const uint32_t dependency : submission.dependencies)
+			{
+				if (dependency >= submissionIndex || submissions[dependency].queueType == submission.queueType)
+				{
+					return Fail("Submission " + std::to_string(submissionIndex) + " depends on submission " + std::to_string(dependency) + ", which is not an earlier submission of another queue");
+				}
+
+				for (uint32_t otherQueueIndex = 0u; otherQueueIndex < QUEUE_TYPE_COUNT; ++otherQueueIndex)
+				{
+					knownCounts[otherQueueIndex] = std::max(knownCounts[otherQueueIndex], knownSubmissionCounts[dependency][otherQueueIndex]);
+				}
+
+				const uint32_t dependencyQueueIndex = static_cast<uint32_t>(submissions[dependency].queueType);
+				knownCounts[dependencyQueueIndex] = std::max(knownCounts[dependencyQueueIndex], queueOrdinals[dependency] + 1u);
+			}
+
+			for (const RenderGraphCommandList& commandList : submission.commandLists)
+			{
+				for (const uint32_t passIndex : commandList.passes)
+				{
+					if (passIndex >= passes.size() || passSubmissions[passIndex] != UINT32_MAX || passes[passIndex].queueType != submission.queueType)
+					{
+						return Fail("Pass " + std::to_string(passIndex) + " is invalid, submitted more than once or submitted to another queue");
+					}
+
+					if (lastQueuePasses[queueIndex] != UINT32_MAX && lastQueuePasses[queueIndex] > passIndex)
+					{
+						return Fail("The passes of the " + std::string(QueueTypeToString(submission.queueType)) + " queue are not submitted in execution order");
+					}
+
+					lastQueuePasses[queueIndex] = passIndex;
+					passSubmissions[passIndex] = submissionIndex;
+				}
+			}
+		}
+
+		std::vector<bool> isPassCompiled(renderGraphDesc.passes.size());
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			if (passSubmissions[passIndex] == UINT32_MAX)
+			{
+				return Fail("Pass '" + renderGraphDesc.passes[passes[passIndex].passIndex].name + "' is not submitted");
+			}
+
+			isPassCompiled[passes[passIndex].passIndex] = true;
+		}
+
+		for (uint32_t passIndex = 0u; passIndex < renderGraphDesc.passes.size(); ++passIndex)
+		{
+			const RenderGraphPassDesc& passDesc = renderGraphDesc.passes[passIndex];
+			const bool writesOutput = std::any_of(passDesc.writes.begin(), passDesc.writes.end(), [&](const RenderGraphResourceAccess& access) { return renderGraphDesc.resources[access.resourceIndex].isOutput; });
+
+			if (!isPassCompiled[passIndex] && (passDesc.hasSideEffects || writesOutput))
+			{
+				return Fail("Pass '" + passDesc.name + "' has side effects or writes an output, but was culled");
+			}
+		}
+
+		// Pass a (in execution order) is known to complete before pass b starts.
+		const auto HappensBefore = [&](uint32_t a, uint32_t b)
+		{
+			if (passes[a].queueType == passes[b].queueType)
+			{
+				return a < b;
+			}
+
+			return queueOrdinals[passSubmissions[a]] < knownSubmissionCounts[passSubmissions[b]][static_cast<uint32_t>(passes[a].queueType)];
+		};
+
+		struct ResourceSimulation
+		{
+			RenderGraphResourceState state{};
+			uint32_t lastModifyingPass{ UINT32_MAX };
+			std::vector<uint32_t> readersSinceModification{};
+		};
+
+		std::vector<ResourceSimulation> resources(renderGraphDesc.resources.size());
+		for (uint32_t resourceIndex = 0u; resourceIndex < resources.size(); ++resourceIndex)
+		{
+			resources[resourceIndex].state = renderGraphDesc.resources[resourceIndex].initialState;
+		}
+
+		// Executes the passes one after the other, checking that every access / barrier is ordered after the ones it conflicts with (so any execution the
+		// queues / dependencies allow behaves the same).
+		const auto Modify = [&](uint32_t resourceIndex, uint32_t passIndex)
+		{
+			ResourceSimulation& resource = resources[resourceIndex];
+
+			bool isOrdered = resource.lastModifyingPass == UINT32_MAX || resource.lastModifyingPass == passIndex || HappensBefore(resource.lastModifyingPass, passIndex);
+			for (const uint32_t reader : resource.readersSinceModification)
+			{
+				isOrdered = isOrdered && (reader == passIndex || HappensBefore(reader, passIndex));
+			}
+
+			resource.lastModifyingPass = passIndex;
+			resource.readersSinceModification.clear();
+
+			return isOrdered;
+		};
+
+		const auto Read = [&](uint32_t resourceIndex, uint32_t passIndex)
+		{
+			ResourceSimulation& resource = resources[resourceIndex];
+			resource.readersSinceModification.push_back(passIndex);
+
+			return resource.lastModifyingPass == UINT32_MAX || resource.lastModifyingPass == passIndex || HappensBefore(resource.lastModifyingPass, passIndex);
+		};
+
+		for (uint32_t passIndex = 0u; passIndex < passes.size(); ++passIndex)
+		{
+			const CompiledRenderGraphPass& pass = passes[passIndex];
+			const RenderGraphPassDesc& passDesc = renderGraphDesc.passes[pass.passIndex];
+
+			const auto ExecuteBarriers = [&](const std::vector<RenderGraphBarrier>& barriers)
+			{
+				for (const RenderGraphBarrier& barrier : barriers)
+				{
+					ResourceSimulation& resource = resources[barrier.resourceIndex];
+					const std::string& resourceName = renderGraphDesc.resources[barrier.resourceIndex].name;
+
+					if (barrier.barrierType == RenderGraphBarrierType::UnorderedAccess)
+					{
+						if (resource.state != RenderGraphResourceState::UnorderedAccess)
+						{
+							return Fail("Pass '" + passDesc.name + "' has a UAV barrier of '" + resourceName + "', which is not in the unordered access state");
+						}
+					}
+					else
+					{
+						if (resource.state != barrier.stateBefore)
+						{
+							return Fail("Pass '" + passDesc.name + "' transitions '" + resourceName + "' from " + RenderGraphResourceStateToString(barrier.stateBefore) +
+								", but it is in " + RenderGraphResourceStateToString(resource.state));
+						}
+
+						if (!IsStateSupportedByQueue(barrier.stateBefore, pass.queueType) || !IsStateSupportedByQueue(barrier.stateAfter, pass.queueType))
+						{
+							return Fail("Pass '" + passDesc.name + "' transitions '" + resourceName + "' between states the " + QueueTypeToString(pass.queueType) + " queue does not support");
+						}
+
+						resource.state = barrier.stateAfter;
+					}
+
+					if (!Modify(barrier.resourceIndex, passIndex))
+					{
+						return Fail("Pass '" + passDesc.name + "' has a barrier of '" + resourceName + "' that is not ordered after the previous accesses");
+					}
+				}
+
+				return true;
+			};
+
+			if (!ExecuteBarriers(pass.beginBarriers))
+			{
+				return false;
+			}
+
+			for (const bool isWrite : { false, true })
+			{
+				for (const RenderGraphResourceAccess& access : isWrite ? passDesc.writes : passDesc.reads)
+				{
+					const ResourceSimulation& resource = resources[access.resourceIndex];
+					const std::string& resourceName = renderGraphDesc.resources[access.resourceIndex].name;
+
+					const bool isInState = isWrite ? resource.state == access.state : IsReadOnlyState(resource.state) && (resource.state & access.state) == access.state;
+					if (!isInState || !IsStateSupportedByQueue(access.state, pass.queueType))
+					{
+						return Fail("Pass '" + passDesc.name + "' accesses '" + resourceName + "' in " + RenderGraphResourceStateToString(access.state) + " on the " +
+							QueueTypeToString(pass.queueType) + " queue, but it is in " + RenderGraphResourceStateToString(resource.state));
+					}
+
+					if (!(isWrite ? Modify(access.resourceIndex, passIndex) : Read(access.resourceIndex, passIndex)))
+					{
+						return Fail("Pass '" + passDesc.name + "' accesses '" + resourceName + "' without being ordered after the previous accesses");
+					}
+				}
+			}
+
+			if (!ExecuteBarriers(pass.endBarriers))
+			{
+				return false;
+			}
+		}
+
+		for (uint32_t resourceIndex = 0u; resourceIndex < resources.size(); ++resourceIndex)
+		{
+			if (resources[resourceIndex].state != renderGraphDesc.resources[resourceIndex].finalState)
+			{
+				return Fail("Resource '" + renderGraphDesc.resources[resourceIndex].name + "' ends in " + RenderGraphResourceStateToString(resources[resourceIndex].state) +
+					" instead of " + RenderGraphResourceStateToString(renderGraphDesc.resources[resourceIndex].finalState));
+			}
+		}
+
+		return true;
+	}
+
+	std::string GenerateRenderGraphReport(const RenderGraphDesc& renderGraphDesc, const CompiledRenderGraph& compiledRenderGraph)
+	{
+		if (!compiledRenderGraph.error.empty())
+		{
+			return "Render graph failed to compile : " + compiledRenderGraph.error + "\n";
+		}
+
+		std::string report{ "Render graph report :\n" };
+
+		const auto AppendBarriers = [&](const char* label, const std::vector<RenderGraphBarrier>& barriers)
+		{
+			for (const RenderGraphBarrier& barrier : barriers)
+			{
+				const std::string& resourceName = renderGraphDesc.resources[barrier.resourceIndex].name;
+
+				if (barrier.barrierType == RenderGraphBarrierType::UnorderedAccess)
+				{
+					report += "        " + std::string(label) + " : UAV barrier of '" + resourceName + "'\n";
+				}
+				else
+				{
+					report += "        " + std::string(label) + " : '" + resourceName + "' " + RenderGraphResourceStateToString(barrier.stateBefore) + " -> " +
+						RenderGraphResourceStateToString(barrier.stateAfter) + "\n";
+				}
+			}
+		};
+
+		for (uint32_t submissionIndex = 0u; submissionIndex < compiledRenderGraph.submissions.size(); ++submissionIndex)
+		{
+			const RenderGraphSubmission& submission = compiledRenderGraph.submissions[submissionIndex];
+
+			report += "  Submission " + std::to_string(submissionIndex) + " (" + QueueTypeToString(submission.queueType) + ")";
+			for (size_t dependencyIndex = 0u; dependencyIndex < submission.dependencies.size(); ++dependencyIndex)
+			{
+				report += (dependencyIndex == 0u ? ", waits for " : ", ") + std::to_string(submission.dependencies[dependencyIndex]);
+			}
+			report += "\n";
+
+			for (size_t commandListIndex = 0u; commandListIndex < submission.commandLists.size(); ++commandListIndex)
+			{
+				report += "    Command list " + std::to_string(commandListIndex) + "\n";
+
+				for (const uint32_t passIndex : submission.commandLists[commandListIndex].passes)
+				{
+					const CompiledRenderGraphPass& pass = compiledRenderGraph.passes[passIndex];
+
+					report += "      Pass '" + renderGraphDesc.passes[pass.passIndex].name + "'\n";
+					AppendBarriers("begin", pass.beginBarriers);
+					AppendBarriers("end", pass.endBarriers);
+				}
+			}
+		}
+
+		const RenderGraphCompileStatistics& statistics = compiledRenderGraph.statistics;
+
+		char line[256]{};
+		std::snprintf(line, sizeof(line), "  Passes : %u (%u culled, %u async compute, %u moved to graphics) | Barriers : %u in %u batches (%u in %u batches without the compiler)\n",
+			statistics.passCount, statistics.culledPassCount, statistics.asyncComputePassCount, statistics.demotedPassCount, statistics.barrierCount, statistics.barrierBatchCount,
+			statistics.naiveBarrierCount, statistics.naiveBarrierBatchCount);
+		report += line;
+
+		std::snprintf(line, sizeof(line), "  Submissions : %u | Command lists : %u | Cross queue dependencies : %u\n", statistics.submissionCount, statistics.commandListCount,
+			statistics.crossQueueDependencyCount);
+		report += line;
+
+		return report;
+	}
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+// The RenderGraph (see RenderGraph.hpp) maps the states to D3D12 and records / submits the compiled passes.
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "QueueScheduler.hpp"
+
+namespace helios::gfx
+{
+	// Mirrors D3D12_RESOURCE_STATES. States are bit flags, so read only states can be combined into a single state (a resource in a combined state can be
+	// read in any of them without further transitions).
+	enum class RenderGraphResourceState : uint32_t
+	{
+		Common = 0u,
+		RenderTarget = 1u << 0u,
+		UnorderedAccess = 1u << 1u,
+		DepthWrite = 1u << 2u,
+		DepthRead = 1u << 3u,
+		NonPixelShaderResource = 1u << 4u,
+		PixelShaderResource = 1u << 5u,
+		CopyDestination = 1u << 6u,
+		CopySource = 1u << 7u,
+		Present = Common,
+	};
+
+	constexpr RenderGraphResourceState operator|(RenderGraphResourceState a, RenderGraphResourceState b) { return static_cast<RenderGraphResourceState>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b)); }
+	constexpr RenderGraphResourceState operator&(RenderGraphResourceState a, RenderGraphResourceState b) { return static_cast<RenderGraphResourceState>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b)); }
+
+	// Combined states are printed as their flags separated by '|'.
+	std::string RenderGraphResourceStateToString(RenderGraphResourceState state);
+
+	bool IsReadOnlyState(RenderGraphResourceState state);
+
+	// Compute command lists can neither use nor transition resources in graphics only states (render target, depth and pixel shader resource).
+	bool IsStateSupportedByQueue(RenderGraphResourceState state, QueueType queueType);
+
+	struct RenderGraphResourceDesc
+	{
+		std::string name{};
+
+		// The state the resource is in before the graph executes, and the state it is left in afterwards.
+		RenderGraphResourceState initialState{};
+		RenderGraphResourceState finalState{};
+
+		// Used outside of the graph (i.e the back buffer) : the passes writing it (and the passes those depend on) are never culled.
+		bool isOutput{};
+	};
+
+	// Queue a pass would like to run on. Async compute passes run on the compute queue unless that is impossible (see CompileRenderGraph).
+	enum class RenderGraphPassQueue : uint32_t
+	{
+		Graphics,
+		AsyncCompute,
+	};
+
+	struct RenderGraphResourceAccess
+	{
+		uint32_t resourceIndex{};
+		RenderGraphResourceState state{};
+	};
+
+	struct RenderGraphPassDesc
+	{
+		// Reads must be in read only states, and writes in a single write state. A pass may read a resource in several states (which are combined),
+		// but may not read and write the same resource.
+		RenderGraphPassDesc& Read(uint32_t resourceIndex, RenderGraphResourceState state);
+		RenderGraphPassDesc& Write(uint32_t resourceIndex, RenderGraphResourceState state);
+
+		std::string name{};
+		RenderGraphPassQueue queue{};
+
+		std::vector<RenderGraphResourceAccess> reads{};
+		std::vector<RenderGraphResourceAccess> writes{};
+
+		// For passes with effects outside of the declared resources (i.e read backs), which are never culled.
+		bool hasSideEffects{};
+	};
+
+	// Passes access resources in the order they are added : a pass reads what the last pass (added before it) writing the resource wrote.
+	// Writes are assumed to preserve the rest of the resource, so a pass writing a resource depends on the previous writer as well.
+	struct RenderGraphDesc
+	{
+		// Return the index of the resource / pass.
+		uint32_t AddResource(const RenderGraphResourceDesc& resourceDesc);
+		uint32_t AddPass(const RenderGraphPassDesc& passDesc);
+
+		std::vector<RenderGraphResourceDesc> resources{};
+		std::vector<RenderGraphPassDesc> passes{};
+	};
+
+	struct RenderGraphCompileOptions
+	{
+		bool isCullingEnabled{ true };
+		bool isAsyncComputeEnabled{ true };
+
+		// Passes of a submission are split into command lists of at most this many passes, so the command lists can be recorded in parallel.
+		uint32_t maxPassesPerCommandList{ UINT32_MAX };
+	};
+
+	enum class RenderGraphBarrierType : uint32_t
+	{
+		Transition,
+		UnorderedAccess,
+	};
+
+	struct RenderGraphBarrier
+	{
+		RenderGraphBarrierType barrierType{};
+		uint32_t resourceIndex{};
+		RenderGraphResourceState stateBefore{};
+		RenderGraphResourceState stateAfter{};
+	};
+
+	struct CompiledRenderGraphPass
+	{
+		// Index into RenderGraphDesc::passes.
+		uint32_t passIndex{};
+		QueueType queueType{};
+
+		// Each list is executed as a single batch, before / after the pass records its commands.
+		std::vector<RenderGraphBarrier> beginBarriers{};
+		std::vector<RenderGraphBarrier> endBarriers{};
+	};
+
+	// Passes (indices into CompiledRenderGraph::passes, in execution order) recorded into a single command list.
+	struct RenderGraphCommandList
+	{
+		std::vector<uint32_t> passes{};
+	};
+
+	struct RenderGraphSubmission
+	{
+		QueueType queueType{};
+		std::vector<RenderGraphCommandList> commandLists{};
+
+		// Indices of earlier submissions (on other queues) that must complete before this submission executes.
+		std::vector<uint32_t> dependencies{};
+	};
+
+	struct RenderGraphCompileStatistics
+	{
+		uint32_t passCount{};
+		uint32_t culledPassCount{};
+		uint32_t asyncComputePassCount{};
+
+		// Async compute passes that run on the graphics queue, as a transition they require can not be performed on the compute queue.
+		uint32_t demotedPassCount{};
+
+		uint32_t barrierCount{};
+		uint32_t barrierBatchCount{};
+
+		// Transitions (and batches) there would be if every access transitioned the resource into exactly its state, at the start of its pass.
+		uint32_t naiveBarrierCount{};
+		uint32_t naiveBarrierBatchCount{};
+
+		uint32_t commandListCount{};
+		uint32_t submissionCount{};
+		uint32_t crossQueueDependencyCount{};
+	};
+
+	struct CompiledRenderGraph
+	{
+		// In execution order, excluding the culled passes.
+		std::vector<CompiledRenderGraphPass> passes{};
+
+		// In submission order.
+		std::vector<RenderGraphSubmission> submissions{};
+
+		RenderGraphCompileStatistics statistics{};
+
+		// Empty if the graph compiled. Otherwise, describes the first invalid pass / access found (and the passes / submissions are empty).
+		std::string error{};
+	};
+
+	// Compiles the graph in the following steps :
+	// (i) Dependencies : each pass depends on the last writer of the resources it accesses, and writers depend on the readers since the last write.
+	// (ii) Culling : passes that neither have side effects nor (transitively) contribute to an output resource are removed.
+	// (iii) Queues : async compute passes are placed on the compute queue if all their states are supported by it.
+	// (iv) Ordering : a topological sort of the dependencies, which schedules async compute passes as early as possible and keeps the declaration order otherwise.
+	// (v) Barriers : consecutive reads of a resource share a single transition into the combined read state. A transition is placed at the start of the accesses
+	// requiring it if they run on a single queue supporting it, and otherwise at the end of the previous accesses of the resource (which they all wait for).
+	// If neither is possible, the async compute passes involved are moved to the graphics queue and the graph is scheduled again.
+	// The end barriers of a pass and the begin barriers of the next pass of the same command list are merged into a single batch.
+	// (vi) Grouping : consecutive passes of a queue form a submission, which is split when a pass waits for another queue's work, or when another queue
+	// waits for the submission's work.
+	CompiledRenderGraph CompileRenderGraph(const RenderGraphDesc& renderGraphDesc, const RenderGraphCompileOptions& compileOptions = {});
+
+	// Simulates the execution of the compiled graph and returns false (with the reason in error, if not null) if any access happens in a state the resource is not in,
+	// a barrier's state before does not match, a queue uses a state it does not support, a resource does not end in its final state, or two accesses of a resource
+	// that are not both reads are not ordered by the queues / submission dependencies.
+	bool ValidateCompiledRenderGraph(const RenderGraphDesc& renderGraphDesc, const CompiledRenderGraph& compiledRenderGraph, std::string* error = nullptr);
+
+	// Human readable table of the submissions, command lists, passes and their barriers.
+	std::string GenerateRenderGraphReport(const RenderGraphDesc& renderGraphDesc, const CompiledRenderGraph& compiledRenderGraph);
+}
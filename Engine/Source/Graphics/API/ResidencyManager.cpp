@@ -0,0 +1,73 @@
+#include "ResidencyManager.hpp"
+
+#include "CommandQueue.hpp"
+#include "MemoryAllocator.hpp"
+
+namespace helios::gfx
+{
+	static std::vector<ID3D12Pageable*> GetPageables(std::span<void* const> resources)
+	{
+		std::vector<ID3D12Pageable*> pageables{};
+		pageables.reserve(resources.size());
+
+		for (void* resource : resources)
+		{
+			pageables.push_back(static_cast<ID3D12Pageable*>(resource));
+		}
+
+		return pageables;
+	}
+
+	ResidencyManager::ResidencyManager(ID3D12Device5* device, MemoryAllocator* memoryAllocator, uint64_t framesInFlight) : mDevice(device), mMemoryAllocator(memoryAllocator)
+	{
+		mResidencyPolicy = std::make_shared<ResidencyPolicy>(ResidencyPolicyDesc{ .framesInFlight = framesInFlight });
+
+		ThrowIfFailed(mDevice->CreateFence(mResidencyFenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mResidencyFence)));
+		mResidencyFence->SetName(L"Residency Fence");
+	}
+
+	void ResidencyManager::RegisterAllocation(Allocation* allocation)
+	{
+		if (!allocation || !allocation->allocation || allocation->allocation->GetHeap() != nullptr)
+		{
+			return;
+		}
+
+		ID3D12Pageable* pageable = allocation->resource.Get();
+		allocation->residencyHandle = mResidencyPolicy->RegisterResource(pageable, allocation->allocation->GetSize());
+	}
+
+	void ResidencyManager::MakeResident(std::span<const uint64_t> resourceIds, CommandQueue* commandQueue)
+	{
+		if (resourceIds.empty())
+		{
+			return;
+		}
+
+		mResidencyPolicy->MarkUsed(resourceIds, [&](std::span<void* const> resources)
+		{
+			const std::vector<ID3D12Pageable*> pageables = GetPageables(resources);
+
+			// EnqueueMakeResident does not block the CPU : the GPU wait ensures the command lists executed after this point do not access the resources before they are resident.
+			mResidencyFenceValue++;
+			ThrowIfFailed(mDevice->EnqueueMakeResident(D3D12_RESIDENCY_FLAG_NONE, static_cast<UINT>(pageables.size()), pageables.data(), mResidencyFence.Get(), mResidencyFenceValue));
+			ThrowIfFailed(commandQueue->GetCommandQueue()->Wait(mResidencyFence.Get(), mResidencyFenceValue));
+
+			core::LogMessage(L"Made " + std::to_wstring(pageables.size()) + L" evicted resource(s) resident", core::LogMessageTypes::Info);
+		});
+	}
+
+	void ResidencyManager::EndFrame()
+	{
+		const MemoryBudget localBudget = mMemoryAllocator->GetLocalBudget();
+
+		mResidencyPolicy->EndFrame(localBudget.usageInBytes, localBudget.budgetInBytes, [&](std::span<void* const> resources)
+		{
+			const std::vector<ID3D12Pageable*> pageables = GetPageables(resources);
+
+			ThrowIfFailed(mDevice->Evict(static_cast<UINT>(pageables.size()), pageables.data()));
+
+			core::LogMessage(L"Evicted " + std::to_wstring(pageables.size()) + L" resource(s) to stay within the video memory budget", core::LogMessageTypes::Info);
+		});
+	}
+}
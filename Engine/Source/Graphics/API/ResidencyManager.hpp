@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Resources.hpp"
+#include "ResidencyPolicy.hpp"
+
+namespace helios::gfx
+{
+	class CommandQueue;
+	class MemoryAllocator;
+
+	// Keeps the local (video) memory usage below the budget by evicting the least recently used resources, and makes them resident again before they are next used.
+	// Resources are marked as used when they are bound through the contexts (see Context::TrackResidency). The LRU / budget decisions are made by the ResidencyPolicy.
+	class ResidencyManager
+	{
+	public:
+		ResidencyManager(ID3D12Device5* device, MemoryAllocator* memoryAllocator, uint64_t framesInFlight);
+
+		// Only committed resources can be evicted individually (placed resources share residency with the rest of their heap), so other allocations are not registered.
+		void RegisterAllocation(Allocation* allocation);
+
+		// Makes the evicted resources among resourceIds resident, and makes the command queue wait (on the GPU) until that has completed.
+		// Must be called before the command lists using the resources are executed.
+		void MakeResident(std::span<const uint64_t> resourceIds, CommandQueue* commandQueue);
+
+		// Evicts the least recently used resources if the local memory usage approaches the budget. To be called once per frame, after the frame's work is submitted.
+		void EndFrame();
+
+		ResidencyStatistics GetStatistics() const { return mResidencyPolicy->GetStatistics(); }
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12Device5> mDevice{};
+		MemoryAllocator* mMemoryAllocator{};
+
+		std::shared_ptr<ResidencyPolicy> mResidencyPolicy{};
+
+		// Signalled by EnqueueMakeResident once the resources are resident. Only accessed with the policy's lock held (from within the residency callbacks).
+		Microsoft::WRL::ComPtr<ID3D12Fence> mResidencyFence{};
+		uint64_t mResidencyFenceValue{};
+	};
+}
@@ -0,0 +1,255 @@
+#include "ResidencyPolicy.hpp"
+
+#include <algorithm>
+
+namespace helios::gfx
+{
+	double ResidencyStatistics::GetChurnRatio() const
+	{
+		if (totalEvictionCount == 0u)
+		{
+			return 0.0;
+		}
+
+		return static_cast<double>(churnCount) / static_cast<double>(totalEvictionCount);
+	}
+
+	ResidencyPolicy::ResidencyPolicy(const ResidencyPolicyDesc& residencyPolicyDesc) : mResidencyPolicyDesc(residencyPolicyDesc)
+	{
+	}
+
+	ResidencyHandle ResidencyPolicy::RegisterResource(void* userData, uint64_t sizeInBytes)
+	{
+		uint64_t resourceId{};
+
+		{
+			std::lock_guard<std::mutex> lockGuard(mMutex);
+
+			resourceId = mNextResourceId++;
+			mResourceRecords[resourceId] = ResourceRecord
+			{
+				.userData = userData,
+				.sizeInBytes = sizeInBytes,
+				.lastUsedFrame = mFrameIndex,
+			};
+		}
+
+		std::weak_ptr<ResidencyPolicy> residencyPolicy = weak_from_this();
+
+		return ResidencyHandle(new uint64_t(resourceId), [residencyPolicy](const uint64_t* resourceId)
+		{
+			if (std::shared_ptr<ResidencyPolicy> policy = residencyPolicy.lock())
+			{
+				policy->UnregisterResource(*resourceId);
+			}
+
+			delete resourceId;
+		});
+	}
+
+	void ResidencyPolicy::UnregisterResource(uint64_t resourceId)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		auto resourceRecord = mResourceRecords.find(resourceId);
+		if (resourceRecord == mResourceRecords.end())
+		{
+			return;
+		}
+
+		if (resourceRecord->second.isResident && resourceRecord->second.isTracked)
+		{
+			mLruList.erase(resourceRecord->second.lruIterator);
+		}
+
+		mResourceRecords.erase(resourceRecord);
+	}
+
+	void ResidencyPolicy::MarkUsed(std::span<const uint64_t> resourceIds, const ResidencyCallback& makeResident)
+	{
+		std::vector<void*> resourcesToMakeResident{};
+
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		for (const uint64_t& resourceId : resourceIds)
+		{
+			auto resourceRecordIterator = mResourceRecords.find(resourceId);
+			if (resourceRecordIterator == mResourceRecords.end())
+			{
+				continue;
+			}
+
+			ResourceRecord& resourceRecord = resourceRecordIterator->second;
+			resourceRecord.lastUsedFrame = mFrameIndex;
+
+			if (!resourceRecord.isResident)
+			{
+				resourcesToMakeResident.push_back(resourceRecord.userData);
+
+				resourceRecord.isResident = true;
+				resourceRecord.isTracked = true;
+				resourceRecord.lruIterator = mLruList.insert(mLruList.begin(), resourceId);
+
+				mCurrentFrameMakeResidentCount++;
+				mStatistics.totalMakeResidentCount++;
+				mStatistics.totalMadeResidentBytes += resourceRecord.sizeInBytes;
+
+				if (mFrameIndex - resourceRecord.evictedFrame <= mResidencyPolicyDesc.churnFrameWindow)
+				{
+					mStatistics.churnCount++;
+					mStatistics.churnBytes += resourceRecord.sizeInBytes;
+				}
+			}
+			else if (resourceRecord.isTracked)
+			{
+				mLruList.splice(mLruList.begin(), mLruList, resourceRecord.lruIterator);
+			}
+			else
+			{
+				resourceRecord.isTracked = true;
+				resourceRecord.lruIterator = mLruList.insert(mLruList.begin(), resourceId);
+			}
+		}
+
+		if (!resourcesToMakeResident.empty() && makeResident)
+		{
+			makeResident(resourcesToMakeResident);
+		}
+	}
+
+	void ResidencyPolicy::EndFrame(uint64_t usageInBytes, uint64_t budgetInBytes, const ResidencyCallback& evict)
+	{
+		std::vector<void*> resourcesToEvict{};
+
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		const double evictionThresholdBytes = static_cast<double>(budgetInBytes) * mResidencyPolicyDesc.evictionThreshold;
+		const double evictionTargetBytes = static_cast<double>(budgetInBytes) * mResidencyPolicyDesc.evictionTarget;
+
+		if (static_cast<double>(usageInBytes) > evictionThresholdBytes)
+		{
+			// Walk from the least recently used resource, stopping at the first one that may still be in use by the GPU (all following ones were used more recently).
+			while (!mLruList.empty() && static_cast<double>(usageInBytes) > evictionTargetBytes)
+			{
+				const uint64_t resourceId = mLruList.back();
+				ResourceRecord& resourceRecord = mResourceRecords[resourceId];
+
+				if (resourceRecord.lastUsedFrame + mResidencyPolicyDesc.framesInFlight > mFrameIndex)
+				{
+					break;
+				}
+
+				mLruList.pop_back();
+
+				resourceRecord.isResident = false;
+				resourceRecord.evictedFrame = mFrameIndex;
+
+				resourcesToEvict.push_back(resourceRecord.userData);
+
+				usageInBytes -= std::min(usageInBytes, resourceRecord.sizeInBytes);
+
+				mCurrentFrameEvictionCount++;
+				mStatistics.totalEvictionCount++;
+				mStatistics.totalEvictedBytes += resourceRecord.sizeInBytes;
+			}
+		}
+
+		if (!resourcesToEvict.empty() && evict)
+		{
+			evict(resourcesToEvict);
+		}
+
+		mStatistics.frameEvictionCount = mCurrentFrameEvictionCount;
+		mStatistics.frameMakeResidentCount = mCurrentFrameMakeResidentCount;
+
+		mCurrentFrameEvictionCount = 0u;
+		mCurrentFrameMakeResidentCount = 0u;
+
+		mFrameIndex++;
+	}
+
+	uint64_t ResidencyPolicy::GetFrameIndex() const
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		return mFrameIndex;
+	}
+
+	ResidencyStatistics ResidencyPolicy::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		ResidencyStatistics statistics = mStatistics;
+		statistics.resourceCount = static_cast<uint32_t>(mResourceRecords.size());
+
+		for (const auto& [resourceId, resourceRecord] : mResourceRecords)
+		{
+			if (resourceRecord.isResident)
+			{
+				statistics.residentResourceCount++;
+				statistics.residentBytes += resourceRecord.sizeInBytes;
+			}
+			else
+			{
+				statistics.evictedBytes += resourceRecord.sizeInBytes;
+			}
+		}
+
+		return statistics;
+	}
+
+	ResidencyTraceResult SimulateResidencyTrace(const ResidencyTrace& residencyTrace, uint64_t budgetInBytes, const ResidencyPolicyDesc& residencyPolicyDesc)
+	{
+		std::shared_ptr<ResidencyPolicy> residencyPolicy = std::make_shared<ResidencyPolicy>(residencyPolicyDesc);
+
+		// The user data of each resource is a pointer to its resident flag, so the simulated usage can be kept in sync with the callbacks.
+		std::vector<ResidencyHandle> residencyHandles{};
+		std::vector<uint64_t> resourceIds{};
+		std::unique_ptr<bool[]> isResident = std::make_unique<bool[]>(residencyTrace.resourceSizes.size());
+
+		uint64_t usageInBytes{};
+
+		for (size_t i = 0; i < residencyTrace.resourceSizes.size(); ++i)
+		{
+			isResident[i] = true;
+			usageInBytes += residencyTrace.resourceSizes[i];
+
+			residencyHandles.push_back(residencyPolicy->RegisterResource(&isResident[i], residencyTrace.resourceSizes[i]));
+			resourceIds.push_back(*residencyHandles.back());
+		}
+
+		const auto setResidency = [&](std::span<void* const> resources, bool resident)
+		{
+			for (void* resource : resources)
+			{
+				bool* resourceIsResident = static_cast<bool*>(resource);
+				const size_t resourceIndex = static_cast<size_t>(resourceIsResident - isResident.get());
+
+				*resourceIsResident = resident;
+				usageInBytes = resident ? usageInBytes + residencyTrace.resourceSizes[resourceIndex] : usageInBytes - residencyTrace.resourceSizes[resourceIndex];
+			}
+		};
+
+		ResidencyTraceResult residencyTraceResult{};
+
+		std::vector<uint64_t> frameResourceIds{};
+		for (const std::vector<uint32_t>& frame : residencyTrace.frames)
+		{
+			frameResourceIds.clear();
+			for (const uint32_t& resourceIndex : frame)
+			{
+				frameResourceIds.push_back(resourceIds[resourceIndex]);
+			}
+
+			residencyPolicy->MarkUsed(frameResourceIds, [&](std::span<void* const> resources) { setResidency(resources, true); });
+			residencyTraceResult.peakUsageInBytes = std::max(residencyTraceResult.peakUsageInBytes, usageInBytes);
+
+			residencyPolicy->EndFrame(usageInBytes, budgetInBytes, [&](std::span<void* const> resources) { setResidency(resources, false); });
+			residencyTraceResult.peakEndOfFrameUsageInBytes = std::max(residencyTraceResult.peakEndOfFrameUsageInBytes, usageInBytes);
+			residencyTraceResult.overBudgetFrameCount += usageInBytes > budgetInBytes ? 1u : 0u;
+		}
+
+		residencyTraceResult.statistics = residencyPolicy->GetStatistics();
+
+		return residencyTraceResult;
+	}
+}
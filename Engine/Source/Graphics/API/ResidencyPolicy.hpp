@@ -0,0 +1,133 @@
+#pragma once
+
+// The ResidencyManager drives it with the resources bound through the contexts, and performs the actual MakeResident / Evict calls.
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace helios::gfx
+{
+	struct ResidencyPolicyDesc
+	{
+		// Eviction starts once usage exceeds evictionThreshold * budget, and evicts the coldest resources until usage is below evictionTarget * budget.
+		double evictionThreshold{ 0.95 };
+		double evictionTarget{ 0.85 };
+
+		// Resources used within the last framesInFlight frames may still be referenced by the GPU, so they are never evicted.
+		uint64_t framesInFlight{ 3u };
+
+		// A resource that has to be made resident again within churnFrameWindow frames of being evicted counts as churn.
+		uint64_t churnFrameWindow{ 60u };
+	};
+
+	struct ResidencyStatistics
+	{
+		uint32_t resourceCount{};
+		uint32_t residentResourceCount{};
+		uint64_t residentBytes{};
+		uint64_t evictedBytes{};
+
+		// Of the last completed frame.
+		uint32_t frameEvictionCount{};
+		uint32_t frameMakeResidentCount{};
+
+		uint64_t totalEvictionCount{};
+		uint64_t totalMakeResidentCount{};
+		uint64_t totalEvictedBytes{};
+		uint64_t totalMadeResidentBytes{};
+
+		uint64_t churnCount{};
+		uint64_t churnBytes{};
+
+		// Fraction of evictions that had to be undone shortly after. Values close to 1.0 mean the working set does not fit in the budget (i.e thrashing).
+		double GetChurnRatio() const;
+	};
+
+	// The resource remains registered until all copies of the handle are destroyed / reset (same semantics as MemoryStatisticsHandle).
+	using ResidencyHandle = std::shared_ptr<const uint64_t>;
+
+	// Receives the user data of the resources to make resident / evict. Invoked with the policy's lock held, so the user data stays valid for the duration of the call.
+	using ResidencyCallback = std::function<void(std::span<void* const> resources)>;
+
+	// Tracks the last used frame of each registered resource, and picks the least recently used ones for eviction when usage approaches the budget.
+	// Resources only become candidates for eviction once they have been marked as used at least once, so resources whose usage is not tracked are never evicted.
+	class ResidencyPolicy : public std::enable_shared_from_this<ResidencyPolicy>
+	{
+	public:
+		explicit ResidencyPolicy(const ResidencyPolicyDesc& residencyPolicyDesc = {});
+
+		// Must be called on a ResidencyPolicy object owned by a std::shared_ptr (handles only hold a weak reference to it).
+		// Resources are resident when registered.
+		ResidencyHandle RegisterResource(void* userData, uint64_t sizeInBytes);
+
+		// Marks the resources as used in the current frame. Evicted resources among them are passed to makeResident, and are considered resident after the call.
+		void MarkUsed(std::span<const uint64_t> resourceIds, const ResidencyCallback& makeResident);
+
+		// usageInBytes is the total usage of the memory segment (including resources not tracked by the policy).
+		// If required, passes the resources to evict to the callback, then advances to the next frame.
+		void EndFrame(uint64_t usageInBytes, uint64_t budgetInBytes, const ResidencyCallback& evict);
+
+		uint64_t GetFrameIndex() const;
+		ResidencyStatistics GetStatistics() const;
+
+	private:
+		struct ResourceRecord
+		{
+			void* userData{};
+			uint64_t sizeInBytes{};
+
+			uint64_t lastUsedFrame{};
+			uint64_t evictedFrame{};
+
+			bool isResident{ true };
+			bool isTracked{};
+
+			// Only valid if the resource is resident and tracked.
+			std::list<uint64_t>::iterator lruIterator{};
+		};
+
+		void UnregisterResource(uint64_t resourceId);
+
+	private:
+		ResidencyPolicyDesc mResidencyPolicyDesc{};
+
+		mutable std::mutex mMutex{};
+
+		std::unordered_map<uint64_t, ResourceRecord> mResourceRecords{};
+		uint64_t mNextResourceId{ 1u };
+
+		// Resident tracked resources, most recently used first. As MarkUsed always moves resources to the front, the list is sorted by last used frame.
+		std::list<uint64_t> mLruList{};
+
+		uint64_t mFrameIndex{};
+
+		ResidencyStatistics mStatistics{};
+		uint32_t mCurrentFrameEvictionCount{};
+		uint32_t mCurrentFrameMakeResidentCount{};
+	};
+
+	// Simulated workload : frames[i] is the list of resources (indices into resourceSizes) used in frame i.
+	struct ResidencyTrace
+	{
+		std::vector<uint64_t> resourceSizes{};
+		std::vector<std::vector<uint32_t>> frames{};
+	};
+
+	struct ResidencyTraceResult
+	{
+		ResidencyStatistics statistics{};
+
+		// Budget compliance : the usage once the resources of a frame are made resident (before eviction), and at the end of the frame (after eviction).
+		uint64_t peakUsageInBytes{};
+		uint64_t peakEndOfFrameUsageInBytes{};
+		uint32_t overBudgetFrameCount{};
+	};
+
+	// Replays the trace against a policy, with the resident bytes of the trace's resources as the usage.
+	ResidencyTraceResult SimulateResidencyTrace(const ResidencyTrace& residencyTrace, uint64_t budgetInBytes, const ResidencyPolicyDesc& residencyPolicyDesc = {});
+}
@@ -0,0 +1,497 @@
+#include "ResourceStateTracker.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace helios::gfx
+{
+	static bool IsReadOnlyState(uint32_t state)
+	{
+		return state != 0u && (state & ~READ_ONLY_RESOURCE_STATES) == 0u;
+	}
+
+	// Returns true if a resource in currentState can be used in requestedState without a transition.
+	static bool IsStateCovered(uint32_t currentState, uint32_t requestedState)
+	{
+		return currentState == requestedState || (IsReadOnlyState(currentState) && IsReadOnlyState(requestedState) && (requestedState & ~currentState) == 0u);
+	}
+
+	void ResourceStateTracker::TransitionResource(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount)
+	{
+		TransitionResource(resource, state, subresource, subresourceCount, TransitionType::Regular);
+	}
+
+	void ResourceStateTracker::BeginResourceTransition(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount)
+	{
+		TransitionResource(resource, state, subresource, subresourceCount, TransitionType::Begin);
+	}
+
+	void ResourceStateTracker::AddResourceBarrier(const ResourceBarrierCommand& barrier, uint32_t subresourceCount)
+	{
+		switch (barrier.barrierType)
+		{
+			case BarrierType::Transition:
+			{
+				const uint32_t trackedState = GetResourceState(barrier.resource, barrier.subresource);
+				if (trackedState != UNKNOWN_RESOURCE_STATE && trackedState != barrier.stateBefore)
+				{
+					mStatistics.correctedTransitionCount++;
+				}
+
+				SetInitialResourceState(barrier.resource, barrier.stateBefore, barrier.subresource, subresourceCount);
+
+				// The end of a split transition is requested like any transition to its state after.
+				TransitionResource(barrier.resource, barrier.stateAfter, barrier.subresource, subresourceCount, barrier.split == BarrierSplit::Begin ? TransitionType::Begin : TransitionType::Regular);
+			}break;
+
+			case BarrierType::Aliasing:
+			{
+				mPendingBarriers.push_back(barrier);
+				mStatistics.aliasingBarrierCount++;
+			}break;
+
+			case BarrierType::UnorderedAccess:
+			{
+				mPendingBarriers.push_back(barrier);
+				mStatistics.uavBarrierCount++;
+			}break;
+		}
+	}
+
+	void ResourceStateTracker::EndResourceTransitions()
+	{
+		for (auto& [resource, resourceState] : mResourceStates)
+		{
+			for (uint32_t i = 0u; i < resourceState.size(); i++)
+			{
+				if (resourceState[i].splitState != UNKNOWN_RESOURCE_STATE)
+				{
+					EndSubresourceTransition(resource, resourceState.size() == 1u ? ALL_SUBRESOURCES : i, resourceState[i]);
+				}
+			}
+		}
+	}
+
+	void ResourceStateTracker::ClearPendingBarriers()
+	{
+		if (!mPendingBarriers.empty())
+		{
+			mStatistics.barrierBatchCount++;
+			mPendingBarriers.clear();
+		}
+	}
+
+	uint32_t ResourceStateTracker::GetResourceState(CommandHandle resource, uint32_t subresource) const
+	{
+		auto resourceStateIterator = mResourceStates.find(resource);
+		if (resourceStateIterator == mResourceStates.end())
+		{
+			return UNKNOWN_RESOURCE_STATE;
+		}
+
+		const ResourceState& resourceState = resourceStateIterator->second;
+		if (resourceState.size() == 1u)
+		{
+			return resourceState.front().state;
+		}
+
+		if (subresource != ALL_SUBRESOURCES)
+		{
+			return subresource < resourceState.size() ? resourceState[subresource].state : UNKNOWN_RESOURCE_STATE;
+		}
+
+		const bool isUniform = std::ranges::all_of(resourceState, [&](const SubresourceState& subresourceState) { return subresourceState.state == resourceState.front().state; });
+		return isUniform ? resourceState.front().state : UNKNOWN_RESOURCE_STATE;
+	}
+
+	void ResourceStateTracker::TransitionResource(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount, TransitionType transitionType)
+	{
+		ResourceState& resourceState = mResourceStates[resource];
+		if (resourceState.empty())
+		{
+			resourceState.resize(1u);
+		}
+
+		if (subresource != ALL_SUBRESOURCES)
+		{
+			ExpandResourceState(resource, resourceState, subresourceCount);
+			TransitionSubresource(resource, subresource, resourceState[subresource], state, transitionType);
+
+			return;
+		}
+
+		if (resourceState.size() == 1u)
+		{
+			TransitionSubresource(resource, ALL_SUBRESOURCES, resourceState.front(), state, transitionType);
+
+			return;
+		}
+
+		for (uint32_t i = 0u; i < resourceState.size(); i++)
+		{
+			TransitionSubresource(resource, i, resourceState[i], state, transitionType);
+		}
+
+		// Once all subresources are in the same state again, they can be transitioned with a single barrier. This is not possible while split transitions
+		// are in flight, as their end barriers must be recorded per subresource.
+		const bool isUniform = std::ranges::all_of(resourceState, [&](const SubresourceState& subresourceState)
+		{
+			return subresourceState.state == resourceState.front().state && subresourceState.splitState == UNKNOWN_RESOURCE_STATE;
+		});
+
+		if (isUniform)
+		{
+			resourceState.resize(1u);
+		}
+	}
+
+	void ResourceStateTracker::TransitionSubresource(CommandHandle resource, uint32_t subresource, SubresourceState& subresourceState, uint32_t state, TransitionType transitionType)
+	{
+		bool isSplitTransitionEnded{ false };
+		if (subresourceState.splitState != UNKNOWN_RESOURCE_STATE)
+		{
+			EndSubresourceTransition(resource, subresource, subresourceState);
+			isSplitTransitionEnded = true;
+		}
+
+		if (subresourceState.state == UNKNOWN_RESOURCE_STATE)
+		{
+			if (transitionType == TransitionType::Regular)
+			{
+				mPendingTransitions.push_back(PendingTransition
+				{
+					.resource = resource,
+					.subresource = subresource,
+					.state = state,
+				});
+
+				subresourceState.state = state;
+			}
+
+			return;
+		}
+
+		if (IsStateCovered(subresourceState.state, state))
+		{
+			// Ending the split transition was the transition that was requested.
+			if (!isSplitTransitionEnded)
+			{
+				mStatistics.redundantTransitionCount++;
+			}
+
+			return;
+		}
+
+		// Read only states can be combined, so the resource does not have to be transitioned back when it is read in its previous state again.
+		const uint32_t newState = IsReadOnlyState(subresourceState.state) && IsReadOnlyState(state) ? subresourceState.state | state : state;
+
+		if (transitionType == TransitionType::Begin)
+		{
+			AddTransition(resource, subresource, subresourceState.state, newState, BarrierSplit::Begin);
+			subresourceState.splitState = newState;
+		}
+		else
+		{
+			AddTransition(resource, subresource, subresourceState.state, newState, BarrierSplit::None);
+			subresourceState.state = newState;
+		}
+	}
+
+	void ResourceStateTracker::EndSubresourceTransition(CommandHandle resource, uint32_t subresource, SubresourceState& subresourceState)
+	{
+		const uint32_t splitState = std::exchange(subresourceState.splitState, UNKNOWN_RESOURCE_STATE);
+
+		// Begin barriers still pending were recorded after the last work command : the split would not overlap with any work.
+		auto beginBarrier = std::ranges::find_if(mPendingBarriers, [&](const ResourceBarrierCommand& barrier)
+		{
+			return barrier.barrierType == BarrierType::Transition && barrier.resource == resource && barrier.subresource == subresource && barrier.split == BarrierSplit::Begin;
+		});
+
+		if (beginBarrier != mPendingBarriers.end())
+		{
+			beginBarrier->split = BarrierSplit::None;
+			mStatistics.mergedTransitionCount++;
+		}
+		else
+		{
+			mPendingBarriers.push_back(ResourceBarrierCommand
+			{
+				.barrierType = BarrierType::Transition,
+				.stateBefore = subresourceState.state,
+				.stateAfter = splitState,
+				.resource = resource,
+				.subresource = subresource,
+				.split = BarrierSplit::End,
+			});
+
+			mStatistics.splitTransitionCount++;
+		}
+
+		subresourceState.state = splitState;
+	}
+
+	void ResourceStateTracker::AddTransition(CommandHandle resource, uint32_t subresource, uint32_t stateBefore, uint32_t stateAfter, BarrierSplit split)
+	{
+		// Only the last pending barrier referencing the resource can be merged with, as the barriers of a batch are executed in order.
+		auto lastBarrier = std::find_if(mPendingBarriers.rbegin(), mPendingBarriers.rend(), [&](const ResourceBarrierCommand& barrier)
+		{
+			return barrier.resource == resource || barrier.resourceAfter == resource || (barrier.barrierType != BarrierType::Transition && barrier.resource == 0u);
+		});
+
+		const bool canMerge = split == BarrierSplit::None && lastBarrier != mPendingBarriers.rend() && lastBarrier->barrierType == BarrierType::Transition &&
+			lastBarrier->resource == resource && lastBarrier->subresource == subresource && lastBarrier->split == BarrierSplit::None && lastBarrier->stateAfter == stateBefore;
+
+		if (canMerge)
+		{
+			mStatistics.mergedTransitionCount++;
+
+			if (lastBarrier->stateBefore == stateAfter)
+			{
+				mPendingBarriers.erase(std::next(lastBarrier).base());
+				mStatistics.transitionCount--;
+			}
+			else
+			{
+				lastBarrier->stateAfter = stateAfter;
+			}
+
+			return;
+		}
+
+		mPendingBarriers.push_back(ResourceBarrierCommand
+		{
+			.barrierType = BarrierType::Transition,
+			.stateBefore = stateBefore,
+			.stateAfter = stateAfter,
+			.resource = resource,
+			.subresource = subresource,
+			.split = split,
+		});
+
+		mStatistics.transitionCount++;
+	}
+
+	void ResourceStateTracker::ExpandResourceState(CommandHandle resource, ResourceState& resourceState, uint32_t subresourceCount)
+	{
+		if (resourceState.size() != 1u)
+		{
+			return;
+		}
+
+		if (resourceState.front().splitState != UNKNOWN_RESOURCE_STATE)
+		{
+			EndSubresourceTransition(resource, ALL_SUBRESOURCES, resourceState.front());
+		}
+
+		resourceState.resize(std::max(subresourceCount, 1u), resourceState.front());
+	}
+
+	void ResourceStateTracker::SetInitialResourceState(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount)
+	{
+		ResourceState& resourceState = mResourceStates[resource];
+		if (resourceState.empty())
+		{
+			resourceState.resize(1u);
+		}
+
+		if (subresource != ALL_SUBRESOURCES && resourceState.front().state == UNKNOWN_RESOURCE_STATE)
+		{
+			ExpandResourceState(resource, resourceState, subresourceCount);
+		}
+
+		for (uint32_t i = 0u; i < resourceState.size(); i++)
+		{
+			const bool isTargeted = subresource == ALL_SUBRESOURCES || subresource == i || resourceState.size() == 1u;
+			if (isTargeted && resourceState[i].state == UNKNOWN_RESOURCE_STATE)
+			{
+				mPendingTransitions.push_back(PendingTransition
+				{
+					.resource = resource,
+					.subresource = resourceState.size() == 1u ? ALL_SUBRESOURCES : i,
+					.state = state,
+				});
+
+				resourceState[i].state = state;
+			}
+		}
+	}
+
+	void ResourceStateTracker::Reset()
+	{
+		mResourceStates.clear();
+		mPendingTransitions.clear();
+	}
+
+	ResourceStateHandle ResourceStateRegistry::RegisterResource(CommandHandle resource, uint32_t initialState)
+	{
+		{
+			std::lock_guard<std::mutex> lockGuard(mMutex);
+			mResourceStates[resource] = { initialState };
+		}
+
+		std::weak_ptr<ResourceStateRegistry> resourceStateRegistry = weak_from_this();
+
+		return ResourceStateHandle(new CommandHandle(resource), [resourceStateRegistry](const CommandHandle* resource)
+		{
+			if (std::shared_ptr<ResourceStateRegistry> registry = resourceStateRegistry.lock())
+			{
+				registry->UnregisterResource(*resource);
+			}
+
+			delete resource;
+		});
+	}
+
+	void ResourceStateRegistry::UnregisterResource(CommandHandle resource)
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+		mResourceStates.erase(resource);
+	}
+
+	ResolvedTransitions ResourceStateRegistry::ResolvePendingTransitions(QueueType queueType, std::span<CommandStream* const> commandStreams)
+	{
+		ResolvedTransitions resolvedTransitions{};
+		std::vector<ResourceBarrierCommand> resolvedBarriers{};
+
+		const uint32_t queueResourceStates = queueType == QueueType::Compute ? COMPUTE_QUEUE_RESOURCE_STATES : COPY_QUEUE_RESOURCE_STATES;
+		const auto isSupportedByQueue = [&](uint32_t state)
+		{
+			return queueType == QueueType::Graphics || (state & ~queueResourceStates) == 0u;
+		};
+
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		for (size_t i = 0u; i < commandStreams.size(); i++)
+		{
+			ResourceStateTracker* resourceStateTracker = commandStreams[i]->GetResourceStateTracker();
+			if (!resourceStateTracker)
+			{
+				continue;
+			}
+
+			resolvedBarriers.clear();
+
+			const auto addResolvedBarrier = [&](CommandHandle resource, uint32_t subresource, uint32_t stateBefore, uint32_t stateAfter)
+			{
+				if (stateBefore == stateAfter)
+				{
+					return;
+				}
+
+				std::vector<ResourceBarrierCommand>& barriers = isSupportedByQueue(stateBefore) && isSupportedByQueue(stateAfter) ? resolvedBarriers :
+					resolvedTransitions.graphicsPrologueBarriers;
+
+				barriers.push_back(ResourceBarrierCommand
+				{
+					.barrierType = BarrierType::Transition,
+					.stateBefore = stateBefore,
+					.stateAfter = stateAfter,
+					.resource = resource,
+					.subresource = subresource,
+				});
+			};
+
+			for (const ResourceStateTracker::PendingTransition& pendingTransition : resourceStateTracker->mPendingTransitions)
+			{
+				auto resourceStateIterator = mResourceStates.find(pendingTransition.resource);
+				if (resourceStateIterator == mResourceStates.end())
+				{
+					continue;
+				}
+
+				const std::vector<uint32_t>& resourceState = resourceStateIterator->second;
+				if (resourceState.size() == 1u)
+				{
+					addResolvedBarrier(pendingTransition.resource, pendingTransition.subresource, resourceState.front(), pendingTransition.state);
+				}
+				else if (pendingTransition.subresource == ALL_SUBRESOURCES)
+				{
+					for (uint32_t subresource = 0u; subresource < resourceState.size(); subresource++)
+					{
+						addResolvedBarrier(pendingTransition.resource, subresource, resourceState[subresource], pendingTransition.state);
+					}
+				}
+				else if (pendingTransition.subresource < resourceState.size())
+				{
+					addResolvedBarrier(pendingTransition.resource, pendingTransition.subresource, resourceState[pendingTransition.subresource], pendingTransition.state);
+				}
+			}
+
+			if (i == 0u)
+			{
+				resolvedTransitions.prologueBarriers = resolvedBarriers;
+			}
+			else
+			{
+				commandStreams[i - 1u]->RecordResolvedBarriers(resolvedBarriers);
+			}
+
+			// The states the stream leaves the resources in are the states the next streams start with.
+			for (const auto& [resource, trackedResourceState] : resourceStateTracker->mResourceStates)
+			{
+				auto resourceStateIterator = mResourceStates.find(resource);
+				if (resourceStateIterator == mResourceStates.end())
+				{
+					continue;
+				}
+
+				std::vector<uint32_t>& resourceState = resourceStateIterator->second;
+				if (trackedResourceState.size() == 1u)
+				{
+					if (trackedResourceState.front().state != UNKNOWN_RESOURCE_STATE)
+					{
+						resourceState.assign(1u, trackedResourceState.front().state);
+					}
+
+					continue;
+				}
+
+				if (resourceState.size() != trackedResourceState.size())
+				{
+					resourceState.resize(trackedResourceState.size(), resourceState.front());
+				}
+
+				for (uint32_t subresource = 0u; subresource < trackedResourceState.size(); subresource++)
+				{
+					if (trackedResourceState[subresource].state != UNKNOWN_RESOURCE_STATE)
+					{
+						resourceState[subresource] = trackedResourceState[subresource].state;
+					}
+				}
+
+				if (std::ranges::all_of(resourceState, [&](uint32_t state) { return state == resourceState.front(); }))
+				{
+					resourceState.resize(1u);
+				}
+			}
+
+			resourceStateTracker->Reset();
+		}
+
+		return resolvedTransitions;
+	}
+
+	uint32_t ResourceStateRegistry::GetResourceState(CommandHandle resource, uint32_t subresource) const
+	{
+		std::lock_guard<std::mutex> lockGuard(mMutex);
+
+		auto resourceStateIterator = mResourceStates.find(resource);
+		if (resourceStateIterator == mResourceStates.end())
+		{
+			return UNKNOWN_RESOURCE_STATE;
+		}
+
+		const std::vector<uint32_t>& resourceState = resourceStateIterator->second;
+		if (resourceState.size() == 1u)
+		{
+			return resourceState.front();
+		}
+
+		if (subresource != ALL_SUBRESOURCES)
+		{
+			return subresource < resourceState.size() ? resourceState[subresource] : UNKNOWN_RESOURCE_STATE;
+		}
+
+		return std::ranges::all_of(resourceState, [&](uint32_t state) { return state == resourceState.front(); }) ? resourceState.front() : UNKNOWN_RESOURCE_STATE;
+	}
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+// States are D3D12_RESOURCE_STATES values (see the static_assert in Context.cpp), as the tracker has to tell the read only states apart.
+#include "CommandStream.hpp"
+#include "QueueScheduler.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace helios::gfx
+{
+	// D3D12_RESOURCE_STATE_GENERIC_READ | D3D12_RESOURCE_STATE_DEPTH_READ : a resource can be in several of these states at once.
+	static constexpr uint32_t READ_ONLY_RESOURCE_STATES = 0xAE3u;
+
+	// The states the command lists of the compute queue (D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | UNORDERED_ACCESS | NON_PIXEL_SHADER_RESOURCE |
+	// INDIRECT_ARGUMENT | COPY_DEST | COPY_SOURCE), and of the copy queue (COPY_DEST | COPY_SOURCE) can transition resources from / to, besides COMMON.
+	static constexpr uint32_t COMPUTE_QUEUE_RESOURCE_STATES = 0xE49u;
+	static constexpr uint32_t COPY_QUEUE_RESOURCE_STATES = 0xC00u;
+
+	// State of the (sub)resources a stream has not used yet : the state they are in at the start of the stream is only known on submission.
+	static constexpr uint32_t UNKNOWN_RESOURCE_STATE = UINT32_MAX;
+
+	// Tracks the state of the (sub)resources used by a command stream (one tracker per stream, owned by it), and turns the states requested by the caller into
+	// transitions from the tracked state :
+	// - Transitions are batched until the next work command (draw, dispatch, copy, clear) or explicit flush, so they are executed by a single call.
+	// - Transitions to the state the resource is already in (or to read only states it is already in) are skipped, and consecutive transitions of the same
+	//   batch are merged (A -> B followed by B -> C becomes A -> C).
+	// - The first use of a resource in the stream records no barrier, but the state it expects : the barrier (if any) is recorded on submission by the
+	//   ResourceStateRegistry, which knows the state the previously submitted streams left the resource in.
+	// - Split transitions are begun after the last use of a resource, and ended before its next use. If no work was recorded in between, the pair is
+	//   merged into a regular transition, as the split would only add a barrier.
+	class ResourceStateTracker
+	{
+	public:
+		// subresourceCount is only used if a single subresource is transitioned, and must be the same for all the transitions of the resource.
+		void TransitionResource(CommandHandle resource, uint32_t state, uint32_t subresource = ALL_SUBRESOURCES, uint32_t subresourceCount = 1u);
+
+		// The (sub)resource must not be used until its transition is ended by a call to TransitionResource with the same state (or by EndResourceTransitions).
+		// Has no effect on resources whose state is not known yet (the transition will happen on the next use).
+		void BeginResourceTransition(CommandHandle resource, uint32_t state, uint32_t subresource = ALL_SUBRESOURCES, uint32_t subresourceCount = 1u);
+
+		// Barriers recorded with explicit states : the state before of transitions is only used if the (sub)resource is used for the first time (the tracked
+		// state is used otherwise, and the barrier counted as corrected if they differ). UAV and aliasing barriers are batched as is.
+		void AddResourceBarrier(const ResourceBarrierCommand& barrier, uint32_t subresourceCount = 1u);
+
+		// Ends the split transitions that are still in flight (required before submission).
+		void EndResourceTransitions();
+
+		std::span<const ResourceBarrierCommand> GetPendingBarriers() const { return mPendingBarriers; }
+
+		// To be called once the pending barriers are recorded (i.e before a work command, so a split transition can only be merged if no work was recorded
+		// since it was begun). Counts the batch.
+		void ClearPendingBarriers();
+
+		// Returns the tracked state of the (sub)resource (UNKNOWN_RESOURCE_STATE if not used yet, or if its subresources are in different states).
+		uint32_t GetResourceState(CommandHandle resource, uint32_t subresource = ALL_SUBRESOURCES) const;
+
+		const ResourceBarrierStatistics& GetStatistics() const { return mStatistics; }
+
+	private:
+		friend class ResourceStateRegistry;
+
+		struct SubresourceState
+		{
+			uint32_t state{ UNKNOWN_RESOURCE_STATE };
+
+			// Target state of the split transition in flight (if any).
+			uint32_t splitState{ UNKNOWN_RESOURCE_STATE };
+		};
+
+		// A single element while all subresources are in the same state (and transitioned together), else one element per subresource.
+		using ResourceState = std::vector<SubresourceState>;
+
+		// First use of a (sub)resource in the stream : the state it must be in at the start of the stream.
+		struct PendingTransition
+		{
+			CommandHandle resource{};
+			uint32_t subresource{};
+			uint32_t state{};
+		};
+
+		enum class TransitionType : uint32_t
+		{
+			Regular,
+			Begin,
+		};
+
+		void TransitionResource(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount, TransitionType transitionType);
+		void TransitionSubresource(CommandHandle resource, uint32_t subresource, SubresourceState& subresourceState, uint32_t state, TransitionType transitionType);
+
+		// Ends the split transition in flight of the subresource, or turns it into a regular transition if it is still pending.
+		void EndSubresourceTransition(CommandHandle resource, uint32_t subresource, SubresourceState& subresourceState);
+
+		// Merges the transition into the last pending barrier of the resource if possible.
+		void AddTransition(CommandHandle resource, uint32_t subresource, uint32_t stateBefore, uint32_t stateAfter, BarrierSplit split);
+
+		// Gives each subresource its own state (if not already the case). Split transitions in flight for all subresources are ended first, as the end
+		// barrier must match the begin barrier.
+		void ExpandResourceState(CommandHandle resource, ResourceState& resourceState, uint32_t subresourceCount);
+
+		// Records the first use of the (sub)resources whose state is not known yet.
+		void SetInitialResourceState(CommandHandle resource, uint32_t state, uint32_t subresource, uint32_t subresourceCount);
+
+		// To be called once the resources were submitted : the tracked states become the states the next stream starts with.
+		void Reset();
+
+	private:
+		std::unordered_map<CommandHandle, ResourceState> mResourceStates{};
+		std::vector<PendingTransition> mPendingTransitions{};
+
+		std::vector<ResourceBarrierCommand> mPendingBarriers{};
+
+		ResourceBarrierStatistics mStatistics{};
+	};
+
+	// The resource remains registered until all copies of the handle are destroyed / reset (same semantics as MemoryStatisticsHandle).
+	using ResourceStateHandle = std::shared_ptr<const CommandHandle>;
+
+	// The transitions resolved for a submission, that must be executed before its first stream.
+	struct ResolvedTransitions
+	{
+		// Executed on the queue of the submission (see CommandStream::RecordResolvedBarriers).
+		std::vector<ResourceBarrierCommand> prologueBarriers{};
+
+		// Only for the compute and copy queues : the transitions from or to states their command lists cannot use (i.e from RENDER_TARGET after a
+		// graphics pass). They are executed on the graphics queue, and the submission must wait for them.
+		std::vector<ResourceBarrierCommand> graphicsPrologueBarriers{};
+	};
+
+	// State of the resources between submissions : the state the last submitted stream left them in. Resolves the first uses of the resources in the streams
+	// that are submitted (see ResourceStateTracker).
+	class ResourceStateRegistry : public std::enable_shared_from_this<ResourceStateRegistry>
+	{
+	public:
+		// Must be called on a ResourceStateRegistry object owned by a std::shared_ptr (handles only hold a weak reference to it).
+		ResourceStateHandle RegisterResource(CommandHandle resource, uint32_t initialState);
+
+		// To be called with the streams of a submission to queueType (in execution order), once their split transitions are ended, and before they are
+		// translated. The transitions required by the first use of the resources in a stream are recorded at the end of the stream before it, and the ones of
+		// the first stream are returned (see ResolvedTransitions).
+		// The transitions a compute or copy submission cannot execute are returned as the graphics prologue, whichever stream they are for : a resource in a
+		// graphics only state was last used by the graphics queue, so it is not used by the streams of the submission before its first use.
+		// Resources that are not registered are assumed to already be in the state expected by their first use.
+		// Note : The submissions are resolved in the order of the calls (the CPU submission order), which is taken as the order the streams using a resource
+		// execute in on the GPU. The caller must hence resolve and execute a submission without any other submission in between (the Device does both under
+		// its queue scheduler lock), and submissions on different queues that share a resource must be ordered by a queue dependency.
+		ResolvedTransitions ResolvePendingTransitions(QueueType queueType, std::span<CommandStream* const> commandStreams);
+
+		// UNKNOWN_RESOURCE_STATE if not registered.
+		uint32_t GetResourceState(CommandHandle resource, uint32_t subresource = ALL_SUBRESOURCES) const;
+
+	private:
+		void UnregisterResource(CommandHandle resource);
+
+	private:
+		mutable std::mutex mMutex{};
+
+		// Same layout as ResourceStateTracker::ResourceState (a single state, or one state per subresource).
+		std::unordered_map<CommandHandle, std::vector<uint32_t>> mResourceStates{};
+	};
+}
@@ -4,7 +4,7 @@
 
 namespace helios::gfx
 {
-	Allocation::Allocation(const Allocation& other) : resource(other.resource), allocation(other.allocation)
+	Allocation::Allocation(const Allocation& other) : resource(other.resource), allocation(other.allocation), placementHandle(other.placementHandle), statisticsHandle(other.statisticsHandle), residencyHandle(other.residencyHandle), resourceStateHandle(other.resourceStateHandle)
 	{
 		if (other.mappedPointer.has_value())
 		{
@@ -30,12 +30,16 @@ namespace helios::gfx
 
 		resource = other.resource;		
 		allocation = other.allocation;
+		placementHandle = other.placementHandle;
+		statisticsHandle = other.statisticsHandle;
+		residencyHandle = other.residencyHandle;
+		resourceStateHandle = other.resourceStateHandle;
 
 		return *this;
 	}
 
 	Allocation::Allocation(Allocation&& other) noexcept
-		: resource(std::move(other.resource)), allocation(std::move(other.allocation))
+		: resource(std::move(other.resource)), allocation(std::move(other.allocation)), placementHandle(std::move(other.placementHandle)), statisticsHandle(std::move(other.statisticsHandle)), residencyHandle(std::move(other.residencyHandle)), resourceStateHandle(std::move(other.resourceStateHandle))
 	{
 		if (other.mappedPointer.has_value())
 		{
@@ -47,6 +51,10 @@ namespace helios::gfx
 	{
 		resource = std::move(other.resource); 
 		allocation = std::move(other.allocation);
+		placementHandle = std::move(other.placementHandle);
+		statisticsHandle = std::move(other.statisticsHandle);
+		residencyHandle = std::move(other.residencyHandle);
+		resourceStateHandle = std::move(other.resourceStateHandle);
 	
 		if (other.mappedPointer.has_value())
 		{
@@ -56,27 +64,34 @@ namespace helios::gfx
 		return *this;
 	}
 
-	void Allocation::Update(const void* data, size_t size)
+	void Allocation::Update(const void* data, size_t size, size_t offset)
 	{
 		if (!data || !mappedPointer.has_value())
 		{
 			throw std::exception("Trying to update resource that is not placed in CPU visible memory, or the data is null");
 		}
 
-		memcpy(mappedPointer.value(), data, size);
+		memcpy(static_cast<std::byte*>(mappedPointer.value()) + offset, data, size);
 	}
 
 	void Allocation::Reset()
 	{
+		residencyHandle.reset();
+		resourceStateHandle.reset();
 		resource.Reset();
 		allocation.Reset();
+		placementHandle.reset();
+		statisticsHandle.reset();
 	}
 
 	// To be used primarily for constant buffers.
 	void Buffer::Update(const void* data)
 	{
+		// Only constant buffers are versioned.
+		const uint32_t version = versionSizeInBytes != 0u ? versionRing.Advance(sFrameNumber.load(std::memory_order_acquire)) : 0u;
+
 		// Allocation's update function will take care if data is null or not.
-		allocation->Update(data, sizeInBytes);
+		allocation->Update(data, sizeInBytes, version * versionSizeInBytes);
 	}
 
 	// In the model abstraction, the buffers are wrapped in unique pointers.
@@ -99,7 +114,7 @@ namespace helios::gfx
 			return UINT32_MAX;
 		}
 
-		return buffer->cbvIndex;
+		return buffer->cbvIndices[buffer->versionRing.GetVersion()];
 	}
 
 	uint32_t Buffer::GetUavIndex(const Buffer* buffer)
@@ -156,6 +171,16 @@ namespace helios::gfx
 		return texture->dsvIndex;
 	}
 
+	uint32_t Texture::GetReadOnlyDsvIndex(const Texture* texture)
+	{
+		if (texture == nullptr)
+		{
+			return UINT32_MAX;
+		}
+
+		return texture->readOnlyDsvIndex;
+	}
+
 	uint32_t Texture::GetRtvIndex(const Texture* texture)
 	{
 		if (texture == nullptr)
@@ -3,11 +3,17 @@
 
 
 #include "Descriptor.hpp"
+#include "FrameVersionRing.hpp"
+#include "MemoryStatistics.hpp"
+#include "ResidencyPolicy.hpp"
+#include "ResourceStateTracker.hpp"
 
 #include "Common/BindlessRS.hlsli"
 
 namespace helios::gfx
 {
+	class MipMapGenerationBatch;
+
 	// This design choice of having a common Texture / Buffer struct for all various types is inspired from SanityEngine : https://github.com/DethRaid/SanityEngine.
 	// Struct with back buffer data.
 	struct BackBuffer
@@ -17,6 +23,9 @@ namespace helios::gfx
 
 		ID3D12Resource* GetResource() { return backBufferResource.Get(); }
 		std::wstring bufferName{};
+
+		// Back buffers are not created by the memory allocator, but are registered with its resource state registry as well (in the present state).
+		ResourceStateHandle resourceStateHandle{};
 	};
 
 	// When custom allocator is used much more data will be stored in the allocation struct.
@@ -32,12 +41,26 @@ namespace helios::gfx
 		Allocation(Allocation&& other) noexcept;
 		Allocation& operator=(Allocation&& other) noexcept;
 
-		void Update(const void* data, size_t size);
+		void Update(const void* data, size_t size, size_t offset = 0u);
 		void Reset();
 
 		Microsoft::WRL::ComPtr<D3D12MA::Allocation> allocation{};
 		std::optional<void*> mappedPointer{};
+
+		// Set for resources placed by the TLSF heap pools of the memory allocator (instead of D3D12MA) : releasing the last copy returns the range to the pool.
+		// Note : Declared before the resource, so that the resource is destroyed before its memory range can be reused.
+		std::shared_ptr<void> placementHandle{};
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource{};
+
+		// Keeps the allocation registered with the memory allocator's statistics until the last copy of the allocation is reset / destroyed.
+		MemoryStatisticsHandle statisticsHandle{};
+
+		// Set if the resource can be evicted by the residency manager. Declared after the resource, so that it is unregistered before the resource is released.
+		ResidencyHandle residencyHandle{};
+
+		// Keeps the state the last submission left the resource in registered with the memory allocator (see ResourceStateRegistry). Declared after the
+		// resource, so that it is unregistered before a new resource can be created at the same address.
+		ResourceStateHandle resourceStateHandle{};
 	};
 
 	// Buffer related functions / enum's.
@@ -48,6 +71,8 @@ namespace helios::gfx
 		IndexBuffer,
 		StructuredBuffer,
 		ConstantBuffer,
+		// Structured buffer which is also written by shaders (has a UAV along with the SRV).
+		UAVBuffer,
 	};
 
 	struct BufferCreationDesc
@@ -56,9 +81,14 @@ namespace helios::gfx
 		std::wstring name{};
 	};
 
+	// Maximum number of frames the CPU can record ahead of the GPU (also the number of swap chain back buffers).
+	static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3u;
+
 	struct Buffer
 	{
 		// To be used primarily for constant buffers.
+		// Constant buffers have a version (a copy of the data with its own CBV) per frame in flight, selected by a FrameVersionRing.
+		// GetCbvIndex returns the last written version, so buffers that are not updated every frame remain valid.
 		void Update(const void* data);
 
 		// In the model abstraction, the buffers are wrapped in unique pointers.
@@ -77,7 +107,15 @@ namespace helios::gfx
 		// Access these using the GetXIndex calls.
 		uint32_t srvIndex{};
 		uint32_t uavIndex{};
-		uint32_t cbvIndex{};
+		std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> cbvIndices{};
+
+		// Offset between the versions of a constant buffer (CBV's must be 256 byte aligned).
+		size_t versionSizeInBytes{};
+		FrameVersionRing<MAX_FRAMES_IN_FLIGHT> versionRing{};
+
+		// Number of the frame being recorded by the CPU, set by the device once the previous frame is presented.
+		// Atomic, as buffers are updated from other threads (i.e the jobs of Scene::Update) than the one presenting.
+		static inline std::atomic<uint64_t> sFrameNumber{};
 
 		// Required as device sets all the indices.
 		friend class Device;
@@ -110,6 +148,14 @@ namespace helios::gfx
 		uint32_t depthOrArraySize{ 1u };
 		std::wstring name{};
 		std::wstring path{};
+
+		// If set, the texture is created as a placed resource at aliasingOffset within this allocation, rather than getting its own allocation.
+		// Only used by the TransientResourcePool.
+		D3D12MA::Allocation* aliasingAllocation{ nullptr };
+		uint64_t aliasingOffset{};
+
+		// If set, the mips are generated once the batch is submitted (see MipMapGenerator), rather than before CreateTexture returns.
+		MipMapGenerationBatch* mipMapGenerationBatch{ nullptr };
 	};
 	
 	struct Texture
@@ -122,6 +168,7 @@ namespace helios::gfx
 		static uint32_t GetSrvIndex(const Texture* texture);
 		static uint32_t GetUavIndex(const Texture* texture);
 		static uint32_t GetDsvIndex(const Texture* texture);
+		static uint32_t GetReadOnlyDsvIndex(const Texture* texture);
 		static uint32_t GetRtvIndex(const Texture* texture);
 
 		static bool IsTextureSRGB(const DXGI_FORMAT& format);
@@ -137,6 +184,9 @@ namespace helios::gfx
 		uint32_t dsvIndex{};
 		uint32_t rtvIndex{};
 
+		// Depth stencil textures also have a read only DSV, so they can be depth tested against while being read by shaders (see DepthStencilAccess).
+		uint32_t readOnlyDsvIndex{};
+
 		friend class Device;
 	};
 
@@ -218,8 +268,12 @@ namespace helios::gfx
 		uint32_t rtvCount{ 1u };
 		DXGI_FORMAT depthFormat{ DXGI_FORMAT_D32_FLOAT };
 		D3D12_COMPARISON_FUNC depthComparisonFunc{ D3D12_COMPARISON_FUNC_LESS };
+		// Must be D3D12_DEPTH_WRITE_MASK_ZERO for pipelines used with a read only depth stencil view.
+		D3D12_DEPTH_WRITE_MASK depthWriteMask{ D3D12_DEPTH_WRITE_MASK_ALL };
 		FrontFaceWindingOrder frontFaceWindingOrder{ FrontFaceWindingOrder::ClockWise };
 		D3D12_CULL_MODE cullMode{ D3D12_CULL_MODE_BACK };
+		// If false, the depth of primitives in front of the near plane (or beyond the far plane) is clamped instead of the primitives being clipped.
+		bool depthClipEnable{ true };
 		std::wstring pipelineName{};
 	};
 	
@@ -0,0 +1,322 @@
+#include "SinglePassDownsampler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace helios::gfx
+{
+	// Reciprocals of the footprint texel counts (2 x 2, and up to 3 x 3 at the last row / column of odd mips), indexed by the count.
+	// Stored as bit patterns, so SinglePassDownsampleCS.hlsl uses the exact same constants.
+	static constexpr std::array<uint32_t, 10u> FOOTPRINT_RECIPROCAL_BITS
+	{
+		0x00000000u, 0x3F800000u, 0x3F000000u, 0x3EAAAAABu, 0x3E800000u, 0x00000000u, 0x3E2AAAABu, 0x00000000u, 0x00000000u, 0x3DE38E39u
+	};
+
+	static DownsampleTexel Combine(const DownsampleTexel& accumulated, const DownsampleTexel& value, DownsampleReduction downsampleReduction)
+	{
+		DownsampleTexel result{};
+
+		for (size_t channel = 0u; channel < result.size(); ++channel)
+		{
+			switch (downsampleReduction)
+			{
+				case DownsampleReduction::Average:
+				{
+					result[channel] = accumulated[channel] + value[channel];
+				}break;
+
+				case DownsampleReduction::Min:
+				{
+					result[channel] = std::fmin(accumulated[channel], value[channel]);
+				}break;
+
+				case DownsampleReduction::Max:
+				{
+					result[channel] = std::fmax(accumulated[channel], value[channel]);
+				}break;
+
+				case DownsampleReduction::MinMax:
+				{
+					result[channel] = channel % 2u == 0u ? std::fmin(accumulated[channel], value[channel]) : std::fmax(accumulated[channel], value[channel]);
+				}break;
+			}
+		}
+
+		return result;
+	}
+
+	static DownsampleTexel Resolve(const DownsampleTexel& accumulated, uint32_t texelCount, DownsampleReduction downsampleReduction)
+	{
+		if (downsampleReduction != DownsampleReduction::Average)
+		{
+			return accumulated;
+		}
+
+		const float reciprocal = std::bit_cast<float>(FOOTPRINT_RECIPROCAL_BITS[texelCount]);
+
+		DownsampleTexel result{};
+		for (size_t channel = 0u; channel < result.size(); ++channel)
+		{
+			result[channel] = accumulated[channel] * reciprocal;
+		}
+
+		return result;
+	}
+
+	// Reduces the 2 x 2 texels returned by load(i, j) in row major order, as the tiles are reduced by the shader.
+	template <typename Load>
+	static DownsampleTexel Reduce2x2(Load&& load, DownsampleReduction downsampleReduction)
+	{
+		DownsampleTexel accumulated = load(0u, 0u);
+		accumulated = Combine(accumulated, load(1u, 0u), downsampleReduction);
+		accumulated = Combine(accumulated, load(0u, 1u), downsampleReduction);
+		accumulated = Combine(accumulated, load(1u, 1u), downsampleReduction);
+
+		return Resolve(accumulated, 4u, downsampleReduction);
+	}
+
+	static DownsampleTexel ReduceFootprint(const DownsampleImage& source, uint32_t x, uint32_t y, DownsampleReduction downsampleReduction)
+	{
+		const DownsampleFootprint footprintX = GetDownsampleFootprint(x, source.width);
+		const DownsampleFootprint footprintY = GetDownsampleFootprint(y, source.height);
+
+		DownsampleTexel accumulated = source.At(footprintX.begin, footprintY.begin);
+		for (uint32_t sourceY = footprintY.begin; sourceY < footprintY.end; ++sourceY)
+		{
+			for (uint32_t sourceX = footprintX.begin; sourceX < footprintX.end; ++sourceX)
+			{
+				if (sourceX != footprintX.begin || sourceY != footprintY.begin)
+				{
+					accumulated = Combine(accumulated, source.At(sourceX, sourceY), downsampleReduction);
+				}
+			}
+		}
+
+		return Resolve(accumulated, (footprintX.end - footprintX.begin) * (footprintY.end - footprintY.begin), downsampleReduction);
+	}
+
+	// Texels are initialized to NaN, so texels the emulation never writes do not compare equal to the reference.
+	static std::vector<DownsampleImage> CreateMips(uint32_t width, uint32_t height, uint32_t mipCount)
+	{
+		std::vector<DownsampleImage> mips(mipCount);
+
+		for (uint32_t mipLevel = 1u; mipLevel <= mipCount; ++mipLevel)
+		{
+			DownsampleImage& mip = mips[mipLevel - 1u];
+
+			mip.width = GetDownsampleMipDimension(width, mipLevel);
+			mip.height = GetDownsampleMipDimension(height, mipLevel);
+			mip.texels.assign(static_cast<size_t>(mip.width) * mip.height, DownsampleTexel{ std::numeric_limits<float>::quiet_NaN() });
+		}
+
+		return mips;
+	}
+
+	const char* DownsampleReductionToString(DownsampleReduction downsampleReduction)
+	{
+		switch (downsampleReduction)
+		{
+			case DownsampleReduction::Average:
+			{
+				return "Average";
+			}break;
+
+			case DownsampleReduction::Min:
+			{
+				return "Min";
+			}break;
+
+			case DownsampleReduction::Max:
+			{
+				return "Max";
+			}break;
+
+			case DownsampleReduction::MinMax:
+			{
+				return "MinMax";
+			}break;
+		}
+
+		return "Unknown";
+	}
+
+	uint32_t GetDownsampleMipDimension(uint32_t dimension, uint32_t mipLevel)
+	{
+		return std::max(dimension >> mipLevel, 1u);
+	}
+
+	DownsampleFootprint GetDownsampleFootprint(uint32_t destinationIndex, uint32_t sourceDimension)
+	{
+		const uint32_t destinationDimension = GetDownsampleMipDimension(sourceDimension, 1u);
+
+		return DownsampleFootprint
+		{
+			.begin = destinationIndex * 2u,
+			.end = destinationIndex == destinationDimension - 1u ? sourceDimension : destinationIndex * 2u + 2u,
+		};
+	}
+
+	uint32_t GetDownsampleMipCount(uint32_t mipLevels)
+	{
+		return std::min(std::max(mipLevels, 1u) - 1u, SPD_MAX_MIP_COUNT);
+	}
+
+	bool IsSinglePassDownsampleSupported(uint32_t width, uint32_t height, uint32_t mipLevels)
+	{
+		return mipLevels > 1u && mipLevels - 1u <= SPD_MAX_MIP_COUNT && width <= SPD_MAX_DIMENSION && height <= SPD_MAX_DIMENSION;
+	}
+
+	std::array<uint32_t, 2u> GetDownsampleThreadGroupCount(uint32_t width, uint32_t height)
+	{
+		constexpr uint32_t mip1TileDimension = SPD_TILE_DIMENSION / 2u;
+
+		return
+		{
+			(GetDownsampleMipDimension(width, 1u) + mip1TileDimension - 1u) / mip1TileDimension,
+			(GetDownsampleMipDimension(height, 1u) + mip1TileDimension - 1u) / mip1TileDimension,
+		};
+	}
+
+	std::vector<DownsampleImage> DownsampleReference(const DownsampleImage& source, uint32_t mipCount, DownsampleReduction downsampleReduction)
+	{
+		std::vector<DownsampleImage> mips = CreateMips(source.width, source.height, std::min(mipCount, SPD_MAX_MIP_COUNT));
+
+		for (size_t mipIndex = 0u; mipIndex < mips.size(); ++mipIndex)
+		{
+			const DownsampleImage& previousMip = mipIndex == 0u ? source : mips[mipIndex - 1u];
+			DownsampleImage& mip = mips[mipIndex];
+
+			for (uint32_t y = 0u; y < mip.height; ++y)
+			{
+				for (uint32_t x = 0u; x < mip.width; ++x)
+				{
+					mip.At(x, y) = ReduceFootprint(previousMip, x, y, downsampleReduction);
+				}
+			}
+		}
+
+		return mips;
+	}
+
+	std::vector<DownsampleImage> EmulateSinglePassDownsample(const DownsampleImage& source, uint32_t mipCount, DownsampleReduction downsampleReduction)
+	{
+		std::vector<DownsampleImage> mips = CreateMips(source.width, source.height, std::min(mipCount, SPD_MAX_MIP_COUNT));
+		if (mips.empty())
+		{
+			return mips;
+		}
+
+		const auto getMip = [&](uint32_t mipLevel) -> const DownsampleImage& { return mipLevel == 0u ? source : mips[mipLevel - 1u]; };
+
+		const uint32_t generatedMipCount = static_cast<uint32_t>(mips.size());
+		const uint32_t groupMipCount = std::min(generatedMipCount, SPD_GROUP_MIP_COUNT);
+
+		// Group shared memory holds the tile of mip 1, and each following mip is written into its top left corner.
+		constexpr uint32_t mip1TileDimension = SPD_TILE_DIMENSION / 2u;
+		std::vector<DownsampleTexel> groupSharedTexels(mip1TileDimension * mip1TileDimension);
+		std::vector<DownsampleTexel> groupValues(mip1TileDimension * mip1TileDimension);
+
+		const std::array<uint32_t, 2u> threadGroupCount = GetDownsampleThreadGroupCount(source.width, source.height);
+
+		for (uint32_t groupY = 0u; groupY < threadGroupCount[1]; ++groupY)
+		{
+			for (uint32_t groupX = 0u; groupX < threadGroupCount[0]; ++groupX)
+			{
+				// Mip 1 : 2 x 2 texels of the source (clamped to its dimensions, as the tiles at the edges extend past them).
+				for (uint32_t localIndex = 0u; localIndex < mip1TileDimension * mip1TileDimension; ++localIndex)
+				{
+					const uint32_t localX = localIndex % mip1TileDimension;
+					const uint32_t localY = localIndex / mip1TileDimension;
+					const uint32_t x = groupX * mip1TileDimension + localX;
+					const uint32_t y = groupY * mip1TileDimension + localY;
+
+					const DownsampleTexel value = Reduce2x2([&](uint32_t i, uint32_t j)
+					{
+						return source.At(std::min(x * 2u + i, source.width - 1u), std::min(y * 2u + j, source.height - 1u));
+					}, downsampleReduction);
+
+					groupSharedTexels[localY * mip1TileDimension + localX] = value;
+
+					DownsampleImage& mip = mips[0];
+					if (x < mip.width && y < mip.height)
+					{
+						mip.At(x, y) = value;
+					}
+				}
+
+				// Mips 2 to SPD_GROUP_MIP_COUNT : 2 x 2 texels of the previous mip's tile. All values are computed before any is written back (the shader synchronizes the group in between).
+				for (uint32_t mipLevel = 2u; mipLevel <= groupMipCount; ++mipLevel)
+				{
+					const uint32_t tileDimension = SPD_TILE_DIMENSION >> mipLevel;
+
+					for (uint32_t localIndex = 0u; localIndex < tileDimension * tileDimension; ++localIndex)
+					{
+						const uint32_t localX = localIndex % tileDimension;
+						const uint32_t localY = localIndex / tileDimension;
+
+						groupValues[localIndex] = Reduce2x2([&](uint32_t i, uint32_t j)
+						{
+							return groupSharedTexels[(localY * 2u + j) * mip1TileDimension + localX * 2u + i];
+						}, downsampleReduction);
+					}
+
+					for (uint32_t localIndex = 0u; localIndex < tileDimension * tileDimension; ++localIndex)
+					{
+						const uint32_t localX = localIndex % tileDimension;
+						const uint32_t localY = localIndex / tileDimension;
+						const uint32_t x = groupX * tileDimension + localX;
+						const uint32_t y = groupY * tileDimension + localY;
+
+						groupSharedTexels[localY * mip1TileDimension + localX] = groupValues[localIndex];
+
+						DownsampleImage& mip = mips[mipLevel - 1u];
+						if (x < mip.width && y < mip.height)
+						{
+							mip.At(x, y) = groupValues[localIndex];
+						}
+					}
+				}
+			}
+		}
+
+		// Last group : the tiles only reduce 2 x 2 texels, so the last column (row) of a mip is wrong if the previous mip's width (height) is odd, or if its last column (row) was wrong.
+		bool isLastColumnWrong{};
+		bool isLastRowWrong{};
+
+		for (uint32_t mipLevel = 1u; mipLevel <= groupMipCount; ++mipLevel)
+		{
+			const DownsampleImage& previousMip = getMip(mipLevel - 1u);
+			DownsampleImage& mip = mips[mipLevel - 1u];
+
+			isLastColumnWrong = isLastColumnWrong || previousMip.width % 2u != 0u;
+			isLastRowWrong = isLastRowWrong || previousMip.height % 2u != 0u;
+
+			const uint32_t columnTexelCount = isLastColumnWrong ? mip.height : 0u;
+			const uint32_t rowTexelCount = isLastRowWrong ? mip.width - (isLastColumnWrong ? 1u : 0u) : 0u;
+
+			for (uint32_t index = 0u; index < columnTexelCount + rowTexelCount; ++index)
+			{
+				const uint32_t x = index < columnTexelCount ? mip.width - 1u : index - columnTexelCount;
+				const uint32_t y = index < columnTexelCount ? index : mip.height - 1u;
+
+				mip.At(x, y) = ReduceFootprint(previousMip, x, y, downsampleReduction);
+			}
+		}
+
+		// Last group : the remaining mips, from mip SPD_GROUP_MIP_COUNT.
+		for (uint32_t mipLevel = SPD_GROUP_MIP_COUNT + 1u; mipLevel <= generatedMipCount; ++mipLevel)
+		{
+			const DownsampleImage& previousMip = getMip(mipLevel - 1u);
+			DownsampleImage& mip = mips[mipLevel - 1u];
+
+			for (uint32_t index = 0u; index < mip.width * mip.height; ++index)
+			{
+				mip.At(index % mip.width, index / mip.width) = ReduceFootprint(previousMip, index % mip.width, index / mip.width, downsampleReduction);
+			}
+		}
+
+		return mips;
+	}
+}
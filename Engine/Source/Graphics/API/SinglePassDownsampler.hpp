@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace helios::gfx
+{
+	// The values of the footprint of a texel in the previous mip are reduced into it. Min / Max are used for (conservative) depth pyramids.
+	// MinMax keeps the minimum in the even channels (x / z) and the maximum in the odd ones (y / w), so a single pyramid whose mip 0 holds the depth in
+	// both x and y stores the depth range of every texel (see HiZPyramid).
+	enum class DownsampleReduction : uint32_t
+	{
+		Average,
+		Min,
+		Max,
+		MinMax,
+	};
+
+	const char* DownsampleReductionToString(DownsampleReduction downsampleReduction);
+
+	// Each thread group reduces a tile of SPD_TILE_DIMENSION x SPD_TILE_DIMENSION source texels into the first SPD_GROUP_MIP_COUNT mips (in group shared memory).
+	// The last group to complete (found using a global atomic counter) then generates the remaining mips from mip SPD_GROUP_MIP_COUNT, so a single dispatch generates the entire chain.
+	static constexpr uint32_t SPD_TILE_DIMENSION = 64u;
+	static constexpr uint32_t SPD_GROUP_MIP_COUNT = 6u;
+	static constexpr uint32_t SPD_MAX_MIP_COUNT = 12u;
+	static constexpr uint32_t SPD_THREAD_GROUP_SIZE = 256u;
+
+	// The last group generates the remaining mips on its own, which is only cheap while mip SPD_GROUP_MIP_COUNT is at most a tile.
+	static constexpr uint32_t SPD_MAX_DIMENSION = SPD_TILE_DIMENSION << SPD_GROUP_MIP_COUNT;
+
+	using DownsampleTexel = std::array<float, 4>;
+
+	struct DownsampleImage
+	{
+		uint32_t width{};
+		uint32_t height{};
+
+		// Row major.
+		std::vector<DownsampleTexel> texels{};
+
+		DownsampleTexel& At(uint32_t x, uint32_t y) { return texels[static_cast<size_t>(y) * width + x]; }
+		const DownsampleTexel& At(uint32_t x, uint32_t y) const { return texels[static_cast<size_t>(y) * width + x]; }
+	};
+
+	// Source texels [begin, end) along one axis, reduced into a destination texel.
+	struct DownsampleFootprint
+	{
+		uint32_t begin{};
+		uint32_t end{};
+	};
+
+	// Mips are sized as by D3D12 (max(1, dimension >> mipLevel)). A destination texel reduces two source texels, except the last one of an odd source dimension,
+	// which also reduces the last source texel (so no source texel is dropped, which keeps depth pyramids conservative), and the one of a source dimension of 1.
+	uint32_t GetDownsampleMipDimension(uint32_t dimension, uint32_t mipLevel);
+	DownsampleFootprint GetDownsampleFootprint(uint32_t destinationIndex, uint32_t sourceDimension);
+
+	// Number of mips generated from mip 0 (at most SPD_MAX_MIP_COUNT).
+	uint32_t GetDownsampleMipCount(uint32_t mipLevels);
+
+	bool IsSinglePassDownsampleSupported(uint32_t width, uint32_t height, uint32_t mipLevels);
+
+	// Thread groups of the dispatch : one per tile of mip 1.
+	std::array<uint32_t, 2u> GetDownsampleThreadGroupCount(uint32_t width, uint32_t height);
+
+	// Mips [1, mipCount] as defined by the reduction of the footprints, one mip after the other. Averages sum the footprint in row major order and multiply by the
+	// reciprocal of the texel count, so the shader's results match bit for bit for 32 bit float formats (barring denormals, which GPUs may flush).
+	std::vector<DownsampleImage> DownsampleReference(const DownsampleImage& source, uint32_t mipCount, DownsampleReduction downsampleReduction);
+
+	// Emulates SinglePassDownsampleCS.hlsl thread group by thread group : the tiles reduced into group shared memory (which get the last row / column of odd mips wrong),
+	// then the last group fixing up those rows / columns and generating the remaining mips. Must match DownsampleReference exactly.
+	std::vector<DownsampleImage> EmulateSinglePassDownsample(const DownsampleImage& source, uint32_t mipCount, DownsampleReduction downsampleReduction);
+}
@@ -0,0 +1,643 @@
+#include "TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace helios::gfx
+{
+	static inline uint32_t FloorLog2(uint64_t value)
+	{
+		return 63u - static_cast<uint32_t>(std::countl_zero(value));
+	}
+
+	static inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1u) / alignment * alignment;
+	}
+
+	double TlsfStatistics::GetFragmentation() const
+	{
+		const uint64_t freeBytes = capacityInBytes - usedBytes;
+		if (freeBytes == 0u)
+		{
+			return 0.0;
+		}
+
+		return 1.0 - static_cast<double>(largestFreeBlockBytes) / static_cast<double>(freeBytes);
+	}
+
+	TlsfAllocator::TlsfAllocator(uint64_t capacityInBytes) : mCapacity(capacityInBytes)
+	{
+		mSecondLevelBitmaps.resize(FL_INDEX_COUNT, 0u);
+		mFreeListHeads.resize(FL_INDEX_COUNT * SL_INDEX_COUNT, INVALID_NODE_INDEX);
+
+		// Initially, the entire range is a single free block.
+		const uint32_t nodeIndex = CreateNode();
+		mNodes[nodeIndex].offset = 0u;
+		mNodes[nodeIndex].size = capacityInBytes;
+
+		InsertFreeNode(nodeIndex);
+	}
+
+	void TlsfAllocator::Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+	{
+		if (size < SMALL_BLOCK_SIZE)
+		{
+			firstLevel = 0u;
+			secondLevel = static_cast<uint32_t>(size);
+		}
+		else
+		{
+			const uint32_t log2Size = FloorLog2(size);
+
+			firstLevel = log2Size - FL_INDEX_SHIFT + 1u;
+			secondLevel = static_cast<uint32_t>(size >> (log2Size - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+		}
+	}
+
+	uint32_t TlsfAllocator::FindFreeNode(uint64_t size) const
+	{
+		// Round the size up to the next second level boundary, so that any block in the bin found is large enough.
+		if (size >= SMALL_BLOCK_SIZE)
+		{
+			const uint64_t roundUp = (1ull << (FloorLog2(size) - SL_INDEX_COUNT_LOG2)) - 1u;
+			if (size > UINT64_MAX - roundUp)
+			{
+				return INVALID_NODE_INDEX;
+			}
+
+			size += roundUp;
+		}
+
+		uint32_t firstLevel{};
+		uint32_t secondLevel{};
+		Mapping(size, firstLevel, secondLevel);
+
+		uint32_t secondLevelMap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		if (secondLevelMap == 0u)
+		{
+			if (firstLevel + 1u >= FL_INDEX_COUNT)
+			{
+				return INVALID_NODE_INDEX;
+			}
+
+			const uint64_t firstLevelMap = mFirstLevelBitmap & (~0ull << (firstLevel + 1u));
+			if (firstLevelMap == 0u)
+			{
+				return INVALID_NODE_INDEX;
+			}
+
+			firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+			secondLevelMap = mSecondLevelBitmaps[firstLevel];
+		}
+
+		secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+
+		return mFreeListHeads[firstLevel * SL_INDEX_COUNT + secondLevel];
+	}
+
+	std::optional<TlsfAllocation> TlsfAllocator::Allocate(uint64_t sizeInBytes, uint64_t alignment)
+	{
+		sizeInBytes = std::max<uint64_t>(sizeInBytes, 1u);
+		alignment = std::max<uint64_t>(alignment, 1u);
+
+		if (sizeInBytes > mCapacity)
+		{
+			return std::nullopt;
+		}
+
+		const auto fits = [&](uint32_t nodeIndex)
+		{
+			const Node& node = mNodes[nodeIndex];
+			return AlignUp(node.offset, alignment) + sizeInBytes <= node.offset + node.size;
+		};
+
+		// The first attempt ignores alignment (which succeeds in most cases, as offsets of blocks are usually aligned already).
+		// If that fails, search for a block large enough to fit the size along with the worst case padding.
+		uint32_t nodeIndex = FindFreeNode(sizeInBytes);
+		if (nodeIndex == INVALID_NODE_INDEX || !fits(nodeIndex))
+		{
+			if (alignment == 1u || sizeInBytes > UINT64_MAX - alignment)
+			{
+				return std::nullopt;
+			}
+
+			nodeIndex = FindFreeNode(sizeInBytes + alignment - 1u);
+			if (nodeIndex == INVALID_NODE_INDEX)
+			{
+				return std::nullopt;
+			}
+		}
+
+		RemoveFreeNode(nodeIndex);
+
+		// Handle padding in front of the aligned offset.
+		const uint64_t alignedOffset = AlignUp(mNodes[nodeIndex].offset, alignment);
+		const uint64_t padding = alignedOffset - mNodes[nodeIndex].offset;
+
+		if (padding > 0u)
+		{
+			if (padding >= MIN_FREE_BLOCK_SIZE)
+			{
+				const uint32_t paddingNodeIndex = CreateNode();
+				Node& paddingNode = mNodes[paddingNodeIndex];
+				Node& node = mNodes[nodeIndex];
+
+				paddingNode.offset = node.offset;
+				paddingNode.size = padding;
+				paddingNode.prevPhysical = node.prevPhysical;
+				paddingNode.nextPhysical = nodeIndex;
+
+				if (node.prevPhysical != INVALID_NODE_INDEX)
+				{
+					mNodes[node.prevPhysical].nextPhysical = paddingNodeIndex;
+				}
+				node.prevPhysical = paddingNodeIndex;
+
+				InsertFreeNode(paddingNodeIndex);
+			}
+			else
+			{
+				// As adjacent free blocks are always merged, the previous block is in use : it takes over the padding.
+				Node& previousNode = mNodes[mNodes[nodeIndex].prevPhysical];
+				previousNode.size += padding;
+				mUsedBytes += padding;
+			}
+
+			mNodes[nodeIndex].offset = alignedOffset;
+			mNodes[nodeIndex].size -= padding;
+		}
+
+		// Split of the remaining part of the block.
+		const uint64_t remainder = mNodes[nodeIndex].size - sizeInBytes;
+		if (remainder >= MIN_FREE_BLOCK_SIZE)
+		{
+			const uint32_t remainderNodeIndex = CreateNode();
+			Node& remainderNode = mNodes[remainderNodeIndex];
+			Node& node = mNodes[nodeIndex];
+
+			remainderNode.offset = node.offset + sizeInBytes;
+			remainderNode.size = remainder;
+			remainderNode.prevPhysical = nodeIndex;
+			remainderNode.nextPhysical = node.nextPhysical;
+
+			if (node.nextPhysical != INVALID_NODE_INDEX)
+			{
+				mNodes[node.nextPhysical].prevPhysical = remainderNodeIndex;
+			}
+			node.nextPhysical = remainderNodeIndex;
+			node.size = sizeInBytes;
+
+			InsertFreeNode(remainderNodeIndex);
+		}
+
+		Node& node = mNodes[nodeIndex];
+		node.isFree = false;
+		node.alignment = alignment;
+
+		mUsedBytes += node.size;
+		mAllocationCount++;
+
+		return TlsfAllocation
+		{
+			.offset = node.offset,
+			.sizeInBytes = node.size,
+			.nodeIndex = nodeIndex
+		};
+	}
+
+	void TlsfAllocator::Free(const TlsfAllocation& allocation)
+	{
+		uint32_t nodeIndex = allocation.nodeIndex;
+
+		mUsedBytes -= mNodes[nodeIndex].size;
+		mAllocationCount--;
+
+		mNodes[nodeIndex].isFree = true;
+
+		// Merge with next block.
+		const uint32_t nextNodeIndex = mNodes[nodeIndex].nextPhysical;
+		if (nextNodeIndex != INVALID_NODE_INDEX && mNodes[nextNodeIndex].isFree)
+		{
+			RemoveFreeNode(nextNodeIndex);
+
+			mNodes[nodeIndex].size += mNodes[nextNodeIndex].size;
+			mNodes[nodeIndex].nextPhysical = mNodes[nextNodeIndex].nextPhysical;
+
+			if (mNodes[nodeIndex].nextPhysical != INVALID_NODE_INDEX)
+			{
+				mNodes[mNodes[nodeIndex].nextPhysical].prevPhysical = nodeIndex;
+			}
+
+			ReleaseNode(nextNodeIndex);
+		}
+
+		// Merge with previous block.
+		const uint32_t previousNodeIndex = mNodes[nodeIndex].prevPhysical;
+		if (previousNodeIndex != INVALID_NODE_INDEX && mNodes[previousNodeIndex].isFree)
+		{
+			RemoveFreeNode(previousNodeIndex);
+
+			mNodes[previousNodeIndex].size += mNodes[nodeIndex].size;
+			mNodes[previousNodeIndex].nextPhysical = mNodes[nodeIndex].nextPhysical;
+
+			if (mNodes[previousNodeIndex].nextPhysical != INVALID_NODE_INDEX)
+			{
+				mNodes[mNodes[previousNodeIndex].nextPhysical].prevPhysical = previousNodeIndex;
+			}
+
+			ReleaseNode(nodeIndex);
+			nodeIndex = previousNodeIndex;
+		}
+
+		InsertFreeNode(nodeIndex);
+	}
+
+	void TlsfAllocator::InsertFreeNode(uint32_t nodeIndex)
+	{
+		uint32_t firstLevel{};
+		uint32_t secondLevel{};
+		Mapping(mNodes[nodeIndex].size, firstLevel, secondLevel);
+
+		uint32_t& head = mFreeListHeads[firstLevel * SL_INDEX_COUNT + secondLevel];
+
+		Node& node = mNodes[nodeIndex];
+		node.isFree = true;
+		node.prevFree = INVALID_NODE_INDEX;
+		node.nextFree = head;
+
+		if (head != INVALID_NODE_INDEX)
+		{
+			mNodes[head].prevFree = nodeIndex;
+		}
+		head = nodeIndex;
+
+		mFirstLevelBitmap |= 1ull << firstLevel;
+		mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+
+		mFreeBlockCount++;
+	}
+
+	void TlsfAllocator::RemoveFreeNode(uint32_t nodeIndex)
+	{
+		uint32_t firstLevel{};
+		uint32_t secondLevel{};
+		Mapping(mNodes[nodeIndex].size, firstLevel, secondLevel);
+
+		Node& node = mNodes[nodeIndex];
+
+		if (node.prevFree != INVALID_NODE_INDEX)
+		{
+			mNodes[node.prevFree].nextFree = node.nextFree;
+		}
+		else
+		{
+			mFreeListHeads[firstLevel * SL_INDEX_COUNT + secondLevel] = node.nextFree;
+		}
+
+		if (node.nextFree != INVALID_NODE_INDEX)
+		{
+			mNodes[node.nextFree].prevFree = node.prevFree;
+		}
+
+		node.prevFree = INVALID_NODE_INDEX;
+		node.nextFree = INVALID_NODE_INDEX;
+
+		if (mFreeListHeads[firstLevel * SL_INDEX_COUNT + secondLevel] == INVALID_NODE_INDEX)
+		{
+			mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+			if (mSecondLevelBitmaps[firstLevel] == 0u)
+			{
+				mFirstLevelBitmap &= ~(1ull << firstLevel);
+			}
+		}
+
+		mFreeBlockCount--;
+	}
+
+	uint32_t TlsfAllocator::CreateNode()
+	{
+		if (!mUnusedNodeIndices.empty())
+		{
+			const uint32_t nodeIndex = mUnusedNodeIndices.back();
+			mUnusedNodeIndices.pop_back();
+
+			mNodes[nodeIndex] = Node{};
+			return nodeIndex;
+		}
+
+		mNodes.emplace_back();
+		return static_cast<uint32_t>(mNodes.size() - 1u);
+	}
+
+	void TlsfAllocator::ReleaseNode(uint32_t nodeIndex)
+	{
+		mNodes[nodeIndex] = Node{};
+		mUnusedNodeIndices.push_back(nodeIndex);
+	}
+
+	TlsfStatistics TlsfAllocator::GetStatistics() const
+	{
+		TlsfStatistics statistics
+		{
+			.capacityInBytes = mCapacity,
+			.usedBytes = mUsedBytes,
+			.allocationCount = mAllocationCount,
+			.freeBlockCount = mFreeBlockCount,
+		};
+
+		// The largest free block is in the highest non empty bin.
+		if (mFirstLevelBitmap != 0u)
+		{
+			const uint32_t firstLevel = FloorLog2(mFirstLevelBitmap);
+			const uint32_t secondLevel = 31u - static_cast<uint32_t>(std::countl_zero(mSecondLevelBitmaps[firstLevel]));
+
+			for (uint32_t nodeIndex = mFreeListHeads[firstLevel * SL_INDEX_COUNT + secondLevel]; nodeIndex != INVALID_NODE_INDEX; nodeIndex = mNodes[nodeIndex].nextFree)
+			{
+				statistics.largestFreeBlockBytes = std::max(statistics.largestFreeBlockBytes, mNodes[nodeIndex].size);
+			}
+		}
+
+		return statistics;
+	}
+
+	std::vector<TlsfDefragmentationMove> TlsfAllocator::GetDefragmentationHints(uint32_t blockIndex) const
+	{
+		std::vector<TlsfDefragmentationMove> moves{};
+
+		// Find the first block in the physical chain (the one at offset 0).
+		uint32_t nodeIndex = INVALID_NODE_INDEX;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(mNodes.size()); ++i)
+		{
+			if (mNodes[i].size != 0u && mNodes[i].prevPhysical == INVALID_NODE_INDEX)
+			{
+				nodeIndex = i;
+				break;
+			}
+		}
+
+		uint64_t compactedOffset{};
+		for (; nodeIndex != INVALID_NODE_INDEX; nodeIndex = mNodes[nodeIndex].nextPhysical)
+		{
+			const Node& node = mNodes[nodeIndex];
+			if (node.isFree)
+			{
+				continue;
+			}
+
+			const uint64_t targetOffset = AlignUp(compactedOffset, node.alignment);
+			if (targetOffset < node.offset)
+			{
+				moves.push_back(
+					{
+						.blockIndex = blockIndex,
+						.nodeIndex = nodeIndex,
+						.currentOffset = node.offset,
+						.targetOffset = targetOffset,
+						.sizeInBytes = node.size
+					});
+			}
+
+			compactedOffset = std::min(targetOffset, node.offset) + node.size;
+		}
+
+		return moves;
+	}
+
+	bool TlsfAllocator::Validate() const
+	{
+		// Validate the physical chain.
+		uint32_t headIndex = INVALID_NODE_INDEX;
+		uint32_t nodeCount{};
+		for (uint32_t i = 0; i < static_cast<uint32_t>(mNodes.size()); ++i)
+		{
+			if (mNodes[i].size != 0u && mNodes[i].prevPhysical == INVALID_NODE_INDEX)
+			{
+				headIndex = i;
+				nodeCount++;
+			}
+		}
+
+		if (nodeCount != 1u || mNodes[headIndex].offset != 0u)
+		{
+			return false;
+		}
+
+		uint64_t expectedOffset{};
+		uint64_t usedBytes{};
+		uint32_t allocationCount{};
+		uint32_t freeBlockCount{};
+		bool previousIsFree{};
+
+		for (uint32_t nodeIndex = headIndex; nodeIndex != INVALID_NODE_INDEX; nodeIndex = mNodes[nodeIndex].nextPhysical)
+		{
+			const Node& node = mNodes[nodeIndex];
+
+			if (node.offset != expectedOffset || node.size == 0u)
+			{
+				return false;
+			}
+
+			if (node.nextPhysical != INVALID_NODE_INDEX && mNodes[node.nextPhysical].prevPhysical != nodeIndex)
+			{
+				return false;
+			}
+
+			if (node.isFree)
+			{
+				if (previousIsFree)
+				{
+					return false;
+				}
+
+				freeBlockCount++;
+			}
+			else
+			{
+				if (node.offset % node.alignment != 0u)
+				{
+					return false;
+				}
+
+				usedBytes += node.size;
+				allocationCount++;
+			}
+
+			previousIsFree = node.isFree;
+			expectedOffset += node.size;
+		}
+
+		if (expectedOffset != mCapacity || usedBytes != mUsedBytes || allocationCount != mAllocationCount || freeBlockCount != mFreeBlockCount)
+		{
+			return false;
+		}
+
+		// Validate the bins and bitmaps.
+		uint32_t binnedFreeBlockCount{};
+		for (uint32_t firstLevel = 0; firstLevel < FL_INDEX_COUNT; ++firstLevel)
+		{
+			const bool firstLevelBitSet = (mFirstLevelBitmap >> firstLevel) & 1u;
+			if (firstLevelBitSet != (mSecondLevelBitmaps[firstLevel] != 0u))
+			{
+				return false;
+			}
+
+			for (uint32_t secondLevel = 0; secondLevel < SL_INDEX_COUNT; ++secondLevel)
+			{
+				const uint32_t head = mFreeListHeads[firstLevel * SL_INDEX_COUNT + secondLevel];
+				const bool secondLevelBitSet = (mSecondLevelBitmaps[firstLevel] >> secondLevel) & 1u;
+
+				if (secondLevelBitSet != (head != INVALID_NODE_INDEX))
+				{
+					return false;
+				}
+
+				for (uint32_t nodeIndex = head; nodeIndex != INVALID_NODE_INDEX; nodeIndex = mNodes[nodeIndex].nextFree)
+				{
+					uint32_t nodeFirstLevel{};
+					uint32_t nodeSecondLevel{};
+					Mapping(mNodes[nodeIndex].size, nodeFirstLevel, nodeSecondLevel);
+
+					if (!mNodes[nodeIndex].isFree || nodeFirstLevel != firstLevel || nodeSecondLevel != secondLevel)
+					{
+						return false;
+					}
+
+					binnedFreeBlockCount++;
+				}
+			}
+		}
+
+		return binnedFreeBlockCount == mFreeBlockCount;
+	}
+
+	TlsfHeapPool::TlsfHeapPool(uint64_t blockSizeInBytes, BlockCallback onBlockCreated, BlockCallback onBlockDestroyed)
+		: mBlockSizeInBytes(blockSizeInBytes), mOnBlockCreated(std::move(onBlockCreated)), mOnBlockDestroyed(std::move(onBlockDestroyed))
+	{
+	}
+
+	TlsfHeapPool::~TlsfHeapPool()
+	{
+		for (uint32_t blockIndex = 0; blockIndex < static_cast<uint32_t>(mBlocks.size()); ++blockIndex)
+		{
+			if (mBlocks[blockIndex] && mOnBlockDestroyed)
+			{
+				mOnBlockDestroyed(blockIndex, mBlocks[blockIndex]->GetCapacity());
+			}
+		}
+	}
+
+	std::optional<TlsfHeapPoolAllocation> TlsfHeapPool::Allocate(uint64_t sizeInBytes, uint64_t alignment)
+	{
+		for (uint32_t blockIndex = 0; blockIndex < static_cast<uint32_t>(mBlocks.size()); ++blockIndex)
+		{
+			if (!mBlocks[blockIndex])
+			{
+				continue;
+			}
+
+			if (std::optional<TlsfAllocation> allocation = mBlocks[blockIndex]->Allocate(sizeInBytes, alignment))
+			{
+				return TlsfHeapPoolAllocation{ .blockIndex = blockIndex, .allocation = allocation.value() };
+			}
+		}
+
+		// No block can fit the allocation, so create a new one (reusing a empty slot if possible).
+		const uint64_t newBlockSize = std::max(mBlockSizeInBytes, AlignUp(sizeInBytes, std::max<uint64_t>(alignment, 1u)));
+
+		auto freeSlot = std::find(mBlocks.begin(), mBlocks.end(), nullptr);
+		const uint32_t blockIndex = static_cast<uint32_t>(std::distance(mBlocks.begin(), freeSlot));
+
+		if (freeSlot == mBlocks.end())
+		{
+			mBlocks.emplace_back();
+		}
+
+		mBlocks[blockIndex] = std::make_unique<TlsfAllocator>(newBlockSize);
+		if (mOnBlockCreated)
+		{
+			mOnBlockCreated(blockIndex, newBlockSize);
+		}
+
+		// Block offsets start at 0, which satisfies any alignment.
+		std::optional<TlsfAllocation> allocation = mBlocks[blockIndex]->Allocate(sizeInBytes, alignment);
+		if (!allocation.has_value())
+		{
+			return std::nullopt;
+		}
+
+		return TlsfHeapPoolAllocation{ .blockIndex = blockIndex, .allocation = allocation.value() };
+	}
+
+	void TlsfHeapPool::Free(const TlsfHeapPoolAllocation& allocation)
+	{
+		mBlocks[allocation.blockIndex]->Free(allocation.allocation);
+
+		if (!mBlocks[allocation.blockIndex]->IsEmpty())
+		{
+			return;
+		}
+
+		const bool otherEmptyBlockExists = std::any_of(mBlocks.begin(), mBlocks.end(), [&](const std::unique_ptr<TlsfAllocator>& block)
+		{
+			return block && block.get() != mBlocks[allocation.blockIndex].get() && block->IsEmpty();
+		});
+
+		// Dedicated (larger than block size) blocks are always destroyed once empty.
+		if (otherEmptyBlockExists || mBlocks[allocation.blockIndex]->GetCapacity() > mBlockSizeInBytes)
+		{
+			if (mOnBlockDestroyed)
+			{
+				mOnBlockDestroyed(allocation.blockIndex, mBlocks[allocation.blockIndex]->GetCapacity());
+			}
+
+			mBlocks[allocation.blockIndex].reset();
+		}
+	}
+
+	uint32_t TlsfHeapPool::GetBlockCount() const
+	{
+		return static_cast<uint32_t>(std::count_if(mBlocks.begin(), mBlocks.end(), [](const std::unique_ptr<TlsfAllocator>& block) { return block != nullptr; }));
+	}
+
+	TlsfStatistics TlsfHeapPool::GetStatistics() const
+	{
+		TlsfStatistics statistics{};
+
+		for (const std::unique_ptr<TlsfAllocator>& block : mBlocks)
+		{
+			if (!block)
+			{
+				continue;
+			}
+
+			const TlsfStatistics blockStatistics = block->GetStatistics();
+
+			statistics.capacityInBytes += blockStatistics.capacityInBytes;
+			statistics.usedBytes += blockStatistics.usedBytes;
+			statistics.allocationCount += blockStatistics.allocationCount;
+			statistics.freeBlockCount += blockStatistics.freeBlockCount;
+			statistics.largestFreeBlockBytes = std::max(statistics.largestFreeBlockBytes, blockStatistics.largestFreeBlockBytes);
+		}
+
+		return statistics;
+	}
+
+	std::vector<TlsfDefragmentationMove> TlsfHeapPool::GetDefragmentationHints() const
+	{
+		std::vector<TlsfDefragmentationMove> moves{};
+
+		for (uint32_t blockIndex = 0; blockIndex < static_cast<uint32_t>(mBlocks.size()); ++blockIndex)
+		{
+			if (!mBlocks[blockIndex])
+			{
+				continue;
+			}
+
+			std::vector<TlsfDefragmentationMove> blockMoves = mBlocks[blockIndex]->GetDefragmentationHints(blockIndex);
+			moves.insert(moves.end(), blockMoves.begin(), blockMoves.end());
+		}
+
+		return moves;
+	}
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+// The MemoryAllocator uses it to sub allocate ranges of ID3D12Heap's (see MemoryAllocator::CreatePlacedResourceAllocation).
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace helios::gfx
+{
+	struct TlsfAllocation
+	{
+		uint64_t offset{};
+		uint64_t sizeInBytes{};
+
+		// Handle used by the allocator to free the allocation.
+		uint32_t nodeIndex{};
+	};
+
+	struct TlsfStatistics
+	{
+		uint64_t capacityInBytes{};
+		uint64_t usedBytes{};
+		uint32_t allocationCount{};
+		uint32_t freeBlockCount{};
+		uint64_t largestFreeBlockBytes{};
+
+		// 0.0 if all free memory is a single contiguous range, approaches 1.0 as the free memory is split into many small ranges.
+		double GetFragmentation() const;
+	};
+
+	// Defragmentation hint : moving the allocation from currentOffset to targetOffset (in the order in which the hints are returned) compacts the block.
+	// Note : The source and destination ranges of a single move can overlap, in which case the data has to be copied through a intermediate resource.
+	struct TlsfDefragmentationMove
+	{
+		uint32_t blockIndex{};
+		uint32_t nodeIndex{};
+		uint64_t currentOffset{};
+		uint64_t targetOffset{};
+		uint64_t sizeInBytes{};
+	};
+
+	// Two level segregated fit allocator that manages offsets within a single range of capacityInBytes.
+	// Allocate and Free are O(1) : free blocks are placed into bins indexed by (first level = log2 of the size, second level = linear subdivision of that power of two range).
+	// Bitmaps of non empty bins are used to find a suitable free block with a couple of bit scans.
+	// Adjacent free blocks are always merged on free.
+	class TlsfAllocator
+	{
+	public:
+		static constexpr uint32_t SL_INDEX_COUNT_LOG2 = 5u;
+		static constexpr uint32_t SL_INDEX_COUNT = 1u << SL_INDEX_COUNT_LOG2;
+
+		// Sizes below SMALL_BLOCK_SIZE are placed into first level 0, with a second level bin per byte.
+		static constexpr uint32_t FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2;
+		static constexpr uint64_t SMALL_BLOCK_SIZE = 1ull << FL_INDEX_SHIFT;
+		static constexpr uint32_t FL_INDEX_COUNT = 64u - FL_INDEX_SHIFT + 1u;
+
+		// Free ranges smaller than this (from alignment padding / splitting) are not tracked separately, but are made part of a neighbouring allocation.
+		static constexpr uint64_t MIN_FREE_BLOCK_SIZE = 256u;
+
+		static constexpr uint32_t INVALID_NODE_INDEX = UINT32_MAX;
+
+	public:
+		explicit TlsfAllocator(uint64_t capacityInBytes);
+
+		// Returns std::nullopt if there is no free range large enough.
+		std::optional<TlsfAllocation> Allocate(uint64_t sizeInBytes, uint64_t alignment = 1u);
+		void Free(const TlsfAllocation& allocation);
+
+		uint64_t GetCapacity() const { return mCapacity; }
+		bool IsEmpty() const { return mAllocationCount == 0u; }
+
+		TlsfStatistics GetStatistics() const;
+
+		// Returns a plan that moves all allocations as close to offset 0 as possible, leaving a single free range at the end.
+		std::vector<TlsfDefragmentationMove> GetDefragmentationHints(uint32_t blockIndex = 0u) const;
+
+		// Checks all internal invariants (physical chain covers the range, no adjacent free blocks, bins / bitmaps are consistent).
+		bool Validate() const;
+
+	private:
+		struct Node
+		{
+			uint64_t offset{};
+			uint64_t size{};
+			uint64_t alignment{ 1u };
+
+			uint32_t prevPhysical{ INVALID_NODE_INDEX };
+			uint32_t nextPhysical{ INVALID_NODE_INDEX };
+
+			uint32_t prevFree{ INVALID_NODE_INDEX };
+			uint32_t nextFree{ INVALID_NODE_INDEX };
+
+			bool isFree{};
+		};
+
+		static void Mapping(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+		uint32_t FindFreeNode(uint64_t size) const;
+
+		void InsertFreeNode(uint32_t nodeIndex);
+		void RemoveFreeNode(uint32_t nodeIndex);
+
+		uint32_t CreateNode();
+		void ReleaseNode(uint32_t nodeIndex);
+
+	private:
+		uint64_t mCapacity{};
+		uint64_t mUsedBytes{};
+		uint32_t mAllocationCount{};
+		uint32_t mFreeBlockCount{};
+
+		std::vector<Node> mNodes{};
+		std::vector<uint32_t> mUnusedNodeIndices{};
+
+		uint64_t mFirstLevelBitmap{};
+		std::vector<uint32_t> mSecondLevelBitmaps{};
+		std::vector<uint32_t> mFreeListHeads{};
+	};
+
+	struct TlsfHeapPoolAllocation
+	{
+		uint32_t blockIndex{};
+		TlsfAllocation allocation{};
+	};
+
+	// Manages a growable list of TLSF blocks (each backing one heap). Blocks are created / destroyed through the callbacks, so the pool itself is API independent.
+	// Allocations larger than the block size get a dedicated block.
+	class TlsfHeapPool
+	{
+	public:
+		using BlockCallback = std::function<void(uint32_t blockIndex, uint64_t sizeInBytes)>;
+
+		TlsfHeapPool(uint64_t blockSizeInBytes, BlockCallback onBlockCreated = {}, BlockCallback onBlockDestroyed = {});
+		~TlsfHeapPool();
+
+		TlsfHeapPool(const TlsfHeapPool& other) = delete;
+		TlsfHeapPool& operator=(const TlsfHeapPool& other) = delete;
+
+		std::optional<TlsfHeapPoolAllocation> Allocate(uint64_t sizeInBytes, uint64_t alignment = 1u);
+
+		// Empty blocks are destroyed, except for one which is retained to avoid creating / destroying heaps on alternating allocate / free.
+		void Free(const TlsfHeapPoolAllocation& allocation);
+
+		uint32_t GetBlockCount() const;
+		TlsfStatistics GetStatistics() const;
+		std::vector<TlsfDefragmentationMove> GetDefragmentationHints() const;
+
+	private:
+		uint64_t mBlockSizeInBytes{};
+		BlockCallback mOnBlockCreated{};
+		BlockCallback mOnBlockDestroyed{};
+
+		// Null entries are block slots that can be reused.
+		std::vector<std::unique_ptr<TlsfAllocator>> mBlocks{};
+	};
+}
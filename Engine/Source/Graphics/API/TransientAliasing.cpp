@@ -0,0 +1,146 @@
+#include "TransientAliasing.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+namespace helios::gfx
+{
+	static inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		if (alignment <= 1u)
+		{
+			return value;
+		}
+
+		return (value + alignment - 1u) / alignment * alignment;
+	}
+
+	TransientAliasingResult ComputeAliasedPlacements(const std::vector<TransientResourceAliasingDesc>& resources)
+	{
+		TransientAliasingResult result{};
+		result.offsets.resize(resources.size());
+
+		// Larger resources are placed first, as they are the hardest to fit into gaps left by others.
+		// Ties are broken by the first pass so that the packing is deterministic.
+		std::vector<size_t> placementOrder(resources.size());
+		std::iota(placementOrder.begin(), placementOrder.end(), 0u);
+
+		std::stable_sort(placementOrder.begin(), placementOrder.end(), [&](size_t a, size_t b)
+		{
+			if (resources[a].sizeInBytes != resources[b].sizeInBytes)
+			{
+				return resources[a].sizeInBytes > resources[b].sizeInBytes;
+			}
+
+			return resources[a].lifetime.firstPass < resources[b].lifetime.firstPass;
+		});
+
+		struct MemoryRange
+		{
+			uint64_t begin{};
+			uint64_t end{};
+		};
+
+		std::vector<size_t> placedResources{};
+		placedResources.reserve(resources.size());
+
+		for (const size_t resourceIndex : placementOrder)
+		{
+			const TransientResourceAliasingDesc& resource = resources[resourceIndex];
+			// Note : Without aliasing, the resources would be placed back to back, so the padding required by their alignment is counted as well.
+			result.unaliasedSizeInBytes = AlignUp(result.unaliasedSizeInBytes, resource.alignment) + resource.sizeInBytes;
+
+			// Collect memory ranges of all placed resources that are alive at the same time as the current one.
+			std::vector<MemoryRange> occupiedRanges{};
+			for (const size_t placedIndex : placedResources)
+			{
+				if (resources[placedIndex].lifetime.Overlaps(resource.lifetime))
+				{
+					occupiedRanges.push_back({ result.offsets[placedIndex], result.offsets[placedIndex] + resources[placedIndex].sizeInBytes });
+				}
+			}
+
+			std::sort(occupiedRanges.begin(), occupiedRanges.end(), [](const MemoryRange& a, const MemoryRange& b) { return a.begin < b.begin; });
+
+			// First fit : walk the occupied ranges in order, and take the first gap large enough.
+			uint64_t candidateOffset{ 0u };
+			for (const MemoryRange& range : occupiedRanges)
+			{
+				if (candidateOffset + resource.sizeInBytes <= range.begin)
+				{
+					break;
+				}
+
+				candidateOffset = std::max(candidateOffset, AlignUp(range.end, resource.alignment));
+			}
+
+			result.offsets[resourceIndex] = candidateOffset;
+			result.heapSizeInBytes = std::max(result.heapSizeInBytes, candidateOffset + resource.sizeInBytes);
+
+			placedResources.push_back(resourceIndex);
+		}
+
+		return result;
+	}
+
+	bool ValidateAliasedPlacements(const std::vector<TransientResourceAliasingDesc>& resources, const TransientAliasingResult& result)
+	{
+		if (result.offsets.size() != resources.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < resources.size(); ++i)
+		{
+			if (resources[i].alignment > 1u && result.offsets[i] % resources[i].alignment != 0u)
+			{
+				return false;
+			}
+
+			if (result.offsets[i] + resources[i].sizeInBytes > result.heapSizeInBytes)
+			{
+				return false;
+			}
+
+			for (size_t j = i + 1; j < resources.size(); ++j)
+			{
+				if (!resources[i].lifetime.Overlaps(resources[j].lifetime))
+				{
+					continue;
+				}
+
+				const bool memoryOverlaps = result.offsets[i] < result.offsets[j] + resources[j].sizeInBytes && result.offsets[j] < result.offsets[i] + resources[i].sizeInBytes;
+				if (memoryOverlaps)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	std::string GenerateMemorySavingsReport(const std::vector<TransientResourceAliasingDesc>& resources, const TransientAliasingResult& result)
+	{
+		static constexpr double BYTES_TO_MB = 1.0 / (1024.0 * 1024.0);
+
+		std::string report{ "Transient resource aliasing report :\n" };
+		char line[256]{};
+
+		for (size_t i = 0; i < resources.size(); ++i)
+		{
+			std::snprintf(line, sizeof(line), "  %-48s %9.2f MB  offset %9.2f MB  passes [%u, %u]\n", resources[i].name.c_str(), resources[i].sizeInBytes * BYTES_TO_MB,
+				result.offsets[i] * BYTES_TO_MB, resources[i].lifetime.firstPass, resources[i].lifetime.lastPass);
+			report += line;
+		}
+
+		const double savedPercentage = result.unaliasedSizeInBytes == 0u ? 0.0 : 100.0 * (1.0 - static_cast<double>(result.heapSizeInBytes) / static_cast<double>(result.unaliasedSizeInBytes));
+
+		std::snprintf(line, sizeof(line), "  Without aliasing : %.2f MB, with aliasing : %.2f MB, saved : %.2f MB (%.1f%%)\n", result.unaliasedSizeInBytes * BYTES_TO_MB,
+			result.heapSizeInBytes * BYTES_TO_MB, (result.unaliasedSizeInBytes - std::min(result.unaliasedSizeInBytes, result.heapSizeInBytes)) * BYTES_TO_MB, savedPercentage);
+		report += line;
+
+		return report;
+	}
+}
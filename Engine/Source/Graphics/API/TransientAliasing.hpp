@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace helios::gfx
+{
+	// Inclusive range of pass indices (in frame execution order) in which a transient resource is read or written.
+	struct TransientResourceLifetime
+	{
+		uint32_t firstPass{};
+		uint32_t lastPass{};
+
+		bool Overlaps(const TransientResourceLifetime& other) const { return firstPass <= other.lastPass && other.firstPass <= lastPass; }
+	};
+
+	struct TransientResourceAliasingDesc
+	{
+		std::string name{};
+		uint64_t sizeInBytes{};
+		uint64_t alignment{};
+		TransientResourceLifetime lifetime{};
+	};
+
+	// Result of packing : offsets[i] is the heap offset of the i'th resource passed to ComputeAliasedPlacements.
+	// unaliasedSizeInBytes is the size of the heap if the resources were placed back to back (in the same order, with the same alignments) without aliasing.
+	struct TransientAliasingResult
+	{
+		std::vector<uint64_t> offsets{};
+		uint64_t heapSizeInBytes{};
+		uint64_t unaliasedSizeInBytes{};
+	};
+
+	// Assigns heap offsets to the resources such that two resources only share memory if their lifetimes do not overlap.
+	// Greedy approach : resources are placed largest first, each at the lowest aligned offset that does not collide with an already placed resource whose lifetime overlaps.
+	TransientAliasingResult ComputeAliasedPlacements(const std::vector<TransientResourceAliasingDesc>& resources);
+
+	// Returns true if no two resources with overlapping lifetimes have overlapping memory ranges, and all offsets are correctly aligned.
+	bool ValidateAliasedPlacements(const std::vector<TransientResourceAliasingDesc>& resources, const TransientAliasingResult& result);
+
+	// Human readable table of each resource (size, offset, lifetime) along with the memory saved by aliasing.
+	std::string GenerateMemorySavingsReport(const std::vector<TransientResourceAliasingDesc>& resources, const TransientAliasingResult& result);
+}
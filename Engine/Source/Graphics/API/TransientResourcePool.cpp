@@ -0,0 +1,117 @@
+#include "TransientResourcePool.hpp"
+
+#include "Device.hpp"
+#include "Context.hpp"
+
+#include "Core/Log.hpp"
+
+namespace helios::gfx
+{
+	RenderTarget* TransientResourcePool::AddRenderTarget(const TextureCreationDesc& textureCreationDesc, const TransientResourceLifetime& lifetime)
+	{
+		std::unique_ptr<TransientResource> transientResource = std::make_unique<TransientResource>();
+		transientResource->textureCreationDesc = textureCreationDesc;
+		transientResource->lifetime = lifetime;
+		transientResource->renderTarget = std::make_unique<RenderTarget>();
+		transientResource->renderTarget->renderTargetName = textureCreationDesc.name;
+		transientResource->renderTarget->renderTexture = std::make_unique<Texture>();
+
+		RenderTarget* renderTarget = transientResource->renderTarget.get();
+		mTransientResources.emplace_back(std::move(transientResource));
+
+		return renderTarget;
+	}
+
+	Texture* TransientResourcePool::AddDepthStencilTexture(const TextureCreationDesc& textureCreationDesc, const TransientResourceLifetime& lifetime)
+	{
+		std::unique_ptr<TransientResource> transientResource = std::make_unique<TransientResource>();
+		transientResource->textureCreationDesc = textureCreationDesc;
+		transientResource->lifetime = lifetime;
+		transientResource->texture = std::make_unique<Texture>();
+
+		Texture* texture = transientResource->texture.get();
+		mTransientResources.emplace_back(std::move(transientResource));
+
+		return texture;
+	}
+
+	void TransientResourcePool::ExtendLifetime(const RenderTarget* renderTarget, uint32_t lastPass)
+	{
+		for (const std::unique_ptr<TransientResource>& transientResource : mTransientResources)
+		{
+			if (transientResource->renderTarget.get() == renderTarget)
+			{
+				transientResource->lifetime.lastPass = std::max(transientResource->lifetime.lastPass, lastPass);
+				return;
+			}
+		}
+	}
+
+	void TransientResourcePool::Compile(Device* device, const Uint2& dimensions)
+	{
+		MemoryAllocator* memoryAllocator = device->GetMemoryAllocator();
+
+		std::vector<TransientResourceAliasingDesc> aliasingDescs{};
+		aliasingDescs.reserve(mTransientResources.size());
+
+		for (const std::unique_ptr<TransientResource>& transientResource : mTransientResources)
+		{
+			transientResource->textureCreationDesc.dimensions = dimensions;
+			transientResource->textureCreationDesc.aliasingAllocation = nullptr;
+
+			const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = memoryAllocator->GetTextureAllocationInfo(transientResource->textureCreationDesc);
+
+			aliasingDescs.push_back(
+				{
+					.name = WstringToString(transientResource->textureCreationDesc.name),
+					.sizeInBytes = allocationInfo.SizeInBytes,
+					.alignment = allocationInfo.Alignment,
+					.lifetime = transientResource->lifetime
+				});
+		}
+
+		mAliasingResult = ComputeAliasedPlacements(aliasingDescs);
+		if (!ValidateAliasedPlacements(aliasingDescs, mAliasingResult))
+		{
+			ErrorMessage(L"Transient resource placements are invalid : resources with overlapping lifetimes share memory.");
+		}
+
+		// Frames in flight may still use the old heap (and the resources placed in it), so it is released through the deferred release queue.
+		// The placed resources hold a reference to the heap, so the order in which they are released does not matter.
+		device->DeferredRelease(std::move(mHeapAllocation));
+
+		mHeapAllocation = memoryAllocator->CreateAliasingHeapAllocation(mAliasingResult.heapSizeInBytes, L"Transient Resource Heap");
+
+		for (size_t i = 0; i < mTransientResources.size(); ++i)
+		{
+			TransientResource* transientResource = mTransientResources[i].get();
+			transientResource->textureCreationDesc.aliasingAllocation = mHeapAllocation->allocation.Get();
+			transientResource->textureCreationDesc.aliasingOffset = mAliasingResult.offsets[i];
+
+			Texture* texture = transientResource->GetTexture();
+
+			// First compile creates the resources (and their descriptors), subsequent compiles recreate them (releasing the old ones once the GPU is done with them).
+			if (!texture->allocation)
+			{
+				*texture = device->CreateTexture(transientResource->textureCreationDesc);
+			}
+			else
+			{
+				device->ResizeTexture(texture, transientResource->textureCreationDesc);
+			}
+		}
+
+		core::LogMessage(StringToWString(GenerateMemorySavingsReport(aliasingDescs, mAliasingResult)), core::LogMessageTypes::Info);
+	}
+
+	void TransientResourcePool::AddAliasingBarriers(Context* context, uint32_t passIndex) const
+	{
+		for (const std::unique_ptr<TransientResource>& transientResource : mTransientResources)
+		{
+			if (transientResource->lifetime.firstPass == passIndex)
+			{
+				context->AddAliasingBarrier(nullptr, transientResource->GetTexture()->GetResource());
+			}
+		}
+	}
+}
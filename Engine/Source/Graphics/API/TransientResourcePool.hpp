@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Resources.hpp"
+#include "TransientAliasing.hpp"
+
+namespace helios::gfx
+{
+	class Device;
+	class Context;
+
+	// Owns all screen sized render targets / depth stencil textures that are only needed for a part of the frame.
+	// All resources are placed in a single heap, and resources whose lifetimes (range of passes in which they are used) do not overlap share memory.
+	// Usage : Add all resources (with their lifetimes), call Compile() once (and on every resize), and call AddAliasingBarriers() at the start of each pass.
+	class TransientResourcePool
+	{
+	public:
+		// The returned pointers remain valid for the lifetime of the pool (including across Compile calls).
+		RenderTarget* AddRenderTarget(const TextureCreationDesc& textureCreationDesc, const TransientResourceLifetime& lifetime);
+		Texture* AddDepthStencilTexture(const TextureCreationDesc& textureCreationDesc, const TransientResourceLifetime& lifetime);
+
+		// For resources that are read after their last 'real' use (i.e the editor displaying the GBuffer in the final pass).
+		void ExtendLifetime(const RenderTarget* renderTarget, uint32_t lastPass);
+
+		// Computes the placement of all resources and (re)creates the heap and resources. The old heap / resources are released using the device's deferred release queue.
+		void Compile(Device* device, const Uint2& dimensions);
+
+		// Adds an aliasing barrier for every resource that becomes active in pass passIndex.
+		void AddAliasingBarriers(Context* context, uint32_t passIndex) const;
+
+		uint64_t GetHeapSizeInBytes() const { return mAliasingResult.heapSizeInBytes; }
+		uint64_t GetUnaliasedSizeInBytes() const { return mAliasingResult.unaliasedSizeInBytes; }
+
+	private:
+		struct TransientResource
+		{
+			TextureCreationDesc textureCreationDesc{};
+			TransientResourceLifetime lifetime{};
+
+			// Only one of these is valid, depending on textureCreationDesc.usage.
+			std::unique_ptr<RenderTarget> renderTarget{};
+			std::unique_ptr<Texture> texture{};
+
+			Texture* GetTexture() const { return renderTarget ? renderTarget->renderTexture.get() : texture.get(); }
+		};
+
+		// Declared before the resources so that the placed resources are destroyed before the heap.
+		std::unique_ptr<Allocation> mHeapAllocation{};
+		TransientAliasingResult mAliasingResult{};
+
+		std::vector<std::unique_ptr<TransientResource>> mTransientResources{};
+	};
+}
@@ -3,6 +3,7 @@
 #include "DeferredGeometryPass.hpp"
 
 #include "../API/Device.hpp"
+#include "../API/TransientResourcePool.hpp"
 
 // For reference :
 // float4 albedo : SV_Target0;
@@ -12,7 +13,7 @@
 
 namespace helios::gfx
 {
-    DeferredGeometryPass::DeferredGeometryPass(const gfx::Device *device, const Uint2 &dimensions)
+    DeferredGeometryPass::DeferredGeometryPass(const gfx::Device *device, gfx::TransientResourcePool *transientResourcePool, const gfx::TransientResourceLifetime &lifetime)
     {
         // Create pipeline state.
 
@@ -30,81 +31,146 @@ namespace helios::gfx
 
         mDeferredPassPipelineState = std::make_unique<gfx::PipelineState>(device->GetDevice(), deferredPassPipelineStateCreationDesc);
 
-        // Create MRT's for GPass.
+        // With the depth pre-pass, only the closest surface passes the depth test (the depth buffer already contains its depth).
+        deferredPassPipelineStateCreationDesc.depthComparisonFunc = D3D12_COMPARISON_FUNC_EQUAL;
+        deferredPassPipelineStateCreationDesc.depthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+        deferredPassPipelineStateCreationDesc.pipelineName = L"Deferred Geometry Pass Depth Pre Pass Pipeline";
+
+        mDepthPrePassDeferredPassPipelineState = std::make_unique<gfx::PipelineState>(device->GetDevice(), deferredPassPipelineStateCreationDesc);
+
+        gfx::GraphicsPipelineStateCreationDesc depthPrePassPipelineStateCreationDesc
+        {
+            .shaderModule
+            {
+                .vsShaderPath = (L"Shaders/RenderPass/DepthPrePassVS.cso"),
+                .psShaderPath = (L"Shaders/RenderPass/DepthPrePassPS.cso"),
+            },
+            .rtvFormats = {},
+            .rtvCount = 0,
+            .pipelineName = L"Depth Pre Pass Pipeline"
+        };
+
+        mDepthPrePassPipelineState = std::make_unique<gfx::PipelineState>(device->GetDevice(), depthPrePassPipelineStateCreationDesc);
+
+        mHiZCullingPass = std::make_unique<gfx::HiZCullingPass>(device);
+
+        // Create MRT's for GPass (dimensions are set by the transient resource pool).
 
         gfx::TextureCreationDesc albedoRenderTargetTextureCreationDesc
         {
             .usage = gfx::TextureUsage::RenderTarget,
-            .dimensions = dimensions,
             .format = DXGI_FORMAT_R8G8B8A8_UNORM,
             .name = L"Deferred Pass Albedo Texture"
         };
 
-        mDeferredPassRTs.albedoRT = std::make_unique<gfx::RenderTarget>(device->CreateRenderTarget(albedoRenderTargetTextureCreationDesc));
+        mDeferredPassRTs.albedoRT = transientResourcePool->AddRenderTarget(albedoRenderTargetTextureCreationDesc, lifetime);
 
         gfx::TextureCreationDesc positionEmissiveRenderTargetTextureCreationDesc
         {
             .usage = gfx::TextureUsage::RenderTarget,
-            .dimensions = dimensions,
             .format = DXGI_FORMAT_R16G16B16A16_FLOAT,
             .name = L"Deferred Pass Position Emissive Texture"
         };
 
-        mDeferredPassRTs.positionEmissiveRT = std::make_unique<gfx::RenderTarget>(device->CreateRenderTarget(positionEmissiveRenderTargetTextureCreationDesc));
+        mDeferredPassRTs.positionEmissiveRT = transientResourcePool->AddRenderTarget(positionEmissiveRenderTargetTextureCreationDesc, lifetime);
 
         gfx::TextureCreationDesc normalEmissiveRenderTargetTextureCreationDesc
         {
             .usage = gfx::TextureUsage::RenderTarget,
-            .dimensions = dimensions,
             .format = DXGI_FORMAT_R16G16B16A16_FLOAT,
             .name = L"Deferred Pass Normal Emissive Texture"
         };
 
-        mDeferredPassRTs.normalEmissiveRT = std::make_unique<gfx::RenderTarget>(device->CreateRenderTarget(normalEmissiveRenderTargetTextureCreationDesc));
+        mDeferredPassRTs.normalEmissiveRT = transientResourcePool->AddRenderTarget(normalEmissiveRenderTargetTextureCreationDesc, lifetime);
 
         gfx::TextureCreationDesc aoMetalRoughnessEmissiveRenderTargetTextureCreationDesc
         {
             .usage = gfx::TextureUsage::RenderTarget,
-            .dimensions = dimensions,
             .format = DXGI_FORMAT_R16G16B16A16_FLOAT,
             .name = L"Deferred Pass AO Metal Roughness Emissive Texture"
         };
 
-        mDeferredPassRTs.aoMetalRoughnessEmissiveRT = std::make_unique<gfx::RenderTarget>(device->CreateRenderTarget(aoMetalRoughnessEmissiveRenderTargetTextureCreationDesc));
+        mDeferredPassRTs.aoMetalRoughnessEmissiveRT = transientResourcePool->AddRenderTarget(aoMetalRoughnessEmissiveRenderTargetTextureCreationDesc, lifetime);
     }
 
-    void DeferredGeometryPass::Render(scene::Scene *scene, gfx::GraphicsContext *graphicsContext, gfx::Texture *depthBuffer)
+    void DeferredGeometryPass::Render(gfx::Device* device, scene::Scene* scene, std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts, gfx::Texture* depthBuffer)
     {
         std::array<const gfx::RenderTarget *, 4u> renderTargets
         {
-            mDeferredPassRTs.albedoRT.get(),
-            mDeferredPassRTs.positionEmissiveRT.get(),
-            mDeferredPassRTs.normalEmissiveRT.get(),
-            mDeferredPassRTs.aoMetalRoughnessEmissiveRT.get(),
+            mDeferredPassRTs.albedoRT,
+            mDeferredPassRTs.positionEmissiveRT,
+            mDeferredPassRTs.normalEmissiveRT,
+            mDeferredPassRTs.aoMetalRoughnessEmissiveRT,
         };
 
-        graphicsContext->AddResourceBarrier(renderTargets, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
-        graphicsContext->ExecuteResourceBarriers();
-
-        graphicsContext->SetGraphicsPipelineState(mDeferredPassPipelineState.get());
-        graphicsContext->SetRenderTarget(renderTargets, depthBuffer);
-        graphicsContext->SetDefaultViewportAndScissor();
-        graphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        // Note : The render targets are transitioned by the render graph.
+        gfx::GraphicsContext* graphicsContext = graphicsContexts.back().get();
 
         graphicsContext->ClearRenderTargetView(renderTargets, std::array<float, 4u>{0.0f, 0.0f, 0.0f, 1.0f});
         graphicsContext->ClearDepthStencilView(depthBuffer, 1.0f);
 
-        scene->RenderModels(graphicsContext);
+        // All draws of the visible meshes are built (and uploaded) once, and executed by both passes with a single ExecuteIndirect each (per culling phase), so the
+        // pass is recorded into this context only.
+        scene->BuildIndirectDraws(device, graphicsContext);
 
-        graphicsContext->AddResourceBarrier(renderTargets, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-        graphicsContext->ExecuteResourceBarriers();
-    }
+        // Without the depth pre-pass, the G-Buffer pass writes depth.
+        const auto setDepthWritingPass = [&]()
+        {
+            if (mDepthPrePassEnabled)
+            {
+                graphicsContext->SetGraphicsPipelineState(mDepthPrePassPipelineState.get());
+                graphicsContext->SetRenderTarget(depthBuffer);
+            }
+            else
+            {
+                graphicsContext->SetGraphicsPipelineState(mDeferredPassPipelineState.get());
+                graphicsContext->SetRenderTarget(renderTargets, depthBuffer);
+            }
 
-    void DeferredGeometryPass::Resize(gfx::Device *device, const Uint2 &dimensions)
-    {
-        device->ResizeRenderTarget(mDeferredPassRTs.albedoRT.get());
-        device->ResizeRenderTarget(mDeferredPassRTs.positionEmissiveRT.get());
-        device->ResizeRenderTarget(mDeferredPassRTs.normalEmissiveRT.get());
-        device->ResizeRenderTarget(mDeferredPassRTs.aoMetalRoughnessEmissiveRT.get());
+            graphicsContext->SetDefaultViewportAndScissor();
+            graphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        };
+
+        const bool isHiZCullingEnabled = mHiZCullingEnabled && mHiZCullingPass->UpdatePyramid(device, depthBuffer->dimensions);
+
+        if (isHiZCullingEnabled)
+        {
+            mHiZCullingPass->Cull(device, graphicsContext, scene, scene::HiZCullingPhase::First);
+
+            setDepthWritingPass();
+            mHiZCullingPass->RenderVisibleDraws(graphicsContext, scene, scene::HiZCullingPhase::First);
+
+            // Note : The compute pipeline state set by the culling / pyramid dispatches replaces the graphics one, so the pass is set again.
+            mHiZCullingPass->BuildPyramid(device, graphicsContext, depthBuffer);
+            mHiZCullingPass->Cull(device, graphicsContext, scene, scene::HiZCullingPhase::Second);
+
+            setDepthWritingPass();
+            mHiZCullingPass->RenderVisibleDraws(graphicsContext, scene, scene::HiZCullingPhase::Second);
+        }
+        else
+        {
+            setDepthWritingPass();
+            scene->RenderModelsIndirect(graphicsContext);
+        }
+
+        if (!mDepthPrePassEnabled)
+        {
+            return;
+        }
+
+        graphicsContext->SetGraphicsPipelineState(mDepthPrePassDeferredPassPipelineState.get());
+        graphicsContext->SetRenderTarget(renderTargets, depthBuffer);
+        graphicsContext->SetDefaultViewportAndScissor();
+        graphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        if (isHiZCullingEnabled)
+        {
+            mHiZCullingPass->RenderVisibleDraws(graphicsContext, scene, scene::HiZCullingPhase::First);
+            mHiZCullingPass->RenderVisibleDraws(graphicsContext, scene, scene::HiZCullingPhase::Second);
+        }
+        else
+        {
+            scene->RenderModelsIndirect(graphicsContext);
+        }
     }
 } // namespace helios::gfx
@@ -2,6 +2,9 @@
 
 #include "../API/Resources.hpp"
 #include "../API/PipelineState.hpp"
+#include "../API/TransientAliasing.hpp"
+
+#include "HiZCullingPass.hpp"
 
 #include "../../Scene/Scene.hpp"
 
@@ -14,28 +17,45 @@ namespace helios::gfx
 	// float4 positionEmissive : SV_Target1;
 	// float4 normalEmissive : SV_Target2;
 	// float4 aoMetalRoughnessEmissive : SV_Target3;
+	// The RT's are owned (and resized) by the transient resource pool.
 	struct DeferredPassRTs
 	{
-		std::unique_ptr<gfx::RenderTarget> albedoRT{};
-		std::unique_ptr<gfx::RenderTarget> positionEmissiveRT{};
-		std::unique_ptr<gfx::RenderTarget> normalEmissiveRT{};
-		std::unique_ptr<gfx::RenderTarget> aoMetalRoughnessEmissiveRT{};
+		gfx::RenderTarget* albedoRT{};
+		gfx::RenderTarget* positionEmissiveRT{};
+		gfx::RenderTarget* normalEmissiveRT{};
+		gfx::RenderTarget* aoMetalRoughnessEmissiveRT{};
 	};
 
-	// This abstraction produces MRT's for various attributes (positions, albedo, normal etc) for a given scene. Handles resizing of all RT's too.
+	class TransientResourcePool;
+
+	// This abstraction produces MRT's for various attributes (positions, albedo, normal etc) for a given scene.
+	// The MRT's are transient : they are only alive (i.e not sharing memory with other resources) in the passes that are within lifetime.
 	class DeferredGeometryPass
 	{
 	public:
-		DeferredGeometryPass(const gfx::Device* device, const Uint2& dimensions);
-
-		void Render(scene::Scene* scene, gfx::GraphicsContext* graphicsContext, gfx::Texture* depthBuffer);
+		DeferredGeometryPass(const gfx::Device* device, gfx::TransientResourcePool* transientResourcePool, const gfx::TransientResourceLifetime& lifetime);
 
-		void Resize(gfx::Device* device, const Uint2& dimensions);
+		// The pass is recorded into graphicsContexts.back(), so the caller can record its own commands (i.e barriers) before and after it : the draws of the scene
+		// are built on the CPU once (see Scene::BuildIndirectDraws), and each of the passes below submits all of them with a single ExecuteIndirect.
+		// If the depth pre-pass is enabled, the scene is first rendered to the depth buffer only, and the G-Buffer is then rendered with an EQUAL depth test (without
+		// writing depth), so the G-Buffer is only written once per pixel (at the cost of transforming the geometry twice).
+		// If Hi-Z culling is enabled, the draws are culled on the GPU in two phases (see HiZCullingPass) : the depth of the draws kept by the first phase is rendered,
+		// the depth pyramid is built from it, and the depth of the draws kept by the second phase is rendered. The G-Buffer pass of the depth pre-pass then
+		// executes the draws of both phases.
+		void Render(gfx::Device* device, scene::Scene* scene, std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts, gfx::Texture* depthBuffer);
 
 	public:
 		DeferredPassRTs mDeferredPassRTs{};
 
 		std::unique_ptr<gfx::PipelineState> mDeferredPassPipelineState{};
+
+		std::unique_ptr<gfx::PipelineState> mDepthPrePassPipelineState{};
+		std::unique_ptr<gfx::PipelineState> mDepthPrePassDeferredPassPipelineState{};
+
+		bool mDepthPrePassEnabled{ false };
+
+		std::unique_ptr<gfx::HiZCullingPass> mHiZCullingPass{};
+		bool mHiZCullingEnabled{ true };
 	};
 
 }
@@ -0,0 +1,309 @@
+#include "HiZCullingPass.hpp"
+
+#include "../API/Device.hpp"
+
+namespace helios::gfx
+{
+    // Buffers are released once the frames in flight are done with them.
+    static void DeferredRelease(gfx::Device* const device, std::unique_ptr<gfx::Buffer>& buffer)
+    {
+        if (!buffer)
+        {
+            return;
+        }
+
+        device->DeferredRelease(std::move(buffer->allocation));
+        device->DeferredRelease(device->GetSrvCbvUavDescriptor(), gfx::Buffer::GetSrvIndex(buffer.get()));
+        device->DeferredRelease(device->GetSrvCbvUavDescriptor(), gfx::Buffer::GetUavIndex(buffer.get()));
+
+        buffer.reset();
+    }
+
+    HiZCullingPass::HiZCullingPass(const gfx::Device* device)
+    {
+        gfx::ComputePipelineStateCreationDesc copyDepthPipelineStateCreationDesc
+        {
+            .csShaderPath = L"Shaders/Culling/HiZCopyDepthCS.cso",
+            .pipelineName = L"Hi-Z Copy Depth Pipeline"
+        };
+
+        mCopyDepthPipelineState = std::make_unique<gfx::PipelineState>(device->CreatePipelineState(copyDepthPipelineStateCreationDesc));
+
+        gfx::ComputePipelineStateCreationDesc cullingPipelineStateCreationDesc
+        {
+            .csShaderPath = L"Shaders/Culling/HiZCullingCS.cso",
+            .pipelineName = L"Hi-Z Culling Pipeline"
+        };
+
+        mCullingPipelineState = std::make_unique<gfx::PipelineState>(device->CreatePipelineState(cullingPipelineStateCreationDesc));
+
+        gfx::BufferCreationDesc drawCountBufferCreationDesc
+        {
+            .usage = gfx::BufferUsage::UAVBuffer,
+            .name = L"Hi-Z Culling Draw Count Buffer"
+        };
+
+        // Both counts start at 0 : each phase resets the count of the other one (see HiZCullingCS.hlsl).
+        const std::array<uint32_t, 2u> drawCounts{};
+        mDrawCountBuffer = std::make_unique<gfx::Buffer>(device->CreateBuffer<uint32_t>(drawCountBufferCreationDesc, drawCounts));
+    }
+
+    bool HiZCullingPass::UpdatePyramid(gfx::Device* const device, const Uint2& dimensions)
+    {
+        if (mPyramid && mPyramidDimensions.x == dimensions.x && mPyramidDimensions.y == dimensions.y)
+        {
+            return mIsPyramidSupported;
+        }
+
+        ReleasePyramid(device);
+        CreatePyramid(device, dimensions);
+
+        return mIsPyramidSupported;
+    }
+
+    void HiZCullingPass::CreatePyramid(gfx::Device* const device, const Uint2& dimensions)
+    {
+        gfx::TextureCreationDesc pyramidCreationDesc
+        {
+            .usage = gfx::TextureUsage::UAVTexture,
+            .dimensions = dimensions,
+            .format = DXGI_FORMAT_R32G32_FLOAT,
+            .mipLevels = scene::GetHiZMipCount(dimensions.x, dimensions.y),
+            .name = L"Hi-Z Depth Pyramid",
+        };
+
+        mPyramid = std::make_unique<gfx::Texture>(device->CreateTexture(pyramidCreationDesc));
+        mPyramidDimensions = dimensions;
+        mIsPyramidValid = false;
+
+        mPyramidMipUavIndices.reserve(pyramidCreationDesc.mipLevels);
+        mPyramidMipUavIndices.push_back(gfx::Texture::GetUavIndex(mPyramid.get()));
+
+        for (uint32_t mipLevel : std::views::iota(1u, pyramidCreationDesc.mipLevels))
+        {
+            UavCreationDesc uavCreationDesc
+            {
+                .uavDesc
+                {
+                    .Format = pyramidCreationDesc.format,
+                    .ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D,
+                    .Texture2D
+                    {
+                        .MipSlice = mipLevel,
+                        .PlaneSlice = 0u
+                    }
+                }
+            };
+
+            mPyramidMipUavIndices.push_back(device->CreateUav(uavCreationDesc, mPyramid->GetResource()));
+        }
+
+        mIsPyramidSupported = device->GetMipMapGenerator()->IsSinglePassDownsampleEligible(mPyramid->GetResource()->GetDesc());
+    }
+
+    void HiZCullingPass::ReleasePyramid(gfx::Device* const device)
+    {
+        if (!mPyramid)
+        {
+            return;
+        }
+
+        // Note : Mip 0's UAV is the texture's own UAV.
+        device->DeferredRelease(std::move(mPyramid->allocation));
+        device->DeferredRelease(device->GetSrvCbvUavDescriptor(), gfx::Texture::GetSrvIndex(mPyramid.get()));
+
+        for (const uint32_t uavIndex : mPyramidMipUavIndices)
+        {
+            device->DeferredRelease(device->GetSrvCbvUavDescriptor(), uavIndex);
+        }
+
+        mPyramid.reset();
+        mPyramidMipUavIndices.clear();
+    }
+
+    void HiZCullingPass::ReserveBuffers(gfx::Device* const device, uint32_t drawCount, uint32_t meshDrawCount)
+    {
+        if (drawCount > mDrawCapacity)
+        {
+            DeferredRelease(device, mOutputArgumentBuffer);
+
+            mDrawCapacity = static_cast<uint32_t>(static_cast<float>(drawCount) * CAPACITY_GROWTH_FACTOR);
+
+            gfx::BufferCreationDesc outputArgumentBufferCreationDesc
+            {
+                .usage = gfx::BufferUsage::UAVBuffer,
+                .name = L"Hi-Z Culling Output Argument Buffer"
+            };
+
+            const std::vector<IndirectDrawArguments> outputArguments(mDrawCapacity * 2u);
+            mOutputArgumentBuffer = std::make_unique<gfx::Buffer>(device->CreateBuffer<IndirectDrawArguments>(outputArgumentBufferCreationDesc, outputArguments));
+        }
+
+        if (meshDrawCount > mVisibilityCapacity)
+        {
+            DeferredRelease(device, mVisibilityBuffer);
+
+            mVisibilityCapacity = static_cast<uint32_t>(static_cast<float>(meshDrawCount) * CAPACITY_GROWTH_FACTOR);
+
+            gfx::BufferCreationDesc visibilityBufferCreationDesc
+            {
+                .usage = gfx::BufferUsage::UAVBuffer,
+                .name = L"Hi-Z Culling Visibility Buffer"
+            };
+
+            // Note : The visibility is lost, so the first phase keeps no draw this frame (the second phase then keeps all the visible ones).
+            const std::vector<uint32_t> visibility(mVisibilityCapacity, 0u);
+            mVisibilityBuffer = std::make_unique<gfx::Buffer>(device->CreateBuffer<uint32_t>(visibilityBufferCreationDesc, visibility));
+        }
+    }
+
+    void HiZCullingPass::Cull(gfx::Device* const device, gfx::GraphicsContext* const graphicsContext, scene::Scene* const scene, scene::HiZCullingPhase phase)
+    {
+        const std::span<const scene::HiZDrawBounds> drawBounds = scene->GetIndirectDrawBounds();
+        const uint32_t drawCount = static_cast<uint32_t>(drawBounds.size());
+
+        if (phase == scene::HiZCullingPhase::First)
+        {
+            ReserveBuffers(device, drawCount, scene->GetMeshDrawCount());
+
+            mDrawBoundsVersionIndex = static_cast<uint32_t>(device->GetFrameNumber() % MAX_FRAMES_IN_FLIGHT);
+            DrawBoundsVersion& version = mDrawBoundsVersions[mDrawBoundsVersionIndex];
+
+            if (drawCount > version.capacity)
+            {
+                // Frames in flight may still cull with the old version.
+                if (version.allocation)
+                {
+                    device->DeferredRelease(std::move(version.allocation));
+                    device->DeferredRelease(device->GetSrvCbvUavDescriptor(), version.srvIndex);
+                }
+
+                version.capacity = mDrawCapacity;
+
+                const BufferCreationDesc drawBoundsBufferCreationDesc
+                {
+                    .usage = BufferUsage::UploadBuffer,
+                    .name = L"Hi-Z Culling Draw Bounds Buffer " + std::to_wstring(mDrawBoundsVersionIndex),
+                };
+
+                version.allocation = device->GetMemoryAllocator()->CreateBufferResourceAllocation(drawBoundsBufferCreationDesc,
+                    ResourceCreationDesc::CreateBufferResourceCreationDesc(static_cast<uint64_t>(version.capacity) * sizeof(scene::HiZDrawBounds)));
+
+                const SrvCreationDesc srvCreationDesc
+                {
+                    .srvDesc
+                    {
+                        .Format = DXGI_FORMAT_UNKNOWN,
+                        .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+                        .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+                        .Buffer
+                        {
+                            .FirstElement = 0u,
+                            .NumElements = version.capacity,
+                            .StructureByteStride = static_cast<UINT>(sizeof(scene::HiZDrawBounds)),
+                        }
+                    }
+                };
+
+                version.srvIndex = device->CreateSrv(srvCreationDesc, version.allocation->resource.Get());
+            }
+
+            if (drawCount != 0u)
+            {
+                version.allocation->Update(drawBounds.data(), drawBounds.size_bytes());
+            }
+        }
+
+        if (drawCount == 0u)
+        {
+            return;
+        }
+
+        graphicsContext->TrackResidency(mOutputArgumentBuffer.get());
+        graphicsContext->TrackResidency(mDrawCountBuffer.get());
+        graphicsContext->TrackResidency(mVisibilityBuffer.get());
+        graphicsContext->TrackResidency(mPyramid.get());
+
+        graphicsContext->TransitionResource(mOutputArgumentBuffer->allocation->resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        graphicsContext->TransitionResource(mDrawCountBuffer->allocation->resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        graphicsContext->TransitionResource(mVisibilityBuffer->allocation->resource.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        graphicsContext->TransitionResource(mPyramid->GetResource(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+
+        // The second phase reads the visibility written by the first one.
+        graphicsContext->AddUavBarrier(mVisibilityBuffer->allocation->resource.Get());
+        graphicsContext->ExecuteResourceBarriers();
+
+        HiZCullingRenderResources renderResources
+        {
+            .argumentBufferIndex = scene->GetIndirectDrawBuffer()->GetArgumentBufferIndex(),
+            .drawBoundsBufferIndex = mDrawBoundsVersions[mDrawBoundsVersionIndex].srvIndex,
+            .drawCount = drawCount,
+            .outputArgumentBufferIndex = gfx::Buffer::GetUavIndex(mOutputArgumentBuffer.get()),
+            .outputArgumentOffset = phase == scene::HiZCullingPhase::First ? 0u : mDrawCapacity,
+            .drawCountBufferIndex = gfx::Buffer::GetUavIndex(mDrawCountBuffer.get()),
+            .visibilityBufferIndex = gfx::Buffer::GetUavIndex(mVisibilityBuffer.get()),
+            .pyramidIndex = gfx::Texture::GetSrvIndex(mPyramid.get()),
+            .pyramidWidth = mPyramidDimensions.x,
+            .pyramidHeight = mPyramidDimensions.y,
+            .pyramidMipCount = static_cast<uint32_t>(mPyramidMipUavIndices.size()),
+            .isPyramidValid = mIsPyramidValid ? 1u : 0u,
+            .phase = static_cast<uint32_t>(phase),
+            .sceneBufferIndex = scene->GetSceneBufferIndex(),
+        };
+
+        graphicsContext->SetComputePipelineState(mCullingPipelineState.get());
+        graphicsContext->Set32BitComputeConstants(&renderResources);
+        graphicsContext->Dispatch((drawCount + CULLING_THREAD_GROUP_SIZE - 1u) / CULLING_THREAD_GROUP_SIZE, 1u, 1u);
+
+        graphicsContext->TransitionResource(mOutputArgumentBuffer->allocation->resource.Get(), D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+        graphicsContext->TransitionResource(mDrawCountBuffer->allocation->resource.Get(), D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+        graphicsContext->ExecuteResourceBarriers();
+    }
+
+    void HiZCullingPass::RenderVisibleDraws(const gfx::GraphicsContext* const graphicsContext, scene::Scene* const scene, scene::HiZCullingPhase phase)
+    {
+        if (scene->GetIndirectDrawBounds().empty())
+        {
+            return;
+        }
+
+        const uint64_t argumentBufferOffset = phase == scene::HiZCullingPhase::First ? 0u : static_cast<uint64_t>(mDrawCapacity) * sizeof(IndirectDrawArguments);
+        const uint64_t countBufferOffset = static_cast<uint64_t>(phase) * sizeof(uint32_t);
+
+        scene->RenderModelsIndirect(graphicsContext, mOutputArgumentBuffer->allocation->resource.Get(), argumentBufferOffset, mDrawCountBuffer->allocation->resource.Get(),
+            countBufferOffset);
+    }
+
+    void HiZCullingPass::BuildPyramid(gfx::Device* const device, gfx::GraphicsContext* const graphicsContext, gfx::Texture* const depthBuffer)
+    {
+        graphicsContext->TrackResidency(mPyramid.get());
+
+        graphicsContext->TransitionResource(depthBuffer->GetResource(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        graphicsContext->TransitionResource(mPyramid->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        graphicsContext->ExecuteResourceBarriers();
+
+        HiZCopyDepthRenderResources renderResources
+        {
+            .depthTextureIndex = gfx::Texture::GetSrvIndex(depthBuffer),
+            .pyramidMip0Index = mPyramidMipUavIndices.front(),
+            .width = mPyramidDimensions.x,
+            .height = mPyramidDimensions.y,
+        };
+
+        graphicsContext->SetComputePipelineState(mCopyDepthPipelineState.get());
+        graphicsContext->Set32BitComputeConstants(&renderResources);
+        graphicsContext->Dispatch((mPyramidDimensions.x + 7u) / 8u, (mPyramidDimensions.y + 7u) / 8u, 1u);
+
+        // The downsampler reads mip 0 through its UAV.
+        graphicsContext->AddUavBarrier(mPyramid->GetResource());
+        graphicsContext->ExecuteResourceBarriers();
+
+        device->GetMipMapGenerator()->RecordSinglePassDownsample(graphicsContext, mPyramid->GetResource()->GetDesc(), mPyramidMipUavIndices, DownsampleReduction::MinMax);
+
+        graphicsContext->TransitionResource(mPyramid->GetResource(), D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        graphicsContext->TransitionResource(depthBuffer->GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        graphicsContext->ExecuteResourceBarriers();
+
+        mIsPyramidValid = true;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../API/Resources.hpp"
+#include "../API/PipelineState.hpp"
+
+#include "../../Scene/Scene.hpp"
+
+namespace helios::gfx
+{
+	// Two phase occlusion culling of the scene's indirect draws (see Scene::BuildIndirectDraws) on the GPU, against a hierarchical depth pyramid.
+	// The first phase culls the draws visible in the previous frame against the pyramid of the previous frame, and the pyramid is rebuilt from the depth they
+	// wrote. The second phase culls all draws against it, and keeps the visible ones the first phase did not keep (see scene::HiZCullingPhase). The math
+	// is mirrored on the CPU by scene::CullHiZDraw, which the headless SandBox verifies against a per pixel depth buffer.
+	// The draws kept by a phase are written by HiZCullingCS.hlsl into an argument buffer, and executed by RenderVisibleDraws with the count written by the GPU.
+	// Everything is recorded into the given graphics context, as the pyramid is built between the draws of both phases.
+	class HiZCullingPass
+	{
+	public:
+		HiZCullingPass(const gfx::Device* device);
+
+		// Recreates the pyramid if the depth buffer was resized. Returns false if the single pass downsampler cannot build it (i.e if the depth buffer is larger
+		// than SPD_MAX_DIMENSION, or if R32G32_FLOAT does not support typed UAV loads), in which case all draws should be rendered without culling.
+		bool UpdatePyramid(gfx::Device* const device, const Uint2& dimensions);
+
+		// Culls the draws built by the last Scene::BuildIndirectDraws. The first phase must be culled first, once per frame, as it uploads the bounds of the draws.
+		void Cull(gfx::Device* const device, gfx::GraphicsContext* const graphicsContext, scene::Scene* const scene, scene::HiZCullingPhase phase);
+
+		// Executes the draws kept by the last Cull of the phase. The pipeline state, render targets etc must be set.
+		void RenderVisibleDraws(const gfx::GraphicsContext* const graphicsContext, scene::Scene* const scene, scene::HiZCullingPhase phase);
+
+		// Builds the pyramid from the depth buffer (in the depth write state, which it is left in) : the depth is copied into mip 0, which the single pass
+		// downsampler reduces with DownsampleReduction::MinMax.
+		void BuildPyramid(gfx::Device* const device, gfx::GraphicsContext* const graphicsContext, gfx::Texture* const depthBuffer);
+
+	private:
+		void CreatePyramid(gfx::Device* const device, const Uint2& dimensions);
+		void ReleasePyramid(gfx::Device* const device);
+
+		// Recreates the output arguments (with room to grow) and visibility buffers if the scene outgrew them.
+		void ReserveBuffers(gfx::Device* const device, uint32_t drawCount, uint32_t meshDrawCount);
+
+	public:
+		static constexpr uint32_t CULLING_THREAD_GROUP_SIZE = 64u;
+
+		// The buffers are recreated with this many times the required capacity, so they are not recreated every time the scene grows.
+		static constexpr float CAPACITY_GROWTH_FACTOR = 1.5f;
+
+		std::unique_ptr<gfx::PipelineState> mCopyDepthPipelineState{};
+		std::unique_ptr<gfx::PipelineState> mCullingPipelineState{};
+
+		// R32G32_FLOAT, holding the (minimum, maximum) depth of every texel (see scene::HiZPyramid). mPyramidMipUavIndices holds the UAV's of mip 0 onwards.
+		std::unique_ptr<gfx::Texture> mPyramid{};
+		std::vector<uint32_t> mPyramidMipUavIndices{};
+		Uint2 mPyramidDimensions{};
+		bool mIsPyramidSupported{ false };
+
+		// False until the pyramid is built (after it is created) : the first phase then keeps all draws visible in the previous frame.
+		bool mIsPyramidValid{ false };
+
+		// Bounds of the draws (scene::HiZDrawBounds), with a version per frame in flight (as for IndirectDrawBuffer).
+		struct DrawBoundsVersion
+		{
+			std::unique_ptr<Allocation> allocation{};
+			uint32_t srvIndex{ UINT32_MAX };
+			uint32_t capacity{};
+		};
+
+		std::array<DrawBoundsVersion, MAX_FRAMES_IN_FLIGHT> mDrawBoundsVersions{};
+		uint32_t mDrawBoundsVersionIndex{};
+
+		// The arguments kept by the first phase are written from index 0, and those of the second phase from index mDrawCapacity.
+		std::unique_ptr<gfx::Buffer> mOutputArgumentBuffer{};
+		uint32_t mDrawCapacity{};
+
+		// Draw count of each phase.
+		std::unique_ptr<gfx::Buffer> mDrawCountBuffer{};
+
+		// One uint per mesh draw of the scene (see scene::HiZDrawBounds::visibilityIndex), persisted across frames.
+		std::unique_ptr<gfx::Buffer> mVisibilityBuffer{};
+		uint32_t mVisibilityCapacity{};
+	};
+}
@@ -33,6 +33,8 @@ namespace helios::gfx
             .rtvFormats = {},
             .rtvCount = 0,
 			.cullMode = D3D12_CULL_MODE_FRONT,
+			// Casters between the light and the near plane are not culled (see Scene::CullShadowCasters), so they must be clamped to the near plane rather than clipped.
+			.depthClipEnable = false,
             .pipelineName = L"Shadow Mapping Pipeline State",
 		};
 
@@ -58,7 +60,7 @@ namespace helios::gfx
 		};
 	}
 
-	void ShadowPass::Render(scene::Scene* scene, gfx::GraphicsContext* graphicsContext)
+	void ShadowPass::Render(gfx::Device* device, scene::Scene* scene, std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
 	{
 		// Setup and update shadow constant buffer.
 		static D3D12_VIEWPORT viewport
@@ -82,14 +84,11 @@ namespace helios::gfx
 		mShadowMappingBufferData.viewProjectionMatrix = lightViewMatrix * lightProjectionMatrix;
 		mShadowMappingBuffer->Update(&mShadowMappingBufferData);
 
-		graphicsContext->AddResourceBarrier(mDepthTexture->GetResource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-		graphicsContext->ExecuteResourceBarriers();
+		// The light travels from lightPosition towards the origin.
+		scene->CullShadowCasters(mShadowMappingBufferData.viewProjectionMatrix, DirectX::XMVector3Normalize(directionalLightPositionVector));
 
-
-		graphicsContext->SetGraphicsPipelineState(mShadowPipelineState.get());
-		graphicsContext->SetRenderTarget(mDepthTexture.get());
-		graphicsContext->SetViewportAndScissor(viewport);
-		graphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		// Note : The depth texture is transitioned by the render graph.
+		gfx::GraphicsContext* graphicsContext = graphicsContexts.back().get();
 
 		graphicsContext->ClearDepthStencilView(mDepthTexture.get(), 1.0f);
 
@@ -98,9 +97,21 @@ namespace helios::gfx
 			.shadowMappingBufferIndex = gfx::Buffer::GetCbvIndex(mShadowMappingBuffer.get()),
 		};
 
-		scene->RenderModels(graphicsContext, renderResources);
+		const size_t drawGraphicsContextsIndex = graphicsContexts.size();
+		for (uint32_t i = 0; i < scene->GetRecordingChunkCount(); ++i)
+		{
+			graphicsContexts.push_back(device->GetGraphicsContext(mShadowPipelineState.get()));
+		}
 
-		graphicsContext->AddResourceBarrier(mDepthTexture->GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-		graphicsContext->ExecuteResourceBarriers();
+		scene->RenderModels(std::span(graphicsContexts).subspan(drawGraphicsContextsIndex), [&](gfx::GraphicsContext* drawGraphicsContext)
+		{
+			drawGraphicsContext->SetGraphicsPipelineState(mShadowPipelineState.get());
+			drawGraphicsContext->SetRenderTarget(mDepthTexture.get());
+			drawGraphicsContext->SetViewportAndScissor(viewport);
+			drawGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		}, renderResources);
+
+		// Commands recorded after the pass (i.e the render graph's barriers) go into the last context, which must execute after the draws.
+		graphicsContexts.push_back(device->GetGraphicsContext(mShadowPipelineState.get()));
 	}
 }
\ No newline at end of file
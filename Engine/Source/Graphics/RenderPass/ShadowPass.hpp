@@ -13,7 +13,8 @@ namespace helios::gfx
 	{
 	public:
 		ShadowPass(const gfx::Device* device);
-		void Render(scene::Scene* scene, gfx::GraphicsContext* graphicsContext);
+		// Same as DeferredGeometryPass::Render : setup commands are recorded into graphicsContexts.back(), and the draw / closing barrier contexts are appended.
+		void Render(gfx::Device* device, scene::Scene* scene, std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts);
 	
 	public:
 		static constexpr uint32_t SHADOW_MAP_DIMENSIONS = 2048u;
@@ -4,30 +4,56 @@
 #include "Core/Application.hpp"
 #include "Core/Engine.hpp"
 #include "Core/Timer.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/SnapshotBuffer.hpp"
 
 #include "Utility/Helpers.hpp"
 #include "Utility/ResourceManager.hpp"
 
 #include "Editor/Editor.hpp"
 
+#include "Graphics/API/CommandAllocatorPool.hpp"
 #include "Graphics/API/CommandQueue.hpp"
+#include "Graphics/API/CommandStream.hpp"
 #include "Graphics/API/ComputeContext.hpp"
 #include "Graphics/API/Descriptor.hpp"
 #include "Graphics/API/Device.hpp"
+#include "Graphics/API/DrawSorting.hpp"
 #include "Graphics/API/GraphicsContext.hpp"
+#include "Graphics/API/IndirectDraw.hpp"
+#include "Graphics/API/IndirectDrawBuffer.hpp"
 #include "Graphics/API/MemoryAllocator.hpp"
+#include "Graphics/API/MemoryStatistics.hpp"
 #include "Graphics/API/MipMapGenerator.hpp"
+#include "Graphics/API/NullRenderBackend.hpp"
 #include "Graphics/API/PipelineState.hpp"
+#include "Graphics/API/QueueScheduler.hpp"
+#include "Graphics/API/RenderBackend.hpp"
+#include "Graphics/API/RenderGraph.hpp"
+#include "Graphics/API/RenderGraphCompiler.hpp"
+#include "Graphics/API/ResidencyManager.hpp"
+#include "Graphics/API/ResidencyPolicy.hpp"
 #include "Graphics/API/Resources.hpp"
+#include "Graphics/API/ResourceStateTracker.hpp"
+#include "Graphics/API/SinglePassDownsampler.hpp"
+#include "Graphics/API/TlsfAllocator.hpp"
+#include "Graphics/API/TransientAliasing.hpp"
+#include "Graphics/API/TransientResourcePool.hpp"
 
 #include "Graphics/RenderPass/DeferredGeometryPass.hpp"
 #include "Graphics/RenderPass/ShadowPass.hpp"
 #include "Graphics/RenderPass/BloomPass.hpp"
+#include "Graphics/RenderPass/HiZCullingPass.hpp"
 
+#include "Scene/BoundingVolumeHierarchy.hpp"
 #include "Scene/Camera.hpp"
+#include "Scene/FrustumCulling.hpp"
+#include "Scene/HiZCulling.hpp"
 #include "Scene/Light.hpp"
 #include "Scene/Model.hpp"
+#include "Scene/OcclusionCulling.hpp"
 #include "Scene/Scene.hpp"
+#include "Scene/ShadowCasterCulling.hpp"
 #include "Scene/SkyBox.hpp"
 
 // File with all constant buffer structs shared between C++ and HLSL.
@@ -38,6 +38,8 @@
 // STL Includes.
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <iostream>
 #include <chrono>
@@ -48,6 +50,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <random>
 #include <ranges>
@@ -64,6 +67,7 @@
 #include "Utility/Helpers.hpp"
 #include "Utility/ResourceManager.hpp"
 #include "Core/Log.hpp"
+#include "Core/JobSystem.hpp"
 
 // To be used only in the .cpp files.
 namespace wrl = Microsoft::WRL;
@@ -0,0 +1,761 @@
+#include "BoundingVolumeHierarchy.hpp"
+
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+
+namespace helios::scene
+{
+	// Traversal / object test cost ratio of the SAH.
+	static constexpr float SAH_TRAVERSAL_COST = 1.0f;
+
+	// Number of objects per job when binning a node in parallel.
+	static constexpr uint32_t PARALLEL_BINNING_BATCH_SIZE = 16384u;
+
+	static constexpr BoundingBox EMPTY_BOUNDING_BOX
+	{
+		.minimum = { std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() },
+		.maximum = { -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() },
+	};
+
+	static void ExpandBoundingBox(BoundingBox& boundingBox, const BoundingBox& other)
+	{
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			boundingBox.minimum[axis] = std::min(boundingBox.minimum[axis], other.minimum[axis]);
+			boundingBox.maximum[axis] = std::max(boundingBox.maximum[axis], other.maximum[axis]);
+		}
+	}
+
+	static void ExpandBoundingBox(BoundingBox& boundingBox, const Float3& point)
+	{
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			boundingBox.minimum[axis] = std::min(boundingBox.minimum[axis], point[axis]);
+			boundingBox.maximum[axis] = std::max(boundingBox.maximum[axis], point[axis]);
+		}
+	}
+
+	// 0 for empty boxes.
+	static float ComputeSurfaceArea(const BoundingBox& boundingBox)
+	{
+		const float sizeX = std::max(boundingBox.maximum[0] - boundingBox.minimum[0], 0.0f);
+		const float sizeY = std::max(boundingBox.maximum[1] - boundingBox.minimum[1], 0.0f);
+		const float sizeZ = std::max(boundingBox.maximum[2] - boundingBox.minimum[2], 0.0f);
+
+		return 2.0f * (sizeX * sizeY + sizeY * sizeZ + sizeZ * sizeX);
+	}
+
+	// Same computation as CullBoundingBoxes (via BoundingBoxSoA::Set), so the queries keep exactly the same boxes.
+	static bool IsBoundingBoxOutsidePlane(const Plane& plane, const BoundingBox& boundingBox, bool& isInsidePlane)
+	{
+		const float centerX = (boundingBox.minimum[0] + boundingBox.maximum[0]) * 0.5f;
+		const float centerY = (boundingBox.minimum[1] + boundingBox.maximum[1]) * 0.5f;
+		const float centerZ = (boundingBox.minimum[2] + boundingBox.maximum[2]) * 0.5f;
+		const float extentX = (boundingBox.maximum[0] - boundingBox.minimum[0]) * 0.5f;
+		const float extentY = (boundingBox.maximum[1] - boundingBox.minimum[1]) * 0.5f;
+		const float extentZ = (boundingBox.maximum[2] - boundingBox.minimum[2]) * 0.5f;
+
+		const float distance = plane[0] * centerX + plane[1] * centerY + plane[2] * centerZ + plane[3];
+		const float radius = std::abs(plane[0]) * extentX + std::abs(plane[1]) * extentY + std::abs(plane[2]) * extentZ;
+
+		isInsidePlane = distance - radius >= 0.0f;
+
+		return distance + radius < 0.0f;
+	}
+
+	// The inverse direction is computed once per query. Components of the direction that are 0 give infinite inverses : the slab distances are then
+	// infinite (or NaN if the origin is on the slab plane, which std::min / std::max ignore), so the slab does not restrict the ray.
+	struct RayTraversal
+	{
+		explicit RayTraversal(const Ray& ray) : origin(ray.origin), inverseDirection{ 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] }
+		{
+		}
+
+		std::optional<float> Intersect(const BoundingBox& boundingBox, float maxDistance) const
+		{
+			float entryDistance = 0.0f;
+			float exitDistance = maxDistance;
+
+			for (size_t axis = 0u; axis < 3u; ++axis)
+			{
+				float slabEntryDistance = (boundingBox.minimum[axis] - origin[axis]) * inverseDirection[axis];
+				float slabExitDistance = (boundingBox.maximum[axis] - origin[axis]) * inverseDirection[axis];
+				if (inverseDirection[axis] < 0.0f)
+				{
+					std::swap(slabEntryDistance, slabExitDistance);
+				}
+
+				entryDistance = std::max(entryDistance, slabEntryDistance);
+				exitDistance = std::min(exitDistance, slabExitDistance);
+			}
+
+			if (entryDistance > exitDistance)
+			{
+				return std::nullopt;
+			}
+
+			return entryDistance;
+		}
+
+		Float3 origin{};
+		Float3 inverseDirection{};
+	};
+
+	std::optional<float> IntersectRayBoundingBox(const Ray& ray, const BoundingBox& boundingBox)
+	{
+		return RayTraversal(ray).Intersect(boundingBox, ray.maxDistance);
+	}
+
+	bool IntersectSphereBoundingBox(const BoundingSphere& boundingSphere, const BoundingBox& boundingBox)
+	{
+		float squaredDistance{};
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			const float center = boundingSphere.center[axis];
+			if (center < boundingBox.minimum[axis])
+			{
+				squaredDistance += (boundingBox.minimum[axis] - center) * (boundingBox.minimum[axis] - center);
+			}
+			else if (center > boundingBox.maximum[axis])
+			{
+				squaredDistance += (center - boundingBox.maximum[axis]) * (center - boundingBox.maximum[axis]);
+			}
+		}
+
+		return squaredDistance <= boundingSphere.radius * boundingSphere.radius;
+	}
+
+	// Bins with more centers than this are not worth it (each split plane is swept for each node).
+	static constexpr uint32_t MAX_SAH_BIN_COUNT = 64u;
+
+	// The objects are partitioned by value (rather than through mObjectIndices), so binning reads them sequentially.
+	struct BuildObject
+	{
+		BoundingBox boundingBox{};
+		Float3 center{};
+		uint32_t objectIndex{};
+	};
+
+	struct BoundingVolumeHierarchy::BuildState
+	{
+		BoundingVolumeHierarchyBuildDesc buildDesc{};
+
+		std::vector<BuildObject> objects{};
+		std::atomic<uint32_t> nodeCount{};
+	};
+
+	// A range of BuildState::objects (and of mObjectIndices once built), with the bounds of its objects and of their centers.
+	struct BoundingVolumeHierarchy::BuildRange
+	{
+		uint32_t objectBegin{};
+		uint32_t objectEnd{};
+
+		BoundingBox boundingBox{ EMPTY_BOUNDING_BOX };
+		BoundingBox centerBoundingBox{ EMPTY_BOUNDING_BOX };
+	};
+
+	// The bounds of the objects and of the centers of a bin are kept, so the bounds of both children are known once the split is chosen (without another
+	// pass over their objects).
+	struct SahBin
+	{
+		BoundingBox boundingBox{ EMPTY_BOUNDING_BOX };
+		BoundingBox centerBoundingBox{ EMPTY_BOUNDING_BOX };
+		uint32_t objectCount{};
+	};
+
+	static void ExpandSahBin(SahBin& bin, const SahBin& other)
+	{
+		ExpandBoundingBox(bin.boundingBox, other.boundingBox);
+		ExpandBoundingBox(bin.centerBoundingBox, other.centerBoundingBox);
+		bin.objectCount += other.objectCount;
+	}
+
+	// Calls reduceBatch(begin, end) on batches of [objectBegin, objectEnd) in parallel (or on the whole range if isParallel is false), and merges the
+	// results in order with merge(result, batchResult).
+	template <typename Result, typename ReduceBatchFunction, typename MergeFunction>
+	static Result ReduceObjectRange(uint32_t objectBegin, uint32_t objectEnd, bool isParallel, const ReduceBatchFunction& reduceBatch, const MergeFunction& merge)
+	{
+		if (!isParallel)
+		{
+			return reduceBatch(objectBegin, objectEnd);
+		}
+
+		const uint32_t objectCount = objectEnd - objectBegin;
+		std::vector<Result> batchResults((objectCount + PARALLEL_BINNING_BATCH_SIZE - 1u) / PARALLEL_BINNING_BATCH_SIZE);
+
+		core::JobSystem::Get().ParallelFor(objectCount, PARALLEL_BINNING_BATCH_SIZE, [&](uint32_t begin, uint32_t end)
+		{
+			batchResults[begin / PARALLEL_BINNING_BATCH_SIZE] = reduceBatch(objectBegin + begin, objectBegin + end);
+		});
+
+		Result result = std::move(batchResults.front());
+		for (size_t i = 1u; i < batchResults.size(); ++i)
+		{
+			merge(result, batchResults[i]);
+		}
+
+		return result;
+	}
+
+	void BoundingVolumeHierarchy::Build(std::span<const BoundingBox> boundingBoxes, const BoundingVolumeHierarchyBuildDesc& buildDesc)
+	{
+		const uint32_t objectCount = static_cast<uint32_t>(boundingBoxes.size());
+
+		mObjectBoundingBoxes.assign(boundingBoxes.begin(), boundingBoxes.end());
+		mObjectLeafIndices.assign(objectCount, INVALID_INDEX);
+		mObjectIndices.resize(objectCount);
+
+		mDirtyNodeIndices.clear();
+		mBuildSahCost = 0.0f;
+
+		if (objectCount == 0u)
+		{
+			mNodes.clear();
+			mParentIndices.clear();
+			mIsNodeDirty.clear();
+
+			return;
+		}
+
+		BuildState buildState
+		{
+			.buildDesc = buildDesc,
+			.objects = std::vector<BuildObject>(objectCount),
+		};
+
+		buildState.buildDesc.maxLeafObjectCount = std::max(buildState.buildDesc.maxLeafObjectCount, 1u);
+		buildState.buildDesc.binCount = std::clamp(buildState.buildDesc.binCount, 2u, MAX_SAH_BIN_COUNT);
+
+		BuildRange rootRange
+		{
+			.objectBegin = 0u,
+			.objectEnd = objectCount,
+		};
+
+		for (uint32_t i = 0u; i < objectCount; ++i)
+		{
+			BuildObject& object = buildState.objects[i];
+			object.boundingBox = boundingBoxes[i];
+			object.objectIndex = i;
+
+			for (size_t axis = 0u; axis < 3u; ++axis)
+			{
+				object.center[axis] = (boundingBoxes[i].minimum[axis] + boundingBoxes[i].maximum[axis]) * 0.5f;
+			}
+
+			ExpandBoundingBox(rootRange.boundingBox, object.boundingBox);
+			ExpandBoundingBox(rootRange.centerBoundingBox, object.center);
+		}
+
+		// A binary tree with objectCount leaves (at most) has 2 * objectCount - 1 nodes (at most). The nodes are allocated from the front, and the unused ones trimmed.
+		mNodes.resize(2u * objectCount - 1u);
+		mParentIndices.resize(2u * objectCount - 1u);
+		buildState.nodeCount = 1u;
+
+		BuildNode(buildState, 0u, rootRange, INVALID_INDEX);
+
+		mNodes.resize(buildState.nodeCount);
+		mParentIndices.resize(buildState.nodeCount);
+		mIsNodeDirty.assign(buildState.nodeCount, 0u);
+
+		mBuildSahCost = GetSahCost();
+	}
+
+	void BoundingVolumeHierarchy::BuildNode(BuildState& buildState, uint32_t nodeIndex, const BuildRange& buildRange, uint32_t parentIndex)
+	{
+		const BoundingVolumeHierarchyBuildDesc& buildDesc = buildState.buildDesc;
+		const uint32_t objectBegin = buildRange.objectBegin;
+		const uint32_t objectEnd = buildRange.objectEnd;
+		const uint32_t objectCount = objectEnd - objectBegin;
+		const bool isParallel = buildDesc.parallelObjectCount != 0u && objectCount > buildDesc.parallelObjectCount;
+
+		mParentIndices[nodeIndex] = parentIndex;
+
+		Node& node = mNodes[nodeIndex];
+		node.boundingBox = buildRange.boundingBox;
+
+		const auto MakeLeaf = [&]()
+		{
+			node.firstIndex = objectBegin;
+			node.objectCount = objectCount;
+
+			for (uint32_t i = objectBegin; i < objectEnd; ++i)
+			{
+				mObjectIndices[i] = buildState.objects[i].objectIndex;
+				mObjectLeafIndices[mObjectIndices[i]] = nodeIndex;
+			}
+		};
+
+		if (objectCount == 1u)
+		{
+			MakeLeaf();
+			return;
+		}
+
+		// Bins the object centers along each axis (the axes along which all centers are equal cannot be split). Small nodes use as many bins as objects,
+		// as sweeping the empty bins would dominate the build time of the bottom of the tree.
+		const uint32_t binCount = std::min(buildDesc.binCount, objectCount);
+		std::array<float, 3u> binScales{};
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			const float centerExtent = buildRange.centerBoundingBox.maximum[axis] - buildRange.centerBoundingBox.minimum[axis];
+			binScales[axis] = centerExtent > 0.0f ? static_cast<float>(binCount) / centerExtent : 0.0f;
+		}
+
+		const auto GetBinIndex = [&](const BuildObject& object, size_t axis)
+		{
+			const float offset = (object.center[axis] - buildRange.centerBoundingBox.minimum[axis]) * binScales[axis];
+			return std::min(binCount - 1u, static_cast<uint32_t>(offset));
+		};
+
+		const std::vector<SahBin> bins = ReduceObjectRange<std::vector<SahBin>>(objectBegin, objectEnd, isParallel && objectCount > PARALLEL_BINNING_BATCH_SIZE,
+			[&](uint32_t begin, uint32_t end)
+			{
+				std::vector<SahBin> batchBins(3u * binCount);
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const BuildObject& object = buildState.objects[i];
+					for (size_t axis = 0u; axis < 3u; ++axis)
+					{
+						SahBin& bin = batchBins[axis * binCount + GetBinIndex(object, axis)];
+						ExpandBoundingBox(bin.boundingBox, object.boundingBox);
+						ExpandBoundingBox(bin.centerBoundingBox, object.center);
+						++bin.objectCount;
+					}
+				}
+
+				return batchBins;
+			},
+			[](std::vector<SahBin>& result, const std::vector<SahBin>& batchResult)
+			{
+				for (size_t i = 0u; i < result.size(); ++i)
+				{
+					ExpandSahBin(result[i], batchResult[i]);
+				}
+			});
+
+		// Sweeps the split planes between bins : cost = traversal + (area(left) * count(left) + area(right) * count(right)) / area(node).
+		const float nodeArea = ComputeSurfaceArea(node.boundingBox);
+
+		float bestSplitCost = std::numeric_limits<float>::infinity();
+		size_t bestSplitAxis{};
+		uint32_t bestSplitBinIndex{};
+
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			if (binScales[axis] == 0.0f || nodeArea <= 0.0f)
+			{
+				continue;
+			}
+
+			const SahBin* axisBins = &bins[axis * binCount];
+
+			// rightCosts[i] is the cost of the bins (i, binCount), or a negative value if they are empty.
+			std::array<float, MAX_SAH_BIN_COUNT> rightCosts{};
+			BoundingBox rightBoundingBox{ EMPTY_BOUNDING_BOX };
+			uint32_t rightObjectCount{};
+			for (uint32_t i = binCount - 1u; i > 0u; --i)
+			{
+				ExpandBoundingBox(rightBoundingBox, axisBins[i].boundingBox);
+				rightObjectCount += axisBins[i].objectCount;
+				rightCosts[i - 1u] = rightObjectCount == 0u ? -1.0f : ComputeSurfaceArea(rightBoundingBox) * static_cast<float>(rightObjectCount);
+			}
+
+			BoundingBox leftBoundingBox{ EMPTY_BOUNDING_BOX };
+			uint32_t leftObjectCount{};
+			for (uint32_t i = 0u; i + 1u < binCount; ++i)
+			{
+				ExpandBoundingBox(leftBoundingBox, axisBins[i].boundingBox);
+				leftObjectCount += axisBins[i].objectCount;
+
+				if (leftObjectCount == 0u || rightCosts[i] < 0.0f)
+				{
+					continue;
+				}
+
+				const float splitCost = SAH_TRAVERSAL_COST + (ComputeSurfaceArea(leftBoundingBox) * static_cast<float>(leftObjectCount) + rightCosts[i]) / nodeArea;
+				if (splitCost < bestSplitCost)
+				{
+					bestSplitCost = splitCost;
+					bestSplitAxis = axis;
+					bestSplitBinIndex = i;
+				}
+			}
+		}
+
+		const bool hasSplit = bestSplitCost != std::numeric_limits<float>::infinity();
+		if (objectCount <= buildDesc.maxLeafObjectCount && (!hasSplit || bestSplitCost >= static_cast<float>(objectCount)))
+		{
+			MakeLeaf();
+			return;
+		}
+
+		BuildRange leftRange{ .objectBegin = objectBegin };
+		BuildRange rightRange{ .objectEnd = objectEnd };
+
+		if (hasSplit)
+		{
+			leftRange.objectEnd = static_cast<uint32_t>(std::partition(buildState.objects.begin() + objectBegin, buildState.objects.begin() + objectEnd, [&](const BuildObject& object)
+			{
+				return GetBinIndex(object, bestSplitAxis) <= bestSplitBinIndex;
+			}) - buildState.objects.begin());
+
+			SahBin leftBin{};
+			SahBin rightBin{};
+			for (uint32_t i = 0u; i < binCount; ++i)
+			{
+				ExpandSahBin(i <= bestSplitBinIndex ? leftBin : rightBin, bins[bestSplitAxis * binCount + i]);
+			}
+
+			leftRange.boundingBox = leftBin.boundingBox;
+			leftRange.centerBoundingBox = leftBin.centerBoundingBox;
+			rightRange.boundingBox = rightBin.boundingBox;
+			rightRange.centerBoundingBox = rightBin.centerBoundingBox;
+		}
+		else
+		{
+			// Note : All centers are equal, so no plane separates the objects : they are split in two halves (in their current order) to bound the leaf size.
+			leftRange.objectEnd = objectBegin + objectCount / 2u;
+			leftRange.centerBoundingBox = buildRange.centerBoundingBox;
+			rightRange.centerBoundingBox = buildRange.centerBoundingBox;
+
+			for (uint32_t i = objectBegin; i < objectEnd; ++i)
+			{
+				ExpandBoundingBox(i < leftRange.objectEnd ? leftRange.boundingBox : rightRange.boundingBox, buildState.objects[i].boundingBox);
+			}
+		}
+
+		rightRange.objectBegin = leftRange.objectEnd;
+
+		const uint32_t childIndex = buildState.nodeCount.fetch_add(2u, std::memory_order_relaxed);
+		node.firstIndex = childIndex;
+		node.objectCount = 0u;
+
+		// The children cover disjoint ranges of objects and nodes, so they can be built in parallel.
+		if (isParallel)
+		{
+			core::JobCounter jobCounter{};
+			core::JobSystem::Get().Schedule([&, childIndex]() { BuildNode(buildState, childIndex + 1u, rightRange, nodeIndex); }, &jobCounter);
+
+			BuildNode(buildState, childIndex, leftRange, nodeIndex);
+
+			core::JobSystem::Get().Wait(jobCounter);
+			return;
+		}
+
+		BuildNode(buildState, childIndex, leftRange, nodeIndex);
+		BuildNode(buildState, childIndex + 1u, rightRange, nodeIndex);
+	}
+
+	void BoundingVolumeHierarchy::UpdateObject(uint32_t objectIndex, const BoundingBox& boundingBox)
+	{
+		mObjectBoundingBoxes[objectIndex] = boundingBox;
+
+		// Stops at the first marked node, as its ancestors are marked too.
+		for (uint32_t nodeIndex = mObjectLeafIndices[objectIndex]; nodeIndex != INVALID_INDEX && mIsNodeDirty[nodeIndex] == 0u; nodeIndex = mParentIndices[nodeIndex])
+		{
+			mIsNodeDirty[nodeIndex] = 1u;
+			mDirtyNodeIndices.push_back(nodeIndex);
+		}
+	}
+
+	uint32_t BoundingVolumeHierarchy::Refit()
+	{
+		// Children have larger indices than their parent : visiting the nodes by decreasing index refits the children first. If most nodes moved, scanning
+		// the flags of all nodes is cheaper than sorting the marked ones.
+		const bool isScanningAllNodes = mDirtyNodeIndices.size() * 8u > mNodes.size();
+		if (isScanningAllNodes)
+		{
+			mDirtyNodeIndices.clear();
+			for (uint32_t nodeIndex = static_cast<uint32_t>(mNodes.size()); nodeIndex > 0u; --nodeIndex)
+			{
+				if (mIsNodeDirty[nodeIndex - 1u] != 0u)
+				{
+					mDirtyNodeIndices.push_back(nodeIndex - 1u);
+				}
+			}
+		}
+		else
+		{
+			std::sort(mDirtyNodeIndices.begin(), mDirtyNodeIndices.end(), std::greater<uint32_t>());
+		}
+
+		for (const uint32_t nodeIndex : mDirtyNodeIndices)
+		{
+			Node& node = mNodes[nodeIndex];
+			node.boundingBox = EMPTY_BOUNDING_BOX;
+
+			if (node.objectCount == 0u)
+			{
+				ExpandBoundingBox(node.boundingBox, mNodes[node.firstIndex].boundingBox);
+				ExpandBoundingBox(node.boundingBox, mNodes[node.firstIndex + 1u].boundingBox);
+			}
+			else
+			{
+				for (uint32_t i = node.firstIndex; i < node.firstIndex + node.objectCount; ++i)
+				{
+					ExpandBoundingBox(node.boundingBox, mObjectBoundingBoxes[mObjectIndices[i]]);
+				}
+			}
+
+			mIsNodeDirty[nodeIndex] = 0u;
+		}
+
+		const uint32_t refitNodeCount = static_cast<uint32_t>(mDirtyNodeIndices.size());
+		mDirtyNodeIndices.clear();
+
+		return refitNodeCount;
+	}
+
+	void BoundingVolumeHierarchy::QueryConvexVolume(std::span<const Plane> planes, std::vector<uint32_t>& objectIndices) const
+	{
+		if (mNodes.empty())
+		{
+			return;
+		}
+
+		// Each node is tested only against the planes its parent straddles : once a node is inside a plane, so are all objects below it (and once it is
+		// inside all planes, its subtree is visited without any test).
+		const uint32_t planeCount = std::min(static_cast<uint32_t>(planes.size()), 32u);
+		const uint32_t allPlanesMask = planeCount == 32u ? ~0u : (1u << planeCount) - 1u;
+
+		std::vector<std::pair<uint32_t, uint32_t>> nodeStack{ { 0u, allPlanesMask } };
+
+		while (!nodeStack.empty())
+		{
+			const auto [nodeIndex, parentPlanesMask] = nodeStack.back();
+			nodeStack.pop_back();
+
+			const Node& node = mNodes[nodeIndex];
+
+			bool isOutside = false;
+			uint32_t planesMask = parentPlanesMask;
+			for (uint32_t remainingPlanesMask = parentPlanesMask; remainingPlanesMask != 0u && !isOutside; remainingPlanesMask &= remainingPlanesMask - 1u)
+			{
+				const uint32_t planeIndex = static_cast<uint32_t>(std::countr_zero(remainingPlanesMask));
+
+				bool isInsidePlane{};
+				isOutside = IsBoundingBoxOutsidePlane(planes[planeIndex], node.boundingBox, isInsidePlane);
+				if (isInsidePlane)
+				{
+					planesMask &= ~(1u << planeIndex);
+				}
+			}
+
+			if (isOutside)
+			{
+				continue;
+			}
+
+			if (node.objectCount == 0u)
+			{
+				nodeStack.emplace_back(node.firstIndex, planesMask);
+				nodeStack.emplace_back(node.firstIndex + 1u, planesMask);
+				continue;
+			}
+
+			for (uint32_t i = node.firstIndex; i < node.firstIndex + node.objectCount; ++i)
+			{
+				bool isObjectOutside = false;
+				for (uint32_t remainingPlanesMask = planesMask; remainingPlanesMask != 0u && !isObjectOutside; remainingPlanesMask &= remainingPlanesMask - 1u)
+				{
+					bool isInsidePlane{};
+					isObjectOutside = IsBoundingBoxOutsidePlane(planes[std::countr_zero(remainingPlanesMask)], mObjectBoundingBoxes[mObjectIndices[i]], isInsidePlane);
+				}
+
+				if (!isObjectOutside)
+				{
+					objectIndices.push_back(mObjectIndices[i]);
+				}
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& objectIndices) const
+	{
+		QueryConvexVolume(frustum.planes, objectIndices);
+	}
+
+	void BoundingVolumeHierarchy::QuerySphere(const BoundingSphere& boundingSphere, std::vector<uint32_t>& objectIndices) const
+	{
+		if (mNodes.empty())
+		{
+			return;
+		}
+
+		std::vector<uint32_t> nodeStack{ 0u };
+
+		while (!nodeStack.empty())
+		{
+			const Node& node = mNodes[nodeStack.back()];
+			nodeStack.pop_back();
+
+			if (!IntersectSphereBoundingBox(boundingSphere, node.boundingBox))
+			{
+				continue;
+			}
+
+			if (node.objectCount == 0u)
+			{
+				nodeStack.push_back(node.firstIndex);
+				nodeStack.push_back(node.firstIndex + 1u);
+				continue;
+			}
+
+			for (uint32_t i = node.firstIndex; i < node.firstIndex + node.objectCount; ++i)
+			{
+				if (IntersectSphereBoundingBox(boundingSphere, mObjectBoundingBoxes[mObjectIndices[i]]))
+				{
+					objectIndices.push_back(mObjectIndices[i]);
+				}
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::QueryRay(const Ray& ray, std::vector<RayHit>& rayHits) const
+	{
+		if (mNodes.empty())
+		{
+			return;
+		}
+
+		const RayTraversal rayTraversal(ray);
+		const size_t firstRayHitIndex = rayHits.size();
+
+		std::vector<uint32_t> nodeStack{ 0u };
+
+		while (!nodeStack.empty())
+		{
+			const Node& node = mNodes[nodeStack.back()];
+			nodeStack.pop_back();
+
+			if (!rayTraversal.Intersect(node.boundingBox, ray.maxDistance).has_value())
+			{
+				continue;
+			}
+
+			if (node.objectCount == 0u)
+			{
+				nodeStack.push_back(node.firstIndex);
+				nodeStack.push_back(node.firstIndex + 1u);
+				continue;
+			}
+
+			for (uint32_t i = node.firstIndex; i < node.firstIndex + node.objectCount; ++i)
+			{
+				if (const std::optional<float> distance = rayTraversal.Intersect(mObjectBoundingBoxes[mObjectIndices[i]], ray.maxDistance); distance.has_value())
+				{
+					rayHits.push_back(RayHit{ .objectIndex = mObjectIndices[i], .distance = *distance });
+				}
+			}
+		}
+
+		std::sort(rayHits.begin() + firstRayHitIndex, rayHits.end(), [](const RayHit& a, const RayHit& b)
+		{
+			return a.distance < b.distance || (a.distance == b.distance && a.objectIndex < b.objectIndex);
+		});
+	}
+
+	std::optional<RayHit> BoundingVolumeHierarchy::QueryClosestRayHit(const Ray& ray) const
+	{
+		if (mNodes.empty())
+		{
+			return std::nullopt;
+		}
+
+		const RayTraversal rayTraversal(ray);
+
+		std::optional<RayHit> closestRayHit{};
+		float closestDistance = ray.maxDistance;
+
+		// Nodes are pushed with their entry distance, and skipped if a closer hit was found meanwhile. Ties are resolved towards the smallest object index,
+		// so nodes as far as the closest hit are still visited.
+		std::vector<std::pair<uint32_t, float>> nodeStack{};
+		if (const std::optional<float> rootDistance = rayTraversal.Intersect(mNodes.front().boundingBox, closestDistance); rootDistance.has_value())
+		{
+			nodeStack.emplace_back(0u, *rootDistance);
+		}
+
+		while (!nodeStack.empty())
+		{
+			const auto [nodeIndex, nodeDistance] = nodeStack.back();
+			nodeStack.pop_back();
+
+			if (nodeDistance > closestDistance)
+			{
+				continue;
+			}
+
+			const Node& node = mNodes[nodeIndex];
+
+			if (node.objectCount == 0u)
+			{
+				const std::optional<float> firstChildDistance = rayTraversal.Intersect(mNodes[node.firstIndex].boundingBox, closestDistance);
+				const std::optional<float> secondChildDistance = rayTraversal.Intersect(mNodes[node.firstIndex + 1u].boundingBox, closestDistance);
+
+				const auto PushChild = [&](uint32_t childIndex, const std::optional<float>& childDistance)
+				{
+					if (childDistance.has_value())
+					{
+						nodeStack.emplace_back(childIndex, *childDistance);
+					}
+				};
+
+				// The nearest child is pushed last, so it is visited first.
+				if (secondChildDistance.has_value() && (!firstChildDistance.has_value() || *secondChildDistance < *firstChildDistance))
+				{
+					PushChild(node.firstIndex, firstChildDistance);
+					PushChild(node.firstIndex + 1u, secondChildDistance);
+				}
+				else
+				{
+					PushChild(node.firstIndex + 1u, secondChildDistance);
+					PushChild(node.firstIndex, firstChildDistance);
+				}
+
+				continue;
+			}
+
+			for (uint32_t i = node.firstIndex; i < node.firstIndex + node.objectCount; ++i)
+			{
+				const uint32_t objectIndex = mObjectIndices[i];
+				const std::optional<float> distance = rayTraversal.Intersect(mObjectBoundingBoxes[objectIndex], closestDistance);
+
+				if (distance.has_value() && (!closestRayHit.has_value() || *distance < closestDistance || (*distance == closestDistance && objectIndex < closestRayHit->objectIndex)))
+				{
+					closestRayHit = RayHit{ .objectIndex = objectIndex, .distance = *distance };
+					closestDistance = *distance;
+				}
+			}
+		}
+
+		return closestRayHit;
+	}
+
+	float BoundingVolumeHierarchy::GetSahCost() const
+	{
+		if (mNodes.empty())
+		{
+			return 0.0f;
+		}
+
+		const float rootArea = ComputeSurfaceArea(mNodes.front().boundingBox);
+		if (rootArea <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		double sahCost{};
+		for (const Node& node : mNodes)
+		{
+			const float nodeArea = ComputeSurfaceArea(node.boundingBox);
+			sahCost += node.objectCount == 0u ? nodeArea * SAH_TRAVERSAL_COST : nodeArea * static_cast<float>(node.objectCount);
+		}
+
+		return static_cast<float>(sahCost / rootArea);
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "FrustumCulling.hpp"
+
+#include <limits>
+#include <optional>
+
+namespace helios::scene
+{
+	struct Ray
+	{
+		Float3 origin{};
+
+		// Does not have to be normalized : the hit distances are then in units of the direction's length.
+		Float3 direction{};
+
+		float maxDistance{ std::numeric_limits<float>::infinity() };
+	};
+
+	struct RayHit
+	{
+		uint32_t objectIndex{};
+
+		// Distance at which the ray enters the box (0 if the origin is inside of it).
+		float distance{};
+	};
+
+	// Slab test. Returns the distance at which the ray enters the box, if it does so before ray.maxDistance.
+	std::optional<float> IntersectRayBoundingBox(const Ray& ray, const BoundingBox& boundingBox);
+
+	// Returns true if the sphere intersects or contains the box (Arvo's closest point test).
+	bool IntersectSphereBoundingBox(const BoundingSphere& boundingSphere, const BoundingBox& boundingBox);
+
+	struct BoundingVolumeHierarchyBuildDesc
+	{
+		// Nodes with at most this many objects become leaves if splitting them does not lower the SAH cost. Larger nodes are always split.
+		uint32_t maxLeafObjectCount{ 4u };
+
+		// The split is chosen among binCount - 1 planes per axis, evenly spaced across the bounds of the object centers.
+		uint32_t binCount{ 16u };
+
+		// Nodes with more objects than this are split in parallel (with the engine job system), and their objects are binned in parallel.
+		// Set to 0 to build serially.
+		uint32_t parallelObjectCount{ 4096u };
+	};
+
+	// Binary tree of axis aligned boxes over a set of objects (i.e the world bounds of the meshes of a scene), so spatial queries visit O(log n) nodes rather
+	// than every object. The tree is built top down with the binned surface area heuristic (SAH), and objects can be moved afterwards by refitting the
+	// bounds of the nodes above them, which keeps the topology (so the quality degrades as objects move : rebuild once GetSahCost() grows too much relative
+	// to GetBuildSahCost()).
+	// Not thread safe : queries may run concurrently with each other, but not with Build / UpdateObject / Refit.
+	class BoundingVolumeHierarchy
+	{
+	public:
+		// Object i has the bounds boundingBoxes[i]. Replaces the previous hierarchy.
+		void Build(std::span<const BoundingBox> boundingBoxes, const BoundingVolumeHierarchyBuildDesc& buildDesc = {});
+
+		// Sets the bounds of an object, and marks the nodes above it for the next Refit.
+		void UpdateObject(uint32_t objectIndex, const BoundingBox& boundingBox);
+
+		// Recomputes the bounds of the nodes marked by UpdateObject (bottom up, so each node is recomputed once however many of its objects moved).
+		// Returns the number of recomputed nodes.
+		uint32_t Refit();
+
+		// The queries append the indices of the objects whose box passes the test to objectIndices, in no particular order.
+		// An object is kept unless its box is entirely outside one of the planes (same test as CullBoundingBoxes). At most 32 planes are supported.
+		void QueryConvexVolume(std::span<const Plane> planes, std::vector<uint32_t>& objectIndices) const;
+		void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& objectIndices) const;
+		void QuerySphere(const BoundingSphere& boundingSphere, std::vector<uint32_t>& objectIndices) const;
+
+		// Appends the boxes hit by the ray to rayHits, sorted by distance.
+		void QueryRay(const Ray& ray, std::vector<RayHit>& rayHits) const;
+
+		// The closest box hit by the ray (i.e for picking). Children are visited front to back, and nodes farther than the closest hit so far are skipped.
+		std::optional<RayHit> QueryClosestRayHit(const Ray& ray) const;
+
+		// Expected cost of a query, relative to testing the root : the sum of the areas of the internal nodes, and of the leaves weighted by their object
+		// count, divided by the area of the root.
+		float GetSahCost() const;
+		float GetBuildSahCost() const { return mBuildSahCost; }
+
+		uint32_t GetObjectCount() const { return static_cast<uint32_t>(mObjectBoundingBoxes.size()); }
+		uint32_t GetNodeCount() const { return static_cast<uint32_t>(mNodes.size()); }
+		const BoundingBox& GetObjectBoundingBox(uint32_t objectIndex) const { return mObjectBoundingBoxes[objectIndex]; }
+
+	private:
+		// Internal nodes have objectCount == 0, and their children are at firstIndex and firstIndex + 1. Leaves reference the objects
+		// mObjectIndices[firstIndex, firstIndex + objectCount).
+		struct Node
+		{
+			BoundingBox boundingBox{};
+			uint32_t firstIndex{};
+			uint32_t objectCount{};
+		};
+
+		struct BuildState;
+		struct BuildRange;
+		void BuildNode(BuildState& buildState, uint32_t nodeIndex, const BuildRange& buildRange, uint32_t parentIndex);
+
+	private:
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		// Note : A node is always allocated before its children, so children have larger indices than their parent (which Refit relies on).
+		std::vector<Node> mNodes{};
+		std::vector<uint32_t> mParentIndices{};
+
+		std::vector<uint32_t> mObjectIndices{};
+		std::vector<BoundingBox> mObjectBoundingBoxes{};
+		std::vector<uint32_t> mObjectLeafIndices{};
+
+		// Nodes marked by UpdateObject. A node is marked at most once, and all its ancestors are then marked too.
+		std::vector<uint32_t> mDirtyNodeIndices{};
+		std::vector<uint8_t> mIsNodeDirty{};
+
+		float mBuildSahCost{};
+	};
+}
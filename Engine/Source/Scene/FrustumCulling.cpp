@@ -0,0 +1,654 @@
+#include "FrustumCulling.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define HELIOS_CULLING_X64
+#include <immintrin.h>
+
+// MSVC allows AVX intrinsics in any function, while GCC / Clang require the function to be compiled for AVX (without enabling it for the whole file, which
+// would make the other functions unusable on CPUs without AVX).
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define HELIOS_TARGET_AVX
+#else
+#define HELIOS_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace helios::scene
+{
+	static uint32_t GetPaddedCount(uint32_t count)
+	{
+		return (count + MAX_CULLING_BATCH_SIZE - 1u) / MAX_CULLING_BATCH_SIZE * MAX_CULLING_BATCH_SIZE;
+	}
+
+	// Writes the visibility of the (at most batchSize) elements of the batch starting at index from a mask with one bit per element, and returns the number of
+	// visible elements. The padding past count is ignored.
+	static uint32_t WriteBatchVisibility(uint32_t visibleMask, uint32_t index, uint32_t batchSize, uint32_t count, std::span<uint8_t> visibility)
+	{
+		const uint32_t elementCount = std::min(batchSize, count - index);
+		visibleMask &= (1u << elementCount) - 1u;
+
+		for (uint32_t i = 0u; i < elementCount; ++i)
+		{
+			visibility[index + i] = static_cast<uint8_t>((visibleMask >> i) & 1u);
+		}
+
+		return static_cast<uint32_t>(std::popcount(visibleMask));
+	}
+
+	Matrix4x4 MultiplyMatrices(const Matrix4x4& a, const Matrix4x4& b)
+	{
+		Matrix4x4 result{};
+		for (size_t row = 0u; row < 4u; ++row)
+		{
+			for (size_t column = 0u; column < 4u; ++column)
+			{
+				for (size_t i = 0u; i < 4u; ++i)
+				{
+					result[row * 4u + column] += a[row * 4u + i] * b[i * 4u + column];
+				}
+			}
+		}
+
+		return result;
+	}
+
+	Matrix4x4 CreateLookToMatrix(const Float3& position, const Float3& direction)
+	{
+		const auto Normalize = [](const Float3& vector)
+		{
+			const float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+			return Float3{ vector[0] / length, vector[1] / length, vector[2] / length };
+		};
+
+		const auto Cross = [](const Float3& a, const Float3& b)
+		{
+			return Float3{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+		};
+
+		const auto Dot = [](const Float3& a, const Float3& b)
+		{
+			return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+		};
+
+		const Float3 forward = Normalize(direction);
+		const Float3 right = Normalize(Cross({ 0.0f, 1.0f, 0.0f }, forward));
+		const Float3 up = Cross(forward, right);
+
+		return Matrix4x4
+		{
+			right[0], up[0], forward[0], 0.0f,
+			right[1], up[1], forward[1], 0.0f,
+			right[2], up[2], forward[2], 0.0f,
+			-Dot(right, position), -Dot(up, position), -Dot(forward, position), 1.0f,
+		};
+	}
+
+	Matrix4x4 CreatePerspectiveMatrix(float verticalFov, float aspectRatio, float nearPlane, float farPlane)
+	{
+		const float yScale = 1.0f / std::tan(verticalFov * 0.5f);
+		const float depthScale = farPlane / (farPlane - nearPlane);
+
+		return Matrix4x4
+		{
+			yScale / aspectRatio, 0.0f, 0.0f, 0.0f,
+			0.0f, yScale, 0.0f, 0.0f,
+			0.0f, 0.0f, depthScale, 1.0f,
+			0.0f, 0.0f, -nearPlane * depthScale, 0.0f,
+		};
+	}
+
+	Matrix4x4 CreateOrthographicMatrix(float extents, float nearPlane, float farPlane)
+	{
+		const float depthScale = 1.0f / (farPlane - nearPlane);
+
+		return Matrix4x4
+		{
+			1.0f / extents, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f / extents, 0.0f, 0.0f,
+			0.0f, 0.0f, depthScale, 0.0f,
+			0.0f, 0.0f, -nearPlane * depthScale, 1.0f,
+		};
+	}
+
+	Frustum ExtractFrustum(const Matrix4x4& viewProjectionMatrix)
+	{
+		// With row vectors, the clip space coordinate i is the dot product of the position with the column i of the matrix.
+		const auto GetColumn = [&](uint32_t column)
+		{
+			return Plane
+			{
+				viewProjectionMatrix[column], viewProjectionMatrix[4u + column], viewProjectionMatrix[8u + column], viewProjectionMatrix[12u + column],
+			};
+		};
+
+		const auto Combine = [](const Plane& a, const Plane& b, float sign)
+		{
+			return Plane{ a[0] + sign * b[0], a[1] + sign * b[1], a[2] + sign * b[2], a[3] + sign * b[3] };
+		};
+
+		const Plane x = GetColumn(0u);
+		const Plane y = GetColumn(1u);
+		const Plane z = GetColumn(2u);
+		const Plane w = GetColumn(3u);
+
+		// -w <= x <= w, -w <= y <= w, 0 <= z <= w.
+		Frustum frustum
+		{
+			.planes =
+			{
+				Combine(w, x, 1.0f),
+				Combine(w, x, -1.0f),
+				Combine(w, y, 1.0f),
+				Combine(w, y, -1.0f),
+				z,
+				Combine(w, z, -1.0f),
+			},
+		};
+
+		for (Plane& plane : frustum.planes)
+		{
+			const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			if (length > 0.0f)
+			{
+				for (float& value : plane)
+				{
+					value /= length;
+				}
+			}
+		}
+
+		return frustum;
+	}
+
+	BoundingBox ComputeBoundingBox(std::span<const Float3> positions)
+	{
+		if (positions.empty())
+		{
+			return BoundingBox{};
+		}
+
+		BoundingBox boundingBox
+		{
+			.minimum = positions.front(),
+			.maximum = positions.front(),
+		};
+
+		for (const Float3& position : positions)
+		{
+			for (size_t axis = 0u; axis < 3u; ++axis)
+			{
+				boundingBox.minimum[axis] = std::min(boundingBox.minimum[axis], position[axis]);
+				boundingBox.maximum[axis] = std::max(boundingBox.maximum[axis], position[axis]);
+			}
+		}
+
+		return boundingBox;
+	}
+
+	BoundingSphere ComputeBoundingSphere(std::span<const Float3> positions, const BoundingBox& boundingBox)
+	{
+		BoundingSphere boundingSphere{};
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			boundingSphere.center[axis] = (boundingBox.minimum[axis] + boundingBox.maximum[axis]) * 0.5f;
+		}
+
+		float squaredRadius{};
+		for (const Float3& position : positions)
+		{
+			const float x = position[0] - boundingSphere.center[0];
+			const float y = position[1] - boundingSphere.center[1];
+			const float z = position[2] - boundingSphere.center[2];
+
+			squaredRadius = std::max(squaredRadius, x * x + y * y + z * z);
+		}
+
+		boundingSphere.radius = std::sqrt(squaredRadius);
+
+		return boundingSphere;
+	}
+
+	BoundingBox TransformBoundingBox(const BoundingBox& boundingBox, const Matrix4x4& matrix)
+	{
+		Float3 center{};
+		Float3 extent{};
+		for (size_t axis = 0u; axis < 3u; ++axis)
+		{
+			center[axis] = (boundingBox.minimum[axis] + boundingBox.maximum[axis]) * 0.5f;
+			extent[axis] = (boundingBox.maximum[axis] - boundingBox.minimum[axis]) * 0.5f;
+		}
+
+		BoundingBox transformedBoundingBox{};
+		for (size_t column = 0u; column < 3u; ++column)
+		{
+			float transformedCenter = matrix[12u + column];
+			float transformedExtent{};
+
+			for (size_t row = 0u; row < 3u; ++row)
+			{
+				transformedCenter += center[row] * matrix[row * 4u + column];
+				transformedExtent += extent[row] * std::abs(matrix[row * 4u + column]);
+			}
+
+			transformedBoundingBox.minimum[column] = transformedCenter - transformedExtent;
+			transformedBoundingBox.maximum[column] = transformedCenter + transformedExtent;
+		}
+
+		return transformedBoundingBox;
+	}
+
+	BoundingSphere TransformBoundingSphere(const BoundingSphere& boundingSphere, const Matrix4x4& matrix)
+	{
+		BoundingSphere transformedBoundingSphere{};
+		for (size_t column = 0u; column < 3u; ++column)
+		{
+			float transformedCenter = matrix[12u + column];
+			for (size_t row = 0u; row < 3u; ++row)
+			{
+				transformedCenter += boundingSphere.center[row] * matrix[row * 4u + column];
+			}
+
+			transformedBoundingSphere.center[column] = transformedCenter;
+		}
+
+		// With row vectors, the row i of the matrix is the transformed basis vector i.
+		float maxSquaredScale{};
+		for (size_t row = 0u; row < 3u; ++row)
+		{
+			const float* basis = &matrix[row * 4u];
+			maxSquaredScale = std::max(maxSquaredScale, basis[0] * basis[0] + basis[1] * basis[1] + basis[2] * basis[2]);
+		}
+
+		transformedBoundingSphere.radius = boundingSphere.radius * std::sqrt(maxSquaredScale);
+
+		return transformedBoundingSphere;
+	}
+
+	float ComputeBoundingBoxDepth(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix)
+	{
+		float clipZ = viewProjectionMatrix[14u];
+		float clipW = viewProjectionMatrix[15u];
+		for (size_t row = 0u; row < 3u; ++row)
+		{
+			const float center = (boundingBox.minimum[row] + boundingBox.maximum[row]) * 0.5f;
+			clipZ += center * viewProjectionMatrix[row * 4u + 2u];
+			clipW += center * viewProjectionMatrix[row * 4u + 3u];
+		}
+
+		return clipW > 0.0f ? clipZ / clipW : 0.0f;
+	}
+
+	void BoundingBoxSoA::Resize(uint32_t count)
+	{
+		mCount = count;
+
+		const uint32_t paddedCount = GetPaddedCount(count);
+		for (std::vector<float>* values : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ })
+		{
+			values->resize(paddedCount);
+		}
+	}
+
+	void BoundingBoxSoA::Set(uint32_t index, const BoundingBox& boundingBox)
+	{
+		centerX[index] = (boundingBox.minimum[0] + boundingBox.maximum[0]) * 0.5f;
+		centerY[index] = (boundingBox.minimum[1] + boundingBox.maximum[1]) * 0.5f;
+		centerZ[index] = (boundingBox.minimum[2] + boundingBox.maximum[2]) * 0.5f;
+		extentX[index] = (boundingBox.maximum[0] - boundingBox.minimum[0]) * 0.5f;
+		extentY[index] = (boundingBox.maximum[1] - boundingBox.minimum[1]) * 0.5f;
+		extentZ[index] = (boundingBox.maximum[2] - boundingBox.minimum[2]) * 0.5f;
+	}
+
+	BoundingBox BoundingBoxSoA::Get(uint32_t index) const
+	{
+		return BoundingBox
+		{
+			.minimum = { centerX[index] - extentX[index], centerY[index] - extentY[index], centerZ[index] - extentZ[index] },
+			.maximum = { centerX[index] + extentX[index], centerY[index] + extentY[index], centerZ[index] + extentZ[index] },
+		};
+	}
+
+	void BoundingSphereSoA::Resize(uint32_t count)
+	{
+		mCount = count;
+
+		const uint32_t paddedCount = GetPaddedCount(count);
+		for (std::vector<float>* values : { &centerX, &centerY, &centerZ, &radius })
+		{
+			values->resize(paddedCount);
+		}
+	}
+
+	void BoundingSphereSoA::Set(uint32_t index, const BoundingSphere& boundingSphere)
+	{
+		centerX[index] = boundingSphere.center[0];
+		centerY[index] = boundingSphere.center[1];
+		centerZ[index] = boundingSphere.center[2];
+		radius[index] = boundingSphere.radius;
+	}
+
+	const char* CullingImplementationToString(CullingImplementation cullingImplementation)
+	{
+		switch (cullingImplementation)
+		{
+			case CullingImplementation::Scalar:
+			{
+				return "Scalar";
+			}break;
+
+			case CullingImplementation::Sse:
+			{
+				return "SSE";
+			}break;
+
+			case CullingImplementation::Avx:
+			{
+				return "AVX";
+			}break;
+
+			case CullingImplementation::Best:
+			{
+				return "Best";
+			}break;
+		}
+
+		return "Unknown";
+	}
+
+	bool IsCullingImplementationSupported(CullingImplementation cullingImplementation)
+	{
+		switch (cullingImplementation)
+		{
+			case CullingImplementation::Scalar:
+			case CullingImplementation::Best:
+			{
+				return true;
+			}break;
+
+			// SSE2 is part of x64.
+			case CullingImplementation::Sse:
+			{
+#if defined(HELIOS_CULLING_X64)
+				return true;
+#else
+				return false;
+#endif
+			}break;
+
+			// The OS must also save the AVX registers on context switches (OSXSAVE and XCR0), which __builtin_cpu_supports checks as well.
+			case CullingImplementation::Avx:
+			{
+#if defined(HELIOS_CULLING_X64) && defined(_MSC_VER) && !defined(__clang__)
+				std::array<int, 4> cpuInfo{};
+				__cpuid(cpuInfo.data(), 1);
+
+				const bool isAvxSupported = (cpuInfo[2] & (1 << 28)) != 0;
+				const bool isXSaveEnabled = (cpuInfo[2] & (1 << 27)) != 0;
+
+				return isAvxSupported && isXSaveEnabled && (_xgetbv(0u) & 0x6u) == 0x6u;
+#elif defined(HELIOS_CULLING_X64)
+				return __builtin_cpu_supports("avx");
+#else
+				return false;
+#endif
+			}break;
+		}
+
+		return false;
+	}
+
+	CullingImplementation ResolveCullingImplementation(CullingImplementation cullingImplementation)
+	{
+		if (cullingImplementation != CullingImplementation::Best)
+		{
+			return IsCullingImplementationSupported(cullingImplementation) ? cullingImplementation : CullingImplementation::Scalar;
+		}
+
+		// Checking the CPU is not free, and its features do not change while running.
+		static const CullingImplementation bestCullingImplementation = IsCullingImplementationSupported(CullingImplementation::Avx) ? CullingImplementation::Avx :
+			IsCullingImplementationSupported(CullingImplementation::Sse) ? CullingImplementation::Sse : CullingImplementation::Scalar;
+
+		return bestCullingImplementation;
+	}
+
+	// Note : All implementations compute ((a * x + b * y) + c * z) + d, then add the (projected) radius, and cull if the sum is negative, so they produce
+	// the exact same results (no FMA is used, as the scalar code would round differently).
+	static uint32_t CullBoundingBoxesScalar(std::span<const Plane> planes, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility)
+	{
+		uint32_t visibleCount{};
+
+		for (uint32_t i = 0u; i < boundingBoxes.GetCount(); ++i)
+		{
+			bool isVisible = true;
+			for (const Plane& plane : planes)
+			{
+				const float distance = plane[0] * boundingBoxes.centerX[i] + plane[1] * boundingBoxes.centerY[i] + plane[2] * boundingBoxes.centerZ[i] + plane[3];
+				const float radius = std::abs(plane[0]) * boundingBoxes.extentX[i] + std::abs(plane[1]) * boundingBoxes.extentY[i] + std::abs(plane[2]) * boundingBoxes.extentZ[i];
+
+				isVisible = isVisible && !(distance + radius < 0.0f);
+			}
+
+			visibility[i] = isVisible ? 1u : 0u;
+			visibleCount += isVisible ? 1u : 0u;
+		}
+
+		return visibleCount;
+	}
+
+	static uint32_t CullBoundingSpheresScalar(std::span<const Plane> planes, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility)
+	{
+		uint32_t visibleCount{};
+
+		for (uint32_t i = 0u; i < boundingSpheres.GetCount(); ++i)
+		{
+			bool isVisible = true;
+			for (const Plane& plane : planes)
+			{
+				const float distance = plane[0] * boundingSpheres.centerX[i] + plane[1] * boundingSpheres.centerY[i] + plane[2] * boundingSpheres.centerZ[i] + plane[3];
+
+				isVisible = isVisible && !(distance + boundingSpheres.radius[i] < 0.0f);
+			}
+
+			visibility[i] = isVisible ? 1u : 0u;
+			visibleCount += isVisible ? 1u : 0u;
+		}
+
+		return visibleCount;
+	}
+
+#if defined(HELIOS_CULLING_X64)
+	static uint32_t CullBoundingBoxesSse(std::span<const Plane> planes, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility)
+	{
+		// Clears the sign bit.
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 zero = _mm_setzero_ps();
+
+		uint32_t visibleCount{};
+
+		for (uint32_t i = 0u; i < boundingBoxes.GetCount(); i += 4u)
+		{
+			const __m128 centerX = _mm_loadu_ps(&boundingBoxes.centerX[i]);
+			const __m128 centerY = _mm_loadu_ps(&boundingBoxes.centerY[i]);
+			const __m128 centerZ = _mm_loadu_ps(&boundingBoxes.centerZ[i]);
+			const __m128 extentX = _mm_loadu_ps(&boundingBoxes.extentX[i]);
+			const __m128 extentY = _mm_loadu_ps(&boundingBoxes.extentY[i]);
+			const __m128 extentZ = _mm_loadu_ps(&boundingBoxes.extentZ[i]);
+
+			__m128 outsideMask = _mm_setzero_ps();
+			for (const Plane& plane : planes)
+			{
+				const __m128 a = _mm_set1_ps(plane[0]);
+				const __m128 b = _mm_set1_ps(plane[1]);
+				const __m128 c = _mm_set1_ps(plane[2]);
+
+				__m128 distance = _mm_add_ps(_mm_mul_ps(a, centerX), _mm_mul_ps(b, centerY));
+				distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(c, centerZ)), _mm_set1_ps(plane[3]));
+
+				__m128 radius = _mm_add_ps(_mm_mul_ps(_mm_and_ps(a, absMask), extentX), _mm_mul_ps(_mm_and_ps(b, absMask), extentY));
+				radius = _mm_add_ps(radius, _mm_mul_ps(_mm_and_ps(c, absMask), extentZ));
+
+				outsideMask = _mm_or_ps(outsideMask, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			visibleCount += WriteBatchVisibility(~static_cast<uint32_t>(_mm_movemask_ps(outsideMask)), i, 4u, boundingBoxes.GetCount(), visibility);
+		}
+
+		return visibleCount;
+	}
+
+	static uint32_t CullBoundingSpheresSse(std::span<const Plane> planes, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility)
+	{
+		const __m128 zero = _mm_setzero_ps();
+
+		uint32_t visibleCount{};
+
+		for (uint32_t i = 0u; i < boundingSpheres.GetCount(); i += 4u)
+		{
+			const __m128 centerX = _mm_loadu_ps(&boundingSpheres.centerX[i]);
+			const __m128 centerY = _mm_loadu_ps(&boundingSpheres.centerY[i]);
+			const __m128 centerZ = _mm_loadu_ps(&boundingSpheres.centerZ[i]);
+			const __m128 radius = _mm_loadu_ps(&boundingSpheres.radius[i]);
+
+			__m128 outsideMask = _mm_setzero_ps();
+			for (const Plane& plane : planes)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), centerX), _mm_mul_ps(_mm_set1_ps(plane[1]), centerY));
+				distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane[2]), centerZ)), _mm_set1_ps(plane[3]));
+
+				outsideMask = _mm_or_ps(outsideMask, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			visibleCount += WriteBatchVisibility(~static_cast<uint32_t>(_mm_movemask_ps(outsideMask)), i, 4u, boundingSpheres.GetCount(), visibility);
+		}
+
+		return visibleCount;
+	}
+
+	HELIOS_TARGET_AVX static uint32_t CullBoundingBoxesAvx(std::span<const Plane> planes, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility)
+	{
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		const __m256 zero = _mm256_setzero_ps();
+
+		uint32_t visibleCount{};
+
+		for (uint32_t i = 0u; i < boundingBoxes.GetCount(); i += 8u)
+		{
+			const __m256 centerX = _mm256_loadu_ps(&boundingBoxes.centerX[i]);
+			const __m256 centerY = _mm256_loadu_ps(&boundingBoxes.centerY[i]);
+			const __m256 centerZ = _mm256_loadu_ps(&boundingBoxes.centerZ[i]);
+			const __m256 extentX = _mm256_loadu_ps(&boundingBoxes.extentX[i]);
+			const __m256 extentY = _mm256_loadu_ps(&boundingBoxes.extentY[i]);
+			const __m256 extentZ = _mm256_loadu_ps(&boundingBoxes.extentZ[i]);
+
+			__m256 outsideMask = _mm256_setzero_ps();
+			for (const Plane& plane : planes)
+			{
+				const __m256 a = _mm256_set1_ps(plane[0]);
+				const __m256 b = _mm256_set1_ps(plane[1]);
+				const __m256 c = _mm256_set1_ps(plane[2]);
+
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(a, centerX), _mm256_mul_ps(b, centerY));
+				distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(c, centerZ)), _mm256_set1_ps(plane[3]));
+
+				__m256 radius = _mm256_add_ps(_mm256_mul_ps(_mm256_and_ps(a, absMask), extentX), _mm256_mul_ps(_mm256_and_ps(b, absMask), extentY));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_and_ps(c, absMask), extentZ));
+
+				outsideMask = _mm256_or_ps(outsideMask, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+			}
+
+			visibleCount += WriteBatchVisibility(~static_cast<uint32_t>(_mm256_movemask_ps(outsideMask)), i, 8u, boundingBoxes.GetCount(), visibility);
+		}
+
+		return visibleCount;
+	}
+
+	HELIOS_TARGET_AVX static uint32_t CullBoundingSpheresAvx(std::span<const Plane> planes, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+
+		uint32_t visibleCount{};
+
+		for (uint32_t i = 0u; i < boundingSpheres.GetCount(); i += 8u)
+		{
+			const __m256 centerX = _mm256_loadu_ps(&boundingSpheres.centerX[i]);
+			const __m256 centerY = _mm256_loadu_ps(&boundingSpheres.centerY[i]);
+			const __m256 centerZ = _mm256_loadu_ps(&boundingSpheres.centerZ[i]);
+			const __m256 radius = _mm256_loadu_ps(&boundingSpheres.radius[i]);
+
+			__m256 outsideMask = _mm256_setzero_ps();
+			for (const Plane& plane : planes)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[0]), centerX), _mm256_mul_ps(_mm256_set1_ps(plane[1]), centerY));
+				distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane[2]), centerZ)), _mm256_set1_ps(plane[3]));
+
+				outsideMask = _mm256_or_ps(outsideMask, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_LT_OQ));
+			}
+
+			visibleCount += WriteBatchVisibility(~static_cast<uint32_t>(_mm256_movemask_ps(outsideMask)), i, 8u, boundingSpheres.GetCount(), visibility);
+		}
+
+		return visibleCount;
+	}
+#endif
+
+	uint32_t CullBoundingBoxes(const Frustum& frustum, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility, CullingImplementation cullingImplementation)
+	{
+		return CullBoundingBoxes(frustum.planes, boundingBoxes, visibility, cullingImplementation);
+	}
+
+	uint32_t CullBoundingBoxes(std::span<const Plane> planes, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility, CullingImplementation cullingImplementation)
+	{
+		switch (ResolveCullingImplementation(cullingImplementation))
+		{
+#if defined(HELIOS_CULLING_X64)
+			case CullingImplementation::Sse:
+			{
+				return CullBoundingBoxesSse(planes, boundingBoxes, visibility);
+			}break;
+
+			case CullingImplementation::Avx:
+			{
+				return CullBoundingBoxesAvx(planes, boundingBoxes, visibility);
+			}break;
+#endif
+
+			default:
+			{
+				return CullBoundingBoxesScalar(planes, boundingBoxes, visibility);
+			}break;
+		}
+	}
+
+	uint32_t CullBoundingSpheres(const Frustum& frustum, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility, CullingImplementation cullingImplementation)
+	{
+		return CullBoundingSpheres(frustum.planes, boundingSpheres, visibility, cullingImplementation);
+	}
+
+	uint32_t CullBoundingSpheres(std::span<const Plane> planes, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility, CullingImplementation cullingImplementation)
+	{
+		switch (ResolveCullingImplementation(cullingImplementation))
+		{
+#if defined(HELIOS_CULLING_X64)
+			case CullingImplementation::Sse:
+			{
+				return CullBoundingSpheresSse(planes, boundingSpheres, visibility);
+			}break;
+
+			case CullingImplementation::Avx:
+			{
+				return CullBoundingSpheresAvx(planes, boundingSpheres, visibility);
+			}break;
+#endif
+
+			default:
+			{
+				return CullBoundingSpheresScalar(planes, boundingSpheres, visibility);
+			}break;
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace helios::scene
+{
+	// Row major, and used with row vectors (p' = p * M), as DirectXMath and the shaders (see BindlessRS.hlsli).
+	using Matrix4x4 = std::array<float, 16>;
+	using Float3 = std::array<float, 3>;
+
+	struct BoundingBox
+	{
+		Float3 minimum{};
+		Float3 maximum{};
+	};
+
+	struct BoundingSphere
+	{
+		Float3 center{};
+		float radius{};
+	};
+
+	// (a, b, c, d) with a normalized normal pointing inside the volume the plane bounds : a point p is inside the plane if dot(p, n) + d >= 0.
+	using Plane = std::array<float, 4>;
+
+	// Order : left, right, bottom, top, near, far.
+	struct Frustum
+	{
+		std::array<Plane, 6> planes{};
+	};
+
+	// a * b transforms by a, then by b (i.e a model matrix times a view projection matrix).
+	Matrix4x4 MultiplyMatrices(const Matrix4x4& a, const Matrix4x4& b);
+
+	// Same as XMMatrixLookToLH, with an up direction of +Y (so direction must not be vertical).
+	Matrix4x4 CreateLookToMatrix(const Float3& position, const Float3& direction);
+
+	// Same as XMMatrixPerspectiveFovLH.
+	Matrix4x4 CreatePerspectiveMatrix(float verticalFov, float aspectRatio, float nearPlane, float farPlane);
+
+	// Same as XMMatrixOrthographicOffCenterLH(-extents, extents, -extents, extents, nearPlane, farPlane).
+	Matrix4x4 CreateOrthographicMatrix(float extents, float nearPlane, float farPlane);
+
+	// Gribb / Hartmann plane extraction, for a D3D projection (clip space depth in [0, w]). The planes are in the space the matrix transforms from
+	// (world space for a view projection matrix).
+	Frustum ExtractFrustum(const Matrix4x4& viewProjectionMatrix);
+
+	// Bounds of a mesh in model space, computed once at import. The sphere is centered on the box, with the smallest radius enclosing all positions (which is
+	// tighter than the half diagonal of the box).
+	BoundingBox ComputeBoundingBox(std::span<const Float3> positions);
+	BoundingSphere ComputeBoundingSphere(std::span<const Float3> positions, const BoundingBox& boundingBox);
+
+	// Arvo's method : the box enclosing the transformed box (not the transformed positions, so it may be larger than the bounds of the transformed mesh).
+	BoundingBox TransformBoundingBox(const BoundingBox& boundingBox, const Matrix4x4& matrix);
+
+	// The radius is scaled by the largest scale of the matrix, so the sphere stays conservative for non uniform scales.
+	BoundingSphere TransformBoundingSphere(const BoundingSphere& boundingSphere, const Matrix4x4& matrix);
+
+	// Clip space depth (z / w) of the center of the box, used for sorting the draws front to back (see gfx::MakeDrawSortKey). 0 if the center is behind the
+	// viewer (w <= 0), as the box then intersects the near plane (or is culled).
+	float ComputeBoundingBoxDepth(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix);
+
+	// Structure of arrays layout of the bounds, so a batch of 4 (SSE) or 8 (AVX) boxes / spheres is tested against a plane with a few instructions.
+	// The arrays are padded to a multiple of MAX_CULLING_BATCH_SIZE, so the batches never have to handle a partial batch.
+	static constexpr uint32_t MAX_CULLING_BATCH_SIZE = 8u;
+
+	class BoundingBoxSoA
+	{
+	public:
+		void Resize(uint32_t count);
+		void Set(uint32_t index, const BoundingBox& boundingBox);
+		BoundingBox Get(uint32_t index) const;
+
+		uint32_t GetCount() const { return mCount; }
+
+	public:
+		std::vector<float> centerX{};
+		std::vector<float> centerY{};
+		std::vector<float> centerZ{};
+		std::vector<float> extentX{};
+		std::vector<float> extentY{};
+		std::vector<float> extentZ{};
+
+	private:
+		uint32_t mCount{};
+	};
+
+	class BoundingSphereSoA
+	{
+	public:
+		void Resize(uint32_t count);
+		void Set(uint32_t index, const BoundingSphere& boundingSphere);
+
+		uint32_t GetCount() const { return mCount; }
+
+	public:
+		std::vector<float> centerX{};
+		std::vector<float> centerY{};
+		std::vector<float> centerZ{};
+		std::vector<float> radius{};
+
+	private:
+		uint32_t mCount{};
+	};
+
+	// Instruction set used for the culling. Best is the widest one supported by the CPU (checked at runtime), and Scalar is the reference the SIMD
+	// implementations must match exactly (the operations are done in the same order).
+	enum class CullingImplementation : uint32_t
+	{
+		Scalar,
+		Sse,
+		Avx,
+		Best,
+	};
+
+	const char* CullingImplementationToString(CullingImplementation cullingImplementation);
+
+	bool IsCullingImplementationSupported(CullingImplementation cullingImplementation);
+
+	// The implementation used when culling with cullingImplementation (Best is resolved to the widest supported one, and unsupported ones to Scalar).
+	CullingImplementation ResolveCullingImplementation(CullingImplementation cullingImplementation);
+
+	// Writes 1 in visibility[i] if the i'th box / sphere intersects or is inside the frustum, else 0, and returns the number of visible boxes / spheres.
+	// visibility must hold at least GetCount() elements. A box is culled only if it is entirely outside one of the planes, so boxes near the corners of the
+	// frustum may be kept (which is conservative).
+	uint32_t CullBoundingBoxes(const Frustum& frustum, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation = CullingImplementation::Best);
+
+	uint32_t CullBoundingSpheres(const Frustum& frustum, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation = CullingImplementation::Best);
+
+	// Same as above, for any convex volume given by its planes (i.e a frustum with some of its planes removed). Everything is visible if planes is empty.
+	uint32_t CullBoundingBoxes(std::span<const Plane> planes, const BoundingBoxSoA& boundingBoxes, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation = CullingImplementation::Best);
+
+	uint32_t CullBoundingSpheres(std::span<const Plane> planes, const BoundingSphereSoA& boundingSpheres, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation = CullingImplementation::Best);
+}
@@ -0,0 +1,243 @@
+#include "HiZCulling.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace helios::scene
+{
+	static std::array<float, 4> TransformPosition(const Float3& position, const Matrix4x4& matrix)
+	{
+		std::array<float, 4> result{};
+		for (size_t column = 0u; column < 4u; ++column)
+		{
+			result[column] = ((position[0] * matrix[column] + position[1] * matrix[4u + column]) + position[2] * matrix[8u + column]) + matrix[12u + column];
+		}
+
+		return result;
+	}
+
+	std::optional<HiZScreenBounds> ProjectBoundingBoxToScreen(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix, uint32_t width, uint32_t height)
+	{
+		HiZScreenBounds screenBounds
+		{
+			.minimumX = std::numeric_limits<float>::infinity(),
+			.maximumX = -std::numeric_limits<float>::infinity(),
+			.minimumY = std::numeric_limits<float>::infinity(),
+			.maximumY = -std::numeric_limits<float>::infinity(),
+			.minimumZ = std::numeric_limits<float>::infinity(),
+		};
+
+		for (uint32_t i = 0u; i < 8u; ++i)
+		{
+			const Float3 corner
+			{
+				(i & 1u) ? boundingBox.maximum[0] : boundingBox.minimum[0],
+				(i & 2u) ? boundingBox.maximum[1] : boundingBox.minimum[1],
+				(i & 4u) ? boundingBox.maximum[2] : boundingBox.minimum[2],
+			};
+
+			const std::array<float, 4> clipPosition = TransformPosition(corner, viewProjectionMatrix);
+			if (!(clipPosition[3] > 0.0f) || clipPosition[2] < 0.0f)
+			{
+				return std::nullopt;
+			}
+
+			const float x = (clipPosition[0] / clipPosition[3] * 0.5f + 0.5f) * static_cast<float>(width);
+			const float y = (0.5f - clipPosition[1] / clipPosition[3] * 0.5f) * static_cast<float>(height);
+
+			screenBounds.minimumX = std::min(screenBounds.minimumX, x);
+			screenBounds.maximumX = std::max(screenBounds.maximumX, x);
+			screenBounds.minimumY = std::min(screenBounds.minimumY, y);
+			screenBounds.maximumY = std::max(screenBounds.maximumY, y);
+			screenBounds.minimumZ = std::min(screenBounds.minimumZ, clipPosition[2] / clipPosition[3]);
+		}
+
+		return screenBounds;
+	}
+
+	std::optional<HiZPixelRect> GetHiZPixelRect(const HiZScreenBounds& screenBounds, uint32_t width, uint32_t height)
+	{
+		const float screenWidth = static_cast<float>(width);
+		const float screenHeight = static_cast<float>(height);
+
+		if (screenBounds.maximumX <= 0.0f || screenBounds.minimumX >= screenWidth || screenBounds.maximumY <= 0.0f || screenBounds.minimumY >= screenHeight)
+		{
+			return std::nullopt;
+		}
+
+		const uint32_t columnBegin = static_cast<uint32_t>(std::max(std::floor(screenBounds.minimumX), 0.0f));
+		const uint32_t rowBegin = static_cast<uint32_t>(std::max(std::floor(screenBounds.minimumY), 0.0f));
+
+		return HiZPixelRect
+		{
+			.columnBegin = columnBegin,
+			.columnEnd = std::max(static_cast<uint32_t>(std::min(std::ceil(screenBounds.maximumX), screenWidth)), columnBegin + 1u) - 1u,
+			.rowBegin = rowBegin,
+			.rowEnd = std::max(static_cast<uint32_t>(std::min(std::ceil(screenBounds.maximumY), screenHeight)), rowBegin + 1u) - 1u,
+		};
+	}
+
+	uint32_t GetHiZMipCount(uint32_t width, uint32_t height)
+	{
+		return gfx::GetDownsampleMipCount(static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })))) + 1u;
+	}
+
+	uint32_t GetHiZTexelIndex(uint32_t pixel, uint32_t dimension, uint32_t mipLevel)
+	{
+		// The last texel of a mip also covers the last texel of an odd previous mip.
+		uint32_t index = pixel;
+		for (uint32_t level = 1u; level <= mipLevel; ++level)
+		{
+			index = std::min(index >> 1u, gfx::GetDownsampleMipDimension(dimension, level) - 1u);
+		}
+
+		return index;
+	}
+
+	std::optional<uint32_t> GetHiZMipLevel(const HiZPixelRect& pixelRect, uint32_t width, uint32_t height, uint32_t mipCount)
+	{
+		uint32_t columnBegin = pixelRect.columnBegin;
+		uint32_t columnEnd = pixelRect.columnEnd;
+		uint32_t rowBegin = pixelRect.rowBegin;
+		uint32_t rowEnd = pixelRect.rowEnd;
+
+		// Same as GetHiZTexelIndex, for the 4 edges at once.
+		for (uint32_t mipLevel = 0u; mipLevel < mipCount; ++mipLevel)
+		{
+			if (mipLevel != 0u)
+			{
+				const uint32_t lastColumn = gfx::GetDownsampleMipDimension(width, mipLevel) - 1u;
+				const uint32_t lastRow = gfx::GetDownsampleMipDimension(height, mipLevel) - 1u;
+
+				columnBegin = std::min(columnBegin >> 1u, lastColumn);
+				columnEnd = std::min(columnEnd >> 1u, lastColumn);
+				rowBegin = std::min(rowBegin >> 1u, lastRow);
+				rowEnd = std::min(rowEnd >> 1u, lastRow);
+			}
+
+			if (columnEnd - columnBegin <= 1u && rowEnd - rowBegin <= 1u)
+			{
+				return mipLevel;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	void HiZPyramid::Build(std::span<const float> depth, uint32_t width, uint32_t height)
+	{
+		mWidth = width;
+		mHeight = height;
+
+		gfx::DownsampleImage mip0
+		{
+			.width = width,
+			.height = height,
+		};
+
+		mip0.texels.resize(depth.size());
+		std::ranges::transform(depth, mip0.texels.begin(), [](float value) { return gfx::DownsampleTexel{ value, value, value, value }; });
+
+		const uint32_t mipCount = GetHiZMipCount(width, height);
+
+		mMips.clear();
+		mMips.reserve(mipCount);
+		mMips.push_back(std::move(mip0));
+
+		if (mipCount > 1u)
+		{
+			std::vector<gfx::DownsampleImage> mips = gfx::DownsampleReference(mMips.front(), mipCount - 1u, gfx::DownsampleReduction::MinMax);
+			std::ranges::move(mips, std::back_inserter(mMips));
+		}
+	}
+
+	bool HiZPyramid::IsBoundingBoxOccluded(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix) const
+	{
+		if (IsEmpty())
+		{
+			return false;
+		}
+
+		const std::optional<HiZScreenBounds> screenBounds = ProjectBoundingBoxToScreen(boundingBox, viewProjectionMatrix, mWidth, mHeight);
+		if (!screenBounds.has_value())
+		{
+			return false;
+		}
+
+		const std::optional<HiZPixelRect> pixelRect = GetHiZPixelRect(*screenBounds, mWidth, mHeight);
+		if (!pixelRect.has_value())
+		{
+			return false;
+		}
+
+		const std::optional<uint32_t> mipLevel = GetHiZMipLevel(*pixelRect, mWidth, mHeight, GetMipCount());
+		if (!mipLevel.has_value())
+		{
+			return false;
+		}
+
+		const uint32_t columnBegin = GetHiZTexelIndex(pixelRect->columnBegin, mWidth, *mipLevel);
+		const uint32_t columnEnd = GetHiZTexelIndex(pixelRect->columnEnd, mWidth, *mipLevel);
+		const uint32_t rowBegin = GetHiZTexelIndex(pixelRect->rowBegin, mHeight, *mipLevel);
+		const uint32_t rowEnd = GetHiZTexelIndex(pixelRect->rowEnd, mHeight, *mipLevel);
+
+		// The maximum depth is in y (see DownsampleReduction::MinMax).
+		float maximumDepth = 0.0f;
+		for (uint32_t y = rowBegin; y <= rowEnd; ++y)
+		{
+			for (uint32_t x = columnBegin; x <= columnEnd; ++x)
+			{
+				maximumDepth = std::max(maximumDepth, GetTexel(*mipLevel, x, y)[1]);
+			}
+		}
+
+		return screenBounds->minimumZ > maximumDepth;
+	}
+
+	bool CullHiZDraw(HiZCullingPhase phase, const HiZDrawBounds& drawBounds, const HiZPyramid& pyramid, const Matrix4x4& viewProjectionMatrix, std::span<uint8_t> visibility)
+	{
+		uint8_t& isVisible = visibility[drawBounds.visibilityIndex];
+
+		if (phase == HiZCullingPhase::First && isVisible == 0u)
+		{
+			return false;
+		}
+
+		const BoundingBox boundingBox
+		{
+			.minimum = drawBounds.minimum,
+			.maximum = drawBounds.maximum,
+		};
+
+		const bool isOccluded = pyramid.IsBoundingBoxOccluded(boundingBox, viewProjectionMatrix);
+
+		if (phase == HiZCullingPhase::First)
+		{
+			isVisible = isOccluded ? 0u : 1u;
+			return !isOccluded;
+		}
+
+		const bool wasDrawn = isVisible != 0u;
+		isVisible = isOccluded ? 0u : 1u;
+
+		return !isOccluded && !wasDrawn;
+	}
+
+	uint32_t CullHiZDraws(HiZCullingPhase phase, std::span<const HiZDrawBounds> drawBounds, const HiZPyramid& pyramid, const Matrix4x4& viewProjectionMatrix,
+		std::span<uint8_t> visibility, std::vector<uint32_t>& drawIndices)
+	{
+		uint32_t drawCount{};
+		for (uint32_t drawIndex = 0u; drawIndex < drawBounds.size(); ++drawIndex)
+		{
+			if (CullHiZDraw(phase, drawBounds[drawIndex], pyramid, viewProjectionMatrix, visibility))
+			{
+				drawIndices.push_back(drawIndex);
+				++drawCount;
+			}
+		}
+
+		return drawCount;
+	}
+}
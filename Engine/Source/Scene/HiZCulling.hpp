@@ -0,0 +1,102 @@
+#pragma once
+
+#include "FrustumCulling.hpp"
+
+#include "Graphics/API/SinglePassDownsampler.hpp"
+
+#include <optional>
+
+namespace helios::scene
+{
+	// Per draw input of the GPU occlusion culling : the world space bounds of what the draw renders (a mesh here, but nothing assumes so), and the index of
+	// its entry in the visibility persisted across frames. Same layout as the HiZDrawBounds of HiZCullingCS.hlsl.
+	struct HiZDrawBounds
+	{
+		Float3 minimum{};
+		uint32_t visibilityIndex{};
+		Float3 maximum{};
+		uint32_t padding{};
+	};
+
+	// The draws visible in the previous frame are culled against the previous frame's pyramid and drawn first. The pyramid is then rebuilt from the depth
+	// they wrote, and all draws are culled against it : the draws visible now that were not drawn by the first phase are drawn, and the visibility is updated
+	// for the next frame. Occluders hence do not have to be known on the CPU, and a draw wrongly culled by the first phase (i.e as the camera moved since
+	// the pyramid was built) is drawn by the second.
+	enum class HiZCullingPhase : uint32_t
+	{
+		First,
+		Second,
+	};
+
+	// Screen space bounds (in pixels of mip 0, from the top left corner) of the 8 corners of a box, and the nearest depth of the corners.
+	struct HiZScreenBounds
+	{
+		float minimumX{};
+		float maximumX{};
+		float minimumY{};
+		float maximumY{};
+		float minimumZ{};
+	};
+
+	// Pixels [begin, end] along each axis.
+	struct HiZPixelRect
+	{
+		uint32_t columnBegin{};
+		uint32_t columnEnd{};
+		uint32_t rowBegin{};
+		uint32_t rowEnd{};
+	};
+
+	// std::nullopt if one of the corners is in front of the near plane (standard depth and D3D clip space, as the OcclusionBuffer).
+	std::optional<HiZScreenBounds> ProjectBoundingBoxToScreen(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix, uint32_t width, uint32_t height);
+
+	// Every pixel the bounds touch (not only the ones whose center they contain), or std::nullopt if the bounds are outside of the screen.
+	std::optional<HiZPixelRect> GetHiZPixelRect(const HiZScreenBounds& screenBounds, uint32_t width, uint32_t height);
+
+	// Mips (including mip 0) of the pyramid of a width x height depth buffer : down to 1 x 1, or as many as the single pass downsampler generates.
+	uint32_t GetHiZMipCount(uint32_t width, uint32_t height);
+
+	// Texel of the mip whose footprint (see gfx::GetDownsampleFootprint, applied from mip 0) contains the pixel, along one axis.
+	uint32_t GetHiZTexelIndex(uint32_t pixel, uint32_t dimension, uint32_t mipLevel);
+
+	// Lowest mip at which the rect touches at most 2 x 2 texels, or std::nullopt if it touches more at the last mip (for pyramids not reaching 1 x 1).
+	std::optional<uint32_t> GetHiZMipLevel(const HiZPixelRect& pixelRect, uint32_t width, uint32_t height, uint32_t mipCount);
+
+	// CPU version of the depth pyramid built on the GPU : mip 0 holds the depth in x and y, and the mips are reduced with DownsampleReduction::MinMax, so every
+	// texel holds the (minimum, maximum) depth of the pixels of its footprint.
+	class HiZPyramid
+	{
+	public:
+		// depth is row major (width x height).
+		void Build(std::span<const float> depth, uint32_t width, uint32_t height);
+
+		// An empty pyramid (never built) occludes nothing.
+		bool IsEmpty() const { return mMips.empty(); }
+
+		// A box is occluded if its nearest depth is behind the maximum depth of the (at most 2 x 2) texels of the mip selected by GetHiZMipLevel.
+		// Boxes crossing the near plane, or outside of the screen, are never occluded (the latter being left to the frustum culling).
+		bool IsBoundingBoxOccluded(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix) const;
+
+		const gfx::DownsampleTexel& GetTexel(uint32_t mipLevel, uint32_t x, uint32_t y) const { return mMips[mipLevel].At(x, y); }
+
+		uint32_t GetWidth() const { return mWidth; }
+		uint32_t GetHeight() const { return mHeight; }
+		uint32_t GetMipCount() const { return static_cast<uint32_t>(mMips.size()); }
+
+	private:
+		uint32_t mWidth{};
+		uint32_t mHeight{};
+
+		// Mip 0 onwards.
+		std::vector<gfx::DownsampleImage> mMips{};
+	};
+
+	// Mirror of HiZCullingCS.hlsl (one thread per draw) : returns true if the draw is drawn by the phase. The first phase only tests the draws whose
+	// visibility is set, and clears it for the occluded ones. The second phase tests all draws, draws the visible ones whose visibility is not set (they
+	// were not drawn by the first phase), and sets the visibility to whether the draw is visible.
+	bool CullHiZDraw(HiZCullingPhase phase, const HiZDrawBounds& drawBounds, const HiZPyramid& pyramid, const Matrix4x4& viewProjectionMatrix, std::span<uint8_t> visibility);
+
+	// Culls every draw, appending the indices of the draws drawn by the phase to drawIndices. Returns the number of draws appended.
+	uint32_t CullHiZDraws(HiZCullingPhase phase, std::span<const HiZDrawBounds> drawBounds, const HiZPyramid& pyramid, const Matrix4x4& viewProjectionMatrix,
+		std::span<uint8_t> visibility, std::vector<uint32_t>& drawIndices);
+}
@@ -56,22 +56,21 @@ namespace helios::scene
 		}
 	}
 
-	void Light::Update()
+	void Light::Update(const LightBuffer& lightBufferData)
 	{
 		// Make the model matrix.
 		if (mLightType == LightTypes::PointLightData)
 		{
-			math::XMVECTOR translationVector = math::XMLoadFloat4(&sLightBufferData.lightPosition[mLightNumber]);
+			math::XMVECTOR translationVector = math::XMLoadFloat4(&lightBufferData.lightPosition[mLightNumber]);
 
-			sLightInstanceData.modelMatrix[mLightNumber] = math::XMMatrixScaling(sLightBufferData.radiusIntensity[mLightNumber].x, sLightBufferData.radiusIntensity[mLightNumber].x, sLightBufferData.radiusIntensity[mLightNumber].x) * math::XMMatrixTranslationFromVector(translationVector);
-
-			sLightInstanceBuffer->Update(&sLightInstanceData);
+			sLightInstanceData.modelMatrix[mLightNumber] = math::XMMatrixScaling(lightBufferData.radiusIntensity[mLightNumber].x, lightBufferData.radiusIntensity[mLightNumber].x, lightBufferData.radiusIntensity[mLightNumber].x) * math::XMMatrixTranslationFromVector(translationVector);
 		}
 	}
 
-	void Light::UpdateLightBuffer()
+	void Light::UpdateLightBuffer(const LightBuffer& lightBufferData)
 	{	
-		sLightBuffer->Update(&sLightBufferData);
+		sLightBuffer->Update(&lightBufferData);
+		sLightInstanceBuffer->Update(&sLightInstanceData);
 	}
 
 	void Light::Render(const gfx::GraphicsContext* graphicsContext, LightRenderResources& lightRenderResources)
@@ -36,11 +36,12 @@ namespace helios::scene
 		static LightBuffer* GetLightBufferData() { return &sLightBufferData; }
 		static uint32_t GetCbvIndex() { return gfx::Buffer::GetCbvIndex(sLightBuffer.get()); }
 		
-		// Update light position (form the static b).
-		void Update();
+		// Update the light's instance model matrix (from the light buffer data).
+		void Update(const LightBuffer& lightBufferData);
 		
-		// Update the static member variables (light buffer).
-		static void UpdateLightBuffer();
+		// Update the static light buffer and light instance buffer.
+		// note(rtarun9) : The light buffer data (GetLightBufferData) is the state edited by the editor / application, while lightBufferData is the snapshot of it being rendered.
+		static void UpdateLightBuffer(const LightBuffer& lightBufferData);
 
 		// note(rtarun9) Its a bit frustrating to use this LightRenderResources as in each relevant function call a new struct is created which copies some data into it and passes on the struct 
 		// to another function (and so on). For this, desisgnated initializers will not be used here. Also, the function will take a reference to the struct and not a const ref, which is a exception.
@@ -80,37 +80,35 @@ namespace helios::scene
 
 		}
 
-		// Load samplers.
-		std::thread loadSamplerThread([&]()
-		{
-			LoadSamplers(device, model);
-		});
-		
+		// Load samplers (materials refer to the sampler indices, so this is done before loading the materials).
+		LoadSamplers(device, model);
+
+		core::JobSystem& jobSystem = core::JobSystem::Get();
+		core::JobCounter loadCounter{};
+
 		// Load textures and materials.
-		std::thread loadMaterialThread([&]()
+		jobSystem.Schedule([&]()
 		{
 			LoadMaterials(device, model);
-		});
+		}, &loadCounter);
 		
 		// Build meshes.
 		tinygltf::Scene& scene = model.scenes[model.defaultScene];
 		
-		std::thread loadMeshThread([&]()
+		jobSystem.Schedule([&]()
 		{
 			for (const int& nodeIndex : scene.nodes)
 			{
 				LoadNode(device, modelCreationDesc, nodeIndex, model);
 			}
-		});
+		}, &loadCounter);
 		
-		loadSamplerThread.join();
-		loadMaterialThread.join();
-		loadMeshThread.join();
+		jobSystem.Wait(loadCounter);
 	}
 
 
-	// For slight speed up in model loading, one thread will be used to load / create materials (i.e the material textures),
-	// and one thread will read the mesh and fill the various accessors (position, indices, texture coord's, etc) into vector so they can be loaded into buffers.
+	// For speed up in model loading, one job will be used to load / create materials (which in turn uses a job per material),
+	// and one job will read the mesh and fill the various accessors (position, indices, texture coord's, etc) into vector so they can be loaded into buffers.
 	void Model::LoadNode(const gfx::Device* device, const ModelCreationDesc& modelCreationDesc, uint32_t nodeIndex, tinygltf::Model& model)
 	{
 		tinygltf::Node& node = model.nodes[nodeIndex];
@@ -302,6 +300,27 @@ namespace helios::scene
 
 			mesh.materialIndex = primitive.material;
 
+			// XMFLOAT3 has the layout of Float3 (the culling code does not depend on DirectXMath).
+			static_assert(sizeof(math::XMFLOAT3) == sizeof(Float3));
+			const std::span<const Float3> boundsPositions(reinterpret_cast<const Float3*>(modelPositions.data()), modelPositions.size());
+
+			mesh.boundingBox = ComputeBoundingBox(boundsPositions);
+			mesh.boundingSphere = ComputeBoundingSphere(boundsPositions, mesh.boundingBox);
+
+			const float boundingBoxSizeX = mesh.boundingBox.maximum[0] - mesh.boundingBox.minimum[0];
+			const float boundingBoxSizeY = mesh.boundingBox.maximum[1] - mesh.boundingBox.minimum[1];
+			const float boundingBoxSizeZ = mesh.boundingBox.maximum[2] - mesh.boundingBox.minimum[2];
+			const float boundingBoxDiagonal = std::sqrt(boundingBoxSizeX * boundingBoxSizeX + boundingBoxSizeY * boundingBoxSizeY + boundingBoxSizeZ * boundingBoxSizeZ);
+
+			if (modelCreationDesc.minimumOccluderSize.has_value() && boundingBoxDiagonal >= *modelCreationDesc.minimumOccluderSize)
+			{
+				mesh.occluderMesh = std::make_shared<const OccluderMesh>(OccluderMesh
+				{
+					.positions = std::vector<Float3>(boundsPositions.begin(), boundsPositions.end()),
+					.indices = indices,
+				});
+			}
+
 			mMeshes.push_back(mesh);
 		}
 
@@ -447,6 +466,9 @@ namespace helios::scene
 
 	void Model::LoadMaterials(const gfx::Device* device, tinygltf::Model& model)
 	{
+		// The mips of all material textures are generated by a single submission, once all materials are loaded.
+		gfx::MipMapGenerationBatch mipMapGenerationBatch{};
+
 		auto CreateTexture = [&](tinygltf::Image& image, gfx::TextureCreationDesc& textureCreationDesc)
 		{
 			std::string texturePath = WstringToString(mModelDirectory) + image.uri;
@@ -460,158 +482,213 @@ namespace helios::scene
 
 			// Create max mip levels possible.
 
-			textureCreationDesc.mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height))) + 1);
+			textureCreationDesc.mipLevels = gfx::GetFullMipChainLevelCount(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
 	
 			textureCreationDesc.dimensions = { (uint32_t)width, (uint32_t)height };
+			textureCreationDesc.mipMapGenerationBatch = &mipMapGenerationBatch;
 
 			return std::move(std::make_unique<gfx::Texture>(device->CreateTexture(textureCreationDesc, data)));
 		};
 
-		size_t index{ 0 };
 		mMaterials.resize(model.materials.size());
 
-		for (const tinygltf::Material& material : model.materials)
+		// Each material is loaded by a separate job, as decoding the material textures is the most expensive part of loading a model.
+		core::JobSystem::Get().ParallelFor(static_cast<uint32_t>(model.materials.size()), 1u, [&](uint32_t materialIndexBegin, uint32_t materialIndexEnd)
 		{
-			PBRMaterial pbrMaterial{};
-
+			for (uint32_t index = materialIndexBegin; index < materialIndexEnd; ++index)
 			{
-				if (material.pbrMetallicRoughness.baseColorTexture.index >= 0)
-				{
-					gfx::TextureCreationDesc albedoTextureCreationDesc
-					{
-						.usage = gfx::TextureUsage::TextureFromData,
-						.format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
-						.mipLevels = 6u,
-						.name = mModelName + L" albedo texture"
-					};
+				const tinygltf::Material& material = model.materials[index];
 
-					tinygltf::Texture& albedoTexture = model.textures[material.pbrMetallicRoughness.baseColorTexture.index];
-					tinygltf::Image& albedoImage = model.images[albedoTexture.source];
+				PBRMaterial pbrMaterial{};
 
-					pbrMaterial.albedoTexture = CreateTexture(albedoImage, albedoTextureCreationDesc);
-					pbrMaterial.albedoTextureSamplerIndex = mSamplers[albedoTexture.sampler];
-				}
+				{
+					if (material.pbrMetallicRoughness.baseColorTexture.index >= 0)
+					{
+						gfx::TextureCreationDesc albedoTextureCreationDesc
+						{
+							.usage = gfx::TextureUsage::TextureFromData,
+							.format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+							.mipLevels = 6u,
+							.name = mModelName + L" albedo texture"
+						};
+
+						tinygltf::Texture& albedoTexture = model.textures[material.pbrMetallicRoughness.baseColorTexture.index];
+						tinygltf::Image& albedoImage = model.images[albedoTexture.source];
+
+						pbrMaterial.albedoTexture = CreateTexture(albedoImage, albedoTextureCreationDesc);
+						pbrMaterial.albedoTextureSamplerIndex = mSamplers[albedoTexture.sampler];
+					}
 
-			};
+				};
 			
-			{
-				if (material.pbrMetallicRoughness.metallicRoughnessTexture.index >= 0)
 				{
-					gfx::TextureCreationDesc metalRoughnessTextureCreationDesc
+					if (material.pbrMetallicRoughness.metallicRoughnessTexture.index >= 0)
 					{
-						.usage = gfx::TextureUsage::TextureFromData,
-						.format = DXGI_FORMAT_R8G8B8A8_UNORM,
-						.mipLevels = 4u,
-						.name = mModelName + L" metal roughness texture"
-					};
-
-					tinygltf::Texture& metalRoughnessTexture = model.textures[material.pbrMetallicRoughness.metallicRoughnessTexture.index];
-					tinygltf::Image& metalRoughnessImage = model.images[metalRoughnessTexture.source];
-
-					pbrMaterial.metalRoughnessTexture = CreateTexture(metalRoughnessImage, metalRoughnessTextureCreationDesc);
-					pbrMaterial.metalRoughnessTextureSamplerIndex = mSamplers[metalRoughnessTexture.sampler];
-				}
-			};
+						gfx::TextureCreationDesc metalRoughnessTextureCreationDesc
+						{
+							.usage = gfx::TextureUsage::TextureFromData,
+							.format = DXGI_FORMAT_R8G8B8A8_UNORM,
+							.mipLevels = 4u,
+							.name = mModelName + L" metal roughness texture"
+						};
+
+						tinygltf::Texture& metalRoughnessTexture = model.textures[material.pbrMetallicRoughness.metallicRoughnessTexture.index];
+						tinygltf::Image& metalRoughnessImage = model.images[metalRoughnessTexture.source];
+
+						pbrMaterial.metalRoughnessTexture = CreateTexture(metalRoughnessImage, metalRoughnessTextureCreationDesc);
+						pbrMaterial.metalRoughnessTextureSamplerIndex = mSamplers[metalRoughnessTexture.sampler];
+					}
+				};
 
-			{
-				if (material.normalTexture.index >= 0)
 				{
-					gfx::TextureCreationDesc normalTextureCreationDesc
+					if (material.normalTexture.index >= 0)
 					{
-						.usage = gfx::TextureUsage::TextureFromData,
-						.format = DXGI_FORMAT_R8G8B8A8_UNORM,
-						.mipLevels = 2u,
-						.name = mModelName + L" normal texture",
-					};
-
-					tinygltf::Texture& normalTexture = model.textures[material.normalTexture.index];
-					tinygltf::Image& normalImage = model.images[normalTexture.source];
-
-					pbrMaterial.normalTexture = CreateTexture(normalImage, normalTextureCreationDesc);
-					pbrMaterial.normalTextureSamplerIndex = mSamplers[normalTexture.sampler];
-				}
-			};
+						gfx::TextureCreationDesc normalTextureCreationDesc
+						{
+							.usage = gfx::TextureUsage::TextureFromData,
+							.format = DXGI_FORMAT_R8G8B8A8_UNORM,
+							.mipLevels = 2u,
+							.name = mModelName + L" normal texture",
+						};
+
+						tinygltf::Texture& normalTexture = model.textures[material.normalTexture.index];
+						tinygltf::Image& normalImage = model.images[normalTexture.source];
+
+						pbrMaterial.normalTexture = CreateTexture(normalImage, normalTextureCreationDesc);
+						pbrMaterial.normalTextureSamplerIndex = mSamplers[normalTexture.sampler];
+					}
+				};
 
-			{
-				if (material.occlusionTexture.index >= 0)
 				{
-					gfx::TextureCreationDesc occlusionTextureCreationDesc
+					if (material.occlusionTexture.index >= 0)
 					{
-						.usage = gfx::TextureUsage::TextureFromData,
-						.format = DXGI_FORMAT_R8G8B8A8_UNORM,
-						.mipLevels = 4u,
-						.name = mModelName + L" occlusion texture",
-					};
-
-					tinygltf::Texture& aoTexture = model.textures[material.occlusionTexture.index];
-					tinygltf::Image& aoImage = model.images[aoTexture.source];
-
-					pbrMaterial.aoTexture = CreateTexture(aoImage, occlusionTextureCreationDesc);
-					pbrMaterial.aoTextureSamplerIndex = mSamplers[aoTexture.sampler];
-				}
-			};
+						gfx::TextureCreationDesc occlusionTextureCreationDesc
+						{
+							.usage = gfx::TextureUsage::TextureFromData,
+							.format = DXGI_FORMAT_R8G8B8A8_UNORM,
+							.mipLevels = 4u,
+							.name = mModelName + L" occlusion texture",
+						};
+
+						tinygltf::Texture& aoTexture = model.textures[material.occlusionTexture.index];
+						tinygltf::Image& aoImage = model.images[aoTexture.source];
+
+						pbrMaterial.aoTexture = CreateTexture(aoImage, occlusionTextureCreationDesc);
+						pbrMaterial.aoTextureSamplerIndex = mSamplers[aoTexture.sampler];
+					}
+				};
 			
-			{
-				if (material.emissiveTexture.index >= 0)
 				{
-					gfx::TextureCreationDesc emissiveTextureCreationDesc
+					if (material.emissiveTexture.index >= 0)
 					{
-						.usage = gfx::TextureUsage::TextureFromData,
-						.format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
-						.mipLevels = 4u,
-						.name = mModelName + L" emissive texture",
-					};
-
-					tinygltf::Texture& emissiveTexture = model.textures[material.emissiveTexture.index];
-					tinygltf::Image& emissiveImage = model.images[emissiveTexture.source];
+						gfx::TextureCreationDesc emissiveTextureCreationDesc
+						{
+							.usage = gfx::TextureUsage::TextureFromData,
+							.format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+							.mipLevels = 4u,
+							.name = mModelName + L" emissive texture",
+						};
+
+						tinygltf::Texture& emissiveTexture = model.textures[material.emissiveTexture.index];
+						tinygltf::Image& emissiveImage = model.images[emissiveTexture.source];
+
+						pbrMaterial.emissiveTexture = CreateTexture(emissiveImage, emissiveTextureCreationDesc);
+						pbrMaterial.emissiveTextureSamplerIndex = mSamplers[emissiveTexture.sampler];
+					}
+				};
 
-					pbrMaterial.emissiveTexture = CreateTexture(emissiveImage, emissiveTextureCreationDesc);
-					pbrMaterial.emissiveTextureSamplerIndex = mSamplers[emissiveTexture.sampler];
-				}
-			};
+				mMaterials[index] = std::move(pbrMaterial);
+			}
+		});
 
-			mMaterials[index++] = std::move(pbrMaterial);
-		}
+		device->GetMipMapGenerator()->GenerateMips(mipMapGenerationBatch);
 	}
 	
-	void Model::Render(const gfx::GraphicsContext* graphicsContext, const SceneRenderResources& sceneRenderResources)
+	void Model::TrackResidency(const gfx::GraphicsContext* graphicsContext, const Mesh& mesh) const
 	{
-		for (const Mesh& mesh : mMeshes)
+		graphicsContext->TrackResidency(mesh.positionBuffer.get());
+		graphicsContext->TrackResidency(mesh.textureCoordsBuffer.get());
+		graphicsContext->TrackResidency(mesh.normalBuffer.get());
+		graphicsContext->TrackResidency(mesh.tangentBuffer.get());
+		graphicsContext->TrackResidency(mesh.biTangentBuffer.get());
+
+		// Primitives without a material (i.e light / sky box meshes) have a invalid material index.
+		if (mesh.materialIndex >= mMaterials.size())
 		{
-			graphicsContext->SetIndexBuffer(mesh.indexBuffer.get());
+			return;
+		}
 
-			PBRRenderResources pbrRenderResources
-			{
-				.positionBufferIndex = gfx::Buffer::GetSrvIndex(mesh.positionBuffer.get()),
-				.textureBufferIndex = gfx::Buffer::GetSrvIndex(mesh.textureCoordsBuffer.get()),
-				.normalBufferIndex = gfx::Buffer::GetSrvIndex(mesh.normalBuffer.get()),
-				.tangentBufferIndex = gfx::Buffer::GetSrvIndex(mesh.tangentBuffer.get()),
-				.biTangentBufferIndex = gfx::Buffer::GetSrvIndex(mesh.biTangentBuffer.get()),
+		const PBRMaterial& material = mMaterials[mesh.materialIndex];
 
-				.transformBufferIndex = gfx::Buffer::GetCbvIndex(mTransform.transformBuffer.get()),
-				.sceneBufferIndex = sceneRenderResources.sceneBufferIndex,
-				.lightBufferIndex = sceneRenderResources.lightBufferIndex,
+		graphicsContext->TrackResidency(material.albedoTexture.get());
+		graphicsContext->TrackResidency(material.normalTexture.get());
+		graphicsContext->TrackResidency(material.metalRoughnessTexture.get());
+		graphicsContext->TrackResidency(material.aoTexture.get());
+		graphicsContext->TrackResidency(material.emissiveTexture.get());
+	}
 
-				.albedoTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].albedoTexture.get()),
-				.albedoTextureSamplerIndex = mMaterials[mesh.materialIndex].albedoTextureSamplerIndex,
+	PBRRenderResources Model::GetPBRRenderResources(const Mesh& mesh, const SceneRenderResources& sceneRenderResources) const
+	{
+		return PBRRenderResources
+		{
+			.positionBufferIndex = gfx::Buffer::GetSrvIndex(mesh.positionBuffer.get()),
+			.textureBufferIndex = gfx::Buffer::GetSrvIndex(mesh.textureCoordsBuffer.get()),
+			.normalBufferIndex = gfx::Buffer::GetSrvIndex(mesh.normalBuffer.get()),
+			.tangentBufferIndex = gfx::Buffer::GetSrvIndex(mesh.tangentBuffer.get()),
+			.biTangentBufferIndex = gfx::Buffer::GetSrvIndex(mesh.biTangentBuffer.get()),
 
-				.metalRoughnessTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].metalRoughnessTexture.get()),
-				.metalRoughnessTextureSamplerIndex = mMaterials[mesh.materialIndex].metalRoughnessTextureSamplerIndex,
-				
-				.normalTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].normalTexture.get()),
-				.normalTextureSamplerIndex = mMaterials[mesh.materialIndex].normalTextureSamplerIndex,
+			.transformBufferIndex = gfx::Buffer::GetCbvIndex(mTransform.transformBuffer.get()),
+			.sceneBufferIndex = sceneRenderResources.sceneBufferIndex,
+			.lightBufferIndex = sceneRenderResources.lightBufferIndex,
 
-				.aoTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].aoTexture.get()),
-				.aoTextureSamplerIndex = mMaterials[mesh.materialIndex].aoTextureSamplerIndex,
+			.albedoTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].albedoTexture.get()),
+			.albedoTextureSamplerIndex = mMaterials[mesh.materialIndex].albedoTextureSamplerIndex,
 
-				.emissiveTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].emissiveTexture.get()),
-				.emissiveTextureSamplerIndex = mMaterials[mesh.materialIndex].emissiveTextureSamplerIndex
-			};
+			.metalRoughnessTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].metalRoughnessTexture.get()),
+			.metalRoughnessTextureSamplerIndex = mMaterials[mesh.materialIndex].metalRoughnessTextureSamplerIndex,
+			
+			.normalTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].normalTexture.get()),
+			.normalTextureSamplerIndex = mMaterials[mesh.materialIndex].normalTextureSamplerIndex,
 
+			.aoTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].aoTexture.get()),
+			.aoTextureSamplerIndex = mMaterials[mesh.materialIndex].aoTextureSamplerIndex,
 
-			graphicsContext->Set32BitGraphicsConstants(&pbrRenderResources);
-			graphicsContext->DrawInstanceIndexed(mesh.indicesCount);
-		}
+			.emissiveTextureIndex = gfx::Texture::GetSrvIndex(mMaterials[mesh.materialIndex].emissiveTexture.get()),
+			.emissiveTextureSamplerIndex = mMaterials[mesh.materialIndex].emissiveTextureSamplerIndex
+		};
+	}
+
+	void Model::RenderMesh(const gfx::GraphicsContext* graphicsContext, const SceneRenderResources& sceneRenderResources, uint32_t meshIndex) const
+	{
+		const Mesh& mesh = mMeshes[meshIndex];
+
+		TrackResidency(graphicsContext, mesh);
+		graphicsContext->SetIndexBuffer(mesh.indexBuffer.get());
+
+		const PBRRenderResources pbrRenderResources = GetPBRRenderResources(mesh, sceneRenderResources);
+
+		graphicsContext->Set32BitGraphicsConstants(&pbrRenderResources);
+		graphicsContext->DrawInstanceIndexed(mesh.indicesCount);
+	}
+
+	void Model::AddIndirectDraw(const gfx::GraphicsContext* graphicsContext, gfx::IndirectDrawStream& indirectDrawStream, const SceneRenderResources& sceneRenderResources,
+		uint32_t meshIndex) const
+	{
+		const Mesh& mesh = mMeshes[meshIndex];
+
+		// The index buffer is set by the command signature, so it is tracked here rather than by SetIndexBuffer.
+		TrackResidency(graphicsContext, mesh);
+		graphicsContext->TrackResidency(mesh.indexBuffer.get());
+
+		const gfx::IndexBufferView indexBufferView
+		{
+			.bufferLocation = mesh.indexBuffer->allocation->resource->GetGPUVirtualAddress(),
+			.sizeInBytes = static_cast<uint32_t>(mesh.indexBuffer->sizeInBytes),
+			.format = static_cast<uint32_t>(DXGI_FORMAT_R32_UINT),
+		};
+
+		indirectDrawStream.AddDraw(indexBufferView, gfx::DrawIndexedArguments{ .indexCountPerInstance = mesh.indicesCount, .instanceCount = 1u },
+			GetPBRRenderResources(mesh, sceneRenderResources));
 	}
 
 	// See Light.hpp for why this function takes a ref and not const ref to the render resources struct.
@@ -619,6 +696,7 @@ namespace helios::scene
 	{
 		for (const Mesh& mesh : mMeshes)
 		{
+			TrackResidency(graphicsContext, mesh);
 			graphicsContext->SetIndexBuffer(mesh.indexBuffer.get());
 
 			lightRenderResources.positionBufferIndex = gfx::Buffer::GetSrvIndex(mesh.positionBuffer.get());
@@ -633,6 +711,7 @@ namespace helios::scene
 	{
 		for (const Mesh& mesh : mMeshes)
 		{
+			TrackResidency(graphicsContext, mesh);
 			graphicsContext->SetIndexBuffer(mesh.indexBuffer.get());
 
 			skyBoxrenderResources.positionBufferIndex = gfx::Buffer::GetSrvIndex(mesh.positionBuffer.get());
@@ -643,22 +722,21 @@ namespace helios::scene
 		}
 	}
 	
-	void Model::Render(const gfx::GraphicsContext* graphicsContext, ShadowMappingRenderResources& shadowMappingRenderResources)
+	void Model::RenderMesh(const gfx::GraphicsContext* graphicsContext, const ShadowMappingRenderResources& shadowMappingRenderResources, uint32_t meshIndex) const
 	{
-		for (const Mesh& mesh : mMeshes)
-		{
-			graphicsContext->SetIndexBuffer(mesh.indexBuffer.get());
+		const Mesh& mesh = mMeshes[meshIndex];
 
-			ShadowMappingRenderResources shadowRenderResources
-			{
-				.positionBufferIndex = gfx::Buffer::GetSrvIndex(mesh.positionBuffer.get()),
-				.transformBufferIndex = gfx::Buffer::GetCbvIndex(mTransform.transformBuffer.get()),
-				.shadowMappingBufferIndex = shadowMappingRenderResources.shadowMappingBufferIndex,
-			};
+		TrackResidency(graphicsContext, mesh);
+		graphicsContext->SetIndexBuffer(mesh.indexBuffer.get());
 
+		ShadowMappingRenderResources shadowRenderResources
+		{
+			.positionBufferIndex = gfx::Buffer::GetSrvIndex(mesh.positionBuffer.get()),
+			.transformBufferIndex = gfx::Buffer::GetCbvIndex(mTransform.transformBuffer.get()),
+			.shadowMappingBufferIndex = shadowMappingRenderResources.shadowMappingBufferIndex,
+		};
 
-			graphicsContext->Set32BitGraphicsConstants(&shadowRenderResources);
-			graphicsContext->DrawInstanceIndexed(mesh.indicesCount);
-		}
+		graphicsContext->Set32BitGraphicsConstants(&shadowRenderResources);
+		graphicsContext->DrawInstanceIndexed(mesh.indicesCount);
 	}
 }
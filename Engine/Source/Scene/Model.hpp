@@ -2,6 +2,10 @@
 
 #include "Graphics/API/Resources.hpp"
 #include "Graphics/API/Device.hpp"
+#include "Graphics/API/IndirectDraw.hpp"
+
+#include "Scene/FrustumCulling.hpp"
+#include "Scene/OcclusionCulling.hpp"
 
 #include "Common/BindlessRS.hlsli"
 #include "Common/ConstantBuffers.hlsli"
@@ -24,20 +28,24 @@ namespace helios::scene
 		TransformComponent data{};
 		std::unique_ptr<gfx::Buffer> transformBuffer{};
 
-		void Update()
+		// Computes the transform buffer data from the transform component, without touching the GPU buffer (so it can be done on the update thread).
+		TransformBuffer GetTransformBufferData() const
 		{
 			DirectX::XMVECTOR scalingVector = DirectX::XMLoadFloat3(&data.scale);
 			DirectX::XMVECTOR rotationVector = DirectX::XMLoadFloat3(&data.rotation);
 			DirectX::XMVECTOR translationVector = DirectX::XMLoadFloat3(&data.translate);
 
 			DirectX::XMMATRIX modelMatrix = DirectX::XMMatrixScalingFromVector(scalingVector) * DirectX::XMMatrixRotationRollPitchYawFromVector(rotationVector) * DirectX::XMMatrixTranslationFromVector(translationVector);
-			TransformBuffer updatedTransformBuffer
+			return TransformBuffer
 			{
 				.modelMatrix = modelMatrix,
 				.inverseModelMatrix = DirectX::XMMatrixInverse(nullptr, modelMatrix),
 			};
-			
-			transformBuffer->Update(&updatedTransformBuffer);
+		}
+
+		void Update(const TransformBuffer& transformBufferData)
+		{
+			transformBuffer->Update(&transformBufferData);
 		}
 	};
 
@@ -75,12 +83,23 @@ namespace helios::scene
 		uint32_t indicesCount{};
 
 		uint32_t materialIndex{};
+
+		// In model space (computed from the positions at import). Transformed by the model matrix when culling (see Scene::CullModels).
+		BoundingBox boundingBox{};
+		BoundingSphere boundingSphere{};
+
+		// CPU copy of the positions / indices, rasterized into the occlusion buffer by Scene::CullModels. Only kept for the meshes large enough to hide others
+		// (see ModelCreationDesc::minimumOccluderSize).
+		std::shared_ptr<const OccluderMesh> occluderMesh{};
 	};
 
 	struct ModelCreationDesc
 	{
 		std::wstring modelPath{};
 		std::wstring modelName{};
+
+		// The meshes whose bounding box diagonal (in model space) is at least this long are occluders (i.e the walls / floors of an interior). None if not set.
+		std::optional<float> minimumOccluderSize{};
 	};
 
 	// Model class uses tinygltf for loading GLTF models.
@@ -95,17 +114,33 @@ namespace helios::scene
 
 		Transform* GetTransform() { return &mTransform; };
 		std::wstring GetName() const { return mModelName; }
+		uint32_t GetMeshCount() const { return static_cast<uint32_t>(mMeshes.size()); }
+		std::span<const Mesh> GetMeshes() const { return mMeshes; }
+
+		uint32_t GetMaterialCount() const { return static_cast<uint32_t>(mMaterials.size()); }
 
-		void Render(const gfx::GraphicsContext* graphicsContext, const SceneRenderResources& sceneRenderResources);
+		// Records the draw of a single mesh, so the draws of all models can be recorded in any order (i.e sorted, see Scene::RenderModels) and split across
+		// multiple contexts.
+		void RenderMesh(const gfx::GraphicsContext* graphicsContext, const SceneRenderResources& sceneRenderResources, uint32_t meshIndex) const;
+		void RenderMesh(const gfx::GraphicsContext* graphicsContext, const ShadowMappingRenderResources& shadowMappingRenderResources, uint32_t meshIndex) const;
 		void Render(const gfx::GraphicsContext* graphicsContext, LightRenderResources& lightRenderResources);
 		void Render(const gfx::GraphicsContext* graphicsContext, SkyBoxRenderResources& skyBoxrenderResources);
-		void Render(const gfx::GraphicsContext* graphicsContext, ShadowMappingRenderResources& shadowMappingRenderResources);
+
+		// Adds the draw of a mesh (with the PBRRenderResources of the mesh as its draw data) to the stream, rather than recording it (see Scene::BuildIndirectDraws).
+		// The resources of the mesh are tracked for residency by graphicsContext, which must be executed along with the draws.
+		void AddIndirectDraw(const gfx::GraphicsContext* graphicsContext, gfx::IndirectDrawStream& indirectDrawStream, const SceneRenderResources& sceneRenderResources,
+			uint32_t meshIndex) const;
 
 	private:
 		void LoadNode(const gfx::Device* device, const ModelCreationDesc& modelCreationDesc, uint32_t nodeIndex, tinygltf::Model& model);
 		void LoadSamplers(const gfx::Device* device, tinygltf::Model& model);
 		void LoadMaterials(const gfx::Device* device, tinygltf::Model& model);
 
+		// The mesh buffers / material textures are accessed through the bindless descriptor heap, so they have to be tracked explicitly for residency.
+		void TrackResidency(const gfx::GraphicsContext* graphicsContext, const Mesh& mesh) const;
+
+		PBRRenderResources GetPBRRenderResources(const Mesh& mesh, const SceneRenderResources& sceneRenderResources) const;
+
 		Transform mTransform{};
 	
 	public:
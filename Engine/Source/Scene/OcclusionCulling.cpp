@@ -0,0 +1,844 @@
+#include "OcclusionCulling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define HELIOS_CULLING_X64
+#include <immintrin.h>
+
+// See FrustumCulling.cpp.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define HELIOS_TARGET_AVX
+#else
+#define HELIOS_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace helios::scene
+{
+	static constexpr uint32_t TILE_WIDTH = OcclusionBuffer::TILE_WIDTH;
+	static constexpr uint32_t TILE_HEIGHT = OcclusionBuffer::TILE_HEIGHT;
+
+	static constexpr uint32_t FULL_ROW_MASK = 0xFFFFFFFFu;
+
+	// Offsets of the pixel centers of the rows of a tile, and of the left edges of (up to MAX_CULLING_BATCH_SIZE) consecutive tiles.
+	alignas(32) static constexpr std::array<float, TILE_HEIGHT> ROW_CENTER_OFFSETS{ 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+	alignas(32) static constexpr std::array<float, MAX_CULLING_BATCH_SIZE> TILE_OFFSETS{ 0.0f, 32.0f, 64.0f, 96.0f, 128.0f, 160.0f, 192.0f, 224.0f };
+
+	static_assert(TILE_HEIGHT == 8u && TILE_WIDTH == 32u, "The SIMD implementations assume 8 rows per tile, and one 32 bit mask per row.");
+
+	// The edge's column at the row center y' is x + (y' - y) * slope. A triangle is bounded by one or two edges on each side, the missing ones being at
+	// -inf (left) / +inf (right).
+	struct OcclusionTriangleEdge
+	{
+		float x{};
+		float y{};
+		float slope{};
+	};
+
+	struct OcclusionTriangleEdges
+	{
+		std::array<OcclusionTriangleEdge, 2u> left{};
+		std::array<OcclusionTriangleEdge, 2u> right{};
+	};
+
+	// The depth of the triangle in a tile row is rowDepth + (x' - x) * slopeX, bounded by the farthest vertex. minimumX / maximumX bound the triangle.
+	struct OcclusionDepthPlane
+	{
+		float x{};
+		float slopeX{};
+		float minimumX{};
+		float maximumX{};
+		float maximumZ{};
+	};
+
+	static std::array<float, 4> TransformPosition(const Float3& position, const Matrix4x4& matrix)
+	{
+		std::array<float, 4> result{};
+		for (size_t column = 0u; column < 4u; ++column)
+		{
+			result[column] = ((position[0] * matrix[column] + position[1] * matrix[4u + column]) + position[2] * matrix[8u + column]) + matrix[12u + column];
+		}
+
+		return result;
+	}
+
+	// Note : All implementations compute the row spans, tile depths and projected corners with the same operations in the same order, so they rasterize the
+	// exact same buffer and cull the exact same boxes (no FMA is used, as the scalar code would round differently).
+	// The spans are clamped to [-1, width + 1] before being rounded, so they fit in an int (and the SSE rounding can go through a conversion to int).
+	static void ComputeRowSpansScalar(const OcclusionTriangleEdges& edges, float rowBegin, float maximumColumn, std::array<int32_t, TILE_HEIGHT>& columnBegins,
+		std::array<int32_t, TILE_HEIGHT>& columnEnds)
+	{
+		for (uint32_t i = 0u; i < TILE_HEIGHT; ++i)
+		{
+			const float rowCenter = rowBegin + ROW_CENTER_OFFSETS[i];
+
+			const float left = std::max(edges.left[0].x + (rowCenter - edges.left[0].y) * edges.left[0].slope, edges.left[1].x + (rowCenter - edges.left[1].y) * edges.left[1].slope);
+			const float right = std::min(edges.right[0].x + (rowCenter - edges.right[0].y) * edges.right[0].slope, edges.right[1].x + (rowCenter - edges.right[1].y) * edges.right[1].slope);
+
+			// The covered columns have their center in [left, right].
+			columnBegins[i] = static_cast<int32_t>(std::ceil(std::min(std::max(left, -1.0f), maximumColumn) - 0.5f));
+			columnEnds[i] = static_cast<int32_t>(std::floor(std::min(std::max(right, -1.0f), maximumColumn) - 0.5f));
+		}
+	}
+
+	static void ComputeTileDepthsScalar(const OcclusionDepthPlane& depthPlane, float rowDepth, uint32_t tileXBegin, uint32_t tileCount, float* depths)
+	{
+		for (uint32_t i = 0u; i < tileCount; ++i)
+		{
+			// The plane is the farthest at one of the corners of the part of the tile inside the triangle's bounds.
+			const float tileLeft = static_cast<float>((tileXBegin + i) * TILE_WIDTH);
+			const float farthestX = depthPlane.slopeX > 0.0f ? std::min(tileLeft + static_cast<float>(TILE_WIDTH), depthPlane.maximumX) : std::max(tileLeft, depthPlane.minimumX);
+
+			depths[i] = std::min(rowDepth + (farthestX - depthPlane.x) * depthPlane.slopeX, depthPlane.maximumZ);
+		}
+	}
+
+	struct OcclusionScreenBounds
+	{
+		float minimumX{};
+		float maximumX{};
+		float minimumY{};
+		float maximumY{};
+		float minimumZ{};
+	};
+
+	// Screen space bounds of the 8 corners of the box, or std::nullopt if one of them is in front of the near plane.
+	static std::optional<OcclusionScreenBounds> ProjectBoundingBoxScalar(const BoundingBox& boundingBox, const Matrix4x4& matrix, float width, float height)
+	{
+		OcclusionScreenBounds screenBounds
+		{
+			.minimumX = std::numeric_limits<float>::infinity(),
+			.maximumX = -std::numeric_limits<float>::infinity(),
+			.minimumY = std::numeric_limits<float>::infinity(),
+			.maximumY = -std::numeric_limits<float>::infinity(),
+			.minimumZ = std::numeric_limits<float>::infinity(),
+		};
+
+		for (uint32_t i = 0u; i < 8u; ++i)
+		{
+			const Float3 corner
+			{
+				(i & 1u) ? boundingBox.maximum[0] : boundingBox.minimum[0],
+				(i & 2u) ? boundingBox.maximum[1] : boundingBox.minimum[1],
+				(i & 4u) ? boundingBox.maximum[2] : boundingBox.minimum[2],
+			};
+
+			const std::array<float, 4> clipPosition = TransformPosition(corner, matrix);
+			if (!(clipPosition[3] > 0.0f) || clipPosition[2] < 0.0f)
+			{
+				return std::nullopt;
+			}
+
+			const float x = (clipPosition[0] / clipPosition[3] * 0.5f + 0.5f) * width;
+			const float y = (0.5f - clipPosition[1] / clipPosition[3] * 0.5f) * height;
+
+			screenBounds.minimumX = std::min(screenBounds.minimumX, x);
+			screenBounds.maximumX = std::max(screenBounds.maximumX, x);
+			screenBounds.minimumY = std::min(screenBounds.minimumY, y);
+			screenBounds.maximumY = std::max(screenBounds.maximumY, y);
+			screenBounds.minimumZ = std::min(screenBounds.minimumZ, clipPosition[2] / clipPosition[3]);
+		}
+
+		return screenBounds;
+	}
+
+#if defined(HELIOS_CULLING_X64)
+	static __m128 EvaluateEdgeSse(const OcclusionTriangleEdge& edge, __m128 rowCenter)
+	{
+		return _mm_add_ps(_mm_set1_ps(edge.x), _mm_mul_ps(_mm_sub_ps(rowCenter, _mm_set1_ps(edge.y)), _mm_set1_ps(edge.slope)));
+	}
+
+	// SSE2 has no rounding instruction : the values are small enough to be rounded through a conversion to int (which truncates).
+	static __m128i CeilToIntSse(__m128 value)
+	{
+		const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+		return _mm_cvttps_epi32(_mm_add_ps(truncated, _mm_and_ps(_mm_cmplt_ps(truncated, value), _mm_set1_ps(1.0f))));
+	}
+
+	static __m128i FloorToIntSse(__m128 value)
+	{
+		const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+		return _mm_cvttps_epi32(_mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f))));
+	}
+
+	static void ComputeRowSpansSse(const OcclusionTriangleEdges& edges, float rowBegin, float maximumColumn, std::array<int32_t, TILE_HEIGHT>& columnBegins,
+		std::array<int32_t, TILE_HEIGHT>& columnEnds)
+	{
+		const __m128 minimum = _mm_set1_ps(-1.0f);
+		const __m128 maximum = _mm_set1_ps(maximumColumn);
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		for (uint32_t i = 0u; i < TILE_HEIGHT; i += 4u)
+		{
+			const __m128 rowCenter = _mm_add_ps(_mm_set1_ps(rowBegin), _mm_load_ps(&ROW_CENTER_OFFSETS[i]));
+
+			const __m128 left = _mm_max_ps(EvaluateEdgeSse(edges.left[0], rowCenter), EvaluateEdgeSse(edges.left[1], rowCenter));
+			const __m128 right = _mm_min_ps(EvaluateEdgeSse(edges.right[0], rowCenter), EvaluateEdgeSse(edges.right[1], rowCenter));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&columnBegins[i]), CeilToIntSse(_mm_sub_ps(_mm_min_ps(_mm_max_ps(left, minimum), maximum), half)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&columnEnds[i]), FloorToIntSse(_mm_sub_ps(_mm_min_ps(_mm_max_ps(right, minimum), maximum), half)));
+		}
+	}
+
+	static void ComputeTileDepthsSse(const OcclusionDepthPlane& depthPlane, float rowDepth, uint32_t tileXBegin, uint32_t tileCount, float* depths)
+	{
+		const __m128 slopeX = _mm_set1_ps(depthPlane.slopeX);
+		const __m128 planeX = _mm_set1_ps(depthPlane.x);
+		const __m128 maximumZ = _mm_set1_ps(depthPlane.maximumZ);
+
+		for (uint32_t i = 0u; i < tileCount; i += 4u)
+		{
+			const __m128 tileLeft = _mm_add_ps(_mm_set1_ps(static_cast<float>((tileXBegin + i) * TILE_WIDTH)), _mm_load_ps(TILE_OFFSETS.data()));
+			const __m128 farthestX = depthPlane.slopeX > 0.0f ? _mm_min_ps(_mm_add_ps(tileLeft, _mm_set1_ps(static_cast<float>(TILE_WIDTH))), _mm_set1_ps(depthPlane.maximumX)) :
+				_mm_max_ps(tileLeft, _mm_set1_ps(depthPlane.minimumX));
+
+			_mm_storeu_ps(&depths[i], _mm_min_ps(_mm_add_ps(_mm_set1_ps(rowDepth), _mm_mul_ps(_mm_sub_ps(farthestX, planeX), slopeX)), maximumZ));
+		}
+	}
+
+	// The corners are in 2 batches of 4 lanes, corner i having the maximum of the box along x / y / z if its bit 0 / 1 / 2 is set (as in the scalar version).
+	static std::optional<OcclusionScreenBounds> ProjectBoundingBoxSse(const BoundingBox& boundingBox, const Matrix4x4& matrix, float width, float height)
+	{
+		const __m128 cornerX = _mm_setr_ps(boundingBox.minimum[0], boundingBox.maximum[0], boundingBox.minimum[0], boundingBox.maximum[0]);
+		const __m128 cornerY = _mm_setr_ps(boundingBox.minimum[1], boundingBox.minimum[1], boundingBox.maximum[1], boundingBox.maximum[1]);
+
+		__m128 clipPositions[4]{};
+		std::array<float, 8u> screenX{};
+		std::array<float, 8u> screenY{};
+		std::array<float, 8u> screenZ{};
+
+		for (uint32_t i = 0u; i < 2u; ++i)
+		{
+			const __m128 cornerZ = _mm_set1_ps(i == 0u ? boundingBox.minimum[2] : boundingBox.maximum[2]);
+
+			for (size_t column = 0u; column < 4u; ++column)
+			{
+				clipPositions[column] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(cornerX, _mm_set1_ps(matrix[column])), _mm_mul_ps(cornerY, _mm_set1_ps(matrix[4u + column]))),
+					_mm_mul_ps(cornerZ, _mm_set1_ps(matrix[8u + column]))), _mm_set1_ps(matrix[12u + column]));
+			}
+
+			if (_mm_movemask_ps(_mm_or_ps(_mm_cmpngt_ps(clipPositions[3], _mm_setzero_ps()), _mm_cmplt_ps(clipPositions[2], _mm_setzero_ps()))) != 0)
+			{
+				return std::nullopt;
+			}
+
+			const __m128 half = _mm_set1_ps(0.5f);
+			_mm_storeu_ps(&screenX[i * 4u], _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_div_ps(clipPositions[0], clipPositions[3]), half), half), _mm_set1_ps(width)));
+			_mm_storeu_ps(&screenY[i * 4u], _mm_mul_ps(_mm_sub_ps(half, _mm_mul_ps(_mm_div_ps(clipPositions[1], clipPositions[3]), half)), _mm_set1_ps(height)));
+			_mm_storeu_ps(&screenZ[i * 4u], _mm_div_ps(clipPositions[2], clipPositions[3]));
+		}
+
+		return OcclusionScreenBounds
+		{
+			.minimumX = *std::min_element(screenX.begin(), screenX.end()),
+			.maximumX = *std::max_element(screenX.begin(), screenX.end()),
+			.minimumY = *std::min_element(screenY.begin(), screenY.end()),
+			.maximumY = *std::max_element(screenY.begin(), screenY.end()),
+			.minimumZ = *std::min_element(screenZ.begin(), screenZ.end()),
+		};
+	}
+
+	HELIOS_TARGET_AVX static __m256 EvaluateEdgeAvx(const OcclusionTriangleEdge& edge, __m256 rowCenter)
+	{
+		return _mm256_add_ps(_mm256_set1_ps(edge.x), _mm256_mul_ps(_mm256_sub_ps(rowCenter, _mm256_set1_ps(edge.y)), _mm256_set1_ps(edge.slope)));
+	}
+
+	HELIOS_TARGET_AVX static void ComputeRowSpansAvx(const OcclusionTriangleEdges& edges, float rowBegin, float maximumColumn, std::array<int32_t, TILE_HEIGHT>& columnBegins,
+		std::array<int32_t, TILE_HEIGHT>& columnEnds)
+	{
+		const __m256 minimum = _mm256_set1_ps(-1.0f);
+		const __m256 maximum = _mm256_set1_ps(maximumColumn);
+		const __m256 half = _mm256_set1_ps(0.5f);
+
+		const __m256 rowCenter = _mm256_add_ps(_mm256_set1_ps(rowBegin), _mm256_load_ps(ROW_CENTER_OFFSETS.data()));
+
+		const __m256 left = _mm256_max_ps(EvaluateEdgeAvx(edges.left[0], rowCenter), EvaluateEdgeAvx(edges.left[1], rowCenter));
+		const __m256 right = _mm256_min_ps(EvaluateEdgeAvx(edges.right[0], rowCenter), EvaluateEdgeAvx(edges.right[1], rowCenter));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(columnBegins.data()), _mm256_cvttps_epi32(_mm256_ceil_ps(_mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(left, minimum), maximum), half))));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(columnEnds.data()), _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(right, minimum), maximum), half))));
+	}
+
+	HELIOS_TARGET_AVX static void ComputeTileDepthsAvx(const OcclusionDepthPlane& depthPlane, float rowDepth, uint32_t tileXBegin, uint32_t tileCount, float* depths)
+	{
+		const __m256 slopeX = _mm256_set1_ps(depthPlane.slopeX);
+		const __m256 planeX = _mm256_set1_ps(depthPlane.x);
+		const __m256 maximumZ = _mm256_set1_ps(depthPlane.maximumZ);
+
+		for (uint32_t i = 0u; i < tileCount; i += 8u)
+		{
+			const __m256 tileLeft = _mm256_add_ps(_mm256_set1_ps(static_cast<float>((tileXBegin + i) * TILE_WIDTH)), _mm256_load_ps(TILE_OFFSETS.data()));
+			const __m256 farthestX = depthPlane.slopeX > 0.0f ? _mm256_min_ps(_mm256_add_ps(tileLeft, _mm256_set1_ps(static_cast<float>(TILE_WIDTH))), _mm256_set1_ps(depthPlane.maximumX)) :
+				_mm256_max_ps(tileLeft, _mm256_set1_ps(depthPlane.minimumX));
+
+			_mm256_storeu_ps(&depths[i], _mm256_min_ps(_mm256_add_ps(_mm256_set1_ps(rowDepth), _mm256_mul_ps(_mm256_sub_ps(farthestX, planeX), slopeX)), maximumZ));
+		}
+	}
+
+	// The 8 corners in one batch (same order as the scalar version).
+	HELIOS_TARGET_AVX static std::optional<OcclusionScreenBounds> ProjectBoundingBoxAvx(const BoundingBox& boundingBox, const Matrix4x4& matrix, float width, float height)
+	{
+		const __m256 cornerX = _mm256_setr_ps(boundingBox.minimum[0], boundingBox.maximum[0], boundingBox.minimum[0], boundingBox.maximum[0],
+			boundingBox.minimum[0], boundingBox.maximum[0], boundingBox.minimum[0], boundingBox.maximum[0]);
+		const __m256 cornerY = _mm256_setr_ps(boundingBox.minimum[1], boundingBox.minimum[1], boundingBox.maximum[1], boundingBox.maximum[1],
+			boundingBox.minimum[1], boundingBox.minimum[1], boundingBox.maximum[1], boundingBox.maximum[1]);
+		const __m256 cornerZ = _mm256_setr_ps(boundingBox.minimum[2], boundingBox.minimum[2], boundingBox.minimum[2], boundingBox.minimum[2],
+			boundingBox.maximum[2], boundingBox.maximum[2], boundingBox.maximum[2], boundingBox.maximum[2]);
+
+		__m256 clipPositions[4]{};
+		for (size_t column = 0u; column < 4u; ++column)
+		{
+			clipPositions[column] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cornerX, _mm256_set1_ps(matrix[column])), _mm256_mul_ps(cornerY, _mm256_set1_ps(matrix[4u + column]))),
+				_mm256_mul_ps(cornerZ, _mm256_set1_ps(matrix[8u + column]))), _mm256_set1_ps(matrix[12u + column]));
+		}
+
+		const __m256 zero = _mm256_setzero_ps();
+		if (_mm256_movemask_ps(_mm256_or_ps(_mm256_cmp_ps(clipPositions[3], zero, _CMP_NGT_UQ), _mm256_cmp_ps(clipPositions[2], zero, _CMP_LT_OQ))) != 0)
+		{
+			return std::nullopt;
+		}
+
+		std::array<float, 8u> screenX{};
+		std::array<float, 8u> screenY{};
+		std::array<float, 8u> screenZ{};
+
+		const __m256 half = _mm256_set1_ps(0.5f);
+		_mm256_storeu_ps(screenX.data(), _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(clipPositions[0], clipPositions[3]), half), half), _mm256_set1_ps(width)));
+		_mm256_storeu_ps(screenY.data(), _mm256_mul_ps(_mm256_sub_ps(half, _mm256_mul_ps(_mm256_div_ps(clipPositions[1], clipPositions[3]), half)), _mm256_set1_ps(height)));
+		_mm256_storeu_ps(screenZ.data(), _mm256_div_ps(clipPositions[2], clipPositions[3]));
+
+		return OcclusionScreenBounds
+		{
+			.minimumX = *std::min_element(screenX.begin(), screenX.end()),
+			.maximumX = *std::max_element(screenX.begin(), screenX.end()),
+			.minimumY = *std::min_element(screenY.begin(), screenY.end()),
+			.maximumY = *std::max_element(screenY.begin(), screenY.end()),
+			.minimumZ = *std::min_element(screenZ.begin(), screenZ.end()),
+		};
+	}
+#endif
+
+	static void ComputeRowSpans(const OcclusionTriangleEdges& edges, float rowBegin, float maximumColumn, std::array<int32_t, TILE_HEIGHT>& columnBegins,
+		std::array<int32_t, TILE_HEIGHT>& columnEnds, CullingImplementation cullingImplementation)
+	{
+		switch (cullingImplementation)
+		{
+#if defined(HELIOS_CULLING_X64)
+			case CullingImplementation::Sse:
+			{
+				ComputeRowSpansSse(edges, rowBegin, maximumColumn, columnBegins, columnEnds);
+			}break;
+
+			case CullingImplementation::Avx:
+			{
+				ComputeRowSpansAvx(edges, rowBegin, maximumColumn, columnBegins, columnEnds);
+			}break;
+#endif
+
+			default:
+			{
+				ComputeRowSpansScalar(edges, rowBegin, maximumColumn, columnBegins, columnEnds);
+			}break;
+		}
+	}
+
+	static void ComputeTileDepths(const OcclusionDepthPlane& depthPlane, float rowDepth, uint32_t tileXBegin, uint32_t tileCount, float* depths,
+		CullingImplementation cullingImplementation)
+	{
+		switch (cullingImplementation)
+		{
+#if defined(HELIOS_CULLING_X64)
+			case CullingImplementation::Sse:
+			{
+				ComputeTileDepthsSse(depthPlane, rowDepth, tileXBegin, tileCount, depths);
+			}break;
+
+			case CullingImplementation::Avx:
+			{
+				ComputeTileDepthsAvx(depthPlane, rowDepth, tileXBegin, tileCount, depths);
+			}break;
+#endif
+
+			default:
+			{
+				ComputeTileDepthsScalar(depthPlane, rowDepth, tileXBegin, tileCount, depths);
+			}break;
+		}
+	}
+
+	static std::optional<OcclusionScreenBounds> ProjectBoundingBox(const BoundingBox& boundingBox, const Matrix4x4& matrix, float width, float height,
+		CullingImplementation cullingImplementation)
+	{
+		switch (cullingImplementation)
+		{
+#if defined(HELIOS_CULLING_X64)
+			case CullingImplementation::Sse:
+			{
+				return ProjectBoundingBoxSse(boundingBox, matrix, width, height);
+			}break;
+
+			case CullingImplementation::Avx:
+			{
+				return ProjectBoundingBoxAvx(boundingBox, matrix, width, height);
+			}break;
+#endif
+
+			default:
+			{
+				return ProjectBoundingBoxScalar(boundingBox, matrix, width, height);
+			}break;
+		}
+	}
+
+	// Bits [columnBegin, columnEnd] of the row of tile tileX, where the columns are relative to the screen (and may be outside of the tile).
+	static uint32_t ComputeColumnMask(int32_t columnBegin, int32_t columnEnd, uint32_t tileX)
+	{
+		const int32_t tileLeft = static_cast<int32_t>(tileX * TILE_WIDTH);
+		const int32_t begin = std::clamp(columnBegin - tileLeft, 0, static_cast<int32_t>(TILE_WIDTH));
+		const int32_t end = std::clamp(columnEnd - tileLeft, -1, static_cast<int32_t>(TILE_WIDTH) - 1);
+
+		if (begin > end)
+		{
+			return 0u;
+		}
+
+		return static_cast<uint32_t>((uint64_t{ 2u } << end) - (uint64_t{ 1u } << begin));
+	}
+
+	OccluderMesh CreateBoxOccluderMesh(const BoundingBox& boundingBox)
+	{
+		OccluderMesh occluderMesh{};
+
+		// Corner i has the maximum of the box along x / y / z if its bit 0 / 1 / 2 is set.
+		for (uint32_t i = 0u; i < 8u; ++i)
+		{
+			occluderMesh.positions.push_back(Float3
+			{
+				(i & 1u) ? boundingBox.maximum[0] : boundingBox.minimum[0],
+				(i & 2u) ? boundingBox.maximum[1] : boundingBox.minimum[1],
+				(i & 4u) ? boundingBox.maximum[2] : boundingBox.minimum[2],
+			});
+		}
+
+		// Two triangles per face (the winding does not matter, as the occluders are rendered without back face culling).
+		occluderMesh.indices =
+		{
+			0u, 2u, 3u, 0u, 3u, 1u,
+			4u, 5u, 7u, 4u, 7u, 6u,
+			0u, 4u, 6u, 0u, 6u, 2u,
+			1u, 3u, 7u, 1u, 7u, 5u,
+			0u, 1u, 5u, 0u, 5u, 4u,
+			2u, 6u, 7u, 2u, 7u, 3u,
+		};
+
+		return occluderMesh;
+	}
+
+	void OcclusionBuffer::Resize(uint32_t width, uint32_t height)
+	{
+		mTileCountX = (width + TILE_WIDTH - 1u) / TILE_WIDTH;
+		mTileCountY = (height + TILE_HEIGHT - 1u) / TILE_HEIGHT;
+		mWidth = mTileCountX * TILE_WIDTH;
+		mHeight = mTileCountY * TILE_HEIGHT;
+
+		const uint32_t tileCount = mTileCountX * mTileCountY;
+		mTileZMax0.resize(tileCount);
+		mTileZMax1.resize(tileCount);
+		mTileMasks.resize(tileCount * TILE_HEIGHT);
+		mTileDepths.resize((mTileCountX + MAX_CULLING_BATCH_SIZE - 1u) / MAX_CULLING_BATCH_SIZE * MAX_CULLING_BATCH_SIZE);
+
+		Clear();
+	}
+
+	void OcclusionBuffer::Clear()
+	{
+		std::fill(mTileZMax0.begin(), mTileZMax0.end(), 1.0f);
+		std::fill(mTileZMax1.begin(), mTileZMax1.end(), 0.0f);
+		std::fill(mTileMasks.begin(), mTileMasks.end(), 0u);
+	}
+
+	uint32_t OcclusionBuffer::RenderOccluder(std::span<const Float3> positions, std::span<const uint32_t> indices, const Matrix4x4& modelViewProjectionMatrix,
+		CullingImplementation cullingImplementation)
+	{
+		cullingImplementation = ResolveCullingImplementation(cullingImplementation);
+
+		mClipPositions.resize(positions.size());
+		for (size_t i = 0u; i < positions.size(); ++i)
+		{
+			mClipPositions[i] = TransformPosition(positions[i], modelViewProjectionMatrix);
+		}
+
+		const float width = static_cast<float>(mWidth);
+		const float height = static_cast<float>(mHeight);
+
+		uint32_t triangleCount{};
+
+		for (size_t i = 0u; i + 2u < indices.size(); i += 3u)
+		{
+			// Sutherland Hodgman clipping against the near plane (z >= 0), which turns the triangle into a polygon of up to 4 vertices.
+			std::array<std::array<float, 4>, 4u> polygon{};
+			uint32_t polygonVertexCount{};
+
+			for (size_t vertex = 0u; vertex < 3u; ++vertex)
+			{
+				const std::array<float, 4>& current = mClipPositions[indices[i + vertex]];
+				const std::array<float, 4>& next = mClipPositions[indices[i + (vertex + 1u) % 3u]];
+
+				if (current[2] >= 0.0f)
+				{
+					polygon[polygonVertexCount++] = current;
+				}
+
+				if ((current[2] >= 0.0f) != (next[2] >= 0.0f))
+				{
+					const float t = current[2] / (current[2] - next[2]);
+
+					std::array<float, 4>& intersection = polygon[polygonVertexCount++];
+					for (size_t component = 0u; component < 4u; ++component)
+					{
+						intersection[component] = current[component] + (next[component] - current[component]) * t;
+					}
+
+					intersection[2] = 0.0f;
+				}
+			}
+
+			if (polygonVertexCount < 3u)
+			{
+				continue;
+			}
+
+			std::array<ScreenVertex, 4u> screenVertices{};
+			bool isProjectable{ true };
+
+			for (uint32_t vertex = 0u; vertex < polygonVertexCount; ++vertex)
+			{
+				const std::array<float, 4>& clipPosition = polygon[vertex];
+				isProjectable &= clipPosition[3] > 0.0f;
+
+				screenVertices[vertex] =
+				{
+					.x = (clipPosition[0] / clipPosition[3] * 0.5f + 0.5f) * width,
+					.y = (0.5f - clipPosition[1] / clipPosition[3] * 0.5f) * height,
+					.z = clipPosition[2] / clipPosition[3],
+				};
+			}
+
+			// Only possible with projections that do not place the eye behind the near plane. Skipping an occluder is always conservative.
+			if (!isProjectable)
+			{
+				continue;
+			}
+
+			for (uint32_t vertex = 1u; vertex + 1u < polygonVertexCount; ++vertex)
+			{
+				RenderTriangle({ screenVertices[0], screenVertices[vertex], screenVertices[vertex + 1u] }, cullingImplementation);
+				++triangleCount;
+			}
+		}
+
+		return triangleCount;
+	}
+
+	void OcclusionBuffer::RenderTriangle(const std::array<ScreenVertex, 3>& vertices, CullingImplementation cullingImplementation)
+	{
+		// Twice the signed area : 0 for degenerate triangles (which cover no pixel center), and not finite if the vertices are not.
+		const float doubleArea = (vertices[1].x - vertices[0].x) * (vertices[2].y - vertices[0].y) - (vertices[1].y - vertices[0].y) * (vertices[2].x - vertices[0].x);
+		if (doubleArea == 0.0f || !std::isfinite(doubleArea))
+		{
+			return;
+		}
+
+		const float minimumX = std::min({ vertices[0].x, vertices[1].x, vertices[2].x });
+		const float maximumX = std::max({ vertices[0].x, vertices[1].x, vertices[2].x });
+		const float minimumY = std::min({ vertices[0].y, vertices[1].y, vertices[2].y });
+		const float maximumY = std::max({ vertices[0].y, vertices[1].y, vertices[2].y });
+		const float maximumZ = std::max({ vertices[0].z, vertices[1].z, vertices[2].z });
+
+		// Rows / columns whose center is inside of the triangle's bounds.
+		const float maximumRow = static_cast<float>(mHeight - 1u);
+		const float maximumColumnIndex = static_cast<float>(mWidth - 1u);
+
+		const float rowBeginValue = std::max(std::ceil(minimumY - 0.5f), 0.0f);
+		const float rowEndValue = std::min(std::floor(maximumY - 0.5f), maximumRow);
+		const float columnBeginValue = std::max(std::ceil(minimumX - 0.5f), 0.0f);
+		const float columnEndValue = std::min(std::floor(maximumX - 0.5f), maximumColumnIndex);
+
+		if (rowBeginValue > rowEndValue || columnBeginValue > columnEndValue)
+		{
+			return;
+		}
+
+		const uint32_t rowBegin = static_cast<uint32_t>(rowBeginValue);
+		const uint32_t rowEnd = static_cast<uint32_t>(rowEndValue);
+		const uint32_t columnBegin = static_cast<uint32_t>(columnBeginValue);
+		const uint32_t columnEnd = static_cast<uint32_t>(columnEndValue);
+
+		// An edge from v to w bounds the triangle on the left if the third vertex is on its right (which depends on the winding and on the direction of the
+		// edge). Horizontal edges only bound the rows, which the triangle's bounds already do.
+		OcclusionTriangleEdges edges
+		{
+			.left = { OcclusionTriangleEdge{ .x = -std::numeric_limits<float>::infinity() }, OcclusionTriangleEdge{ .x = -std::numeric_limits<float>::infinity() } },
+			.right = { OcclusionTriangleEdge{ .x = std::numeric_limits<float>::infinity() }, OcclusionTriangleEdge{ .x = std::numeric_limits<float>::infinity() } },
+		};
+
+		uint32_t leftEdgeCount{};
+		uint32_t rightEdgeCount{};
+
+		for (size_t i = 0u; i < 3u; ++i)
+		{
+			const ScreenVertex& v = vertices[i];
+			const ScreenVertex& w = vertices[(i + 1u) % 3u];
+
+			const float deltaY = w.y - v.y;
+			if (deltaY == 0.0f)
+			{
+				continue;
+			}
+
+			// Nearly horizontal edges may have an infinite slope, which would make the spans NaN. Skipping the triangle is conservative.
+			const OcclusionTriangleEdge edge{ .x = v.x, .y = v.y, .slope = (w.x - v.x) / deltaY };
+			if (!std::isfinite(edge.slope))
+			{
+				return;
+			}
+
+			// The edges are split by the sign of deltaY (which sum to 0), so there are at most two on each side.
+			if (doubleArea * deltaY < 0.0f)
+			{
+				edges.left[leftEdgeCount++] = edge;
+			}
+			else
+			{
+				edges.right[rightEdgeCount++] = edge;
+			}
+		}
+
+		// Depth plane (depth is linear in screen space) : z = z0 + (x - x0) * slopeX + (y - y0) * slopeY.
+		const float deltaX1 = vertices[1].x - vertices[0].x;
+		const float deltaY1 = vertices[1].y - vertices[0].y;
+		const float deltaZ1 = vertices[1].z - vertices[0].z;
+		const float deltaX2 = vertices[2].x - vertices[0].x;
+		const float deltaY2 = vertices[2].y - vertices[0].y;
+		const float deltaZ2 = vertices[2].z - vertices[0].z;
+
+		const float slopeX = (deltaZ1 * deltaY2 - deltaY1 * deltaZ2) / doubleArea;
+		const float slopeY = (deltaX1 * deltaZ2 - deltaZ1 * deltaX2) / doubleArea;
+
+		if (!std::isfinite(slopeX) || !std::isfinite(slopeY))
+		{
+			return;
+		}
+
+		const OcclusionDepthPlane depthPlane
+		{
+			.x = vertices[0].x,
+			.slopeX = slopeX,
+			.minimumX = minimumX,
+			.maximumX = maximumX,
+			.maximumZ = maximumZ,
+		};
+
+		const float maximumColumn = static_cast<float>(mWidth + 1u);
+
+		const uint32_t tileXBegin = columnBegin / TILE_WIDTH;
+		const uint32_t tileXEnd = columnEnd / TILE_WIDTH;
+
+		std::array<int32_t, TILE_HEIGHT> columnBegins{};
+		std::array<int32_t, TILE_HEIGHT> columnEnds{};
+
+		for (uint32_t tileY = rowBegin / TILE_HEIGHT; tileY <= rowEnd / TILE_HEIGHT; ++tileY)
+		{
+			const uint32_t tileTop = tileY * TILE_HEIGHT;
+			ComputeRowSpans(edges, static_cast<float>(tileTop), maximumColumn, columnBegins, columnEnds, cullingImplementation);
+
+			// The farthest row of the part of the tile row inside the triangle's bounds.
+			const float farthestY = slopeY > 0.0f ? std::min(static_cast<float>(tileTop + TILE_HEIGHT), maximumY) : std::max(static_cast<float>(tileTop), minimumY);
+			const float rowDepth = vertices[0].z + (farthestY - vertices[0].y) * slopeY;
+
+			ComputeTileDepths(depthPlane, rowDepth, tileXBegin, tileXEnd - tileXBegin + 1u, mTileDepths.data(), cullingImplementation);
+
+			// Rows outside of the triangle's bounds are not covered, whatever their span.
+			for (uint32_t row = 0u; row < TILE_HEIGHT; ++row)
+			{
+				if (tileTop + row < rowBegin || tileTop + row > rowEnd)
+				{
+					columnBegins[row] = 1;
+					columnEnds[row] = 0;
+				}
+			}
+
+			for (uint32_t tileX = tileXBegin; tileX <= tileXEnd; ++tileX)
+			{
+				const uint32_t tileIndex = tileY * mTileCountX + tileX;
+				const float depth = mTileDepths[tileX - tileXBegin];
+
+				// The triangle is behind everything already in the tile.
+				if (depth >= mTileZMax0[tileIndex])
+				{
+					continue;
+				}
+
+				std::array<uint32_t, TILE_HEIGHT> coverage{};
+				uint32_t coveredRowMask{ FULL_ROW_MASK };
+				uint32_t anyCoveredRowMask{};
+
+				for (uint32_t row = 0u; row < TILE_HEIGHT; ++row)
+				{
+					coverage[row] = ComputeColumnMask(columnBegins[row], columnEnds[row], tileX);
+					coveredRowMask &= coverage[row];
+					anyCoveredRowMask |= coverage[row];
+				}
+
+				if (anyCoveredRowMask == 0u)
+				{
+					continue;
+				}
+
+				uint32_t* const masks = &mTileMasks[tileIndex * TILE_HEIGHT];
+
+				uint32_t anyMaskedRowMask{};
+				for (uint32_t row = 0u; row < TILE_HEIGHT; ++row)
+				{
+					anyMaskedRowMask |= masks[row];
+				}
+
+				// The triangle covers the whole tile : it bounds every pixel, and the mask stays only if it is nearer.
+				if (coveredRowMask == FULL_ROW_MASK)
+				{
+					mTileZMax0[tileIndex] = depth;
+					if (anyMaskedRowMask != 0u && mTileZMax1[tileIndex] >= depth)
+					{
+						std::fill_n(masks, TILE_HEIGHT, 0u);
+					}
+
+					continue;
+				}
+
+				// A triangle much nearer than the mask replaces it (the pixels of the mask it does not cover are then only bounded by zMax0), else it is added to
+				// the mask (which moves zMax1 back to the farthest of both).
+				if (anyMaskedRowMask == 0u || mTileZMax1[tileIndex] - depth > mTileZMax0[tileIndex] - mTileZMax1[tileIndex])
+				{
+					mTileZMax1[tileIndex] = depth;
+					std::copy(coverage.begin(), coverage.end(), masks);
+				}
+				else
+				{
+					mTileZMax1[tileIndex] = std::max(mTileZMax1[tileIndex], depth);
+					for (uint32_t row = 0u; row < TILE_HEIGHT; ++row)
+					{
+						masks[row] |= coverage[row];
+					}
+				}
+
+				uint32_t maskedRowMask{ FULL_ROW_MASK };
+				for (uint32_t row = 0u; row < TILE_HEIGHT; ++row)
+				{
+					maskedRowMask &= masks[row];
+				}
+
+				// Every pixel is in the mask, so zMax1 bounds the whole tile.
+				if (maskedRowMask == FULL_ROW_MASK)
+				{
+					mTileZMax0[tileIndex] = mTileZMax1[tileIndex];
+					std::fill_n(masks, TILE_HEIGHT, 0u);
+				}
+			}
+		}
+	}
+
+	bool OcclusionBuffer::IsTileOccluded(uint32_t tileIndex, uint32_t tileRowBegin, uint32_t tileRowEnd, uint32_t columnMask, float depth) const
+	{
+		if (mTileZMax0[tileIndex] < depth)
+		{
+			return true;
+		}
+
+		if (!(mTileZMax1[tileIndex] < depth))
+		{
+			return false;
+		}
+
+		// The pixels outside of the mask are only bounded by zMax0.
+		for (uint32_t row = tileRowBegin; row <= tileRowEnd; ++row)
+		{
+			if ((mTileMasks[tileIndex * TILE_HEIGHT + row] & columnMask) != columnMask)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool OcclusionBuffer::IsBoundingBoxOccluded(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix, CullingImplementation cullingImplementation) const
+	{
+		const float width = static_cast<float>(mWidth);
+		const float height = static_cast<float>(mHeight);
+
+		const std::optional<OcclusionScreenBounds> screenBounds = ProjectBoundingBox(boundingBox, viewProjectionMatrix, width, height, ResolveCullingImplementation(cullingImplementation));
+		if (!screenBounds.has_value())
+		{
+			return false;
+		}
+
+		if (screenBounds->maximumX <= 0.0f || screenBounds->minimumX >= width || screenBounds->maximumY <= 0.0f || screenBounds->minimumY >= height)
+		{
+			return false;
+		}
+
+		// Every pixel the bounds touch (not only the ones whose center they contain), so boxes smaller than a pixel are tested too.
+		const uint32_t columnBegin = static_cast<uint32_t>(std::max(std::floor(screenBounds->minimumX), 0.0f));
+		const uint32_t columnEnd = std::max(static_cast<uint32_t>(std::min(std::ceil(screenBounds->maximumX), width)), columnBegin + 1u) - 1u;
+		const uint32_t rowBegin = static_cast<uint32_t>(std::max(std::floor(screenBounds->minimumY), 0.0f));
+		const uint32_t rowEnd = std::max(static_cast<uint32_t>(std::min(std::ceil(screenBounds->maximumY), height)), rowBegin + 1u) - 1u;
+
+		for (uint32_t tileY = rowBegin / TILE_HEIGHT; tileY <= rowEnd / TILE_HEIGHT; ++tileY)
+		{
+			const uint32_t tileTop = tileY * TILE_HEIGHT;
+			const uint32_t tileRowBegin = std::max(rowBegin, tileTop) - tileTop;
+			const uint32_t tileRowEnd = std::min(rowEnd, tileTop + TILE_HEIGHT - 1u) - tileTop;
+
+			for (uint32_t tileX = columnBegin / TILE_WIDTH; tileX <= columnEnd / TILE_WIDTH; ++tileX)
+			{
+				const uint32_t columnMask = ComputeColumnMask(static_cast<int32_t>(columnBegin), static_cast<int32_t>(columnEnd), tileX);
+				if (!IsTileOccluded(tileY * mTileCountX + tileX, tileRowBegin, tileRowEnd, columnMask, screenBounds->minimumZ))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	uint32_t OcclusionBuffer::CullBoundingBoxes(const BoundingBoxSoA& boundingBoxes, const Matrix4x4& viewProjectionMatrix, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation) const
+	{
+		cullingImplementation = ResolveCullingImplementation(cullingImplementation);
+
+		uint32_t occludedCount{};
+		for (uint32_t i = 0u; i < boundingBoxes.GetCount(); ++i)
+		{
+			if (visibility[i] != 0u && IsBoundingBoxOccluded(boundingBoxes.Get(i), viewProjectionMatrix, cullingImplementation))
+			{
+				visibility[i] = 0u;
+				++occludedCount;
+			}
+		}
+
+		return occludedCount;
+	}
+
+	float OcclusionBuffer::GetPixelDepthBound(uint32_t x, uint32_t y) const
+	{
+		const uint32_t tileIndex = (y / TILE_HEIGHT) * mTileCountX + x / TILE_WIDTH;
+		const bool isMasked = ((mTileMasks[tileIndex * TILE_HEIGHT + y % TILE_HEIGHT] >> (x % TILE_WIDTH)) & 1u) != 0u;
+
+		return isMasked ? mTileZMax1[tileIndex] : mTileZMax0[tileIndex];
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "FrustumCulling.hpp"
+
+namespace helios::scene
+{
+	// Geometry rasterized into the occlusion buffer : a simplified version of a mesh, or its bounds (see CreateBoxOccluderMesh). It must be entirely inside
+	// of the mesh it stands for, else meshes visible through it may be culled.
+	struct OccluderMesh
+	{
+		std::vector<Float3> positions{};
+		std::vector<uint32_t> indices{};
+	};
+
+	// The 12 triangles of the box, i.e for a solid wall / pillar whose bounds are the occluder.
+	OccluderMesh CreateBoxOccluderMesh(const BoundingBox& boundingBox);
+
+	// Low resolution depth buffer the occluders are rasterized into on the CPU, to cull the meshes they hide before recording their draws (masked software
+	// occlusion culling, as in "Masked Software Occlusion Culling" by Hasselgren et al.).
+	// Rather than a depth per pixel, each tile of TILE_WIDTH x TILE_HEIGHT pixels stores two depths and a coverage mask (one bit per pixel) : every pixel of
+	// the tile is nearer than zMax0, and the pixels in the mask are nearer than zMax1 (<= zMax0). Triangles are merged into the tile with the farthest
+	// depth they have in it : into the mask if it is close to zMax1, else they replace it, and once the mask is full zMax0 is moved to zMax1.
+	// Hence, the tiles form the coarse level of a hierarchical depth buffer (which occludees are tested against first) and the masks its pixel level.
+	// Standard depth (0 at the near plane) and D3D clip space, with the same viewport mapping as the GPU : a pixel is covered if its center is.
+	// Not thread safe : occludees may be tested concurrently, but not while occluders are rendered.
+	class OcclusionBuffer
+	{
+	public:
+		static constexpr uint32_t TILE_WIDTH = 32u;
+		static constexpr uint32_t TILE_HEIGHT = 8u;
+
+		// The size is rounded up to a multiple of the tile size. Clears the buffer.
+		void Resize(uint32_t width, uint32_t height);
+
+		// Every pixel is at the far plane.
+		void Clear();
+
+		// Rasterizes the triangles (clipped against the near plane, and without back face culling, so the winding does not matter).
+		// Returns the number of triangles rasterized (after clipping), for statistics.
+		uint32_t RenderOccluder(std::span<const Float3> positions, std::span<const uint32_t> indices, const Matrix4x4& modelViewProjectionMatrix,
+			CullingImplementation cullingImplementation = CullingImplementation::Best);
+
+		// A box is occluded if its nearest depth is behind the buffer over all the pixels its screen space bounds touch. Boxes crossing the near plane, or
+		// outside of the screen, are never occluded (the latter being left to the frustum culling).
+		bool IsBoundingBoxOccluded(const BoundingBox& boundingBox, const Matrix4x4& viewProjectionMatrix, CullingImplementation cullingImplementation = CullingImplementation::Best) const;
+
+		// Sets visibility[i] to 0 for the occluded boxes among the visible ones (the boxes set to 0 are not tested), and returns the number of boxes it culled.
+		// visibility must hold at least boundingBoxes.GetCount() elements.
+		uint32_t CullBoundingBoxes(const BoundingBoxSoA& boundingBoxes, const Matrix4x4& viewProjectionMatrix, std::span<uint8_t> visibility,
+			CullingImplementation cullingImplementation = CullingImplementation::Best) const;
+
+		// The depth the pixel is known to be nearer than (1 if nothing was rendered over it).
+		float GetPixelDepthBound(uint32_t x, uint32_t y) const;
+
+		uint32_t GetWidth() const { return mWidth; }
+		uint32_t GetHeight() const { return mHeight; }
+
+	private:
+		struct ScreenVertex
+		{
+			float x{};
+			float y{};
+			float z{};
+		};
+
+		void RenderTriangle(const std::array<ScreenVertex, 3>& vertices, CullingImplementation cullingImplementation);
+
+		bool IsTileOccluded(uint32_t tileIndex, uint32_t tileRowBegin, uint32_t tileRowEnd, uint32_t columnMask, float depth) const;
+
+	private:
+		uint32_t mWidth{};
+		uint32_t mHeight{};
+		uint32_t mTileCountX{};
+		uint32_t mTileCountY{};
+
+		// Indexed by tileY * mTileCountX + tileX. The masks have TILE_HEIGHT rows per tile, with bit i of a row for the pixel in column i of the tile.
+		std::vector<float> mTileZMax0{};
+		std::vector<float> mTileZMax1{};
+		std::vector<uint32_t> mTileMasks{};
+
+		// Clip space positions of the occluder being rendered, and the depths of the triangle being rendered in the tiles of a tile row (padded to a multiple
+		// of MAX_CULLING_BATCH_SIZE, as they are computed in batches).
+		std::vector<std::array<float, 4>> mClipPositions{};
+		std::vector<float> mTileDepths{};
+	};
+}
@@ -23,6 +23,10 @@ namespace helios::scene
 		mSceneBuffer = std::make_unique<gfx::Buffer>(device->CreateBuffer<SceneBuffer>(sceneBufferCreationDesc, std::span<SceneBuffer, 0u>{}));
 		
 		mCamera = std::make_unique<Camera>();
+
+		mRecordingThreadCount = core::JobSystem::Get().GetWorkerCount() + 1u;
+
+		mIndirectDrawBuffer = std::make_unique<gfx::IndirectDrawBuffer>(device, static_cast<uint32_t>(sizeof(PBRRenderResources)), L"Scene Indirect Draw");
 	}
 	
 	Scene::~Scene()
@@ -30,10 +34,33 @@ namespace helios::scene
 		Light::DestroyLightResources();
 	}
 
+	static std::vector<VisibilityMesh> GetVisibilityMeshes(const Model& model)
+	{
+		std::vector<VisibilityMesh> visibilityMeshes{};
+		for (const Mesh& mesh : model.GetMeshes())
+		{
+			visibilityMeshes.push_back(VisibilityMesh
+			{
+				.boundingBox = mesh.boundingBox,
+				.materialIndex = mesh.materialIndex,
+				.occluderMesh = mesh.occluderMesh,
+			});
+		}
+
+		return visibilityMeshes;
+	}
+
 	void Scene::AddModel(const gfx::Device* device, const ModelCreationDesc& modelCreationDesc)
 	{
+		// The model is loaded without holding the scene lock, as the update thread would be stalled for the whole load.
 		auto model = std::make_unique<Model>(device, modelCreationDesc);
-		mModels.push_back(std::move(model));
+
+		mVisibility.AddModel(GetVisibilityMeshes(*model), model->GetMaterialCount());
+
+		{
+			std::lock_guard<std::mutex> sceneLockGuard(mSceneMutex);
+			mModels.push_back(std::move(model));
+		}
 
 		core::LogMessage(L"Added model to scene : " + modelCreationDesc.modelName, core::LogMessageTypes::Info);
 	}
@@ -41,6 +68,10 @@ namespace helios::scene
 	void Scene::AddModel(std::unique_ptr<Model> model)
 	{
 		core::LogMessage(L"Added model to scene : " + model->mModelName, core::LogMessageTypes::Info);
+
+		mVisibility.AddModel(GetVisibilityMeshes(*model), model->GetMaterialCount());
+
+		std::lock_guard<std::mutex> sceneLockGuard(mSceneMutex);
 		mModels.push_back(std::move(model));
 	}
 
@@ -69,50 +100,226 @@ namespace helios::scene
 
 	void Scene::Update(float cameraAspectRatio)
 	{
+		std::lock_guard<std::mutex> sceneLockGuard(mSceneMutex);
+
 		mCamera->Update(static_cast<float>(core::Application::GetTimer().GetDeltaTime()));
 
-		SceneBuffer sceneBufferData =
+		SceneSnapshot& sceneSnapshot = mSnapshots.GetWriteSnapshot();
+
+		sceneSnapshot.sceneBufferData =
 		{
 			.cameraPosition = mCamera->GetCameraPosition(),
 			.cameraTarget = mCamera->GetCameraTarget(),
 			.viewProjectionMatrix = mCamera->GetViewMatrix() * math::XMMatrixPerspectiveFovLH(math::XMConvertToRadians(mFov), cameraAspectRatio, mNearPlane, mFarPlane),
 		};
 
-		mSceneBuffer->Update(&sceneBufferData);
+		// Each transform is computed independently, so they can be computed in parallel.
+		sceneSnapshot.modelTransforms.resize(mModels.size());
+		core::JobSystem::Get().ParallelFor(static_cast<uint32_t>(mModels.size()), 4u, [&](uint32_t modelIndexBegin, uint32_t modelIndexEnd)
+		{
+			for (uint32_t modelIndex = modelIndexBegin; modelIndex < modelIndexEnd; ++modelIndex)
+			{
+				sceneSnapshot.modelTransforms[modelIndex] = mModels[modelIndex]->GetTransform()->GetTransformBufferData();
+			}
+		});
+
+		sceneSnapshot.lightBufferData = *Light::GetLightBufferData();
 
-		for (auto& model : mModels)
+		mSnapshots.Publish();
+	}
+
+	bool Scene::AcquireSnapshot()
+	{
+		if (!mSnapshots.WaitForNewSnapshot())
 		{
-			model->GetTransform()->Update();
+			return false;
+		}
+
+		const SceneSnapshot* sceneSnapshot = mSnapshots.Acquire();
+
+		mRecordingCpuTime = mCurrentFrameRecordingCpuTime;
+		mCurrentFrameRecordingCpuTime = 0.0;
+
+		mSceneBuffer->Update(&sceneSnapshot->sceneBufferData);
+
+		// Models added (by the editor) after the snapshot was produced keep their transform until the next snapshot.
+		// The model list is modified under the scene lock (see AddModel), so it is read under it as well.
+		{
+			std::lock_guard<std::mutex> sceneLockGuard(mSceneMutex);
+
+			const uint32_t transformCount = static_cast<uint32_t>(std::min(sceneSnapshot->modelTransforms.size(), mModels.size()));
+
+			// Each transform update writes to its own constant buffer, so they can be done in parallel.
+			core::JobSystem::Get().ParallelFor(transformCount, 4u, [&](uint32_t modelIndexBegin, uint32_t modelIndexEnd)
+			{
+				for (uint32_t modelIndex = modelIndexBegin; modelIndex < modelIndexEnd; ++modelIndex)
+				{
+					mModels[modelIndex]->GetTransform()->Update(sceneSnapshot->modelTransforms[modelIndex]);
+				}
+			});
 		}
 
 		for (auto& light : mLights)
 		{
-			light->Update();
+			light->Update(sceneSnapshot->lightBufferData);
+		}
+
+		scene::Light::UpdateLightBuffer(sceneSnapshot->lightBufferData);
+
+		CullModels(*sceneSnapshot);
+
+		return true;
+	}
+
+	static Matrix4x4 ToMatrix4x4(const math::XMMATRIX& matrix)
+	{
+		math::XMFLOAT4X4 storedMatrix{};
+		math::XMStoreFloat4x4(&storedMatrix, matrix);
+
+		return std::bit_cast<Matrix4x4>(storedMatrix);
+	}
+
+	void Scene::CullModels(const SceneSnapshot& sceneSnapshot)
+	{
+		std::vector<Matrix4x4> modelMatrices(mModels.size());
+		for (uint32_t modelIndex = 0u; modelIndex < mModels.size(); ++modelIndex)
+		{
+			// Models added (by the editor) after the snapshot was produced are not in it yet.
+			modelMatrices[modelIndex] = ToMatrix4x4(modelIndex < sceneSnapshot.modelTransforms.size() ?
+				sceneSnapshot.modelTransforms[modelIndex].modelMatrix : mModels[modelIndex]->GetTransform()->GetTransformBufferData().modelMatrix);
+		}
+
+		mVisibility.CullMeshes(modelMatrices, ToMatrix4x4(sceneSnapshot.sceneBufferData.viewProjectionMatrix));
+	}
+
+	std::optional<uint32_t> Scene::PickModel(float viewportX, float viewportY) const
+	{
+		// Unprojects the point on the near and far planes : the ray goes from one to the other, so maxDistance = 1 ends it on the far plane.
+		const math::XMFLOAT4X4 viewProjectionMatrix = std::bit_cast<math::XMFLOAT4X4>(mVisibility.GetCameraViewProjectionMatrix());
+		const math::XMMATRIX inverseViewProjectionMatrix = math::XMMatrixInverse(nullptr, math::XMLoadFloat4x4(&viewProjectionMatrix));
+
+		const float clipX = viewportX * 2.0f - 1.0f;
+		const float clipY = 1.0f - viewportY * 2.0f;
+
+		math::XMFLOAT3 nearPoint{};
+		math::XMFLOAT3 farPoint{};
+		math::XMStoreFloat3(&nearPoint, math::XMVector3TransformCoord(math::XMVectorSet(clipX, clipY, 0.0f, 1.0f), inverseViewProjectionMatrix));
+		math::XMStoreFloat3(&farPoint, math::XMVector3TransformCoord(math::XMVectorSet(clipX, clipY, 1.0f, 1.0f), inverseViewProjectionMatrix));
+
+		const Ray ray
+		{
+			.origin = { nearPoint.x, nearPoint.y, nearPoint.z },
+			.direction = { farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z },
+			.maxDistance = 1.0f,
+		};
+
+		const std::optional<RayHit> rayHit = mVisibility.GetMeshBvh().QueryClosestRayHit(ray);
+		if (!rayHit.has_value())
+		{
+			return std::nullopt;
 		}
 
-		scene::Light::UpdateLightBuffer();
+		return mVisibility.GetMeshDrawLocation(rayHit->objectIndex).modelIndex;
 	}
 
-	void Scene::RenderModels(const gfx::GraphicsContext* graphicsContext)
+	void Scene::CullShadowCasters(const math::XMMATRIX& lightViewProjectionMatrix, const math::XMVECTOR& lightDirection)
 	{
+		math::XMFLOAT3 lightDirectionData{};
+		math::XMStoreFloat3(&lightDirectionData, lightDirection);
+
+		mVisibility.CullShadowCasters(ToMatrix4x4(lightViewProjectionMatrix), Float3{ lightDirectionData.x, lightDirectionData.y, lightDirectionData.z });
+	}
+
+	void Scene::RenderModels(std::span<std::unique_ptr<gfx::GraphicsContext>> graphicsContexts, const std::function<void(gfx::GraphicsContext*)>& setupGraphicsContext)
+	{
+		const std::chrono::high_resolution_clock::time_point sortingStartTime = std::chrono::high_resolution_clock::now();
+
 		SceneRenderResources sceneRenderResources
 		{
 			.sceneBufferIndex = gfx::Buffer::GetCbvIndex(mSceneBuffer.get()),
 			.lightBufferIndex = scene::Light::GetCbvIndex()
 		};
 
-		for (auto& model : mModels)
+		mVisibility.BuildCameraDrawPackets();
+
+		mCurrentFrameRecordingCpuTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - sortingStartTime).count();
+
+		RecordInParallel(graphicsContexts, setupGraphicsContext, [&](gfx::GraphicsContext* graphicsContext, const Model* model, uint32_t meshIndex)
 		{
-			model->Render(graphicsContext, sceneRenderResources);
-		}
+			model->RenderMesh(graphicsContext, sceneRenderResources, meshIndex);
+		});
 	}
 
-	void Scene::RenderModels(const gfx::GraphicsContext* graphicsContext, ShadowMappingRenderResources& shadowMappingRenderResources)
+	void Scene::RenderModels(std::span<std::unique_ptr<gfx::GraphicsContext>> graphicsContexts, const std::function<void(gfx::GraphicsContext*)>& setupGraphicsContext, ShadowMappingRenderResources& shadowMappingRenderResources)
 	{
-		for (auto& model : mModels)
+		const std::chrono::high_resolution_clock::time_point sortingStartTime = std::chrono::high_resolution_clock::now();
+
+		mVisibility.BuildShadowDrawPackets();
+
+		mCurrentFrameRecordingCpuTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - sortingStartTime).count();
+
+		RecordInParallel(graphicsContexts, setupGraphicsContext, [&](gfx::GraphicsContext* graphicsContext, const Model* model, uint32_t meshIndex)
 		{
-			model->Render(graphicsContext, shadowMappingRenderResources);
-		}
+			model->RenderMesh(graphicsContext, shadowMappingRenderResources, meshIndex);
+		});
+	}
+
+	void Scene::BuildIndirectDraws(gfx::Device* device, const gfx::GraphicsContext* graphicsContext)
+	{
+		const std::chrono::high_resolution_clock::time_point recordingStartTime = std::chrono::high_resolution_clock::now();
+
+		SceneRenderResources sceneRenderResources
+		{
+			.sceneBufferIndex = gfx::Buffer::GetCbvIndex(mSceneBuffer.get()),
+			.lightBufferIndex = scene::Light::GetCbvIndex()
+		};
+
+		mVisibility.BuildIndirectDraws(mIndirectDrawStream, mIndirectDrawBounds, [&](gfx::IndirectDrawStream& indirectDrawStream, const MeshDrawLocation& meshDrawLocation)
+		{
+			mModels[meshDrawLocation.modelIndex]->AddIndirectDraw(graphicsContext, indirectDrawStream, sceneRenderResources, meshDrawLocation.meshIndex);
+		});
+
+		mIndirectDrawBuffer->Upload(device, mIndirectDrawStream);
+
+		mCurrentFrameRecordingCpuTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - recordingStartTime).count();
+	}
+
+	void Scene::RenderModelsIndirect(const gfx::GraphicsContext* graphicsContext)
+	{
+		mIndirectDrawBuffer->ExecuteIndirect(graphicsContext);
+	}
+
+	void Scene::RenderModelsIndirect(const gfx::GraphicsContext* graphicsContext, ID3D12Resource* const argumentBuffer, uint64_t argumentBufferOffset,
+		ID3D12Resource* const countBuffer, uint64_t countBufferOffset)
+	{
+		mIndirectDrawBuffer->ExecuteIndirect(graphicsContext, argumentBuffer, argumentBufferOffset, countBuffer, countBufferOffset);
+	}
+
+	uint32_t Scene::GetMeshDrawCount() const
+	{
+		return mVisibility.GetMeshDrawCount();
+	}
+
+	uint32_t Scene::GetRecordingChunkCount() const
+	{
+		return mVisibility.GetRecordingChunkCount(mRecordingThreadCount);
+	}
+
+	void Scene::RecordInParallel(std::span<std::unique_ptr<gfx::GraphicsContext>> graphicsContexts, const std::function<void(gfx::GraphicsContext*)>& setupGraphicsContext, const RenderMeshFunction& renderFunction)
+	{
+		const std::chrono::high_resolution_clock::time_point recordingStartTime = std::chrono::high_resolution_clock::now();
+
+		// Each chunk is recorded into its own context (and hence command allocator), so no synchronization is required between the chunks.
+		mVisibility.RecordInParallel(static_cast<uint32_t>(graphicsContexts.size()), [&](uint32_t chunkIndex)
+		{
+			setupGraphicsContext(graphicsContexts[chunkIndex].get());
+		},
+		[&](uint32_t chunkIndex, const MeshDrawLocation& meshDrawLocation)
+		{
+			renderFunction(graphicsContexts[chunkIndex].get(), mModels[meshDrawLocation.modelIndex].get(), meshDrawLocation.meshIndex);
+		});
+
+		mCurrentFrameRecordingCpuTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - recordingStartTime).count();
 	}
 
 	void Scene::RenderLights(const gfx::GraphicsContext* graphicsContext)
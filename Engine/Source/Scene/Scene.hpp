@@ -4,11 +4,30 @@
 #include "Scene/Model.hpp"
 #include "Scene/Light.hpp"
 #include "Scene/SkyBox.hpp"
+#include "Scene/HiZCulling.hpp"
+#include "Scene/SceneVisibility.hpp"
+
+#include "Core/SnapshotBuffer.hpp"
+
+#include "Graphics/API/IndirectDrawBuffer.hpp"
+#include "Graphics/API/DrawSorting.hpp"
 
 #include "Common/BindlessRS.hlsli"
 
 namespace helios::scene
 {
+	// Copy of the scene state required for rendering a frame, produced by the update thread every tick (see Scene::Update) and consumed by the render thread.
+	// Once published, it is never modified, so the render thread can read it without synchronizing with the update thread.
+	struct SceneSnapshot
+	{
+		SceneBuffer sceneBufferData{};
+
+		// Indexed like Scene::mModels, at the time the snapshot was produced.
+		std::vector<TransformBuffer> modelTransforms{};
+
+		LightBuffer lightBufferData{};
+	};
+
 	// The reason for this abstraction is to seperate the code for managing scene objects (camera / model / light) from the SandBox, which is mostly related to 
 	// rendering techniques and other stuff.
 	// However, the scene will not hold a reference to the gfx::Device as this class is mostly handled from engien.
@@ -19,6 +38,8 @@ namespace helios::scene
 		Scene(const gfx::Device* device);
 		~Scene();
 
+		// Models are loaded without holding mSceneMutex, and added to the model list under it. Hence, the caller must not hold the lock.
+		// Models are added to the visibility as well, so they must be added from the render thread (or before it starts).
 		void AddModel(const gfx::Device* device, const ModelCreationDesc& modelCreationDesc);
 		void AddModel(std::unique_ptr<Model> model);
 
@@ -31,17 +52,78 @@ namespace helios::scene
 		void AddCamera();
 
 		// Aspect ratio is determined by engine.
+		// Called from the update (main) thread : updates the camera and publishes a snapshot of the camera, model transforms and lights. Does not write to any GPU resource.
 		void Update(float cameraAspectRatio);
 
-		void RenderModels(const gfx::GraphicsContext* graphicsContext);
-		void RenderModels(const gfx::GraphicsContext* graphicsContext, ShadowMappingRenderResources& shadowMappingRenderResources);
+		// Called from the render thread before recording a frame : waits for a snapshot newer than the last one, and writes it into the scene / transform / light buffers.
+		// The meshes are then culled against the camera frustum of the snapshot (see SceneVisibility::CullMeshes).
+		// Returns false (without waiting) once the snapshots are closed.
+		bool AcquireSnapshot();
+
+		// Wakes up the render thread if it is waiting in AcquireSnapshot, and makes further calls return false. Used when shutting down.
+		void CloseSnapshots() { mSnapshots.Close(); }
+
+		// The mesh draws of all models are sorted (see SceneVisibility::BuildCameraDrawPackets) and split into chunks, which are recorded in parallel (each into its own context).
+		// Command lists must be created (and submitted) from the render thread, so the contexts are created by the caller : graphicsContexts.size() should be GetRecordingChunkCount().
+		// setupGraphicsContext is called for every context (from the recording thread) before the draws are recorded, to bind the pass's render targets / viewport etc.
+		// The meshes culled by the visibility are skipped, and the shadow mapping overload skips the meshes culled by CullShadowCasters (and sorts the
+		// draws front to back from the light).
+		void RenderModels(std::span<std::unique_ptr<gfx::GraphicsContext>> graphicsContexts, const std::function<void(gfx::GraphicsContext*)>& setupGraphicsContext);
+		void RenderModels(std::span<std::unique_ptr<gfx::GraphicsContext>> graphicsContexts, const std::function<void(gfx::GraphicsContext*)>& setupGraphicsContext, ShadowMappingRenderResources& shadowMappingRenderResources);
 		void RenderLights(const gfx::GraphicsContext* graphicsContext);
+
+		// Builds a draw (see Model::AddIndirectDraw) per mesh kept by the culling, in the same order as RenderModels, and uploads them into the indirect draw buffer. To be called once per frame,
+		// before RenderModelsIndirect. The residency of the meshes is tracked by graphicsContext, which must be executed along with the indirect draws.
+		void BuildIndirectDraws(gfx::Device* device, const gfx::GraphicsContext* graphicsContext);
+
+		// Records all the draws built by BuildIndirectDraws with a single ExecuteIndirect. The pipeline state (whose shaders read their PBRRenderResources
+		// through IndirectDrawRenderResources), render targets etc must be set.
+		void RenderModelsIndirect(const gfx::GraphicsContext* graphicsContext);
+
+		// Same as above, for the subset of the draws whose arguments (and count) were written by the GPU (see HiZCullingPass).
+		void RenderModelsIndirect(const gfx::GraphicsContext* graphicsContext, ID3D12Resource* const argumentBuffer, uint64_t argumentBufferOffset,
+			ID3D12Resource* const countBuffer, uint64_t countBufferOffset);
+
+		// The draws built by the last BuildIndirectDraws, and the bounds of their meshes (same indices), whose visibility index is the mesh's draw index.
+		const gfx::IndirectDrawBuffer* GetIndirectDrawBuffer() const { return mIndirectDrawBuffer.get(); }
+		std::span<const HiZDrawBounds> GetIndirectDrawBounds() const { return mIndirectDrawBounds; }
+
+		// See SceneVisibility::CullShadowCasters. To be called from the render thread once per frame, before rendering the shadow map.
+		// lightDirection is the direction the light travels in.
+		void CullShadowCasters(const math::XMMATRIX& lightViewProjectionMatrix, const math::XMVECTOR& lightDirection);
+
+		// Index of the model with the closest mesh (bounding box) under a point of the viewport (in [0, 1], from the top left corner), as seen from the
+		// camera of the last culled snapshot. Queries the mesh hierarchy, so only models that were culled at least once can be picked.
+		std::optional<uint32_t> PickModel(float viewportX, float viewportY) const;
+
 		void RenderSkyBox(const gfx::GraphicsContext* graphicsContext);
 
 		// Get buffer indices.
 		uint32_t GetSceneBufferIndex() { return gfx::Buffer::GetCbvIndex(mSceneBuffer.get()); }
 
+		uint32_t GetMeshDrawCount() const;
+
+		// See SceneVisibility::GetRecordingChunkCount.
+		uint32_t GetRecordingChunkCount() const;
+
+	private:
+		// Splits the packets built by the visibility evenly across the contexts, and for each context calls setupGraphicsContext once followed by
+		// renderFunction(graphicsContext, model, meshIndex) for every packet within the context's chunk, in order. The chunks are recorded in parallel.
+		using RenderMeshFunction = std::function<void(gfx::GraphicsContext* graphicsContext, const Model* model, uint32_t meshIndex)>;
+		void RecordInParallel(std::span<std::unique_ptr<gfx::GraphicsContext>> graphicsContexts, const std::function<void(gfx::GraphicsContext*)>& setupGraphicsContext, const RenderMeshFunction& renderFunction);
+
+		// Culls the meshes with the model matrices and camera of the snapshot (see SceneVisibility::CullMeshes). Models added (by the editor) after the
+		// snapshot was produced are not in it yet, so their current transform is used.
+		void CullModels(const SceneSnapshot& sceneSnapshot);
+
 	public:
+		core::SnapshotBuffer<SceneSnapshot> mSnapshots{};
+
+	public:
+		// Guards the scene state that is written by the editor (which runs on the render thread) and read by the update thread to produce snapshots :
+		// the model list and transform components, the light buffer data, the camera and the projection parameters.
+		std::mutex mSceneMutex{};
+
 		std::vector<std::unique_ptr<Model>> mModels{};
 		std::vector<std::unique_ptr<Light>> mLights{};
 		std::unique_ptr<Camera> mCamera{};
@@ -53,5 +135,22 @@ namespace helios::scene
 		float mFov{ 45.0f };
 		float mNearPlane{ 0.1f };
 		float mFarPlane{ 1000.0f };
+
+		// Maximum number of threads (including the render thread) used for recording the model draws. Set to 1 for serial recording.
+		uint32_t mRecordingThreadCount{};
+
+		// CPU time (in milliseconds) spent recording the model draws (for all passes) in the previous frame. Only accessed from the render thread.
+		double mRecordingCpuTime{};
+		double mCurrentFrameRecordingCpuTime{};
+
+		// Culling and sorting of the mesh draws (whose draw index is the index of the mesh among the meshes of all models, in order). Only accessed from the
+		// render thread.
+		SceneVisibility mVisibility{};
+
+	private:
+		// The draws of the visible meshes (with their PBRRenderResources as draw data), rebuilt every frame by BuildIndirectDraws.
+		gfx::IndirectDrawStream mIndirectDrawStream{ sizeof(PBRRenderResources) };
+		std::unique_ptr<gfx::IndirectDrawBuffer> mIndirectDrawBuffer{};
+		std::vector<HiZDrawBounds> mIndirectDrawBounds{};
 	};
 }
\ No newline at end of file
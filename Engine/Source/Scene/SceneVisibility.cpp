@@ -0,0 +1,291 @@
+#include "SceneVisibility.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "Core/JobSystem.hpp"
+
+namespace helios::scene
+{
+	SceneVisibility::SceneVisibility()
+	{
+		mOcclusionBuffer.Resize(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT);
+	}
+
+	void SceneVisibility::AddModel(std::span<const VisibilityMesh> meshes, uint32_t materialCount)
+	{
+		const uint32_t modelIndex = GetModelCount();
+
+		mModels.push_back(VisibilityModel
+		{
+			.firstDrawIndex = GetMeshDrawCount(),
+			.meshCount = static_cast<uint32_t>(meshes.size()),
+			.firstMaterialIndex = mMaterialCount,
+		});
+
+		for (uint32_t meshIndex = 0u; meshIndex < static_cast<uint32_t>(meshes.size()); ++meshIndex)
+		{
+			mMeshes.push_back(meshes[meshIndex]);
+			mMeshDrawLocations.push_back(MeshDrawLocation{ .modelIndex = modelIndex, .meshIndex = meshIndex });
+		}
+
+		mMaterialCount += materialCount;
+	}
+
+	void SceneVisibility::CullMeshes(std::span<const Matrix4x4> modelMatrices, const Matrix4x4& cameraViewProjectionMatrix)
+	{
+		const std::chrono::high_resolution_clock::time_point cullingStartTime = std::chrono::high_resolution_clock::now();
+
+		const uint32_t drawCount = GetMeshDrawCount();
+		mMeshVisibility.resize(drawCount);
+
+		// Note : The bounding boxes are computed even if frustum culling is disabled, as the shadow caster culling uses them.
+		mMeshBoundingBoxes.Resize(drawCount);
+
+		// Each model writes the boxes of its own draws, so they can be transformed in parallel.
+		core::JobSystem::Get().ParallelFor(GetModelCount(), 4u, [&](uint32_t modelIndexBegin, uint32_t modelIndexEnd)
+		{
+			for (uint32_t modelIndex = modelIndexBegin; modelIndex < modelIndexEnd; ++modelIndex)
+			{
+				const VisibilityModel& model = mModels[modelIndex];
+				for (uint32_t drawIndex = model.firstDrawIndex; drawIndex < model.firstDrawIndex + model.meshCount; ++drawIndex)
+				{
+					mMeshBoundingBoxes.Set(drawIndex, TransformBoundingBox(mMeshes[drawIndex].boundingBox, modelMatrices[modelIndex]));
+				}
+			}
+		});
+
+		UpdateMeshBvh(modelMatrices);
+
+		mCameraViewProjectionMatrix = cameraViewProjectionMatrix;
+
+		if (mFrustumCullingEnabled)
+		{
+			mVisibleMeshDrawCount = CullBoundingBoxes(ExtractFrustum(mCameraViewProjectionMatrix), mMeshBoundingBoxes, mMeshVisibility);
+		}
+		else
+		{
+			std::fill(mMeshVisibility.begin(), mMeshVisibility.end(), static_cast<uint8_t>(1u));
+			mVisibleMeshDrawCount = drawCount;
+		}
+
+		if (mOcclusionCullingEnabled)
+		{
+			CullOccludedMeshes(modelMatrices);
+		}
+		else
+		{
+			mOccludedMeshDrawCount = 0u;
+			mOccluderTriangleCount = 0u;
+		}
+
+		mCullingCpuTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cullingStartTime).count();
+	}
+
+	void SceneVisibility::CullOccludedMeshes(std::span<const Matrix4x4> modelMatrices)
+	{
+		mOcclusionBuffer.Clear();
+		mOccluderTriangleCount = 0u;
+
+		// Occluders outside of the camera frustum cannot hide anything.
+		for (uint32_t drawIndex = 0u; drawIndex < GetMeshDrawCount(); ++drawIndex)
+		{
+			const VisibilityMesh& mesh = mMeshes[drawIndex];
+			if (mesh.occluderMesh && mMeshVisibility[drawIndex] != 0u)
+			{
+				const Matrix4x4 modelViewProjectionMatrix = MultiplyMatrices(modelMatrices[mMeshDrawLocations[drawIndex].modelIndex], mCameraViewProjectionMatrix);
+				mOccluderTriangleCount += mOcclusionBuffer.RenderOccluder(mesh.occluderMesh->positions, mesh.occluderMesh->indices, modelViewProjectionMatrix);
+			}
+		}
+
+		mOccludedMeshDrawCount = mOcclusionBuffer.CullBoundingBoxes(mMeshBoundingBoxes, mCameraViewProjectionMatrix, mMeshVisibility);
+		mVisibleMeshDrawCount -= mOccludedMeshDrawCount;
+	}
+
+	void SceneVisibility::UpdateMeshBvh(std::span<const Matrix4x4> modelMatrices)
+	{
+		const uint32_t drawCount = mMeshBoundingBoxes.GetCount();
+
+		bool isRebuildRequired = mMeshBvh.GetObjectCount() != drawCount || mMeshBvhModelMatrices.size() != modelMatrices.size();
+		if (!isRebuildRequired)
+		{
+			for (uint32_t modelIndex = 0u; modelIndex < GetModelCount(); ++modelIndex)
+			{
+				const VisibilityModel& model = mModels[modelIndex];
+				if (modelMatrices[modelIndex] != mMeshBvhModelMatrices[modelIndex])
+				{
+					for (uint32_t drawIndex = model.firstDrawIndex; drawIndex < model.firstDrawIndex + model.meshCount; ++drawIndex)
+					{
+						mMeshBvh.UpdateObject(drawIndex, mMeshBoundingBoxes.Get(drawIndex));
+					}
+				}
+			}
+
+			// Refitting keeps the topology, so the hierarchy is rebuilt once the moved meshes made it much worse than a new one would be.
+			mMeshBvhRefitNodeCount = mMeshBvh.Refit();
+			isRebuildRequired = mMeshBvhRefitNodeCount != 0u && mMeshBvh.GetSahCost() > mMeshBvh.GetBuildSahCost() * MAX_MESH_BVH_SAH_COST_RATIO;
+		}
+
+		if (isRebuildRequired)
+		{
+			std::vector<BoundingBox> meshBoundingBoxes(drawCount);
+			for (uint32_t i = 0u; i < drawCount; ++i)
+			{
+				meshBoundingBoxes[i] = mMeshBoundingBoxes.Get(i);
+			}
+
+			mMeshBvh.Build(meshBoundingBoxes);
+			mMeshBvhRefitNodeCount = 0u;
+			++mMeshBvhBuildCount;
+		}
+
+		mMeshBvhModelMatrices.assign(modelMatrices.begin(), modelMatrices.end());
+	}
+
+	void SceneVisibility::CullShadowCasters(const Matrix4x4& lightViewProjectionMatrix, const Float3& lightDirection)
+	{
+		const std::chrono::high_resolution_clock::time_point cullingStartTime = std::chrono::high_resolution_clock::now();
+
+		mLightViewProjectionMatrix = lightViewProjectionMatrix;
+
+		mShadowCasterVisibility.resize(mMeshBoundingBoxes.GetCount());
+
+		if (!mShadowCasterCullingEnabled)
+		{
+			std::fill(mShadowCasterVisibility.begin(), mShadowCasterVisibility.end(), static_cast<uint8_t>(1u));
+			mShadowCasterCullingStatistics =
+			{
+				.casterCount = mMeshBoundingBoxes.GetCount(),
+				.visibleCount = mMeshBoundingBoxes.GetCount(),
+			};
+
+			return;
+		}
+
+		// If no receiver is visible, only the camera frustum bounds the receivers (so the shadow map is still valid if the editor displays it).
+		const ShadowCasterCullingDesc shadowCasterCullingDesc
+		{
+			.lightViewProjectionMatrix = lightViewProjectionMatrix,
+			.lightDirection = lightDirection,
+			.cameraViewProjectionMatrix = mCameraViewProjectionMatrix,
+			.receiverBounds = ComputeVisibleBounds(mMeshBoundingBoxes, mMeshVisibility),
+		};
+
+		mShadowCasterCullingStatistics = scene::CullShadowCasters(shadowCasterCullingDesc, mMeshBoundingBoxes, mShadowCasterVisibility);
+
+		mCullingCpuTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cullingStartTime).count();
+	}
+
+	void SceneVisibility::BuildCameraDrawPackets()
+	{
+		BuildDrawPackets(mMeshVisibility, CAMERA_DRAW_SORT_PASS, mCameraViewProjectionMatrix, true);
+		mDrawSortStateChanges = gfx::CountDrawSortStateChanges(mDrawPackets);
+	}
+
+	void SceneVisibility::BuildShadowDrawPackets()
+	{
+		BuildDrawPackets(mShadowCasterVisibility, SHADOW_DRAW_SORT_PASS, mLightViewProjectionMatrix, false);
+	}
+
+	void SceneVisibility::BuildDrawPackets(std::span<const uint8_t> meshVisibility, uint32_t pass, const Matrix4x4& viewProjectionMatrix, bool materialKeyed)
+	{
+		mDrawPackets.clear();
+
+		for (uint32_t drawIndex = 0u; drawIndex < GetMeshDrawCount(); ++drawIndex)
+		{
+			// Models added since the last culling have not been culled yet.
+			if (drawIndex < meshVisibility.size() && meshVisibility[drawIndex] == 0u)
+			{
+				continue;
+			}
+
+			uint64_t sortKey{};
+			if (mDrawSortingEnabled)
+			{
+				// Note : The meshes of models added since the last culling have no bounds yet, so they are sorted as the closest.
+				const float depth = drawIndex < mMeshBoundingBoxes.GetCount() ? ComputeBoundingBoxDepth(mMeshBoundingBoxes.Get(drawIndex), viewProjectionMatrix) : 0.0f;
+				const uint32_t material = materialKeyed ? mModels[mMeshDrawLocations[drawIndex].modelIndex].firstMaterialIndex + mMeshes[drawIndex].materialIndex : 0u;
+
+				sortKey = gfx::MakeDrawSortKey(pass, 0u, material, depth);
+			}
+
+			mDrawPackets.push_back(gfx::DrawPacket{ .sortKey = sortKey, .drawIndex = drawIndex });
+		}
+
+		if (mDrawSortingEnabled)
+		{
+			gfx::SortDrawPackets(mDrawPackets, mDrawPacketScratch);
+		}
+	}
+
+	void SceneVisibility::BuildIndirectDraws(gfx::IndirectDrawStream& indirectDrawStream, std::vector<HiZDrawBounds>& drawBounds, const AddIndirectDrawFunction& addDraw)
+	{
+		indirectDrawStream.Clear();
+		indirectDrawStream.Reserve(GetMeshDrawCount());
+		drawBounds.clear();
+
+		BuildCameraDrawPackets();
+
+		for (const gfx::DrawPacket& drawPacket : mDrawPackets)
+		{
+			addDraw(indirectDrawStream, mMeshDrawLocations[drawPacket.drawIndex]);
+
+			const BoundingBox boundingBox = GetMeshBoundingBox(drawPacket.drawIndex);
+
+			drawBounds.push_back(HiZDrawBounds
+			{
+				.minimum = boundingBox.minimum,
+				.visibilityIndex = drawPacket.drawIndex,
+				.maximum = boundingBox.maximum,
+			});
+		}
+	}
+
+	std::pair<uint32_t, uint32_t> SceneVisibility::GetChunkPacketRange(uint32_t chunkIndex, uint32_t chunkCount) const
+	{
+		const uint32_t packetCount = static_cast<uint32_t>(mDrawPackets.size());
+		const uint32_t chunkSize = (packetCount + chunkCount - 1u) / std::max(chunkCount, 1u);
+
+		const uint32_t packetIndexBegin = std::min(chunkIndex * chunkSize, packetCount);
+		return { packetIndexBegin, std::min(packetIndexBegin + chunkSize, packetCount) };
+	}
+
+	uint32_t SceneVisibility::GetRecordingChunkCount(uint32_t recordingThreadCount) const
+	{
+		const uint32_t threadCount = std::clamp(recordingThreadCount, 1u, core::JobSystem::Get().GetWorkerCount() + 1u);
+
+		return std::clamp(GetMeshDrawCount() / MIN_DRAWS_PER_RECORDING_CHUNK, 1u, threadCount);
+	}
+
+	void SceneVisibility::RecordInParallel(uint32_t chunkCount, const BeginRecordingChunkFunction& beginChunk, const RecordDrawFunction& recordDraw) const
+	{
+		core::JobSystem::Get().ParallelFor(chunkCount, 1u, [&](uint32_t chunkIndexBegin, uint32_t chunkIndexEnd)
+		{
+			for (uint32_t chunkIndex = chunkIndexBegin; chunkIndex < chunkIndexEnd; ++chunkIndex)
+			{
+				beginChunk(chunkIndex);
+
+				const auto [packetIndexBegin, packetIndexEnd] = GetChunkPacketRange(chunkIndex, chunkCount);
+				for (uint32_t packetIndex = packetIndexBegin; packetIndex < packetIndexEnd; ++packetIndex)
+				{
+					recordDraw(chunkIndex, mMeshDrawLocations[mDrawPackets[packetIndex].drawIndex]);
+				}
+			}
+		});
+	}
+
+	BoundingBox SceneVisibility::GetMeshBoundingBox(uint32_t drawIndex) const
+	{
+		if (drawIndex < mMeshBoundingBoxes.GetCount())
+		{
+			return mMeshBoundingBoxes.Get(drawIndex);
+		}
+
+		return BoundingBox
+		{
+			.minimum = Float3{ -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() },
+			.maximum = Float3{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() },
+		};
+	}
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "HiZCulling.hpp"
+#include "OcclusionCulling.hpp"
+#include "ShadowCasterCulling.hpp"
+
+#include "Graphics/API/DrawSorting.hpp"
+#include "Graphics/API/IndirectDraw.hpp"
+
+namespace helios::scene
+{
+	// A mesh as seen by the SceneVisibility : its bounds (in model space), material and occluder (if it has one).
+	struct VisibilityMesh
+	{
+		BoundingBox boundingBox{};
+		uint32_t materialIndex{};
+
+		std::shared_ptr<const OccluderMesh> occluderMesh{};
+	};
+
+	// Where the mesh of a draw index is : the index of its model (in the order the models were added), and of the mesh within the model.
+	struct MeshDrawLocation
+	{
+		uint32_t modelIndex{};
+		uint32_t meshIndex{};
+	};
+
+	// The CPU side of the scene's visibility : culls the meshes of the models against the camera frustum and the occluders, culls the shadow casters, and
+	// builds the sorted draw packets the passes record. The meshes of all models are indexed in order (the draw index), as the visibility and packets refer to them.
+	// Not thread safe : models are added, and the meshes culled, from the render thread (the culling itself is spread over the job system).
+	class SceneVisibility
+	{
+	public:
+		SceneVisibility();
+
+		// The meshes of the model get the next draw indices. materialCount is the number of materials of the model, so the materials of all models have
+		// distinct keys.
+		void AddModel(std::span<const VisibilityMesh> meshes, uint32_t materialCount);
+
+		uint32_t GetModelCount() const { return static_cast<uint32_t>(mModels.size()); }
+		uint32_t GetMeshDrawCount() const { return static_cast<uint32_t>(mMeshes.size()); }
+		MeshDrawLocation GetMeshDrawLocation(uint32_t drawIndex) const { return mMeshDrawLocations[drawIndex]; }
+
+		// Transforms the bounding boxes of the meshes by the model matrices (indexed by model index, one per model), and tests them against the frustum of
+		// the view projection matrix, then against the occlusion buffer (see CullOccludedMeshes).
+		// Done once per frame, so all passes rendering from the camera draw the same meshes (which the EQUAL depth test after the depth pre-pass requires).
+		void CullMeshes(std::span<const Matrix4x4> modelMatrices, const Matrix4x4& cameraViewProjectionMatrix);
+
+		// Culls the shadow casters of the directional light (see scene::CullShadowCasters) against the light frustum and the receivers visible from the camera
+		// (i.e the meshes kept by CullMeshes). lightDirection is the direction the light travels in.
+		void CullShadowCasters(const Matrix4x4& lightViewProjectionMatrix, const Float3& lightDirection);
+
+		// Builds a packet per visible mesh (all meshes of the models added since the last culling) into the draw packets, sorted by their key (see
+		// gfx::MakeDrawSortKey) : the pass, the material (the shadow pass ignores the materials) and the depth of the mesh's bounds from the camera (or
+		// the light), so the draws sharing a material are recorded together, front to back. In draw index order if mDrawSortingEnabled is false.
+		// The camera overload also counts the state changes of the packets (see mDrawSortStateChanges).
+		void BuildCameraDrawPackets();
+		void BuildShadowDrawPackets();
+
+		std::span<const gfx::DrawPacket> GetDrawPackets() const { return mDrawPackets; }
+
+		// Builds the camera draw packets, and a draw per packet (in the same order) into indirectDrawStream, which is cleared first : addDraw adds the draw of
+		// the mesh to the stream. The world space bounds of the draws are written into drawBounds (same indices, the visibility index being the draw index of
+		// the mesh), for the GPU occlusion culling (see HiZCulling).
+		using AddIndirectDrawFunction = std::function<void(gfx::IndirectDrawStream& indirectDrawStream, const MeshDrawLocation& meshDrawLocation)>;
+		void BuildIndirectDraws(gfx::IndirectDrawStream& indirectDrawStream, std::vector<HiZDrawBounds>& drawBounds, const AddIndirectDrawFunction& addDraw);
+
+		// The packets split evenly across chunkCount chunks (i.e one per recording thread) : the range [begin, end) of the packets of the chunk.
+		std::pair<uint32_t, uint32_t> GetChunkPacketRange(uint32_t chunkIndex, uint32_t chunkCount) const;
+
+		// One chunk per recording thread (up to one per job system thread), unless that would make the chunks smaller than MIN_DRAWS_PER_RECORDING_CHUNK.
+		// Hence, the chunk size grows with the scene.
+		uint32_t GetRecordingChunkCount(uint32_t recordingThreadCount) const;
+
+		// Records the draw packets last built in chunkCount chunks (see GetChunkPacketRange), in parallel over the job system : beginChunk is called once per
+		// chunk (i.e to set up the context it is recorded into), then recordDraw for each draw of the chunk. A chunk is recorded by a single thread.
+		using BeginRecordingChunkFunction = std::function<void(uint32_t chunkIndex)>;
+		using RecordDrawFunction = std::function<void(uint32_t chunkIndex, const MeshDrawLocation& meshDrawLocation)>;
+		void RecordInParallel(uint32_t chunkCount, const BeginRecordingChunkFunction& beginChunk, const RecordDrawFunction& recordDraw) const;
+
+		// World space bounds of the mesh of the last culling. The meshes of models added since then are given bounds that are never culled.
+		BoundingBox GetMeshBoundingBox(uint32_t drawIndex) const;
+
+		std::span<const uint8_t> GetMeshVisibility() const { return mMeshVisibility; }
+		std::span<const uint8_t> GetShadowCasterVisibility() const { return mShadowCasterVisibility; }
+
+		// Hierarchy over the world space bounds of the meshes (object index is the draw index).
+		const BoundingVolumeHierarchy& GetMeshBvh() const { return mMeshBvh; }
+		const Matrix4x4& GetCameraViewProjectionMatrix() const { return mCameraViewProjectionMatrix; }
+
+	private:
+		// Rasterizes the occluders of the meshes inside of the camera frustum into the occlusion buffer, and culls the meshes they hide.
+		void CullOccludedMeshes(std::span<const Matrix4x4> modelMatrices);
+
+		// Refits the hierarchy over the world space boxes for the models whose matrix changed since the last call, or rebuilds it if meshes were added
+		// (or if refitting degraded it too much).
+		void UpdateMeshBvh(std::span<const Matrix4x4> modelMatrices);
+
+		void BuildDrawPackets(std::span<const uint8_t> meshVisibility, uint32_t pass, const Matrix4x4& viewProjectionMatrix, bool materialKeyed);
+
+	public:
+		// The pass field of the draw sort keys (see BuildDrawPackets).
+		static constexpr uint32_t CAMERA_DRAW_SORT_PASS = 0u;
+		static constexpr uint32_t SHADOW_DRAW_SORT_PASS = 1u;
+
+		// Below this, the cost of submitting another command list outweighs recording the draws on another thread.
+		static constexpr uint32_t MIN_DRAWS_PER_RECORDING_CHUNK = 64u;
+
+		// The mesh hierarchy is rebuilt once refitting makes its SAH cost this many times larger than after its last build.
+		static constexpr float MAX_MESH_BVH_SAH_COST_RATIO = 2.0f;
+
+		// Low resolution, as the occluders only have to hide whole meshes (rather than pixels).
+		static constexpr uint32_t OCCLUSION_BUFFER_WIDTH = 320u;
+		static constexpr uint32_t OCCLUSION_BUFFER_HEIGHT = 192u;
+
+		// Frustum culling of the meshes (see CullMeshes) and of the shadow casters (see CullShadowCasters).
+		bool mFrustumCullingEnabled{ true };
+		uint32_t mVisibleMeshDrawCount{};
+		double mCullingCpuTime{};
+
+		bool mShadowCasterCullingEnabled{ true };
+		ShadowCasterCullingStatistics mShadowCasterCullingStatistics{};
+
+		// Occlusion culling of the meshes kept by the frustum culling (see CullOccludedMeshes). The occluders are the meshes added with an occluder mesh.
+		bool mOcclusionCullingEnabled{ true };
+		uint32_t mOccludedMeshDrawCount{};
+		uint32_t mOccluderTriangleCount{};
+
+		// Sorting of the draw packets of every pass, and the state changes of the camera draws of the last frame.
+		bool mDrawSortingEnabled{ true };
+		gfx::DrawSortStateChanges mDrawSortStateChanges{};
+
+		// Number of nodes refit in the last frame, and of builds since the visibility was created (see UpdateMeshBvh).
+		uint32_t mMeshBvhRefitNodeCount{};
+		uint32_t mMeshBvhBuildCount{};
+
+	private:
+		struct VisibilityModel
+		{
+			uint32_t firstDrawIndex{};
+			uint32_t meshCount{};
+
+			// Index of the first material of the model among the materials of all models.
+			uint32_t firstMaterialIndex{};
+		};
+
+		std::vector<VisibilityModel> mModels{};
+		std::vector<VisibilityMesh> mMeshes{};
+		std::vector<MeshDrawLocation> mMeshDrawLocations{};
+		uint32_t mMaterialCount{};
+
+		// World space bounding boxes and visibility of the meshes of the last culling (indexed by draw index).
+		BoundingBoxSoA mMeshBoundingBoxes{};
+		std::vector<uint8_t> mMeshVisibility{};
+		std::vector<uint8_t> mShadowCasterVisibility{};
+
+		// Of the last CullMeshes, and of the last CullShadowCasters.
+		Matrix4x4 mCameraViewProjectionMatrix{};
+		Matrix4x4 mLightViewProjectionMatrix{};
+
+		// The packets of the last BuildDrawPackets, and the scratch buffer they are sorted with.
+		std::vector<gfx::DrawPacket> mDrawPackets{};
+		std::vector<gfx::DrawPacket> mDrawPacketScratch{};
+
+		// Hierarchy over mMeshBoundingBoxes (same indices), and the model matrices its boxes were computed with.
+		BoundingVolumeHierarchy mMeshBvh{};
+		std::vector<Matrix4x4> mMeshBvhModelMatrices{};
+
+		OcclusionBuffer mOcclusionBuffer{};
+	};
+}
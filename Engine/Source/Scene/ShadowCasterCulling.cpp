@@ -0,0 +1,108 @@
+#include "ShadowCasterCulling.hpp"
+
+#include <algorithm>
+
+namespace helios::scene
+{
+	static constexpr uint32_t FRUSTUM_NEAR_PLANE_INDEX = 4u;
+
+	std::optional<BoundingBox> ComputeVisibleBounds(const BoundingBoxSoA& boundingBoxes, std::span<const uint8_t> visibility)
+	{
+		std::optional<BoundingBox> visibleBounds{};
+
+		for (uint32_t i = 0u; i < boundingBoxes.GetCount(); ++i)
+		{
+			if (visibility[i] == 0u)
+			{
+				continue;
+			}
+
+			const BoundingBox boundingBox = boundingBoxes.Get(i);
+
+			if (!visibleBounds.has_value())
+			{
+				visibleBounds = boundingBox;
+				continue;
+			}
+
+			for (size_t axis = 0u; axis < 3u; ++axis)
+			{
+				visibleBounds->minimum[axis] = std::min(visibleBounds->minimum[axis], boundingBox.minimum[axis]);
+				visibleBounds->maximum[axis] = std::max(visibleBounds->maximum[axis], boundingBox.maximum[axis]);
+			}
+		}
+
+		return visibleBounds;
+	}
+
+	ShadowCasterCullingStatistics CullShadowCasters(const ShadowCasterCullingDesc& shadowCasterCullingDesc, const BoundingBoxSoA& casterBoundingBoxes, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation)
+	{
+		const uint32_t casterCount = casterBoundingBoxes.GetCount();
+
+		// The light frustum, extended towards the light.
+		const Frustum lightFrustum = ExtractFrustum(shadowCasterCullingDesc.lightViewProjectionMatrix);
+
+		std::vector<Plane> lightPlanes{};
+		for (uint32_t i = 0u; i < static_cast<uint32_t>(lightFrustum.planes.size()); ++i)
+		{
+			if (i != FRUSTUM_NEAR_PLANE_INDEX)
+			{
+				lightPlanes.push_back(lightFrustum.planes[i]);
+			}
+		}
+
+		// The receiver volume : the camera frustum, intersected with the bounds of the visible receivers.
+		const Frustum cameraFrustum = ExtractFrustum(shadowCasterCullingDesc.cameraViewProjectionMatrix);
+
+		std::vector<Plane> receiverPlanes(cameraFrustum.planes.begin(), cameraFrustum.planes.end());
+		if (shadowCasterCullingDesc.receiverBounds.has_value())
+		{
+			const BoundingBox& receiverBounds = *shadowCasterCullingDesc.receiverBounds;
+			for (size_t axis = 0u; axis < 3u; ++axis)
+			{
+				Plane minimumPlane{};
+				minimumPlane[axis] = 1.0f;
+				minimumPlane[3] = -receiverBounds.minimum[axis];
+
+				Plane maximumPlane{};
+				maximumPlane[axis] = -1.0f;
+				maximumPlane[3] = receiverBounds.maximum[axis];
+
+				receiverPlanes.push_back(minimumPlane);
+				receiverPlanes.push_back(maximumPlane);
+			}
+		}
+
+		// Sweeping the caster along the light direction moves it inside the planes whose normal points along the light direction, without bound.
+		const Float3& lightDirection = shadowCasterCullingDesc.lightDirection;
+		std::erase_if(receiverPlanes, [&](const Plane& plane)
+		{
+			return plane[0] * lightDirection[0] + plane[1] * lightDirection[1] + plane[2] * lightDirection[2] > 0.0f;
+		});
+
+		ShadowCasterCullingStatistics statistics
+		{
+			.casterCount = casterCount,
+		};
+
+		const uint32_t insideLightFrustumCount = CullBoundingBoxes(lightPlanes, casterBoundingBoxes, visibility, cullingImplementation);
+		statistics.outsideLightFrustumCount = casterCount - insideLightFrustumCount;
+
+		std::vector<uint8_t> receiverVisibility(casterCount);
+		CullBoundingBoxes(receiverPlanes, casterBoundingBoxes, receiverVisibility, cullingImplementation);
+
+		for (uint32_t i = 0u; i < casterCount; ++i)
+		{
+			if (visibility[i] != 0u && receiverVisibility[i] == 0u)
+			{
+				visibility[i] = 0u;
+				++statistics.noVisibleReceiverCount;
+			}
+		}
+
+		statistics.visibleCount = insideLightFrustumCount - statistics.noVisibleReceiverCount;
+
+		return statistics;
+	}
+}
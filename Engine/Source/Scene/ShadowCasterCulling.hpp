@@ -0,0 +1,47 @@
+#pragma once
+
+#include "FrustumCulling.hpp"
+
+#include <optional>
+
+namespace helios::scene
+{
+	struct ShadowCasterCullingDesc
+	{
+		// Orthographic projection of the directional light's shadow map (see ShadowPass).
+		Matrix4x4 lightViewProjectionMatrix{};
+
+		// Direction the light travels in (from the light towards the scene).
+		Float3 lightDirection{};
+
+		Matrix4x4 cameraViewProjectionMatrix{};
+
+		// Bounds of the receivers visible from the camera (see ComputeVisibleBounds). Only the camera frustum bounds the receivers if not set.
+		std::optional<BoundingBox> receiverBounds{};
+	};
+
+	struct ShadowCasterCullingStatistics
+	{
+		uint32_t casterCount{};
+
+		// Outside of the light frustum (extended towards the light).
+		uint32_t outsideLightFrustumCount{};
+
+		// Inside the light frustum, but their shadow cannot land on a visible receiver.
+		uint32_t noVisibleReceiverCount{};
+
+		uint32_t visibleCount{};
+	};
+
+	// Bounds of the boxes whose visibility is not 0 (std::nullopt if there are none).
+	std::optional<BoundingBox> ComputeVisibleBounds(const BoundingBoxSoA& boundingBoxes, std::span<const uint8_t> visibility);
+
+	// A caster is rendered into the shadow map if :
+	// - It is inside the light frustum without its near plane, as casters between the light and the near plane still cast shadows (the shadow pipeline
+	//   clamps their depth instead of clipping them).
+	// - The volume it sweeps along the light direction intersects the camera frustum and the receiver bounds, i.e its shadow may land on a visible receiver.
+	//   The swept volume is unbounded, so it can only be separated by the planes facing the light : the box is tested against those planes only.
+	// Writes 1 in visibility[i] if the i'th caster is rendered, else 0. visibility must hold at least casterBoundingBoxes.GetCount() elements.
+	ShadowCasterCullingStatistics CullShadowCasters(const ShadowCasterCullingDesc& shadowCasterCullingDesc, const BoundingBoxSoA& casterBoundingBoxes, std::span<uint8_t> visibility,
+		CullingImplementation cullingImplementation = CullingImplementation::Best);
+}
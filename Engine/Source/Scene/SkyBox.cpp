@@ -108,7 +108,7 @@ namespace helios::scene
 			// Generate cube map.
 			auto computeContext = device->GetComputeContext();
 
-			computeContext->AddResourceBarrier(mSkyBoxTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+			computeContext->TransitionResource(mSkyBoxTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 			computeContext->ExecuteResourceBarriers();
 
 			computeContext->SetComputePipelineState(mCubeMapFromEquirectPipelineState.get());
@@ -147,19 +147,21 @@ namespace helios::scene
 				size /= 2;
 			}
 
-			computeContext->AddResourceBarrier(mSkyBoxTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+			computeContext->TransitionResource(mSkyBoxTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON);
 			computeContext->ExecuteResourceBarriers();
 
+			device->ExecuteContext(std::move(computeContext));
+
 			// Generate mips for all the cube faces.
+			// Note : The mip map generator executes on the compute queue as well (and waits for its submission), so it is ordered after the cube map generation, and the equirect texture is no longer in use once the constructor returns.
 			device->GetMipMapGenerator()->GenerateMips(mSkyBoxTexture.get());
-			device->ExecuteContext(std::move(computeContext));
 		}
 
 		// Run compute shader to generate irradiance map from sky box texture.
 		{
 			auto computeContext = device->GetComputeContext();
 
-			computeContext->AddResourceBarrier(mIrradianceMapTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+			computeContext->TransitionResource(mIrradianceMapTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 			computeContext->ExecuteResourceBarriers();
 
 			computeContext->SetComputePipelineState(mIrradianceMapPipelineState.get());
@@ -173,7 +175,7 @@ namespace helios::scene
 			computeContext->Set32BitComputeConstants(&diffuseIrradianceRenderResources);
 
 			computeContext->Dispatch(IRRADIANCE_MAP_TEXTURE_DIMENSION / 32u, IRRADIANCE_MAP_TEXTURE_DIMENSION / 32u, 6u);
-			computeContext->AddResourceBarrier(mIrradianceMapTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+			computeContext->TransitionResource(mIrradianceMapTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON);
 			computeContext->ExecuteResourceBarriers();
 
 			device->ExecuteContext(std::move(computeContext));
@@ -183,7 +185,7 @@ namespace helios::scene
 		{
 			auto computeContext = device->GetComputeContext();
 
-			computeContext->AddResourceBarrier(mPreFilterTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+			computeContext->TransitionResource(mPreFilterTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 			computeContext->ExecuteResourceBarriers();
 
 			computeContext->SetComputePipelineState(mPrefilterMapPipelineState.get());
@@ -223,7 +225,7 @@ namespace helios::scene
 				size /= 2;
 			}
 
-			computeContext->AddResourceBarrier(mPreFilterTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+			computeContext->TransitionResource(mPreFilterTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON);
 			computeContext->ExecuteResourceBarriers();
 
 			device->ExecuteContext(std::move(computeContext));
@@ -233,7 +235,7 @@ namespace helios::scene
 		{
 			auto computeContext = device->GetComputeContext();
 
-			computeContext->AddResourceBarrier(mBRDFLutTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+			computeContext->TransitionResource(mBRDFLutTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 			computeContext->ExecuteResourceBarriers();
 
 			computeContext->SetComputePipelineState(mBRDFLutPipelineState.get());
@@ -247,10 +249,11 @@ namespace helios::scene
 
 			computeContext->Dispatch(BRDF_LUT_TEXTURE_DIMENSION / 32u, BRDF_LUT_TEXTURE_DIMENSION / 32u, 1u);
 
-			computeContext->AddResourceBarrier(mBRDFLutTexture->GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+			computeContext->TransitionResource(mBRDFLutTexture->GetResource(), D3D12_RESOURCE_STATE_COMMON);
 			computeContext->ExecuteResourceBarriers();
 
-			device->ExecuteContext(std::move(computeContext));
+			// As submissions to the compute queue execute in order, the last submission completing implies all the maps are ready.
+			mPrecomputeSubmission = device->ExecuteContext(std::move(computeContext));
 		}
 
 		// Create skybox model.
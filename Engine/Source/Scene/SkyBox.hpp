@@ -26,6 +26,9 @@ namespace helios::scene
 
 		void Render(const gfx::GraphicsContext* graphicsContext, SkyBoxRenderResources& renderResources);
 
+		// The cube map and IBL maps are generated asynchronously on the compute queue : submissions reading them must depend on this submission.
+		const gfx::QueueSubmission& GetPrecomputeSubmission() const { return mPrecomputeSubmission; }
+
 	public:
 		static constexpr inline const wchar_t* SKYBOX_MODEL_PATH{ L"Assets/Models/Cube/glTF/Cube.gltf" };
 
@@ -45,6 +48,8 @@ namespace helios::scene
 		std::unique_ptr<gfx::Texture> mIrradianceMapTexture;
 		std::unique_ptr<gfx::Texture> mPreFilterTexture;
 		std::unique_ptr<gfx::Texture> mBRDFLutTexture;
+
+		gfx::QueueSubmission mPrecomputeSubmission{};
 	};
 }
 
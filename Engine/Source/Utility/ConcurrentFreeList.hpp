@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+// Lock free (unordered) free list, primarily used for recycling command lists across threads.
+// Values are stored in nodes that are linked into one of two Treiber stacks : one for nodes holding a value, and one for empty nodes (which are reused by Push).
+// Nodes are never freed (until the free list is destroyed) and are referred to by index, so the stack heads can be tagged with a counter to avoid the ABA problem.
+// Push / Pop are lock free, except when Push has to allocate a new chunk of nodes (i.e the number of values in the list reaches a new maximum).
+template <typename T>
+class ConcurrentFreeList
+{
+public:
+	ConcurrentFreeList() = default;
+
+	ConcurrentFreeList(const ConcurrentFreeList& other) = delete;
+	ConcurrentFreeList& operator=(const ConcurrentFreeList& other) = delete;
+
+	// Returns false (and discards the value) if the maximum number of nodes has been reached.
+	bool Push(T value)
+	{
+		std::optional<uint32_t> nodeIndex = PopNode(mEmptyNodesHead);
+		if (!nodeIndex.has_value())
+		{
+			nodeIndex = AllocateNode();
+			if (!nodeIndex.has_value())
+			{
+				return false;
+			}
+		}
+
+		// The node is exclusively owned by this thread until it is pushed to the stack.
+		GetNode(*nodeIndex).value = std::move(value);
+		PushNode(mValueNodesHead, *nodeIndex);
+
+		return true;
+	}
+
+	std::optional<T> Pop()
+	{
+		const std::optional<uint32_t> nodeIndex = PopNode(mValueNodesHead);
+		if (!nodeIndex.has_value())
+		{
+			return std::nullopt;
+		}
+
+		Node& node = GetNode(*nodeIndex);
+
+		std::optional<T> value = std::move(node.value);
+		node.value.reset();
+
+		PushNode(mEmptyNodesHead, *nodeIndex);
+
+		return value;
+	}
+
+public:
+	static constexpr uint32_t NODES_PER_CHUNK = 64u;
+	static constexpr uint32_t MAX_CHUNKS = 1024u;
+
+private:
+	struct Node
+	{
+		std::optional<T> value{};
+
+		// Index + 1 of the next node in the stack, 0 if this is the last node.
+		std::atomic<uint32_t> next{};
+	};
+
+	// The lower 32 bits of a stack head hold index + 1 of the top node (0 if the stack is empty), the upper 32 bits hold a tag that is incremented on every change.
+	static constexpr uint64_t PackHead(uint32_t nodeIndexPlusOne, uint32_t tag) { return (static_cast<uint64_t>(tag) << 32u) | nodeIndexPlusOne; }
+	static constexpr uint32_t GetHeadNodeIndexPlusOne(uint64_t head) { return static_cast<uint32_t>(head & 0xFFFFFFFFu); }
+	static constexpr uint32_t GetHeadTag(uint64_t head) { return static_cast<uint32_t>(head >> 32u); }
+
+	Node& GetNode(uint32_t nodeIndex)
+	{
+		return mChunks[nodeIndex / NODES_PER_CHUNK].load(std::memory_order_acquire)[nodeIndex % NODES_PER_CHUNK];
+	}
+
+	void PushNode(std::atomic<uint64_t>& stackHead, uint32_t nodeIndex)
+	{
+		Node& node = GetNode(nodeIndex);
+
+		uint64_t head = stackHead.load(std::memory_order_relaxed);
+		uint64_t newHead{};
+
+		do
+		{
+			node.next.store(GetHeadNodeIndexPlusOne(head), std::memory_order_relaxed);
+			newHead = PackHead(nodeIndex + 1u, GetHeadTag(head) + 1u);
+		} while (!stackHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	std::optional<uint32_t> PopNode(std::atomic<uint64_t>& stackHead)
+	{
+		uint64_t head = stackHead.load(std::memory_order_acquire);
+		uint64_t newHead{};
+
+		do
+		{
+			if (GetHeadNodeIndexPlusOne(head) == 0u)
+			{
+				return std::nullopt;
+			}
+
+			// The node may be popped (and pushed again) by another thread meanwhile, in which case next is stale, but the tag makes the exchange fail.
+			const uint32_t next = GetNode(GetHeadNodeIndexPlusOne(head) - 1u).next.load(std::memory_order_relaxed);
+			newHead = PackHead(next, GetHeadTag(head) + 1u);
+		} while (!stackHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire));
+
+		return GetHeadNodeIndexPlusOne(head) - 1u;
+	}
+
+	std::optional<uint32_t> AllocateNode()
+	{
+		std::lock_guard<std::mutex> lockGuard(mAllocationMutex);
+
+		if (mNodeCount == NODES_PER_CHUNK * MAX_CHUNKS)
+		{
+			return std::nullopt;
+		}
+
+		const uint32_t chunkIndex = mNodeCount / NODES_PER_CHUNK;
+		if (mNodeCount % NODES_PER_CHUNK == 0u)
+		{
+			mChunkStorage[chunkIndex] = std::make_unique<Node[]>(NODES_PER_CHUNK);
+			mChunks[chunkIndex].store(mChunkStorage[chunkIndex].get(), std::memory_order_release);
+		}
+
+		return mNodeCount++;
+	}
+
+private:
+	std::atomic<uint64_t> mValueNodesHead{};
+	std::atomic<uint64_t> mEmptyNodesHead{};
+
+	std::array<std::atomic<Node*>, MAX_CHUNKS> mChunks{};
+
+	// Only accessed when allocating nodes.
+	std::mutex mAllocationMutex{};
+	std::array<std::unique_ptr<Node[]>, MAX_CHUNKS> mChunkStorage{};
+	uint32_t mNodeCount{};
+};
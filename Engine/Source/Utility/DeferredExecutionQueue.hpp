@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Deferred execution queue, primarily used for deferred destruction of GPU resources / descriptors.
+// Functions can be pushed in two ways :
+// (i) Without fence values : they are 'pending' until either Execute() is called, or they are tagged with fence values using TagPendingFunctions().
+// (ii) With fence values (one per command queue) : they are executed by ExecuteCompletedFunctions() once the completed value of every fence is >= the tagged value.
+// As fence values only increase, functions are tagged in non decreasing order, so only the front of the queue has to be checked.
+struct DeferredExecutionQueue
+{
+	// Graphics, compute and copy queue.
+	static constexpr size_t MAX_FENCE_COUNT = 3u;
+	using FenceValues = std::array<uint64_t, MAX_FENCE_COUNT>;
+
+	struct FenceKeyedFunction
+	{
+		FenceValues fenceValues{};
+		std::function<void()> function{};
+	};
+
+	void PushFunction(std::function<void()>&& function)
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		functionPointers.push_back(std::move(function));
+	}
+
+	void PushFunction(std::function<void()>&& function, const FenceValues& fenceValues)
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		fenceKeyedFunctions.push_back({ .fenceValues = fenceValues, .function = std::move(function) });
+	}
+
+	// Tags all pending functions with the fence values that are signalled after the last submission which could reference the released objects.
+	void TagPendingFunctions(const FenceValues& fenceValues)
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+
+		for (std::function<void()>& function : functionPointers)
+		{
+			fenceKeyedFunctions.push_back({ .fenceValues = fenceValues, .function = std::move(function) });
+		}
+
+		functionPointers.clear();
+	}
+
+	// Returns the number of functions executed.
+	size_t ExecuteCompletedFunctions(const FenceValues& completedFenceValues)
+	{
+		std::vector<std::function<void()>> completedFunctions{};
+
+		{
+			std::lock_guard<std::mutex> lockGuard(mutex);
+
+			while (!fenceKeyedFunctions.empty() && IsComplete(fenceKeyedFunctions.front().fenceValues, completedFenceValues))
+			{
+				completedFunctions.push_back(std::move(fenceKeyedFunctions.front().function));
+				fenceKeyedFunctions.pop_front();
+			}
+		}
+
+		// Executed outside of the lock, so that the functions themselves can push to the queue.
+		for (std::function<void()>& function : completedFunctions)
+		{
+			function();
+		}
+
+		return completedFunctions.size();
+	}
+
+	// Executes all functions (pending ones in reverse order of pushing) regardless of fence values. Only call this when the GPU is idle.
+	void Execute()
+	{
+		std::vector<std::function<void()>> functions{};
+		std::deque<FenceKeyedFunction> fenceKeyed{};
+
+		{
+			std::lock_guard<std::mutex> lockGuard(mutex);
+
+			functions.swap(functionPointers);
+			fenceKeyed.swap(fenceKeyedFunctions);
+		}
+
+		for (FenceKeyedFunction& fenceKeyedFunction : fenceKeyed)
+		{
+			fenceKeyedFunction.function();
+		}
+
+		for (auto it = functions.rbegin(); it != functions.rend(); it++)
+		{
+			(*it)();
+		}
+	}
+
+	size_t GetPendingFunctionCount() const
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		return functionPointers.size() + fenceKeyedFunctions.size();
+	}
+
+	static bool IsComplete(const FenceValues& fenceValues, const FenceValues& completedFenceValues)
+	{
+		for (size_t i = 0; i < MAX_FENCE_COUNT; ++i)
+		{
+			if (completedFenceValues[i] < fenceValues[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::vector<std::function<void()>> functionPointers;
+	std::deque<FenceKeyedFunction> fenceKeyedFunctions;
+
+	mutable std::mutex mutex;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DeferredExecutionQueue.hpp"
+
 // Reference : https://github.com/microsoft/DirectX-Graphics-Samples/blob/master/Samples/Desktop/D3D12HelloWorld/src/HelloWindow/DXSampleHelper.h.
 static inline std::string WstringToString(std::wstring_view inputWString)
 {
@@ -50,28 +52,6 @@ static inline void GetBlobMessage(ID3DBlob* blob)
 
 #define CREATE_LAMBDA_FUNCTION(function) ([&](){function;})
 
-// Deferred execution queue for templated functions.
-// note (rtarun9) : This is added here as currently there is no DX_TYPES / similar file.
-struct DeferredExecutionQueue
-{
-	std::vector<std::function<void()>> functionPointers;
-
-	void PushFunction(std::function<void()>&& function)
-	{
-		functionPointers.push_back(function);
-	}
-
-	void Execute()
-	{
-		for (auto it = functionPointers.rbegin(); it != functionPointers.rend(); it++)
-		{
-			(*it)();
-		}
-
-		functionPointers.clear();
-	}
-};
-
 template <typename T>
 static inline constexpr typename std::underlying_type<T>::type EnumClassValue(const T& value)
 {
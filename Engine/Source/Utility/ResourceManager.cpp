@@ -47,25 +47,25 @@ namespace helios::utility
 
     void ResourceManager::LoadModel(const gfx::Device* device, const scene::ModelCreationDesc& modelCreationDesc)
     {
-        sLoadedModels[modelCreationDesc.modelName] = std::async(utility::ResourceManager::CreateModel, device, modelCreationDesc);
+        sLoadedModels[modelCreationDesc.modelName] = core::JobSystem::Get().ScheduleTask([=]() { return utility::ResourceManager::CreateModel(device, modelCreationDesc); });
     }
 
     std::unique_ptr<scene::Model> ResourceManager::GetLoadedModel(std::wstring_view modelName)
     {
         std::future<std::unique_ptr<scene::Model>> model = std::move(sLoadedModels[modelName.data()]);
-        model.wait();
+        core::JobSystem::Get().Wait(model);
         return std::move(model.get());
     }
 
     void ResourceManager::LoadSkyBox(gfx::Device* const device, const scene::SkyBoxCreationDesc& skyBoxCreationDesc)
 	{
-		sLoadedSkyBox[skyBoxCreationDesc.name] = std::async(utility::ResourceManager::CreateSkyBox, device, skyBoxCreationDesc);
+		sLoadedSkyBox[skyBoxCreationDesc.name] = core::JobSystem::Get().ScheduleTask([=]() { return utility::ResourceManager::CreateSkyBox(device, skyBoxCreationDesc); });
     }
 
     std::unique_ptr<scene::SkyBox> ResourceManager::GetLoadedSkyBox(std::wstring_view skyBoxName)
     {
 		std::future<std::unique_ptr<scene::SkyBox>> skyBox = std::move(sLoadedSkyBox[skyBoxName.data()]);
-        skyBox.wait();
+        core::JobSystem::Get().Wait(skyBox);
 		return std::move(skyBox.get());
     }
 
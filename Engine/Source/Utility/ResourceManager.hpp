@@ -6,7 +6,7 @@
 
 namespace helios::utility
 {
-    // Purely static class that handles creation of all types of resources in a multithreaded way (by default, for now atleast).
+    // Purely static class that handles creation of all types of resources in a multithreaded way (each resource is created by a job of the engine's job system).
     // Use the name (usually passed into the XCreationDesc) to index and get the resource in the unordered_map of any resource type.
 	class ResourceManager
     {
@@ -0,0 +1,98 @@
+#include "HeadlessSandBox.hpp"
+#include "TestSuites.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+// Usage : SandBoxHeadless [--frames N] [--meshes N] [--depth-prepass] [--no-frustum-culling] [--no-shadow-caster-culling] [--no-draw-sorting] [--no-indirect-draws] [--verify] [--benchmark]. Returns a non zero exit code if the null render backend detected invalid commands.
+// --verify only runs the test suites, and --benchmark only the CPU benchmarks (see Tests/TestSuites.hpp).
+int main(int argc, char** argv)
+{
+	HeadlessConfig config{};
+	bool verify{};
+	bool benchmark{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view option(argv[i]);
+
+		if (option == "--verify")
+		{
+			verify = true;
+			continue;
+		}
+
+		if (option == "--benchmark")
+		{
+			benchmark = true;
+			continue;
+		}
+
+		if (option == "--depth-prepass")
+		{
+			config.depthPrePass = true;
+			continue;
+		}
+
+		if (option == "--no-frustum-culling")
+		{
+			config.frustumCulling = false;
+			continue;
+		}
+
+		if (option == "--no-shadow-caster-culling")
+		{
+			config.shadowCasterCulling = false;
+			continue;
+		}
+
+		if (option == "--no-draw-sorting")
+		{
+			config.drawSorting = false;
+			continue;
+		}
+
+		if (option == "--no-indirect-draws")
+		{
+			config.indirectDraws = false;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "Missing value for option : %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+
+		const uint32_t value = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+
+		if (option == "--frames")
+		{
+			config.frameCount = value;
+		}
+		else if (option == "--meshes")
+		{
+			config.meshCount = value;
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown option : %s\n", argv[i - 1]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (verify)
+	{
+		return RunTestSuites() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (benchmark)
+	{
+		return RunBenchmarks() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	HeadlessSandBox sandBox{ config };
+
+	return sandBox.Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
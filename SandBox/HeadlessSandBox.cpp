@@ -0,0 +1,688 @@
+#include "HeadlessSandBox.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace helios;
+
+namespace
+{
+	// The D3D12_RESOURCE_STATES values, as the resource state tracking has to tell the read only states apart.
+	enum ResourceState : uint32_t
+	{
+		Present = 0x0u,
+		RenderTarget = 0x4u,
+		UnorderedAccess = 0x8u,
+		DepthWrite = 0x10u,
+		DepthRead = 0x20u,
+		ShaderResource = 0xC0u,
+		CopyDestination = 0x400u,
+		CopySource = 0x800u,
+	};
+
+	static constexpr uint32_t TRIANGLE_LIST_TOPOLOGY = 4u;
+
+	// Root constants of the passes (the indices of their inputs / outputs, as RenderTargetRenderResources).
+	using PassRenderResources = std::array<uint32_t, 4u>;
+
+	struct FrameTimings
+	{
+		std::vector<double> updateTimes{};
+		std::vector<double> renderTimes{};
+	};
+
+	void PrintTimings(const char* name, std::vector<double>& times)
+	{
+		std::sort(times.begin(), times.end());
+
+		double totalTime{};
+		for (const double time : times)
+		{
+			totalTime += time;
+		}
+
+		const size_t p95Index = std::min(times.size() - 1u, times.size() * 95u / 100u);
+		std::printf("%-8s : avg %.3f ms | p95 %.3f ms | max %.3f ms\n", name, totalTime / static_cast<double>(times.size()), times[p95Index], times.back());
+	}
+}
+
+HeadlessSandBox::HeadlessSandBox(const HeadlessConfig& config)
+	: mConfig(config), mResourceStateRegistry(std::make_shared<gfx::ResourceStateRegistry>())
+{
+	// The synthetic meshes have no occluder meshes, so there is nothing to occlusion cull.
+	mVisibility.mFrustumCullingEnabled = mConfig.frustumCulling;
+	mVisibility.mShadowCasterCullingEnabled = mConfig.shadowCasterCulling;
+	mVisibility.mOcclusionCullingEnabled = false;
+	mVisibility.mDrawSortingEnabled = mConfig.drawSorting;
+
+	CreateObjects();
+	CreateScene();
+}
+
+HeadlessSandBox::~HeadlessSandBox()
+{
+	ReleaseObjects();
+}
+
+bool HeadlessSandBox::Run()
+{
+	FrameTimings frameTimings{};
+
+	for (uint32_t frame = 0u; frame < mConfig.frameCount; ++frame)
+	{
+		const std::chrono::high_resolution_clock::time_point updateStartTime = std::chrono::high_resolution_clock::now();
+
+		UpdateScene(static_cast<float>(frame) / 60.0f);
+
+		const std::chrono::high_resolution_clock::time_point renderStartTime = std::chrono::high_resolution_clock::now();
+
+		RenderFrame();
+
+		const std::chrono::high_resolution_clock::time_point renderEndTime = std::chrono::high_resolution_clock::now();
+
+		frameTimings.updateTimes.push_back(std::chrono::duration<double, std::milli>(renderStartTime - updateStartTime).count());
+		frameTimings.renderTimes.push_back(std::chrono::duration<double, std::milli>(renderEndTime - renderStartTime).count());
+
+		// Only the statistics are of interest over many frames.
+		mBackend.ClearRecordedSubmissions();
+	}
+
+	const gfx::NullRenderBackendStatistics backendStatistics = mBackend.GetStatistics();
+	const gfx::QueueSchedulerStatistics queueSchedulerStatistics = mQueueScheduler.GetStatistics();
+
+	std::printf("Headless SandBox : %u frames, %u meshes, depth pre-pass %s, frustum culling %s, shadow caster culling %s, draw sorting %s, indirect draws %s, %u job system workers\n",
+		mConfig.frameCount, mConfig.meshCount, mConfig.depthPrePass ? "on" : "off", mConfig.frustumCulling ? "on" : "off", mConfig.shadowCasterCulling ? "on" : "off",
+		mConfig.drawSorting ? "on" : "off", mConfig.indirectDraws ? "on" : "off", core::JobSystem::Get().GetWorkerCount());
+
+	const auto perFrameCount = [&](uint64_t count) { return static_cast<double>(count) / static_cast<double>(std::max(mConfig.frameCount, 1u)); };
+
+	std::printf("Visible meshes per frame : %.1f (%s culling)\n", perFrameCount(mVisibleMeshCount),
+		scene::CullingImplementationToString(scene::ResolveCullingImplementation(scene::CullingImplementation::Best)));
+	std::printf("Shadow casters per frame : %.1f rendered | %.1f outside the light frustum | %.1f without visible receivers\n",
+		perFrameCount(mShadowCasterCullingStatistics.visibleCount), perFrameCount(mShadowCasterCullingStatistics.outsideLightFrustumCount),
+		perFrameCount(mShadowCasterCullingStatistics.noVisibleReceiverCount));
+	std::printf("Material changes per frame : %.1f (camera draws)\n", perFrameCount(mMaterialChangeCount));
+
+	if (mConfig.frameCount != 0u)
+	{
+		PrintTimings("Update", frameTimings.updateTimes);
+		PrintTimings("Render", frameTimings.renderTimes);
+	}
+
+	std::printf("Recorded commands : %llu (%llu filtered, %.1f KB) | Submissions : %llu | GPU queue waits : %llu (%llu skipped)\n",
+		static_cast<unsigned long long>(mCommandStreamStatistics.recordedCommandCount), static_cast<unsigned long long>(mCommandStreamStatistics.filteredCommandCount),
+		static_cast<double>(mCommandStreamStatistics.recordedByteSize) / 1024.0, static_cast<unsigned long long>(backendStatistics.submissionCount),
+		static_cast<unsigned long long>(backendStatistics.queueWaitCount), static_cast<unsigned long long>(queueSchedulerStatistics.skippedWaitCount));
+
+	for (uint32_t commandType = 0u; commandType < gfx::COMMAND_TYPE_COUNT; ++commandType)
+	{
+		std::printf("  %-20s : %llu\n", gfx::CommandTypeToString(static_cast<gfx::CommandType>(commandType)), static_cast<unsigned long long>(backendStatistics.commandCounts[commandType]));
+	}
+
+	const gfx::ResourceBarrierStatistics& barrierStatistics = mCommandStreamStatistics.resourceBarrierStatistics;
+	const auto perFrame = [&](uint64_t count) { return static_cast<double>(count) / static_cast<double>(std::max(mConfig.frameCount, 1u)); };
+
+	std::printf("Resource barriers per frame : %.1f transitions (%.1f split, %.1f resolved) | %.1f UAV | %.1f aliasing | %.1f batches | %.1f redundant, %.1f merged, %.1f corrected\n",
+		perFrame(barrierStatistics.transitionCount), perFrame(barrierStatistics.splitTransitionCount), perFrame(barrierStatistics.resolvedTransitionCount),
+		perFrame(barrierStatistics.uavBarrierCount), perFrame(barrierStatistics.aliasingBarrierCount), perFrame(barrierStatistics.barrierBatchCount),
+		perFrame(barrierStatistics.redundantTransitionCount), perFrame(barrierStatistics.mergedTransitionCount), perFrame(barrierStatistics.correctedTransitionCount));
+
+	std::printf("Invalid handles : %llu | Invalid waits : %llu | Invalid barriers : %llu\n", static_cast<unsigned long long>(backendStatistics.invalidHandleCount),
+		static_cast<unsigned long long>(backendStatistics.invalidWaitCount), static_cast<unsigned long long>(backendStatistics.invalidBarrierCount));
+
+	return backendStatistics.invalidHandleCount == 0u && backendStatistics.invalidWaitCount == 0u && backendStatistics.invalidBarrierCount == 0u;
+}
+
+void HeadlessSandBox::CreateObjects()
+{
+	mDescriptorHeaps[0] = mBackend.CreateObject(gfx::BackendObjectType::DescriptorHeap, "SRV_CBV_UAV Descriptor Heap");
+	mDescriptorHeaps[1] = mBackend.CreateObject(gfx::BackendObjectType::DescriptorHeap, "Sampler Descriptor Heap");
+	mRootSignature = mBackend.CreateObject(gfx::BackendObjectType::RootSignature, "Bindless Root Signature");
+
+	mShadowPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Shadow Pipeline State");
+	mDeferredGeometryPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Deferred Geometry Pipeline State");
+	mDepthPrePassPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Depth Pre Pass Pipeline State");
+	mDepthPrePassDeferredGeometryPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Deferred Geometry Depth Pre Pass Pipeline State");
+	mLightingPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Lighting Pipeline State");
+	mBloomPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Bloom Pipeline State");
+	mPostProcessingPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Post Processing Pipeline State");
+	mFinalPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Final Pipeline State");
+	mSkyBoxPipelineState = mBackend.CreateObject(gfx::BackendObjectType::PipelineState, "Sky Box Pipeline State");
+
+	mIndirectDrawCommandSignature = mBackend.CreateObject(gfx::BackendObjectType::CommandSignature, "Indirect Draw Command Signature");
+	for (uint32_t i = 0u; i < static_cast<uint32_t>(mIndirectArgumentBuffers.size()); ++i)
+	{
+		mIndirectArgumentBuffers[i] = mBackend.CreateObject(gfx::BackendObjectType::Buffer, "Indirect Draw Argument Buffer " + std::to_string(i));
+	}
+
+	mShadowDepthTexture = CreateRenderTarget("Shadow Depth Texture", gfx::BackendObjectType::DepthStencilView, DepthWrite);
+	mDepthStencilTexture = CreateRenderTarget("Depth Stencil Texture", gfx::BackendObjectType::DepthStencilView, DepthWrite);
+	mReadOnlyDepthStencilView = mBackend.CreateObject(gfx::BackendObjectType::DepthStencilView, "Depth Stencil Texture Read Only View");
+
+	for (uint32_t i = 0u; i < static_cast<uint32_t>(mGBuffer.size()); ++i)
+	{
+		mGBuffer[i] = CreateRenderTarget("GBuffer " + std::to_string(i), gfx::BackendObjectType::RenderTargetView, ShaderResource);
+	}
+
+	mOffscreenRT = CreateRenderTarget("Offscreen RT", gfx::BackendObjectType::RenderTargetView, ShaderResource);
+	mBloomTexture = mBackend.CreateObject(gfx::BackendObjectType::Texture, "Bloom Texture");
+	mBloomTextureResourceState = mResourceStateRegistry->RegisterResource(mBloomTexture, UnorderedAccess);
+	mPostProcessingRT = CreateRenderTarget("Post Processing RT", gfx::BackendObjectType::RenderTargetView, ShaderResource);
+	mFinalRT = CreateRenderTarget("Final RT", gfx::BackendObjectType::RenderTargetView, ShaderResource);
+
+	for (uint32_t i = 0u; i < BACK_BUFFER_COUNT; ++i)
+	{
+		mBackBuffers[i] = CreateRenderTarget("Back Buffer " + std::to_string(i), gfx::BackendObjectType::RenderTargetView, Present);
+	}
+}
+
+void HeadlessSandBox::CreateScene()
+{
+	mMeshes.reserve(mConfig.meshCount);
+	mTransforms.resize(mConfig.meshCount);
+
+	for (uint32_t i = 0u; i < mConfig.meshCount; ++i)
+	{
+		const float halfExtent = 0.5f + static_cast<float>(i % 7u) * 0.25f;
+
+		mMeshes.push_back(Mesh
+		{
+			.indexBuffer = mBackend.CreateObject(gfx::BackendObjectType::Buffer, "Mesh Index Buffer " + std::to_string(i)),
+			.indicesCount = 3u * (64u + (i * 7919u) % 4096u),
+			.transformIndex = i,
+			.materialIndex = i % 32u,
+		});
+
+		// Note : The meshes share the materials of the scene (rather than each model having its own), so the models add no materials and the material index
+		// is the sort key of the mesh's material as is.
+		const std::array<scene::VisibilityMesh, 1u> visibilityMeshes
+		{
+			scene::VisibilityMesh
+			{
+				.boundingBox = { .minimum = { -0.5f - halfExtent, -halfExtent, -halfExtent }, .maximum = { 0.5f + halfExtent, halfExtent, halfExtent } },
+				.materialIndex = mMeshes.back().materialIndex,
+			},
+		};
+
+		mVisibility.AddModel(visibilityMeshes, 0u);
+	}
+}
+
+void HeadlessSandBox::ReleaseObjects()
+{
+	for (const Mesh& mesh : mMeshes)
+	{
+		mBackend.ReleaseObject(mesh.indexBuffer);
+	}
+
+	const auto releaseRenderTarget = [&](const RenderTarget& renderTarget)
+	{
+		mBackend.ReleaseObject(renderTarget.texture);
+		mBackend.ReleaseObject(renderTarget.view);
+	};
+
+	for (const RenderTarget& renderTarget : mBackBuffers)
+	{
+		releaseRenderTarget(renderTarget);
+	}
+
+	for (const RenderTarget& renderTarget : mGBuffer)
+	{
+		releaseRenderTarget(renderTarget);
+	}
+
+	releaseRenderTarget(mShadowDepthTexture);
+	releaseRenderTarget(mDepthStencilTexture);
+	releaseRenderTarget(mOffscreenRT);
+	releaseRenderTarget(mPostProcessingRT);
+	releaseRenderTarget(mFinalRT);
+
+	for (const gfx::CommandHandle indirectArgumentBuffer : mIndirectArgumentBuffers)
+	{
+		mBackend.ReleaseObject(indirectArgumentBuffer);
+	}
+
+	for (const gfx::CommandHandle handle : { mBloomTexture, mReadOnlyDepthStencilView, mShadowPipelineState, mDeferredGeometryPipelineState, mDepthPrePassPipelineState,
+		mDepthPrePassDeferredGeometryPipelineState, mLightingPipelineState, mBloomPipelineState, mPostProcessingPipelineState, mFinalPipelineState, mSkyBoxPipelineState,
+		mIndirectDrawCommandSignature, mRootSignature, mDescriptorHeaps[0], mDescriptorHeaps[1] })
+	{
+		mBackend.ReleaseObject(handle);
+	}
+}
+
+void HeadlessSandBox::UpdateScene(float time)
+{
+	// Same work split as Scene::Update : the model matrices are computed in parallel batches.
+	core::JobSystem::Get().ParallelFor(mConfig.meshCount, 256u, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const float angle = time + static_cast<float>(i) * 0.01f;
+			const float sinAngle = std::sin(angle);
+			const float cosAngle = std::cos(angle);
+
+			mTransforms[i] = Matrix
+			{
+				cosAngle, 0.0f, -sinAngle, 0.0f,
+				0.0f, 1.0f, 0.0f, 0.0f,
+				sinAngle, 0.0f, cosAngle, 0.0f,
+				static_cast<float>(i % 64u) * 4.0f, 0.0f, static_cast<float>(i / 64u) * 4.0f, 1.0f,
+			};
+		}
+	});
+
+	// The camera turns around the center of the grid of meshes.
+	const float gridCenterZ = static_cast<float>((mConfig.meshCount + 63u) / 64u) * 2.0f;
+	const float yaw = time * 0.5f;
+
+	mViewProjectionMatrix = scene::MultiplyMatrices(scene::CreateLookToMatrix({ 128.0f, 8.0f, gridCenterZ }, { std::sin(yaw), 0.0f, std::cos(yaw) }),
+		scene::CreatePerspectiveMatrix(0.785398f, static_cast<float>(mConfig.width) / static_cast<float>(mConfig.height), 0.1f, 1000.0f));
+
+	// Same setup as ShadowPass : an orthographic projection centered on the grid, backed off along the light direction. The shadow map covers part of the grid.
+	mLightDirection = { 0.4f, -1.0f, 0.3f };
+	const float lightDirectionLength = std::sqrt(mLightDirection[0] * mLightDirection[0] + mLightDirection[1] * mLightDirection[1] + mLightDirection[2] * mLightDirection[2]);
+	const scene::Float3 lightPosition
+	{
+		128.0f - mLightDirection[0] / lightDirectionLength * 200.0f, -mLightDirection[1] / lightDirectionLength * 200.0f, gridCenterZ - mLightDirection[2] / lightDirectionLength * 200.0f,
+	};
+
+	mLightViewProjectionMatrix = scene::MultiplyMatrices(scene::CreateLookToMatrix(lightPosition, mLightDirection), scene::CreateOrthographicMatrix(90.0f, 1.0f, 370.0f));
+}
+
+void HeadlessSandBox::RenderFrame()
+{
+	const RenderTarget& backBuffer = mBackBuffers[mFrameNumber % BACK_BUFFER_COUNT];
+
+	mVisibility.CullMeshes(mTransforms, mViewProjectionMatrix);
+	mVisibility.CullShadowCasters(mLightViewProjectionMatrix, mLightDirection);
+
+	mVisibleMeshCount += mVisibility.mVisibleMeshDrawCount;
+
+	const scene::ShadowCasterCullingStatistics& shadowCasterCullingStatistics = mVisibility.mShadowCasterCullingStatistics;
+	mShadowCasterCullingStatistics.casterCount += shadowCasterCullingStatistics.casterCount;
+	mShadowCasterCullingStatistics.outsideLightFrustumCount += shadowCasterCullingStatistics.outsideLightFrustumCount;
+	mShadowCasterCullingStatistics.noVisibleReceiverCount += shadowCasterCullingStatistics.noVisibleReceiverCount;
+	mShadowCasterCullingStatistics.visibleCount += shadowCasterCullingStatistics.visibleCount;
+
+	// Renderpass -1 : Shadow pass.
+	std::vector<std::unique_ptr<gfx::CommandStream>> graphicsCommandStreams1{};
+	graphicsCommandStreams1.push_back(std::make_unique<gfx::CommandStream>());
+
+	BeginPass(*graphicsCommandStreams1.back(), gfx::PipelineBindPoint::Graphics, mShadowPipelineState);
+	graphicsCommandStreams1.back()->TransitionResource(mShadowDepthTexture.texture, DepthWrite);
+	graphicsCommandStreams1.back()->Record(gfx::ClearDepthStencilCommand{ .depthStencil = mShadowDepthTexture.view, .depth = 1.0f });
+
+	mVisibility.BuildShadowDrawPackets();
+	RecordMeshes(graphicsCommandStreams1, mShadowPipelineState, {}, mShadowDepthTexture.view, SHADOW_MAP_DIMENSION, SHADOW_MAP_DIMENSION);
+
+	// Renderpass 0 : Deferred Geometry pass.
+	graphicsCommandStreams1.push_back(std::make_unique<gfx::CommandStream>());
+	BeginPass(*graphicsCommandStreams1.back(), gfx::PipelineBindPoint::Graphics, mDeferredGeometryPipelineState);
+
+	for (const RenderTarget& renderTarget : mGBuffer)
+	{
+		graphicsCommandStreams1.back()->TransitionResource(renderTarget.texture, ResourceState::RenderTarget);
+		graphicsCommandStreams1.back()->Record(gfx::ClearRenderTargetCommand{ .renderTarget = renderTarget.view });
+	}
+
+	graphicsCommandStreams1.back()->TransitionResource(mDepthStencilTexture.texture, DepthWrite);
+	graphicsCommandStreams1.back()->Record(gfx::ClearDepthStencilCommand{ .depthStencil = mDepthStencilTexture.view, .depth = 1.0f });
+
+	const gfx::CommandHandle deferredGeometryPipelineState = mConfig.depthPrePass ? mDepthPrePassDeferredGeometryPipelineState : mDeferredGeometryPipelineState;
+
+	if (mConfig.indirectDraws)
+	{
+		// As DeferredGeometryPass : both passes are recorded into the stream of the clears.
+		BuildIndirectDraws();
+
+		if (mConfig.depthPrePass)
+		{
+			RecordIndirectMeshes(*graphicsCommandStreams1.back(), mDepthPrePassPipelineState, {}, mDepthStencilTexture.view, mConfig.width, mConfig.height);
+		}
+
+		RecordIndirectMeshes(*graphicsCommandStreams1.back(), deferredGeometryPipelineState, mGBuffer, mDepthStencilTexture.view, mConfig.width, mConfig.height);
+	}
+	else
+	{
+		// As Scene::RenderModels : the packets are built per pass.
+		if (mConfig.depthPrePass)
+		{
+			mVisibility.BuildCameraDrawPackets();
+			RecordMeshes(graphicsCommandStreams1, mDepthPrePassPipelineState, {}, mDepthStencilTexture.view, mConfig.width, mConfig.height);
+		}
+
+		mVisibility.BuildCameraDrawPackets();
+		RecordMeshes(graphicsCommandStreams1, deferredGeometryPipelineState, mGBuffer, mDepthStencilTexture.view, mConfig.width, mConfig.height);
+	}
+
+	mMaterialChangeCount += mVisibility.mDrawSortStateChanges.materialChangeCount;
+
+	// Renderpass 1 : Deferred lighting pass, then the sky box, depth tested against the depth of the deferred geometry pass through a read only DSV.
+	// The shadow map was rendered by other streams : its transition is resolved on submission.
+	graphicsCommandStreams1.push_back(std::make_unique<gfx::CommandStream>());
+	gfx::CommandStream& lightingCommandStream = *graphicsCommandStreams1.back();
+
+	BeginPass(lightingCommandStream, gfx::PipelineBindPoint::Graphics, mLightingPipelineState);
+
+	for (const RenderTarget& renderTarget : mGBuffer)
+	{
+		lightingCommandStream.TransitionResource(renderTarget.texture, ShaderResource);
+	}
+
+	lightingCommandStream.TransitionResource(mShadowDepthTexture.texture, ShaderResource);
+	lightingCommandStream.TransitionResource(mOffscreenRT.texture, ResourceState::RenderTarget);
+
+	lightingCommandStream.Record(gfx::SetRenderTargetsCommand{ .renderTargetCount = 1u, .renderTargets = { mOffscreenRT.view } });
+	lightingCommandStream.Record(gfx::SetViewportCommand{ .width = static_cast<float>(mConfig.width), .height = static_cast<float>(mConfig.height), .maxDepth = 1.0f });
+	lightingCommandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, PassRenderResources{});
+	lightingCommandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+
+	lightingCommandStream.TransitionResource(mDepthStencilTexture.texture, DepthRead);
+
+	lightingCommandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = mSkyBoxPipelineState });
+	lightingCommandStream.Record(gfx::SetRenderTargetsCommand{ .renderTargetCount = 1u, .renderTargets = { mOffscreenRT.view }, .depthStencil = mReadOnlyDepthStencilView });
+	lightingCommandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, PassRenderResources{});
+	lightingCommandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 36u, .instanceCount = 1u });
+
+	lightingCommandStream.TransitionResource(mOffscreenRT.texture, ShaderResource);
+
+	const std::array<gfx::QueueSubmission, 1u> lightingSubmission
+	{
+		Submit(gfx::QueueType::Graphics, graphicsCommandStreams1, {}),
+	};
+
+	// Render pass 1.5 : Bloom pass (on the compute queue, once the lighting pass is done). Each dispatch downsamples the previous mip into the next one.
+	std::vector<std::unique_ptr<gfx::CommandStream>> bloomCommandStreams{};
+	bloomCommandStreams.push_back(std::make_unique<gfx::CommandStream>());
+	gfx::CommandStream& bloomCommandStream = *bloomCommandStreams.back();
+
+	BeginPass(bloomCommandStream, gfx::PipelineBindPoint::Compute, mBloomPipelineState);
+
+	for (uint32_t mipLevel = 0u; mipLevel < BLOOM_MIP_LEVELS; ++mipLevel)
+	{
+		if (mipLevel != 0u)
+		{
+			bloomCommandStream.TransitionResource(mBloomTexture, ShaderResource, mipLevel - 1u, BLOOM_MIP_LEVELS);
+		}
+
+		bloomCommandStream.TransitionResource(mBloomTexture, UnorderedAccess, mipLevel, BLOOM_MIP_LEVELS);
+
+		const PassRenderResources bloomRenderResources{ mipLevel };
+		bloomCommandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Compute }, bloomRenderResources);
+		bloomCommandStream.Record(gfx::DispatchCommand
+		{
+			.threadGroupCountX = std::max((mConfig.width >> (mipLevel + 1u)) / 8u, 1u),
+			.threadGroupCountY = std::max((mConfig.height >> (mipLevel + 1u)) / 8u, 1u),
+			.threadGroupCountZ = 1u,
+		});
+	}
+
+	bloomCommandStream.TransitionResource(mBloomTexture, ShaderResource);
+
+	const std::array<gfx::QueueSubmission, 1u> bloomSubmission
+	{
+		Submit(gfx::QueueType::Compute, bloomCommandStreams, lightingSubmission),
+	};
+
+	// Render pass 2 / 3 : Post processing and final (sharing a stream), and copy to the back buffer.
+	std::vector<std::unique_ptr<gfx::CommandStream>> graphicsCommandStreams2{};
+	graphicsCommandStreams2.push_back(std::make_unique<gfx::CommandStream>());
+	gfx::CommandStream& fullscreenCommandStream = *graphicsCommandStreams2.back();
+
+	const std::array<std::pair<gfx::CommandHandle, const RenderTarget*>, 2u> fullscreenPasses
+	{
+		std::pair{ mPostProcessingPipelineState, &mPostProcessingRT },
+		std::pair{ mFinalPipelineState, &mFinalRT },
+	};
+
+	for (size_t i = 0u; i < fullscreenPasses.size(); ++i)
+	{
+		const auto& [pipelineState, renderTarget] = fullscreenPasses[i];
+
+		BeginPass(fullscreenCommandStream, gfx::PipelineBindPoint::Graphics, pipelineState);
+
+		fullscreenCommandStream.TransitionResource(renderTarget->texture, ResourceState::RenderTarget);
+
+		fullscreenCommandStream.Record(gfx::SetRenderTargetsCommand{ .renderTargetCount = 1u, .renderTargets = { renderTarget->view } });
+		fullscreenCommandStream.Record(gfx::SetViewportCommand{ .width = static_cast<float>(mConfig.width), .height = static_cast<float>(mConfig.height), .maxDepth = 1.0f });
+		fullscreenCommandStream.Record(gfx::ClearRenderTargetCommand{ .renderTarget = renderTarget->view });
+
+		// The inputs are transitioned after the clear, so the (split) transition of the previous pass' output overlaps with it.
+		fullscreenCommandStream.TransitionResource(mBloomTexture, ShaderResource);
+		if (i != 0u)
+		{
+			fullscreenCommandStream.TransitionResource(fullscreenPasses[i - 1u].second->texture, ShaderResource);
+		}
+
+		fullscreenCommandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, PassRenderResources{});
+		fullscreenCommandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+
+		if (i + 1u < fullscreenPasses.size())
+		{
+			fullscreenCommandStream.BeginResourceTransition(renderTarget->texture, ShaderResource);
+		}
+	}
+
+	graphicsCommandStreams2.push_back(std::make_unique<gfx::CommandStream>());
+	gfx::CommandStream& copyCommandStream = *graphicsCommandStreams2.back();
+
+	copyCommandStream.TransitionResource(mFinalRT.texture, CopySource);
+	copyCommandStream.TransitionResource(backBuffer.texture, CopyDestination);
+	copyCommandStream.Record(gfx::CopyResourceCommand{ .destination = backBuffer.texture, .source = mFinalRT.texture });
+	copyCommandStream.TransitionResource(backBuffer.texture, Present);
+
+	Submit(gfx::QueueType::Graphics, graphicsCommandStreams2, bloomSubmission);
+
+	// Present : at most MAX_FRAME_LATENCY frames are in flight (see Device::Present).
+	mFrameNumber++;
+
+	if (mFrameNumber > MAX_FRAME_LATENCY)
+	{
+		const gfx::QueueScheduler::FenceValues& completedFrameFenceValues = mFrameFenceValues[(mFrameNumber - MAX_FRAME_LATENCY - 1u) % mFrameFenceValues.size()];
+
+		for (uint32_t queueIndex = 0u; queueIndex < gfx::QUEUE_TYPE_COUNT; ++queueIndex)
+		{
+			mBackend.WaitForFenceValue(static_cast<gfx::QueueType>(queueIndex), completedFrameFenceValues[queueIndex]);
+		}
+	}
+
+	mQueueScheduler.SetCompletedFenceValues(
+	{
+		mBackend.GetCompletedFenceValue(gfx::QueueType::Graphics),
+		mBackend.GetCompletedFenceValue(gfx::QueueType::Compute),
+		mBackend.GetCompletedFenceValue(gfx::QueueType::Copy),
+	});
+}
+
+void HeadlessSandBox::RecordMeshes(std::vector<std::unique_ptr<gfx::CommandStream>>& commandStreams, gfx::CommandHandle pipelineState,
+	std::span<const RenderTarget> renderTargets, gfx::CommandHandle depthStencilView, uint32_t viewportWidth, uint32_t viewportHeight)
+{
+	const uint32_t commandStreamCount = (static_cast<uint32_t>(mVisibility.GetDrawPackets().size()) + MESHES_PER_COMMAND_STREAM - 1u) / MESHES_PER_COMMAND_STREAM;
+	const size_t firstCommandStreamIndex = commandStreams.size();
+
+	for (uint32_t i = 0u; i < commandStreamCount; ++i)
+	{
+		commandStreams.push_back(std::make_unique<gfx::CommandStream>());
+	}
+
+	gfx::SetRenderTargetsCommand setRenderTargetsCommand
+	{
+		.renderTargetCount = static_cast<uint32_t>(renderTargets.size()),
+		.isSingleHandleToDescriptorRange = 1u,
+		.depthStencil = depthStencilView,
+	};
+
+	for (uint32_t i = 0u; i < setRenderTargetsCommand.renderTargetCount; ++i)
+	{
+		setRenderTargetsCommand.renderTargets[i] = renderTargets[i].view;
+	}
+
+	mVisibility.RecordInParallel(commandStreamCount, [&](uint32_t commandStreamIndex)
+	{
+		gfx::CommandStream& commandStream = *commandStreams[firstCommandStreamIndex + commandStreamIndex];
+
+		BeginPass(commandStream, gfx::PipelineBindPoint::Graphics, pipelineState);
+
+		commandStream.Record(setRenderTargetsCommand);
+		commandStream.Record(gfx::SetViewportCommand{ .width = static_cast<float>(viewportWidth), .height = static_cast<float>(viewportHeight), .maxDepth = 1.0f });
+		commandStream.Record(gfx::SetPrimitiveTopologyCommand{ .primitiveTopology = TRIANGLE_LIST_TOPOLOGY });
+	},
+	[&](uint32_t commandStreamIndex, const scene::MeshDrawLocation& meshDrawLocation)
+	{
+		gfx::CommandStream& commandStream = *commandStreams[firstCommandStreamIndex + commandStreamIndex];
+
+		// The models have a single mesh, so the model index is the index of the mesh.
+		const Mesh& mesh = mMeshes[meshDrawLocation.modelIndex];
+
+		const std::array<uint32_t, 2u> meshRenderResources{ mesh.transformIndex, mesh.materialIndex };
+
+		commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = mesh.indexBuffer, .sizeInBytes = mesh.indicesCount * 4u });
+		commandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, meshRenderResources);
+		commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = mesh.indicesCount, .instanceCount = 1u });
+	});
+}
+
+void HeadlessSandBox::BuildIndirectDraws()
+{
+	// The models have a single mesh, so the model index is the index of the mesh.
+	mVisibility.BuildIndirectDraws(mIndirectDrawStream, mIndirectDrawBounds, [&](gfx::IndirectDrawStream& indirectDrawStream, const scene::MeshDrawLocation& meshDrawLocation)
+	{
+		const Mesh& mesh = mMeshes[meshDrawLocation.modelIndex];
+
+		DrawData drawData{};
+		drawData[0] = mesh.transformIndex;
+		drawData[1] = mesh.materialIndex;
+
+		indirectDrawStream.AddDraw(gfx::IndexBufferView{ .bufferLocation = mesh.indexBuffer, .sizeInBytes = mesh.indicesCount * 4u },
+			gfx::DrawIndexedArguments{ .indexCountPerInstance = mesh.indicesCount, .instanceCount = 1u }, drawData);
+	});
+
+	// Same copies as IndirectDrawBuffer::Upload.
+	const std::span<const gfx::IndirectDrawArguments> arguments = mIndirectDrawStream.GetArguments();
+	const std::span<const std::byte> drawData = mIndirectDrawStream.GetDrawData();
+
+	mIndirectDrawUploadMemory.resize(std::max(mIndirectDrawUploadMemory.size(), arguments.size_bytes() + drawData.size_bytes()));
+
+	if (!arguments.empty())
+	{
+		std::memcpy(mIndirectDrawUploadMemory.data(), arguments.data(), arguments.size_bytes());
+		std::memcpy(mIndirectDrawUploadMemory.data() + arguments.size_bytes(), drawData.data(), drawData.size_bytes());
+	}
+}
+
+void HeadlessSandBox::RecordIndirectMeshes(gfx::CommandStream& commandStream, gfx::CommandHandle pipelineState, std::span<const RenderTarget> renderTargets,
+	gfx::CommandHandle depthStencilView, uint32_t viewportWidth, uint32_t viewportHeight)
+{
+	gfx::SetRenderTargetsCommand setRenderTargetsCommand
+	{
+		.renderTargetCount = static_cast<uint32_t>(renderTargets.size()),
+		.isSingleHandleToDescriptorRange = 1u,
+		.depthStencil = depthStencilView,
+	};
+
+	for (uint32_t i = 0u; i < setRenderTargetsCommand.renderTargetCount; ++i)
+	{
+		setRenderTargetsCommand.renderTargets[i] = renderTargets[i].view;
+	}
+
+	commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = pipelineState });
+	commandStream.Record(setRenderTargetsCommand);
+	commandStream.Record(gfx::SetViewportCommand{ .width = static_cast<float>(viewportWidth), .height = static_cast<float>(viewportHeight), .maxDepth = 1.0f });
+	commandStream.Record(gfx::SetPrimitiveTopologyCommand{ .primitiveTopology = TRIANGLE_LIST_TOPOLOGY });
+
+	// There are no descriptors, so the draw data buffer index is 0.
+	gfx::RecordIndirectDraws(commandStream, 0u, gfx::ExecuteIndirectCommand
+	{
+		.commandSignature = mIndirectDrawCommandSignature,
+		.maxCommandCount = mIndirectDrawStream.GetDrawCount(),
+		.argumentBuffer = mIndirectArgumentBuffers[mFrameNumber % mIndirectArgumentBuffers.size()],
+	});
+}
+
+void HeadlessSandBox::BeginPass(gfx::CommandStream& commandStream, gfx::PipelineBindPoint bindPoint, gfx::CommandHandle pipelineState) const
+{
+	commandStream.Record(gfx::SetDescriptorHeapsCommand{ .descriptorHeapCount = 2u, .descriptorHeaps = mDescriptorHeaps });
+	commandStream.Record(gfx::SetRootSignatureCommand{ .bindPoint = bindPoint, .rootSignature = mRootSignature });
+	commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = pipelineState });
+}
+
+gfx::QueueSubmission HeadlessSandBox::Submit(gfx::QueueType queueType, std::span<const std::unique_ptr<gfx::CommandStream>> commandStreams, std::span<const gfx::QueueSubmission> dependencies)
+{
+	std::vector<gfx::CommandStream*> resolvedCommandStreams{};
+	for (const std::unique_ptr<gfx::CommandStream>& commandStream : commandStreams)
+	{
+		commandStream->EndResourceTransitions();
+		resolvedCommandStreams.push_back(commandStream.get());
+	}
+
+	const gfx::ResolvedTransitions resolvedTransitions = mResourceStateRegistry->ResolvePendingTransitions(queueType, resolvedCommandStreams);
+
+	// As Device::ExecuteContexts : the transitions the compute / copy queue cannot execute are executed on the graphics queue first.
+	std::vector<gfx::QueueSubmission> submissionDependencies(dependencies.begin(), dependencies.end());
+	if (!resolvedTransitions.graphicsPrologueBarriers.empty())
+	{
+		gfx::CommandStream graphicsPrologueCommandStream{};
+		graphicsPrologueCommandStream.RecordResolvedBarriers(resolvedTransitions.graphicsPrologueBarriers);
+		mCommandStreamStatistics += graphicsPrologueCommandStream.GetStatistics();
+
+		const std::array<const gfx::CommandStream*, 1u> graphicsPrologueCommandStreams{ &graphicsPrologueCommandStream };
+
+		const gfx::QueueSubmission graphicsPrologueSubmission
+		{
+			.queueType = gfx::QueueType::Graphics,
+			.fenceValue = mBackend.ExecuteCommandStreams(gfx::QueueType::Graphics, graphicsPrologueCommandStreams, {}),
+		};
+
+		mQueueScheduler.RecordSignal(gfx::QueueType::Graphics, graphicsPrologueSubmission.fenceValue);
+		mFrameFenceValues[mFrameNumber % mFrameFenceValues.size()][static_cast<uint32_t>(gfx::QueueType::Graphics)] = graphicsPrologueSubmission.fenceValue;
+
+		submissionDependencies.push_back(graphicsPrologueSubmission);
+	}
+
+	gfx::CommandStream prologueCommandStream{};
+	prologueCommandStream.RecordResolvedBarriers(resolvedTransitions.prologueBarriers);
+
+	std::vector<const gfx::CommandStream*> commandStreamPointers{};
+	if (!prologueCommandStream.IsEmpty())
+	{
+		commandStreamPointers.push_back(&prologueCommandStream);
+		mCommandStreamStatistics += prologueCommandStream.GetStatistics();
+	}
+
+	for (const std::unique_ptr<gfx::CommandStream>& commandStream : commandStreams)
+	{
+		commandStreamPointers.push_back(commandStream.get());
+		mCommandStreamStatistics += commandStream->GetStatistics();
+	}
+
+	const std::vector<gfx::QueueWait> queueWaits = mQueueScheduler.ResolveDependencies(queueType, submissionDependencies);
+
+	const gfx::QueueSubmission queueSubmission
+	{
+		.queueType = queueType,
+		.fenceValue = mBackend.ExecuteCommandStreams(queueType, commandStreamPointers, queueWaits),
+	};
+
+	mQueueScheduler.RecordSignal(queueType, queueSubmission.fenceValue);
+	mFrameFenceValues[mFrameNumber % mFrameFenceValues.size()][static_cast<uint32_t>(queueType)] = queueSubmission.fenceValue;
+
+	return queueSubmission;
+}
+
+HeadlessSandBox::RenderTarget HeadlessSandBox::CreateRenderTarget(std::string_view name, gfx::BackendObjectType viewType, uint32_t initialState)
+{
+	const std::string textureName(name);
+	const gfx::CommandHandle texture = mBackend.CreateObject(gfx::BackendObjectType::Texture, textureName);
+
+	return RenderTarget
+	{
+		.texture = texture,
+		.view = mBackend.CreateObject(viewType, textureName + " View"),
+		.resourceState = mResourceStateRegistry->RegisterResource(texture, initialState),
+	};
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Core/JobSystem.hpp"
+#include "Graphics/API/CommandStream.hpp"
+#include "Graphics/API/IndirectDraw.hpp"
+#include "Graphics/API/NullRenderBackend.hpp"
+#include "Graphics/API/QueueScheduler.hpp"
+#include "Graphics/API/ResourceStateTracker.hpp"
+#include "Scene/SceneVisibility.hpp"
+
+struct HeadlessConfig
+{
+	uint32_t frameCount{ 600u };
+	uint32_t meshCount{ 4096u };
+
+	uint32_t width{ 1920u };
+	uint32_t height{ 1080u };
+
+	// See DeferredGeometryPass : the meshes are recorded twice (depth only, then the G-Buffer with an EQUAL depth test).
+	bool depthPrePass{ false };
+
+	// See SceneVisibility::CullMeshes : the meshes outside of the camera frustum are not recorded by the camera passes.
+	bool frustumCulling{ true };
+
+	// See SceneVisibility::CullShadowCasters.
+	bool shadowCasterCulling{ true };
+
+	// See SceneVisibility::BuildCameraDrawPackets : the draws are recorded by material, front to back.
+	bool drawSorting{ true };
+
+	// See Scene::BuildIndirectDraws : the draws of the deferred geometry pass (and depth pre-pass) are built once, and executed by a single ExecuteIndirect per pass
+	// (rather than recorded into parallel streams).
+	bool indirectDraws{ true };
+};
+
+// Runs the CPU side of SandBox's frame against the null render backend, without a window or GPU : the scene update, the parallel recording of the
+// shadow and deferred geometry passes (with the optional depth pre-pass), the lighting / async bloom / post processing passes, and their submission with
+// cross queue dependencies.
+// The scene is synthetic (meshCount meshes with unique index buffers), so the CPU cost can be tracked for a fixed workload (i.e as a CI performance regression).
+// The culling and draw sorting are the Scene's own (see scene::SceneVisibility), with a model per mesh.
+class HeadlessSandBox
+{
+public:
+	explicit HeadlessSandBox(const HeadlessConfig& config);
+	~HeadlessSandBox();
+
+	HeadlessSandBox(const HeadlessSandBox& other) = delete;
+	HeadlessSandBox& operator=(const HeadlessSandBox& other) = delete;
+
+	// Renders config.frameCount frames and prints the timings / recorded command statistics.
+	// Returns false if the backend found commands referring to invalid objects, invalid cross queue waits, or barriers from states resources are not in.
+	bool Run();
+
+private:
+	struct Mesh
+	{
+		helios::gfx::CommandHandle indexBuffer{};
+		uint32_t indicesCount{};
+		uint32_t transformIndex{};
+		uint32_t materialIndex{};
+	};
+
+	struct RenderTarget
+	{
+		helios::gfx::CommandHandle texture{};
+		helios::gfx::CommandHandle view{};
+		helios::gfx::ResourceStateHandle resourceState{};
+	};
+
+	using Matrix = std::array<float, 16>;
+
+	void CreateObjects();
+	void CreateScene();
+	void ReleaseObjects();
+
+	void UpdateScene(float time);
+	void RenderFrame();
+
+	// As Scene::RecordInParallel (see SceneVisibility::RecordInParallel) : records the draw packets last built by mVisibility into command streams of up to
+	// MESHES_PER_COMMAND_STREAM meshes each, in parallel.
+	void RecordMeshes(std::vector<std::unique_ptr<helios::gfx::CommandStream>>& commandStreams, helios::gfx::CommandHandle pipelineState,
+		std::span<const RenderTarget> renderTargets, helios::gfx::CommandHandle depthStencilView, uint32_t viewportWidth, uint32_t viewportHeight);
+
+	// Same as Scene::BuildIndirectDraws (see SceneVisibility::BuildIndirectDraws), and copies the draws into the argument / draw data buffers of the frame.
+	void BuildIndirectDraws();
+
+	// Same as Scene::RenderModelsIndirect : records the draws built by BuildIndirectDraws into a single stream, with one ExecuteIndirect (see gfx::RecordIndirectDraws).
+	void RecordIndirectMeshes(helios::gfx::CommandStream& commandStream, helios::gfx::CommandHandle pipelineState, std::span<const RenderTarget> renderTargets,
+		helios::gfx::CommandHandle depthStencilView, uint32_t viewportWidth, uint32_t viewportHeight);
+
+	// Binds the objects every pass starts with (as the contexts' constructors do).
+	void BeginPass(helios::gfx::CommandStream& commandStream, helios::gfx::PipelineBindPoint bindPoint, helios::gfx::CommandHandle pipelineState) const;
+
+	// Resolves the resource states the streams expect (as Device::ExecuteContext does) before executing them.
+	helios::gfx::QueueSubmission Submit(helios::gfx::QueueType queueType, std::span<const std::unique_ptr<helios::gfx::CommandStream>> commandStreams,
+		std::span<const helios::gfx::QueueSubmission> dependencies);
+
+	RenderTarget CreateRenderTarget(std::string_view name, helios::gfx::BackendObjectType viewType, uint32_t initialState);
+
+private:
+	// Same as the root constants of a draw of Model::Render (sizeof(PBRRenderResources)), as the draw data of an indirect draw.
+	using DrawData = std::array<uint32_t, 18u>;
+
+	static constexpr uint32_t MESHES_PER_COMMAND_STREAM = 256u;
+	static constexpr uint32_t SHADOW_MAP_DIMENSION = 2048u;
+	static constexpr uint32_t BLOOM_MIP_LEVELS = 6u;
+	static constexpr uint32_t BACK_BUFFER_COUNT = 3u;
+	static constexpr uint32_t MAX_FRAME_LATENCY = 2u;
+
+	HeadlessConfig mConfig{};
+
+	helios::gfx::NullRenderBackend mBackend{};
+	helios::gfx::QueueScheduler mQueueScheduler{};
+	std::shared_ptr<helios::gfx::ResourceStateRegistry> mResourceStateRegistry{};
+
+	std::array<helios::gfx::CommandHandle, 2u> mDescriptorHeaps{};
+	helios::gfx::CommandHandle mRootSignature{};
+
+	helios::gfx::CommandHandle mShadowPipelineState{};
+	helios::gfx::CommandHandle mDeferredGeometryPipelineState{};
+	helios::gfx::CommandHandle mDepthPrePassPipelineState{};
+	helios::gfx::CommandHandle mDepthPrePassDeferredGeometryPipelineState{};
+	helios::gfx::CommandHandle mLightingPipelineState{};
+	helios::gfx::CommandHandle mBloomPipelineState{};
+	helios::gfx::CommandHandle mPostProcessingPipelineState{};
+	helios::gfx::CommandHandle mFinalPipelineState{};
+	helios::gfx::CommandHandle mSkyBoxPipelineState{};
+
+	RenderTarget mShadowDepthTexture{};
+	RenderTarget mDepthStencilTexture{};
+	helios::gfx::CommandHandle mReadOnlyDepthStencilView{};
+	std::array<RenderTarget, 4u> mGBuffer{};
+	RenderTarget mOffscreenRT{};
+	helios::gfx::CommandHandle mBloomTexture{};
+	helios::gfx::ResourceStateHandle mBloomTextureResourceState{};
+	RenderTarget mPostProcessingRT{};
+	RenderTarget mFinalRT{};
+	std::array<RenderTarget, BACK_BUFFER_COUNT> mBackBuffers{};
+
+	// Indexed by draw index (the models have a single mesh, so it is also the model index of mVisibility).
+	std::vector<Mesh> mMeshes{};
+	std::vector<Matrix> mTransforms{};
+	Matrix mViewProjectionMatrix{};
+	Matrix mLightViewProjectionMatrix{};
+	helios::scene::Float3 mLightDirection{};
+
+	// The draws built by BuildIndirectDraws (and the bounds of their meshes), and the buffers (per frame in flight, as IndirectDrawBuffer) they are copied into. The
+	// upload memory is emulated by mIndirectDrawUploadMemory, so the copies are part of the CPU cost.
+	helios::gfx::IndirectDrawStream mIndirectDrawStream{ static_cast<uint32_t>(sizeof(DrawData)) };
+	std::vector<helios::scene::HiZDrawBounds> mIndirectDrawBounds{};
+	helios::gfx::CommandHandle mIndirectDrawCommandSignature{};
+	std::array<helios::gfx::CommandHandle, MAX_FRAME_LATENCY + 1u> mIndirectArgumentBuffers{};
+	std::vector<std::byte> mIndirectDrawUploadMemory{};
+
+	helios::scene::SceneVisibility mVisibility{};
+
+	// Summed over all frames.
+	uint64_t mVisibleMeshCount{};
+	uint64_t mMaterialChangeCount{};
+	helios::scene::ShadowCasterCullingStatistics mShadowCasterCullingStatistics{};
+
+	uint64_t mFrameNumber{};
+
+	// Fence values (indexed by the queue type) signalled by the last submissions of the frames in flight, indexed by the frame number.
+	std::array<helios::gfx::QueueScheduler::FenceValues, MAX_FRAME_LATENCY + 1u> mFrameFenceValues{};
+
+	helios::gfx::CommandStreamStatistics mCommandStreamStatistics{};
+};
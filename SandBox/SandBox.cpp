@@ -53,6 +53,8 @@ void SandBox::OnInit()
 	{
 		.modelPath = L"Assets/Models/sponza-gltf-pbr/sponza.glb",
 		.modelName = L"Sponza",
+		// The walls, floors, columns and arches (the curtains, plants and props are occludees only).
+		.minimumOccluderSize = 400.0f,
 	};
 	utility::ResourceManager::LoadModel(mDevice.get(), sponzaCreationDesc);
 
@@ -95,7 +97,8 @@ void SandBox::OnInit()
 
 	utility::ResourceManager::LoadSkyBox(mDevice.get(), skyBoxCreationDesc);
 
-	std::jthread pipelineThread([&]() {CreatePipelineStates(); });
+	core::JobCounter pipelineStateCounter{};
+	core::JobSystem::Get().Schedule([&]() {CreatePipelineStates(); }, &pipelineStateCounter);
 
 	// Create post process buffer.
 	gfx::BufferCreationDesc postProcessBufferCreationDesc
@@ -111,62 +114,59 @@ void SandBox::OnInit()
 	};
 
 
+	mRenderGraph = std::make_unique<gfx::RenderGraph>();
+
+	// Load transient resources (their dimensions are set when the pool is compiled).
+	mTransientResourcePool = std::make_unique<gfx::TransientResourcePool>();
+
 	// Load depth stencil texture.
 	gfx::TextureCreationDesc depthStencilTextureCreationDesc
 	{
 		.usage = gfx::TextureUsage::DepthStencil,
-		.dimensions = mDimensions,
 		.format = DXGI_FORMAT_R32_FLOAT,
 		.name = L"Depth Stencil Texture"
 	};
 
-	mDepthStencilTexture = std::make_unique<gfx::Texture>(mDevice->CreateTexture(depthStencilTextureCreationDesc));
-
-	gfx::TextureCreationDesc fowardDepthStencilTextureCreationDesc
-	{
-		.usage = gfx::TextureUsage::DepthStencil,
-		.dimensions = mDimensions,
-		.format = DXGI_FORMAT_R32_FLOAT,
-		.name = L"Forward Depth Stencil Texture"
-	};
-
-	mForwardRenderingDepthStencilTexture = std::make_unique<gfx::Texture>(mDevice->CreateTexture(fowardDepthStencilTextureCreationDesc));
+	mDepthStencilTexture = mTransientResourcePool->AddDepthStencilTexture(depthStencilTextureCreationDesc, { DeferredGeometry, Lighting });
 
 	// Load render targets.
 	gfx::TextureCreationDesc offscreenRenderTargetTextureCreationDesc
 	{ .usage = gfx::TextureUsage::RenderTarget,
-		.dimensions = mDimensions,
 		.format = DXGI_FORMAT_R16G16B16A16_FLOAT,
 		.name = L"Offscreen Render Texture"
 	};
 
-	mOffscreenRT = std::make_unique<gfx::RenderTarget>(mDevice->CreateRenderTarget(offscreenRenderTargetTextureCreationDesc));
+	mOffscreenRT = mTransientResourcePool->AddRenderTarget(offscreenRenderTargetTextureCreationDesc, { Lighting, PostProcess });
 
 	gfx::TextureCreationDesc postProcessRenderTargetsTextureCreationDesc
 	{
 		.usage = gfx::TextureUsage::RenderTarget,
-		.dimensions = mDimensions,
 		.format = gfx::Device::SWAPCHAIN_FORMAT,
 		.name = L"Post Process Render Texture"
 	};
 
-	mPostProcessingRT = std::make_unique<gfx::RenderTarget>(mDevice->CreateRenderTarget(postProcessRenderTargetsTextureCreationDesc));
+	mPostProcessingRT = mTransientResourcePool->AddRenderTarget(postProcessRenderTargetsTextureCreationDesc, { PostProcess, Final });
 
 	gfx::TextureCreationDesc finalRenderTargetsTextureCreationDesc
 	{
 		.usage = gfx::TextureUsage::RenderTarget,
-		.dimensions = mDimensions,
 		.format = gfx::Device::SWAPCHAIN_FORMAT,
 		.name = L"Final Render Texture"
 	};
 
-	mFinalRT = std::make_unique<gfx::RenderTarget>(mDevice->CreateRenderTarget(finalRenderTargetsTextureCreationDesc));
+	mFinalRT = mTransientResourcePool->AddRenderTarget(finalRenderTargetsTextureCreationDesc, { Final, CopyToSwapChain });
 
 	// Init render passes.
-	mDeferredGPass = std::make_unique<gfx::DeferredGeometryPass>(mDevice.get(), mDimensions);
+	mDeferredGPass = std::make_unique<gfx::DeferredGeometryPass>(mDevice.get(), mTransientResourcePool.get(), gfx::TransientResourceLifetime{ DeferredGeometry, Lighting });
 	mShadowPass = std::make_unique<gfx::ShadowPass>(mDevice.get());
 	//mBloomPass = std::make_unique<gfx::BloomPass>(mDevice.get(), mDimensions);
 
+	// The editor displays the albedo RT in the final pass.
+	mTransientResourcePool->ExtendLifetime(mDeferredGPass->mDeferredPassRTs.albedoRT, Final);
+
+	// Place all transient resources (must be done after all passes have added their resources).
+	mTransientResourcePool->Compile(mDevice.get(), mDimensions);
+
 	// Init other scene objects.
 	mEditor = std::make_unique<editor::Editor>(mDevice.get());
 
@@ -197,6 +197,8 @@ void SandBox::OnInit()
 	auto skyBox = utility::ResourceManager::GetLoadedSkyBox(L"SkyBox");
 	mScene->AddSkyBox(std::move(skyBox));
 
+	core::JobSystem::Get().Wait(pipelineStateCounter);
+
 	core::LogMessage(L"SandBox data initialized", core::LogMessageTypes::Info);
 	core::LogMessage(L"Warn Test", core::LogMessageTypes::Warn);
 	core::LogMessage(L"Warn Error", core::LogMessageTypes::Error);
@@ -205,203 +207,230 @@ void SandBox::OnInit()
 void SandBox::OnUpdate()
 {
 	mScene->Update(mAspectRatio);
-
-	mPostProcessBuffer->Update(&mPostProcessBufferData);
 }
 
 void SandBox::OnRender()
 {
-	std::unique_ptr<gfx::GraphicsContext> shadowPassGraphicsContext = mDevice->GetGraphicsContext(mShadowPass->mShadowPipelineState.get());
-	std::unique_ptr<gfx::GraphicsContext> deferredGPassGraphicsContext = mDevice->GetGraphicsContext(mDeferredGPass->mDeferredPassPipelineState.get());
-	std::unique_ptr<gfx::GraphicsContext> shadingGraphicsContext = mDevice->GetGraphicsContext(mPBRPipelineState.get());
-	std::unique_ptr<gfx::GraphicsContext> postProcessingGraphicsContext = mDevice->GetGraphicsContext(mPostProcessingPipelineState.get());
-	std::unique_ptr<gfx::GraphicsContext> finalGraphicsContext = mDevice->GetGraphicsContext(mFinalPipelineState.get());
-	std::unique_ptr<gfx::GraphicsContext> finalToSwapChainGraphicsContext = mDevice->GetGraphicsContext(nullptr);
-	
-	std::vector<std::unique_ptr<gfx::ComputeContext>> bloomComputeContexts{};
+	ExecuteRenderThreadTasks();
+
+	// Wait for the snapshot of the update that ran while the previous frame was being recorded. Once it is picked up, the main thread can run the next update.
+	if (!mScene->AcquireSnapshot())
+	{
+		return;
+	}
+
+	SignalUpdateConsumed();
+
+	// The post process buffer data is only edited from the editor (on the render thread), so it is not part of the snapshot.
+	mPostProcessBuffer->Update(&mPostProcessBufferData);
+
+	using RenderGraphState = gfx::RenderGraphResourceState;
 
 	gfx::BackBuffer *backBuffer = mDevice->GetCurrentBackBuffer();
 
 	mDevice->BeginFrame();
 
+	// The render graph places the barriers between the passes : resources are imported in the states they rest in between frames, and passes only declare their accesses.
+	const auto ImportResource = [&](const char* name, ID3D12Resource* resource, RenderGraphState restState, bool isOutput = false)
+	{
+		return mRenderGraph->ImportResource(gfx::RenderGraphResourceDesc{ .name = name, .initialState = restState, .finalState = restState, .isOutput = isOutput }, resource);
+	};
+
+	const uint32_t shadowDepthResource = ImportResource("Shadow Depth Texture", mShadowPass->mDepthTexture->GetResource(), RenderGraphState::PixelShaderResource);
+
+	const std::array<uint32_t, 4u> gBufferResources
+	{
+		ImportResource("Albedo RT", mDeferredGPass->mDeferredPassRTs.albedoRT->GetResource(), RenderGraphState::PixelShaderResource),
+		ImportResource("Position Emissive RT", mDeferredGPass->mDeferredPassRTs.positionEmissiveRT->GetResource(), RenderGraphState::PixelShaderResource),
+		ImportResource("Normal Emissive RT", mDeferredGPass->mDeferredPassRTs.normalEmissiveRT->GetResource(), RenderGraphState::PixelShaderResource),
+		ImportResource("AO Metal Roughness Emissive RT", mDeferredGPass->mDeferredPassRTs.aoMetalRoughnessEmissiveRT->GetResource(), RenderGraphState::PixelShaderResource),
+	};
+
+	const uint32_t depthResource = ImportResource("Depth Stencil Texture", mDepthStencilTexture->GetResource(), RenderGraphState::DepthWrite);
+	const uint32_t offscreenResource = ImportResource("Offscreen RT", mOffscreenRT->GetResource(), RenderGraphState::PixelShaderResource);
+	const uint32_t postProcessingResource = ImportResource("Post Processing RT", mPostProcessingRT->GetResource(), RenderGraphState::PixelShaderResource);
+	const uint32_t finalResource = ImportResource("Final RT", mFinalRT->GetResource(), RenderGraphState::CopySource);
+	const uint32_t backBufferResource = ImportResource("Back Buffer", backBuffer->GetResource(), RenderGraphState::Present, true);
+
 	// Configure offscreen render target's.
 	std::array<const gfx::RenderTarget *, 1u> renderTargets
 	{
-		mOffscreenRT.get()
+		mOffscreenRT
 	};
 
 	static std::array<float, 4> clearColor{0.0f, 0.0f, 0.0f, 1.0f};
 
 	// Renderpass -1 : Shadow pass.
-	{
-		mShadowPass->Render(mScene.get(), shadowPassGraphicsContext.get());
-	}
+	mRenderGraph->AddGraphicsPass(gfx::RenderGraphPassDesc{ .name = "Shadow" }.Write(shadowDepthResource, RenderGraphState::DepthWrite),
+		[&](std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
+		{
+			mShadowPass->Render(mDevice.get(), mScene.get(), graphicsContexts);
+		});
 
 	// Renderpass 0 : Deferred Geometry pass
+	gfx::RenderGraphPassDesc deferredGeometryPassDesc{ .name = "Deferred Geometry" };
+	for (const uint32_t gBufferResource : gBufferResources)
 	{
-		mDeferredGPass->Render(mScene.get(), deferredGPassGraphicsContext.get(), mDepthStencilTexture.get());
-
-		// Copying the depth stencil texture so it can be used for rendering lights
-		// (which is forward rendering).
-		deferredGPassGraphicsContext->AddResourceBarrier(mDepthStencilTexture->GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COPY_SOURCE);
-		deferredGPassGraphicsContext->AddResourceBarrier(mForwardRenderingDepthStencilTexture->GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COPY_DEST);
-		deferredGPassGraphicsContext->ExecuteResourceBarriers();
-
-		deferredGPassGraphicsContext->CopyResource(mDepthStencilTexture->GetResource(), mForwardRenderingDepthStencilTexture->GetResource());
-
-		deferredGPassGraphicsContext->AddResourceBarrier( mDepthStencilTexture->GetResource(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-		deferredGPassGraphicsContext->AddResourceBarrier(mForwardRenderingDepthStencilTexture->GetResource(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-
-		deferredGPassGraphicsContext->ExecuteResourceBarriers();
+		deferredGeometryPassDesc.Write(gBufferResource, RenderGraphState::RenderTarget);
 	}
 
+	mRenderGraph->AddGraphicsPass(deferredGeometryPassDesc.Write(depthResource, RenderGraphState::DepthWrite),
+		[&](std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
+		{
+			mDeferredGPass->Render(mDevice.get(), mScene.get(), graphicsContexts, mDepthStencilTexture);
+		},
+		[&](gfx::Context* context) { mTransientResourcePool->AddAliasingBarriers(context, DeferredGeometry); });
+
 	// RenderPass 1 : Do shading on offscreen RT (deferred lighting pass) and then
 	// render lights using forward rendering.
+	// The lights and sky box are depth tested against the depth of the deferred geometry pass through a read only DSV, so the depth does not have to be copied.
+	gfx::RenderGraphPassDesc lightingPassDesc{ .name = "Lighting" };
+	for (const uint32_t gBufferResource : gBufferResources)
 	{
-		shadingGraphicsContext->AddResourceBarrier(renderTargets, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
-		shadingGraphicsContext->ExecuteResourceBarriers();
-
-		shadingGraphicsContext->SetRenderTarget(renderTargets, mDepthStencilTexture.get());
-		shadingGraphicsContext->SetDefaultViewportAndScissor();
-		shadingGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		lightingPassDesc.Read(gBufferResource, RenderGraphState::PixelShaderResource);
+	}
 
-		shadingGraphicsContext->ClearRenderTargetView(renderTargets, std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
-		shadingGraphicsContext->ClearDepthStencilView(mDepthStencilTexture.get(), 1.0f);
+	lightingPassDesc.Read(shadowDepthResource, RenderGraphState::PixelShaderResource).Read(depthResource, RenderGraphState::DepthRead)
+		.Write(offscreenResource, RenderGraphState::RenderTarget);
 
-		DeferredLightingPassRenderResources deferredLightingPassRenderResources
+	mRenderGraph->AddGraphicsPass(lightingPassDesc,
+		[&](std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
 		{
-			.lightBufferIndex = scene::Light::GetCbvIndex(),
-			.sceneBufferIndex = mScene->GetSceneBufferIndex(),
+			gfx::GraphicsContext* shadingGraphicsContext = graphicsContexts.back().get();
 
-			.albedoGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.albedoRT.get()),
-			.positionEmissiveGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.positionEmissiveRT.get()),
-			.normalEmissiveGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.normalEmissiveRT.get()),
-			.aoMetalRoughnessEmissiveGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.aoMetalRoughnessEmissiveRT.get()),
+			shadingGraphicsContext->SetGraphicsPipelineState(mPBRPipelineState.get());
+			shadingGraphicsContext->SetRenderTarget(renderTargets, nullptr);
+			shadingGraphicsContext->SetDefaultViewportAndScissor();
+			shadingGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-			.shadowMappingBufferIndex = gfx::Buffer::GetCbvIndex(mShadowPass->mShadowMappingBuffer.get()),
-			.shadowDepthTextureIndex = gfx::Texture::GetSrvIndex(mShadowPass->mDepthTexture.get()),
+			shadingGraphicsContext->ClearRenderTargetView(renderTargets, std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
 
-			.irradianceMapIndex = gfx::Texture::GetSrvIndex(mScene->mSkyBox->mIrradianceMapTexture.get()),
-			.prefilterMapIndex = gfx::Texture::GetSrvIndex(mScene->mSkyBox->mPreFilterTexture.get()),
-			.brdfLutIndex = gfx::Texture::GetSrvIndex(mScene->mSkyBox->mBRDFLutTexture.get()),
-		};
+			DeferredLightingPassRenderResources deferredLightingPassRenderResources
+			{
+				.lightBufferIndex = scene::Light::GetCbvIndex(),
+				.sceneBufferIndex = mScene->GetSceneBufferIndex(),
 
-		gfx::RenderTarget::Render(shadingGraphicsContext.get(), deferredLightingPassRenderResources);
+				.albedoGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.albedoRT),
+				.positionEmissiveGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.positionEmissiveRT),
+				.normalEmissiveGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.normalEmissiveRT),
+				.aoMetalRoughnessEmissiveGBufferIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mDeferredGPass->mDeferredPassRTs.aoMetalRoughnessEmissiveRT),
 
-		// Render lights and sky box using forward rendering.
+				.shadowMappingBufferIndex = gfx::Buffer::GetCbvIndex(mShadowPass->mShadowMappingBuffer.get()),
+				.shadowDepthTextureIndex = gfx::Texture::GetSrvIndex(mShadowPass->mDepthTexture.get()),
 
-		shadingGraphicsContext->SetGraphicsPipelineState(mLightPipelineState.get());
-		shadingGraphicsContext->SetRenderTarget(renderTargets, mForwardRenderingDepthStencilTexture.get());
+				.irradianceMapIndex = gfx::Texture::GetSrvIndex(mScene->mSkyBox->mIrradianceMapTexture.get()),
+				.prefilterMapIndex = gfx::Texture::GetSrvIndex(mScene->mSkyBox->mPreFilterTexture.get()),
+				.brdfLutIndex = gfx::Texture::GetSrvIndex(mScene->mSkyBox->mBRDFLutTexture.get()),
+			};
 
-		mScene->RenderLights(shadingGraphicsContext.get());
+			gfx::RenderTarget::Render(shadingGraphicsContext, deferredLightingPassRenderResources);
 
-		shadingGraphicsContext->SetGraphicsPipelineState(mSkyBoxPipelineState.get());
+			// Render sky box and lights using forward rendering.
+			// Note : As the depth is read only, the lights do not occlude the sky box, which is hence rendered first.
 
-		mScene->RenderSkyBox(shadingGraphicsContext.get());
+			shadingGraphicsContext->SetGraphicsPipelineState(mSkyBoxPipelineState.get());
+			shadingGraphicsContext->SetRenderTarget(renderTargets, mDepthStencilTexture, gfx::DepthStencilAccess::ReadOnly);
 
-		shadingGraphicsContext->AddResourceBarrier(renderTargets, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-		shadingGraphicsContext->ExecuteResourceBarriers();
-	}
+			mScene->RenderSkyBox(shadingGraphicsContext);
 
-	// Execute contexts.
-	std::array<std::unique_ptr<gfx::GraphicsContext>, 3u> graphicsContexts1
-	{
-		std::move(shadowPassGraphicsContext),
-		std::move(deferredGPassGraphicsContext),
-		std::move(shadingGraphicsContext),
-	};
+			shadingGraphicsContext->SetGraphicsPipelineState(mLightPipelineState.get());
 
-	mDevice->ExecuteContext(graphicsContexts1);
+			mScene->RenderLights(shadingGraphicsContext);
+		},
+		[&](gfx::Context* context) { mTransientResourcePool->AddAliasingBarriers(context, Lighting); });
 
 	// note(rtarun9) : Bloom has not been implemented.
-	// Render pass 1.5 : Bloom Pass.
+	// Render pass 1.5 : Bloom Pass (would be added with AddComputePass, and run on the compute queue while the graphics queue continues).
 	{
-		//mBloomPass->Render(mDevice.get(),  mOffscreenRT.get(), bloomComputeContexts);
+		//mBloomPass->Render(mDevice.get(),  mOffscreenRT, bloomComputeContexts);
 	}
 
-	// Execute the contexts.
-	mDevice->ExecuteContext(bloomComputeContexts);
-
 	// Render pass 2 : Render offscreen rt to post processed RT (after all
 	// processing has occured).
-	{
-		postProcessingGraphicsContext->AddResourceBarrier(mPostProcessingRT->GetResource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
-		postProcessingGraphicsContext->ExecuteResourceBarriers();
-
-		postProcessingGraphicsContext->SetRenderTarget(mPostProcessingRT.get(), mForwardRenderingDepthStencilTexture.get());
-		postProcessingGraphicsContext->SetDefaultViewportAndScissor();
-		postProcessingGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-		postProcessingGraphicsContext->ClearRenderTargetView(mPostProcessingRT.get(), std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
-		postProcessingGraphicsContext->ClearDepthStencilView(mForwardRenderingDepthStencilTexture.get(), 1.0f);
-
-		// Note : buffer indices can be set here or in the RenderTarget::Render
-		// function. Begin done there for now.
-		PostProcessRenderResources postProcessRenderResources
+	mRenderGraph->AddGraphicsPass(gfx::RenderGraphPassDesc{ .name = "Post Process" }.Read(offscreenResource, RenderGraphState::PixelShaderResource)
+		.Write(postProcessingResource, RenderGraphState::RenderTarget),
+		[&](std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
 		{
-			.finalRenderTextureIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mOffscreenRT.get()),
-			.bloomTextureIndex = 0u,
-			.postProcessBufferIndex = gfx::Buffer::GetCbvIndex(mPostProcessBuffer.get())
-		};
+			gfx::GraphicsContext* postProcessingGraphicsContext = graphicsContexts.back().get();
 
-		gfx::RenderTarget::Render(postProcessingGraphicsContext.get(), postProcessRenderResources);
-	}
+			postProcessingGraphicsContext->SetGraphicsPipelineState(mPostProcessingPipelineState.get());
+			postProcessingGraphicsContext->SetRenderTarget(mPostProcessingRT, nullptr);
+			postProcessingGraphicsContext->SetDefaultViewportAndScissor();
+			postProcessingGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-	// Render pass 3 : The RT that is to be displayed to swap chain is processed.
-	// For now, UI is rendered in this RT as well.
-	{
-		finalGraphicsContext->AddResourceBarrier(mPostProcessingRT->GetResource(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-		finalGraphicsContext->AddResourceBarrier(mFinalRT->GetResource(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
-		finalGraphicsContext->ExecuteResourceBarriers();
+			postProcessingGraphicsContext->ClearRenderTargetView(mPostProcessingRT, std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
 
-		finalGraphicsContext->SetRenderTarget(mFinalRT.get(), mForwardRenderingDepthStencilTexture.get());
-		finalGraphicsContext->SetDefaultViewportAndScissor();
-		finalGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			// Note : buffer indices can be set here or in the RenderTarget::Render
+			// function. Begin done there for now.
+			PostProcessRenderResources postProcessRenderResources
+			{
+				.finalRenderTextureIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mOffscreenRT),
+				.bloomTextureIndex = 0u,
+				.postProcessBufferIndex = gfx::Buffer::GetCbvIndex(mPostProcessBuffer.get())
+			};
 
-		finalGraphicsContext->ClearDepthStencilView(mForwardRenderingDepthStencilTexture.get(), 1.0f);
+			gfx::RenderTarget::Render(postProcessingGraphicsContext, postProcessRenderResources);
+		},
+		[&](gfx::Context* context) { mTransientResourcePool->AddAliasingBarriers(context, PostProcess); });
 
-		// Note : buffer indices can be set here or in the RenderTarget::Render
-		// function. Begin done there for now.
-		RenderTargetRenderResources rtvRenderResources
+	// Render pass 3 : The RT that is to be displayed to swap chain is processed.
+	// For now, UI is rendered in this RT as well (the editor displays the albedo RT and the shadow depth texture).
+	mRenderGraph->AddGraphicsPass(gfx::RenderGraphPassDesc{ .name = "Final" }.Read(postProcessingResource, RenderGraphState::PixelShaderResource)
+		.Read(gBufferResources[0], RenderGraphState::PixelShaderResource).Read(shadowDepthResource, RenderGraphState::PixelShaderResource)
+		.Write(finalResource, RenderGraphState::RenderTarget),
+		[&](std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
 		{
-			.textureIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mPostProcessingRT.get()),
-		};
+			gfx::GraphicsContext* finalGraphicsContext = graphicsContexts.back().get();
 
-		gfx::RenderTarget::Render(finalGraphicsContext.get(), rtvRenderResources);
+			finalGraphicsContext->SetGraphicsPipelineState(mFinalPipelineState.get());
+			finalGraphicsContext->SetRenderTarget(mFinalRT, nullptr);
+			finalGraphicsContext->SetDefaultViewportAndScissor();
+			finalGraphicsContext->SetPrimitiveTopologyLayout(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-		mEditor->Render(mDevice.get(), mScene.get(), &mDeferredGPass->mDeferredPassRTs, mShadowPass.get(), clearColor, mPostProcessBufferData, mPostProcessingRT.get(), finalGraphicsContext.get());
-	}
+			// Note : As the final RT shares memory with other resources, its contents are undefined until it is cleared.
+			finalGraphicsContext->ClearRenderTargetView(mFinalRT, std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
 
-	// Render pass 3 : Copy the final RT to the swap chain
-	{
-		finalToSwapChainGraphicsContext->AddResourceBarrier(mFinalRT->GetResource(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
-		finalToSwapChainGraphicsContext->AddResourceBarrier(backBuffer->GetResource(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_COPY_DEST);
-		finalToSwapChainGraphicsContext->ExecuteResourceBarriers();
+			// Note : buffer indices can be set here or in the RenderTarget::Render
+			// function. Begin done there for now.
+			RenderTargetRenderResources rtvRenderResources
+			{
+				.textureIndex = gfx::RenderTarget::GetRenderTextureSRVIndex(mPostProcessingRT),
+			};
 
-		finalToSwapChainGraphicsContext->CopyResource(mFinalRT->GetResource(), backBuffer->GetResource());
+			gfx::RenderTarget::Render(finalGraphicsContext, rtvRenderResources);
 
-		finalToSwapChainGraphicsContext->AddResourceBarrier(backBuffer->GetResource(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PRESENT);
-		finalToSwapChainGraphicsContext->ExecuteResourceBarriers();
-	}
-
-	mDevice->EndFrame();
+			mEditor->Render(mDevice.get(), mScene.get(), &mDeferredGPass->mDeferredPassRTs, mShadowPass.get(), clearColor, mPostProcessBufferData, mPostProcessingRT, finalGraphicsContext);
+		},
+		[&](gfx::Context* context) { mTransientResourcePool->AddAliasingBarriers(context, Final); });
 
-	// Execute graphics / compute contexts.
+	// Render pass 3 : Copy the final RT to the swap chain
+	mRenderGraph->AddGraphicsPass(gfx::RenderGraphPassDesc{ .name = "Copy To Swap Chain" }.Read(finalResource, RenderGraphState::CopySource)
+		.Write(backBufferResource, RenderGraphState::CopyDestination),
+		[&](std::vector<std::unique_ptr<gfx::GraphicsContext>>& graphicsContexts)
+		{
+			graphicsContexts.back()->CopyResource(mFinalRT->GetResource(), backBuffer->GetResource());
+		});
 
-	std::array<std::unique_ptr<gfx::GraphicsContext>, 3u> graphicsContexts2
+	// The deferred lighting pass samples the IBL maps, which are generated asynchronously on the compute queue (the wait is skipped once it is known to have completed).
+	const std::array<gfx::QueueSubmission, 1u> externalDependencies
 	{
-		std::move(postProcessingGraphicsContext),
-		std::move(finalGraphicsContext),
-		std::move(finalToSwapChainGraphicsContext),
+		mScene->mSkyBox->GetPrecomputeSubmission(),
 	};
 
-	mDevice->ExecuteContext(graphicsContexts2);
+	mRenderGraph->Execute(mDevice.get(), externalDependencies);
+
+	mDevice->EndFrame();
 
 	mDevice->Present();
 
 	mFrameIndex++;
 }
 
+void SandBox::OnQuit()
+{
+	mScene->CloseSnapshots();
+}
+
 void SandBox::OnDestroy()
 {
 	scene::Light::DestroyLightResources();
@@ -410,30 +439,44 @@ void SandBox::OnDestroy()
 
 void SandBox::OnKeyAction(uint8_t keycode, bool isKeyDown)
 {
+	// Key actions are handled on the main thread : the ones affecting rendering are forwarded to the render thread.
 	if (isKeyDown && keycode == VK_SPACE)
 	{
-		mEditor->ShowUI(false);
+		ExecuteOnRenderThread([this]() { mEditor->ShowUI(false); });
 	}
 	else if (isKeyDown && keycode == VK_SHIFT)
 	{
-		mEditor->ShowUI(true);
+		ExecuteOnRenderThread([this]() { mEditor->ShowUI(true); });
 	}
 
 	if (isKeyDown && keycode == VK_F5)
 	{
-		mDevice->EnableVSync();
+		ExecuteOnRenderThread([this]() { mDevice->EnableVSync(); });
 	}
 	else if (isKeyDown && keycode == VK_F6)
 	{
-		mDevice->DisableVSync();
+		ExecuteOnRenderThread([this]() { mDevice->DisableVSync(); });
+	}
+
+	if (isKeyDown && keycode == VK_F7)
+	{
+		ExecuteOnRenderThread([this]() { mDeferredGPass->mDepthPrePassEnabled = !mDeferredGPass->mDepthPrePassEnabled; });
+	}
+
+	if (isKeyDown && keycode == VK_F8)
+	{
+		ExecuteOnRenderThread([this]() { mDeferredGPass->mHiZCullingEnabled = !mDeferredGPass->mHiZCullingEnabled; });
 	}
 
 	if (isKeyDown && keycode == 'R')
 	{
-		mDevice->GetComputeCommandQueue()->FlushQueue();
-		mDevice->GetGraphicsCommandQueue()->FlushQueue();
+		ExecuteOnRenderThread([this]()
+		{
+			mDevice->GetComputeCommandQueue()->FlushQueue();
+			mDevice->GetGraphicsCommandQueue()->FlushQueue();
 
-		CreatePipelineStates();
+			CreatePipelineStates();
+		});
 	}
 
 	mScene->mCamera->HandleInput(keycode, isKeyDown);
@@ -441,23 +484,25 @@ void SandBox::OnKeyAction(uint8_t keycode, bool isKeyDown)
 
 void SandBox::OnResize()
 {
-	if (mDimensions != core::Application::GetClientDimensions())
-	{
-		mDevice->ResizeBuffers();
+	const Uint2 dimensions = core::Application::GetClientDimensions();
 
-		mDimensions = core::Application::GetClientDimensions();
+	if (mDimensions != dimensions)
+	{
+		mDimensions = dimensions;
 
 		mAspectRatio = static_cast<float>(mDimensions.x) / static_cast<float>(mDimensions.y);
 
-		// Recreate RTV and SRV of all render targets.
-		mDevice->ResizeRenderTarget(mFinalRT.get());
-		mDevice->ResizeRenderTarget(mOffscreenRT.get());
-		mDevice->ResizeRenderTarget(mPostProcessingRT.get());
+		// The swap chain and the screen sized resources are resized on the render thread, between two frames.
+		ExecuteOnRenderThread([this, dimensions]()
+		{
+			mDevice->ResizeBuffers();
 
-		mDeferredGPass->Resize(mDevice.get(), mDimensions);
-		//mBloomPass->OnResize(mDevice.get(), mDimensions);
+			// Recreate the transient resource heap and all resources placed in it.
+			mTransientResourcePool->Compile(mDevice.get(), dimensions);
+			//mBloomPass->OnResize(mDevice.get(), dimensions);
 
-		mEditor->OnResize(core::Application::GetClientDimensions());
+			mEditor->OnResize(dimensions);
+		});
 	}
 }
 
@@ -471,6 +516,7 @@ void SandBox::CreatePipelineStates()
 			.psShaderPath = L"Shaders/RenderPass/PostProcessRenderPassPS.cso",
 		},
 		.rtvFormats = {gfx::Device::SWAPCHAIN_FORMAT},
+		.depthFormat = DXGI_FORMAT_UNKNOWN,
 		.pipelineName = L"Post Process RenderPass Pipeline"
 	};
 
@@ -483,6 +529,7 @@ void SandBox::CreatePipelineStates()
 			.vsShaderPath = L"Shaders/Shading/PBRVS.cso",
 			.psShaderPath = L"Shaders/Shading/PBRPS.cso",
 		},
+		.depthFormat = DXGI_FORMAT_UNKNOWN,
 		.pipelineName = L"PBR Pipeline"
 	};
 
@@ -495,6 +542,7 @@ void SandBox::CreatePipelineStates()
 			.vsShaderPath = L"Shaders/Light/LightVS.cso",
 			.psShaderPath = L"Shaders/Light/LightPS.cso",
 		},
+		.depthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
 		.pipelineName = L"Light Pipeline"
 	};
 
@@ -508,7 +556,7 @@ void SandBox::CreatePipelineStates()
 			.psShaderPath = L"Shaders/RenderPass/FinalRenderPassPS.cso",
 		},
 		.rtvFormats = {gfx::Device::SWAPCHAIN_FORMAT},
-		.depthFormat = DXGI_FORMAT_D32_FLOAT,
+		.depthFormat = DXGI_FORMAT_UNKNOWN,
 		.pipelineName = L"Final Render Target Pipeline"
 	};
 
@@ -523,6 +571,7 @@ void SandBox::CreatePipelineStates()
 		},
 		.rtvFormats = {DXGI_FORMAT_R16G16B16A16_FLOAT},
 		.depthComparisonFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL,
+		.depthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO,
 		.frontFaceWindingOrder = gfx::FrontFaceWindingOrder::CounterClockWise,
 		.pipelineName = L"Sky Box Pipeline"
 	};
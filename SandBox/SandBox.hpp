@@ -11,6 +11,7 @@ public:
 	virtual void OnUpdate() override;
 	virtual void OnRender() override;
 	virtual void OnDestroy() override;
+	virtual void OnQuit() override;
 
 	void OnKeyAction(uint8_t keycode, bool isKeyDown) override;
 	void OnResize() override;
@@ -24,16 +25,31 @@ private:
 	std::unique_ptr<helios::gfx::Buffer> mPostProcessBuffer{};
 	PostProcessBuffer mPostProcessBufferData{};
 
-	std::unique_ptr<helios::gfx::Texture> mDepthStencilTexture{};
+	// Order in which the passes are added to the render graph in OnRender. Used to specify the lifetimes of transient resources.
+	enum RenderPassIndex : uint32_t
+	{
+		Shadow,
+		DeferredGeometry,
+		Lighting,
+		PostProcess,
+		Final,
+		CopyToSwapChain,
+	};
 
-	// mDepthStencilTexture's data is copied into this depth texture when doing foward rendering.
-	std::unique_ptr<helios::gfx::Texture> mForwardRenderingDepthStencilTexture{};
+	// Places the barriers between the passes of OnRender, and submits them.
+	std::unique_ptr<helios::gfx::RenderGraph> mRenderGraph{};
+
+	// Owns all screen sized render targets / depth textures. Resources used in non overlapping passes share memory.
+	std::unique_ptr<helios::gfx::TransientResourcePool> mTransientResourcePool{};
+
+	// Written by the deferred geometry pass, and bound as a read only DSV (while in the DEPTH_READ state) when rendering the lights / sky box.
+	helios::gfx::Texture* mDepthStencilTexture{};
 
 	// All post processing effects are processed and stored in here (final result of the main scene).
-	std::unique_ptr<helios::gfx::RenderTarget> mPostProcessingRT{};
-	std::unique_ptr<helios::gfx::RenderTarget> mOffscreenRT{};
+	helios::gfx::RenderTarget* mPostProcessingRT{};
+	helios::gfx::RenderTarget* mOffscreenRT{};
 	// Contains the final image that is to be rendered to the swapchain.
-	std::unique_ptr<helios::gfx::RenderTarget> mFinalRT{};
+	helios::gfx::RenderTarget* mFinalRT{};
 
 	std::unique_ptr<helios::gfx::PipelineState> mPBRPipelineState{};
 	std::unique_ptr<helios::gfx::PipelineState> mLightPipelineState{};
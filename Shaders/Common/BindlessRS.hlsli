@@ -101,6 +101,14 @@ struct PBRRenderResources
     uint emissiveTextureSamplerIndex;
 };
 
+// Root constants of the passes executing the scene's draws with ExecuteIndirect (see IndirectDrawBuffer) : the draw index is set per draw by the command
+// signature, and indexes the structured buffer of the draws' PBRRenderResources.
+struct IndirectDrawRenderResources
+{
+    uint drawDataBufferIndex;
+    uint drawIndex;
+};
+
 struct SceneRenderResources
 {
     uint sceneBufferIndex;
@@ -168,7 +176,87 @@ struct MipMapGenerationRenderResources
     uint outputMip3Index;
     uint outputMip4Index;
 
-    uint mipMapGenerationBufferIndex;
+    // Per dispatch parameters are root constants (rather than a constant buffer), so the dispatches of many textures can be recorded into a single command list.
+    uint isSRGB;
+    uint sourceMipLevel;
+    uint numberMipLevels;
+
+    // TextureDimensionType (see ConstantBuffers.hlsli).
+    uint dimensionType;
+
+    // 1.0f / outputDimension.size
+    float texelSizeX;
+    float texelSizeY;
+};
+
+struct SinglePassDownsampleRenderResources
+{
+    // UAV's of mip 0 (the source) to mip 12. Mip 0 is read through a UAV as well, so the entire texture is in the unordered access state.
+    uint mip0Index;
+    uint mip1Index;
+    uint mip2Index;
+    uint mip3Index;
+    uint mip4Index;
+    uint mip5Index;
+    uint mip6Index;
+    uint mip7Index;
+    uint mip8Index;
+    uint mip9Index;
+    uint mip10Index;
+    uint mip11Index;
+    uint mip12Index;
+
+    // Global atomic counter used to find the last thread group (reset by it, so the counter can be reused by later dispatches).
+    uint counterBufferIndex;
+    uint counterIndex;
+
+    uint width;
+    uint height;
+    uint mipCount;
+
+    // DownsampleReduction (see SinglePassDownsampler.hpp).
+    uint reduction;
+    uint isSRGB;
+};
+
+struct HiZCopyDepthRenderResources
+{
+    uint depthTextureIndex;
+
+    // UAV of mip 0 of the depth pyramid (R32G32_FLOAT), whose x and y are set to the depth (see DownsampleReduction::MinMax).
+    uint pyramidMip0Index;
+
+    uint width;
+    uint height;
+};
+
+// See HiZCullingPass and scene::CullHiZDraw (HiZCulling.hpp), which the culling shader mirrors.
+struct HiZCullingRenderResources
+{
+    // The draws built by the CPU (IndirectDrawArguments), and their HiZDrawBounds.
+    uint argumentBufferIndex;
+    uint drawBoundsBufferIndex;
+    uint drawCount;
+
+    // UAV's of the arguments of the draws of the phase (written from argument offset outputArgumentOffset onwards) and of the draw counts of both phases.
+    uint outputArgumentBufferIndex;
+    uint outputArgumentOffset;
+    uint drawCountBufferIndex;
+
+    // UAV of the visibility (one uint per HiZDrawBounds::visibilityIndex), persisted across frames.
+    uint visibilityBufferIndex;
+
+    // SRV of the entire pyramid. If isPyramidValid is 0 (the pyramid was not built yet), no draw is occluded.
+    uint pyramidIndex;
+    uint pyramidWidth;
+    uint pyramidHeight;
+    uint pyramidMipCount;
+    uint isPyramidValid;
+
+    // HiZCullingPhase (see HiZCulling.hpp).
+    uint phase;
+
+    uint sceneBufferIndex;
 };
 
 struct CubeFromEquirectRenderResources
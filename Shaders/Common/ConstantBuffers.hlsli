@@ -115,19 +115,4 @@ enum class TextureDimensionType
     HeightWidthOdd
 };
 
-
-ConstantBufferStruct MipMapGenerationBuffer
-{
-    int isSRGB;
-
-    uint sourceMipLevel;
-
-    // 1.0f  / outputDimension.size
-    float2 texelSize;
-
-    uint numberMipLevels;
-
-    TextureDimensionType dimensionType;
-};
-
 #endif
\ No newline at end of file
@@ -10,6 +10,13 @@ static const float INV_PI = 1.0f / PI;
 static const float INV_TWO_PI = 1.0f / TWO_PI;
 static const float INVALID_INDEX = 4294967295; // UINT32_MAX;
 
+// The PBRRenderResources of the current draw of an ExecuteIndirect (see IndirectDrawRenderResources).
+PBRRenderResources GetIndirectDrawRenderResources(IndirectDrawRenderResources indirectDrawRenderResources)
+{
+    StructuredBuffer<PBRRenderResources> drawDataBuffer = ResourceDescriptorHeap[indirectDrawRenderResources.drawDataBufferIndex];
+    return drawDataBuffer[indirectDrawRenderResources.drawIndex];
+}
+
 float4 GetAlbedo(float2 textureCoords, uint albedoTextureIndex, uint albedoTextureSamplerIndex)
 {
     if (albedoTextureIndex == INVALID_INDEX)
@@ -0,0 +1,22 @@
+// Writes the depth buffer into mip 0 of the depth pyramid as (depth, depth), so the min / max reduction of the single pass downsampler (see
+// DownsampleReduction::MinMax) stores the depth range of the pixels of every texel of the following mips.
+
+#include "../Common/BindlessRS.hlsli"
+
+ConstantBuffer<HiZCopyDepthRenderResources> renderResources : register(b0);
+
+[RootSignature(BindlessRootSignature)]
+[numthreads(8, 8, 1)]
+void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    if (any(dispatchThreadID.xy >= uint2(renderResources.width, renderResources.height)))
+    {
+        return;
+    }
+
+    Texture2D<float> depthTexture = ResourceDescriptorHeap[renderResources.depthTextureIndex];
+    RWTexture2D<float2> pyramidMip0 = ResourceDescriptorHeap[renderResources.pyramidMip0Index];
+
+    const float depth = depthTexture[dispatchThreadID.xy];
+    pyramidMip0[dispatchThreadID.xy] = float2(depth, depth);
+}
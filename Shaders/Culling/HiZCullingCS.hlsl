@@ -0,0 +1,163 @@
+// Occlusion culling of the draws built by the CPU against the depth pyramid, one thread per draw. The draws kept by the phase are appended to the output
+// argument buffer, and their count (read by ExecuteIndirect) is incremented.
+// Mirrors scene::CullHiZDraw (see HiZCulling.cpp), which is verified against a per pixel depth buffer on the CPU : the projection, the selection of the mip
+// and the texels tested must stay in sync with it.
+
+#include "../Common/BindlessRS.hlsli"
+#include "../Common/ConstantBuffers.hlsli"
+
+static const uint THREAD_GROUP_SIZE = 64u;
+static const float INFINITY = asfloat(0x7F800000u);
+
+// HiZCullingPhase.
+static const uint PHASE_FIRST = 0u;
+static const uint PHASE_SECOND = 1u;
+
+// Same layout as IndirectDrawArguments (see IndirectDraw.hpp).
+struct IndirectDrawArguments
+{
+    uint2 indexBufferLocation;
+    uint indexBufferSizeInBytes;
+    uint indexBufferFormat;
+    uint drawIndex;
+    uint indexCountPerInstance;
+    uint instanceCount;
+    uint startIndexLocation;
+    int baseVertexLocation;
+    uint startInstanceLocation;
+};
+
+// Same layout as scene::HiZDrawBounds.
+struct HiZDrawBounds
+{
+    float3 minimum;
+    uint visibilityIndex;
+    float3 maximum;
+    uint padding;
+};
+
+ConstantBuffer<HiZCullingRenderResources> renderResources : register(b0);
+
+uint2 GetMipDimensions(uint mipLevel)
+{
+    return max(uint2(renderResources.pyramidWidth, renderResources.pyramidHeight) >> mipLevel, uint2(1u, 1u));
+}
+
+// See scene::HiZPyramid::IsBoundingBoxOccluded.
+bool IsBoundingBoxOccluded(float3 minimum, float3 maximum, matrix viewProjectionMatrix)
+{
+    if (renderResources.isPyramidValid == 0u)
+    {
+        return false;
+    }
+
+    const float2 dimensions = float2(renderResources.pyramidWidth, renderResources.pyramidHeight);
+
+    float2 minimumScreen = float2(INFINITY, INFINITY);
+    float2 maximumScreen = float2(-INFINITY, -INFINITY);
+    float minimumZ = INFINITY;
+
+    [unroll]
+    for (uint i = 0u; i < 8u; ++i)
+    {
+        const float3 corner = float3((i & 1u) ? maximum.x : minimum.x, (i & 2u) ? maximum.y : minimum.y, (i & 4u) ? maximum.z : minimum.z);
+        const float4 clipPosition = mul(float4(corner, 1.0f), viewProjectionMatrix);
+
+        // Boxes crossing the near plane are never occluded.
+        if (!(clipPosition.w > 0.0f) || clipPosition.z < 0.0f)
+        {
+            return false;
+        }
+
+        const float2 screenPosition = float2(clipPosition.x / clipPosition.w * 0.5f + 0.5f, 0.5f - clipPosition.y / clipPosition.w * 0.5f) * dimensions;
+
+        minimumScreen = min(minimumScreen, screenPosition);
+        maximumScreen = max(maximumScreen, screenPosition);
+        minimumZ = min(minimumZ, clipPosition.z / clipPosition.w);
+    }
+
+    // Boxes outside of the screen are left to the frustum culling.
+    if (any(maximumScreen <= 0.0f) || any(minimumScreen >= dimensions))
+    {
+        return false;
+    }
+
+    // Every pixel the bounds touch.
+    const uint2 pixelBegin = uint2(max(floor(minimumScreen), 0.0f));
+    const uint2 pixelEnd = max(uint2(min(ceil(maximumScreen), dimensions)), pixelBegin + 1u) - 1u;
+
+    // The lowest mip at which the pixels touch at most 2 x 2 texels. The last texel of a mip also covers the last texel of an odd previous mip.
+    uint2 texelBegin = pixelBegin;
+    uint2 texelEnd = pixelEnd;
+    uint mipLevel = 0u;
+
+    while (any(texelEnd - texelBegin > 1u))
+    {
+        if (++mipLevel >= renderResources.pyramidMipCount)
+        {
+            return false;
+        }
+
+        const uint2 lastTexel = GetMipDimensions(mipLevel) - 1u;
+        texelBegin = min(texelBegin >> 1u, lastTexel);
+        texelEnd = min(texelEnd >> 1u, lastTexel);
+    }
+
+    // The maximum depth of the texels is in y (see DownsampleReduction::MinMax).
+    Texture2D<float2> pyramid = ResourceDescriptorHeap[renderResources.pyramidIndex];
+
+    const float maximumDepth = max(max(pyramid.Load(uint3(texelBegin, mipLevel)).y, pyramid.Load(uint3(texelEnd.x, texelBegin.y, mipLevel)).y),
+        max(pyramid.Load(uint3(texelBegin.x, texelEnd.y, mipLevel)).y, pyramid.Load(uint3(texelEnd, mipLevel)).y));
+
+    return minimumZ > maximumDepth;
+}
+
+[RootSignature(BindlessRootSignature)]
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    RWStructuredBuffer<uint> drawCountBuffer = ResourceDescriptorHeap[renderResources.drawCountBufferIndex];
+
+    // The count of the other phase was consumed by its ExecuteIndirect (in the previous frame for the first phase), so it is reset for its next dispatch.
+    if (dispatchThreadID.x == 0u)
+    {
+        drawCountBuffer[renderResources.phase == PHASE_FIRST ? PHASE_SECOND : PHASE_FIRST] = 0u;
+    }
+
+    const uint drawIndex = dispatchThreadID.x;
+    if (drawIndex >= renderResources.drawCount)
+    {
+        return;
+    }
+
+    StructuredBuffer<HiZDrawBounds> drawBoundsBuffer = ResourceDescriptorHeap[renderResources.drawBoundsBufferIndex];
+    RWStructuredBuffer<uint> visibilityBuffer = ResourceDescriptorHeap[renderResources.visibilityBufferIndex];
+
+    const HiZDrawBounds drawBounds = drawBoundsBuffer[drawIndex];
+    const bool wasVisible = visibilityBuffer[drawBounds.visibilityIndex] != 0u;
+
+    // The first phase only draws the draws visible in the previous frame.
+    if (renderResources.phase == PHASE_FIRST && !wasVisible)
+    {
+        return;
+    }
+
+    ConstantBuffer<SceneBuffer> sceneBuffer = ResourceDescriptorHeap[renderResources.sceneBufferIndex];
+
+    const bool isOccluded = IsBoundingBoxOccluded(drawBounds.minimum, drawBounds.maximum, sceneBuffer.viewProjectionMatrix);
+    visibilityBuffer[drawBounds.visibilityIndex] = isOccluded ? 0u : 1u;
+
+    // The second phase draws the visible draws the first phase did not draw.
+    if (isOccluded || (renderResources.phase == PHASE_SECOND && wasVisible))
+    {
+        return;
+    }
+
+    StructuredBuffer<IndirectDrawArguments> argumentBuffer = ResourceDescriptorHeap[renderResources.argumentBufferIndex];
+    RWStructuredBuffer<IndirectDrawArguments> outputArgumentBuffer = ResourceDescriptorHeap[renderResources.outputArgumentBufferIndex];
+
+    uint outputIndex;
+    InterlockedAdd(drawCountBuffer[renderResources.phase], 1u, outputIndex);
+
+    outputArgumentBuffer[renderResources.outputArgumentOffset + outputIndex] = argumentBuffer[drawIndex];
+}
@@ -58,8 +58,6 @@ ConstantBuffer<MipMapGenerationRenderResources> renderResources : register(b0);
 [numthreads(8, 8, 1)]
 void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID, uint groupIndex : SV_GroupIndex)
 {
-    ConstantBuffer<MipMapGenerationBuffer> mipMapBuffer = ResourceDescriptorHeap[renderResources.mipMapGenerationBufferIndex];
-
     Texture2D<float4> sourceMipTexture = ResourceDescriptorHeap[renderResources.sourceMipIndex];
     RWTexture2D<float4> outputMip1Texture = ResourceDescriptorHeap[renderResources.outputMip1Index];
     RWTexture2D<float4> outputMip2Texture = ResourceDescriptorHeap[renderResources.outputMip2Index];
@@ -69,54 +67,56 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID, uint groupIndex : SV_G
     // Color value of current mip level being generated.
     float4 sourceMip1 = float4(0.0f, 0.0f, 0.0f, 0.0f);
 
-    switch (mipMapBuffer.dimensionType)
+    const float2 texelSize = float2(renderResources.texelSizeX, renderResources.texelSizeY);
+
+    switch ((TextureDimensionType)renderResources.dimensionType)
     {
         case TextureDimensionType::HeightWidthEven:
         {
             // This offset is taken so that when we use linear filtering the sampler will sample / blend from four corner pixels of sample location.(i.e bilinear sampling)
-            float2 uvCoords = mipMapBuffer.texelSize * (dispatchThreadID.xy + 0.5);
+            float2 uvCoords = texelSize * (dispatchThreadID.xy + 0.5);
 
-            sourceMip1 = sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, mipMapBuffer.sourceMipLevel);
+            sourceMip1 = sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, renderResources.sourceMipLevel);
         }break;
 
         case TextureDimensionType::HeightWidthOdd:
         {
             // In this case, 4 bilinear samples are chosen to make sure undersampling doesnt occur.
-            float2 uvCoords = mipMapBuffer.texelSize * (dispatchThreadID.xy + float2(0.25f, 0.25f));
-            float2 offset = mipMapBuffer.texelSize * float2(0.5f, 0.5f);
+            float2 uvCoords = texelSize * (dispatchThreadID.xy + float2(0.25f, 0.25f));
+            float2 offset = texelSize * float2(0.5f, 0.5f);
 
-            sourceMip1 = 0.25f * (sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, mipMapBuffer.sourceMipLevel) +
-                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + offset, mipMapBuffer.sourceMipLevel) +
-                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + float2(offset.x, 0.0f), mipMapBuffer.sourceMipLevel) +
-                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + float2(0.0f, offset.y), mipMapBuffer.sourceMipLevel));
+            sourceMip1 = 0.25f * (sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, renderResources.sourceMipLevel) +
+                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + offset, renderResources.sourceMipLevel) +
+                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + float2(offset.x, 0.0f), renderResources.sourceMipLevel) +
+                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + float2(0.0f, offset.y), renderResources.sourceMipLevel));
 
         }break;
 
         case TextureDimensionType::HeightOddWidthEven:
         {
             // In this case, 2 bilinear samples are chosen to make sure undersampling doesnt occur.
-            float2 uvCoords = mipMapBuffer.texelSize * (dispatchThreadID.xy + float2(0.5f, 0.25f));
-            float2 offset = mipMapBuffer.texelSize * float2(0.0f, 0.5f);
+            float2 uvCoords = texelSize * (dispatchThreadID.xy + float2(0.5f, 0.25f));
+            float2 offset = texelSize * float2(0.0f, 0.5f);
 
-            sourceMip1 = 0.5f * (sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, mipMapBuffer.sourceMipLevel) +
-                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + offset, mipMapBuffer.sourceMipLevel));
+            sourceMip1 = 0.5f * (sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, renderResources.sourceMipLevel) +
+                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + offset, renderResources.sourceMipLevel));
         }break;
 
         case TextureDimensionType::HeightEvenWidthOdd:
         {
             // In this case, 2 bilinear samples are chosen to make sure undersampling doesnt occur.
-            float2 uvCoords = mipMapBuffer.texelSize * (dispatchThreadID.xy + float2(0.25f, 0.5f));
-            float2 offset = mipMapBuffer.texelSize * float2(0.5f, 0.0f);
+            float2 uvCoords = texelSize * (dispatchThreadID.xy + float2(0.25f, 0.5f));
+            float2 offset = texelSize * float2(0.5f, 0.0f);
 
-            sourceMip1 = 0.5f * (sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, mipMapBuffer.sourceMipLevel) +
-                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + offset, mipMapBuffer.sourceMipLevel));
+            sourceMip1 = 0.5f * (sourceMipTexture.SampleLevel(linearClampSampler, uvCoords, renderResources.sourceMipLevel) +
+                sourceMipTexture.SampleLevel(linearClampSampler, uvCoords + offset, renderResources.sourceMipLevel));
 
         }break;
     }
 
-    outputMip1Texture[dispatchThreadID.xy] = PackColor(sourceMip1, mipMapBuffer.isSRGB);
+    outputMip1Texture[dispatchThreadID.xy] = PackColor(sourceMip1, renderResources.isSRGB);
 
-    if (mipMapBuffer.numberMipLevels == 1)
+    if (renderResources.numberMipLevels == 1)
     {
         return;
     }
@@ -134,11 +134,11 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID, uint groupIndex : SV_G
         float4 sourceMip4 = LoadColor(groupIndex + 0x09); // color right - below current thread (check reference linked above for explanation).
         sourceMip1 = 0.25 * (sourceMip1 + sourceMip2 + sourceMip3 + sourceMip4);
 
-        outputMip2Texture[dispatchThreadID.xy / 2] = PackColor(sourceMip1, mipMapBuffer.isSRGB);
+        outputMip2Texture[dispatchThreadID.xy / 2] = PackColor(sourceMip1, renderResources.isSRGB);
         StoreColor(groupIndex, sourceMip1);
     }
 
-    if (mipMapBuffer.numberMipLevels == 2)
+    if (renderResources.numberMipLevels == 2)
     {
         return;
     }
@@ -154,11 +154,11 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID, uint groupIndex : SV_G
         float4 sourceMip4 = LoadColor(groupIndex + 0x12); 
         sourceMip1 = 0.25 * (sourceMip1 + sourceMip2 + sourceMip3 + sourceMip4);
 
-        outputMip3Texture[dispatchThreadID.xy / 4] = PackColor(sourceMip1, mipMapBuffer.isSRGB);
+        outputMip3Texture[dispatchThreadID.xy / 4] = PackColor(sourceMip1, renderResources.isSRGB);
         StoreColor(groupIndex, sourceMip1);
     }
 
-    if (mipMapBuffer.numberMipLevels == 3)
+    if (renderResources.numberMipLevels == 3)
     {
         return;
     }
@@ -174,6 +174,6 @@ void CsMain(uint3 dispatchThreadID : SV_DispatchThreadID, uint groupIndex : SV_G
         float4 sourceMip4 = LoadColor(groupIndex + 0x24); 
         sourceMip1 = 0.25 * (sourceMip1 + sourceMip2 + sourceMip3 + sourceMip4);
 
-        outputMip4Texture[dispatchThreadID.xy / 8] = PackColor(sourceMip1, mipMapBuffer.isSRGB);
+        outputMip4Texture[dispatchThreadID.xy / 8] = PackColor(sourceMip1, renderResources.isSRGB);
     }
 }
\ No newline at end of file
@@ -0,0 +1,300 @@
+// Primary reference : https://github.com/GPUOpen-Effects/FidelityFX-SPD.
+// Generates up to 12 mips with a single dispatch : each thread group reduces a 64 x 64 tile of the source into mips 1 to 6 (in group shared memory), and the last thread group
+// to complete (found using a global atomic counter) fixes up the last row / column of odd sized mips and generates the remaining mips.
+// The indexing is mirrored by EmulateSinglePassDownsample (see SinglePassDownsampler.cpp), which is verified against the reference implementation on the CPU.
+
+#include "../Common/BindlessRS.hlsli"
+
+static const uint TILE_DIMENSION = 64u;
+static const uint MIP1_TILE_DIMENSION = TILE_DIMENSION / 2u;
+static const uint GROUP_MIP_COUNT = 6u;
+static const uint THREAD_GROUP_SIZE = 256u;
+
+// DownsampleReduction.
+static const uint REDUCTION_AVERAGE = 0u;
+static const uint REDUCTION_MIN = 1u;
+static const uint REDUCTION_MAX = 2u;
+static const uint REDUCTION_MINMAX = 3u;
+
+// Reciprocals of the footprint texel counts, indexed by the count (same bit patterns as FOOTPRINT_RECIPROCAL_BITS in SinglePassDownsampler.cpp).
+static const uint FOOTPRINT_RECIPROCAL_BITS[10] = { 0x00000000u, 0x3F800000u, 0x3F000000u, 0x3EAAAAABu, 0x3E800000u, 0x00000000u, 0x3E2AAAABu, 0x00000000u, 0x00000000u, 0x3DE38E39u };
+
+ConstantBuffer<SinglePassDownsampleRenderResources> renderResources : register(b0);
+
+groupshared float4 groupSharedTexels[MIP1_TILE_DIMENSION][MIP1_TILE_DIMENSION];
+groupshared uint groupSharedPreviousCounterValue;
+
+// Source: https://en.wikipedia.org/wiki/SRGB#The_reverse_transformation
+float3 ConvertToLinear(float3 x)
+{
+    return x < 0.04045f ? x / 12.92 : pow((x + 0.055) / 1.055, 2.4);
+}
+
+// Source: https://en.wikipedia.org/wiki/SRGB#The_forward_transformation_(CIE_XYZ_to_sRGB)
+float3 ConvertToSRGB(float3 x)
+{
+    return x < 0.0031308 ? 12.92 * x : 1.055 * pow(abs(x), 1.0 / 2.4) - 0.055;
+}
+
+uint GetMipIndex(uint mipLevel)
+{
+    switch (mipLevel)
+    {
+        case 0u: return renderResources.mip0Index;
+        case 1u: return renderResources.mip1Index;
+        case 2u: return renderResources.mip2Index;
+        case 3u: return renderResources.mip3Index;
+        case 4u: return renderResources.mip4Index;
+        case 5u: return renderResources.mip5Index;
+        case 6u: return renderResources.mip6Index;
+        case 7u: return renderResources.mip7Index;
+        case 8u: return renderResources.mip8Index;
+        case 9u: return renderResources.mip9Index;
+        case 10u: return renderResources.mip10Index;
+        case 11u: return renderResources.mip11Index;
+        default: return renderResources.mip12Index;
+    }
+}
+
+uint2 GetMipDimensions(uint mipLevel)
+{
+    return max(uint2(renderResources.width, renderResources.height) >> mipLevel, uint2(1u, 1u));
+}
+
+// The mips are written by other thread groups, so they are accessed as globally coherent (bypassing the group's caches).
+float4 LoadMip(uint mipLevel, uint2 coords)
+{
+    globallycoherent RWTexture2D<float4> mip = ResourceDescriptorHeap[GetMipIndex(mipLevel)];
+
+    const float4 color = mip[coords];
+    return renderResources.isSRGB ? float4(ConvertToLinear(color.rgb), color.a) : color;
+}
+
+void StoreMip(uint mipLevel, uint2 coords, float4 color)
+{
+    globallycoherent RWTexture2D<float4> mip = ResourceDescriptorHeap[GetMipIndex(mipLevel)];
+
+    mip[coords] = renderResources.isSRGB ? float4(ConvertToSRGB(color.rgb), color.a) : color;
+}
+
+// Values are combined in row major order, and are marked precise so the compiler does not reorder (or fuse) the operations : results match the CPU reference bit for bit.
+float4 Combine(float4 accumulated, float4 value)
+{
+    precise float4 result;
+
+    switch (renderResources.reduction)
+    {
+        case REDUCTION_MIN:
+        {
+            result = min(accumulated, value);
+        }break;
+
+        case REDUCTION_MAX:
+        {
+            result = max(accumulated, value);
+        }break;
+
+        // Minimum in x / z, maximum in y / w.
+        case REDUCTION_MINMAX:
+        {
+            result = float4(min(accumulated.xz, value.xz), max(accumulated.yw, value.yw)).xzyw;
+        }break;
+
+        default:
+        {
+            result = accumulated + value;
+        }break;
+    }
+
+    return result;
+}
+
+float4 Resolve(float4 accumulated, uint texelCount)
+{
+    if (renderResources.reduction != REDUCTION_AVERAGE)
+    {
+        return accumulated;
+    }
+
+    precise float4 result = accumulated * asfloat(FOOTPRINT_RECIPROCAL_BITS[texelCount]);
+    return result;
+}
+
+// Source texels [x, y) along one axis : two texels, except for the last destination texel of an odd source dimension (which also reduces the last source texel).
+uint2 GetFootprint(uint destinationIndex, uint sourceDimension)
+{
+    const uint destinationDimension = max(sourceDimension >> 1u, 1u);
+    return uint2(destinationIndex * 2u, destinationIndex == destinationDimension - 1u ? sourceDimension : destinationIndex * 2u + 2u);
+}
+
+float4 ReduceFootprint(uint mipLevel, uint2 coords)
+{
+    const uint2 sourceDimensions = GetMipDimensions(mipLevel - 1u);
+    const uint2 footprintX = GetFootprint(coords.x, sourceDimensions.x);
+    const uint2 footprintY = GetFootprint(coords.y, sourceDimensions.y);
+
+    precise float4 accumulated = LoadMip(mipLevel - 1u, uint2(footprintX.x, footprintY.x));
+    for (uint sourceY = footprintY.x; sourceY < footprintY.y; ++sourceY)
+    {
+        for (uint sourceX = footprintX.x; sourceX < footprintX.y; ++sourceX)
+        {
+            if (sourceX != footprintX.x || sourceY != footprintY.x)
+            {
+                accumulated = Combine(accumulated, LoadMip(mipLevel - 1u, uint2(sourceX, sourceY)));
+            }
+        }
+    }
+
+    return Resolve(accumulated, (footprintX.y - footprintX.x) * (footprintY.y - footprintY.x));
+}
+
+// The tiles only reduce 2 x 2 texels, so the last group is required if a mip generated by them has an odd sized previous mip, or if there are mips left after them.
+bool IsLastGroupRequired(uint groupMipCount)
+{
+    bool isRequired = renderResources.mipCount > GROUP_MIP_COUNT;
+
+    for (uint mipLevel = 0u; mipLevel < groupMipCount; ++mipLevel)
+    {
+        isRequired = isRequired || any(GetMipDimensions(mipLevel) % 2u != 0u);
+    }
+
+    return isRequired;
+}
+
+[RootSignature(BindlessRootSignature)]
+[numthreads(THREAD_GROUP_SIZE, 1, 1)]
+void CsMain(uint3 groupID : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const uint groupMipCount = min(renderResources.mipCount, GROUP_MIP_COUNT);
+
+    const uint2 sourceDimensions = GetMipDimensions(0u);
+    const uint2 mip1Dimensions = GetMipDimensions(1u);
+
+    // Mip 1 : 2 x 2 texels of the source (clamped to its dimensions, as the tiles at the edges extend past them). Each thread reduces 4 texels of the tile.
+    for (uint localIndex = groupIndex; localIndex < MIP1_TILE_DIMENSION * MIP1_TILE_DIMENSION; localIndex += THREAD_GROUP_SIZE)
+    {
+        const uint2 localCoords = uint2(localIndex % MIP1_TILE_DIMENSION, localIndex / MIP1_TILE_DIMENSION);
+        const uint2 coords = groupID.xy * MIP1_TILE_DIMENSION + localCoords;
+
+        precise float4 accumulated = LoadMip(0u, min(coords * 2u, sourceDimensions - 1u));
+        accumulated = Combine(accumulated, LoadMip(0u, min(coords * 2u + uint2(1u, 0u), sourceDimensions - 1u)));
+        accumulated = Combine(accumulated, LoadMip(0u, min(coords * 2u + uint2(0u, 1u), sourceDimensions - 1u)));
+        accumulated = Combine(accumulated, LoadMip(0u, min(coords * 2u + uint2(1u, 1u), sourceDimensions - 1u)));
+
+        const float4 value = Resolve(accumulated, 4u);
+
+        groupSharedTexels[localCoords.y][localCoords.x] = value;
+
+        if (all(coords < mip1Dimensions))
+        {
+            StoreMip(1u, coords, value);
+        }
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    // Mips 2 to 6 : 2 x 2 texels of the previous mip's tile, which is written back into the top left corner of group shared memory.
+    for (uint mipLevel = 2u; mipLevel <= groupMipCount; ++mipLevel)
+    {
+        const uint tileDimension = TILE_DIMENSION >> mipLevel;
+        const uint2 localCoords = uint2(groupIndex % tileDimension, groupIndex / tileDimension);
+        const bool isActive = groupIndex < tileDimension * tileDimension;
+
+        float4 value = float4(0.0f, 0.0f, 0.0f, 0.0f);
+        if (isActive)
+        {
+            precise float4 accumulated = groupSharedTexels[localCoords.y * 2u][localCoords.x * 2u];
+            accumulated = Combine(accumulated, groupSharedTexels[localCoords.y * 2u][localCoords.x * 2u + 1u]);
+            accumulated = Combine(accumulated, groupSharedTexels[localCoords.y * 2u + 1u][localCoords.x * 2u]);
+            accumulated = Combine(accumulated, groupSharedTexels[localCoords.y * 2u + 1u][localCoords.x * 2u + 1u]);
+
+            value = Resolve(accumulated, 4u);
+        }
+
+        // All threads read the previous mip's tile before it is overwritten.
+        GroupMemoryBarrierWithGroupSync();
+
+        if (isActive)
+        {
+            groupSharedTexels[localCoords.y][localCoords.x] = value;
+
+            const uint2 coords = groupID.xy * tileDimension + localCoords;
+            if (all(coords < GetMipDimensions(mipLevel)))
+            {
+                StoreMip(mipLevel, coords, value);
+            }
+        }
+
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (!IsLastGroupRequired(groupMipCount))
+    {
+        return;
+    }
+
+    // Makes the mips written by the group visible to the last group, before signalling that the group has completed.
+    DeviceMemoryBarrierWithGroupSync();
+
+    globallycoherent RWStructuredBuffer<uint> counterBuffer = ResourceDescriptorHeap[renderResources.counterBufferIndex];
+
+    if (groupIndex == 0u)
+    {
+        uint previousCounterValue = 0u;
+        InterlockedAdd(counterBuffer[renderResources.counterIndex], 1u, previousCounterValue);
+
+        groupSharedPreviousCounterValue = previousCounterValue;
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint2 threadGroupCount = (mip1Dimensions + MIP1_TILE_DIMENSION - 1u) / MIP1_TILE_DIMENSION;
+    if (groupSharedPreviousCounterValue != threadGroupCount.x * threadGroupCount.y - 1u)
+    {
+        return;
+    }
+
+    // Last group : all other groups have completed, so the counter can be reset for the next dispatch using it.
+    if (groupIndex == 0u)
+    {
+        counterBuffer[renderResources.counterIndex] = 0u;
+    }
+
+    // The last column (row) of a mip is wrong if the previous mip's width (height) is odd, or if its last column (row) was wrong.
+    bool isLastColumnWrong = false;
+    bool isLastRowWrong = false;
+
+    for (uint mipLevel = 1u; mipLevel <= groupMipCount; ++mipLevel)
+    {
+        const uint2 previousMipDimensions = GetMipDimensions(mipLevel - 1u);
+        const uint2 mipDimensions = GetMipDimensions(mipLevel);
+
+        isLastColumnWrong = isLastColumnWrong || previousMipDimensions.x % 2u != 0u;
+        isLastRowWrong = isLastRowWrong || previousMipDimensions.y % 2u != 0u;
+
+        const uint columnTexelCount = isLastColumnWrong ? mipDimensions.y : 0u;
+        const uint rowTexelCount = isLastRowWrong ? mipDimensions.x - (isLastColumnWrong ? 1u : 0u) : 0u;
+
+        for (uint index = groupIndex; index < columnTexelCount + rowTexelCount; index += THREAD_GROUP_SIZE)
+        {
+            const uint2 coords = index < columnTexelCount ? uint2(mipDimensions.x - 1u, index) : uint2(index - columnTexelCount, mipDimensions.y - 1u);
+            StoreMip(mipLevel, coords, ReduceFootprint(mipLevel, coords));
+        }
+
+        DeviceMemoryBarrierWithGroupSync();
+    }
+
+    // Remaining mips, from mip 6.
+    for (uint remainingMipLevel = GROUP_MIP_COUNT + 1u; remainingMipLevel <= renderResources.mipCount; ++remainingMipLevel)
+    {
+        const uint2 mipDimensions = GetMipDimensions(remainingMipLevel);
+
+        for (uint index = groupIndex; index < mipDimensions.x * mipDimensions.y; index += THREAD_GROUP_SIZE)
+        {
+            const uint2 coords = uint2(index % mipDimensions.x, index / mipDimensions.x);
+            StoreMip(remainingMipLevel, coords, ReduceFootprint(remainingMipLevel, coords));
+        }
+
+        DeviceMemoryBarrierWithGroupSync();
+    }
+}
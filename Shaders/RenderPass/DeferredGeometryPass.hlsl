@@ -11,11 +11,14 @@ struct VSOutput
     float3x3 tbnMatrix : TBN_MATRIX;
 };
 
-ConstantBuffer<PBRRenderResources> renderResource : register(b0);
+// The draws are executed indirectly : the root constants only index the draw data of the draw (see Scene::RenderModelsIndirect).
+ConstantBuffer<IndirectDrawRenderResources> indirectDrawRenderResource : register(b0);
 
 [RootSignature(BindlessRootSignature)]
 VSOutput VsMain(uint vertexID : SV_VertexID)
 {
+    PBRRenderResources renderResource = GetIndirectDrawRenderResources(indirectDrawRenderResource);
+
     StructuredBuffer<float3> positionBuffer = ResourceDescriptorHeap[renderResource.positionBufferIndex];
     StructuredBuffer<float2> textureCoordBuffer = ResourceDescriptorHeap[renderResource.textureBufferIndex];
     StructuredBuffer<float3> normalBuffer = ResourceDescriptorHeap[renderResource.normalBufferIndex];
@@ -23,11 +26,13 @@ VSOutput VsMain(uint vertexID : SV_VertexID)
     ConstantBuffer<SceneBuffer> sceneBuffer = ResourceDescriptorHeap[renderResource.sceneBufferIndex];
     ConstantBuffer<TransformBuffer> transformBuffer = ResourceDescriptorHeap[renderResource.transformBufferIndex];
 
-    matrix mvpMatrix = mul(transformBuffer.modelMatrix, sceneBuffer.viewProjectionMatrix);
+    // Note : The position must be computed exactly as in DepthPrePass.hlsl, as the depth written by the pre-pass is tested for equality.
+    precise matrix mvpMatrix = mul(transformBuffer.modelMatrix, sceneBuffer.viewProjectionMatrix);
     float3x3 normalMatrix = (float3x3)transpose(transformBuffer.inverseModelMatrix);
 
     VSOutput output;
-    output.position = mul(float4(positionBuffer[vertexID], 1.0f), mvpMatrix);
+    precise float4 position = mul(float4(positionBuffer[vertexID], 1.0f), mvpMatrix);
+    output.position = position;
     output.textureCoord = textureCoordBuffer[vertexID];
     output.normal = normalBuffer[vertexID];
     output.worldSpacePosition = mul(float4(positionBuffer[vertexID], 1.0f), transformBuffer.modelMatrix).xyz;
@@ -59,6 +64,8 @@ struct PsOutput
 [RootSignature(BindlessRootSignature)]
 PsOutput PsMain(VSOutput psInput) 
 {
+    PBRRenderResources renderResource = GetIndirectDrawRenderResources(indirectDrawRenderResource);
+
     PsOutput output;
 
     output.albedo = GetAlbedo(psInput.textureCoord, renderResource.albedoTextureIndex, renderResource.albedoTextureSamplerIndex);
@@ -0,0 +1,48 @@
+#include "../Common/BindlessRS.hlsli"
+#include "../Common/ConstantBuffers.hlsli"
+#include "../Common/Utils.hlsli"
+
+// Depth only pass of the deferred geometry pass : the G-Buffer is then rendered with an EQUAL depth test, so each pixel is shaded (and written) once.
+struct VSOutput
+{
+    float4 position : SV_Position;
+    float2 textureCoord : TEXTURE_COORD;
+};
+
+// The draws are executed indirectly : the root constants only index the draw data of the draw (see Scene::RenderModelsIndirect).
+ConstantBuffer<IndirectDrawRenderResources> indirectDrawRenderResource : register(b0);
+
+[RootSignature(BindlessRootSignature)]
+VSOutput VsMain(uint vertexID : SV_VertexID)
+{
+    PBRRenderResources renderResource = GetIndirectDrawRenderResources(indirectDrawRenderResource);
+
+    StructuredBuffer<float3> positionBuffer = ResourceDescriptorHeap[renderResource.positionBufferIndex];
+    StructuredBuffer<float2> textureCoordBuffer = ResourceDescriptorHeap[renderResource.textureBufferIndex];
+
+    ConstantBuffer<SceneBuffer> sceneBuffer = ResourceDescriptorHeap[renderResource.sceneBufferIndex];
+    ConstantBuffer<TransformBuffer> transformBuffer = ResourceDescriptorHeap[renderResource.transformBufferIndex];
+
+    // Note : Must match the computation of the position in DeferredGeometryPass.hlsl.
+    precise matrix mvpMatrix = mul(transformBuffer.modelMatrix, sceneBuffer.viewProjectionMatrix);
+
+    VSOutput output;
+    precise float4 position = mul(float4(positionBuffer[vertexID], 1.0f), mvpMatrix);
+    output.position = position;
+    output.textureCoord = textureCoordBuffer[vertexID];
+
+    return output;
+}
+
+// Same alpha test as the G-Buffer pass, so the pixels it discards do not occlude the geometry behind them.
+[RootSignature(BindlessRootSignature)]
+void PsMain(VSOutput psInput)
+{
+    PBRRenderResources renderResource = GetIndirectDrawRenderResources(indirectDrawRenderResource);
+
+    float4 albedo = GetAlbedo(psInput.textureCoord, renderResource.albedoTextureIndex, renderResource.albedoTextureSamplerIndex);
+    if (albedo.a < 0.9f)
+    {
+        discard;
+    }
+}
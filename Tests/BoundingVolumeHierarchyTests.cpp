@@ -0,0 +1,392 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Scene/BoundingVolumeHierarchy.hpp"
+#include "Scene/FrustumCulling.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Bounding volume hierarchy";
+
+	// Boxes of size [0.5, 4] in a cube of half extent worldExtent. Some share their center, so the builder has to split nodes it cannot bin.
+	std::vector<scene::BoundingBox> CreateRandomBoundingBoxes(uint32_t count, float worldExtent, std::mt19937& randomEngine)
+	{
+		std::uniform_real_distribution<float> positionDistribution(-worldExtent, worldExtent);
+		std::uniform_real_distribution<float> sizeDistribution(0.25f, 2.0f);
+
+		std::vector<scene::BoundingBox> boundingBoxes(count);
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			const scene::Float3 center = i % 16u == 15u ? scene::Float3{ 1.0f, 2.0f, 3.0f } :
+				scene::Float3{ positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) };
+			const scene::Float3 extent{ sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine) };
+
+			boundingBoxes[i] = scene::BoundingBox
+			{
+				.minimum = { center[0] - extent[0], center[1] - extent[1], center[2] - extent[2] },
+				.maximum = { center[0] + extent[0], center[1] + extent[1], center[2] + extent[2] },
+			};
+		}
+
+		return boundingBoxes;
+	}
+
+	scene::Ray CreateRandomRay(float worldExtent, std::mt19937& randomEngine)
+	{
+		std::uniform_real_distribution<float> positionDistribution(-worldExtent, worldExtent);
+		std::uniform_real_distribution<float> directionDistribution(-1.0f, 1.0f);
+
+		return scene::Ray
+		{
+			.origin = { positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) },
+			.direction = { directionDistribution(randomEngine), directionDistribution(randomEngine), directionDistribution(randomEngine) },
+			.maxDistance = randomEngine() % 2u == 0u ? std::numeric_limits<float>::infinity() : worldExtent,
+		};
+	}
+
+	// Brute force references for the queries.
+	std::vector<uint32_t> CullBoundingBoxesBruteForce(std::span<const scene::Plane> planes, std::span<const scene::BoundingBox> boundingBoxes)
+	{
+		scene::BoundingBoxSoA boundingBoxesSoA{};
+		boundingBoxesSoA.Resize(static_cast<uint32_t>(boundingBoxes.size()));
+		for (uint32_t i = 0u; i < static_cast<uint32_t>(boundingBoxes.size()); ++i)
+		{
+			boundingBoxesSoA.Set(i, boundingBoxes[i]);
+		}
+
+		std::vector<uint8_t> visibility(boundingBoxes.size());
+		scene::CullBoundingBoxes(planes, boundingBoxesSoA, visibility, scene::CullingImplementation::Scalar);
+
+		std::vector<uint32_t> objectIndices{};
+		for (uint32_t i = 0u; i < static_cast<uint32_t>(boundingBoxes.size()); ++i)
+		{
+			if (visibility[i] != 0u)
+			{
+				objectIndices.push_back(i);
+			}
+		}
+
+		return objectIndices;
+	}
+
+	std::vector<scene::RayHit> QueryRayBruteForce(const scene::Ray& ray, std::span<const scene::BoundingBox> boundingBoxes)
+	{
+		std::vector<scene::RayHit> rayHits{};
+		for (uint32_t i = 0u; i < static_cast<uint32_t>(boundingBoxes.size()); ++i)
+		{
+			if (const std::optional<float> distance = scene::IntersectRayBoundingBox(ray, boundingBoxes[i]); distance.has_value())
+			{
+				rayHits.push_back(scene::RayHit{ .objectIndex = i, .distance = *distance });
+			}
+		}
+
+		std::sort(rayHits.begin(), rayHits.end(), [](const scene::RayHit& a, const scene::RayHit& b)
+		{
+			return a.distance < b.distance || (a.distance == b.distance && a.objectIndex < b.objectIndex);
+		});
+
+		return rayHits;
+	}
+
+	// Runs random convex volume, sphere and ray queries on the hierarchy, and compares them with brute force over boundingBoxes.
+	bool CompareBvhQueries(const char* caseName, const scene::BoundingVolumeHierarchy& boundingVolumeHierarchy, std::span<const scene::BoundingBox> boundingBoxes,
+		float worldExtent, std::mt19937& randomEngine)
+	{
+		const auto Sorted = [](std::vector<uint32_t> objectIndices)
+		{
+			std::sort(objectIndices.begin(), objectIndices.end());
+			return objectIndices;
+		};
+
+		std::uniform_real_distribution<float> unitDistribution(-1.0f, 1.0f);
+
+		for (uint32_t queryIndex = 0u; queryIndex < 16u; ++queryIndex)
+		{
+			// The camera frustum, and random convex volumes (with planes facing random directions).
+			std::vector<scene::Plane> planes{};
+			if (queryIndex == 0u)
+			{
+				const scene::Frustum frustum = scene::ExtractFrustum(scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, worldExtent));
+				planes.assign(frustum.planes.begin(), frustum.planes.end());
+			}
+			else
+			{
+				for (uint32_t planeIndex = 0u; planeIndex < 1u + queryIndex % 8u; ++planeIndex)
+				{
+					scene::Float3 normal{ unitDistribution(randomEngine), unitDistribution(randomEngine), unitDistribution(randomEngine) };
+					const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+					planes.push_back(scene::Plane{ normal[0] / length, normal[1] / length, normal[2] / length, unitDistribution(randomEngine) * worldExtent * 0.5f + worldExtent * 0.25f });
+				}
+			}
+
+			std::vector<uint32_t> objectIndices{};
+			boundingVolumeHierarchy.QueryConvexVolume(planes, objectIndices);
+			if (!Expect(SUITE_NAME, Sorted(objectIndices) == CullBoundingBoxesBruteForce(planes, boundingBoxes), caseName, "the convex volume query to match brute force"))
+			{
+				return false;
+			}
+
+			const scene::BoundingSphere boundingSphere
+			{
+				.center = { unitDistribution(randomEngine) * worldExtent, unitDistribution(randomEngine) * worldExtent, unitDistribution(randomEngine) * worldExtent },
+				.radius = (unitDistribution(randomEngine) + 1.0f) * worldExtent * 0.25f,
+			};
+
+			std::vector<uint32_t> referenceObjectIndices{};
+			for (uint32_t i = 0u; i < static_cast<uint32_t>(boundingBoxes.size()); ++i)
+			{
+				if (scene::IntersectSphereBoundingBox(boundingSphere, boundingBoxes[i]))
+				{
+					referenceObjectIndices.push_back(i);
+				}
+			}
+
+			objectIndices.clear();
+			boundingVolumeHierarchy.QuerySphere(boundingSphere, objectIndices);
+			if (!Expect(SUITE_NAME, Sorted(objectIndices) == referenceObjectIndices, caseName, "the sphere query to match brute force"))
+			{
+				return false;
+			}
+
+			const scene::Ray ray = CreateRandomRay(worldExtent, randomEngine);
+			const std::vector<scene::RayHit> referenceRayHits = QueryRayBruteForce(ray, boundingBoxes);
+
+			std::vector<scene::RayHit> rayHits{};
+			boundingVolumeHierarchy.QueryRay(ray, rayHits);
+
+			const auto IsSameRayHit = [](const scene::RayHit& a, const scene::RayHit& b) { return a.objectIndex == b.objectIndex && a.distance == b.distance; };
+			if (!Expect(SUITE_NAME, std::equal(rayHits.begin(), rayHits.end(), referenceRayHits.begin(), referenceRayHits.end(), IsSameRayHit), caseName,
+				"the ray query to match brute force"))
+			{
+				return false;
+			}
+
+			const std::optional<scene::RayHit> closestRayHit = boundingVolumeHierarchy.QueryClosestRayHit(ray);
+			if (!Expect(SUITE_NAME, closestRayHit.has_value() == !referenceRayHits.empty() && (!closestRayHit.has_value() || IsSameRayHit(*closestRayHit, referenceRayHits.front())),
+				caseName, "the closest ray hit to match brute force"))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+bool VerifyBoundingVolumeHierarchy()
+{
+	// Slab test : hits from outside, from inside, along an axis (with direction components of 0), and misses.
+	{
+		const scene::BoundingBox boundingBox{ .minimum = { -1.0f, -1.0f, -1.0f }, .maximum = { 1.0f, 1.0f, 1.0f } };
+
+		const std::optional<float> frontHit = scene::IntersectRayBoundingBox(scene::Ray{ .origin = { 0.0f, 0.0f, -10.0f }, .direction = { 0.0f, 0.0f, 1.0f } }, boundingBox);
+		const std::optional<float> scaledHit = scene::IntersectRayBoundingBox(scene::Ray{ .origin = { -10.0f, 0.5f, 0.0f }, .direction = { 2.0f, 0.0f, 0.0f } }, boundingBox);
+		const std::optional<float> insideHit = scene::IntersectRayBoundingBox(scene::Ray{ .origin = { 0.5f, 0.5f, 0.5f }, .direction = { 1.0f, 1.0f, 0.0f } }, boundingBox);
+
+		if (!Expect(SUITE_NAME, frontHit.has_value() && *frontHit == 9.0f, "Ray along +Z", "a hit at distance 9") ||
+			!Expect(SUITE_NAME, scaledHit.has_value() && *scaledHit == 4.5f, "Ray along +X", "a hit at distance 4.5 (in units of the direction length)") ||
+			!Expect(SUITE_NAME, insideHit.has_value() && *insideHit == 0.0f, "Ray from inside", "a hit at distance 0") ||
+			!Expect(SUITE_NAME, !scene::IntersectRayBoundingBox(scene::Ray{ .origin = { 0.0f, 0.0f, -10.0f }, .direction = { 0.0f, 0.0f, -1.0f } }, boundingBox).has_value(),
+				"Ray pointing away", "no hit") ||
+			!Expect(SUITE_NAME, !scene::IntersectRayBoundingBox(scene::Ray{ .origin = { 0.0f, 2.0f, -10.0f }, .direction = { 0.0f, 0.0f, 1.0f } }, boundingBox).has_value(),
+				"Ray passing above", "no hit") ||
+			!Expect(SUITE_NAME, !scene::IntersectRayBoundingBox(scene::Ray{ .origin = { 0.0f, 0.0f, -10.0f }, .direction = { 0.0f, 0.0f, 1.0f }, .maxDistance = 8.0f }, boundingBox).has_value(),
+				"Ray ending before the box", "no hit") ||
+			!Expect(SUITE_NAME, scene::IntersectSphereBoundingBox(scene::BoundingSphere{ .center = { 2.0f, 2.0f, 0.0f }, .radius = 1.5f }, boundingBox) &&
+				!scene::IntersectSphereBoundingBox(scene::BoundingSphere{ .center = { 2.0f, 2.0f, 0.0f }, .radius = 1.4f }, boundingBox),
+				"Sphere near a corner", "an intersection only if the radius exceeds sqrt(2)"))
+		{
+			return false;
+		}
+	}
+
+	std::mt19937 randomEngine(42u);
+	uint32_t comparedHierarchyCount{};
+
+	// 40000 objects exercise the parallel binning, and the small parallel threshold the parallel split of the nodes.
+	for (const uint32_t count : { 0u, 1u, 2u, 7u, 100u, 5000u, 40000u })
+	{
+		const float worldExtent = 10.0f * std::cbrt(static_cast<float>(std::max(count, 1u)));
+
+		for (const uint32_t parallelObjectCount : { 0u, 64u })
+		{
+			std::vector<scene::BoundingBox> boundingBoxes = CreateRandomBoundingBoxes(count, worldExtent, randomEngine);
+
+			scene::BoundingVolumeHierarchy boundingVolumeHierarchy{};
+			boundingVolumeHierarchy.Build(boundingBoxes, scene::BoundingVolumeHierarchyBuildDesc{ .parallelObjectCount = parallelObjectCount });
+
+			const std::string caseName = std::to_string(count) + (parallelObjectCount == 0u ? " objects (serial build)" : " objects (parallel build)");
+			if (!Expect(SUITE_NAME, boundingVolumeHierarchy.GetObjectCount() == count && boundingVolumeHierarchy.GetNodeCount() <= std::max(2u * count, 1u) - 1u &&
+				boundingVolumeHierarchy.GetSahCost() == boundingVolumeHierarchy.GetBuildSahCost(), caseName.c_str(), "at most 2n - 1 nodes") ||
+				!CompareBvhQueries(caseName.c_str(), boundingVolumeHierarchy, boundingBoxes, worldExtent, randomEngine))
+			{
+				return false;
+			}
+
+			// Moves a quarter of the objects, and refits.
+			std::uniform_real_distribution<float> offsetDistribution(-worldExtent * 0.25f, worldExtent * 0.25f);
+			for (uint32_t i = 0u; i < count; i += 4u)
+			{
+				const scene::Float3 offset{ offsetDistribution(randomEngine), offsetDistribution(randomEngine), offsetDistribution(randomEngine) };
+				for (size_t axis = 0u; axis < 3u; ++axis)
+				{
+					boundingBoxes[i].minimum[axis] += offset[axis];
+					boundingBoxes[i].maximum[axis] += offset[axis];
+				}
+
+				boundingVolumeHierarchy.UpdateObject(i, boundingBoxes[i]);
+			}
+
+			const uint32_t refitNodeCount = boundingVolumeHierarchy.Refit();
+			const std::string refitCaseName = caseName + " after refit";
+			if (!Expect(SUITE_NAME, (refitNodeCount != 0u) == (count != 0u) && refitNodeCount <= boundingVolumeHierarchy.GetNodeCount() && boundingVolumeHierarchy.Refit() == 0u,
+				refitCaseName.c_str(), "each moved node to be refit once") ||
+				!CompareBvhQueries(refitCaseName.c_str(), boundingVolumeHierarchy, boundingBoxes, worldExtent, randomEngine))
+			{
+				return false;
+			}
+
+			++comparedHierarchyCount;
+		}
+	}
+
+	std::printf("Bounding volume hierarchy : %u hierarchies match brute force (before and after refits)\n", comparedHierarchyCount);
+
+	return true;
+}
+
+void BenchmarkBoundingVolumeHierarchy()
+{
+	static constexpr uint32_t QUERY_COUNT = 100u;
+
+	for (const uint32_t count : { 10'000u, 100'000u, 1'000'000u })
+	{
+		const float worldExtent = 10.0f * std::cbrt(static_cast<float>(count));
+
+		std::mt19937 randomEngine(42u);
+		std::vector<scene::BoundingBox> boundingBoxes = CreateRandomBoundingBoxes(count, worldExtent, randomEngine);
+
+		const auto MeasureMilliseconds = [](const auto& function)
+		{
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			function();
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		};
+
+		scene::BoundingVolumeHierarchy boundingVolumeHierarchy{};
+		const double serialBuildTime = MeasureMilliseconds([&]() { boundingVolumeHierarchy.Build(boundingBoxes, scene::BoundingVolumeHierarchyBuildDesc{ .parallelObjectCount = 0u }); });
+		const double parallelBuildTime = MeasureMilliseconds([&]() { boundingVolumeHierarchy.Build(boundingBoxes); });
+
+		std::printf("Bounding volume hierarchy : %7u objects | build serial %8.2f ms | parallel %7.2f ms | %u nodes | SAH cost %.1f\n", count, serialBuildTime,
+			parallelBuildTime, boundingVolumeHierarchy.GetNodeCount(), boundingVolumeHierarchy.GetSahCost());
+
+		// Moves every object (as when all meshes are animated) : refitting visits every node once, but does not touch the objects' order.
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			boundingBoxes[i].minimum[1] += 0.5f;
+			boundingBoxes[i].maximum[1] += 0.5f;
+		}
+
+		const double refitTime = MeasureMilliseconds([&]()
+		{
+			for (uint32_t i = 0u; i < count; ++i)
+			{
+				boundingVolumeHierarchy.UpdateObject(i, boundingBoxes[i]);
+			}
+
+			boundingVolumeHierarchy.Refit();
+		});
+
+		// Queries, against a linear scan over all objects (the SIMD frustum culling for the frustum).
+		const scene::Frustum frustum = scene::ExtractFrustum(scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, worldExtent));
+
+		scene::BoundingBoxSoA boundingBoxesSoA{};
+		boundingBoxesSoA.Resize(count);
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			boundingBoxesSoA.Set(i, boundingBoxes[i]);
+		}
+
+		std::vector<uint32_t> objectIndices{};
+		std::vector<uint8_t> visibility(count);
+		const double bvhFrustumTime = MeasureMilliseconds([&]() { boundingVolumeHierarchy.QueryFrustum(frustum, objectIndices); });
+		const double linearFrustumTime = MeasureMilliseconds([&]() { scene::CullBoundingBoxes(frustum, boundingBoxesSoA, visibility); });
+
+		std::vector<scene::BoundingSphere> boundingSpheres(QUERY_COUNT);
+		std::vector<scene::Ray> rays(QUERY_COUNT);
+		std::uniform_real_distribution<float> positionDistribution(-worldExtent, worldExtent);
+		for (uint32_t i = 0u; i < QUERY_COUNT; ++i)
+		{
+			boundingSpheres[i] = scene::BoundingSphere{ .center = { positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) }, .radius = 20.0f };
+			rays[i] = CreateRandomRay(worldExtent, randomEngine);
+		}
+
+		uint32_t sphereObjectCount{};
+		const double bvhSphereTime = MeasureMilliseconds([&]()
+		{
+			for (const scene::BoundingSphere& boundingSphere : boundingSpheres)
+			{
+				objectIndices.clear();
+				boundingVolumeHierarchy.QuerySphere(boundingSphere, objectIndices);
+				sphereObjectCount += static_cast<uint32_t>(objectIndices.size());
+			}
+		});
+
+		const double linearSphereTime = MeasureMilliseconds([&]()
+		{
+			for (const scene::BoundingSphere& boundingSphere : boundingSpheres)
+			{
+				objectIndices.clear();
+				for (uint32_t i = 0u; i < count; ++i)
+				{
+					if (scene::IntersectSphereBoundingBox(boundingSphere, boundingBoxes[i]))
+					{
+						objectIndices.push_back(i);
+					}
+				}
+			}
+		});
+
+		uint32_t rayHitCount{};
+		const double bvhRayTime = MeasureMilliseconds([&]()
+		{
+			for (const scene::Ray& ray : rays)
+			{
+				rayHitCount += boundingVolumeHierarchy.QueryClosestRayHit(ray).has_value() ? 1u : 0u;
+			}
+		});
+
+		const double linearRayTime = MeasureMilliseconds([&]()
+		{
+			for (const scene::Ray& ray : rays)
+			{
+				float closestDistance = std::numeric_limits<float>::infinity();
+				for (uint32_t i = 0u; i < count; ++i)
+				{
+					if (const std::optional<float> distance = scene::IntersectRayBoundingBox(ray, boundingBoxes[i]); distance.has_value())
+					{
+						closestDistance = std::min(closestDistance, *distance);
+					}
+				}
+			}
+		});
+
+		std::printf("Bounding volume hierarchy : %7u objects | refit all %6.2f ms | frustum %6.2f ms (linear SIMD %6.2f ms) | %u spheres %7.2f ms (linear %8.2f ms) | "
+			"%u closest rays %7.2f ms (linear %8.2f ms) | %u rays hit\n", count, refitTime, bvhFrustumTime, linearFrustumTime, QUERY_COUNT, bvhSphereTime, linearSphereTime,
+			QUERY_COUNT, bvhRayTime, linearRayTime, rayHitCount);
+	}
+}
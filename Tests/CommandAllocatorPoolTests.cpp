@@ -0,0 +1,268 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Graphics/API/CommandAllocatorPool.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Command allocator pool";
+
+	// Stands in for a ID3D12CommandAllocator : remembers the fence value of the last submission of its command list, so a reset while in flight is detected.
+	struct FakeCommandAllocator
+	{
+		uint32_t index{};
+		uint64_t submittedFenceValue{};
+		bool isRecording{};
+	};
+
+	using FakeCommandAllocatorHandle = std::shared_ptr<FakeCommandAllocator>;
+	using FakeCommandAllocatorPool = gfx::CommandAllocatorPool<FakeCommandAllocatorHandle>;
+
+	struct FakeCommandList
+	{
+		FakeCommandAllocatorHandle allocator{};
+	};
+
+	struct FakeCommandQueue
+	{
+		std::atomic<uint64_t> completedFenceValue{};
+		std::atomic<uint64_t> lastSignaledFenceValue{};
+		std::atomic<uint32_t> createdAllocatorCount{};
+		std::atomic<bool> isResetInFlight{};
+		std::atomic<bool> isAcquiredWhileRecording{};
+
+		FakeCommandAllocatorPool CreatePool()
+		{
+			return FakeCommandAllocatorPool([this]()
+			{
+				return std::make_shared<FakeCommandAllocator>(FakeCommandAllocator{ .index = createdAllocatorCount.fetch_add(1u) });
+			},
+			[this](FakeCommandAllocatorHandle& allocator)
+			{
+				isResetInFlight.store(isResetInFlight.load() || allocator->submittedFenceValue > completedFenceValue.load());
+			});
+		}
+
+		void Acquire(FakeCommandAllocatorPool& pool, FakeCommandList& commandList)
+		{
+			commandList.allocator = pool.Acquire(completedFenceValue.load());
+
+			isAcquiredWhileRecording.store(isAcquiredWhileRecording.load() || commandList.allocator->isRecording);
+			commandList.allocator->isRecording = true;
+		}
+
+		uint64_t Submit(FakeCommandAllocatorPool& pool, std::span<FakeCommandList* const> commandLists)
+		{
+			const uint64_t fenceValue = lastSignaledFenceValue.fetch_add(1u) + 1u;
+
+			for (FakeCommandList* commandList : commandLists)
+			{
+				commandList->allocator->submittedFenceValue = fenceValue;
+				commandList->allocator->isRecording = false;
+				commandList->allocator.reset();
+			}
+
+			pool.Submit(static_cast<uint32_t>(commandLists.size()), fenceValue);
+
+			return fenceValue;
+		}
+	};
+}
+
+bool VerifyCommandAllocatorPool()
+{
+	// The allocators used by a thread in a frame form a batch, reused (and reset at once) when the fence value of the frame completes.
+	{
+		static constexpr uint32_t COMMAND_LIST_COUNT = 3u;
+
+		FakeCommandQueue commandQueue{};
+		FakeCommandAllocatorPool pool = commandQueue.CreatePool();
+
+		std::array<FakeCommandList, COMMAND_LIST_COUNT> commandLists{};
+		std::array<FakeCommandList*, COMMAND_LIST_COUNT> submittedCommandLists{};
+		for (uint32_t commandListIndex = 0u; commandListIndex < COMMAND_LIST_COUNT; ++commandListIndex)
+		{
+			submittedCommandLists[commandListIndex] = &commandLists[commandListIndex];
+		}
+
+		const auto recordFrame = [&]()
+		{
+			std::array<uint32_t, COMMAND_LIST_COUNT> allocatorIndices{};
+			for (uint32_t commandListIndex = 0u; commandListIndex < COMMAND_LIST_COUNT; ++commandListIndex)
+			{
+				commandQueue.Acquire(pool, commandLists[commandListIndex]);
+				allocatorIndices[commandListIndex] = commandLists[commandListIndex].allocator->index;
+			}
+
+			const uint64_t fenceValue = commandQueue.Submit(pool, submittedCommandLists);
+			pool.RetireBatches();
+
+			return std::pair{ allocatorIndices, fenceValue };
+		};
+
+		const auto [firstAllocatorIndices, firstFenceValue] = recordFrame();
+		const auto [secondAllocatorIndices, secondFenceValue] = recordFrame();
+
+		commandQueue.completedFenceValue = firstFenceValue;
+		const auto [thirdAllocatorIndices, thirdFenceValue] = recordFrame();
+
+		const gfx::CommandAllocatorPoolStatistics statistics = pool.GetStatistics();
+		if (!Expect(SUITE_NAME, std::ranges::none_of(secondAllocatorIndices, [&](uint32_t index) { return std::ranges::find(firstAllocatorIndices, index) != firstAllocatorIndices.end(); }),
+				"Batch reset", "new allocators while the first frame is in flight") ||
+			!Expect(SUITE_NAME, thirdAllocatorIndices == firstAllocatorIndices && statistics.batchResetCount == 1u && !commandQueue.isResetInFlight.load(), "Batch reset",
+				"the allocators of the first frame reused (and reset in one go) once its fence value completed") ||
+			!Expect(SUITE_NAME, statistics.allocatorCount == 2u * COMMAND_LIST_COUNT && statistics.batchCount == 2u && statistics.maxAllocatorsPerBatch == COMMAND_LIST_COUNT &&
+				statistics.retiredBatchCount == 2u, "Batch reset", "2 batches of 3 allocators, both retired"))
+		{
+			return false;
+		}
+	}
+
+	// A command list acquired on another thread and not submitted yet keeps every batch open (as the fence value to retire them with is not known yet).
+	// Command lists are submitted by other threads than the ones that acquired them.
+	{
+		FakeCommandQueue commandQueue{};
+		FakeCommandAllocatorPool pool = commandQueue.CreatePool();
+
+		FakeCommandList mainThreadCommandList{};
+		FakeCommandList workerThreadCommandList{};
+
+		commandQueue.Acquire(pool, mainThreadCommandList);
+		const uint32_t mainThreadAllocatorIndex = mainThreadCommandList.allocator->index;
+
+		std::thread workerThread([&]() { commandQueue.Acquire(pool, workerThreadCommandList); });
+		workerThread.join();
+
+		const std::array<FakeCommandList*, 1u> mainThreadCommandLists{ &mainThreadCommandList };
+		const uint64_t mainThreadFenceValue = commandQueue.Submit(pool, mainThreadCommandLists);
+
+		pool.RetireBatches();
+		const uint64_t retiredBatchCountWhileUnsubmitted = pool.GetStatistics().retiredBatchCount;
+
+		// The worker's command list is submitted by the main thread.
+		const std::array<FakeCommandList*, 1u> workerThreadCommandLists{ &workerThreadCommandList };
+		const uint64_t workerThreadFenceValue = commandQueue.Submit(pool, workerThreadCommandLists);
+
+		pool.RetireBatches();
+		const uint64_t retiredBatchCount = pool.GetStatistics().retiredBatchCount;
+
+		// Both batches are retired with the fence value of the last submission.
+		commandQueue.completedFenceValue = mainThreadFenceValue;
+		commandQueue.Acquire(pool, mainThreadCommandList);
+		const bool isReusedBeforeLastSubmission = mainThreadCommandList.allocator->index == mainThreadAllocatorIndex;
+		commandQueue.Submit(pool, mainThreadCommandLists);
+		pool.RetireBatches();
+
+		commandQueue.completedFenceValue = workerThreadFenceValue;
+		commandQueue.Acquire(pool, mainThreadCommandList);
+
+		if (!Expect(SUITE_NAME, retiredBatchCountWhileUnsubmitted == 0u, "Unsubmitted command lists", "no batch retired while a command list is not submitted") ||
+			!Expect(SUITE_NAME, retiredBatchCount == 2u, "Unsubmitted command lists", "the batches of both threads retired once every command list is submitted") ||
+			!Expect(SUITE_NAME, !isReusedBeforeLastSubmission && mainThreadCommandList.allocator->index == mainThreadAllocatorIndex && !commandQueue.isResetInFlight.load(),
+				"Unsubmitted command lists", "the batches reused once the fence value of the last submission completed"))
+		{
+			return false;
+		}
+	}
+
+	// Frames recorded by persistent threads (as the job system's), each submitting the command lists acquired by another thread, and the batches retired
+	// at the end of every frame. No allocator is reset while in flight or handed out to two command lists, and the number of allocators is bounded by the
+	// command lists in flight.
+	{
+		static constexpr uint32_t THREAD_COUNT = 4u;
+		static constexpr uint32_t COMMAND_LISTS_PER_THREAD = 4u;
+		static constexpr uint32_t FRAME_COUNT = 300u;
+		static constexpr uint64_t FRAMES_IN_FLIGHT = 2u;
+
+		FakeCommandQueue commandQueue{};
+		FakeCommandAllocatorPool pool = commandQueue.CreatePool();
+
+		std::array<std::array<FakeCommandList, COMMAND_LISTS_PER_THREAD>, THREAD_COUNT> commandLists{};
+
+		std::vector<uint64_t> frameFenceValues{};
+		std::atomic<uint64_t> frameFenceValue{};
+
+		// Run by one of the threads once all of them submitted their command lists.
+		const auto endFrame = [&]() noexcept
+		{
+			frameFenceValues.push_back(frameFenceValue.load());
+			pool.RetireBatches();
+
+			// The GPU completes the frames older than the frames in flight.
+			if (frameFenceValues.size() > FRAMES_IN_FLIGHT)
+			{
+				commandQueue.completedFenceValue = std::max(commandQueue.completedFenceValue.load(), frameFenceValues[frameFenceValues.size() - FRAMES_IN_FLIGHT - 1u]);
+			}
+		};
+
+		std::barrier acquiredBarrier(THREAD_COUNT);
+		std::barrier frameBarrier(THREAD_COUNT, endFrame);
+
+		std::vector<std::thread> threads{};
+		for (uint32_t threadIndex = 0u; threadIndex < THREAD_COUNT; ++threadIndex)
+		{
+			threads.emplace_back([&, threadIndex]()
+			{
+				for (uint32_t frameIndex = 0u; frameIndex < FRAME_COUNT; ++frameIndex)
+				{
+					for (FakeCommandList& commandList : commandLists[threadIndex])
+					{
+						commandQueue.Acquire(pool, commandList);
+					}
+
+					acquiredBarrier.arrive_and_wait();
+
+					// Each thread submits the command lists recorded by the next one.
+					std::vector<FakeCommandList*> submittedCommandLists{};
+					for (FakeCommandList& commandList : commandLists[(threadIndex + 1u) % THREAD_COUNT])
+					{
+						submittedCommandLists.push_back(&commandList);
+					}
+
+					const uint64_t fenceValue = commandQueue.Submit(pool, submittedCommandLists);
+
+					uint64_t expectedFenceValue = frameFenceValue.load();
+					while (expectedFenceValue < fenceValue && !frameFenceValue.compare_exchange_weak(expectedFenceValue, fenceValue))
+					{
+					}
+
+					frameBarrier.arrive_and_wait();
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		const gfx::CommandAllocatorPoolStatistics statistics = pool.GetStatistics();
+		if (!Expect(SUITE_NAME, !commandQueue.isResetInFlight.load(), "Threaded frames", "no allocator reset while in flight") ||
+			!Expect(SUITE_NAME, !commandQueue.isAcquiredWhileRecording.load(), "Threaded frames", "no allocator handed out to two command lists") ||
+			!Expect(SUITE_NAME, statistics.allocatorCount <= (FRAMES_IN_FLIGHT + 2u) * THREAD_COUNT * COMMAND_LISTS_PER_THREAD, "Threaded frames",
+				"no more allocators than the command lists of the frames in flight") ||
+			!Expect(SUITE_NAME, statistics.batchResetCount > 0u && statistics.maxAllocatorsPerBatch == COMMAND_LISTS_PER_THREAD && statistics.unsubmittedAllocatorCount == 0u,
+				"Threaded frames", "batches of the command lists of a thread in a frame, reused once their frame completed"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Command allocator pool : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,288 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Graphics/API/CommandStream.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Command stream";
+
+	// D3D12_RESOURCE_STATES values.
+	enum TrackedState : uint32_t
+	{
+		RenderTarget = 0x4u,
+		UnorderedAccess = 0x8u,
+		PixelShaderResource = 0x80u,
+		CopySource = 0x800u,
+	};
+
+	std::vector<gfx::CommandType> GetRecordedCommandTypes(const gfx::CommandStream& commandStream)
+	{
+		std::vector<gfx::CommandType> commandTypes{};
+		commandStream.ForEachCommand([&](const gfx::CommandHeader& header)
+		{
+			commandTypes.push_back(header.type);
+		});
+
+		return commandTypes;
+	}
+
+	// Records drawCount draws, each with root constants of a size and value depending on its index (so none is redundant, and the commands have various
+	// sizes), starting from firstDrawIndex.
+	void RecordNumberedDraws(gfx::CommandStream& commandStream, uint32_t firstDrawIndex, uint32_t drawCount)
+	{
+		for (uint32_t drawIndex = firstDrawIndex; drawIndex < firstDrawIndex + drawCount; ++drawIndex)
+		{
+			std::array<uint32_t, gfx::MAX_ROOT_CONSTANTS> rootConstants{};
+			rootConstants.fill(drawIndex);
+
+			commandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, std::span(rootConstants).first(1u + drawIndex % gfx::MAX_ROOT_CONSTANTS));
+			commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u, .startVertexLocation = drawIndex });
+		}
+	}
+
+	// Returns true if the stream holds exactly the commands of RecordNumberedDraws(commandStream, firstDrawIndex, drawCount), in order.
+	bool AreNumberedDrawsRecorded(const gfx::CommandStream& commandStream, uint32_t firstDrawIndex, uint32_t drawCount)
+	{
+		bool areDrawsRecorded = commandStream.GetCommandCount() == 2u * drawCount;
+
+		uint32_t commandIndex{};
+		commandStream.ForEachCommand([&](const gfx::CommandHeader& header)
+		{
+			const uint32_t drawIndex = firstDrawIndex + commandIndex / 2u;
+			if (commandIndex % 2u == 0u)
+			{
+				const std::span<const uint32_t> rootConstants = gfx::CommandStream::GetRootConstants(header);
+				areDrawsRecorded = areDrawsRecorded && header.type == gfx::CommandType::SetRootConstants && rootConstants.size() == 1u + drawIndex % gfx::MAX_ROOT_CONSTANTS &&
+					std::all_of(rootConstants.begin(), rootConstants.end(), [&](uint32_t value) { return value == drawIndex; });
+			}
+			else
+			{
+				areDrawsRecorded = areDrawsRecorded && header.type == gfx::CommandType::Draw &&
+					gfx::CommandStream::GetCommand<gfx::DrawCommand>(header).startVertexLocation == drawIndex;
+			}
+
+			++commandIndex;
+		});
+
+		return areDrawsRecorded && commandIndex == 2u * drawCount;
+	}
+}
+
+bool VerifyCommandStream()
+{
+	// State filtering : a state command setting the state that is already set is not recorded, while setting another value is. Changing the root signature
+	// invalidates the root constants, and InvalidateState makes the next state commands be recorded again.
+	{
+		const gfx::SetPipelineStateCommand setPipelineStateCommand{ .pipelineState = 0x100u };
+		const gfx::SetRootSignatureCommand setRootSignatureCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics, .rootSignature = 0x200u };
+		const gfx::SetViewportCommand setViewportCommand{ .width = 1920.0f, .height = 1080.0f, .maxDepth = 1.0f };
+		const gfx::SetRootConstantsCommand setRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics };
+		const std::array<uint32_t, 2u> rootConstants{ 1u, 2u };
+
+		gfx::CommandStream commandStream{};
+		for (uint32_t i = 0u; i < 2u; ++i)
+		{
+			commandStream.Record(setPipelineStateCommand);
+			commandStream.Record(setRootSignatureCommand);
+			commandStream.Record(setViewportCommand);
+			commandStream.Record(gfx::SetPrimitiveTopologyCommand{ .primitiveTopology = 4u });
+			commandStream.Record(setRootConstantsCommand, rootConstants);
+		}
+
+		const bool areRepeatedCommandsFiltered = commandStream.GetCommandCount() == 5u && commandStream.GetStatistics().filteredCommandCount == 5u;
+
+		commandStream.Clear();
+		commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = 0x101u });
+		commandStream.Record(gfx::SetViewportCommand{ .width = 960.0f, .height = 540.0f, .maxDepth = 1.0f });
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+
+		const bool areOtherValuesRecorded = GetRecordedCommandTypes(commandStream) == std::vector<gfx::CommandType>{ gfx::CommandType::SetPipelineState, gfx::CommandType::SetViewport };
+
+		commandStream.Clear();
+		commandStream.Record(gfx::SetRootSignatureCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics, .rootSignature = 0x201u });
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+		commandStream.Record(gfx::SetRootSignatureCommand{ .bindPoint = gfx::PipelineBindPoint::Compute, .rootSignature = 0x201u });
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+
+		const bool areRootConstantsInvalidated = GetRecordedCommandTypes(commandStream) == std::vector<gfx::CommandType>{ gfx::CommandType::SetRootSignature,
+			gfx::CommandType::SetRootConstants, gfx::CommandType::SetRootSignature };
+
+		commandStream.Clear();
+		commandStream.InvalidateState();
+		commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = 0x101u });
+
+		if (!Expect(SUITE_NAME, areRepeatedCommandsFiltered, "State filtering", "the repeated state commands to be filtered") ||
+			!Expect(SUITE_NAME, areOtherValuesRecorded, "State filtering", "the state commands setting other values to be recorded") ||
+			!Expect(SUITE_NAME, areRootConstantsInvalidated, "State filtering", "the root constants to be recorded again after their bind point's root signature changed") ||
+			!Expect(SUITE_NAME, commandStream.GetCommandCount() == 1u, "State filtering", "the state commands to be recorded again after InvalidateState"))
+		{
+			return false;
+		}
+	}
+
+	// Root constants : only the given values are stored in the stream (after the command), and setting the same values again is redundant while other values are not.
+	{
+		const gfx::SetRootConstantsCommand setRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics, .rootParameterIndex = 0u };
+		const std::array<uint32_t, 3u> rootConstants{ 7u, 8u, 9u };
+		const std::array<uint32_t, 3u> otherRootConstants{ 7u, 8u, 10u };
+
+		gfx::CommandStream commandStream{};
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+		commandStream.Record(setRootConstantsCommand, std::span(rootConstants).first(2u));
+		commandStream.Record(setRootConstantsCommand, otherRootConstants);
+
+		std::vector<std::vector<uint32_t>> recordedRootConstants{};
+		commandStream.ForEachCommand([&](const gfx::CommandHeader& header)
+		{
+			const std::span<const uint32_t> values = gfx::CommandStream::GetRootConstants(header);
+			recordedRootConstants.emplace_back(values.begin(), values.end());
+		});
+
+		const auto GetCommandSize = [](size_t valueCount)
+		{
+			const size_t commandSize = sizeof(gfx::CommandHeader) + sizeof(gfx::SetRootConstantsCommand) + valueCount * sizeof(uint32_t);
+			return (commandSize + gfx::CommandStream::COMMAND_ALIGNMENT - 1u) & ~(gfx::CommandStream::COMMAND_ALIGNMENT - 1u);
+		};
+
+		const size_t expectedByteSize = 2u * GetCommandSize(3u) + GetCommandSize(2u);
+
+		if (!Expect(SUITE_NAME, recordedRootConstants == std::vector<std::vector<uint32_t>>{ { 7u, 8u, 9u }, { 7u, 8u }, { 7u, 8u, 10u } }, "Root constants",
+			"the values of the 3 commands that are not redundant") ||
+			!Expect(SUITE_NAME, commandStream.GetStatistics().recordedByteSize == expectedByteSize, "Root constants", "only the given values stored in the stream"))
+		{
+			return false;
+		}
+	}
+
+	// Empty work : draws / dispatches without vertices, instances or thread groups have no effect, so they are not recorded (and do not flush the pending barriers).
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.Record(gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::Transition, .stateBefore = RenderTarget, .stateAfter = PixelShaderResource, .resource = 0x300u });
+
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 0u, .instanceCount = 1u });
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 0u });
+		commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = 0u, .instanceCount = 1u });
+		commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = 3u, .instanceCount = 0u });
+		commandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 0u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+		commandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 0u, .threadGroupCountZ = 1u });
+		commandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 0u });
+
+		const bool isEmptyWorkFiltered = commandStream.IsEmpty() && commandStream.GetStatistics().filteredCommandCount == 7u;
+
+		commandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+
+		if (!Expect(SUITE_NAME, isEmptyWorkFiltered, "Empty work", "the 7 empty draws / dispatches to be filtered, leaving the barrier pending") ||
+			!Expect(SUITE_NAME, GetRecordedCommandTypes(commandStream) == std::vector<gfx::CommandType>{ gfx::CommandType::ResourceBarrier, gfx::CommandType::Dispatch },
+				"Empty work", "the barrier to be flushed by the first dispatch with thread groups"))
+		{
+			return false;
+		}
+	}
+
+	// Chunks : a stream growing past CHUNK_SIZE continues into new chunks, and its commands (of various sizes) are read back in order. Clear keeps the chunks,
+	// so the stream is recorded again into the same memory.
+	{
+		static constexpr uint32_t DRAW_COUNT = 2'000u;
+
+		gfx::CommandStream commandStream{};
+		RecordNumberedDraws(commandStream, 0u, DRAW_COUNT);
+
+		const uint64_t recordedByteSize = commandStream.GetStatistics().recordedByteSize;
+		const bool areDrawsRecorded = AreNumberedDrawsRecorded(commandStream, 0u, DRAW_COUNT);
+
+		commandStream.Clear();
+		RecordNumberedDraws(commandStream, DRAW_COUNT, DRAW_COUNT);
+
+		if (!Expect(SUITE_NAME, recordedByteSize > 8u * gfx::CommandStream::CHUNK_SIZE, "Chunks", "the draws to span more than 8 chunks") ||
+			!Expect(SUITE_NAME, areDrawsRecorded, "Chunks", "the commands of all chunks to be read back in recording order") ||
+			!Expect(SUITE_NAME, AreNumberedDrawsRecorded(commandStream, DRAW_COUNT, DRAW_COUNT), "Chunks", "the commands recorded after Clear to replace the previous ones"))
+		{
+			return false;
+		}
+	}
+
+	// Threads : streams are recorded by several threads at once, each into its own streams, whose chunks come from (and are returned to) the pool shared by all streams.
+	{
+		static constexpr uint32_t THREAD_COUNT = 8u;
+		static constexpr uint32_t STREAMS_PER_THREAD = 16u;
+		static constexpr uint32_t DRAWS_PER_STREAM = 500u;
+
+		std::array<bool, THREAD_COUNT> areStreamsValid{};
+
+		std::vector<std::thread> threads{};
+		for (uint32_t threadIndex = 0u; threadIndex < THREAD_COUNT; ++threadIndex)
+		{
+			threads.emplace_back([&, threadIndex]()
+			{
+				bool areThreadStreamsValid{ true };
+				for (uint32_t streamIndex = 0u; streamIndex < STREAMS_PER_THREAD; ++streamIndex)
+				{
+					const uint32_t firstDrawIndex = (threadIndex * STREAMS_PER_THREAD + streamIndex) * DRAWS_PER_STREAM;
+
+					// Destroying the stream returns its chunks to the pool, so the chunks go back and forth between the threads.
+					gfx::CommandStream commandStream{};
+					RecordNumberedDraws(commandStream, firstDrawIndex, DRAWS_PER_STREAM);
+					areThreadStreamsValid = areThreadStreamsValid && AreNumberedDrawsRecorded(commandStream, firstDrawIndex, DRAWS_PER_STREAM);
+				}
+
+				areStreamsValid[threadIndex] = areThreadStreamsValid;
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		if (!Expect(SUITE_NAME, std::all_of(areStreamsValid.begin(), areStreamsValid.end(), [](bool isValid) { return isValid; }), "Threads",
+			"the commands of every stream to be the ones recorded into it, in order"))
+		{
+			return false;
+		}
+	}
+
+	// Barrier batching : the barriers requested between two work commands are recorded together (as one batch, translated into a single call) right before
+	// the next work command, and none is recorded without work after them until they are flushed.
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.Record(gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::Transition, .stateBefore = RenderTarget, .stateAfter = PixelShaderResource, .resource = 0x300u });
+		commandStream.Record(gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::Transition, .stateBefore = CopySource, .stateAfter = UnorderedAccess, .resource = 0x301u });
+		commandStream.Record(gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::UnorderedAccess, .resource = 0x302u });
+
+		const bool areBarriersPending = commandStream.IsEmpty();
+
+		commandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+		commandStream.TransitionResource(0x301u, CopySource);
+		commandStream.Record(gfx::CopyResourceCommand{ .destination = 0x303u, .source = 0x301u });
+		commandStream.TransitionResource(0x300u, RenderTarget);
+		commandStream.FlushResourceBarriers();
+
+		const gfx::ResourceBarrierStatistics statistics = commandStream.GetStatistics().resourceBarrierStatistics;
+
+		if (!Expect(SUITE_NAME, areBarriersPending, "Barrier batching", "no barrier recorded before the next work command") ||
+			!Expect(SUITE_NAME, GetRecordedCommandTypes(commandStream) == std::vector<gfx::CommandType>{ gfx::CommandType::ResourceBarrier, gfx::CommandType::ResourceBarrier,
+				gfx::CommandType::ResourceBarrier, gfx::CommandType::Dispatch, gfx::CommandType::ResourceBarrier, gfx::CommandType::CopyResource, gfx::CommandType::ResourceBarrier },
+				"Barrier batching", "the barriers recorded together before the work following them") ||
+			!Expect(SUITE_NAME, statistics.barrierBatchCount == 3u && statistics.transitionCount == 4u && statistics.uavBarrierCount == 1u, "Barrier batching",
+				"4 transitions and 1 UAV barrier in 3 batches"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Command stream : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,144 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Utility/ConcurrentFreeList.hpp"
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Concurrent free list";
+}
+
+bool VerifyConcurrentFreeList()
+{
+	// Values pushed from a single thread are all popped back (in any order), then the list is empty.
+	{
+		static constexpr uint32_t VALUE_COUNT = 200u;
+
+		ConcurrentFreeList<uint32_t> freeList{};
+		const bool isEmptyPopEmpty = !freeList.Pop().has_value();
+
+		for (uint32_t value = 0u; value < VALUE_COUNT; ++value)
+		{
+			freeList.Push(value);
+		}
+
+		std::vector<uint32_t> poppedValues{};
+		while (std::optional<uint32_t> value = freeList.Pop())
+		{
+			poppedValues.push_back(*value);
+		}
+
+		std::ranges::sort(poppedValues);
+
+		bool isEveryValuePopped = poppedValues.size() == VALUE_COUNT;
+		for (uint32_t value = 0u; isEveryValuePopped && value < VALUE_COUNT; ++value)
+		{
+			isEveryValuePopped = poppedValues[value] == value;
+		}
+
+		if (!Expect(SUITE_NAME, isEmptyPopEmpty, "Single thread", "nothing popped from an empty list") ||
+			!Expect(SUITE_NAME, isEveryValuePopped, "Single thread", "every pushed value popped exactly once"))
+		{
+			return false;
+		}
+	}
+
+	// Push fails once every node holds a value, and succeeds again once a value is popped (its node being reused rather than a new one allocated).
+	{
+		using FreeList = ConcurrentFreeList<uint32_t>;
+		static constexpr uint32_t MAX_NODE_COUNT = FreeList::NODES_PER_CHUNK * FreeList::MAX_CHUNKS;
+
+		FreeList freeList{};
+
+		bool isEveryPushAccepted = true;
+		for (uint32_t value = 0u; value < MAX_NODE_COUNT; ++value)
+		{
+			isEveryPushAccepted = freeList.Push(value) && isEveryPushAccepted;
+		}
+
+		const bool isPushOverCapacityRejected = !freeList.Push(MAX_NODE_COUNT);
+
+		const std::optional<uint32_t> poppedValue = freeList.Pop();
+		const bool isPushAfterPopAccepted = freeList.Push(MAX_NODE_COUNT);
+
+		if (!Expect(SUITE_NAME, isEveryPushAccepted && isPushOverCapacityRejected, "Capacity", "every push accepted up to the maximum number of nodes, then rejected") ||
+			!Expect(SUITE_NAME, poppedValue.has_value() && isPushAfterPopAccepted, "Capacity", "the node of a popped value reused by the next push"))
+		{
+			return false;
+		}
+	}
+
+	// Threads pushing unique values and popping values pushed by any thread : no value is lost or popped twice, and the values left are popped afterwards.
+	{
+		static constexpr uint32_t THREAD_COUNT = 8u;
+		static constexpr uint32_t VALUES_PER_THREAD = 20000u;
+
+		ConcurrentFreeList<uint32_t> freeList{};
+
+		std::vector<std::vector<uint32_t>> poppedValues(THREAD_COUNT + 1u);
+
+		std::vector<std::thread> threads{};
+		for (uint32_t threadIndex = 0u; threadIndex < THREAD_COUNT; ++threadIndex)
+		{
+			threads.emplace_back([&, threadIndex]()
+			{
+				for (uint32_t valueIndex = 0u; valueIndex < VALUES_PER_THREAD; ++valueIndex)
+				{
+					freeList.Push(threadIndex * VALUES_PER_THREAD + valueIndex);
+
+					// Pops less than it pushes, so the list grows (new nodes being allocated while other threads pop).
+					if (valueIndex % 4u != 0u)
+					{
+						if (std::optional<uint32_t> value = freeList.Pop())
+						{
+							poppedValues[threadIndex].push_back(*value);
+						}
+					}
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		while (std::optional<uint32_t> value = freeList.Pop())
+		{
+			poppedValues[THREAD_COUNT].push_back(*value);
+		}
+
+		std::vector<uint32_t> popCounts(THREAD_COUNT * VALUES_PER_THREAD);
+		bool isValueInRange = true;
+		for (const std::vector<uint32_t>& threadPoppedValues : poppedValues)
+		{
+			for (uint32_t value : threadPoppedValues)
+			{
+				if (value >= popCounts.size())
+				{
+					isValueInRange = false;
+					continue;
+				}
+
+				popCounts[value]++;
+			}
+		}
+
+		if (!Expect(SUITE_NAME, isValueInRange && std::ranges::all_of(popCounts, [](uint32_t popCount) { return popCount == 1u; }), "Threaded push / pop",
+			"every pushed value popped exactly once"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Concurrent free list : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,180 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Utility/DeferredExecutionQueue.hpp"
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Deferred execution queue";
+
+	// Simulates the fences of the graphics, compute and copy queues : values are signaled on submission, and completed later (in order) by the 'GPU'.
+	struct SimulatedFences
+	{
+		DeferredExecutionQueue::FenceValues lastSignaledValues{};
+		DeferredExecutionQueue::FenceValues completedValues{};
+
+		DeferredExecutionQueue::FenceValues Signal(bool signalCompute, bool signalCopy)
+		{
+			lastSignaledValues[0]++;
+			lastSignaledValues[1] += signalCompute ? 1u : 0u;
+			lastSignaledValues[2] += signalCopy ? 1u : 0u;
+
+			return lastSignaledValues;
+		}
+
+		// Completes up to the given number of values on each queue.
+		void Complete(uint64_t graphicsValueCount, uint64_t computeValueCount, uint64_t copyValueCount)
+		{
+			completedValues[0] = std::min(completedValues[0] + graphicsValueCount, lastSignaledValues[0]);
+			completedValues[1] = std::min(completedValues[1] + computeValueCount, lastSignaledValues[1]);
+			completedValues[2] = std::min(completedValues[2] + copyValueCount, lastSignaledValues[2]);
+		}
+
+		void CompleteAll()
+		{
+			completedValues = lastSignaledValues;
+		}
+	};
+}
+
+bool VerifyDeferredExecutionQueue()
+{
+	// Functions are held until the fence values they are tagged with complete on every queue.
+	{
+		DeferredExecutionQueue deferredExecutionQueue{};
+		SimulatedFences simulatedFences{};
+
+		bool isReleased{ false };
+		deferredExecutionQueue.PushFunction([&]() { isReleased = true; });
+
+		// Pending functions are not executed until they are tagged.
+		simulatedFences.CompleteAll();
+		if (!Expect(SUITE_NAME, deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues) == 0u && !isReleased, "Hold", "untagged functions held"))
+		{
+			return false;
+		}
+
+		deferredExecutionQueue.TagPendingFunctions(simulatedFences.Signal(true, false));
+
+		simulatedFences.Complete(1u, 0u, 0u);
+		if (!Expect(SUITE_NAME, deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues) == 0u && !isReleased, "Hold",
+			"the function held until the compute fence completes"))
+		{
+			return false;
+		}
+
+		simulatedFences.Complete(0u, 1u, 0u);
+		if (!Expect(SUITE_NAME, deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues) == 1u && isReleased, "Hold",
+			"the function released once every fence completes") ||
+			!Expect(SUITE_NAME, deferredExecutionQueue.GetPendingFunctionCount() == 0u, "Hold", "no function left"))
+		{
+			return false;
+		}
+	}
+
+	// Frames with a few frames of latency : the functions are released in the order of their fences, and only once their fences complete.
+	{
+		DeferredExecutionQueue deferredExecutionQueue{};
+		SimulatedFences simulatedFences{};
+		std::mt19937 randomEngine(42u);
+
+		static constexpr uint32_t FRAME_COUNT = 500u;
+
+		std::vector<DeferredExecutionQueue::FenceValues> frameFenceValues{};
+		std::vector<uint32_t> releasedFrames{};
+		bool isReleasedBeforeCompletion{ false };
+
+		for (uint32_t frameIndex = 0u; frameIndex < FRAME_COUNT; ++frameIndex)
+		{
+			const uint32_t releaseCount = randomEngine() % 4u;
+			for (uint32_t i = 0u; i < releaseCount; ++i)
+			{
+				deferredExecutionQueue.PushFunction([&, frameIndex]()
+				{
+					isReleasedBeforeCompletion = isReleasedBeforeCompletion || !DeferredExecutionQueue::IsComplete(frameFenceValues[frameIndex], simulatedFences.completedValues);
+					releasedFrames.push_back(frameIndex);
+				});
+			}
+
+			// Present : the releases of the frame are tagged with the values signaled after its submissions.
+			frameFenceValues.push_back(simulatedFences.Signal(randomEngine() % 2u == 0u, randomEngine() % 4u == 0u));
+			deferredExecutionQueue.TagPendingFunctions(frameFenceValues.back());
+
+			// The GPU progresses at an irregular pace on each queue.
+			simulatedFences.Complete(randomEngine() % 3u, randomEngine() % 3u, randomEngine() % 3u);
+			deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues);
+		}
+
+		const size_t heldFunctionCount = deferredExecutionQueue.GetPendingFunctionCount();
+		const size_t releasedFunctionCount = releasedFrames.size();
+
+		simulatedFences.CompleteAll();
+		deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues);
+
+		if (!Expect(SUITE_NAME, !isReleasedBeforeCompletion, "Fence order", "no function released before its fences complete") ||
+			!Expect(SUITE_NAME, std::is_sorted(releasedFrames.begin(), releasedFrames.end()), "Fence order", "the functions released in the order of their fences") ||
+			!Expect(SUITE_NAME, heldFunctionCount > 0u && releasedFunctionCount > 0u, "Fence order", "some functions released, and some held by the GPU latency") ||
+			!Expect(SUITE_NAME, deferredExecutionQueue.GetPendingFunctionCount() == 0u && releasedFrames.size() == heldFunctionCount + releasedFunctionCount, "Fence order",
+				"every function released once all fences complete"))
+		{
+			return false;
+		}
+	}
+
+	// Functions may push releases to the queue while they are executed (i.e a resource owning descriptors).
+	{
+		DeferredExecutionQueue deferredExecutionQueue{};
+		SimulatedFences simulatedFences{};
+
+		bool isNestedReleased{ false };
+		deferredExecutionQueue.PushFunction([&]()
+		{
+			deferredExecutionQueue.PushFunction([&]() { isNestedReleased = true; });
+		});
+
+		deferredExecutionQueue.TagPendingFunctions(simulatedFences.Signal(false, false));
+		simulatedFences.CompleteAll();
+		deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues);
+
+		deferredExecutionQueue.TagPendingFunctions(simulatedFences.Signal(false, false));
+		simulatedFences.CompleteAll();
+		deferredExecutionQueue.ExecuteCompletedFunctions(simulatedFences.completedValues);
+
+		if (!Expect(SUITE_NAME, isNestedReleased && deferredExecutionQueue.GetPendingFunctionCount() == 0u, "Nested release", "the release pushed by a release executed"))
+		{
+			return false;
+		}
+	}
+
+	// Shutdown (the GPU is idle) : every function is executed regardless of the fences, the tagged ones in fence order, then the pending ones in reverse order.
+	{
+		DeferredExecutionQueue deferredExecutionQueue{};
+		SimulatedFences simulatedFences{};
+
+		std::vector<uint32_t> executionOrder{};
+
+		deferredExecutionQueue.PushFunction([&]() { executionOrder.push_back(0u); });
+		deferredExecutionQueue.TagPendingFunctions(simulatedFences.Signal(true, true));
+		deferredExecutionQueue.PushFunction([&]() { executionOrder.push_back(1u); }, simulatedFences.Signal(true, true));
+		deferredExecutionQueue.PushFunction([&]() { executionOrder.push_back(2u); });
+		deferredExecutionQueue.PushFunction([&]() { executionOrder.push_back(3u); });
+
+		deferredExecutionQueue.Execute();
+
+		if (!Expect(SUITE_NAME, executionOrder == std::vector<uint32_t>{ 0u, 1u, 3u, 2u }, "Shutdown", "the tagged functions in fence order, then the pending ones in reverse order") ||
+			!Expect(SUITE_NAME, deferredExecutionQueue.GetPendingFunctionCount() == 0u, "Shutdown", "the queue drained"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Deferred execution queue : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,38 @@
+#include "TestSuites.hpp"
+
+#include <cstdio>
+#include <utility>
+
+void PrintDepthBandwidthEstimate()
+{
+	// D32_FLOAT depth, and the G-Buffer of the deferred geometry pass (RGBA8 albedo, 3 x RGBA16F).
+	static constexpr double DEPTH_BYTES_PER_PIXEL = 4.0;
+	static constexpr double GBUFFER_BYTES_PER_PIXEL = 4.0 + 3.0 * 8.0;
+
+	// Note : The copy of the depth buffer read and wrote it once, and it was cleared three times per frame (by the lighting pass, and the forward depth by
+	// the post processing / final passes). Clears are counted as full writes (an upper bound, as fast clears only touch the compression metadata), and the
+	// decompression of the depth buffer required by the copy is not counted.
+	static constexpr double DEPTH_COPY_BYTES_PER_PIXEL = 2.0 * DEPTH_BYTES_PER_PIXEL;
+	static constexpr double DEPTH_CLEAR_BYTES_PER_PIXEL = 3.0 * DEPTH_BYTES_PER_PIXEL;
+
+	static constexpr double FRAMES_PER_SECOND = 60.0;
+	static constexpr double MEGABYTE = 1024.0 * 1024.0;
+
+	for (const auto& [width, height] : { std::pair{ 1920u, 1080u }, std::pair{ 2560u, 1440u }, std::pair{ 3840u, 2160u } })
+	{
+		const double pixelCount = static_cast<double>(width) * height;
+		const double savedBytes = pixelCount * (DEPTH_COPY_BYTES_PER_PIXEL + DEPTH_CLEAR_BYTES_PER_PIXEL);
+
+		std::printf("Read only depth (estimate) : %4ux%4u | %6.1f MB / frame saved (%5.2f GB/s at %.0f fps) | %5.1f MB of transient memory freed\n", width, height,
+			savedBytes / MEGABYTE, savedBytes * FRAMES_PER_SECOND / (MEGABYTE * 1024.0), FRAMES_PER_SECOND, pixelCount * DEPTH_BYTES_PER_PIXEL / MEGABYTE);
+	}
+
+	// The depth pre-pass writes the depth once more (and reads it for the depth test of the G-Buffer pass), but the G-Buffer is written once per pixel,
+	// instead of once per depth test passed.
+	for (const double overdraw : { 1.5, 2.0, 3.0 })
+	{
+		const double savedBytesPerPixel = (overdraw - 1.0) * GBUFFER_BYTES_PER_PIXEL - 2.0 * DEPTH_BYTES_PER_PIXEL;
+		std::printf("Depth pre-pass (estimate) : overdraw %.1f | %+5.1f bytes / pixel of render target traffic (%+6.1f MB / frame at 2560x1440)\n", overdraw,
+			-savedBytesPerPixel, -savedBytesPerPixel * 2560.0 * 1440.0 / MEGABYTE);
+	}
+}
@@ -0,0 +1,305 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Graphics/API/CommandStream.hpp"
+#include "Graphics/API/DrawSorting.hpp"
+#include "Scene/FrustumCulling.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Draw sorting";
+
+	constexpr std::array<gfx::DrawSortImplementation, 3u> DRAW_SORT_IMPLEMENTATIONS
+	{
+		gfx::DrawSortImplementation::StdSort, gfx::DrawSortImplementation::Radix, gfx::DrawSortImplementation::ParallelRadix,
+	};
+
+	// Packets drawn (in draw index order) from a random scene : the pipeline / material of a draw is the one of its mesh, as for instances of the same mesh.
+	struct DrawSortingScene
+	{
+		scene::BoundingBoxSoA boundingBoxes{};
+		std::vector<uint32_t> meshIndices{};
+		std::vector<uint32_t> meshPipelines{};
+		std::vector<uint32_t> meshMaterials{};
+	};
+
+	DrawSortingScene CreateDrawSortingScene(uint32_t drawCount, uint32_t meshCount, uint32_t pipelineCount, uint32_t materialCount, std::mt19937& randomEngine)
+	{
+		DrawSortingScene drawSortingScene{};
+
+		scene::BoundingSphereSoA boundingSpheres{};
+		CreateRandomBounds(drawCount, randomEngine, drawSortingScene.boundingBoxes, boundingSpheres);
+
+		std::uniform_int_distribution<uint32_t> meshDistribution(0u, meshCount - 1u);
+		std::uniform_int_distribution<uint32_t> pipelineDistribution(0u, pipelineCount - 1u);
+		std::uniform_int_distribution<uint32_t> materialDistribution(0u, materialCount - 1u);
+
+		for (uint32_t i = 0u; i < drawCount; ++i)
+		{
+			drawSortingScene.meshIndices.push_back(meshDistribution(randomEngine));
+		}
+
+		for (uint32_t i = 0u; i < meshCount; ++i)
+		{
+			drawSortingScene.meshPipelines.push_back(pipelineDistribution(randomEngine));
+			drawSortingScene.meshMaterials.push_back(materialDistribution(randomEngine));
+		}
+
+		return drawSortingScene;
+	}
+
+	void BuildDrawSortingPackets(const DrawSortingScene& drawSortingScene, const scene::Matrix4x4& viewProjectionMatrix, std::vector<gfx::DrawPacket>& drawPackets)
+	{
+		drawPackets.resize(drawSortingScene.meshIndices.size());
+
+		for (uint32_t i = 0u; i < static_cast<uint32_t>(drawPackets.size()); ++i)
+		{
+			const uint32_t meshIndex = drawSortingScene.meshIndices[i];
+			const float depth = scene::ComputeBoundingBoxDepth(drawSortingScene.boundingBoxes.Get(i), viewProjectionMatrix);
+
+			drawPackets[i] = gfx::DrawPacket
+			{
+				.sortKey = gfx::MakeDrawSortKey(0u, drawSortingScene.meshPipelines[meshIndex], drawSortingScene.meshMaterials[meshIndex], depth),
+				.drawIndex = i,
+			};
+		}
+	}
+
+	// Records the packets in order (as Scene::RenderModels) : the pipeline state of the draw, its mesh's index buffer, its root constants (draw index and material) and the draw.
+	gfx::CommandStreamStatistics RecordDrawPackets(const DrawSortingScene& drawSortingScene, std::span<const gfx::DrawPacket> drawPackets)
+	{
+		gfx::CommandStream commandStream{};
+		for (const gfx::DrawPacket& drawPacket : drawPackets)
+		{
+			const uint32_t meshIndex = drawSortingScene.meshIndices[drawPacket.drawIndex];
+
+			const std::array<uint32_t, 2u> rootConstants{ drawPacket.drawIndex, drawSortingScene.meshMaterials[meshIndex] };
+
+			commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = 0x100u + drawSortingScene.meshPipelines[meshIndex] });
+			commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = 0x10000u + meshIndex, .sizeInBytes = 4096u });
+			commandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, rootConstants);
+			commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = 1024u, .instanceCount = 1u });
+		}
+
+		return commandStream.GetStatistics();
+	}
+}
+
+bool VerifyDrawSorting()
+{
+	// Fields : each field is read back (including the largest value that fits in its bits), a value too large for its field is rejected, and the fields are
+	// ordered pass, pipeline, material, then depth.
+	{
+		const uint64_t sortKey = gfx::MakeDrawSortKey(5u, 200u, 0xABCDEu, 3.5f);
+		const uint64_t maximumSortKey = gfx::MakeDrawSortKey(0xFu, 0xFFu, 0xFFFFFu, 0.0f);
+		if (!Expect(SUITE_NAME, gfx::GetDrawSortKeyPass(sortKey) == 5u && gfx::GetDrawSortKeyPipeline(sortKey) == 200u && gfx::GetDrawSortKeyMaterial(sortKey) == 0xABCDEu &&
+			gfx::GetDrawSortKeyDepth(sortKey) == 3.5f, "Fields", "the fields of the key to be read back") ||
+			!Expect(SUITE_NAME, gfx::GetDrawSortKeyPass(maximumSortKey) == 0xFu && gfx::GetDrawSortKeyPipeline(maximumSortKey) == 0xFFu &&
+			gfx::GetDrawSortKeyMaterial(maximumSortKey) == 0xFFFFFu, "Fields", "the largest values of the fields to be read back, without overflowing into the next field"))
+		{
+			return false;
+		}
+
+		const auto IsRejected = [](uint32_t pass, uint32_t pipeline, uint32_t material)
+		{
+			try
+			{
+				gfx::MakeDrawSortKey(pass, pipeline, material, 0.0f);
+			}
+			catch (const std::runtime_error&)
+			{
+				return true;
+			}
+
+			return false;
+		};
+
+		if (!Expect(SUITE_NAME, IsRejected(0x10u, 0u, 0u) && IsRejected(0u, 0x100u, 0u) && IsRejected(0u, 0u, 0x100000u), "Fields",
+			"a pass, pipeline or material too large for its field to throw (rather than be truncated)"))
+		{
+			return false;
+		}
+
+		const float maximumDepth = std::numeric_limits<float>::max();
+		if (!Expect(SUITE_NAME, gfx::MakeDrawSortKey(0u, 0xFFu, 0xFFFFFu, maximumDepth) < gfx::MakeDrawSortKey(1u, 0u, 0u, 0.0f), "Order", "the pass to be sorted first") ||
+			!Expect(SUITE_NAME, gfx::MakeDrawSortKey(0u, 0u, 0xFFFFFu, maximumDepth) < gfx::MakeDrawSortKey(0u, 1u, 0u, 0.0f), "Order", "the pipeline to be sorted before the material") ||
+			!Expect(SUITE_NAME, gfx::MakeDrawSortKey(0u, 0u, 0u, maximumDepth) < gfx::MakeDrawSortKey(0u, 0u, 1u, 0.0f), "Order", "the material to be sorted before the depth"))
+		{
+			return false;
+		}
+	}
+
+	// Depth : non negative depths sort as floats (front to back), and negative depths, -0 and NaN as 0.
+	{
+		const std::array<float, 8u> depths{ 0.0f, std::numeric_limits<float>::denorm_min(), 1e-6f, 0.2f, 0.5f, 0.9999f, 1.0f, 4096.0f };
+		for (size_t i = 1u; i < depths.size(); ++i)
+		{
+			if (!Expect(SUITE_NAME, gfx::MakeDrawSortKey(0u, 0u, 0u, depths[i - 1u]) < gfx::MakeDrawSortKey(0u, 0u, 0u, depths[i]), "Depth", "closer draws to be sorted first"))
+			{
+				return false;
+			}
+		}
+
+		const uint64_t zeroDepthKey = gfx::MakeDrawSortKey(0u, 0u, 0u, 0.0f);
+		for (const float depth : { -1.0f, -0.0f, -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() })
+		{
+			if (!Expect(SUITE_NAME, gfx::MakeDrawSortKey(0u, 0u, 0u, depth) == zeroDepthKey, "Depth", "negative depths, -0 and NaN to be sorted as 0"))
+			{
+				return false;
+			}
+		}
+
+		// The depth of the bounds grows with the distance to the camera (looking down +Z), and is 0 for bounds centered behind it.
+		const scene::Matrix4x4 viewProjectionMatrix = scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, 1000.0f);
+		const auto getDepth = [&](float z) { return scene::ComputeBoundingBoxDepth(CreateCenteredBox({ 1.0f, -2.0f, z }, { 1.0f, 1.0f, 1.0f }), viewProjectionMatrix); };
+
+		if (!Expect(SUITE_NAME, getDepth(5.0f) > 0.0f && getDepth(5.0f) < getDepth(50.0f) && getDepth(50.0f) < getDepth(500.0f) && getDepth(500.0f) < 1.0f, "Bounds depth",
+			"the depth of bounds in front of the camera to grow with their distance, within [0, 1]") ||
+			!Expect(SUITE_NAME, getDepth(-5.0f) == 0.0f, "Bounds depth", "bounds behind the camera to have a depth of 0"))
+		{
+			return false;
+		}
+	}
+
+	// Sorting : the radix sorts match std::stable_sort exactly (including the order of the packets with the same key) for random keys, few distinct keys
+	// (with bytes that are the same in all keys, which are skipped), and keys as built for a scene.
+	std::mt19937 randomEngine(42u);
+
+	for (const uint32_t packetCount : { 0u, 1u, 2u, 100u, gfx::PARALLEL_RADIX_SORT_MIN_BLOCK_SIZE - 1u, gfx::PARALLEL_RADIX_SORT_MIN_BLOCK_SIZE * 3u + 5u, 100'000u, 250'000u })
+	{
+		for (uint32_t distribution = 0u; distribution < 3u; ++distribution)
+		{
+			std::vector<gfx::DrawPacket> drawPackets(packetCount);
+			std::uniform_int_distribution<uint64_t> keyDistribution{};
+			std::uniform_int_distribution<uint32_t> fieldDistribution(0u, 7u);
+			std::uniform_real_distribution<float> depthDistribution(0.0f, 1.0f);
+
+			for (uint32_t i = 0u; i < packetCount; ++i)
+			{
+				switch (distribution)
+				{
+				case 0u: { drawPackets[i].sortKey = keyDistribution(randomEngine); }break;
+				case 1u: { drawPackets[i].sortKey = gfx::MakeDrawSortKey(3u, 1u, fieldDistribution(randomEngine), static_cast<float>(fieldDistribution(randomEngine))); }break;
+				case 2u: { drawPackets[i].sortKey = gfx::MakeDrawSortKey(0u, fieldDistribution(randomEngine), fieldDistribution(randomEngine) * 1000u, depthDistribution(randomEngine)); }break;
+				}
+
+				drawPackets[i].drawIndex = i;
+			}
+
+			std::vector<gfx::DrawPacket> referencePackets = drawPackets;
+			std::vector<gfx::DrawPacket> scratch{};
+			gfx::SortDrawPackets(referencePackets, scratch, gfx::DrawSortImplementation::StdSort);
+
+			for (const gfx::DrawSortImplementation drawSortImplementation : DRAW_SORT_IMPLEMENTATIONS)
+			{
+				std::vector<gfx::DrawPacket> sortedPackets = drawPackets;
+				gfx::SortDrawPackets(sortedPackets, scratch, drawSortImplementation);
+
+				const bool isMatching = std::ranges::equal(sortedPackets, referencePackets, [](const gfx::DrawPacket& a, const gfx::DrawPacket& b)
+				{
+					return a.sortKey == b.sortKey && a.drawIndex == b.drawIndex;
+				});
+
+				if (!Expect(SUITE_NAME, isMatching, gfx::DrawSortImplementationToString(drawSortImplementation), "the packets to be sorted as std::stable_sort"))
+				{
+					std::printf("Draw sorting : %u packets, key distribution %u\n", packetCount, distribution);
+					return false;
+				}
+			}
+		}
+	}
+
+	// State changes : the first packet sets all state, and changing the pipeline also changes the material.
+	{
+		const std::array<gfx::DrawPacket, 5u> drawPackets
+		{
+			gfx::DrawPacket{ .sortKey = gfx::MakeDrawSortKey(0u, 0u, 0u, 0.1f) },
+			gfx::DrawPacket{ .sortKey = gfx::MakeDrawSortKey(0u, 0u, 0u, 0.2f) },
+			gfx::DrawPacket{ .sortKey = gfx::MakeDrawSortKey(0u, 0u, 1u, 0.1f) },
+			gfx::DrawPacket{ .sortKey = gfx::MakeDrawSortKey(0u, 1u, 1u, 0.1f) },
+			gfx::DrawPacket{ .sortKey = gfx::MakeDrawSortKey(1u, 1u, 1u, 0.1f) },
+		};
+
+		const gfx::DrawSortStateChanges stateChanges = gfx::CountDrawSortStateChanges(drawPackets);
+		if (!Expect(SUITE_NAME, stateChanges.passChangeCount == 2u && stateChanges.pipelineChangeCount == 3u && stateChanges.materialChangeCount == 4u, "State changes",
+			"2 pass, 3 pipeline and 4 material changes"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Draw sorting : all cases are valid\n");
+
+	return true;
+}
+
+void BenchmarkDrawSorting()
+{
+	static constexpr uint32_t DRAW_COUNT = 100'000u;
+	static constexpr uint32_t ITERATION_COUNT = 50u;
+
+	std::mt19937 randomEngine(42u);
+	const DrawSortingScene drawSortingScene = CreateDrawSortingScene(DRAW_COUNT, 2048u, 8u, 512u, randomEngine);
+	const scene::Matrix4x4 viewProjectionMatrix = scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+	std::vector<gfx::DrawPacket> unsortedPackets{};
+
+	double keyingTime{};
+	for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+	{
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		BuildDrawSortingPackets(drawSortingScene, viewProjectionMatrix, unsortedPackets);
+		keyingTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	std::printf("Draw sorting : %u draws | keying %.3f ms\n", DRAW_COUNT, keyingTime / ITERATION_COUNT);
+
+	std::vector<gfx::DrawPacket> sortedPackets{};
+	std::vector<gfx::DrawPacket> scratch{};
+	double stdSortTime{};
+
+	for (const gfx::DrawSortImplementation drawSortImplementation : DRAW_SORT_IMPLEMENTATIONS)
+	{
+		double sortingTime{};
+		for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+		{
+			sortedPackets = unsortedPackets;
+
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			gfx::SortDrawPackets(sortedPackets, scratch, drawSortImplementation);
+			sortingTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		}
+
+		stdSortTime = drawSortImplementation == gfx::DrawSortImplementation::StdSort ? sortingTime : stdSortTime;
+
+		std::printf("Draw sorting : %-13s | %u draws | %.3f ms | %.2fx std::stable_sort\n", gfx::DrawSortImplementationToString(drawSortImplementation), DRAW_COUNT,
+			sortingTime / ITERATION_COUNT, stdSortTime / std::max(sortingTime, 1e-9));
+	}
+
+	// The state changes and commands recorded for the draws in draw index order, and sorted : the command stream filters the pipeline state / index buffer
+	// set again for consecutive draws sharing them.
+	for (const bool isSorted : { false, true })
+	{
+		const std::span<const gfx::DrawPacket> drawPackets = isSorted ? sortedPackets : unsortedPackets;
+
+		const gfx::DrawSortStateChanges stateChanges = gfx::CountDrawSortStateChanges(drawPackets);
+		const gfx::CommandStreamStatistics statistics = RecordDrawPackets(drawSortingScene, drawPackets);
+
+		std::printf("Draw sorting : %-8s | %u pipeline changes | %u material changes | %llu commands recorded (%llu filtered) | %.1f KB of commands\n",
+			isSorted ? "sorted" : "unsorted", stateChanges.pipelineChangeCount, stateChanges.materialChangeCount, static_cast<unsigned long long>(statistics.recordedCommandCount),
+			static_cast<unsigned long long>(statistics.filteredCommandCount), static_cast<double>(statistics.recordedByteSize) / 1024.0);
+	}
+}
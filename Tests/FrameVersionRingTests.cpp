@@ -0,0 +1,118 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Graphics/API/FrameVersionRing.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Frame version ring";
+
+	// Same as the device : MAX_FRAMES_IN_FLIGHT versions, and the CPU records at most MAX_FRAMES_IN_FLIGHT - 1 frames ahead of the GPU.
+	constexpr uint32_t VERSION_COUNT = 3u;
+	constexpr uint64_t MAX_FRAME_LATENCY = VERSION_COUNT - 1u;
+
+	// Simulates the graphics fence : each frame signals its frame number + 1 on present, which the 'GPU' completes later (in order).
+	struct SimulatedFence
+	{
+		uint64_t lastSignaledValue{};
+		uint64_t completedValue{};
+
+		bool IsFrameComplete(uint64_t frameNumber) const { return completedValue > frameNumber; }
+	};
+}
+
+bool VerifyFrameVersionRing()
+{
+	// Writes within a frame overwrite the same version, and the next frame writes the version after it.
+	{
+		gfx::FrameVersionRing<VERSION_COUNT> versionRing{};
+
+		const uint32_t firstVersion = versionRing.Advance(0u);
+		const uint32_t secondWriteVersion = versionRing.Advance(0u);
+		const uint32_t nextFrameVersion = versionRing.Advance(1u);
+
+		if (!Expect(SUITE_NAME, firstVersion == secondWriteVersion && versionRing.GetVersion() == nextFrameVersion, "Frame", "writes within a frame share their version") ||
+			!Expect(SUITE_NAME, nextFrameVersion == (firstVersion + 1u) % VERSION_COUNT, "Frame", "the next frame writes the next version"))
+		{
+			return false;
+		}
+	}
+
+	// Frames recorded ahead of a GPU progressing at an irregular pace, with buffers written several times in some frames and not at all in others :
+	// no version is written while a frame still in flight reads it, and every frame reads the data last written before it was submitted.
+	{
+		static constexpr uint32_t BUFFER_COUNT = 8u;
+		static constexpr uint64_t FRAME_COUNT = 2000u;
+
+		std::mt19937 randomEngine(7u);
+		SimulatedFence simulatedFence{};
+
+		std::array<gfx::FrameVersionRing<VERSION_COUNT>, BUFFER_COUNT> versionRings{};
+		std::array<std::array<uint64_t, VERSION_COUNT>, BUFFER_COUNT> versionContents{};
+		std::array<uint64_t, BUFFER_COUNT> lastWrittenContents{};
+
+		// Version of each buffer read by every submitted frame.
+		std::vector<std::array<uint32_t, BUFFER_COUNT>> frameReadVersions{};
+
+		bool isInFlightVersionWritten{ false };
+		bool isStaleVersionRead{ false };
+		uint64_t writeCount{};
+
+		for (uint64_t frameNumber = 0u; frameNumber < FRAME_COUNT; ++frameNumber)
+		{
+			// The CPU waits for the frame MAX_FRAME_LATENCY + 1 frames behind before recording.
+			if (frameNumber > MAX_FRAME_LATENCY)
+			{
+				simulatedFence.completedValue = std::max(simulatedFence.completedValue, frameNumber - MAX_FRAME_LATENCY);
+			}
+
+			for (uint32_t bufferIndex = 0u; bufferIndex < BUFFER_COUNT; ++bufferIndex)
+			{
+				const uint32_t bufferWriteCount = randomEngine() % 4u;
+				for (uint32_t i = 0u; i < bufferWriteCount; ++i)
+				{
+					const uint32_t version = versionRings[bufferIndex].Advance(frameNumber);
+
+					for (uint64_t previousFrameNumber = 0u; previousFrameNumber < frameNumber; ++previousFrameNumber)
+					{
+						isInFlightVersionWritten = isInFlightVersionWritten ||
+							(!simulatedFence.IsFrameComplete(previousFrameNumber) && frameReadVersions[previousFrameNumber][bufferIndex] == version);
+					}
+
+					versionContents[bufferIndex][version] = ++writeCount;
+					lastWrittenContents[bufferIndex] = writeCount;
+				}
+			}
+
+			std::array<uint32_t, BUFFER_COUNT>& readVersions = frameReadVersions.emplace_back();
+			for (uint32_t bufferIndex = 0u; bufferIndex < BUFFER_COUNT; ++bufferIndex)
+			{
+				readVersions[bufferIndex] = versionRings[bufferIndex].GetVersion();
+				isStaleVersionRead = isStaleVersionRead || versionContents[bufferIndex][readVersions[bufferIndex]] != lastWrittenContents[bufferIndex];
+			}
+
+			// Present, and the GPU completes between 0 and 2 frames.
+			simulatedFence.lastSignaledValue = frameNumber + 1u;
+			simulatedFence.completedValue = std::min(simulatedFence.completedValue + randomEngine() % 3u, simulatedFence.lastSignaledValue);
+		}
+
+		if (!Expect(SUITE_NAME, !isInFlightVersionWritten, "Simulated fence", "no version written while a frame in flight reads it") ||
+			!Expect(SUITE_NAME, !isStaleVersionRead, "Simulated fence", "every frame reads the data last written before its submission"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Frame version ring : all cases are valid\n");
+
+	return true;
+}
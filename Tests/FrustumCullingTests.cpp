@@ -0,0 +1,194 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Scene/FrustumCulling.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Frustum culling";
+}
+
+bool VerifyFrustumCulling()
+{
+	const scene::Frustum frustum = scene::ExtractFrustum(scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	// Hand written cases, for boxes (of half extent 1) and spheres (of radius 1), with the expected visibility.
+	struct CullingCase
+	{
+		const char* name{};
+		scene::Float3 center{};
+		bool isVisible{};
+	};
+
+	static constexpr std::array<CullingCase, 9u> CULLING_CASES
+	{
+		CullingCase{ "In front of the camera", { 0.0f, 0.0f, 10.0f }, true },
+		CullingCase{ "Behind the camera", { 0.0f, 0.0f, -10.0f }, false },
+		CullingCase{ "Straddling the near plane", { 0.0f, 0.0f, 0.0f }, true },
+		CullingCase{ "Beyond the far plane", { 0.0f, 0.0f, 1002.0f }, false },
+		CullingCase{ "Straddling the far plane", { 0.0f, 0.0f, 1000.5f }, true },
+		CullingCase{ "Left of the frustum", { -50.0f, 0.0f, 10.0f }, false },
+		CullingCase{ "Right of the frustum", { 50.0f, 0.0f, 10.0f }, false },
+		CullingCase{ "Above the frustum", { 0.0f, 50.0f, 10.0f }, false },
+		CullingCase{ "Straddling the bottom plane", { 0.0f, -4.6f, 10.0f }, true },
+	};
+
+	scene::BoundingBoxSoA boundingBoxes{};
+	scene::BoundingSphereSoA boundingSpheres{};
+	boundingBoxes.Resize(static_cast<uint32_t>(CULLING_CASES.size()));
+	boundingSpheres.Resize(static_cast<uint32_t>(CULLING_CASES.size()));
+
+	for (uint32_t i = 0u; i < static_cast<uint32_t>(CULLING_CASES.size()); ++i)
+	{
+		const scene::Float3& center = CULLING_CASES[i].center;
+		boundingBoxes.Set(i, scene::BoundingBox{ .minimum = { center[0] - 1.0f, center[1] - 1.0f, center[2] - 1.0f }, .maximum = { center[0] + 1.0f, center[1] + 1.0f, center[2] + 1.0f } });
+		boundingSpheres.Set(i, scene::BoundingSphere{ .center = center, .radius = 1.0f });
+	}
+
+	for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+	{
+		if (!scene::IsCullingImplementationSupported(cullingImplementation))
+		{
+			continue;
+		}
+
+		std::vector<uint8_t> boxVisibility(CULLING_CASES.size());
+		std::vector<uint8_t> sphereVisibility(CULLING_CASES.size());
+		scene::CullBoundingBoxes(frustum, boundingBoxes, boxVisibility, cullingImplementation);
+		scene::CullBoundingSpheres(frustum, boundingSpheres, sphereVisibility, cullingImplementation);
+
+		for (size_t i = 0u; i < CULLING_CASES.size(); ++i)
+		{
+			const char* expectation = CULLING_CASES[i].isVisible ? "the bounds to be visible" : "the bounds to be culled";
+			if (!Expect(SUITE_NAME, (boxVisibility[i] != 0u) == CULLING_CASES[i].isVisible, CULLING_CASES[i].name, expectation) ||
+				!Expect(SUITE_NAME, (sphereVisibility[i] != 0u) == CULLING_CASES[i].isVisible, CULLING_CASES[i].name, expectation))
+			{
+				return false;
+			}
+		}
+	}
+
+	// A unit box rotated by 45 degrees around Y (and translated) is sqrt(2) wide along X and Z, and the sphere is scaled by the largest scale.
+	{
+		const float cosAngle = std::cos(0.785398f);
+		const float sinAngle = std::sin(0.785398f);
+		const scene::Matrix4x4 modelMatrix
+		{
+			cosAngle, 0.0f, -sinAngle, 0.0f,
+			0.0f, 3.0f, 0.0f, 0.0f,
+			sinAngle, 0.0f, cosAngle, 0.0f,
+			10.0f, 20.0f, 30.0f, 1.0f,
+		};
+
+		const scene::BoundingBox boundingBox = scene::TransformBoundingBox(scene::BoundingBox{ .minimum = { -1.0f, -1.0f, -1.0f }, .maximum = { 1.0f, 1.0f, 1.0f } }, modelMatrix);
+		const scene::BoundingSphere boundingSphere = scene::TransformBoundingSphere(scene::BoundingSphere{ .center = { 1.0f, 0.0f, 0.0f }, .radius = 2.0f }, modelMatrix);
+
+		const auto IsNear = [](float a, float b) { return std::abs(a - b) < 1e-4f; };
+		if (!Expect(SUITE_NAME, IsNear(boundingBox.minimum[0], 10.0f - 1.414214f) && IsNear(boundingBox.maximum[2], 30.0f + 1.414214f) &&
+			IsNear(boundingBox.minimum[1], 17.0f) && IsNear(boundingBox.maximum[1], 23.0f), "Transformed box", "the box enclosing the rotated, scaled and translated box") ||
+			!Expect(SUITE_NAME, IsNear(boundingSphere.center[0], 10.0f + cosAngle) && IsNear(boundingSphere.center[2], 30.0f - sinAngle) && IsNear(boundingSphere.radius, 6.0f),
+				"Transformed sphere", "the center to be transformed and the radius to be scaled by 3"))
+		{
+			return false;
+		}
+	}
+
+	// The SIMD implementations must match the scalar one exactly, including for counts that are not a multiple of the batch size.
+	std::mt19937 randomEngine(42u);
+
+	for (const uint32_t count : { 1u, 7u, 9u, 1000u, 10007u })
+	{
+		CreateRandomBounds(count, randomEngine, boundingBoxes, boundingSpheres);
+
+		std::vector<uint8_t> referenceBoxVisibility(count);
+		std::vector<uint8_t> referenceSphereVisibility(count);
+		const uint32_t referenceBoxCount = scene::CullBoundingBoxes(frustum, boundingBoxes, referenceBoxVisibility, scene::CullingImplementation::Scalar);
+		const uint32_t referenceSphereCount = scene::CullBoundingSpheres(frustum, boundingSpheres, referenceSphereVisibility, scene::CullingImplementation::Scalar);
+
+		for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+		{
+			if (!scene::IsCullingImplementationSupported(cullingImplementation))
+			{
+				continue;
+			}
+
+			// Checks that the padding past the count is never written.
+			std::vector<uint8_t> boxVisibility(count + 1u, 0xFFu);
+			std::vector<uint8_t> sphereVisibility(count + 1u, 0xFFu);
+			const uint32_t boxCount = scene::CullBoundingBoxes(frustum, boundingBoxes, boxVisibility, cullingImplementation);
+			const uint32_t sphereCount = scene::CullBoundingSpheres(frustum, boundingSpheres, sphereVisibility, cullingImplementation);
+
+			const char* caseName = scene::CullingImplementationToString(cullingImplementation);
+			if (!Expect(SUITE_NAME, boxCount == referenceBoxCount && std::equal(referenceBoxVisibility.begin(), referenceBoxVisibility.end(), boxVisibility.begin()) &&
+				boxVisibility.back() == 0xFFu, caseName, "the same box visibility as the scalar implementation") ||
+				!Expect(SUITE_NAME, sphereCount == referenceSphereCount && std::equal(referenceSphereVisibility.begin(), referenceSphereVisibility.end(), sphereVisibility.begin()) &&
+				sphereVisibility.back() == 0xFFu, caseName, "the same sphere visibility as the scalar implementation"))
+			{
+				return false;
+			}
+		}
+	}
+
+	std::printf("Frustum culling : all cases are valid (%s used by default)\n", scene::CullingImplementationToString(scene::ResolveCullingImplementation(scene::CullingImplementation::Best)));
+
+	return true;
+}
+
+void BenchmarkFrustumCulling()
+{
+	static constexpr uint32_t BOUNDS_COUNT = 100'000u;
+	static constexpr uint32_t ITERATION_COUNT = 200u;
+
+	const scene::Frustum frustum = scene::ExtractFrustum(scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	std::mt19937 randomEngine(42u);
+	scene::BoundingBoxSoA boundingBoxes{};
+	scene::BoundingSphereSoA boundingSpheres{};
+	CreateRandomBounds(BOUNDS_COUNT, randomEngine, boundingBoxes, boundingSpheres);
+
+	std::vector<uint8_t> visibility(BOUNDS_COUNT);
+
+	for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+	{
+		if (!scene::IsCullingImplementationSupported(cullingImplementation))
+		{
+			continue;
+		}
+
+		for (const bool isSphere : { false, true })
+		{
+			std::vector<double> cullingTimes{};
+			uint32_t visibleCount{};
+
+			for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+			{
+				const auto startTime = std::chrono::high_resolution_clock::now();
+				visibleCount = isSphere ? scene::CullBoundingSpheres(frustum, boundingSpheres, visibility, cullingImplementation) :
+					scene::CullBoundingBoxes(frustum, boundingBoxes, visibility, cullingImplementation);
+				cullingTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - startTime).count());
+			}
+
+			std::sort(cullingTimes.begin(), cullingTimes.end());
+
+			double totalCullingTime{};
+			for (const double cullingTime : cullingTimes)
+			{
+				totalCullingTime += cullingTime;
+			}
+
+			std::printf("Frustum culling : %-6s %-7s | %u bounds | average %8.1f us | p95 %8.1f us | %u visible\n", scene::CullingImplementationToString(cullingImplementation),
+				isSphere ? "spheres" : "boxes", BOUNDS_COUNT, totalCullingTime / cullingTimes.size(), cullingTimes[cullingTimes.size() * 95u / 100u], visibleCount);
+		}
+	}
+}
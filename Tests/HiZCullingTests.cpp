@@ -0,0 +1,343 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Graphics/API/SinglePassDownsampler.hpp"
+#include "Scene/HiZCulling.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Hi-Z culling";
+
+	// Stand in for the geometry of a draw : the pixels whose center is within the screen space bounds of its box, at the nearest depth of the box (so the
+	// box is only occluded where it is hidden). Boxes crossing the near plane are not rendered.
+	void RenderHiZImpostor(const scene::BoundingBox& boundingBox, const scene::Matrix4x4& viewProjectionMatrix, uint32_t width, uint32_t height, std::span<float> depthBuffer)
+	{
+		const std::optional<scene::HiZScreenBounds> screenBounds = scene::ProjectBoundingBoxToScreen(boundingBox, viewProjectionMatrix, width, height);
+		if (!screenBounds.has_value())
+		{
+			return;
+		}
+
+		// Pixels [begin, end) whose center is within [minimum, maximum].
+		const auto GetPixelRange = [](float minimum, float maximum, uint32_t dimension)
+		{
+			const float begin = std::clamp(std::ceil(minimum - 0.5f), 0.0f, static_cast<float>(dimension));
+			const float end = std::clamp(std::floor(maximum - 0.5f) + 1.0f, begin, static_cast<float>(dimension));
+
+			return std::pair{ static_cast<uint32_t>(begin), static_cast<uint32_t>(end) };
+		};
+
+		const auto [columnBegin, columnEnd] = GetPixelRange(screenBounds->minimumX, screenBounds->maximumX, width);
+		const auto [rowBegin, rowEnd] = GetPixelRange(screenBounds->minimumY, screenBounds->maximumY, height);
+
+		for (uint32_t y = rowBegin; y < rowEnd; ++y)
+		{
+			for (uint32_t x = columnBegin; x < columnEnd; ++x)
+			{
+				float& depth = depthBuffer[static_cast<size_t>(y) * width + x];
+				depth = std::min(depth, screenBounds->minimumZ);
+			}
+		}
+	}
+
+	// The texel range of every mip must be exactly the range of the pixels GetHiZTexelIndex maps to it, and the last mip must be 1 x 1.
+	bool VerifyHiZPyramid(uint32_t width, uint32_t height, std::mt19937& randomEngine)
+	{
+		std::uniform_real_distribution<float> depthDistribution(0.0f, 1.0f);
+
+		std::vector<float> depthBuffer(static_cast<size_t>(width) * height);
+		std::ranges::generate(depthBuffer, [&]() { return depthDistribution(randomEngine); });
+
+		scene::HiZPyramid pyramid{};
+		pyramid.Build(depthBuffer, width, height);
+
+		const std::string caseName = std::to_string(width) + "x" + std::to_string(height);
+
+		const uint32_t lastMipLevel = pyramid.GetMipCount() - 1u;
+		if (!Expect(SUITE_NAME, gfx::GetDownsampleMipDimension(width, lastMipLevel) == 1u && gfx::GetDownsampleMipDimension(height, lastMipLevel) == 1u, caseName.c_str(),
+			"the last mip to be 1 x 1"))
+		{
+			return false;
+		}
+
+		for (uint32_t mipLevel = 0u; mipLevel < pyramid.GetMipCount(); ++mipLevel)
+		{
+			const uint32_t mipWidth = gfx::GetDownsampleMipDimension(width, mipLevel);
+			const uint32_t mipHeight = gfx::GetDownsampleMipDimension(height, mipLevel);
+
+			std::vector<std::array<float, 2u>> ranges(static_cast<size_t>(mipWidth) * mipHeight, { std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() });
+			for (uint32_t y = 0u; y < height; ++y)
+			{
+				for (uint32_t x = 0u; x < width; ++x)
+				{
+					const float depth = depthBuffer[static_cast<size_t>(y) * width + x];
+
+					std::array<float, 2u>& range = ranges[static_cast<size_t>(scene::GetHiZTexelIndex(y, height, mipLevel)) * mipWidth + scene::GetHiZTexelIndex(x, width, mipLevel)];
+					range = { std::min(range[0], depth), std::max(range[1], depth) };
+				}
+			}
+
+			for (uint32_t y = 0u; y < mipHeight; ++y)
+			{
+				for (uint32_t x = 0u; x < mipWidth; ++x)
+				{
+					const gfx::DownsampleTexel& texel = pyramid.GetTexel(mipLevel, x, y);
+					const std::array<float, 2u>& range = ranges[static_cast<size_t>(y) * mipWidth + x];
+
+					if (!Expect(SUITE_NAME, texel[0] == range[0] && texel[1] == range[1], caseName.c_str(), "the texels to hold the depth range of the pixels mapped to them"))
+					{
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+bool VerifyHiZCulling()
+{
+	std::mt19937 randomEngine(42u);
+
+	for (const auto& [width, height] : { std::pair{ 1u, 1u }, std::pair{ 1u, 7u }, std::pair{ 64u, 64u }, std::pair{ 157u, 93u }, std::pair{ 320u, 192u }, std::pair{ 333u, 4u } })
+	{
+		if (!VerifyHiZPyramid(width, height, randomEngine))
+		{
+			return false;
+		}
+	}
+
+	// The mip selected for random rects must be the lowest at which they touch at most 2 x 2 texels.
+	for (const auto& [width, height] : { std::pair{ 157u, 93u }, std::pair{ 1920u, 1080u }, std::pair{ 4096u, 4096u } })
+	{
+		const uint32_t mipCount = scene::GetHiZMipCount(width, height);
+
+		for (uint32_t i = 0u; i < 10'000u; ++i)
+		{
+			std::uniform_int_distribution<uint32_t> columnDistribution(0u, width - 1u);
+			std::uniform_int_distribution<uint32_t> rowDistribution(0u, height - 1u);
+
+			const auto [columnBegin, columnEnd] = std::minmax({ columnDistribution(randomEngine), columnDistribution(randomEngine) });
+			const auto [rowBegin, rowEnd] = std::minmax({ rowDistribution(randomEngine), rowDistribution(randomEngine) });
+
+			const scene::HiZPixelRect pixelRect{ .columnBegin = columnBegin, .columnEnd = columnEnd, .rowBegin = rowBegin, .rowEnd = rowEnd };
+
+			const auto IsWithin2x2 = [&](uint32_t mipLevel)
+			{
+				return scene::GetHiZTexelIndex(columnEnd, width, mipLevel) - scene::GetHiZTexelIndex(columnBegin, width, mipLevel) <= 1u &&
+					scene::GetHiZTexelIndex(rowEnd, height, mipLevel) - scene::GetHiZTexelIndex(rowBegin, height, mipLevel) <= 1u;
+			};
+
+			const std::optional<uint32_t> mipLevel = scene::GetHiZMipLevel(pixelRect, width, height, mipCount);
+			if (!Expect(SUITE_NAME, mipLevel.has_value() && *mipLevel < mipCount && IsWithin2x2(*mipLevel) && (*mipLevel == 0u || !IsWithin2x2(*mipLevel - 1u)), "Mip selection",
+				"the lowest mip at which the rect touches at most 2 x 2 texels"))
+			{
+				return false;
+			}
+		}
+	}
+
+	static constexpr uint32_t WIDTH = 320u;
+	static constexpr uint32_t HEIGHT = 192u;
+
+	const scene::Matrix4x4 viewProjectionMatrix = scene::CreatePerspectiveMatrix(0.785398f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+
+	// Hand written cases against a wall, for boxes of half extent 0.5, with the expected occlusion.
+	{
+		std::vector<float> depthBuffer(static_cast<size_t>(WIDTH) * HEIGHT, 1.0f);
+		RenderHiZImpostor(scene::BoundingBox{ .minimum = { -5.0f, -5.0f, 10.0f }, .maximum = { 5.0f, 5.0f, 10.5f } }, viewProjectionMatrix, WIDTH, HEIGHT, depthBuffer);
+
+		scene::HiZPyramid pyramid{};
+		pyramid.Build(depthBuffer, WIDTH, HEIGHT);
+
+		struct OcclusionCase
+		{
+			const char* name{};
+			scene::Float3 center{};
+			bool isOccluded{};
+		};
+
+		static constexpr std::array<OcclusionCase, 7u> OCCLUSION_CASES
+		{
+			OcclusionCase{ "Behind the wall", { 2.0f, 0.0f, 20.0f }, true },
+			OcclusionCase{ "Far behind the wall", { -3.0f, 1.0f, 200.0f }, true },
+			OcclusionCase{ "In front of the wall", { 0.0f, 0.0f, 5.0f }, false },
+			OcclusionCase{ "Partially behind the wall", { 9.8f, 0.0f, 20.0f }, false },
+			OcclusionCase{ "Beside the wall", { 12.0f, 0.0f, 20.0f }, false },
+			OcclusionCase{ "Straddling the near plane", { 0.0f, 0.0f, 0.0f }, false },
+			OcclusionCase{ "Outside of the screen", { 0.0f, 60.0f, 20.0f }, false },
+		};
+
+		for (const OcclusionCase& occlusionCase : OCCLUSION_CASES)
+		{
+			if (!Expect(SUITE_NAME, pyramid.IsBoundingBoxOccluded(CreateCenteredBox(occlusionCase.center, { 0.5f, 0.5f, 0.5f }), viewProjectionMatrix) == occlusionCase.isOccluded,
+				occlusionCase.name, occlusionCase.isOccluded ? "the box to be occluded" : "the box to be visible"))
+			{
+				return false;
+			}
+		}
+
+		if (!Expect(SUITE_NAME, !scene::HiZPyramid{}.IsBoundingBoxOccluded(CreateCenteredBox({ 2.0f, 0.0f, 20.0f }, { 0.5f, 0.5f, 0.5f }), viewProjectionMatrix), "Empty pyramid",
+			"nothing to be occluded"))
+		{
+			return false;
+		}
+	}
+
+	// Random scenes : every culled box must be behind the per pixel depth buffer over all the pixels its bounds touch.
+	uint32_t referenceOccludedCount{};
+	uint32_t occludedCount{};
+
+	for (uint32_t sceneIndex = 0u; sceneIndex < 16u; ++sceneIndex)
+	{
+		std::uniform_real_distribution<float> positionDistribution(-30.0f, 30.0f);
+		std::uniform_real_distribution<float> depthDistribution(2.0f, 100.0f);
+		std::uniform_real_distribution<float> sizeDistribution(0.05f, 3.0f);
+		std::uniform_real_distribution<float> occluderSizeDistribution(1.0f, 12.0f);
+
+		std::vector<float> depthBuffer(static_cast<size_t>(WIDTH) * HEIGHT, 1.0f);
+		for (uint32_t i = 0u; i < 8u + sceneIndex * 4u; ++i)
+		{
+			const scene::Float3 center{ positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.5f, depthDistribution(randomEngine) * 0.5f };
+			RenderHiZImpostor(CreateCenteredBox(center, { occluderSizeDistribution(randomEngine), occluderSizeDistribution(randomEngine), 0.25f }), viewProjectionMatrix, WIDTH, HEIGHT, depthBuffer);
+		}
+
+		scene::HiZPyramid pyramid{};
+		pyramid.Build(depthBuffer, WIDTH, HEIGHT);
+
+		for (uint32_t i = 0u; i < 2000u; ++i)
+		{
+			const scene::Float3 center{ positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.5f, depthDistribution(randomEngine) };
+			const scene::BoundingBox boundingBox = CreateCenteredBox(center, { sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine) });
+
+			bool isReferenceOccluded{ false };
+
+			const std::optional<scene::HiZScreenBounds> screenBounds = scene::ProjectBoundingBoxToScreen(boundingBox, viewProjectionMatrix, WIDTH, HEIGHT);
+			const std::optional<scene::HiZPixelRect> pixelRect = screenBounds.has_value() ? scene::GetHiZPixelRect(*screenBounds, WIDTH, HEIGHT) : std::nullopt;
+			if (pixelRect.has_value())
+			{
+				isReferenceOccluded = true;
+				for (uint32_t y = pixelRect->rowBegin; y <= pixelRect->rowEnd; ++y)
+				{
+					for (uint32_t x = pixelRect->columnBegin; x <= pixelRect->columnEnd; ++x)
+					{
+						isReferenceOccluded &= depthBuffer[static_cast<size_t>(y) * WIDTH + x] < screenBounds->minimumZ;
+					}
+				}
+			}
+
+			const bool isOccluded = pyramid.IsBoundingBoxOccluded(boundingBox, viewProjectionMatrix);
+			if (!Expect(SUITE_NAME, !isOccluded || isReferenceOccluded, "Random scene", "the culled boxes to be occluded in the depth buffer"))
+			{
+				return false;
+			}
+
+			referenceOccludedCount += isReferenceOccluded ? 1u : 0u;
+			occludedCount += isOccluded ? 1u : 0u;
+		}
+	}
+
+	// Two phase culling along a camera path through a city of blocks and props : the depth of the draws of both phases must be the depth of all draws (every
+	// draw that shows was drawn), and no draw may be drawn twice in a frame.
+	static constexpr uint32_t FRAME_COUNT = 64u;
+
+	std::vector<scene::HiZDrawBounds> drawBounds{};
+	std::vector<scene::BoundingBox> drawBoxes{};
+
+	const auto AddDraw = [&](const scene::BoundingBox& boundingBox)
+	{
+		drawBounds.push_back(scene::HiZDrawBounds{ .minimum = boundingBox.minimum, .visibilityIndex = static_cast<uint32_t>(drawBounds.size()), .maximum = boundingBox.maximum });
+		drawBoxes.push_back(boundingBox);
+	};
+
+	for (float x = -60.0f; x <= 60.0f; x += 12.0f)
+	{
+		for (float z = -60.0f; z <= 60.0f; z += 12.0f)
+		{
+			AddDraw(CreateCenteredBox({ x, 4.0f, z }, { 3.0f, 4.0f, 3.0f }));
+		}
+	}
+
+	{
+		std::uniform_real_distribution<float> positionDistribution(-66.0f, 66.0f);
+		std::uniform_real_distribution<float> sizeDistribution(0.1f, 0.6f);
+		for (uint32_t i = 0u; i < 3000u; ++i)
+		{
+			const float extent = sizeDistribution(randomEngine);
+			AddDraw(CreateCenteredBox({ positionDistribution(randomEngine), extent, positionDistribution(randomEngine) }, { extent, extent, extent }));
+		}
+	}
+
+	const scene::Matrix4x4 projectionMatrix = scene::CreatePerspectiveMatrix(1.047198f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+
+	scene::HiZPyramid pyramid{};
+	std::vector<uint8_t> visibility(drawBounds.size(), 0u);
+
+	uint64_t firstPhaseDrawCount{};
+	uint64_t secondPhaseDrawCount{};
+
+	for (uint32_t frame = 0u; frame < FRAME_COUNT; ++frame)
+	{
+		const float t = static_cast<float>(frame) / static_cast<float>(FRAME_COUNT - 1u);
+		const scene::Matrix4x4 frameViewProjectionMatrix = scene::MultiplyMatrices(CreateWalkthroughViewMatrix({ -54.0f + 108.0f * t, 1.5f, 6.0f }, 1.2f + std::sin(t * 6.0f)), projectionMatrix);
+
+		std::vector<uint32_t> firstPhaseDrawIndices{};
+		scene::CullHiZDraws(scene::HiZCullingPhase::First, drawBounds, pyramid, frameViewProjectionMatrix, visibility, firstPhaseDrawIndices);
+
+		std::vector<float> depthBuffer(static_cast<size_t>(WIDTH) * HEIGHT, 1.0f);
+		for (const uint32_t drawIndex : firstPhaseDrawIndices)
+		{
+			RenderHiZImpostor(drawBoxes[drawIndex], frameViewProjectionMatrix, WIDTH, HEIGHT, depthBuffer);
+		}
+
+		pyramid.Build(depthBuffer, WIDTH, HEIGHT);
+
+		std::vector<uint32_t> secondPhaseDrawIndices{};
+		scene::CullHiZDraws(scene::HiZCullingPhase::Second, drawBounds, pyramid, frameViewProjectionMatrix, visibility, secondPhaseDrawIndices);
+
+		for (const uint32_t drawIndex : secondPhaseDrawIndices)
+		{
+			RenderHiZImpostor(drawBoxes[drawIndex], frameViewProjectionMatrix, WIDTH, HEIGHT, depthBuffer);
+		}
+
+		std::vector<float> referenceDepthBuffer(static_cast<size_t>(WIDTH) * HEIGHT, 1.0f);
+		for (const scene::BoundingBox& boundingBox : drawBoxes)
+		{
+			RenderHiZImpostor(boundingBox, frameViewProjectionMatrix, WIDTH, HEIGHT, referenceDepthBuffer);
+		}
+
+		std::vector<uint32_t> drawnIndices = firstPhaseDrawIndices;
+		drawnIndices.insert(drawnIndices.end(), secondPhaseDrawIndices.begin(), secondPhaseDrawIndices.end());
+		std::ranges::sort(drawnIndices);
+
+		if (!Expect(SUITE_NAME, depthBuffer == referenceDepthBuffer, "Two phases", "the draws of both phases to produce the depth of all draws") ||
+			!Expect(SUITE_NAME, std::ranges::adjacent_find(drawnIndices) == drawnIndices.end(), "Two phases", "no draw to be drawn by both phases"))
+		{
+			return false;
+		}
+
+		firstPhaseDrawCount += firstPhaseDrawIndices.size();
+		secondPhaseDrawCount += secondPhaseDrawIndices.size();
+	}
+
+	std::printf("Hi-Z culling : all cases are valid (%u of the %u boxes occluded in the per pixel depth buffer are culled, %.1f + %.1f of %zu draws drawn per frame by the two phases)\n",
+		occludedCount, referenceOccludedCount, static_cast<double>(firstPhaseDrawCount) / FRAME_COUNT, static_cast<double>(secondPhaseDrawCount) / FRAME_COUNT, drawBounds.size());
+
+	return true;
+}
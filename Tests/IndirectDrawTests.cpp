@@ -0,0 +1,293 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "Graphics/API/IndirectDraw.hpp"
+#include "Graphics/API/NullRenderBackend.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Indirect draws";
+
+	// Same size as PBRRenderResources (the draw data of the deferred geometry pass).
+	using IndirectDrawData = std::array<uint32_t, 18u>;
+
+	uint32_t CountRecordedCommands(const gfx::CommandStream& commandStream, gfx::CommandType type)
+	{
+		uint32_t count{};
+		commandStream.ForEachCommand([&](const gfx::CommandHeader& header)
+		{
+			count += header.type == type ? 1u : 0u;
+		});
+
+		return count;
+	}
+}
+
+bool VerifyIndirectDraws()
+{
+	// Layout : each draw gets consecutive arguments (with its index as draw index), and its draw data zero padded to the stride.
+	{
+		gfx::IndirectDrawStream indirectDrawStream(static_cast<uint32_t>(sizeof(IndirectDrawData)));
+
+		for (uint32_t i = 0u; i < 100u; ++i)
+		{
+			IndirectDrawData drawData{};
+			drawData.fill(i * 100u);
+
+			const uint32_t drawIndex = indirectDrawStream.AddDraw(gfx::IndexBufferView{ .bufferLocation = 0x1000u * i, .sizeInBytes = 12u * i, .format = 42u },
+				gfx::DrawIndexedArguments{ .indexCountPerInstance = 3u * i, .instanceCount = 1u, .startIndexLocation = i, .baseVertexLocation = -static_cast<int32_t>(i) },
+				drawData);
+
+			if (!Expect(SUITE_NAME, drawIndex == i, "Layout", "the draw indices to be consecutive"))
+			{
+				return false;
+			}
+		}
+
+		// A smaller draw data is padded, and a larger one truncated.
+		const uint32_t smallDrawData = 7u;
+		indirectDrawStream.AddDraw(gfx::IndexBufferView{}, gfx::DrawIndexedArguments{ .indexCountPerInstance = 3u, .instanceCount = 1u }, smallDrawData);
+
+		const std::array<uint32_t, 32u> largeDrawData{ 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u, 9u };
+		indirectDrawStream.AddDraw(gfx::IndexBufferView{}, gfx::DrawIndexedArguments{ .indexCountPerInstance = 3u, .instanceCount = 1u }, largeDrawData);
+
+		const std::span<const gfx::IndirectDrawArguments> arguments = indirectDrawStream.GetArguments();
+		const std::span<const std::byte> drawData = indirectDrawStream.GetDrawData();
+
+		bool areArgumentsValid = arguments.size() == 102u && drawData.size() == 102u * sizeof(IndirectDrawData);
+		for (uint32_t i = 0u; areArgumentsValid && i < 100u; ++i)
+		{
+			IndirectDrawData expectedDrawData{};
+			expectedDrawData.fill(i * 100u);
+
+			areArgumentsValid = arguments[i].indexBufferView.bufferLocation == 0x1000u * i && arguments[i].indexBufferView.sizeInBytes == 12u * i &&
+				arguments[i].indexBufferView.format == 42u && arguments[i].drawIndex == i && arguments[i].drawIndexedArguments.indexCountPerInstance == 3u * i &&
+				arguments[i].drawIndexedArguments.startIndexLocation == i && arguments[i].drawIndexedArguments.baseVertexLocation == -static_cast<int32_t>(i) &&
+				std::memcmp(drawData.data() + i * sizeof(IndirectDrawData), expectedDrawData.data(), sizeof(IndirectDrawData)) == 0;
+		}
+
+		IndirectDrawData paddedDrawData{};
+		std::memcpy(paddedDrawData.data(), drawData.data() + 100u * sizeof(IndirectDrawData), sizeof(IndirectDrawData));
+
+		IndirectDrawData truncatedDrawData{};
+		std::memcpy(truncatedDrawData.data(), drawData.data() + 101u * sizeof(IndirectDrawData), sizeof(IndirectDrawData));
+
+		if (!Expect(SUITE_NAME, areArgumentsValid, "Layout", "the arguments and draw data of each draw at its draw index") ||
+			!Expect(SUITE_NAME, paddedDrawData[0] == 7u && std::all_of(paddedDrawData.begin() + 1u, paddedDrawData.end(), [](uint32_t value) { return value == 0u; }), "Layout",
+				"smaller draw data to be zero padded") ||
+			!Expect(SUITE_NAME, std::all_of(truncatedDrawData.begin(), truncatedDrawData.end(), [](uint32_t value) { return value == 9u; }), "Layout",
+				"larger draw data to be truncated to the stride"))
+		{
+			return false;
+		}
+
+		// Clear : the stream is reused every frame, restarting the draw indices.
+		indirectDrawStream.Clear();
+		const uint32_t drawIndex = indirectDrawStream.AddDraw(gfx::IndexBufferView{}, gfx::DrawIndexedArguments{ .indexCountPerInstance = 3u, .instanceCount = 1u }, smallDrawData);
+
+		if (!Expect(SUITE_NAME, drawIndex == 0u && indirectDrawStream.GetDrawCount() == 1u && indirectDrawStream.GetDrawData().size() == sizeof(IndirectDrawData), "Clear",
+			"the draw indices to restart from 0"))
+		{
+			return false;
+		}
+	}
+
+	gfx::NullRenderBackend backend{};
+
+	const gfx::CommandHandle commandSignature = backend.CreateObject(gfx::BackendObjectType::CommandSignature, "Command Signature");
+	const gfx::CommandHandle argumentBuffer = backend.CreateObject(gfx::BackendObjectType::Buffer, "Argument Buffer");
+	const gfx::CommandHandle countBuffer = backend.CreateObject(gfx::BackendObjectType::Buffer, "Count Buffer");
+	const gfx::CommandHandle indexBuffer = backend.CreateObject(gfx::BackendObjectType::Buffer, "Index Buffer");
+
+	// State filtering : the command signature changes the root constants and index buffer, so setting them again after ExecuteIndirect is not redundant.
+	// An ExecuteIndirect without commands has no effect.
+	{
+		const gfx::SetRootConstantsCommand setRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics };
+		const std::array<uint32_t, 2u> rootConstants{ 1u, 0u };
+
+		gfx::CommandStream commandStream{};
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+		commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = indexBuffer, .sizeInBytes = 12u });
+		commandStream.Record(gfx::ExecuteIndirectCommand{ .commandSignature = commandSignature, .maxCommandCount = 0u, .argumentBuffer = argumentBuffer });
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+		commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = indexBuffer, .sizeInBytes = 12u });
+
+		const bool isEmptyExecuteIndirectFiltered = CountRecordedCommands(commandStream, gfx::CommandType::ExecuteIndirect) == 0u &&
+			CountRecordedCommands(commandStream, gfx::CommandType::SetRootConstants) == 1u && CountRecordedCommands(commandStream, gfx::CommandType::SetIndexBuffer) == 1u;
+
+		commandStream.Record(gfx::ExecuteIndirectCommand{ .commandSignature = commandSignature, .maxCommandCount = 16u, .argumentBuffer = argumentBuffer, .countBuffer = countBuffer });
+		commandStream.Record(setRootConstantsCommand, rootConstants);
+		commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = indexBuffer, .sizeInBytes = 12u });
+		commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = 3u, .instanceCount = 1u });
+
+		const bool isStateReset = CountRecordedCommands(commandStream, gfx::CommandType::ExecuteIndirect) == 1u &&
+			CountRecordedCommands(commandStream, gfx::CommandType::SetRootConstants) == 2u && CountRecordedCommands(commandStream, gfx::CommandType::SetIndexBuffer) == 2u;
+
+		const gfx::CommandStream* const commandStreams[]{ &commandStream };
+		backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+
+		if (!Expect(SUITE_NAME, isEmptyExecuteIndirectFiltered, "State filtering", "an ExecuteIndirect without commands to be filtered (leaving the state as is)") ||
+			!Expect(SUITE_NAME, isStateReset, "State filtering", "the root constants and index buffer to be set again after ExecuteIndirect") ||
+			!Expect(SUITE_NAME, backend.GetStatistics().invalidHandleCount == 0u, "Null render backend", "the ExecuteIndirect to be valid"))
+		{
+			return false;
+		}
+	}
+
+	// Recording (as Scene::RenderModelsIndirect) : the draw data buffer index is set as the first root constant before the ExecuteIndirect, and nothing is
+	// recorded without draws.
+	{
+		gfx::CommandStream commandStream{};
+		gfx::RecordIndirectDraws(commandStream, 5u, gfx::ExecuteIndirectCommand{ .commandSignature = commandSignature, .maxCommandCount = 0u, .argumentBuffer = argumentBuffer });
+
+		const bool isEmptyRecordingSkipped = commandStream.IsEmpty();
+
+		gfx::RecordIndirectDraws(commandStream, 5u, gfx::ExecuteIndirectCommand{ .commandSignature = commandSignature, .maxCommandCount = 4u, .argumentBuffer = argumentBuffer });
+
+		std::vector<gfx::CommandType> recordedCommandTypes{};
+		std::vector<uint32_t> recordedRootConstants{};
+		commandStream.ForEachCommand([&](const gfx::CommandHeader& header)
+		{
+			recordedCommandTypes.push_back(header.type);
+			if (header.type == gfx::CommandType::SetRootConstants)
+			{
+				const std::span<const uint32_t> values = gfx::CommandStream::GetRootConstants(header);
+				recordedRootConstants.assign(values.begin(), values.end());
+			}
+		});
+
+		const gfx::CommandStream* const commandStreams[]{ &commandStream };
+		backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+
+		if (!Expect(SUITE_NAME, isEmptyRecordingSkipped, "Recording", "nothing recorded without draws") ||
+			!Expect(SUITE_NAME, recordedCommandTypes == std::vector<gfx::CommandType>{ gfx::CommandType::SetRootConstants, gfx::CommandType::ExecuteIndirect } &&
+				recordedRootConstants == std::vector<uint32_t>{ 5u, 0u }, "Recording", "the draw data buffer index as root constant, then the ExecuteIndirect") ||
+			!Expect(SUITE_NAME, backend.GetStatistics().invalidHandleCount == 0u, "Null render backend", "the recorded ExecuteIndirect to be valid"))
+		{
+			return false;
+		}
+	}
+
+	// The null render backend detects a command signature / argument buffer of the wrong type.
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.Record(gfx::ExecuteIndirectCommand{ .commandSignature = argumentBuffer, .maxCommandCount = 1u, .argumentBuffer = commandSignature });
+
+		const gfx::CommandStream* const commandStreams[]{ &commandStream };
+		backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+
+		if (!Expect(SUITE_NAME, backend.GetStatistics().invalidHandleCount == 2u, "Null render backend", "2 invalid handles"))
+		{
+			return false;
+		}
+	}
+
+	for (const gfx::CommandHandle handle : { commandSignature, argumentBuffer, countBuffer, indexBuffer })
+	{
+		backend.ReleaseObject(handle);
+	}
+
+	std::printf("Indirect draws : all cases are valid\n");
+
+	return true;
+}
+
+void BenchmarkIndirectDraws()
+{
+	static constexpr uint32_t DRAW_COUNT = 10'000u;
+	static constexpr uint32_t ITERATION_COUNT = 100u;
+
+	std::vector<gfx::CommandHandle> indexBuffers(DRAW_COUNT);
+	for (uint32_t i = 0u; i < DRAW_COUNT; ++i)
+	{
+		indexBuffers[i] = 0x10000u + i;
+	}
+
+	const auto getIndexCount = [](uint32_t drawIndex) { return 3u * (64u + (drawIndex * 7919u) % 4096u); };
+
+	const auto getDrawData = [](uint32_t drawIndex)
+	{
+		IndirectDrawData drawData{};
+		for (uint32_t i = 0u; i < static_cast<uint32_t>(drawData.size()); ++i)
+		{
+			drawData[i] = drawIndex * 5u + i;
+		}
+
+		return drawData;
+	};
+
+	// Per draw recording (as Model::RenderMesh) : an index buffer, the root constants of the draw data and a draw per mesh.
+	double directTime{};
+	uint64_t directByteSize{};
+
+	for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+	{
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		gfx::CommandStream commandStream{};
+		for (uint32_t i = 0u; i < DRAW_COUNT; ++i)
+		{
+			const IndirectDrawData drawData = getDrawData(i);
+
+			commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = indexBuffers[i], .sizeInBytes = getIndexCount(i) * 4u });
+			commandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, drawData);
+			commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = getIndexCount(i), .instanceCount = 1u });
+		}
+
+		directTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		directByteSize = commandStream.GetStatistics().recordedByteSize;
+	}
+
+	// Indirect (as Scene::BuildIndirectDraws / RenderModelsIndirect) : the draws are written into the stream, copied into the (emulated) upload buffers, and
+	// submitted with a single ExecuteIndirect.
+	double indirectTime{};
+	uint64_t indirectByteSize{};
+	uint64_t uploadByteSize{};
+
+	gfx::IndirectDrawStream indirectDrawStream(static_cast<uint32_t>(sizeof(IndirectDrawData)));
+	std::vector<std::byte> uploadMemory(DRAW_COUNT * (sizeof(gfx::IndirectDrawArguments) + sizeof(IndirectDrawData)));
+
+	for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+	{
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		indirectDrawStream.Clear();
+		indirectDrawStream.Reserve(DRAW_COUNT);
+
+		for (uint32_t i = 0u; i < DRAW_COUNT; ++i)
+		{
+			indirectDrawStream.AddDraw(gfx::IndexBufferView{ .bufferLocation = indexBuffers[i], .sizeInBytes = getIndexCount(i) * 4u },
+				gfx::DrawIndexedArguments{ .indexCountPerInstance = getIndexCount(i), .instanceCount = 1u }, getDrawData(i));
+		}
+
+		const std::span<const gfx::IndirectDrawArguments> arguments = indirectDrawStream.GetArguments();
+		const std::span<const std::byte> drawData = indirectDrawStream.GetDrawData();
+
+		std::memcpy(uploadMemory.data(), arguments.data(), arguments.size_bytes());
+		std::memcpy(uploadMemory.data() + arguments.size_bytes(), drawData.data(), drawData.size_bytes());
+
+		gfx::CommandStream commandStream{};
+		gfx::RecordIndirectDraws(commandStream, 0u, gfx::ExecuteIndirectCommand{ .commandSignature = 1u, .maxCommandCount = indirectDrawStream.GetDrawCount(), .argumentBuffer = 2u });
+
+		indirectTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		indirectByteSize = commandStream.GetStatistics().recordedByteSize;
+		uploadByteSize = arguments.size_bytes() + drawData.size_bytes();
+	}
+
+	const double iterationCount = static_cast<double>(ITERATION_COUNT);
+	std::printf("Indirect draws : %u draws | per draw recording %.3f ms (%.1f KB of commands) | indirect %.3f ms (%.1f KB of commands, %.1f KB uploaded) | %.2fx\n",
+		DRAW_COUNT, directTime / iterationCount, static_cast<double>(directByteSize) / 1024.0, indirectTime / iterationCount, static_cast<double>(indirectByteSize) / 1024.0,
+		static_cast<double>(uploadByteSize) / 1024.0, directTime / std::max(indirectTime, 1e-9));
+}
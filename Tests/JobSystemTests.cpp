@@ -0,0 +1,246 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/JobSystem.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Job system";
+
+	// Schedules two child jobs per level and waits on them from within the job (so workers wait on jobs executed by other workers), returning the leaf count.
+	// Note : A waiting thread executes any queued job (including ones that wait themselves), so the stack depth grows with the number of jobs : keep the depth low.
+	uint64_t ForkJoin(core::JobSystem& jobSystem, uint32_t depth)
+	{
+		if (depth == 0u)
+		{
+			return 1u;
+		}
+
+		std::atomic<uint64_t> leafCount{};
+		core::JobCounter counter{};
+
+		for (uint32_t i = 0u; i < 2u; ++i)
+		{
+			jobSystem.Schedule([&]() { leafCount.fetch_add(ForkJoin(jobSystem, depth - 1u), std::memory_order_relaxed); }, &counter);
+		}
+
+		jobSystem.Wait(counter);
+
+		return leafCount.load(std::memory_order_relaxed);
+	}
+
+	// Work of a few microseconds, which the compiler cannot remove.
+	float ComputeWork(uint32_t index)
+	{
+		float value = static_cast<float>(index);
+		for (uint32_t i = 0u; i < 256u; ++i)
+		{
+			value = std::sqrt(value * 1.0001f + static_cast<float>(i));
+		}
+
+		return value;
+	}
+}
+
+bool VerifyJobSystem()
+{
+	// The worker counts cover a single worker (every job executed by one thread, or stolen by the waiting thread) and more workers than hardware threads.
+	for (const uint32_t workerCount : { 1u, 2u, 4u, 8u })
+	{
+		core::JobSystem jobSystem(workerCount);
+
+		// Nested fork / join : jobs waiting on jobs must not deadlock the pool, and every leaf executes exactly once.
+		if (!Expect(SUITE_NAME, ForkJoin(jobSystem, 10u) == 1024u, "Fork join", "every one of the 1024 leaves executed once"))
+		{
+			return false;
+		}
+
+		// Every index of ParallelFor is processed exactly once, for counts that are / are not multiples of the batch size.
+		for (const uint32_t count : { 0u, 1u, 255u, 256u, 257u, 100'000u })
+		{
+			std::vector<std::atomic<uint32_t>> visitCounts(count);
+			jobSystem.ParallelFor(count, 256u, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					visitCounts[i].fetch_add(1u, std::memory_order_relaxed);
+				}
+			});
+
+			if (!Expect(SUITE_NAME, std::all_of(visitCounts.begin(), visitCounts.end(), [](const std::atomic<uint32_t>& visitCount) { return visitCount.load() == 1u; }),
+				"Parallel for", "every index processed exactly once"))
+			{
+				return false;
+			}
+		}
+
+		// Dependencies : a chain of jobs where each one only starts once the previous one completed executes in order.
+		{
+			static constexpr uint32_t CHAIN_LENGTH = 200u;
+
+			std::vector<std::unique_ptr<core::JobCounter>> counters{};
+			std::vector<uint32_t> executionOrder{};
+			std::mutex executionOrderMutex{};
+
+			for (uint32_t i = 0u; i < CHAIN_LENGTH; ++i)
+			{
+				counters.push_back(std::make_unique<core::JobCounter>());
+				jobSystem.Schedule([&, i]()
+				{
+					std::lock_guard<std::mutex> lockGuard(executionOrderMutex);
+					executionOrder.push_back(i);
+				}, counters[i].get(), i > 0u ? counters[i - 1u].get() : nullptr);
+			}
+
+			jobSystem.Wait(*counters.back());
+
+			for (const std::unique_ptr<core::JobCounter>& counter : counters)
+			{
+				jobSystem.Wait(*counter);
+			}
+
+			if (!Expect(SUITE_NAME, executionOrder.size() == CHAIN_LENGTH && std::is_sorted(executionOrder.begin(), executionOrder.end()), "Dependencies",
+				"the chain of dependent jobs executed in order"))
+			{
+				return false;
+			}
+		}
+
+		// Several threads that are not workers schedule jobs and wait on futures concurrently (as the loading threads do).
+		{
+			static constexpr uint32_t PRODUCER_COUNT = 4u;
+			static constexpr uint32_t TASK_COUNT_PER_PRODUCER = 2000u;
+
+			std::atomic<bool> areResultsValid{ true };
+			std::vector<std::thread> producers{};
+
+			for (uint32_t producerIndex = 0u; producerIndex < PRODUCER_COUNT; ++producerIndex)
+			{
+				producers.emplace_back([&, producerIndex]()
+				{
+					std::vector<std::future<uint32_t>> futures{};
+					for (uint32_t i = 0u; i < TASK_COUNT_PER_PRODUCER; ++i)
+					{
+						futures.push_back(jobSystem.ScheduleTask([=]() { return producerIndex * TASK_COUNT_PER_PRODUCER + i; }));
+					}
+
+					for (uint32_t i = 0u; i < TASK_COUNT_PER_PRODUCER; ++i)
+					{
+						jobSystem.Wait(futures[i]);
+						if (futures[i].get() != producerIndex * TASK_COUNT_PER_PRODUCER + i)
+						{
+							areResultsValid.store(false);
+						}
+					}
+				});
+			}
+
+			for (std::thread& producer : producers)
+			{
+				producer.join();
+			}
+
+			if (!Expect(SUITE_NAME, areResultsValid.load(), "Concurrent producers", "the result of every task scheduled from other threads"))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Shutdown : the jobs still queued when the job system is destroyed are executed.
+	{
+		std::atomic<uint32_t> executedJobCount{};
+
+		{
+			core::JobSystem jobSystem(2u);
+			for (uint32_t i = 0u; i < 10'000u; ++i)
+			{
+				jobSystem.Schedule([&]() { executedJobCount.fetch_add(1u, std::memory_order_relaxed); });
+			}
+		}
+
+		if (!Expect(SUITE_NAME, executedJobCount.load() == 10'000u, "Shutdown", "every queued job executed before the workers exit"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Job system : all cases are valid\n");
+
+	return true;
+}
+
+void BenchmarkJobSystem()
+{
+	static constexpr uint32_t ITERATION_COUNT = 20u;
+
+	const uint32_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	std::vector<uint32_t> workerCounts{ 1u };
+	while (workerCounts.back() * 2u <= hardwareThreadCount)
+	{
+		workerCounts.push_back(workerCounts.back() * 2u);
+	}
+
+	double singleWorkerTime{};
+	for (const uint32_t workerCount : workerCounts)
+	{
+		core::JobSystem jobSystem(workerCount);
+
+		// Throughput of ParallelFor over work of a few microseconds per element.
+		static constexpr uint32_t ELEMENT_COUNT = 100'000u;
+		std::vector<float> results(ELEMENT_COUNT);
+
+		double parallelForTime{};
+		for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+		{
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			jobSystem.ParallelFor(ELEMENT_COUNT, 256u, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					results[i] = ComputeWork(i);
+				}
+			});
+			parallelForTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		}
+
+		singleWorkerTime = workerCount == 1u ? parallelForTime : singleWorkerTime;
+
+		// Overhead of scheduling : empty jobs scheduled from the main thread, which waits on them.
+		static constexpr uint32_t EMPTY_JOB_COUNT = 32'768u;
+
+		double emptyJobsTime{};
+		for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+		{
+			const auto startTime = std::chrono::high_resolution_clock::now();
+
+			core::JobCounter counter{};
+			for (uint32_t i = 0u; i < EMPTY_JOB_COUNT; ++i)
+			{
+				jobSystem.Schedule([]() {}, &counter);
+			}
+
+			jobSystem.Wait(counter);
+			emptyJobsTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		}
+
+		std::printf("Job system : %2u workers | parallel for of %u elements %.3f ms (%.2fx 1 worker) | %u empty jobs %.3f ms (%.1f ns / job)\n", workerCount,
+			ELEMENT_COUNT, parallelForTime / ITERATION_COUNT, singleWorkerTime / std::max(parallelForTime, 1e-9), EMPTY_JOB_COUNT, emptyJobsTime / ITERATION_COUNT,
+			emptyJobsTime / ITERATION_COUNT * 1e6 / EMPTY_JOB_COUNT);
+	}
+}
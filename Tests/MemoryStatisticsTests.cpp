@@ -0,0 +1,351 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Graphics/API/MemoryStatistics.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Memory statistics";
+
+	// Stands in for the MemoryAllocator (which requires a device) : allocations are placed first fit in fixed size blocks, registered in the statistics as
+	// MemoryAllocator does, and the block statistics / budgets are pushed into the statistics when a snapshot is taken (as in MemoryAllocator::GetMemoryStatistics).
+	class FakeMemoryAllocator
+	{
+	public:
+		static constexpr uint64_t BLOCK_SIZE_IN_BYTES = 64u * 1024u * 1024u;
+
+		struct Allocation
+		{
+			uint32_t blockIndex{};
+			uint64_t offset{};
+			uint64_t sizeInBytes{};
+			gfx::MemoryStatisticsHandle statisticsHandle{};
+		};
+
+		explicit FakeMemoryAllocator(uint64_t localBudgetInBytes) : mLocalBudgetInBytes(localBudgetInBytes)
+		{
+		}
+
+		std::shared_ptr<Allocation> Allocate(std::string_view name, const gfx::MemoryCategory& category, uint64_t sizeInBytes)
+		{
+			std::shared_ptr<Allocation> allocation = std::make_shared<Allocation>(Allocation
+			{
+				.sizeInBytes = sizeInBytes,
+				.statisticsHandle = mMemoryStatistics->RegisterAllocation(name, category, sizeInBytes),
+			});
+
+			for (uint32_t blockIndex = 0u; blockIndex < mBlocks.size(); ++blockIndex)
+			{
+				if (const std::optional<uint64_t> offset = FindFreeRange(mBlocks[blockIndex], sizeInBytes))
+				{
+					allocation->blockIndex = blockIndex;
+					allocation->offset = *offset;
+					mBlocks[blockIndex].push_back(allocation);
+
+					return allocation;
+				}
+			}
+
+			allocation->blockIndex = static_cast<uint32_t>(mBlocks.size());
+			mBlocks.push_back({ allocation });
+
+			return allocation;
+		}
+
+		// Releases the memory of the allocation (the statistics handle may still be held elsewhere).
+		void Free(const std::shared_ptr<Allocation>& allocation)
+		{
+			std::vector<std::shared_ptr<Allocation>>& block = mBlocks[allocation->blockIndex];
+			block.erase(std::remove(block.begin(), block.end(), allocation), block.end());
+		}
+
+		gfx::MemoryStatisticsSnapshot GetMemoryStatistics()
+		{
+			gfx::MemoryBlockStatistics blockStatistics{};
+
+			for (const std::vector<std::shared_ptr<Allocation>>& block : mBlocks)
+			{
+				std::vector<std::shared_ptr<Allocation>> sortedAllocations = block;
+				std::sort(sortedAllocations.begin(), sortedAllocations.end(), [](const auto& a, const auto& b) { return a->offset < b->offset; });
+
+				uint64_t rangeBegin{};
+				for (const std::shared_ptr<Allocation>& allocation : sortedAllocations)
+				{
+					AddUnusedRange(blockStatistics, allocation->offset - rangeBegin);
+					rangeBegin = allocation->offset + allocation->sizeInBytes;
+
+					blockStatistics.allocationCount++;
+					blockStatistics.allocationBytes += allocation->sizeInBytes;
+				}
+
+				AddUnusedRange(blockStatistics, BLOCK_SIZE_IN_BYTES - rangeBegin);
+
+				blockStatistics.blockCount++;
+				blockStatistics.blockBytes += BLOCK_SIZE_IN_BYTES;
+			}
+
+			mMemoryStatistics->SetBlockStatistics(blockStatistics);
+			mMemoryStatistics->SetBudgets({ .usageInBytes = blockStatistics.blockBytes, .budgetInBytes = mLocalBudgetInBytes }, {});
+
+			return mMemoryStatistics->GetSnapshot();
+		}
+
+		// Destroys the statistics, as when the allocator is destroyed before the last allocation.
+		void ResetMemoryStatistics()
+		{
+			mMemoryStatistics.reset();
+		}
+
+	private:
+		static std::optional<uint64_t> FindFreeRange(const std::vector<std::shared_ptr<Allocation>>& block, uint64_t sizeInBytes)
+		{
+			std::vector<std::shared_ptr<Allocation>> sortedAllocations = block;
+			std::sort(sortedAllocations.begin(), sortedAllocations.end(), [](const auto& a, const auto& b) { return a->offset < b->offset; });
+
+			uint64_t rangeBegin{};
+			for (const std::shared_ptr<Allocation>& allocation : sortedAllocations)
+			{
+				if (allocation->offset - rangeBegin >= sizeInBytes)
+				{
+					return rangeBegin;
+				}
+
+				rangeBegin = allocation->offset + allocation->sizeInBytes;
+			}
+
+			return BLOCK_SIZE_IN_BYTES - rangeBegin >= sizeInBytes ? std::optional<uint64_t>(rangeBegin) : std::nullopt;
+		}
+
+		static void AddUnusedRange(gfx::MemoryBlockStatistics& blockStatistics, uint64_t rangeSizeInBytes)
+		{
+			if (rangeSizeInBytes > 0u)
+			{
+				blockStatistics.unusedRangeCount++;
+				blockStatistics.largestUnusedRangeBytes = std::max(blockStatistics.largestUnusedRangeBytes, rangeSizeInBytes);
+			}
+		}
+
+	private:
+		std::shared_ptr<gfx::MemoryStatistics> mMemoryStatistics{ std::make_shared<gfx::MemoryStatistics>() };
+		std::vector<std::vector<std::shared_ptr<Allocation>>> mBlocks{};
+		uint64_t mLocalBudgetInBytes{};
+	};
+
+	constexpr uint64_t MB = 1024u * 1024u;
+
+	size_t ToIndex(const gfx::MemoryCategory& memoryCategory)
+	{
+		return static_cast<size_t>(memoryCategory);
+	}
+}
+
+bool VerifyMemoryStatistics()
+{
+	// Every enumerator has a name (Count is not a category).
+	{
+		bool areNamesValid = std::string(gfx::MemoryCategoryToString(gfx::MemoryCategory::Count)) == "Unknown";
+		for (size_t i = 0u; i < ToIndex(gfx::MemoryCategory::Count); ++i)
+		{
+			areNamesValid = areNamesValid && std::string(gfx::MemoryCategoryToString(static_cast<gfx::MemoryCategory>(i))) != "Unknown";
+		}
+
+		if (!Expect(SUITE_NAME, areNamesValid, "Category names", "a name for every category, and Count reported as Unknown"))
+		{
+			return false;
+		}
+	}
+
+	// Aggregation per category, totals and the order of the resources.
+	{
+		FakeMemoryAllocator allocator(256u * MB);
+
+		const auto albedo = allocator.Allocate("Albedo", gfx::MemoryCategory::Texture, 16u * MB);
+		const auto normal = allocator.Allocate("Normal", gfx::MemoryCategory::Texture, 16u * MB);
+		const auto vertices = allocator.Allocate("Vertices", gfx::MemoryCategory::Mesh, 4u * MB);
+		const auto gBuffer = allocator.Allocate("GBuffer", gfx::MemoryCategory::RenderTarget, 32u * MB);
+		const auto constants = allocator.Allocate("Constants", gfx::MemoryCategory::ConstantBuffer, 64u * 1024u);
+
+		const gfx::MemoryStatisticsSnapshot snapshot = allocator.GetMemoryStatistics();
+
+		if (!Expect(SUITE_NAME, snapshot.categorySizesInBytes[ToIndex(gfx::MemoryCategory::Texture)] == 32u * MB &&
+			snapshot.categoryAllocationCounts[ToIndex(gfx::MemoryCategory::Texture)] == 2u, "Aggregation", "2 textures of 32 MB in total") ||
+			!Expect(SUITE_NAME, snapshot.categorySizesInBytes[ToIndex(gfx::MemoryCategory::Staging)] == 0u &&
+			snapshot.categoryAllocationCounts[ToIndex(gfx::MemoryCategory::Staging)] == 0u, "Aggregation", "no staging memory") ||
+			!Expect(SUITE_NAME, snapshot.GetTotalSizeInBytes() == 68u * MB + 64u * 1024u && snapshot.GetTotalAllocationCount() == 5u, "Aggregation",
+				"totals equal to the sum of the categories") ||
+			!Expect(SUITE_NAME, snapshot.resources.size() == 5u && snapshot.resources.front().name == "GBuffer" && snapshot.resources[1].name == "Albedo" &&
+				snapshot.resources[2].name == "Normal" && snapshot.resources.back().name == "Constants", "Aggregation",
+				"the resources sorted by size (largest first), then by name"))
+		{
+			return false;
+		}
+
+		// The render target does not fit in the 28 MB left in the first block, so it is placed in a second one (and the constants in the first).
+		if (!Expect(SUITE_NAME, snapshot.blockStatistics.blockCount == 2u && snapshot.blockStatistics.allocationCount == 5u &&
+			snapshot.blockStatistics.allocationBytes == snapshot.GetTotalSizeInBytes(), "Block statistics", "the allocations of the fake allocator in 2 blocks") ||
+			!Expect(SUITE_NAME, snapshot.localBudget.usageInBytes == 2u * FakeMemoryAllocator::BLOCK_SIZE_IN_BYTES && snapshot.localBudget.budgetInBytes == 256u * MB,
+				"Budgets", "the usage and budget pushed by the allocator"))
+		{
+			return false;
+		}
+	}
+
+	// Registration lifetime : the allocation is registered until the last copy of its handle is released, and handles may outlive the statistics.
+	{
+		FakeMemoryAllocator allocator(256u * MB);
+
+		auto texture = allocator.Allocate("Texture", gfx::MemoryCategory::Texture, 8u * MB);
+		gfx::MemoryStatisticsHandle handleCopy = texture->statisticsHandle;
+
+		allocator.Free(texture);
+		texture.reset();
+
+		if (!Expect(SUITE_NAME, allocator.GetMemoryStatistics().GetTotalAllocationCount() == 1u, "Handle lifetime", "the allocation registered while a handle copy is held"))
+		{
+			return false;
+		}
+
+		handleCopy.reset();
+
+		if (!Expect(SUITE_NAME, allocator.GetMemoryStatistics().GetTotalAllocationCount() == 0u, "Handle lifetime", "the allocation unregistered with its last handle"))
+		{
+			return false;
+		}
+
+		// Releasing a handle after the statistics are destroyed must not access them.
+		const auto staticTexture = allocator.Allocate("Static Texture", gfx::MemoryCategory::Texture, 8u * MB);
+		allocator.ResetMemoryStatistics();
+		staticTexture->statisticsHandle.reset();
+	}
+
+	// Fragmentation : the freed allocations leave unused ranges between the remaining ones.
+	{
+		FakeMemoryAllocator allocator(256u * MB);
+
+		std::vector<std::shared_ptr<FakeMemoryAllocator::Allocation>> allocations{};
+		for (uint32_t i = 0u; i < 8u; ++i)
+		{
+			allocations.push_back(allocator.Allocate("Mesh " + std::to_string(i), gfx::MemoryCategory::Mesh, 8u * MB));
+		}
+
+		const gfx::MemoryStatisticsSnapshot fullSnapshot = allocator.GetMemoryStatistics();
+		if (!Expect(SUITE_NAME, fullSnapshot.blockStatistics.unusedRangeCount == 0u && fullSnapshot.blockStatistics.GetFragmentation() == 0.0, "Fragmentation",
+			"no fragmentation of a full block"))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0u; i < 8u; i += 2u)
+		{
+			allocator.Free(allocations[i]);
+			allocations[i].reset();
+		}
+
+		// 4 unused ranges of 8 MB : the largest one is a quarter of the unused memory.
+		const gfx::MemoryStatisticsSnapshot fragmentedSnapshot = allocator.GetMemoryStatistics();
+		if (!Expect(SUITE_NAME, fragmentedSnapshot.blockStatistics.unusedRangeCount == 4u && fragmentedSnapshot.blockStatistics.GetFragmentation() == 0.75, "Fragmentation",
+			"a fragmentation of 0.75 for 4 unused ranges of the same size") ||
+			!Expect(SUITE_NAME, fragmentedSnapshot.GetTotalSizeInBytes() == 32u * MB && fragmentedSnapshot.categoryAllocationCounts[ToIndex(gfx::MemoryCategory::Mesh)] == 4u,
+				"Fragmentation", "the freed meshes unregistered"))
+		{
+			return false;
+		}
+
+		// Freeing the mesh between two unused ranges merges them : the 24 MB allocation is placed at the start of the block.
+		allocator.Free(allocations[1]);
+		allocations[1].reset();
+
+		const auto largeMesh = allocator.Allocate("Large Mesh", gfx::MemoryCategory::Mesh, 24u * MB);
+		const gfx::MemoryStatisticsSnapshot reusedSnapshot = allocator.GetMemoryStatistics();
+		if (!Expect(SUITE_NAME, reusedSnapshot.blockStatistics.blockCount == 1u && reusedSnapshot.blockStatistics.unusedRangeCount == 2u &&
+			reusedSnapshot.blockStatistics.GetFragmentation() == 0.5, "Fragmentation", "the 24 MB unused range at the start of the block reused"))
+		{
+			return false;
+		}
+
+		// More allocation bytes than block bytes (inconsistent backend statistics) are not reported as negative fragmentation.
+		const gfx::MemoryBlockStatistics inconsistentStatistics{ .blockBytes = MB, .allocationBytes = 2u * MB, .unusedRangeCount = 1u, .largestUnusedRangeBytes = MB };
+		if (!Expect(SUITE_NAME, inconsistentStatistics.GetFragmentation() == 0.0, "Fragmentation", "no fragmentation without unused memory"))
+		{
+			return false;
+		}
+	}
+
+	// Concurrent registration / release (the allocator is called from the loading threads).
+	{
+		std::shared_ptr<gfx::MemoryStatistics> memoryStatistics = std::make_shared<gfx::MemoryStatistics>();
+
+		static constexpr uint32_t THREAD_COUNT = 4u;
+		static constexpr uint32_t ALLOCATION_COUNT_PER_THREAD = 1000u;
+
+		std::array<std::vector<gfx::MemoryStatisticsHandle>, THREAD_COUNT> handles{};
+		std::vector<std::thread> threads{};
+
+		for (uint32_t threadIndex = 0u; threadIndex < THREAD_COUNT; ++threadIndex)
+		{
+			threads.emplace_back([&, threadIndex]()
+			{
+				for (uint32_t i = 0u; i < ALLOCATION_COUNT_PER_THREAD; ++i)
+				{
+					handles[threadIndex].push_back(memoryStatistics->RegisterAllocation("Staging Buffer", gfx::MemoryCategory::Staging, 256u));
+
+					// Every other allocation is released right away.
+					if (i % 2u == 1u)
+					{
+						handles[threadIndex].pop_back();
+					}
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		const gfx::MemoryStatisticsSnapshot snapshot = memoryStatistics->GetSnapshot();
+		if (!Expect(SUITE_NAME, snapshot.GetTotalAllocationCount() == THREAD_COUNT * ALLOCATION_COUNT_PER_THREAD / 2u &&
+			snapshot.GetTotalSizeInBytes() == THREAD_COUNT * ALLOCATION_COUNT_PER_THREAD / 2u * 256u, "Concurrent registration", "every handle still held registered once"))
+		{
+			return false;
+		}
+	}
+
+	// Json export : escaped names, and every category listed.
+	{
+		FakeMemoryAllocator allocator(256u * MB);
+		const auto texture = allocator.Allocate("Quoted \"Texture\"\n", gfx::MemoryCategory::Texture, MB);
+
+		const std::string json = gfx::MemoryStatisticsSnapshotToJson(allocator.GetMemoryStatistics());
+
+		bool areCategoriesListed{ true };
+		for (size_t i = 0u; i < ToIndex(gfx::MemoryCategory::Count); ++i)
+		{
+			areCategoriesListed = areCategoriesListed && json.find("\"" + std::string(gfx::MemoryCategoryToString(static_cast<gfx::MemoryCategory>(i))) + "\": {") != std::string::npos;
+		}
+
+		if (!Expect(SUITE_NAME, json.find("\"Quoted \\\"Texture\\\"\\u000a\"") != std::string::npos, "Json", "the resource name escaped") ||
+			!Expect(SUITE_NAME, areCategoriesListed, "Json", "every category listed") ||
+			!Expect(SUITE_NAME, json.find("\"totalSizeInBytes\": 1048576,") != std::string::npos, "Json", "the total size"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Memory statistics : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,121 @@
+#include "TestSuites.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Graphics/API/MipMapGenerationPlan.hpp"
+
+using namespace helios;
+
+namespace
+{
+	// Relative to the working directory, as the SandBox loads its models.
+	constexpr const char* MODELS_DIRECTORY = "Assets/Models";
+
+	uint32_t ReadBigEndian(const uint8_t* bytes, uint32_t byteCount)
+	{
+		uint32_t value{};
+		for (uint32_t i = 0u; i < byteCount; ++i)
+		{
+			value = (value << 8u) | bytes[i];
+		}
+
+		return value;
+	}
+
+	// Reads the dimensions from the header of a PNG (IHDR chunk) or JPEG (first start of frame segment), without decoding the image.
+	std::optional<std::array<uint32_t, 2u>> ReadImageDimensions(const std::filesystem::path& imagePath)
+	{
+		std::ifstream file(imagePath, std::ios::binary);
+		const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		static constexpr std::array<uint8_t, 8u> PNG_SIGNATURE{ 0x89u, 'P', 'N', 'G', '\r', '\n', 0x1Au, '\n' };
+		if (bytes.size() >= 24u && std::equal(PNG_SIGNATURE.begin(), PNG_SIGNATURE.end(), bytes.begin()))
+		{
+			return std::array<uint32_t, 2u>{ ReadBigEndian(&bytes[16], 4u), ReadBigEndian(&bytes[20], 4u) };
+		}
+
+		if (bytes.size() < 4u || bytes[0] != 0xFFu || bytes[1] != 0xD8u)
+		{
+			return std::nullopt;
+		}
+
+		// Segments are a marker (0xFF, type) followed by their big endian length (which includes the length itself).
+		for (size_t offset = 2u; offset + 9u < bytes.size();)
+		{
+			if (bytes[offset] != 0xFFu)
+			{
+				return std::nullopt;
+			}
+
+			const uint8_t marker = bytes[offset + 1u];
+			const bool isStartOfFrame = marker >= 0xC0u && marker <= 0xCFu && marker != 0xC4u && marker != 0xC8u && marker != 0xCCu;
+			if (isStartOfFrame)
+			{
+				return std::array<uint32_t, 2u>{ ReadBigEndian(&bytes[offset + 7u], 2u), ReadBigEndian(&bytes[offset + 5u], 2u) };
+			}
+
+			offset += 2u + ReadBigEndian(&bytes[offset + 2u], 2u);
+		}
+
+		return std::nullopt;
+	}
+}
+
+void PrintMipMapGenerationFlushes()
+{
+	std::error_code errorCode{};
+	if (!std::filesystem::is_directory(MODELS_DIRECTORY, errorCode))
+	{
+		std::printf("Mip map generation flushes : %s not found (run from the repository root)\n", MODELS_DIRECTORY);
+		return;
+	}
+
+	std::vector<std::filesystem::path> modelDirectories{};
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(MODELS_DIRECTORY))
+	{
+		if (entry.is_directory())
+		{
+			modelDirectories.push_back(entry.path());
+		}
+	}
+
+	std::ranges::sort(modelDirectories);
+
+	// The textures of a model are the images in its directory (and sub directories) (as Model::LoadMaterials creates them, with their full mip chain, into a single batch).
+	for (const std::filesystem::path& modelDirectory : modelDirectories)
+	{
+		std::vector<gfx::MipMapGenerationTexture> textures{};
+		for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(modelDirectory))
+		{
+			if (!entry.is_regular_file())
+			{
+				continue;
+			}
+
+			if (const std::optional<std::array<uint32_t, 2u>> dimensions = ReadImageDimensions(entry.path()))
+			{
+				const auto [width, height] = *dimensions;
+				textures.push_back(gfx::MipMapGenerationTexture{ .width = width, .height = height, .mipLevels = gfx::GetFullMipChainLevelCount(width, height) });
+			}
+		}
+
+		const gfx::MipMapGenerationFlushes flushes = gfx::CountMipMapGenerationFlushes(textures);
+		if (flushes.textureCount == 0u)
+		{
+			continue;
+		}
+
+		std::printf("Mip map generation flushes : %-18s | %3u textures | %4u dispatches (%3u with the single pass downsampler) | %4u flushes per dispatch -> %u per batch "
+			"(%.1f -> %.2f per texture)\n", modelDirectory.filename().string().c_str(), flushes.textureCount, flushes.dispatchCount, flushes.singlePassDownsampleDispatchCount,
+			flushes.perDispatchFlushCount, flushes.batchFlushCount, static_cast<double>(flushes.perDispatchFlushCount) / flushes.textureCount,
+			static_cast<double>(flushes.batchFlushCount) / flushes.textureCount);
+	}
+}
@@ -0,0 +1,235 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+#include "Graphics/API/NullRenderBackend.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Null render backend";
+
+	// D3D12_RESOURCE_STATES values.
+	enum BackendState : uint32_t
+	{
+		Present = 0x0u,
+		RenderTarget = 0x4u,
+		UnorderedAccess = 0x8u,
+		ShaderResource = 0xC0u,
+	};
+
+	// Executes the barriers as is (bypassing the resource state tracking of the stream), in a single stream.
+	void ExecuteBarriers(gfx::NullRenderBackend& backend, std::initializer_list<gfx::ResourceBarrierCommand> barriers)
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.RecordResolvedBarriers(std::span<const gfx::ResourceBarrierCommand>(barriers.begin(), barriers.size()));
+
+		const std::array<const gfx::CommandStream*, 1u> commandStreams{ &commandStream };
+		backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+	}
+
+	gfx::ResourceBarrierCommand Transition(gfx::CommandHandle resource, uint32_t stateBefore, uint32_t stateAfter, uint32_t subresource = gfx::ALL_SUBRESOURCES,
+		gfx::BarrierSplit split = gfx::BarrierSplit::None)
+	{
+		return gfx::ResourceBarrierCommand
+		{
+			.barrierType = gfx::BarrierType::Transition,
+			.stateBefore = stateBefore,
+			.stateAfter = stateAfter,
+			.resource = resource,
+			.subresource = subresource,
+			.split = split,
+		};
+	}
+}
+
+bool VerifyNullRenderBackend()
+{
+	// Commands referring to live objects of the expected types are valid. Released handles, handles of the wrong object type, null handles (where not
+	// optional) and handles released twice are invalid.
+	{
+		gfx::NullRenderBackend backend{};
+
+		const std::array<gfx::CommandHandle, 2u> descriptorHeaps
+		{
+			backend.CreateObject(gfx::BackendObjectType::DescriptorHeap, "SRV_CBV_UAV Descriptor Heap"),
+			backend.CreateObject(gfx::BackendObjectType::DescriptorHeap, "Sampler Descriptor Heap"),
+		};
+
+		const gfx::CommandHandle rootSignature = backend.CreateObject(gfx::BackendObjectType::RootSignature, "Root Signature");
+		const gfx::CommandHandle pipelineState = backend.CreateObject(gfx::BackendObjectType::PipelineState, "Pipeline State");
+		const gfx::CommandHandle renderTargetView = backend.CreateObject(gfx::BackendObjectType::RenderTargetView, "Render Target View");
+		const gfx::CommandHandle indexBuffer = backend.CreateObject(gfx::BackendObjectType::Buffer, "Index Buffer");
+		const gfx::CommandHandle texture = backend.CreateObject(gfx::BackendObjectType::Texture, "Texture");
+		const gfx::CommandHandle releasedPipelineState = backend.CreateObject(gfx::BackendObjectType::PipelineState, "Released Pipeline State");
+
+		backend.ReleaseObject(releasedPipelineState);
+
+		const auto execute = [&](const auto& recordCommands)
+		{
+			gfx::CommandStream commandStream{};
+			recordCommands(commandStream);
+
+			const std::array<const gfx::CommandStream*, 1u> commandStreams{ &commandStream };
+			backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+
+			return backend.GetStatistics().invalidHandleCount;
+		};
+
+		// The depth stencil is optional.
+		const uint64_t validInvalidHandleCount = execute([&](gfx::CommandStream& commandStream)
+		{
+			commandStream.Record(gfx::SetDescriptorHeapsCommand{ .descriptorHeapCount = 2u, .descriptorHeaps = descriptorHeaps });
+			commandStream.Record(gfx::SetRootSignatureCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics, .rootSignature = rootSignature });
+			commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = pipelineState });
+			commandStream.Record(gfx::SetRenderTargetsCommand{ .renderTargetCount = 1u, .renderTargets = { renderTargetView } });
+			commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = indexBuffer, .sizeInBytes = 12u });
+			commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = 3u, .instanceCount = 1u });
+			commandStream.Record(gfx::CopyResourceCommand{ .destination = texture, .source = indexBuffer });
+		});
+
+		const uint64_t releasedInvalidHandleCount = execute([&](gfx::CommandStream& commandStream)
+		{
+			commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = releasedPipelineState });
+		});
+
+		const uint64_t wrongTypeInvalidHandleCount = execute([&](gfx::CommandStream& commandStream)
+		{
+			commandStream.Record(gfx::ClearRenderTargetCommand{ .renderTarget = texture });
+		});
+
+		const uint64_t nullInvalidHandleCount = execute([&](gfx::CommandStream& commandStream)
+		{
+			commandStream.Record(gfx::SetRootSignatureCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics });
+		});
+
+		backend.ReleaseObject(releasedPipelineState);
+		const uint64_t doubleReleaseInvalidHandleCount = backend.GetStatistics().invalidHandleCount;
+
+		for (const gfx::CommandHandle handle : { descriptorHeaps[0], descriptorHeaps[1], rootSignature, pipelineState, renderTargetView, indexBuffer, texture })
+		{
+			backend.ReleaseObject(handle);
+		}
+
+		const gfx::NullRenderBackendStatistics statistics = backend.GetStatistics();
+
+		if (!Expect(SUITE_NAME, validInvalidHandleCount == 0u, "Handles", "commands referring to live objects of the expected types to be valid") ||
+			!Expect(SUITE_NAME, releasedInvalidHandleCount == 1u, "Handles", "a released handle to be invalid") ||
+			!Expect(SUITE_NAME, wrongTypeInvalidHandleCount == 2u, "Handles", "a texture used as a render target view to be invalid") ||
+			!Expect(SUITE_NAME, nullInvalidHandleCount == 3u, "Handles", "a null root signature to be invalid") ||
+			!Expect(SUITE_NAME, doubleReleaseInvalidHandleCount == 4u && statistics.invalidHandleCount == 4u, "Handles", "a handle released twice to be invalid") ||
+			!Expect(SUITE_NAME, statistics.liveObjectCount == 0u && statistics.submissionCount == 4u, "Handles", "no live object left after 4 submissions"))
+		{
+			return false;
+		}
+	}
+
+	// Waits on fence values the signalling queue was submitted with are valid. Waits on fence values not submitted yet (which would hang the GPU) and waits
+	// recorded for another queue are invalid. Each queue has its own fence values.
+	{
+		gfx::NullRenderBackend backend{};
+
+		const gfx::CommandStream commandStream{};
+		const std::array<const gfx::CommandStream*, 1u> commandStreams{ &commandStream };
+
+		const uint64_t graphicsFenceValue = backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+
+		const std::array<gfx::QueueWait, 1u> validQueueWaits
+		{
+			gfx::QueueWait{ .waitingQueue = gfx::QueueType::Compute, .signallingQueue = gfx::QueueType::Graphics, .fenceValue = graphicsFenceValue },
+		};
+
+		const uint64_t computeFenceValue = backend.ExecuteCommandStreams(gfx::QueueType::Compute, commandStreams, validQueueWaits);
+		const uint64_t validInvalidWaitCount = backend.GetStatistics().invalidWaitCount;
+
+		const std::array<gfx::QueueWait, 2u> invalidQueueWaits
+		{
+			gfx::QueueWait{ .waitingQueue = gfx::QueueType::Compute, .signallingQueue = gfx::QueueType::Graphics, .fenceValue = graphicsFenceValue + 1u },
+			gfx::QueueWait{ .waitingQueue = gfx::QueueType::Graphics, .signallingQueue = gfx::QueueType::Copy, .fenceValue = 0u },
+		};
+
+		backend.ExecuteCommandStreams(gfx::QueueType::Compute, commandStreams, invalidQueueWaits);
+
+		const gfx::NullRenderBackendStatistics statistics = backend.GetStatistics();
+		const std::vector<gfx::RecordedSubmission> recordedSubmissions = backend.GetRecordedSubmissions();
+
+		if (!Expect(SUITE_NAME, graphicsFenceValue == 1u && computeFenceValue == 1u && backend.GetCompletedFenceValue(gfx::QueueType::Compute) == 2u &&
+				backend.GetCompletedFenceValue(gfx::QueueType::Copy) == 0u, "Waits", "fence values counted per queue, and completed on submission") ||
+			!Expect(SUITE_NAME, validInvalidWaitCount == 0u, "Waits", "a wait on a submitted fence value of another queue to be valid") ||
+			!Expect(SUITE_NAME, statistics.invalidWaitCount == 2u && statistics.queueWaitCount == 3u, "Waits",
+				"a wait on a fence value not submitted yet and a wait recorded for another queue to be invalid") ||
+			!Expect(SUITE_NAME, recordedSubmissions.size() == 3u && recordedSubmissions[2].queueWaits.size() == 2u && recordedSubmissions[2].fenceValue == 2u, "Waits",
+				"the submissions recorded with their waits and fence values"))
+		{
+			return false;
+		}
+	}
+
+	// Transitions are validated against the states the executed barriers left the (sub)resources in, across submissions.
+	{
+		gfx::NullRenderBackend backend{};
+
+		const gfx::CommandHandle texture = backend.CreateObject(gfx::BackendObjectType::Texture, "Texture");
+		const gfx::CommandHandle mipChain = backend.CreateObject(gfx::BackendObjectType::Texture, "Mip Chain");
+
+		const auto getInvalidBarrierCount = [&]() { return backend.GetStatistics().invalidBarrierCount; };
+
+		// The state of a resource is unknown until its first transition.
+		ExecuteBarriers(backend, { Transition(texture, Present, RenderTarget), Transition(texture, RenderTarget, ShaderResource) });
+		ExecuteBarriers(backend, { Transition(texture, ShaderResource, RenderTarget) });
+		const uint64_t validInvalidBarrierCount = getInvalidBarrierCount();
+
+		ExecuteBarriers(backend, { Transition(texture, ShaderResource, Present) });
+		const uint64_t wrongStateInvalidBarrierCount = getInvalidBarrierCount();
+
+		// Split transitions ended in the same stream, with the same states.
+		ExecuteBarriers(backend, { Transition(texture, Present, RenderTarget, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::Begin),
+			Transition(texture, Present, RenderTarget, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::End) });
+		const uint64_t splitInvalidBarrierCount = getInvalidBarrierCount();
+
+		ExecuteBarriers(backend, { Transition(texture, RenderTarget, ShaderResource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::Begin) });
+		const uint64_t unendedSplitInvalidBarrierCount = getInvalidBarrierCount();
+
+		ExecuteBarriers(backend, { Transition(texture, RenderTarget, ShaderResource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::End) });
+		const uint64_t unbegunSplitInvalidBarrierCount = getInvalidBarrierCount();
+
+		ExecuteBarriers(backend, { Transition(texture, RenderTarget, ShaderResource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::Begin),
+			Transition(texture, RenderTarget, Present), Transition(texture, RenderTarget, ShaderResource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::End) });
+		const uint64_t inFlightSplitInvalidBarrierCount = getInvalidBarrierCount();
+
+		// A transition of all subresources is only valid if every subresource transitioned individually is in its state before.
+		ExecuteBarriers(backend, { Transition(mipChain, Present, ShaderResource), Transition(mipChain, ShaderResource, UnorderedAccess, 1u) });
+		ExecuteBarriers(backend, { Transition(mipChain, ShaderResource, RenderTarget) });
+		const uint64_t subresourceInvalidBarrierCount = getInvalidBarrierCount();
+
+		ExecuteBarriers(backend, { Transition(mipChain, RenderTarget, ShaderResource, 1u), Transition(mipChain, RenderTarget, ShaderResource, 2u),
+			Transition(mipChain, ShaderResource, Present) });
+		const uint64_t subresourceValidInvalidBarrierCount = getInvalidBarrierCount();
+
+		backend.ReleaseObject(texture);
+		backend.ReleaseObject(mipChain);
+
+		if (!Expect(SUITE_NAME, validInvalidBarrierCount == 0u, "Barriers", "transitions from the states the previous submissions left the resource in to be valid") ||
+			!Expect(SUITE_NAME, wrongStateInvalidBarrierCount == 1u, "Barriers", "a transition from another state to be invalid") ||
+			!Expect(SUITE_NAME, splitInvalidBarrierCount == 1u, "Barriers", "a split transition ended in the same stream to be valid") ||
+			!Expect(SUITE_NAME, unendedSplitInvalidBarrierCount == 2u, "Barriers", "a split transition not ended in its stream to be invalid") ||
+			!Expect(SUITE_NAME, unbegunSplitInvalidBarrierCount == 3u, "Barriers", "the end of a split transition that was not begun to be invalid") ||
+			!Expect(SUITE_NAME, inFlightSplitInvalidBarrierCount == 4u, "Barriers", "a transition of a resource whose split transition is in flight to be invalid") ||
+			!Expect(SUITE_NAME, subresourceInvalidBarrierCount == 5u, "Barriers", "a transition of all subresources while one of them is in another state to be invalid") ||
+			!Expect(SUITE_NAME, subresourceValidInvalidBarrierCount == 5u, "Barriers", "a transition of all subresources once all of them are in its state before to be valid"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Null render backend : all cases are valid\n");
+
+	return true;
+}
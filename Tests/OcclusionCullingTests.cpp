@@ -0,0 +1,481 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Scene/FrustumCulling.hpp"
+#include "Scene/OcclusionCulling.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Occlusion culling";
+
+	struct ReferenceScreenVertex
+	{
+		double x{};
+		double y{};
+		double z{};
+	};
+
+	// Same viewport mapping as the occlusion buffer, in double precision.
+	ReferenceScreenVertex ProjectReferenceVertex(const scene::Float3& position, const scene::Matrix4x4& matrix, uint32_t width, uint32_t height)
+	{
+		std::array<double, 4> clipPosition{};
+		for (size_t column = 0u; column < 4u; ++column)
+		{
+			clipPosition[column] = static_cast<double>(position[0]) * matrix[column] + static_cast<double>(position[1]) * matrix[4u + column] +
+				static_cast<double>(position[2]) * matrix[8u + column] + matrix[12u + column];
+		}
+
+		return ReferenceScreenVertex
+		{
+			.x = (clipPosition[0] / clipPosition[3] * 0.5 + 0.5) * width,
+			.y = (0.5 - clipPosition[1] / clipPosition[3] * 0.5) * height,
+			.z = clipPosition[2] / clipPosition[3],
+		};
+	}
+
+	// Per pixel depth buffer (nearest depth at the pixel centers), for occluders entirely in front of the near plane.
+	void RenderReferenceOccluder(const scene::OccluderMesh& occluderMesh, const scene::Matrix4x4& matrix, uint32_t width, uint32_t height, std::vector<double>& depthBuffer)
+	{
+		for (size_t i = 0u; i + 2u < occluderMesh.indices.size(); i += 3u)
+		{
+			const std::array<ReferenceScreenVertex, 3u> vertices
+			{
+				ProjectReferenceVertex(occluderMesh.positions[occluderMesh.indices[i]], matrix, width, height),
+				ProjectReferenceVertex(occluderMesh.positions[occluderMesh.indices[i + 1u]], matrix, width, height),
+				ProjectReferenceVertex(occluderMesh.positions[occluderMesh.indices[i + 2u]], matrix, width, height),
+			};
+
+			const auto EdgeFunction = [](const ReferenceScreenVertex& a, const ReferenceScreenVertex& b, double x, double y)
+			{
+				return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+			};
+
+			const double area = EdgeFunction(vertices[0], vertices[1], vertices[2].x, vertices[2].y);
+			if (area == 0.0)
+			{
+				continue;
+			}
+
+			for (uint32_t y = 0u; y < height; ++y)
+			{
+				for (uint32_t x = 0u; x < width; ++x)
+				{
+					const double centerX = x + 0.5;
+					const double centerY = y + 0.5;
+
+					const double weight0 = EdgeFunction(vertices[1], vertices[2], centerX, centerY) / area;
+					const double weight1 = EdgeFunction(vertices[2], vertices[0], centerX, centerY) / area;
+					const double weight2 = EdgeFunction(vertices[0], vertices[1], centerX, centerY) / area;
+
+					if (weight0 < 0.0 || weight1 < 0.0 || weight2 < 0.0)
+					{
+						continue;
+					}
+
+					double& depth = depthBuffer[static_cast<size_t>(y) * width + x];
+					depth = std::min(depth, weight0 * vertices[0].z + weight1 * vertices[1].z + weight2 * vertices[2].z);
+				}
+			}
+		}
+	}
+
+	// A box is occluded if the depth buffer is nearer than its nearest corner over all the pixels its screen space bounds touch (as OcclusionBuffer tests it).
+	bool IsBoundingBoxOccludedReference(const scene::BoundingBox& boundingBox, const scene::Matrix4x4& matrix, uint32_t width, uint32_t height, std::span<const double> depthBuffer)
+	{
+		double minimumX = std::numeric_limits<double>::infinity();
+		double maximumX = -std::numeric_limits<double>::infinity();
+		double minimumY = std::numeric_limits<double>::infinity();
+		double maximumY = -std::numeric_limits<double>::infinity();
+		double minimumZ = std::numeric_limits<double>::infinity();
+
+		for (uint32_t i = 0u; i < 8u; ++i)
+		{
+			const scene::Float3 corner
+			{
+				(i & 1u) ? boundingBox.maximum[0] : boundingBox.minimum[0],
+				(i & 2u) ? boundingBox.maximum[1] : boundingBox.minimum[1],
+				(i & 4u) ? boundingBox.maximum[2] : boundingBox.minimum[2],
+			};
+
+			const ReferenceScreenVertex vertex = ProjectReferenceVertex(corner, matrix, width, height);
+			if (vertex.z < 0.0)
+			{
+				return false;
+			}
+
+			minimumX = std::min(minimumX, vertex.x);
+			maximumX = std::max(maximumX, vertex.x);
+			minimumY = std::min(minimumY, vertex.y);
+			maximumY = std::max(maximumY, vertex.y);
+			minimumZ = std::min(minimumZ, vertex.z);
+		}
+
+		if (maximumX <= 0.0 || minimumX >= width || maximumY <= 0.0 || minimumY >= height)
+		{
+			return false;
+		}
+
+		for (uint32_t y = static_cast<uint32_t>(std::max(std::floor(minimumY), 0.0)); y < std::min(std::ceil(maximumY), static_cast<double>(height)); ++y)
+		{
+			for (uint32_t x = static_cast<uint32_t>(std::max(std::floor(minimumX), 0.0)); x < std::min(std::ceil(maximumX), static_cast<double>(width)); ++x)
+			{
+				if (depthBuffer[static_cast<size_t>(y) * width + x] >= minimumZ)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Walls / slabs of random orientation in front of the camera (at the origin, looking down +Z), as triangle pairs and boxes.
+	std::vector<scene::OccluderMesh> CreateRandomOccluders(uint32_t count, std::mt19937& randomEngine)
+	{
+		std::uniform_real_distribution<float> positionDistribution(-20.0f, 20.0f);
+		std::uniform_real_distribution<float> depthDistribution(4.0f, 60.0f);
+		std::uniform_real_distribution<float> sizeDistribution(0.5f, 12.0f);
+
+		std::vector<scene::OccluderMesh> occluderMeshes{};
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			const scene::Float3 center{ positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.5f, depthDistribution(randomEngine) };
+
+			if (i % 2u == 0u)
+			{
+				const scene::Float3 extent{ sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine) * 0.25f };
+				occluderMeshes.push_back(scene::CreateBoxOccluderMesh(scene::BoundingBox
+				{
+					.minimum = { center[0] - extent[0], center[1] - extent[1], center[2] - extent[2] },
+					.maximum = { center[0] + extent[0], center[1] + extent[1], center[2] + extent[2] },
+				}));
+
+				continue;
+			}
+
+			// A quad whose corners are at random depths (kept in front of the near plane).
+			scene::OccluderMesh occluderMesh{ .indices = { 0u, 1u, 2u, 0u, 2u, 3u } };
+			const float sizeX = sizeDistribution(randomEngine);
+			const float sizeY = sizeDistribution(randomEngine);
+			for (const auto& [cornerX, cornerY] : { std::pair{ -1.0f, -1.0f }, std::pair{ 1.0f, -1.0f }, std::pair{ 1.0f, 1.0f }, std::pair{ -1.0f, 1.0f } })
+			{
+				occluderMesh.positions.push_back({ center[0] + cornerX * sizeX, center[1] + cornerY * sizeY, std::max(center[2] + positionDistribution(randomEngine) * 0.2f, 1.0f) });
+			}
+
+			occluderMeshes.push_back(std::move(occluderMesh));
+		}
+
+		return occluderMeshes;
+	}
+}
+
+bool VerifyOcclusionCulling()
+{
+	static constexpr uint32_t WIDTH = 320u;
+	static constexpr uint32_t HEIGHT = 192u;
+
+	const scene::Matrix4x4 viewProjectionMatrix = scene::CreatePerspectiveMatrix(0.785398f, static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+
+	// Two walls meeting at x = 0 (so the boxes behind their seam are only hidden by both masks), and a floor crossing the near plane (so it is clipped).
+	const std::array<scene::OccluderMesh, 3u> occluderMeshes
+	{
+		scene::CreateBoxOccluderMesh(scene::BoundingBox{ .minimum = { -5.0f, -5.0f, 10.0f }, .maximum = { 0.0f, 5.0f, 10.5f } }),
+		scene::CreateBoxOccluderMesh(scene::BoundingBox{ .minimum = { 0.0f, -5.0f, 10.0f }, .maximum = { 5.0f, 5.0f, 10.5f } }),
+		scene::CreateBoxOccluderMesh(scene::BoundingBox{ .minimum = { -50.0f, -2.0f, -10.0f }, .maximum = { 50.0f, -1.0f, 60.0f } }),
+	};
+
+	// Hand written cases, for boxes of half extent 0.5, with the expected occlusion.
+	struct OcclusionCase
+	{
+		const char* name{};
+		scene::Float3 center{};
+		bool isOccluded{};
+	};
+
+	static constexpr std::array<OcclusionCase, 8u> OCCLUSION_CASES
+	{
+		OcclusionCase{ "Behind a wall", { 2.0f, 0.0f, 20.0f }, true },
+		OcclusionCase{ "Behind the seam of the walls", { 0.0f, 1.0f, 20.0f }, true },
+		OcclusionCase{ "Below the floor", { -12.0f, -4.0f, 20.0f }, true },
+		OcclusionCase{ "In front of the walls", { 0.0f, 0.0f, 5.0f }, false },
+		OcclusionCase{ "Partially behind a wall", { 9.8f, 0.0f, 20.0f }, false },
+		OcclusionCase{ "Beside the walls", { 12.0f, 0.0f, 20.0f }, false },
+		OcclusionCase{ "Straddling the near plane", { 0.0f, 0.0f, 0.0f }, false },
+		OcclusionCase{ "Behind the camera", { 0.0f, 0.0f, -20.0f }, false },
+	};
+
+	for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+	{
+		if (!scene::IsCullingImplementationSupported(cullingImplementation))
+		{
+			continue;
+		}
+
+		scene::OcclusionBuffer occlusionBuffer{};
+		occlusionBuffer.Resize(WIDTH, HEIGHT);
+
+		for (const scene::OccluderMesh& occluderMesh : occluderMeshes)
+		{
+			occlusionBuffer.RenderOccluder(occluderMesh.positions, occluderMesh.indices, viewProjectionMatrix, cullingImplementation);
+		}
+
+		for (const OcclusionCase& occlusionCase : OCCLUSION_CASES)
+		{
+			const scene::Float3& center = occlusionCase.center;
+			const scene::BoundingBox boundingBox{ .minimum = { center[0] - 0.5f, center[1] - 0.5f, center[2] - 0.5f }, .maximum = { center[0] + 0.5f, center[1] + 0.5f, center[2] + 0.5f } };
+
+			if (!Expect(SUITE_NAME, occlusionBuffer.IsBoundingBoxOccluded(boundingBox, viewProjectionMatrix, cullingImplementation) == occlusionCase.isOccluded, occlusionCase.name,
+				occlusionCase.isOccluded ? "the box to be occluded" : "the box to be visible"))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Random scenes : the SIMD implementations must rasterize the exact same buffer and cull the exact same boxes as the scalar one, and every pixel bound
+	// and culled box must be conservative compared to a per pixel depth buffer.
+	std::mt19937 randomEngine(42u);
+
+	uint32_t referenceOccludedCount{};
+	uint32_t occludedCount{};
+
+	for (uint32_t sceneIndex = 0u; sceneIndex < 16u; ++sceneIndex)
+	{
+		const std::vector<scene::OccluderMesh> randomOccluderMeshes = CreateRandomOccluders(4u + sceneIndex * 4u, randomEngine);
+
+		std::uniform_real_distribution<float> positionDistribution(-30.0f, 30.0f);
+		std::uniform_real_distribution<float> depthDistribution(2.0f, 100.0f);
+		std::uniform_real_distribution<float> sizeDistribution(0.05f, 3.0f);
+
+		scene::BoundingBoxSoA boundingBoxes{};
+		boundingBoxes.Resize(2000u);
+		for (uint32_t i = 0u; i < boundingBoxes.GetCount(); ++i)
+		{
+			const scene::Float3 center{ positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.5f, depthDistribution(randomEngine) };
+			const scene::Float3 extent{ sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine) };
+
+			boundingBoxes.Set(i, scene::BoundingBox
+			{
+				.minimum = { center[0] - extent[0], center[1] - extent[1], center[2] - extent[2] },
+				.maximum = { center[0] + extent[0], center[1] + extent[1], center[2] + extent[2] },
+			});
+		}
+
+		std::vector<double> referenceDepthBuffer(static_cast<size_t>(WIDTH) * HEIGHT, 1.0);
+		for (const scene::OccluderMesh& occluderMesh : randomOccluderMeshes)
+		{
+			RenderReferenceOccluder(occluderMesh, viewProjectionMatrix, WIDTH, HEIGHT, referenceDepthBuffer);
+		}
+
+		std::optional<scene::OcclusionBuffer> scalarOcclusionBuffer{};
+		std::vector<uint8_t> scalarVisibility{};
+
+		for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+		{
+			if (!scene::IsCullingImplementationSupported(cullingImplementation))
+			{
+				continue;
+			}
+
+			scene::OcclusionBuffer occlusionBuffer{};
+			occlusionBuffer.Resize(WIDTH, HEIGHT);
+
+			for (const scene::OccluderMesh& occluderMesh : randomOccluderMeshes)
+			{
+				occlusionBuffer.RenderOccluder(occluderMesh.positions, occluderMesh.indices, viewProjectionMatrix, cullingImplementation);
+			}
+
+			std::vector<uint8_t> visibility(boundingBoxes.GetCount(), 1u);
+			const uint32_t culledCount = occlusionBuffer.CullBoundingBoxes(boundingBoxes, viewProjectionMatrix, visibility, cullingImplementation);
+
+			const char* caseName = scene::CullingImplementationToString(cullingImplementation);
+
+			if (!scalarOcclusionBuffer.has_value())
+			{
+				// The depth bounds may round differently than the reference (which interpolates the depth in double precision).
+				for (uint32_t y = 0u; y < HEIGHT; ++y)
+				{
+					for (uint32_t x = 0u; x < WIDTH; ++x)
+					{
+						if (!Expect(SUITE_NAME, occlusionBuffer.GetPixelDepthBound(x, y) >= referenceDepthBuffer[static_cast<size_t>(y) * WIDTH + x] - 1e-6, caseName,
+							"the depth bound of every pixel to be behind the depth buffer"))
+						{
+							return false;
+						}
+					}
+				}
+
+				for (uint32_t i = 0u; i < boundingBoxes.GetCount(); ++i)
+				{
+					const bool isReferenceOccluded = IsBoundingBoxOccludedReference(boundingBoxes.Get(i), viewProjectionMatrix, WIDTH, HEIGHT, referenceDepthBuffer);
+					if (!Expect(SUITE_NAME, visibility[i] != 0u || isReferenceOccluded, caseName, "the culled boxes to be occluded in the depth buffer"))
+					{
+						return false;
+					}
+
+					referenceOccludedCount += isReferenceOccluded ? 1u : 0u;
+				}
+
+				occludedCount += culledCount;
+				scalarOcclusionBuffer = std::move(occlusionBuffer);
+				scalarVisibility = std::move(visibility);
+
+				continue;
+			}
+
+			bool isBufferEqual{ true };
+			for (uint32_t y = 0u; y < HEIGHT; ++y)
+			{
+				for (uint32_t x = 0u; x < WIDTH; ++x)
+				{
+					isBufferEqual &= occlusionBuffer.GetPixelDepthBound(x, y) == scalarOcclusionBuffer->GetPixelDepthBound(x, y);
+				}
+			}
+
+			if (!Expect(SUITE_NAME, isBufferEqual, caseName, "the same buffer as the scalar implementation") ||
+				!Expect(SUITE_NAME, visibility == scalarVisibility, caseName, "the same visibility as the scalar implementation"))
+			{
+				return false;
+			}
+		}
+	}
+
+	std::printf("Occlusion culling : all cases are valid (%u of the %u boxes occluded in the per pixel depth buffer are culled, %s used by default)\n", occludedCount,
+		referenceOccludedCount, scene::CullingImplementationToString(scene::ResolveCullingImplementation(scene::CullingImplementation::Best)));
+
+	return true;
+}
+
+void BenchmarkOcclusionCulling()
+{
+	static constexpr uint32_t PROP_COUNT = 20'000u;
+	static constexpr uint32_t FRAME_COUNT = 240u;
+	static constexpr float HALF_LENGTH = 40.0f;
+	static constexpr float PI = 3.14159265f;
+
+	// An interior in the layout of Sponza : a nave along X, between two arcades of pillars (with an architrave and a gallery of pillars above them), side
+	// aisles with a gallery floor, and outer / end walls. The occluders are the bounds of the walls / pillars / floors.
+	std::vector<scene::OccluderMesh> occluderMeshes{};
+	const auto AddOccluder = [&](const scene::Float3& minimum, const scene::Float3& maximum)
+	{
+		occluderMeshes.push_back(scene::CreateBoxOccluderMesh(scene::BoundingBox{ .minimum = minimum, .maximum = maximum }));
+	};
+
+	for (const float side : { -1.0f, 1.0f })
+	{
+		for (float x = -HALF_LENGTH + 4.0f; x < HALF_LENGTH; x += 8.0f)
+		{
+			AddOccluder({ x - 0.75f, 0.0f, side * 8.0f - 0.75f }, { x + 0.75f, 8.0f, side * 8.0f + 0.75f });
+			AddOccluder({ x - 0.5f, 10.0f, side * 8.0f - 0.5f }, { x + 0.5f, 16.0f, side * 8.0f + 0.5f });
+		}
+
+		AddOccluder({ -HALF_LENGTH, 8.0f, side * 8.0f - 0.75f }, { HALF_LENGTH, 10.0f, side * 8.0f + 0.75f });
+		AddOccluder({ -HALF_LENGTH, 8.0f, std::min(side * 8.0f, side * 16.0f) }, { HALF_LENGTH, 8.5f, std::max(side * 8.0f, side * 16.0f) });
+		AddOccluder({ -HALF_LENGTH, 0.0f, side * 16.0f - 0.5f }, { HALF_LENGTH, 18.0f, side * 16.0f + 0.5f });
+		AddOccluder({ side * HALF_LENGTH - 0.5f, 0.0f, -16.0f }, { side * HALF_LENGTH + 0.5f, 18.0f, 16.0f });
+	}
+
+	// Props (the occludees) scattered in the nave, the aisles and the galleries.
+	std::mt19937 randomEngine(42u);
+	std::uniform_real_distribution<float> positionXDistribution(-HALF_LENGTH, HALF_LENGTH);
+	std::uniform_real_distribution<float> positionYDistribution(0.0f, 16.0f);
+	std::uniform_real_distribution<float> positionZDistribution(-15.5f, 15.5f);
+	std::uniform_real_distribution<float> sizeDistribution(0.1f, 0.75f);
+
+	scene::BoundingBoxSoA boundingBoxes{};
+	boundingBoxes.Resize(PROP_COUNT);
+	for (uint32_t i = 0u; i < PROP_COUNT; ++i)
+	{
+		const scene::Float3 center{ positionXDistribution(randomEngine), positionYDistribution(randomEngine), positionZDistribution(randomEngine) };
+		const float extent = sizeDistribution(randomEngine);
+
+		boundingBoxes.Set(i, scene::BoundingBox
+		{
+			.minimum = { center[0] - extent, center[1] - extent, center[2] - extent },
+			.maximum = { center[0] + extent, center[1] + extent, center[2] + extent },
+		});
+	}
+
+	// Camera paths, as functions of the path progress in [0, 1] returning the position and yaw.
+	struct CameraPath
+	{
+		const char* name{};
+		std::function<std::pair<scene::Float3, float>(float)> cameraFunction{};
+	};
+
+	const std::array<CameraPath, 4u> cameraPaths
+	{
+		CameraPath{ "nave walk", [](float t) { return std::pair{ scene::Float3{ -36.0f + 72.0f * t, 2.0f, 3.0f * std::sin(t * 2.0f * PI) }, PI * 0.5f + 0.4f * std::sin(t * 6.0f * PI) }; } },
+		CameraPath{ "nave pan", [](float t) { return std::pair{ scene::Float3{ 0.0f, 2.0f, 0.0f }, t * 2.0f * PI }; } },
+		CameraPath{ "aisle walk", [](float t) { return std::pair{ scene::Float3{ 36.0f - 72.0f * t, 2.0f, 12.0f }, -PI * 0.5f + 0.6f * std::sin(t * 4.0f * PI) }; } },
+		CameraPath{ "gallery", [](float t) { return std::pair{ scene::Float3{ -36.0f + 72.0f * t, 11.0f, -12.0f }, PI * 0.25f + 0.5f * std::sin(t * 2.0f * PI) }; } },
+	};
+
+	const scene::Matrix4x4 projectionMatrix = scene::CreatePerspectiveMatrix(1.047198f, 16.0f / 9.0f, 0.1f, 1000.0f);
+
+	std::vector<uint8_t> visibility(PROP_COUNT);
+
+	for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+	{
+		if (!scene::IsCullingImplementationSupported(cullingImplementation))
+		{
+			continue;
+		}
+
+		scene::OcclusionBuffer occlusionBuffer{};
+		occlusionBuffer.Resize(320u, 192u);
+
+		for (const CameraPath& cameraPath : cameraPaths)
+		{
+			uint64_t frustumVisibleCount{};
+			uint64_t occludedCount{};
+			uint64_t occluderTriangleCount{};
+			double renderTime{};
+			double testTime{};
+
+			for (uint32_t frame = 0u; frame < FRAME_COUNT; ++frame)
+			{
+				const auto [position, yaw] = cameraPath.cameraFunction(static_cast<float>(frame) / static_cast<float>(FRAME_COUNT - 1u));
+				const scene::Matrix4x4 viewProjectionMatrix = scene::MultiplyMatrices(CreateWalkthroughViewMatrix(position, yaw), projectionMatrix);
+
+				frustumVisibleCount += scene::CullBoundingBoxes(scene::ExtractFrustum(viewProjectionMatrix), boundingBoxes, visibility, cullingImplementation);
+
+				const auto renderStartTime = std::chrono::high_resolution_clock::now();
+				occlusionBuffer.Clear();
+				for (const scene::OccluderMesh& occluderMesh : occluderMeshes)
+				{
+					occluderTriangleCount += occlusionBuffer.RenderOccluder(occluderMesh.positions, occluderMesh.indices, viewProjectionMatrix, cullingImplementation);
+				}
+
+				const auto testStartTime = std::chrono::high_resolution_clock::now();
+				occludedCount += occlusionBuffer.CullBoundingBoxes(boundingBoxes, viewProjectionMatrix, visibility, cullingImplementation);
+				const auto testEndTime = std::chrono::high_resolution_clock::now();
+
+				renderTime += std::chrono::duration<double, std::milli>(testStartTime - renderStartTime).count();
+				testTime += std::chrono::duration<double, std::milli>(testEndTime - testStartTime).count();
+			}
+
+			const double frameCount = static_cast<double>(FRAME_COUNT);
+			std::printf("Occlusion culling : %-6s %-10s | %u props | %7.1f in the frustum | %7.1f occluded (%5.1f%%) | %6.1f occluder triangles | render %.3f ms | test %.3f ms\n",
+				scene::CullingImplementationToString(cullingImplementation), cameraPath.name, PROP_COUNT, frustumVisibleCount / frameCount, occludedCount / frameCount,
+				100.0 * static_cast<double>(occludedCount) / static_cast<double>(std::max<uint64_t>(frustumVisibleCount, 1u)), occluderTriangleCount / frameCount,
+				renderTime / frameCount, testTime / frameCount);
+		}
+	}
+}
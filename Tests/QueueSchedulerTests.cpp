@@ -0,0 +1,211 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "Graphics/API/QueueScheduler.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Queue scheduler";
+
+	using FenceValues = gfx::QueueScheduler::FenceValues;
+
+	// Simulates the graphics, compute and copy queues : each submission performs its waits and signals the next fence value of its queue.
+	// The fence values of the other queues reached before each signal (i.e what the GPU guarantees) are recorded, independently of the scheduler.
+	struct SimulatedQueues
+	{
+		gfx::QueueScheduler queueScheduler{};
+
+		// Indexed by the queue type.
+		std::array<FenceValues, gfx::QUEUE_TYPE_COUNT> reachedFenceValues{};
+		std::array<std::vector<FenceValues>, gfx::QUEUE_TYPE_COUNT> signalledReachedFenceValues{};
+		FenceValues completedFenceValues{};
+
+		bool isWaitRedundant{ false };
+		bool isDependencyUnsatisfied{ false };
+
+		std::vector<gfx::QueueWait> Submit(gfx::QueueType queueType, std::span<const gfx::QueueSubmission> dependencies)
+		{
+			const uint32_t queueIndex = static_cast<uint32_t>(queueType);
+			FenceValues& queueReachedFenceValues = reachedFenceValues[queueIndex];
+
+			const std::vector<gfx::QueueWait> queueWaits = queueScheduler.ResolveDependencies(queueType, dependencies);
+			for (const gfx::QueueWait& queueWait : queueWaits)
+			{
+				const uint32_t signallingQueueIndex = static_cast<uint32_t>(queueWait.signallingQueue);
+
+				// A wait on a fence value the queue already reached (or that completed) is redundant.
+				isWaitRedundant = isWaitRedundant || queueWait.fenceValue <= std::max(queueReachedFenceValues[signallingQueueIndex], completedFenceValues[signallingQueueIndex]);
+
+				const FenceValues& signalReachedFenceValues = signalledReachedFenceValues[signallingQueueIndex][queueWait.fenceValue - 1u];
+				for (uint32_t i = 0u; i < gfx::QUEUE_TYPE_COUNT; ++i)
+				{
+					queueReachedFenceValues[i] = std::max(queueReachedFenceValues[i], signalReachedFenceValues[i]);
+				}
+			}
+
+			for (const gfx::QueueSubmission& dependency : dependencies)
+			{
+				const uint32_t signallingQueueIndex = static_cast<uint32_t>(dependency.queueType);
+				isDependencyUnsatisfied = isDependencyUnsatisfied ||
+					(dependency.queueType != queueType && dependency.fenceValue > std::max(queueReachedFenceValues[signallingQueueIndex], completedFenceValues[signallingQueueIndex]));
+			}
+
+			queueReachedFenceValues[queueIndex]++;
+			signalledReachedFenceValues[queueIndex].push_back(queueReachedFenceValues);
+			queueScheduler.RecordSignal(queueType, queueReachedFenceValues[queueIndex]);
+
+			return queueWaits;
+		}
+
+		gfx::QueueSubmission GetLastSubmission(gfx::QueueType queueType) const
+		{
+			return gfx::QueueSubmission{ .queueType = queueType, .fenceValue = reachedFenceValues[static_cast<uint32_t>(queueType)][static_cast<uint32_t>(queueType)] };
+		}
+
+		void Complete(const FenceValues& fenceValues)
+		{
+			completedFenceValues = fenceValues;
+			queueScheduler.SetCompletedFenceValues(completedFenceValues);
+		}
+	};
+}
+
+bool VerifyQueueScheduler()
+{
+	// Dependencies on the same queue, and default constructed dependencies, never require a wait.
+	{
+		SimulatedQueues simulatedQueues{};
+		simulatedQueues.Submit(gfx::QueueType::Graphics, {});
+
+		const std::array<gfx::QueueSubmission, 2u> dependencies{ simulatedQueues.GetLastSubmission(gfx::QueueType::Graphics), gfx::QueueSubmission{} };
+		if (!Expect(SUITE_NAME, simulatedQueues.Submit(gfx::QueueType::Graphics, dependencies).empty(), "Same queue", "no wait"))
+		{
+			return false;
+		}
+	}
+
+	// Cross queue dependency : the graphics queue waits once on the compute submission, and later dependencies on it are already satisfied.
+	{
+		SimulatedQueues simulatedQueues{};
+		simulatedQueues.Submit(gfx::QueueType::Compute, {});
+
+		const std::array<gfx::QueueSubmission, 2u> dependencies{ simulatedQueues.GetLastSubmission(gfx::QueueType::Compute), simulatedQueues.GetLastSubmission(gfx::QueueType::Compute) };
+		const std::vector<gfx::QueueWait> queueWaits = simulatedQueues.Submit(gfx::QueueType::Graphics, dependencies);
+		const std::vector<gfx::QueueWait> laterQueueWaits = simulatedQueues.Submit(gfx::QueueType::Graphics, dependencies);
+
+		const gfx::QueueSchedulerStatistics statistics = simulatedQueues.queueScheduler.GetStatistics();
+		if (!Expect(SUITE_NAME, queueWaits.size() == 1u && queueWaits[0].waitingQueue == gfx::QueueType::Graphics && queueWaits[0].signallingQueue == gfx::QueueType::Compute &&
+			queueWaits[0].fenceValue == 1u, "Cross queue", "the graphics queue waiting on the compute fence value 1") ||
+			!Expect(SUITE_NAME, laterQueueWaits.empty(), "Cross queue", "no wait for a dependency already waited on") ||
+			!Expect(SUITE_NAME, statistics.waitCount == 1u && statistics.skippedWaitCount == 3u && statistics.submissionCount == 3u, "Cross queue",
+				"1 wait, and 3 skipped (the duplicated dependency, and both of the later submission)"))
+		{
+			return false;
+		}
+	}
+
+	// Transitive dependency : the compute queue waited on the copy queue before signalling, so waiting on compute implies the copy dependency.
+	{
+		SimulatedQueues simulatedQueues{};
+		simulatedQueues.Submit(gfx::QueueType::Copy, {});
+
+		const gfx::QueueSubmission copySubmission = simulatedQueues.GetLastSubmission(gfx::QueueType::Copy);
+		simulatedQueues.Submit(gfx::QueueType::Compute, { &copySubmission, 1u });
+
+		const std::array<gfx::QueueSubmission, 2u> dependencies{ copySubmission, simulatedQueues.GetLastSubmission(gfx::QueueType::Compute) };
+		const std::vector<gfx::QueueWait> queueWaits = simulatedQueues.Submit(gfx::QueueType::Graphics, dependencies);
+		const std::vector<gfx::QueueWait> laterQueueWaits = simulatedQueues.Submit(gfx::QueueType::Graphics, { &copySubmission, 1u });
+
+		if (!Expect(SUITE_NAME, queueWaits.size() == 1u && queueWaits[0].signallingQueue == gfx::QueueType::Compute, "Transitive", "a single wait, on the compute queue") ||
+			!Expect(SUITE_NAME, laterQueueWaits.empty(), "Transitive", "the copy dependency known to be satisfied afterwards") ||
+			!Expect(SUITE_NAME, !simulatedQueues.isDependencyUnsatisfied, "Transitive", "every dependency satisfied"))
+		{
+			return false;
+		}
+	}
+
+	// Completed fence values : dependencies on work the GPU already completed are skipped.
+	{
+		SimulatedQueues simulatedQueues{};
+		simulatedQueues.Submit(gfx::QueueType::Copy, {});
+		simulatedQueues.Submit(gfx::QueueType::Copy, {});
+
+		const gfx::QueueSubmission copySubmission = simulatedQueues.GetLastSubmission(gfx::QueueType::Copy);
+		simulatedQueues.Complete(FenceValues{ 0u, 0u, copySubmission.fenceValue });
+
+		if (!Expect(SUITE_NAME, simulatedQueues.Submit(gfx::QueueType::Graphics, { &copySubmission, 1u }).empty(), "Completed", "no wait on a completed fence value") ||
+			!Expect(SUITE_NAME, simulatedQueues.queueScheduler.GetStatistics().skippedWaitCount == 1u, "Completed", "the dependency counted as skipped"))
+		{
+			return false;
+		}
+	}
+
+	// Random frames of async compute and uploads : every dependency is satisfied by the waits (checked against the simulated queues rather than the scheduler's
+	// own bookkeeping), no wait is redundant, and fewer waits are performed than with a wait per cross queue dependency.
+	{
+		SimulatedQueues simulatedQueues{};
+		std::mt19937 randomEngine(11u);
+
+		static constexpr uint32_t SUBMISSION_COUNT = 5000u;
+		uint64_t crossQueueDependencyCount{};
+
+		for (uint32_t submissionIndex = 0u; submissionIndex < SUBMISSION_COUNT; ++submissionIndex)
+		{
+			const gfx::QueueType queueType = static_cast<gfx::QueueType>(randomEngine() % gfx::QUEUE_TYPE_COUNT);
+
+			std::vector<gfx::QueueSubmission> dependencies(randomEngine() % 4u);
+			for (gfx::QueueSubmission& dependency : dependencies)
+			{
+				// One of the last few submissions of a random queue (or none, if the queue has not submitted yet).
+				dependency.queueType = static_cast<gfx::QueueType>(randomEngine() % gfx::QUEUE_TYPE_COUNT);
+
+				const uint64_t lastFenceValue = simulatedQueues.GetLastSubmission(dependency.queueType).fenceValue;
+				dependency.fenceValue = lastFenceValue - std::min<uint64_t>(lastFenceValue, randomEngine() % 4u);
+
+				crossQueueDependencyCount += dependency.queueType != queueType && dependency.fenceValue != 0u ? 1u : 0u;
+			}
+
+			simulatedQueues.Submit(queueType, dependencies);
+
+			// The GPU completes the work of a few submissions back from time to time.
+			if (submissionIndex % 16u == 15u)
+			{
+				FenceValues completedFenceValues{};
+				for (uint32_t queueIndex = 0u; queueIndex < gfx::QUEUE_TYPE_COUNT; ++queueIndex)
+				{
+					const uint64_t lastFenceValue = simulatedQueues.reachedFenceValues[queueIndex][queueIndex];
+					completedFenceValues[queueIndex] = std::max(simulatedQueues.completedFenceValues[queueIndex], lastFenceValue - std::min<uint64_t>(lastFenceValue, 3u));
+				}
+
+				simulatedQueues.Complete(completedFenceValues);
+			}
+		}
+
+		const gfx::QueueSchedulerStatistics statistics = simulatedQueues.queueScheduler.GetStatistics();
+		std::printf("Queue scheduler : %u submissions | %llu cross queue dependencies | %llu waits | %llu skipped\n", SUBMISSION_COUNT,
+			static_cast<unsigned long long>(crossQueueDependencyCount), static_cast<unsigned long long>(statistics.waitCount),
+			static_cast<unsigned long long>(statistics.skippedWaitCount));
+
+		if (!Expect(SUITE_NAME, !simulatedQueues.isDependencyUnsatisfied, "Random submissions", "every dependency satisfied by the waits") ||
+			!Expect(SUITE_NAME, !simulatedQueues.isWaitRedundant, "Random submissions", "no wait on a fence value already reached") ||
+			!Expect(SUITE_NAME, statistics.waitCount + statistics.skippedWaitCount == crossQueueDependencyCount && statistics.waitCount < crossQueueDependencyCount,
+				"Random submissions", "every cross queue dependency either waited on or skipped, and some skipped"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Queue scheduler : all cases are valid\n");
+
+	return true;
+}
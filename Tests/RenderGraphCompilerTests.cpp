@@ -0,0 +1,405 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Graphics/API/RenderGraphCompiler.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Render graph compiler";
+
+	using RenderGraphState = gfx::RenderGraphResourceState;
+
+	// Compiles the graph and validates the result, printing the reason of a failure.
+	bool CompileAndValidate(const char* caseName, const gfx::RenderGraphDesc& renderGraphDesc, const gfx::RenderGraphCompileOptions& compileOptions, gfx::CompiledRenderGraph& compiledRenderGraph)
+	{
+		compiledRenderGraph = gfx::CompileRenderGraph(renderGraphDesc, compileOptions);
+
+		std::string error{};
+		if (!gfx::ValidateCompiledRenderGraph(renderGraphDesc, compiledRenderGraph, &error))
+		{
+			std::printf("Render graph compiler : %s : %s\n%s", caseName, error.c_str(), gfx::GenerateRenderGraphReport(renderGraphDesc, compiledRenderGraph).c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	uint32_t CountBarriers(const gfx::CompiledRenderGraph& compiledRenderGraph, uint32_t resourceIndex, gfx::RenderGraphBarrierType barrierType)
+	{
+		uint32_t barrierCount{};
+		for (const gfx::CompiledRenderGraphPass& pass : compiledRenderGraph.passes)
+		{
+			for (const std::vector<gfx::RenderGraphBarrier>* barriers : { &pass.beginBarriers, &pass.endBarriers })
+			{
+				barrierCount += static_cast<uint32_t>(std::count_if(barriers->begin(), barriers->end(), [&](const gfx::RenderGraphBarrier& barrier)
+				{
+					return barrier.resourceIndex == resourceIndex && barrier.barrierType == barrierType;
+				}));
+			}
+		}
+
+		return barrierCount;
+	}
+
+	// The frame of the SandBox : shadow, deferred geometry, lighting (the lights / sky box are depth tested against a read only view of its depth), post processing,
+	// final (with the editor) and the copy to the back buffer. Resources start and end in the states they rest in between frames.
+	gfx::RenderGraphDesc CreateSandBoxRenderGraph()
+	{
+		gfx::RenderGraphDesc renderGraphDesc{};
+
+		const auto AddResource = [&](const char* name, RenderGraphState restState, bool isOutput = false)
+		{
+			return renderGraphDesc.AddResource(gfx::RenderGraphResourceDesc{ .name = name, .initialState = restState, .finalState = restState, .isOutput = isOutput });
+		};
+
+		const uint32_t shadowDepth = AddResource("ShadowDepth", RenderGraphState::PixelShaderResource);
+		const std::array<uint32_t, 4u> gBuffer
+		{
+			AddResource("Albedo", RenderGraphState::PixelShaderResource),
+			AddResource("PositionEmissive", RenderGraphState::PixelShaderResource),
+			AddResource("NormalEmissive", RenderGraphState::PixelShaderResource),
+			AddResource("AoMetalRoughnessEmissive", RenderGraphState::PixelShaderResource),
+		};
+		const uint32_t depth = AddResource("Depth", RenderGraphState::DepthWrite);
+		const uint32_t offscreen = AddResource("Offscreen", RenderGraphState::PixelShaderResource);
+		const uint32_t postProcess = AddResource("PostProcess", RenderGraphState::PixelShaderResource);
+		const uint32_t final = AddResource("Final", RenderGraphState::CopySource);
+		const uint32_t backBuffer = AddResource("BackBuffer", RenderGraphState::Present, true);
+
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Shadow" }.Write(shadowDepth, RenderGraphState::DepthWrite));
+
+		gfx::RenderGraphPassDesc deferredGeometryPassDesc{ .name = "DeferredGeometry" };
+		for (const uint32_t gBufferResource : gBuffer)
+		{
+			deferredGeometryPassDesc.Write(gBufferResource, RenderGraphState::RenderTarget);
+		}
+		renderGraphDesc.AddPass(deferredGeometryPassDesc.Write(depth, RenderGraphState::DepthWrite));
+
+		gfx::RenderGraphPassDesc lightingPassDesc{ .name = "Lighting" };
+		for (const uint32_t gBufferResource : gBuffer)
+		{
+			lightingPassDesc.Read(gBufferResource, RenderGraphState::PixelShaderResource);
+		}
+		renderGraphDesc.AddPass(lightingPassDesc.Read(shadowDepth, RenderGraphState::PixelShaderResource).Read(depth, RenderGraphState::DepthRead)
+			.Write(offscreen, RenderGraphState::RenderTarget));
+
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "PostProcess" }.Read(offscreen, RenderGraphState::PixelShaderResource)
+			.Write(postProcess, RenderGraphState::RenderTarget));
+
+		// The editor displays the shadow map and the albedo.
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Final" }.Read(gBuffer[0], RenderGraphState::PixelShaderResource).Read(shadowDepth, RenderGraphState::PixelShaderResource)
+			.Read(postProcess, RenderGraphState::PixelShaderResource).Write(final, RenderGraphState::RenderTarget));
+
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "CopyToSwapChain" }.Read(final, RenderGraphState::CopySource).Write(backBuffer, RenderGraphState::CopyDestination));
+
+		return renderGraphDesc;
+	}
+
+	RenderGraphState GetRandomState(std::mt19937& randomEngine, bool isWrite)
+	{
+		static constexpr std::array<RenderGraphState, 4u> WRITE_STATES
+		{
+			RenderGraphState::RenderTarget, RenderGraphState::UnorderedAccess, RenderGraphState::DepthWrite, RenderGraphState::CopyDestination,
+		};
+
+		static constexpr std::array<RenderGraphState, 4u> READ_STATES
+		{
+			RenderGraphState::NonPixelShaderResource, RenderGraphState::PixelShaderResource, RenderGraphState::DepthRead, RenderGraphState::CopySource,
+		};
+
+		if (isWrite)
+		{
+			return WRITE_STATES[randomEngine() % WRITE_STATES.size()];
+		}
+
+		// Mostly single read states, sometimes combined ones.
+		RenderGraphState state = READ_STATES[randomEngine() % READ_STATES.size()];
+		if (randomEngine() % 4u == 0u)
+		{
+			state = state | READ_STATES[randomEngine() % READ_STATES.size()];
+		}
+
+		return state;
+	}
+
+	// Each pass accesses a few distinct resources, preferably the recently written ones (so the graph is deep rather than wide).
+	// The last pass has side effects, so there is always a pass left to transition the resources into their final state.
+	gfx::RenderGraphDesc CreateRandomRenderGraph(std::mt19937& randomEngine, uint32_t passCount, uint32_t resourceCount, uint32_t asyncComputePercentage)
+	{
+		gfx::RenderGraphDesc renderGraphDesc{};
+
+		for (uint32_t resourceIndex = 0u; resourceIndex < resourceCount; ++resourceIndex)
+		{
+			const auto GetRandomRestState = [&]()
+			{
+				const uint32_t choice = randomEngine() % 3u;
+				return choice == 0u ? RenderGraphState::Common : GetRandomState(randomEngine, choice == 1u);
+			};
+
+			renderGraphDesc.AddResource(gfx::RenderGraphResourceDesc
+			{
+				.name = "Resource" + std::to_string(resourceIndex),
+				.initialState = GetRandomRestState(),
+				.finalState = GetRandomRestState(),
+				.isOutput = randomEngine() % 8u == 0u,
+			});
+		}
+
+		for (uint32_t passIndex = 0u; passIndex < passCount; ++passIndex)
+		{
+			gfx::RenderGraphPassDesc passDesc
+			{
+				.name = "Pass" + std::to_string(passIndex),
+				.queue = randomEngine() % 100u < asyncComputePercentage ? gfx::RenderGraphPassQueue::AsyncCompute : gfx::RenderGraphPassQueue::Graphics,
+				.hasSideEffects = randomEngine() % 16u == 0u || passIndex + 1u == passCount,
+			};
+
+			const uint32_t accessCount = 1u + randomEngine() % std::min(resourceCount, 4u);
+			std::vector<uint32_t> accessedResources{};
+
+			while (accessedResources.size() < accessCount)
+			{
+				// Resources near the pass index act as the pass' inputs / outputs.
+				const uint32_t window = std::min(resourceCount, 8u);
+				const uint32_t resourceIndex = (passIndex * resourceCount / std::max(passCount, 1u) + resourceCount - randomEngine() % window) % resourceCount;
+
+				if (std::find(accessedResources.begin(), accessedResources.end(), resourceIndex) == accessedResources.end())
+				{
+					accessedResources.push_back(resourceIndex);
+				}
+			}
+
+			for (const uint32_t resourceIndex : accessedResources)
+			{
+				if (randomEngine() % 3u == 0u)
+				{
+					passDesc.Write(resourceIndex, GetRandomState(randomEngine, true));
+				}
+				else
+				{
+					passDesc.Read(resourceIndex, GetRandomState(randomEngine, false));
+				}
+			}
+
+			renderGraphDesc.AddPass(passDesc);
+		}
+
+		return renderGraphDesc;
+	}
+}
+
+bool VerifyRenderGraphCompiler()
+{
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	gfx::CompiledRenderGraph compiledRenderGraph{};
+
+	// Culling : passes contributing to neither an output nor a pass with side effects are removed.
+	{
+		gfx::RenderGraphDesc renderGraphDesc{};
+		const uint32_t unused = renderGraphDesc.AddResource({ .name = "Unused", .initialState = RenderGraphState::UnorderedAccess, .finalState = RenderGraphState::UnorderedAccess });
+		const uint32_t intermediate = renderGraphDesc.AddResource({ .name = "Intermediate", .initialState = RenderGraphState::PixelShaderResource, .finalState = RenderGraphState::PixelShaderResource });
+		const uint32_t readBack = renderGraphDesc.AddResource({ .name = "ReadBack", .initialState = RenderGraphState::CopyDestination, .finalState = RenderGraphState::CopyDestination });
+		const uint32_t backBuffer = renderGraphDesc.AddResource({ .name = "BackBuffer", .initialState = RenderGraphState::Present, .finalState = RenderGraphState::Present, .isOutput = true });
+
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Unused" }.Write(unused, RenderGraphState::UnorderedAccess));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Intermediate" }.Write(intermediate, RenderGraphState::RenderTarget));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Draw" }.Read(intermediate, RenderGraphState::PixelShaderResource).Write(backBuffer, RenderGraphState::RenderTarget));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "ReadBack", .hasSideEffects = true }.Write(readBack, RenderGraphState::CopyDestination));
+
+		if (!CompileAndValidate("Culling", renderGraphDesc, {}, compiledRenderGraph) ||
+			!Expect(SUITE_NAME, compiledRenderGraph.statistics.passCount == 3u && compiledRenderGraph.statistics.culledPassCount == 1u, "Culling", "only the unused pass to be culled") ||
+			!Expect(SUITE_NAME, compiledRenderGraph.passes.front().passIndex != 0u, "Culling", "the unused pass not to be compiled"))
+		{
+			return false;
+		}
+
+		if (!CompileAndValidate("Culling disabled", renderGraphDesc, { .isCullingEnabled = false }, compiledRenderGraph) ||
+			!Expect(SUITE_NAME, compiledRenderGraph.statistics.passCount == 4u, "Culling disabled", "all passes to be kept"))
+		{
+			return false;
+		}
+	}
+
+	// Reads in several states share a single transition into the combined state, and a write in the current state requires no transition
+	// (except a UAV barrier between unordered access writes).
+	{
+		gfx::RenderGraphDesc renderGraphDesc{};
+		const uint32_t gBuffer = renderGraphDesc.AddResource({ .name = "GBuffer", .initialState = RenderGraphState::RenderTarget,
+			.finalState = RenderGraphState::PixelShaderResource | RenderGraphState::NonPixelShaderResource });
+		const uint32_t histogram = renderGraphDesc.AddResource({ .name = "Histogram", .initialState = RenderGraphState::UnorderedAccess, .finalState = RenderGraphState::UnorderedAccess, .isOutput = true });
+		const uint32_t backBuffer = renderGraphDesc.AddResource({ .name = "BackBuffer", .initialState = RenderGraphState::Present, .finalState = RenderGraphState::Present, .isOutput = true });
+
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Geometry" }.Write(gBuffer, RenderGraphState::RenderTarget));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Lighting" }.Read(gBuffer, RenderGraphState::PixelShaderResource).Write(backBuffer, RenderGraphState::RenderTarget));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "ClearHistogram" }.Write(histogram, RenderGraphState::UnorderedAccess));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Histogram" }.Read(gBuffer, RenderGraphState::NonPixelShaderResource).Write(histogram, RenderGraphState::UnorderedAccess));
+
+		if (!CompileAndValidate("Read states", renderGraphDesc, {}, compiledRenderGraph) ||
+			!Expect(SUITE_NAME, CountBarriers(compiledRenderGraph, gBuffer, gfx::RenderGraphBarrierType::Transition) == 1u, "Read states", "a single transition of the G-Buffer") ||
+			!Expect(SUITE_NAME, CountBarriers(compiledRenderGraph, histogram, gfx::RenderGraphBarrierType::Transition) == 0u, "Read states", "no transition of the histogram") ||
+			!Expect(SUITE_NAME, CountBarriers(compiledRenderGraph, histogram, gfx::RenderGraphBarrierType::UnorderedAccess) == 1u, "Read states", "a UAV barrier between the histogram writes"))
+		{
+			return false;
+		}
+	}
+
+	// Async compute : the compute pass overlaps the independent graphics work, and transitions from graphics only states are performed by the graphics queue.
+	{
+		gfx::RenderGraphDesc renderGraphDesc{};
+		const uint32_t depth = renderGraphDesc.AddResource({ .name = "Depth", .initialState = RenderGraphState::DepthWrite, .finalState = RenderGraphState::DepthWrite });
+		const uint32_t ambientOcclusion = renderGraphDesc.AddResource({ .name = "AmbientOcclusion", .initialState = RenderGraphState::NonPixelShaderResource,
+			.finalState = RenderGraphState::NonPixelShaderResource });
+		const uint32_t shadowDepth = renderGraphDesc.AddResource({ .name = "ShadowDepth", .initialState = RenderGraphState::PixelShaderResource, .finalState = RenderGraphState::PixelShaderResource });
+		const uint32_t backBuffer = renderGraphDesc.AddResource({ .name = "BackBuffer", .initialState = RenderGraphState::Present, .finalState = RenderGraphState::Present, .isOutput = true });
+
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "DepthPrepass" }.Write(depth, RenderGraphState::DepthWrite));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "AmbientOcclusion", .queue = gfx::RenderGraphPassQueue::AsyncCompute }
+			.Read(depth, RenderGraphState::NonPixelShaderResource).Write(ambientOcclusion, RenderGraphState::UnorderedAccess));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Shadow" }.Write(shadowDepth, RenderGraphState::DepthWrite));
+		renderGraphDesc.AddPass(gfx::RenderGraphPassDesc{ .name = "Lighting" }.Read(depth, RenderGraphState::DepthRead).Read(ambientOcclusion, RenderGraphState::PixelShaderResource)
+			.Read(shadowDepth, RenderGraphState::PixelShaderResource).Write(backBuffer, RenderGraphState::RenderTarget));
+
+		if (!CompileAndValidate("Async compute", renderGraphDesc, {}, compiledRenderGraph))
+		{
+			return false;
+		}
+
+		const gfx::CompiledRenderGraphPass& depthPrepass = compiledRenderGraph.passes.front();
+		const bool isDepthTransitionedByPrepass = depthPrepass.passIndex == 0u && depthPrepass.endBarriers.size() == 1u && depthPrepass.endBarriers.front().resourceIndex == depth;
+
+		if (!Expect(SUITE_NAME, compiledRenderGraph.statistics.asyncComputePassCount == 1u && compiledRenderGraph.statistics.demotedPassCount == 0u, "Async compute", "the ambient occlusion pass on the compute queue") ||
+			!Expect(SUITE_NAME, isDepthTransitionedByPrepass, "Async compute", "the depth prepass to transition the depth for the compute queue") ||
+			!Expect(SUITE_NAME, compiledRenderGraph.statistics.submissionCount == 4u && compiledRenderGraph.statistics.crossQueueDependencyCount == 2u, "Async compute",
+				"the shadow pass to be submitted while the compute queue runs"))
+		{
+			return false;
+		}
+
+		if (!CompileAndValidate("Async compute disabled", renderGraphDesc, { .isAsyncComputeEnabled = false }, compiledRenderGraph) ||
+			!Expect(SUITE_NAME, compiledRenderGraph.statistics.submissionCount == 1u && compiledRenderGraph.statistics.asyncComputePassCount == 0u, "Async compute disabled", "a single graphics submission"))
+		{
+			return false;
+		}
+
+		// Compute command lists can not transition the ambient occlusion from the pixel shader resource state, so the pass is moved to the graphics queue.
+		renderGraphDesc.resources[ambientOcclusion].initialState = RenderGraphState::PixelShaderResource;
+
+		if (!CompileAndValidate("Async compute demotion", renderGraphDesc, {}, compiledRenderGraph) ||
+			!Expect(SUITE_NAME, compiledRenderGraph.statistics.asyncComputePassCount == 0u && compiledRenderGraph.statistics.demotedPassCount == 1u, "Async compute demotion",
+				"the ambient occlusion pass on the graphics queue"))
+		{
+			return false;
+		}
+	}
+
+	// Invalid accesses are reported instead of compiled.
+	{
+		gfx::RenderGraphDesc renderGraphDesc{};
+		const uint32_t texture = renderGraphDesc.AddResource({ .name = "Texture" });
+
+		const std::array<gfx::RenderGraphPassDesc, 4u> invalidPassDescs
+		{
+			gfx::RenderGraphPassDesc{ .name = "ReadInWriteState" }.Read(texture, RenderGraphState::UnorderedAccess),
+			gfx::RenderGraphPassDesc{ .name = "WriteInCombinedState" }.Write(texture, RenderGraphState::RenderTarget | RenderGraphState::UnorderedAccess),
+			gfx::RenderGraphPassDesc{ .name = "ReadAndWrite" }.Read(texture, RenderGraphState::PixelShaderResource).Write(texture, RenderGraphState::RenderTarget),
+			gfx::RenderGraphPassDesc{ .name = "InvalidResource" }.Read(texture + 1u, RenderGraphState::PixelShaderResource),
+		};
+
+		for (const gfx::RenderGraphPassDesc& invalidPassDesc : invalidPassDescs)
+		{
+			gfx::RenderGraphDesc invalidRenderGraphDesc = renderGraphDesc;
+			invalidRenderGraphDesc.AddPass(invalidPassDesc);
+
+			if (!Expect(SUITE_NAME, !gfx::CompileRenderGraph(invalidRenderGraphDesc).error.empty(), invalidPassDesc.name.c_str(), "a compilation error"))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Random graphs, with all combinations of options.
+	std::mt19937 randomEngine(42u);
+
+	uint32_t randomGraphCount{};
+	for (uint32_t graphIndex = 0u; graphIndex < 2000u; ++graphIndex)
+	{
+		const gfx::RenderGraphDesc renderGraphDesc = CreateRandomRenderGraph(randomEngine, 1u + randomEngine() % 32u, 1u + randomEngine() % 12u, randomEngine() % 101u);
+
+		const gfx::RenderGraphCompileOptions compileOptions
+		{
+			.isCullingEnabled = randomEngine() % 2u == 0u,
+			.isAsyncComputeEnabled = randomEngine() % 4u != 0u,
+			.maxPassesPerCommandList = static_cast<uint32_t>(1u + randomEngine() % 8u),
+		};
+
+		const std::string caseName = "Random graph " + std::to_string(graphIndex);
+		if (!CompileAndValidate(caseName.c_str(), renderGraphDesc, compileOptions, compiledRenderGraph))
+		{
+			return false;
+		}
+
+		randomGraphCount++;
+	}
+
+	// The frame of the SandBox, whose barriers used to be placed by hand (26 transitions in 12 batches, transitioning the depth back and forth around its copy).
+	const gfx::RenderGraphDesc sandBoxRenderGraphDesc = CreateSandBoxRenderGraph();
+	if (!CompileAndValidate("SandBox", sandBoxRenderGraphDesc, {}, compiledRenderGraph) ||
+		!Expect(SUITE_NAME, compiledRenderGraph.statistics.barrierCount < 26u && compiledRenderGraph.statistics.barrierBatchCount < 12u, "SandBox", "fewer barriers than placed by hand"))
+	{
+		return false;
+	}
+
+	const double verificationTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	std::printf("Render graph compiler : all cases and %u random graphs are valid (%.1f ms)\n%s", randomGraphCount, verificationTime,
+		gfx::GenerateRenderGraphReport(sandBoxRenderGraphDesc, compiledRenderGraph).c_str());
+
+	return true;
+}
+
+void BenchmarkRenderGraphCompiler()
+{
+	static constexpr uint32_t ITERATION_COUNT = 200u;
+
+	std::mt19937 randomEngine(42u);
+
+	for (const uint32_t passCount : { 128u, 256u, 1024u })
+	{
+		// A quarter of the passes would like to run on the compute queue.
+		const gfx::RenderGraphDesc renderGraphDesc = CreateRandomRenderGraph(randomEngine, passCount, passCount / 2u, 25u);
+
+		std::vector<double> compileTimes{};
+		gfx::CompiledRenderGraph compiledRenderGraph{};
+
+		for (uint32_t iteration = 0u; iteration < ITERATION_COUNT; ++iteration)
+		{
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			compiledRenderGraph = gfx::CompileRenderGraph(renderGraphDesc, { .maxPassesPerCommandList = 16u });
+			compileTimes.push_back(std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - startTime).count());
+		}
+
+		std::sort(compileTimes.begin(), compileTimes.end());
+
+		double totalCompileTime{};
+		for (const double compileTime : compileTimes)
+		{
+			totalCompileTime += compileTime;
+		}
+
+		const gfx::RenderGraphCompileStatistics& statistics = compiledRenderGraph.statistics;
+		std::printf("Render graph compiler : %4u passes | average %8.1f us | p95 %8.1f us | %u kept, %u async compute | %u barriers in %u batches (%u in %u without the compiler) | %u submissions\n",
+			passCount, totalCompileTime / compileTimes.size(), compileTimes[compileTimes.size() * 95u / 100u], statistics.passCount, statistics.asyncComputePassCount,
+			statistics.barrierCount, statistics.barrierBatchCount, statistics.naiveBarrierCount, statistics.naiveBarrierBatchCount, statistics.submissionCount);
+	}
+}
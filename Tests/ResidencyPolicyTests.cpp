@@ -0,0 +1,187 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Graphics/API/ResidencyPolicy.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Residency policy";
+
+	constexpr uint64_t MB = 1024u * 1024u;
+
+	// Every resource is used in the first frame (as when the level is loaded), so all of them are tracked by the policy.
+	gfx::ResidencyTrace CreateResidencyTrace(uint32_t resourceCount, uint64_t resourceSizeInBytes)
+	{
+		gfx::ResidencyTrace residencyTrace{};
+		residencyTrace.resourceSizes.resize(resourceCount, resourceSizeInBytes);
+
+		std::vector<uint32_t>& loadingFrame = residencyTrace.frames.emplace_back();
+		for (uint32_t i = 0u; i < resourceCount; ++i)
+		{
+			loadingFrame.push_back(i);
+		}
+
+		return residencyTrace;
+	}
+
+	void PrintResidencyTraceResult(const char* traceName, const gfx::ResidencyTrace& residencyTrace, const gfx::ResidencyTraceResult& residencyTraceResult, uint64_t budgetInBytes)
+	{
+		std::printf("Residency policy : %-15s | %zu frames | %llu evictions | churn ratio %.2f | peak usage %llu MB (%llu MB at the end of a frame) / budget %llu MB | "
+			"%u frames over budget\n", traceName, residencyTrace.frames.size(), static_cast<unsigned long long>(residencyTraceResult.statistics.totalEvictionCount),
+			residencyTraceResult.statistics.GetChurnRatio(), static_cast<unsigned long long>(residencyTraceResult.peakUsageInBytes / MB),
+			static_cast<unsigned long long>(residencyTraceResult.peakEndOfFrameUsageInBytes / MB), static_cast<unsigned long long>(budgetInBytes / MB),
+			residencyTraceResult.overBudgetFrameCount);
+	}
+}
+
+bool VerifyResidencyPolicy()
+{
+	static constexpr gfx::ResidencyPolicyDesc RESIDENCY_POLICY_DESC{};
+
+	// Resources used in the last frames in flight, and resources that were never used, are not evicted even when over budget.
+	{
+		std::shared_ptr<gfx::ResidencyPolicy> residencyPolicy = std::make_shared<gfx::ResidencyPolicy>(RESIDENCY_POLICY_DESC);
+
+		bool isUsedResourceEvicted{ false };
+		bool isUntrackedResourceEvicted{ false };
+
+		const gfx::ResidencyHandle usedResource = residencyPolicy->RegisterResource(&isUsedResourceEvicted, 64u * MB);
+		const gfx::ResidencyHandle untrackedResource = residencyPolicy->RegisterResource(&isUntrackedResourceEvicted, 64u * MB);
+
+		const auto evict = [](std::span<void* const> resources)
+		{
+			for (void* resource : resources)
+			{
+				*static_cast<bool*>(resource) = true;
+			}
+		};
+
+		const uint64_t usedResourceId = *usedResource;
+		residencyPolicy->MarkUsed({ &usedResourceId, 1u }, {});
+
+		for (uint64_t frameIndex = 0u; frameIndex < RESIDENCY_POLICY_DESC.framesInFlight; ++frameIndex)
+		{
+			residencyPolicy->EndFrame(128u * MB, 64u * MB, evict);
+		}
+
+		if (!Expect(SUITE_NAME, !isUsedResourceEvicted && !isUntrackedResourceEvicted, "Frames in flight", "no resource evicted while the GPU may still use it"))
+		{
+			return false;
+		}
+
+		residencyPolicy->EndFrame(128u * MB, 64u * MB, evict);
+
+		const gfx::ResidencyStatistics statistics = residencyPolicy->GetStatistics();
+		if (!Expect(SUITE_NAME, isUsedResourceEvicted && !isUntrackedResourceEvicted, "Frames in flight", "the used resource evicted once out of flight, and the untracked one kept") ||
+			!Expect(SUITE_NAME, statistics.residentResourceCount == 1u && statistics.evictedBytes == 64u * MB && statistics.totalEvictionCount == 1u, "Frames in flight",
+				"the statistics of a single eviction"))
+		{
+			return false;
+		}
+
+		// Making the resource resident again right after its eviction counts as churn.
+		bool isMadeResident{ false };
+		residencyPolicy->MarkUsed({ &usedResourceId, 1u }, [&](std::span<void* const> resources) { isMadeResident = resources.size() == 1u; });
+		if (!Expect(SUITE_NAME, isMadeResident && residencyPolicy->GetStatistics().churnCount == 1u, "Churn", "the resource made resident again, counted as churn"))
+		{
+			return false;
+		}
+	}
+
+	// Trace whose working set fits in the budget : nothing is ever evicted.
+	{
+		static constexpr uint64_t BUDGET_IN_BYTES = 1024u * MB;
+
+		gfx::ResidencyTrace residencyTrace = CreateResidencyTrace(64u, 8u * MB);
+		for (uint32_t frameIndex = 0u; frameIndex < 300u; ++frameIndex)
+		{
+			residencyTrace.frames.push_back(residencyTrace.frames.front());
+		}
+
+		const gfx::ResidencyTraceResult residencyTraceResult = gfx::SimulateResidencyTrace(residencyTrace, BUDGET_IN_BYTES, RESIDENCY_POLICY_DESC);
+		PrintResidencyTraceResult("Fitting", residencyTrace, residencyTraceResult, BUDGET_IN_BYTES);
+
+		if (!Expect(SUITE_NAME, residencyTraceResult.statistics.totalEvictionCount == 0u && residencyTraceResult.overBudgetFrameCount == 0u, "Fitting trace",
+			"no eviction, and every frame within the budget"))
+		{
+			return false;
+		}
+	}
+
+	// Trace moving through a level (resources shared by every frame, and a window of 512 MB sliding through the level) : once the frames of the loading are
+	// out of flight, the usage stays within the budget, and little of what is evicted has to be made resident again.
+	{
+		static constexpr uint64_t BUDGET_IN_BYTES = 1024u * MB;
+		static constexpr uint32_t SHARED_RESOURCE_COUNT = 16u;
+		static constexpr uint32_t WINDOW_RESOURCE_COUNT = 64u;
+		static constexpr uint32_t SECTION_FRAME_COUNT = 200u;
+
+		gfx::ResidencyTrace residencyTrace = CreateResidencyTrace(256u, 8u * MB);
+		for (uint32_t frameIndex = 0u; frameIndex < 6u * SECTION_FRAME_COUNT; ++frameIndex)
+		{
+			const uint32_t windowBegin = SHARED_RESOURCE_COUNT + frameIndex / SECTION_FRAME_COUNT * 32u;
+
+			std::vector<uint32_t>& frame = residencyTrace.frames.emplace_back();
+			for (uint32_t i = 0u; i < SHARED_RESOURCE_COUNT; ++i)
+			{
+				frame.push_back(i);
+			}
+
+			for (uint32_t i = windowBegin; i < windowBegin + WINDOW_RESOURCE_COUNT; ++i)
+			{
+				frame.push_back(i);
+			}
+		}
+
+		const gfx::ResidencyTraceResult residencyTraceResult = gfx::SimulateResidencyTrace(residencyTrace, BUDGET_IN_BYTES, RESIDENCY_POLICY_DESC);
+		PrintResidencyTraceResult("Level streaming", residencyTrace, residencyTraceResult, BUDGET_IN_BYTES);
+
+		if (!Expect(SUITE_NAME, residencyTraceResult.statistics.totalEvictionCount > 0u && residencyTraceResult.statistics.GetChurnRatio() < 0.05, "Level streaming trace",
+			"evictions, with a churn ratio below 5%") ||
+			!Expect(SUITE_NAME, residencyTraceResult.overBudgetFrameCount <= RESIDENCY_POLICY_DESC.framesInFlight, "Level streaming trace",
+				"only the frames of the loading over budget") ||
+			!Expect(SUITE_NAME, residencyTraceResult.statistics.residentBytes <= BUDGET_IN_BYTES, "Level streaming trace", "the resident resources within the budget at the end"))
+		{
+			return false;
+		}
+	}
+
+	// Trace whose working set (320 MB per frame, rotating through 2 GB of resources) does not fit in the budget : the policy thrashes, which the churn ratio
+	// reports, and the resources used by the frames in flight keep the usage over budget.
+	{
+		static constexpr uint64_t BUDGET_IN_BYTES = 256u * MB;
+		static constexpr uint32_t RESOURCE_COUNT = 256u;
+		static constexpr uint32_t FRAME_RESOURCE_COUNT = 40u;
+
+		gfx::ResidencyTrace residencyTrace = CreateResidencyTrace(RESOURCE_COUNT, 8u * MB);
+		for (uint32_t frameIndex = 0u; frameIndex < 300u; ++frameIndex)
+		{
+			std::vector<uint32_t>& frame = residencyTrace.frames.emplace_back();
+			for (uint32_t i = 0u; i < FRAME_RESOURCE_COUNT; ++i)
+			{
+				frame.push_back((frameIndex * FRAME_RESOURCE_COUNT + i) % RESOURCE_COUNT);
+			}
+		}
+
+		const gfx::ResidencyTraceResult residencyTraceResult = gfx::SimulateResidencyTrace(residencyTrace, BUDGET_IN_BYTES, RESIDENCY_POLICY_DESC);
+		PrintResidencyTraceResult("Thrashing", residencyTrace, residencyTraceResult, BUDGET_IN_BYTES);
+
+		if (!Expect(SUITE_NAME, residencyTraceResult.statistics.GetChurnRatio() > 0.5, "Thrashing trace", "a churn ratio above 50%") ||
+			!Expect(SUITE_NAME, residencyTraceResult.overBudgetFrameCount > residencyTrace.frames.size() / 2u, "Thrashing trace", "most frames over budget"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Residency policy : all cases are valid\n");
+
+	return true;
+}
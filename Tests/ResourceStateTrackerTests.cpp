@@ -0,0 +1,316 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Graphics/API/NullRenderBackend.hpp"
+#include "Graphics/API/ResourceStateTracker.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Resource state tracker";
+
+	// D3D12_RESOURCE_STATES values.
+	enum TrackedState : uint32_t
+	{
+		Present = 0x0u,
+		RenderTarget = 0x4u,
+		UnorderedAccess = 0x8u,
+		PixelShaderResource = 0x80u,
+		ShaderResource = 0xC0u,
+		CopySource = 0x800u,
+	};
+
+	std::vector<gfx::ResourceBarrierCommand> GetRecordedBarriers(const gfx::CommandStream& commandStream)
+	{
+		std::vector<gfx::ResourceBarrierCommand> barriers{};
+		commandStream.ForEachCommand([&](const gfx::CommandHeader& header)
+		{
+			if (header.type == gfx::CommandType::ResourceBarrier)
+			{
+				barriers.push_back(gfx::CommandStream::GetCommand<gfx::ResourceBarrierCommand>(header));
+			}
+		});
+
+		return barriers;
+	}
+
+	bool IsTransition(const gfx::ResourceBarrierCommand& barrier, gfx::CommandHandle resource, uint32_t stateBefore, uint32_t stateAfter,
+		uint32_t subresource = gfx::ALL_SUBRESOURCES, gfx::BarrierSplit split = gfx::BarrierSplit::None)
+	{
+		return barrier.barrierType == gfx::BarrierType::Transition && barrier.resource == resource && barrier.stateBefore == stateBefore && barrier.stateAfter == stateAfter &&
+			barrier.subresource == subresource && barrier.split == split;
+	}
+}
+
+bool VerifyResourceStateTracker()
+{
+	gfx::NullRenderBackend backend{};
+	std::shared_ptr<gfx::ResourceStateRegistry> resourceStateRegistry = std::make_shared<gfx::ResourceStateRegistry>();
+
+	const gfx::CommandHandle texture = backend.CreateObject(gfx::BackendObjectType::Texture, "Texture");
+	const gfx::CommandHandle mipChain = backend.CreateObject(gfx::BackendObjectType::Texture, "Mip Chain");
+	const gfx::CommandHandle unregisteredTexture = backend.CreateObject(gfx::BackendObjectType::Texture, "Unregistered Texture");
+	const gfx::CommandHandle renderTarget = backend.CreateObject(gfx::BackendObjectType::Texture, "Render Target");
+	const gfx::CommandHandle buffer = backend.CreateObject(gfx::BackendObjectType::Buffer, "Buffer");
+
+	const gfx::ResourceStateHandle textureResourceState = resourceStateRegistry->RegisterResource(texture, RenderTarget);
+	const gfx::ResourceStateHandle mipChainResourceState = resourceStateRegistry->RegisterResource(mipChain, UnorderedAccess);
+	const gfx::ResourceStateHandle renderTargetResourceState = resourceStateRegistry->RegisterResource(renderTarget, RenderTarget);
+	const gfx::ResourceStateHandle bufferResourceState = resourceStateRegistry->RegisterResource(buffer, CopySource);
+
+	// Executes the streams (after resolving them) on the null render backend, which validates the states.
+	const auto submit = [&](std::span<gfx::CommandStream* const> commandStreams)
+	{
+		for (gfx::CommandStream* commandStream : commandStreams)
+		{
+			commandStream->EndResourceTransitions();
+		}
+
+		gfx::CommandStream prologueCommandStream{};
+		prologueCommandStream.RecordResolvedBarriers(resourceStateRegistry->ResolvePendingTransitions(gfx::QueueType::Graphics, commandStreams).prologueBarriers);
+
+		std::vector<const gfx::CommandStream*> executedCommandStreams{ &prologueCommandStream };
+		executedCommandStreams.insert(executedCommandStreams.end(), commandStreams.begin(), commandStreams.end());
+		backend.ExecuteCommandStreams(gfx::QueueType::Graphics, executedCommandStreams, {});
+
+		return GetRecordedBarriers(prologueCommandStream);
+	};
+
+	// Redundant and merged transitions : the first use of the texture records no barrier, and the transitions between two draws fold into one.
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.TransitionResource(texture, ShaderResource);
+		commandStream.TransitionResource(texture, PixelShaderResource);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.TransitionResource(texture, CopySource);
+		commandStream.TransitionResource(texture, RenderTarget);
+		commandStream.TransitionResource(texture, UnorderedAccess);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.TransitionResource(texture, RenderTarget);
+		commandStream.TransitionResource(texture, UnorderedAccess);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+
+		const std::vector<gfx::ResourceBarrierCommand> barriers = GetRecordedBarriers(commandStream);
+		const gfx::ResourceBarrierStatistics statistics = commandStream.GetStatistics().resourceBarrierStatistics;
+
+		gfx::CommandStream* const commandStreams[]{ &commandStream };
+		const std::vector<gfx::ResourceBarrierCommand> prologueBarriers = submit(commandStreams);
+
+		if (!Expect(SUITE_NAME, barriers.size() == 1u && IsTransition(barriers[0], texture, ShaderResource, UnorderedAccess), "Merging", "a single shader resource -> unordered access transition") ||
+			!Expect(SUITE_NAME, statistics.redundantTransitionCount == 1u && statistics.mergedTransitionCount == 3u && statistics.barrierBatchCount == 1u, "Merging", "1 redundant and 3 merged transitions in 1 batch") ||
+			!Expect(SUITE_NAME, prologueBarriers.size() == 1u && IsTransition(prologueBarriers[0], texture, RenderTarget, ShaderResource), "Merging", "the first use to be resolved from the registered state") ||
+			!Expect(SUITE_NAME, resourceStateRegistry->GetResourceState(texture) == UnorderedAccess, "Merging", "the registry to adopt the final state"))
+		{
+			return false;
+		}
+	}
+
+	// Read only states are combined, and explicit barriers are corrected to the tracked state.
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.TransitionResource(texture, ShaderResource);
+		commandStream.TransitionResource(texture, CopySource);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.TransitionResource(texture, PixelShaderResource);
+		commandStream.Record(gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::Transition, .stateBefore = ShaderResource, .stateAfter = RenderTarget, .resource = texture });
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+
+		const std::vector<gfx::ResourceBarrierCommand> barriers = GetRecordedBarriers(commandStream);
+		const gfx::ResourceBarrierStatistics statistics = commandStream.GetStatistics().resourceBarrierStatistics;
+
+		gfx::CommandStream* const commandStreams[]{ &commandStream };
+		submit(commandStreams);
+
+		const bool areStatesCombined = barriers.size() == 2u && IsTransition(barriers[0], texture, ShaderResource, ShaderResource | CopySource) &&
+			IsTransition(barriers[1], texture, ShaderResource | CopySource, RenderTarget);
+
+		if (!Expect(SUITE_NAME, areStatesCombined, "Read only states", "the read states to be combined, and transitioned from together") ||
+			!Expect(SUITE_NAME, statistics.correctedTransitionCount == 1u && statistics.redundantTransitionCount == 1u, "Read only states", "1 corrected and 1 redundant transition"))
+		{
+			return false;
+		}
+	}
+
+	// Split transitions : begun after the last use, and ended before the next one. Without work in between, the pair is a regular transition.
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.TransitionResource(texture, RenderTarget);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.BeginResourceTransition(texture, ShaderResource);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.TransitionResource(texture, ShaderResource);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.BeginResourceTransition(texture, RenderTarget);
+		commandStream.TransitionResource(texture, RenderTarget);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+		commandStream.BeginResourceTransition(texture, CopySource);
+		commandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+
+		gfx::CommandStream* const commandStreams[]{ &commandStream };
+		submit(commandStreams);
+
+		const std::vector<gfx::ResourceBarrierCommand> barriers = GetRecordedBarriers(commandStream);
+		const gfx::ResourceBarrierStatistics statistics = commandStream.GetStatistics().resourceBarrierStatistics;
+
+		const bool areBarriersSplit = barriers.size() == 5u &&
+			IsTransition(barriers[0], texture, RenderTarget, ShaderResource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::Begin) &&
+			IsTransition(barriers[1], texture, RenderTarget, ShaderResource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::End) &&
+			IsTransition(barriers[2], texture, ShaderResource, RenderTarget) &&
+			IsTransition(barriers[3], texture, RenderTarget, CopySource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::Begin) &&
+			IsTransition(barriers[4], texture, RenderTarget, CopySource, gfx::ALL_SUBRESOURCES, gfx::BarrierSplit::End);
+
+		if (!Expect(SUITE_NAME, areBarriersSplit, "Split transitions", "2 split transitions around the draws, and a regular transition without draw in between") ||
+			!Expect(SUITE_NAME, statistics.splitTransitionCount == 2u && statistics.mergedTransitionCount == 1u, "Split transitions", "2 split and 1 merged transitions"))
+		{
+			return false;
+		}
+	}
+
+	// Subresources : the mips are transitioned individually, and together once they are in the same state again.
+	{
+		static constexpr uint32_t MIP_COUNT = 4u;
+
+		gfx::CommandStream commandStream{};
+		for (uint32_t mip = 0u; mip < MIP_COUNT - 1u; ++mip)
+		{
+			if (mip != 0u)
+			{
+				commandStream.TransitionResource(mipChain, ShaderResource, mip - 1u, MIP_COUNT);
+			}
+
+			commandStream.TransitionResource(mipChain, UnorderedAccess, mip, MIP_COUNT);
+			commandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+		}
+
+		commandStream.TransitionResource(mipChain, ShaderResource);
+
+		gfx::CommandStream* const commandStreams[]{ &commandStream };
+		const std::vector<gfx::ResourceBarrierCommand> prologueBarriers = submit(commandStreams);
+
+		const std::vector<gfx::ResourceBarrierCommand> barriers = GetRecordedBarriers(commandStream);
+
+		// Mips 0 and 1 were transitioned to shader resources between the dispatches, and mip 2 at the end. Mip 3 was never used by the stream before, so
+		// its transition is resolved on submission.
+		const bool areBarriersPerMip = barriers.size() == 3u && IsTransition(barriers[0], mipChain, UnorderedAccess, ShaderResource, 0u) &&
+			IsTransition(barriers[1], mipChain, UnorderedAccess, ShaderResource, 1u) && IsTransition(barriers[2], mipChain, UnorderedAccess, ShaderResource, 2u);
+
+		if (!Expect(SUITE_NAME, areBarriersPerMip, "Subresources", "a transition per mip") ||
+			!Expect(SUITE_NAME, prologueBarriers.size() == 1u && IsTransition(prologueBarriers[0], mipChain, UnorderedAccess, ShaderResource, 3u), "Subresources", "the transition of the last mip to be resolved") ||
+			!Expect(SUITE_NAME, resourceStateRegistry->GetResourceState(mipChain) == ShaderResource, "Subresources", "all mips to end up in the same state"))
+		{
+			return false;
+		}
+	}
+
+	// Resolution : the first use of a resource in a stream is resolved at the end of the stream before it, and unregistered resources are left as is.
+	{
+		gfx::CommandStream firstCommandStream{};
+		firstCommandStream.TransitionResource(mipChain, UnorderedAccess, 1u, 4u);
+		firstCommandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+
+		gfx::CommandStream secondCommandStream{};
+		secondCommandStream.TransitionResource(mipChain, ShaderResource);
+		secondCommandStream.TransitionResource(texture, RenderTarget);
+		secondCommandStream.TransitionResource(unregisteredTexture, ShaderResource);
+		secondCommandStream.Record(gfx::DrawCommand{ .vertexCountPerInstance = 3u, .instanceCount = 1u });
+
+		gfx::CommandStream* const commandStreams[]{ &firstCommandStream, &secondCommandStream };
+		const std::vector<gfx::ResourceBarrierCommand> prologueBarriers = submit(commandStreams);
+
+		const std::vector<gfx::ResourceBarrierCommand> firstBarriers = GetRecordedBarriers(firstCommandStream);
+
+		const bool areBarriersResolved = firstBarriers.size() == 2u && IsTransition(firstBarriers[0], mipChain, UnorderedAccess, ShaderResource, 1u) &&
+			IsTransition(firstBarriers[1], texture, CopySource, RenderTarget);
+
+		if (!Expect(SUITE_NAME, prologueBarriers.size() == 1u && IsTransition(prologueBarriers[0], mipChain, ShaderResource, UnorderedAccess, 1u), "Resolution", "the mip used by the first stream to be resolved before it") ||
+			!Expect(SUITE_NAME, areBarriersResolved, "Resolution", "the resources used by the second stream to be resolved at the end of the first one"))
+		{
+			return false;
+		}
+	}
+
+	// Compute queue : the transitions from graphics only states are returned as the graphics prologue (whichever stream they are for), the others are
+	// executed on the compute queue.
+	{
+		gfx::CommandStream firstCommandStream{};
+		firstCommandStream.TransitionResource(mipChain, UnorderedAccess);
+		firstCommandStream.TransitionResource(buffer, UnorderedAccess);
+		firstCommandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+
+		gfx::CommandStream secondCommandStream{};
+		secondCommandStream.TransitionResource(renderTarget, UnorderedAccess);
+		secondCommandStream.Record(gfx::DispatchCommand{ .threadGroupCountX = 1u, .threadGroupCountY = 1u, .threadGroupCountZ = 1u });
+
+		gfx::CommandStream* const commandStreams[]{ &firstCommandStream, &secondCommandStream };
+		const gfx::ResolvedTransitions resolvedTransitions = resourceStateRegistry->ResolvePendingTransitions(gfx::QueueType::Compute, commandStreams);
+
+		gfx::CommandStream graphicsPrologueCommandStream{};
+		graphicsPrologueCommandStream.RecordResolvedBarriers(resolvedTransitions.graphicsPrologueBarriers);
+
+		gfx::CommandStream prologueCommandStream{};
+		prologueCommandStream.RecordResolvedBarriers(resolvedTransitions.prologueBarriers);
+
+		const gfx::CommandStream* const graphicsCommandStreams[]{ &graphicsPrologueCommandStream };
+		const gfx::QueueWait queueWait
+		{
+			.waitingQueue = gfx::QueueType::Compute,
+			.signallingQueue = gfx::QueueType::Graphics,
+			.fenceValue = backend.ExecuteCommandStreams(gfx::QueueType::Graphics, graphicsCommandStreams, {}),
+		};
+
+		const gfx::CommandStream* const computeCommandStreams[]{ &prologueCommandStream, &firstCommandStream, &secondCommandStream };
+		backend.ExecuteCommandStreams(gfx::QueueType::Compute, computeCommandStreams, std::span(&queueWait, 1u));
+
+		const std::vector<gfx::ResourceBarrierCommand>& graphicsPrologueBarriers = resolvedTransitions.graphicsPrologueBarriers;
+		const bool areGraphicsBarriersRouted = graphicsPrologueBarriers.size() == 2u && IsTransition(graphicsPrologueBarriers[0], mipChain, ShaderResource, UnorderedAccess) &&
+			IsTransition(graphicsPrologueBarriers[1], renderTarget, RenderTarget, UnorderedAccess);
+
+		if (!Expect(SUITE_NAME, areGraphicsBarriersRouted, "Compute queue", "the transitions from the (pixel) shader resource and render target states in the graphics prologue") ||
+			!Expect(SUITE_NAME, resolvedTransitions.prologueBarriers.size() == 1u && IsTransition(resolvedTransitions.prologueBarriers[0], buffer, CopySource, UnorderedAccess),
+				"Compute queue", "the copy source transition in the compute prologue") ||
+			!Expect(SUITE_NAME, GetRecordedBarriers(firstCommandStream).empty(), "Compute queue", "no transition resolved at the end of the first stream"))
+		{
+			return false;
+		}
+	}
+
+	const gfx::NullRenderBackendStatistics validStatistics = backend.GetStatistics();
+
+	// The null render backend detects barriers from the wrong state, and split transitions that are not ended.
+	{
+		gfx::CommandStream commandStream{};
+		commandStream.RecordResolvedBarriers(std::array
+		{
+			gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::Transition, .stateBefore = UnorderedAccess, .stateAfter = ShaderResource, .resource = texture },
+			gfx::ResourceBarrierCommand{ .barrierType = gfx::BarrierType::Transition, .stateBefore = ShaderResource, .stateAfter = Present, .resource = texture, .split = gfx::BarrierSplit::Begin },
+		});
+
+		const gfx::CommandStream* const commandStreams[]{ &commandStream };
+		backend.ExecuteCommandStreams(gfx::QueueType::Graphics, commandStreams, {});
+	}
+
+	const gfx::NullRenderBackendStatistics statistics = backend.GetStatistics();
+
+	if (!Expect(SUITE_NAME, validStatistics.invalidBarrierCount == 0u && validStatistics.invalidHandleCount == 0u, "Null render backend", "the tracked barriers to be valid") ||
+		!Expect(SUITE_NAME, statistics.invalidBarrierCount == 2u, "Null render backend", "the wrong state and the split transition that is not ended to be invalid"))
+	{
+		return false;
+	}
+
+	for (const gfx::CommandHandle handle : { texture, mipChain, unregisteredTexture, renderTarget, buffer })
+	{
+		backend.ReleaseObject(handle);
+	}
+
+	std::printf("Resource state tracker : all cases are valid\n");
+
+	return true;
+}
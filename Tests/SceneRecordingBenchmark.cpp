@@ -0,0 +1,231 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/JobSystem.hpp"
+#include "Graphics/API/CommandStream.hpp"
+#include "Graphics/API/NullRenderBackend.hpp"
+#include "Scene/SceneVisibility.hpp"
+
+using namespace helios;
+
+namespace
+{
+	// Same as the root constants of a draw of Model::RenderMesh (sizeof(PBRRenderResources)).
+	using MeshRenderResources = std::array<uint32_t, 18u>;
+
+	struct BenchmarkMesh
+	{
+		gfx::CommandHandle indexBuffer{};
+		uint32_t indicesCount{};
+	};
+}
+
+void BenchmarkSceneRecording()
+{
+	static constexpr uint32_t MODEL_COUNT = 10u;
+	static constexpr uint32_t MESHES_PER_MODEL = 103u;
+	static constexpr uint32_t MATERIALS_PER_MODEL = 25u;
+	static constexpr uint32_t FRAME_COUNT = 100u;
+	static constexpr float MODEL_SPACING = 40.0f;
+
+	gfx::NullRenderBackend backend{};
+
+	const std::array<gfx::CommandHandle, 2u> descriptorHeaps
+	{
+		backend.CreateObject(gfx::BackendObjectType::DescriptorHeap, "SRV_CBV_UAV Descriptor Heap"),
+		backend.CreateObject(gfx::BackendObjectType::DescriptorHeap, "Sampler Descriptor Heap"),
+	};
+
+	const gfx::CommandHandle rootSignature = backend.CreateObject(gfx::BackendObjectType::RootSignature, "Bindless Root Signature");
+	const gfx::CommandHandle shadowPipelineState = backend.CreateObject(gfx::BackendObjectType::PipelineState, "Shadow Pipeline State");
+	const gfx::CommandHandle deferredGeometryPipelineState = backend.CreateObject(gfx::BackendObjectType::PipelineState, "Deferred Geometry Pipeline State");
+	const gfx::CommandHandle shadowDepthView = backend.CreateObject(gfx::BackendObjectType::DepthStencilView, "Shadow Depth Texture View");
+	const gfx::CommandHandle depthStencilView = backend.CreateObject(gfx::BackendObjectType::DepthStencilView, "Depth Stencil Texture View");
+
+	std::array<gfx::CommandHandle, 4u> gBufferViews{};
+	for (uint32_t i = 0u; i < static_cast<uint32_t>(gBufferViews.size()); ++i)
+	{
+		gBufferViews[i] = backend.CreateObject(gfx::BackendObjectType::RenderTargetView, "GBuffer " + std::to_string(i) + " View");
+	}
+
+	// A Sponza like model (about a hundred meshes over 25 materials, ~260k triangles in total) within the bounds of the nave and aisles, replicated 10
+	// times along X. Each copy is a model of the scene, with its own meshes (and index buffers).
+	std::mt19937 randomEngine(42u);
+	std::uniform_real_distribution<float> positionXDistribution(-14.0f, 14.0f);
+	std::uniform_real_distribution<float> positionYDistribution(0.0f, 12.0f);
+	std::uniform_real_distribution<float> positionZDistribution(-6.0f, 6.0f);
+	std::uniform_real_distribution<float> extentDistribution(0.2f, 3.0f);
+	std::uniform_int_distribution<uint32_t> triangleCountDistribution(100u, 5000u);
+
+	scene::SceneVisibility visibility{};
+
+	// Every mesh is recorded, so the numbers are the cost of recording the whole scene (rather than depending on the camera).
+	visibility.mFrustumCullingEnabled = false;
+	visibility.mShadowCasterCullingEnabled = false;
+	visibility.mOcclusionCullingEnabled = false;
+
+	std::vector<std::vector<BenchmarkMesh>> models(MODEL_COUNT);
+	std::vector<scene::Matrix4x4> modelMatrices{};
+
+	for (uint32_t modelIndex = 0u; modelIndex < MODEL_COUNT; ++modelIndex)
+	{
+		std::vector<scene::VisibilityMesh> visibilityMeshes{};
+		for (uint32_t meshIndex = 0u; meshIndex < MESHES_PER_MODEL; ++meshIndex)
+		{
+			models[modelIndex].push_back(BenchmarkMesh
+			{
+				.indexBuffer = backend.CreateObject(gfx::BackendObjectType::Buffer, "Mesh Index Buffer"),
+				.indicesCount = 3u * triangleCountDistribution(randomEngine),
+			});
+
+			visibilityMeshes.push_back(scene::VisibilityMesh
+			{
+				.boundingBox = CreateCenteredBox({ positionXDistribution(randomEngine), positionYDistribution(randomEngine), positionZDistribution(randomEngine) },
+					{ extentDistribution(randomEngine), extentDistribution(randomEngine), extentDistribution(randomEngine) }),
+				.materialIndex = meshIndex % MATERIALS_PER_MODEL,
+			});
+		}
+
+		visibility.AddModel(visibilityMeshes, MATERIALS_PER_MODEL);
+
+		modelMatrices.push_back(scene::Matrix4x4
+		{
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			static_cast<float>(modelIndex) * MODEL_SPACING, 0.0f, 0.0f, 1.0f,
+		});
+	}
+
+	const scene::Matrix4x4 viewProjectionMatrix = scene::MultiplyMatrices(CreateWalkthroughViewMatrix({ -20.0f, 6.0f, 0.0f }, 3.14159265f * 0.5f),
+		scene::CreatePerspectiveMatrix(1.047198f, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	const scene::Float3 lightDirection{ 0.4f, -1.0f, 0.3f };
+	const scene::Matrix4x4 lightViewProjectionMatrix = scene::MultiplyMatrices(scene::CreateLookToMatrix({ 180.0f, 200.0f, -150.0f }, lightDirection),
+		scene::CreateOrthographicMatrix(420.0f, 1.0f, 600.0f));
+
+	visibility.CullMeshes(modelMatrices, viewProjectionMatrix);
+	visibility.CullShadowCasters(lightViewProjectionMatrix, lightDirection);
+
+	// Records the packets last built by the visibility as the shadow / deferred geometry passes do (see Scene::RecordInParallel) : a stream (context) per
+	// chunk, starting with the state the contexts are set up with, then the index buffer, root constants and draw of every mesh (see Model::RenderMesh).
+	const auto recordPass = [&](uint32_t chunkCount, gfx::CommandHandle pipelineState, std::span<const gfx::CommandHandle> renderTargetViews, gfx::CommandHandle depthView)
+	{
+		std::vector<std::unique_ptr<gfx::CommandStream>> commandStreams{};
+		for (uint32_t chunkIndex = 0u; chunkIndex < chunkCount; ++chunkIndex)
+		{
+			commandStreams.push_back(std::make_unique<gfx::CommandStream>());
+		}
+
+		gfx::SetRenderTargetsCommand setRenderTargetsCommand
+		{
+			.renderTargetCount = static_cast<uint32_t>(renderTargetViews.size()),
+			.isSingleHandleToDescriptorRange = 1u,
+			.depthStencil = depthView,
+		};
+
+		for (uint32_t i = 0u; i < setRenderTargetsCommand.renderTargetCount; ++i)
+		{
+			setRenderTargetsCommand.renderTargets[i] = renderTargetViews[i];
+		}
+
+		visibility.RecordInParallel(chunkCount, [&](uint32_t chunkIndex)
+		{
+			gfx::CommandStream& commandStream = *commandStreams[chunkIndex];
+
+			commandStream.Record(gfx::SetDescriptorHeapsCommand{ .descriptorHeapCount = 2u, .descriptorHeaps = descriptorHeaps });
+			commandStream.Record(gfx::SetRootSignatureCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics, .rootSignature = rootSignature });
+			commandStream.Record(gfx::SetPipelineStateCommand{ .pipelineState = pipelineState });
+			commandStream.Record(setRenderTargetsCommand);
+			commandStream.Record(gfx::SetViewportCommand{ .width = 1920.0f, .height = 1080.0f, .maxDepth = 1.0f });
+			commandStream.Record(gfx::SetPrimitiveTopologyCommand{ .primitiveTopology = 4u });
+		},
+		[&](uint32_t chunkIndex, const scene::MeshDrawLocation& meshDrawLocation)
+		{
+			gfx::CommandStream& commandStream = *commandStreams[chunkIndex];
+			const BenchmarkMesh& mesh = models[meshDrawLocation.modelIndex][meshDrawLocation.meshIndex];
+
+			MeshRenderResources meshRenderResources{};
+			meshRenderResources[0] = meshDrawLocation.modelIndex;
+			meshRenderResources[1] = meshDrawLocation.meshIndex;
+
+			commandStream.Record(gfx::SetIndexBufferCommand{ .bufferLocation = mesh.indexBuffer, .sizeInBytes = mesh.indicesCount * 4u });
+			commandStream.Record(gfx::SetRootConstantsCommand{ .bindPoint = gfx::PipelineBindPoint::Graphics }, meshRenderResources);
+			commandStream.Record(gfx::DrawIndexedCommand{ .indexCountPerInstance = mesh.indicesCount, .instanceCount = 1u });
+		});
+
+		return commandStreams;
+	};
+
+	std::printf("Scene recording : %u models of %u meshes (%u draws per pass), %u job system workers, %u hardware threads\n", MODEL_COUNT, MESHES_PER_MODEL,
+		visibility.GetMeshDrawCount(), core::JobSystem::Get().GetWorkerCount(), std::thread::hardware_concurrency());
+
+	double singleThreadTime{};
+	for (const uint32_t recordingThreadCount : { 1u, 4u, 8u })
+	{
+		// As Scene::GetRecordingChunkCount : the chunk count is also bounded by the threads of the job system.
+		const uint32_t chunkCount = visibility.GetRecordingChunkCount(recordingThreadCount);
+
+		double shadowTime{};
+		double geometryTime{};
+		uint64_t commandCount{};
+
+		for (uint32_t frame = 0u; frame < FRAME_COUNT; ++frame)
+		{
+			const auto shadowStartTime = std::chrono::high_resolution_clock::now();
+
+			visibility.BuildShadowDrawPackets();
+			const std::vector<std::unique_ptr<gfx::CommandStream>> shadowCommandStreams = recordPass(chunkCount, shadowPipelineState, {}, shadowDepthView);
+
+			const auto geometryStartTime = std::chrono::high_resolution_clock::now();
+
+			visibility.BuildCameraDrawPackets();
+			const std::vector<std::unique_ptr<gfx::CommandStream>> geometryCommandStreams = recordPass(chunkCount, deferredGeometryPipelineState, gBufferViews, depthStencilView);
+
+			const auto geometryEndTime = std::chrono::high_resolution_clock::now();
+
+			shadowTime += std::chrono::duration<double, std::milli>(geometryStartTime - shadowStartTime).count();
+			geometryTime += std::chrono::duration<double, std::milli>(geometryEndTime - geometryStartTime).count();
+
+			for (const auto* commandStreams : { &shadowCommandStreams, &geometryCommandStreams })
+			{
+				for (const std::unique_ptr<gfx::CommandStream>& commandStream : *commandStreams)
+				{
+					commandCount += commandStream->GetCommandCount();
+				}
+			}
+		}
+
+		const double totalTime = (shadowTime + geometryTime) / static_cast<double>(FRAME_COUNT);
+		singleThreadTime = recordingThreadCount == 1u ? totalTime : singleThreadTime;
+
+		std::printf("  %u recording threads (%2u chunks per pass) : shadow %.3f ms | deferred geometry %.3f ms | total %.3f ms (x%.2f) | %llu commands per frame\n",
+			recordingThreadCount, chunkCount, shadowTime / static_cast<double>(FRAME_COUNT), geometryTime / static_cast<double>(FRAME_COUNT), totalTime,
+			singleThreadTime / totalTime, static_cast<unsigned long long>(commandCount / FRAME_COUNT));
+	}
+
+	for (const std::vector<BenchmarkMesh>& meshes : models)
+	{
+		for (const BenchmarkMesh& mesh : meshes)
+		{
+			backend.ReleaseObject(mesh.indexBuffer);
+		}
+	}
+
+	for (const gfx::CommandHandle handle : { descriptorHeaps[0], descriptorHeaps[1], rootSignature, shadowPipelineState, deferredGeometryPipelineState, shadowDepthView,
+		depthStencilView, gBufferViews[0], gBufferViews[1], gBufferViews[2], gBufferViews[3] })
+	{
+		backend.ReleaseObject(handle);
+	}
+}
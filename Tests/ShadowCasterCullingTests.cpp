@@ -0,0 +1,161 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Scene/FrustumCulling.hpp"
+#include "Scene/ShadowCasterCulling.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Shadow caster culling";
+}
+
+bool VerifyShadowCasterCulling()
+{
+	// A directional light at (0, 100, 0) looking down -Y, with an orthographic projection of half extent 50 and depth range [1, 200] (same as
+	// XMMatrixLookToLH with an up direction of +Z followed by XMMatrixOrthographicLH(100, 100, 1, 200)).
+	scene::ShadowCasterCullingDesc shadowCasterCullingDesc
+	{
+		.lightViewProjectionMatrix =
+		{
+			0.02f, 0.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, -1.0f / 199.0f, 0.0f,
+			0.0f, 0.02f, 0.0f, 0.0f,
+			0.0f, 0.0f, 99.0f / 199.0f, 1.0f,
+		},
+		.lightDirection = { 0.0f, -1.0f, 0.0f },
+		.cameraViewProjectionMatrix = scene::CreatePerspectiveMatrix(0.785398f, 16.0f / 9.0f, 0.1f, 100.0f),
+	};
+
+	// Hand written cases, for casters of half extent 1, with the expected visibility without and with receiver bounds ([-5, 5] x [-1, 1] x [5, 15]).
+	struct ShadowCasterCullingCase
+	{
+		const char* name{};
+		scene::Float3 center{};
+		bool isVisible{};
+		bool isVisibleWithReceiverBounds{};
+	};
+
+	static constexpr std::array<ShadowCasterCullingCase, 7u> SHADOW_CASTER_CULLING_CASES
+	{
+		ShadowCasterCullingCase{ "Above the receivers", { 0.0f, 20.0f, 10.0f }, true, true },
+		ShadowCasterCullingCase{ "Outside of the light frustum", { 80.0f, 20.0f, 10.0f }, false, false },
+		ShadowCasterCullingCase{ "Between the light and its near plane", { 0.0f, 150.0f, 10.0f }, true, true },
+		ShadowCasterCullingCase{ "Behind the camera", { 0.0f, 20.0f, -30.0f }, false, false },
+		ShadowCasterCullingCase{ "Beside the receivers", { 20.0f, 20.0f, 30.0f }, true, false },
+		ShadowCasterCullingCase{ "Below the camera frustum", { 0.0f, -20.0f, 10.0f }, false, false },
+		ShadowCasterCullingCase{ "Below the receivers", { 0.0f, -3.0f, 10.0f }, true, false },
+	};
+
+	scene::BoundingBoxSoA casterBoundingBoxes{};
+	casterBoundingBoxes.Resize(static_cast<uint32_t>(SHADOW_CASTER_CULLING_CASES.size()));
+
+	for (uint32_t i = 0u; i < static_cast<uint32_t>(SHADOW_CASTER_CULLING_CASES.size()); ++i)
+	{
+		const scene::Float3& center = SHADOW_CASTER_CULLING_CASES[i].center;
+		casterBoundingBoxes.Set(i, scene::BoundingBox{ .minimum = { center[0] - 1.0f, center[1] - 1.0f, center[2] - 1.0f }, .maximum = { center[0] + 1.0f, center[1] + 1.0f, center[2] + 1.0f } });
+	}
+
+	for (const bool hasReceiverBounds : { false, true })
+	{
+		shadowCasterCullingDesc.receiverBounds = hasReceiverBounds ? std::optional{ scene::BoundingBox{ .minimum = { -5.0f, -1.0f, 5.0f }, .maximum = { 5.0f, 1.0f, 15.0f } } } : std::nullopt;
+
+		for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+		{
+			if (!scene::IsCullingImplementationSupported(cullingImplementation))
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> visibility(SHADOW_CASTER_CULLING_CASES.size());
+			const scene::ShadowCasterCullingStatistics statistics = scene::CullShadowCasters(shadowCasterCullingDesc, casterBoundingBoxes, visibility, cullingImplementation);
+
+			uint32_t expectedVisibleCount{};
+			for (size_t i = 0u; i < SHADOW_CASTER_CULLING_CASES.size(); ++i)
+			{
+				const bool isVisible = hasReceiverBounds ? SHADOW_CASTER_CULLING_CASES[i].isVisibleWithReceiverBounds : SHADOW_CASTER_CULLING_CASES[i].isVisible;
+				expectedVisibleCount += isVisible ? 1u : 0u;
+
+				if (!Expect(SUITE_NAME, (visibility[i] != 0u) == isVisible, SHADOW_CASTER_CULLING_CASES[i].name, isVisible ? "the caster to be rendered" : "the caster to be culled"))
+				{
+					return false;
+				}
+			}
+
+			if (!Expect(SUITE_NAME, statistics.casterCount == SHADOW_CASTER_CULLING_CASES.size() && statistics.outsideLightFrustumCount == 1u &&
+				statistics.visibleCount == expectedVisibleCount &&
+				statistics.outsideLightFrustumCount + statistics.noVisibleReceiverCount + statistics.visibleCount == statistics.casterCount,
+				"Shadow caster statistics", "the culled counts to add up to the caster count"))
+			{
+				return false;
+			}
+		}
+	}
+
+	// The bounds of the visible boxes only.
+	{
+		scene::BoundingBoxSoA boundingBoxes{};
+		boundingBoxes.Resize(3u);
+		boundingBoxes.Set(0u, scene::BoundingBox{ .minimum = { -1.0f, 0.0f, 0.0f }, .maximum = { 1.0f, 2.0f, 3.0f } });
+		boundingBoxes.Set(1u, scene::BoundingBox{ .minimum = { 100.0f, 100.0f, 100.0f }, .maximum = { 101.0f, 101.0f, 101.0f } });
+		boundingBoxes.Set(2u, scene::BoundingBox{ .minimum = { 0.0f, -4.0f, 1.0f }, .maximum = { 5.0f, 1.0f, 2.0f } });
+
+		const std::array<uint8_t, 3u> visibility{ 1u, 0u, 1u };
+		const std::optional<scene::BoundingBox> visibleBounds = scene::ComputeVisibleBounds(boundingBoxes, visibility);
+		const std::array<uint8_t, 3u> noVisibility{};
+
+		if (!Expect(SUITE_NAME, visibleBounds.has_value() && visibleBounds->minimum == scene::Float3{ -1.0f, -4.0f, 0.0f } && visibleBounds->maximum == scene::Float3{ 5.0f, 2.0f, 3.0f },
+			"Visible bounds", "the bounds of the visible boxes") ||
+			!Expect(SUITE_NAME, !scene::ComputeVisibleBounds(boundingBoxes, noVisibility).has_value(), "Visible bounds", "no bounds if no box is visible"))
+		{
+			return false;
+		}
+	}
+
+	// The SIMD implementations must match the scalar one exactly, with the receivers being the random boxes visible from the camera.
+	std::mt19937 randomEngine(7u);
+
+	for (const uint32_t count : { 1u, 7u, 9u, 1000u, 10007u })
+	{
+		scene::BoundingBoxSoA boundingBoxes{};
+		scene::BoundingSphereSoA boundingSpheres{};
+		CreateRandomBounds(count, randomEngine, boundingBoxes, boundingSpheres);
+
+		std::vector<uint8_t> receiverVisibility(count);
+		scene::CullBoundingBoxes(scene::ExtractFrustum(shadowCasterCullingDesc.cameraViewProjectionMatrix), boundingBoxes, receiverVisibility);
+		shadowCasterCullingDesc.receiverBounds = scene::ComputeVisibleBounds(boundingBoxes, receiverVisibility);
+
+		std::vector<uint8_t> referenceVisibility(count);
+		const scene::ShadowCasterCullingStatistics referenceStatistics = scene::CullShadowCasters(shadowCasterCullingDesc, boundingBoxes, referenceVisibility,
+			scene::CullingImplementation::Scalar);
+
+		for (const scene::CullingImplementation cullingImplementation : CULLING_IMPLEMENTATIONS)
+		{
+			if (!scene::IsCullingImplementationSupported(cullingImplementation))
+			{
+				continue;
+			}
+
+			std::vector<uint8_t> visibility(count);
+			const scene::ShadowCasterCullingStatistics statistics = scene::CullShadowCasters(shadowCasterCullingDesc, boundingBoxes, visibility, cullingImplementation);
+
+			if (!Expect(SUITE_NAME, statistics.visibleCount == referenceStatistics.visibleCount && statistics.noVisibleReceiverCount == referenceStatistics.noVisibleReceiverCount &&
+				visibility == referenceVisibility, scene::CullingImplementationToString(cullingImplementation), "the same shadow caster visibility as the scalar implementation"))
+			{
+				return false;
+			}
+		}
+	}
+
+	std::printf("Shadow caster culling : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,99 @@
+#include "TestSuites.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Graphics/API/SinglePassDownsampler.hpp"
+
+using namespace helios;
+
+namespace
+{
+	gfx::DownsampleImage CreateRandomImage(uint32_t width, uint32_t height, std::mt19937& randomEngine)
+	{
+		std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+		gfx::DownsampleImage image
+		{
+			.width = width,
+			.height = height,
+			.texels = std::vector<gfx::DownsampleTexel>(static_cast<size_t>(width) * height),
+		};
+
+		for (gfx::DownsampleTexel& texel : image.texels)
+		{
+			texel = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+		}
+
+		return image;
+	}
+}
+
+bool VerifySinglePassDownsampler()
+{
+	std::vector<std::pair<uint32_t, uint32_t>> sizes{};
+
+	// All combinations of small sizes cover every odd / even pattern of the group mips, and the single tile / multiple tiles cases.
+	for (uint32_t width = 1u; width <= 67u; width += 3u)
+	{
+		for (uint32_t height = 1u; height <= 67u; height += 5u)
+		{
+			sizes.emplace_back(width, height);
+		}
+	}
+
+	// Sizes with mips generated by the last group only, and the largest supported dimension (kept thin, so the verification runs quickly).
+	sizes.insert(sizes.end(), { {128u, 128u}, {129u, 257u}, {1920u, 1080u}, {1u, 4096u}, {2049u, 65u}, {4096u, 97u} });
+
+	std::mt19937 randomEngine(42u);
+
+	uint64_t runCount{};
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	for (const auto& [width, height] : sizes)
+	{
+		const gfx::DownsampleImage source = CreateRandomImage(width, height, randomEngine);
+
+		// Generates the entire mip chain, as the mip map generator does.
+		const uint32_t mipLevels = static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+		const uint32_t mipCount = gfx::GetDownsampleMipCount(mipLevels);
+
+		if (mipCount == 0u)
+		{
+			continue;
+		}
+
+		for (const gfx::DownsampleReduction reduction : { gfx::DownsampleReduction::Average, gfx::DownsampleReduction::Min, gfx::DownsampleReduction::Max, gfx::DownsampleReduction::MinMax })
+		{
+			const std::vector<gfx::DownsampleImage> referenceMips = gfx::DownsampleReference(source, mipCount, reduction);
+			const std::vector<gfx::DownsampleImage> emulatedMips = gfx::EmulateSinglePassDownsample(source, mipCount, reduction);
+
+			for (uint32_t mip = 0u; mip < mipCount; ++mip)
+			{
+				const gfx::DownsampleImage& referenceMip = referenceMips[mip];
+				const gfx::DownsampleImage& emulatedMip = emulatedMips[mip];
+
+				if (emulatedMip.width != referenceMip.width || emulatedMip.height != referenceMip.height ||
+					std::memcmp(emulatedMip.texels.data(), referenceMip.texels.data(), referenceMip.texels.size() * sizeof(gfx::DownsampleTexel)) != 0)
+				{
+					std::printf("Single pass downsampler : mismatch for %u x %u, reduction %s, mip %u\n", width, height, gfx::DownsampleReductionToString(reduction), mip + 1u);
+					return false;
+				}
+			}
+
+			runCount++;
+		}
+	}
+
+	const double verificationTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	std::printf("Single pass downsampler : %llu runs match the reference (%.1f ms)\n", static_cast<unsigned long long>(runCount), verificationTime);
+
+	return true;
+}
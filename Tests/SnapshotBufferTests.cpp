@@ -0,0 +1,149 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Core/SnapshotBuffer.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Snapshot buffer";
+
+	// Every value is the sequence number of the snapshot, so a snapshot written to while it is read (or only partially written) is detected.
+	struct TestSnapshot
+	{
+		uint64_t sequence{};
+		std::vector<uint64_t> values{};
+
+		bool IsConsistent() const
+		{
+			return std::all_of(values.begin(), values.end(), [&](uint64_t value) { return value == sequence; });
+		}
+	};
+
+	void WriteSnapshot(TestSnapshot& snapshot, uint64_t sequence, size_t valueCount)
+	{
+		snapshot.sequence = sequence;
+		snapshot.values.assign(valueCount, sequence);
+	}
+}
+
+bool VerifySnapshotBuffer()
+{
+	// Single thread : nothing to acquire before the first publish, the latest published snapshot is acquired, and acquiring again without a publish returns it again.
+	{
+		core::SnapshotBuffer<TestSnapshot> snapshotBuffer{};
+
+		const bool isEmptyBeforePublish = snapshotBuffer.Acquire() == nullptr && snapshotBuffer.GetAcquiredSequence() == 0u;
+
+		for (uint64_t sequence = 1u; sequence <= 3u; ++sequence)
+		{
+			WriteSnapshot(snapshotBuffer.GetWriteSnapshot(), sequence, 4u);
+			if (!Expect(SUITE_NAME, snapshotBuffer.Publish() == sequence, "Single thread", "the publish sequence numbers starting at 1"))
+			{
+				return false;
+			}
+		}
+
+		const TestSnapshot* snapshot = snapshotBuffer.Acquire();
+		const TestSnapshot* snapshotAcquiredAgain = snapshotBuffer.Acquire();
+
+		if (!Expect(SUITE_NAME, isEmptyBeforePublish, "Single thread", "no snapshot before the first publish") ||
+			!Expect(SUITE_NAME, snapshot != nullptr && snapshot->sequence == 3u && snapshot->IsConsistent() && snapshotBuffer.GetAcquiredSequence() == 3u, "Single thread",
+				"the latest snapshot acquired, skipping the older ones") ||
+			!Expect(SUITE_NAME, snapshotAcquiredAgain == snapshot, "Single thread", "the same snapshot acquired again while nothing new is published"))
+		{
+			return false;
+		}
+
+		// The write snapshot is never the acquired one.
+		WriteSnapshot(snapshotBuffer.GetWriteSnapshot(), 4u, 4u);
+		if (!Expect(SUITE_NAME, snapshot->sequence == 3u && snapshot->IsConsistent(), "Single thread", "the acquired snapshot unchanged by the producer's writes"))
+		{
+			return false;
+		}
+	}
+
+	// Close : wakes up a consumer waiting for a new snapshot, and makes further waits return false.
+	{
+		core::SnapshotBuffer<TestSnapshot> snapshotBuffer{};
+
+		std::atomic<bool> waitResult{ true };
+		std::thread consumer([&]() { waitResult.store(snapshotBuffer.WaitForNewSnapshot()); });
+
+		snapshotBuffer.Close();
+		consumer.join();
+
+		if (!Expect(SUITE_NAME, !waitResult.load() && !snapshotBuffer.WaitForNewSnapshot(), "Close", "the waiting consumer woken up, and further waits returning false"))
+		{
+			return false;
+		}
+	}
+
+	// Producer and consumer threads : every acquired snapshot is complete and unmodified while it is read, sequences only increase, and the consumer acquires
+	// the last published snapshot before the buffer is closed.
+	{
+		static constexpr uint64_t PUBLISH_COUNT = 20'000u;
+		static constexpr size_t VALUE_COUNT = 64u;
+
+		core::SnapshotBuffer<TestSnapshot> snapshotBuffer{};
+
+		bool isSnapshotTorn{ false };
+		bool isSequenceOutOfOrder{ false };
+		uint64_t acquiredSnapshotCount{};
+		uint64_t lastAcquiredSequence{};
+
+		std::thread consumer([&]()
+		{
+			while (snapshotBuffer.WaitForNewSnapshot())
+			{
+				const TestSnapshot* snapshot = snapshotBuffer.Acquire();
+
+				isSequenceOutOfOrder = isSequenceOutOfOrder || snapshot->sequence <= lastAcquiredSequence || snapshot->sequence != snapshotBuffer.GetAcquiredSequence();
+
+				// Read the snapshot twice, to give the producer a chance to write into it if it could.
+				isSnapshotTorn = isSnapshotTorn || !snapshot->IsConsistent() || snapshot->values.size() != VALUE_COUNT;
+				std::this_thread::yield();
+				isSnapshotTorn = isSnapshotTorn || !snapshot->IsConsistent();
+
+				lastAcquiredSequence = snapshot->sequence;
+				acquiredSnapshotCount++;
+
+				if (lastAcquiredSequence == PUBLISH_COUNT)
+				{
+					break;
+				}
+			}
+		});
+
+		for (uint64_t sequence = 1u; sequence <= PUBLISH_COUNT; ++sequence)
+		{
+			WriteSnapshot(snapshotBuffer.GetWriteSnapshot(), sequence, VALUE_COUNT);
+			snapshotBuffer.Publish();
+		}
+
+		consumer.join();
+		snapshotBuffer.Close();
+
+		std::printf("Snapshot buffer : %llu snapshots published, %llu acquired\n", static_cast<unsigned long long>(PUBLISH_COUNT),
+			static_cast<unsigned long long>(acquiredSnapshotCount));
+
+		if (!Expect(SUITE_NAME, !isSnapshotTorn, "Producer and consumer", "no snapshot modified while acquired") ||
+			!Expect(SUITE_NAME, !isSequenceOutOfOrder, "Producer and consumer", "the acquired sequences strictly increasing") ||
+			!Expect(SUITE_NAME, lastAcquiredSequence == PUBLISH_COUNT, "Producer and consumer", "the last published snapshot acquired"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("Snapshot buffer : all cases are valid\n");
+
+	return true;
+}
@@ -0,0 +1,30 @@
+#include "TestSuites.hpp"
+
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+// Usage : HeliosTests [--benchmark] [name...]. Runs the test suites (or with --benchmark, the benchmarks) with the given names, or all of them if no name
+// is given. Returns a non zero exit code if a test suite failed.
+int main(int argc, char** argv)
+{
+	bool benchmark{};
+	std::vector<std::string_view> names{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument(argv[i]);
+
+		if (argument == "--benchmark")
+		{
+			benchmark = true;
+			continue;
+		}
+
+		names.push_back(argument);
+	}
+
+	const bool isValid = benchmark ? RunBenchmarks(names) : RunTestSuites(names);
+
+	return isValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
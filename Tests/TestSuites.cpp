@@ -0,0 +1,115 @@
+#include "TestSuites.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace
+{
+	// Note : The names are the names of the ctest tests (see Tests/CMakeLists.txt).
+	constexpr std::array<TestSuite, 23u> TEST_SUITES
+	{
+		TestSuite{ .name = "SinglePassDownsampler", .verify = VerifySinglePassDownsampler },
+		TestSuite{ .name = "RenderGraphCompiler", .verify = VerifyRenderGraphCompiler },
+		TestSuite{ .name = "ResourceStateTracker", .verify = VerifyResourceStateTracker },
+		TestSuite{ .name = "NullRenderBackend", .verify = VerifyNullRenderBackend },
+		TestSuite{ .name = "FrustumCulling", .verify = VerifyFrustumCulling },
+		TestSuite{ .name = "ShadowCasterCulling", .verify = VerifyShadowCasterCulling },
+		TestSuite{ .name = "BoundingVolumeHierarchy", .verify = VerifyBoundingVolumeHierarchy },
+		TestSuite{ .name = "OcclusionCulling", .verify = VerifyOcclusionCulling },
+		TestSuite{ .name = "IndirectDraws", .verify = VerifyIndirectDraws },
+		TestSuite{ .name = "CommandStream", .verify = VerifyCommandStream },
+		TestSuite{ .name = "HiZCulling", .verify = VerifyHiZCulling },
+		TestSuite{ .name = "DrawSorting", .verify = VerifyDrawSorting },
+		TestSuite{ .name = "TransientAliasing", .verify = VerifyTransientAliasing },
+		TestSuite{ .name = "MemoryStatistics", .verify = VerifyMemoryStatistics },
+		TestSuite{ .name = "DeferredExecutionQueue", .verify = VerifyDeferredExecutionQueue },
+		TestSuite{ .name = "TlsfAllocator", .verify = VerifyTlsfAllocator },
+		TestSuite{ .name = "ResidencyPolicy", .verify = VerifyResidencyPolicy },
+		TestSuite{ .name = "JobSystem", .verify = VerifyJobSystem },
+		TestSuite{ .name = "CommandAllocatorPool", .verify = VerifyCommandAllocatorPool },
+		TestSuite{ .name = "ConcurrentFreeList", .verify = VerifyConcurrentFreeList },
+		TestSuite{ .name = "FrameVersionRing", .verify = VerifyFrameVersionRing },
+		TestSuite{ .name = "QueueScheduler", .verify = VerifyQueueScheduler },
+		TestSuite{ .name = "SnapshotBuffer", .verify = VerifySnapshotBuffer },
+	};
+
+	constexpr std::array<Benchmark, 11u> BENCHMARKS
+	{
+		Benchmark{ .name = "RenderGraphCompiler", .run = BenchmarkRenderGraphCompiler },
+		Benchmark{ .name = "DepthBandwidthEstimate", .run = PrintDepthBandwidthEstimate },
+		Benchmark{ .name = "MipMapGenerationFlushes", .run = PrintMipMapGenerationFlushes },
+		Benchmark{ .name = "FrustumCulling", .run = BenchmarkFrustumCulling },
+		Benchmark{ .name = "BoundingVolumeHierarchy", .run = BenchmarkBoundingVolumeHierarchy },
+		Benchmark{ .name = "OcclusionCulling", .run = BenchmarkOcclusionCulling },
+		Benchmark{ .name = "IndirectDraws", .run = BenchmarkIndirectDraws },
+		Benchmark{ .name = "SceneRecording", .run = BenchmarkSceneRecording },
+		Benchmark{ .name = "DrawSorting", .run = BenchmarkDrawSorting },
+		Benchmark{ .name = "TlsfAllocator", .run = BenchmarkTlsfAllocator },
+		Benchmark{ .name = "JobSystem", .run = BenchmarkJobSystem },
+	};
+
+	// Returns false if a name is not the name of any of the entries.
+	template <typename T>
+	bool ValidateNames(std::span<const T> entries, std::span<const std::string_view> names)
+	{
+		bool areNamesValid{ true };
+		for (const std::string_view name : names)
+		{
+			if (std::none_of(entries.begin(), entries.end(), [&](const T& entry) { return name == entry.name; }))
+			{
+				std::printf("Unknown test suite : %.*s\n", static_cast<int>(name.size()), name.data());
+				areNamesValid = false;
+			}
+		}
+
+		return areNamesValid;
+	}
+
+	bool IsSelected(const char* name, std::span<const std::string_view> names)
+	{
+		return names.empty() || std::find(names.begin(), names.end(), name) != names.end();
+	}
+}
+
+std::span<const TestSuite> GetTestSuites()
+{
+	return TEST_SUITES;
+}
+
+std::span<const Benchmark> GetBenchmarks()
+{
+	return BENCHMARKS;
+}
+
+bool RunTestSuites(std::span<const std::string_view> names)
+{
+	bool isValid = ValidateNames(GetTestSuites(), names);
+
+	// All selected suites are run (rather than stopping at the first failure), so a single run reports every failing suite.
+	for (const TestSuite& testSuite : GetTestSuites())
+	{
+		if (IsSelected(testSuite.name, names) && !testSuite.verify())
+		{
+			std::printf("Test suite failed : %s\n", testSuite.name);
+			isValid = false;
+		}
+	}
+
+	return isValid;
+}
+
+bool RunBenchmarks(std::span<const std::string_view> names)
+{
+	const bool areNamesValid = ValidateNames(GetBenchmarks(), names);
+
+	for (const Benchmark& benchmark : GetBenchmarks())
+	{
+		if (IsSelected(benchmark.name, names))
+		{
+			benchmark.run();
+		}
+	}
+
+	return areNamesValid;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+// Verifies the CPU reference / emulations of GPU algorithms and the CPU side of the renderer headlessly, so they can be checked on any platform, i.e on the Linux build farm.
+// Each test suite prints its results and returns false on the first mismatch. ctest runs every suite on its own (HeliosTests <suite name>), and
+// SandBoxHeadless --verify / --benchmark runs all of them.
+#include <span>
+#include <string_view>
+
+struct TestSuite
+{
+	const char* name{};
+	bool (*verify)(){};
+};
+
+struct Benchmark
+{
+	const char* name{};
+	void (*run)(){};
+};
+
+std::span<const TestSuite> GetTestSuites();
+std::span<const Benchmark> GetBenchmarks();
+
+// Runs the test suites (or benchmarks) whose name is in names, or all of them if names is empty.
+// Returns false if a test suite failed, or if a name is not the name of any suite.
+bool RunTestSuites(std::span<const std::string_view> names = {});
+bool RunBenchmarks(std::span<const std::string_view> names = {});
+
+// Compares EmulateSinglePassDownsample (the indexing of SinglePassDownsampleCS.hlsl) with DownsampleReference bit for bit, for all reductions
+// and odd / even / non square sizes (including the ones requiring the last thread group to fix up the last row / column of mips).
+bool VerifySinglePassDownsampler();
+
+// Checks the culling, barrier placement, queue selection and grouping of CompileRenderGraph on hand written graphs (including the SandBox frame),
+// and validates (see ValidateCompiledRenderGraph) the compilation of random graphs with all combinations of options.
+bool VerifyRenderGraphCompiler();
+
+// Prints the compile time (average and 95th percentile) of random graphs of 128 to 1024 passes (HeliosTests --benchmark).
+void BenchmarkRenderGraphCompiler();
+
+// Prints an estimate of the memory traffic saved by depth testing the lights / sky box against a read only view of the depth buffer (instead of a copy of it),
+// and of the traffic of the depth pre-pass for a few amounts of overdraw. Computed from the formats / passes of the SandBox, nothing is measured.
+void PrintDepthBandwidthEstimate();
+
+// Prints the compute queue flushes (CPU waits) of generating the mips of the textures of each model in Assets/Models : one per dispatch before the textures
+// of a model were batched, and one per batch since (see MipMapGenerationFlushes). Computed from the dimensions of the images, nothing is measured.
+void PrintMipMapGenerationFlushes();
+
+// Checks the barriers recorded by the resource state tracking of the command streams (redundant / merged / split / per subresource transitions), and their
+// resolution on submission (with the transitions the compute queue cannot execute routed to the graphics queue), and executes them on the null render
+// backend, which validates the states of the resources.
+bool VerifyResourceStateTracker();
+
+// Checks the validation of the null render backend : handles that are released, null or of the wrong object type, waits on fence values not submitted yet
+// (or recorded for another queue), and transitions from the wrong state, split transitions not ended (or in flight) and transitions of all subresources.
+bool VerifyNullRenderBackend();
+
+// Checks the visibility of boxes / spheres inside, outside and straddling each plane of a camera frustum, the transformation of the bounds, and that the SIMD
+// implementations match the scalar one exactly on random bounds.
+bool VerifyFrustumCulling();
+
+// Prints the time taken to cull 100k boxes / spheres with each supported implementation (HeliosTests --benchmark).
+void BenchmarkFrustumCulling();
+
+// Checks that casters outside of the light frustum, or whose shadow cannot land on a visible receiver, are culled (and that casters between the light and
+// the near plane of its frustum are not), and that the SIMD implementations match the scalar one exactly on random casters.
+bool VerifyShadowCasterCulling();
+
+// Checks the ray / sphere box tests, and that the convex volume, sphere and ray queries of hierarchies of 0 to 40k random boxes (built serially and in
+// parallel) match brute force, before and after moving a quarter of the boxes and refitting.
+bool VerifyBoundingVolumeHierarchy();
+
+// Prints the build (serial / parallel) and refit times of hierarchies of 10k to 1M boxes, and the time taken by their queries against linear scans.
+void BenchmarkBoundingVolumeHierarchy();
+
+// Checks the occlusion of boxes behind / beside / in front of walls and a floor crossing the near plane, that the depth bounds and the culled boxes of random
+// scenes are conservative compared to a per pixel depth buffer, and that the SIMD implementations rasterize and cull exactly as the scalar one.
+bool VerifyOcclusionCulling();
+
+// Prints the cull rate and the time taken to render the occluders / test the props of a Sponza like interior along a few camera paths, with each supported
+// implementation (HeliosTests --benchmark).
+void BenchmarkOcclusionCulling();
+
+// Checks the layout of the arguments / draw data built by IndirectDrawStream, that the command streams do not filter the root constants / index buffer set
+// after an ExecuteIndirect (which changes them), the commands recorded by RecordIndirectDraws, and the validation of ExecuteIndirect by the null render backend.
+bool VerifyIndirectDraws();
+
+// Checks the filtering of repeated state commands and of empty draws / dispatches, the storage of the root constants, the growth of a stream past CHUNK_SIZE
+// (and its reuse after Clear), the recording of separate streams from several threads at once, and the batching of the barriers before the next work command.
+bool VerifyCommandStream();
+
+// Prints the CPU time taken to record 10k draws one by one (as Model::RenderMesh), and to build them into an IndirectDrawStream, copy it into upload memory and
+// record a single ExecuteIndirect (HeliosTests --benchmark).
+void BenchmarkIndirectDraws();
+
+// Prints the CPU time taken to build the draw packets of the shadow / deferred geometry passes of a Sponza like model replicated 10 times, and to record
+// them in parallel (see SceneVisibility::RecordInParallel) with 1, 4 and 8 recording threads (HeliosTests --benchmark).
+void BenchmarkSceneRecording();
+
+// Checks that every texel of the Hi-Z pyramid holds the depth range of the pixels mapped to it, the mip selected for random rects, the occlusion of boxes
+// behind / beside / in front of a wall, that the boxes culled in random scenes are occluded in a per pixel depth buffer, and that the two phase culling along
+// a camera path draws every draw that shows exactly once.
+bool VerifyHiZCulling();
+
+// Checks the fields and order of the draw sort keys (front to back, with negative depths sorted as 0), the depth of bounds, that the radix sorts match
+// std::stable_sort exactly for 0 to 250k packets, and the state changes counted for sorted packets.
+bool VerifyDrawSorting();
+
+// Prints the time taken to key and sort 100k draws with each implementation, and the state changes / commands recorded for them unsorted and sorted
+// (HeliosTests --benchmark).
+void BenchmarkDrawSorting();
+
+// Checks that the placements of transient resources never share memory between resources alive at the same time (including lifetimes sharing a single pass),
+// respect the alignment of the resources, reuse the memory of dead resources, and that the validation rejects invalid placements. Prints the memory savings
+// report of the SandBox frame.
+bool VerifyTransientAliasing();
+
+// Checks the aggregation per category of the allocations registered by a fake allocator, the lifetime of the registrations (including handles outliving the
+// statistics), the fragmentation of the blocks as allocations are freed, concurrent registration, and the json export.
+bool VerifyMemoryStatistics();
+
+// Simulates the fences of the command queues over frames with a few frames of latency, and checks that the deferred functions are held until their fences
+// complete, released in fence order (including releases pushed by releases), and that the queue is drained on shutdown.
+bool VerifyDeferredExecutionQueue();
+
+// Checks the capacity, alignment and coalescing of the TLSF allocator on hand written cases, and that its invariants hold (valid bins / physical chain, live
+// allocations aligned and disjoint, valid defragmentation hints, a single free block once everything is freed) after every operation of random workloads.
+bool VerifyTlsfAllocator();
+
+// Prints the time per allocation / free of the TLSF allocator against a best fit allocator (as the default block metadata of D3D12MA before it used TLSF), and
+// the allocations failing / free ranges left by each, for random workloads (HeliosTests --benchmark).
+void BenchmarkTlsfAllocator();
+
+// Checks that resources used by the frames in flight, or never used, are not evicted, and replays traces (a working set fitting in the budget, a level
+// streamed through, and a working set larger than the budget) with SimulateResidencyTrace, printing their churn and budget compliance.
+bool VerifyResidencyPolicy();
+
+// Stress tests the job system with 1 to 8 workers : nested fork / join, ParallelFor coverage, chains of dependent jobs, tasks scheduled and waited on from
+// several threads that are not workers, and the execution of the jobs still queued on shutdown.
+bool VerifyJobSystem();
+
+// Prints the time taken by ParallelFor over 100k elements and by 32k empty jobs, for 1 worker up to one worker per hardware thread
+// (HeliosTests --benchmark).
+void BenchmarkJobSystem();
+
+// Checks against simulated fences that the batches of command allocators (used by a thread in a frame) are only reused, and reset, once the fence value of
+// their frame completes, that no batch is retired while a command list is not submitted, and that command lists acquired and submitted by different
+// threads never share an allocator or reset one in flight.
+bool VerifyCommandAllocatorPool();
+
+// Checks that the lock free free list (recycling the command lists) pops every pushed value exactly once, from a single thread and from 8 threads pushing
+// and popping concurrently, and that it rejects pushes over its capacity and reuses the nodes of popped values.
+bool VerifyConcurrentFreeList();
+
+// Checks against a simulated fence that constant buffer versions are never written while a frame in flight reads them, with buffers written several
+// times in some frames and not at all in others, and that every frame reads the data last written before its submission.
+bool VerifyFrameVersionRing();
+
+// Checks the cross queue waits against simulated queues : same queue and completed dependencies are skipped, waits implied by earlier (or transitive)
+// waits are not repeated, and random submissions have every dependency satisfied without a redundant wait.
+bool VerifyQueueScheduler();
+
+// Checks the snapshot handoff between a producer and a consumer thread : the latest snapshot is acquired, no acquired snapshot is written to while
+// it is read, sequences only increase, and closing wakes up a waiting consumer.
+bool VerifySnapshotBuffer();
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "TestSupport.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace helios;
+
+bool Expect(const char* suiteName, bool condition, const char* caseName, const char* expectation)
+{
+	if (!condition)
+	{
+		std::printf("%s : %s : expected %s\n", suiteName, caseName, expectation);
+	}
+
+	return condition;
+}
+
+scene::Matrix4x4 CreateWalkthroughViewMatrix(const scene::Float3& position, float yaw)
+{
+	const float sinYaw = std::sin(yaw);
+	const float cosYaw = std::cos(yaw);
+
+	return scene::Matrix4x4
+	{
+		cosYaw, 0.0f, sinYaw, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		-sinYaw, 0.0f, cosYaw, 0.0f,
+		-(cosYaw * position[0] - sinYaw * position[2]), -position[1], -(sinYaw * position[0] + cosYaw * position[2]), 1.0f,
+	};
+}
+
+scene::BoundingBox CreateCenteredBox(const scene::Float3& center, const scene::Float3& extent)
+{
+	return scene::BoundingBox
+	{
+		.minimum = { center[0] - extent[0], center[1] - extent[1], center[2] - extent[2] },
+		.maximum = { center[0] + extent[0], center[1] + extent[1], center[2] + extent[2] },
+	};
+}
+
+void CreateRandomBounds(uint32_t count, std::mt19937& randomEngine, scene::BoundingBoxSoA& boundingBoxes, scene::BoundingSphereSoA& boundingSpheres)
+{
+	std::uniform_real_distribution<float> positionDistribution(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> sizeDistribution(0.1f, 8.0f);
+
+	boundingBoxes.Resize(count);
+	boundingSpheres.Resize(count);
+
+	for (uint32_t i = 0u; i < count; ++i)
+	{
+		const scene::Float3 center{ positionDistribution(randomEngine), positionDistribution(randomEngine) * 0.25f, positionDistribution(randomEngine) };
+		const scene::Float3 extent{ sizeDistribution(randomEngine), sizeDistribution(randomEngine), sizeDistribution(randomEngine) };
+
+		boundingBoxes.Set(i, scene::BoundingBox
+		{
+			.minimum = { center[0] - extent[0], center[1] - extent[1], center[2] - extent[2] },
+			.maximum = { center[0] + extent[0], center[1] + extent[1], center[2] + extent[2] },
+		});
+
+		boundingSpheres.Set(i, scene::BoundingSphere{ .center = center, .radius = extent[0] });
+	}
+}
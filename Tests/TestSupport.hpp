@@ -0,0 +1,24 @@
+#pragma once
+
+// Helpers shared by the test suites (see TestSuites.hpp).
+#include <array>
+#include <cstdint>
+#include <random>
+
+#include "Scene/FrustumCulling.hpp"
+
+// Prints "<suite name> : <case name> : expected <expectation>" if the condition is false, and returns the condition.
+bool Expect(const char* suiteName, bool condition, const char* caseName, const char* expectation);
+
+// Same as XMMatrixLookToLH for a horizontal direction of angle yaw around +Y (0 looking down +Z).
+helios::scene::Matrix4x4 CreateWalkthroughViewMatrix(const helios::scene::Float3& position, float yaw);
+
+helios::scene::BoundingBox CreateCenteredBox(const helios::scene::Float3& center, const helios::scene::Float3& extent);
+
+// Boxes and spheres scattered around the camera (most of them outside of the frustum, some straddling its planes).
+void CreateRandomBounds(uint32_t count, std::mt19937& randomEngine, helios::scene::BoundingBoxSoA& boundingBoxes, helios::scene::BoundingSphereSoA& boundingSpheres);
+
+constexpr std::array<helios::scene::CullingImplementation, 3u> CULLING_IMPLEMENTATIONS
+{
+	helios::scene::CullingImplementation::Scalar, helios::scene::CullingImplementation::Sse, helios::scene::CullingImplementation::Avx,
+};
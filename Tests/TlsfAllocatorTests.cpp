@@ -0,0 +1,456 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Graphics/API/TlsfAllocator.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "TLSF allocator";
+
+	constexpr uint64_t MB = 1024u * 1024u;
+
+	constexpr std::array<uint64_t, 4u> ALIGNMENTS{ 1u, 256u, 4096u, 64u * 1024u };
+
+	struct LiveAllocation
+	{
+		gfx::TlsfAllocation allocation{};
+		uint64_t requestedSizeInBytes{};
+		uint64_t alignment{};
+	};
+
+	// Sizes of placed resources : mostly small buffers / textures, with a few large render targets.
+	uint64_t GetRandomSize(std::mt19937& randomEngine)
+	{
+		switch (randomEngine() % 8u)
+		{
+		case 0u:
+		{
+			return 1u + randomEngine() % (16u * MB);
+		}break;
+
+		case 1u:
+		case 2u:
+		{
+			return 1u + randomEngine() % MB;
+		}break;
+
+		default:
+		{
+			return 1u + randomEngine() % (64u * 1024u);
+		}break;
+		}
+	}
+
+	// Checks the requested ranges of the live allocations are within the capacity, aligned, and do not overlap.
+	bool AreAllocationsDisjoint(std::vector<LiveAllocation> liveAllocations, uint64_t capacityInBytes)
+	{
+		std::sort(liveAllocations.begin(), liveAllocations.end(), [](const LiveAllocation& a, const LiveAllocation& b) { return a.allocation.offset < b.allocation.offset; });
+
+		uint64_t previousEnd{};
+		for (const LiveAllocation& liveAllocation : liveAllocations)
+		{
+			const gfx::TlsfAllocation& allocation = liveAllocation.allocation;
+			if (allocation.offset < previousEnd || allocation.offset % liveAllocation.alignment != 0u || allocation.sizeInBytes < liveAllocation.requestedSizeInBytes ||
+				allocation.offset + allocation.sizeInBytes > capacityInBytes)
+			{
+				return false;
+			}
+
+			previousEnd = allocation.offset + allocation.sizeInBytes;
+		}
+
+		return true;
+	}
+
+	// Checks the moves of the defragmentation hints only move allocations towards offset 0, keep them aligned, and leave no two allocations overlapping.
+	bool AreDefragmentationHintsValid(const gfx::TlsfAllocator& allocator, const std::vector<LiveAllocation>& liveAllocations)
+	{
+		std::vector<LiveAllocation> compactedAllocations = liveAllocations;
+
+		for (const gfx::TlsfDefragmentationMove& move : allocator.GetDefragmentationHints())
+		{
+			const auto it = std::find_if(compactedAllocations.begin(), compactedAllocations.end(), [&](const LiveAllocation& liveAllocation)
+			{
+				return liveAllocation.allocation.nodeIndex == move.nodeIndex;
+			});
+
+			if (it == compactedAllocations.end() || it->allocation.offset != move.currentOffset || move.targetOffset >= move.currentOffset)
+			{
+				return false;
+			}
+
+			// The size of the move includes the padding the allocation may have taken over from its neighbours.
+			it->allocation.offset = move.targetOffset;
+			it->allocation.sizeInBytes = move.sizeInBytes;
+		}
+
+		return AreAllocationsDisjoint(compactedAllocations, allocator.GetCapacity());
+	}
+
+	// Stands in for the default block metadata of D3D12MA (before it switched to TLSF) : free ranges are kept in a map sorted by offset (for coalescing) and a
+	// multimap sorted by size, and the smallest free range that fits the aligned allocation is chosen (best fit).
+	class BestFitAllocator
+	{
+	public:
+		explicit BestFitAllocator(uint64_t capacityInBytes)
+		{
+			InsertFreeRange(0u, capacityInBytes);
+		}
+
+		std::optional<uint64_t> Allocate(uint64_t sizeInBytes, uint64_t alignment)
+		{
+			for (auto it = mFreeRangesBySize.lower_bound(sizeInBytes); it != mFreeRangesBySize.end(); ++it)
+			{
+				const uint64_t rangeOffset = it->second;
+				const uint64_t rangeSize = it->first;
+				const uint64_t alignedOffset = (rangeOffset + alignment - 1u) / alignment * alignment;
+
+				if (alignedOffset + sizeInBytes > rangeOffset + rangeSize)
+				{
+					continue;
+				}
+
+				mFreeRangesBySize.erase(it);
+				mFreeRangesByOffset.erase(rangeOffset);
+
+				if (alignedOffset > rangeOffset)
+				{
+					InsertFreeRange(rangeOffset, alignedOffset - rangeOffset);
+				}
+
+				if (alignedOffset + sizeInBytes < rangeOffset + rangeSize)
+				{
+					InsertFreeRange(alignedOffset + sizeInBytes, rangeOffset + rangeSize - alignedOffset - sizeInBytes);
+				}
+
+				return alignedOffset;
+			}
+
+			return std::nullopt;
+		}
+
+		void Free(uint64_t offset, uint64_t sizeInBytes)
+		{
+			// Merge with the next and previous free ranges.
+			const auto nextIt = mFreeRangesByOffset.find(offset + sizeInBytes);
+			if (nextIt != mFreeRangesByOffset.end())
+			{
+				sizeInBytes += nextIt->second;
+				EraseFreeRange(nextIt->first, nextIt->second);
+			}
+
+			const auto previousIt = mFreeRangesByOffset.lower_bound(offset);
+			if (previousIt != mFreeRangesByOffset.begin() && std::prev(previousIt)->first + std::prev(previousIt)->second == offset)
+			{
+				const auto [previousOffset, previousSize] = *std::prev(previousIt);
+
+				offset = previousOffset;
+				sizeInBytes += previousSize;
+				EraseFreeRange(previousOffset, previousSize);
+			}
+
+			InsertFreeRange(offset, sizeInBytes);
+		}
+
+		uint32_t GetFreeRangeCount() const { return static_cast<uint32_t>(mFreeRangesByOffset.size()); }
+
+	private:
+		void InsertFreeRange(uint64_t offset, uint64_t sizeInBytes)
+		{
+			mFreeRangesByOffset[offset] = sizeInBytes;
+			mFreeRangesBySize.insert({ sizeInBytes, offset });
+		}
+
+		void EraseFreeRange(uint64_t offset, uint64_t sizeInBytes)
+		{
+			mFreeRangesByOffset.erase(offset);
+
+			const auto [first, last] = mFreeRangesBySize.equal_range(sizeInBytes);
+			mFreeRangesBySize.erase(std::find_if(first, last, [&](const auto& freeRange) { return freeRange.second == offset; }));
+		}
+
+	private:
+		std::map<uint64_t, uint64_t> mFreeRangesByOffset{};
+		std::multimap<uint64_t, uint64_t> mFreeRangesBySize{};
+	};
+
+	// Operation of a workload replayed on both allocators : allocate (size, alignment), or free the live allocation at freeIndex (swapped with the last one).
+	struct AllocatorOperation
+	{
+		bool isAllocation{};
+		uint64_t sizeInBytes{};
+		uint64_t alignment{};
+		uint32_t freeIndex{};
+	};
+
+	// Allocations and frees in equal proportions, with the live allocations filling the capacity : most allocations have to reuse freed ranges.
+	std::vector<AllocatorOperation> CreateAllocatorWorkload(uint32_t operationCount, uint32_t maxLiveAllocationCount, std::mt19937& randomEngine)
+	{
+		std::vector<AllocatorOperation> operations{};
+		operations.reserve(operationCount);
+
+		uint32_t liveAllocationCount{};
+		for (uint32_t i = 0u; i < operationCount; ++i)
+		{
+			const bool isAllocation = liveAllocationCount == 0u || (liveAllocationCount < maxLiveAllocationCount && randomEngine() % 2u == 0u);
+			if (isAllocation)
+			{
+				operations.push_back({ .isAllocation = true, .sizeInBytes = 1u + randomEngine() % (256u * 1024u), .alignment = ALIGNMENTS[randomEngine() % ALIGNMENTS.size()] });
+				liveAllocationCount++;
+			}
+			else
+			{
+				operations.push_back({ .freeIndex = static_cast<uint32_t>(randomEngine() % liveAllocationCount) });
+				liveAllocationCount--;
+			}
+		}
+
+		return operations;
+	}
+}
+
+bool VerifyTlsfAllocator()
+{
+	// Hand written cases : the capacity is fully usable, alignment is respected, and freeing everything coalesces the range back into a single free block.
+	{
+		gfx::TlsfAllocator allocator(16u * MB);
+
+		const std::optional<gfx::TlsfAllocation> fullAllocation = allocator.Allocate(16u * MB);
+		if (!Expect(SUITE_NAME, fullAllocation.has_value() && fullAllocation->offset == 0u && !allocator.Allocate(1u).has_value(), "Full capacity",
+			"the whole capacity allocated, and no further allocation possible"))
+		{
+			return false;
+		}
+
+		allocator.Free(*fullAllocation);
+
+		const std::optional<gfx::TlsfAllocation> smallAllocation = allocator.Allocate(1000u);
+		const std::optional<gfx::TlsfAllocation> alignedAllocation = allocator.Allocate(4096u, 64u * 1024u);
+		if (!Expect(SUITE_NAME, !allocator.Allocate(17u * MB).has_value(), "Capacity", "no allocation larger than the capacity") ||
+			!Expect(SUITE_NAME, smallAllocation.has_value() && alignedAllocation.has_value() && alignedAllocation->offset == 64u * 1024u, "Alignment",
+				"the aligned allocation placed at the next multiple of its alignment") ||
+			!Expect(SUITE_NAME, allocator.GetStatistics().freeBlockCount == 2u, "Alignment", "the padding in front of the aligned allocation tracked as a free block"))
+		{
+			return false;
+		}
+
+		allocator.Free(*smallAllocation);
+		allocator.Free(*alignedAllocation);
+
+		const gfx::TlsfStatistics statistics = allocator.GetStatistics();
+		if (!Expect(SUITE_NAME, allocator.Validate() && statistics.freeBlockCount == 1u && statistics.largestFreeBlockBytes == 16u * MB && statistics.usedBytes == 0u,
+			"Coalescing", "a single free block of the whole capacity once everything is freed"))
+		{
+			return false;
+		}
+	}
+
+	// Randomized allocations / frees : the invariants of the allocator hold after every operation, the live allocations never overlap, the defragmentation
+	// hints are valid, and freeing everything always coalesces the range back into a single free block.
+	for (const uint32_t seed : { 1u, 2u, 3u, 4u })
+	{
+		static constexpr uint64_t CAPACITY_IN_BYTES = 64u * MB;
+		static constexpr uint32_t OPERATION_COUNT = 4000u;
+
+		std::mt19937 randomEngine(seed);
+		gfx::TlsfAllocator allocator(CAPACITY_IN_BYTES);
+		std::vector<LiveAllocation> liveAllocations{};
+		uint32_t failedAllocationCount{};
+
+		for (uint32_t operationIndex = 0u; operationIndex < OPERATION_COUNT; ++operationIndex)
+		{
+			// Favor allocations in the first half, and frees in the second half, so the allocator goes from empty to full and back.
+			const uint32_t allocationChance = operationIndex < OPERATION_COUNT / 2u ? 3u : 1u;
+			if (liveAllocations.empty() || randomEngine() % 4u < allocationChance)
+			{
+				const uint64_t sizeInBytes = GetRandomSize(randomEngine);
+				const uint64_t alignment = ALIGNMENTS[randomEngine() % ALIGNMENTS.size()];
+
+				if (const std::optional<gfx::TlsfAllocation> allocation = allocator.Allocate(sizeInBytes, alignment))
+				{
+					liveAllocations.push_back({ .allocation = *allocation, .requestedSizeInBytes = sizeInBytes, .alignment = alignment });
+				}
+				else
+				{
+					failedAllocationCount++;
+				}
+			}
+			else
+			{
+				const size_t freeIndex = randomEngine() % liveAllocations.size();
+				allocator.Free(liveAllocations[freeIndex].allocation);
+
+				liveAllocations[freeIndex] = liveAllocations.back();
+				liveAllocations.pop_back();
+			}
+
+			uint64_t requestedBytes{};
+			for (const LiveAllocation& liveAllocation : liveAllocations)
+			{
+				requestedBytes += liveAllocation.requestedSizeInBytes;
+			}
+
+			const gfx::TlsfStatistics statistics = allocator.GetStatistics();
+			if (!allocator.Validate() || statistics.allocationCount != liveAllocations.size() || statistics.usedBytes < requestedBytes ||
+				statistics.usedBytes > CAPACITY_IN_BYTES || !AreAllocationsDisjoint(liveAllocations, CAPACITY_IN_BYTES))
+			{
+				std::printf("TLSF allocator : seed %u, operation %u : expected the allocations to be valid and disjoint\n", seed, operationIndex);
+				return false;
+			}
+
+			if (operationIndex % 500u == 0u && !AreDefragmentationHintsValid(allocator, liveAllocations))
+			{
+				std::printf("TLSF allocator : seed %u, operation %u : expected valid defragmentation hints\n", seed, operationIndex);
+				return false;
+			}
+		}
+
+		for (const LiveAllocation& liveAllocation : liveAllocations)
+		{
+			allocator.Free(liveAllocation.allocation);
+		}
+
+		const gfx::TlsfStatistics statistics = allocator.GetStatistics();
+		if (!Expect(SUITE_NAME, failedAllocationCount > 0u, "Randomized", "some allocations failing once the allocator is full") ||
+			!Expect(SUITE_NAME, allocator.Validate() && allocator.IsEmpty() && statistics.freeBlockCount == 1u && statistics.largestFreeBlockBytes == CAPACITY_IN_BYTES,
+				"Randomized", "a single free block of the whole capacity once everything is freed"))
+		{
+			return false;
+		}
+	}
+
+	// Heap pool : blocks are created on demand (dedicated ones for allocations larger than the block size), and all but one empty block are destroyed.
+	{
+		std::mt19937 randomEngine(42u);
+
+		int32_t liveBlockCount{};
+		gfx::TlsfHeapPool heapPool(32u * MB, [&](uint32_t, uint64_t) { liveBlockCount++; }, [&](uint32_t, uint64_t) { liveBlockCount--; });
+
+		std::vector<gfx::TlsfHeapPoolAllocation> allocations{};
+		for (uint32_t i = 0u; i < 200u; ++i)
+		{
+			const uint64_t sizeInBytes = i % 50u == 0u ? 48u * MB : GetRandomSize(randomEngine);
+			if (const std::optional<gfx::TlsfHeapPoolAllocation> allocation = heapPool.Allocate(sizeInBytes, ALIGNMENTS[randomEngine() % ALIGNMENTS.size()]))
+			{
+				allocations.push_back(*allocation);
+			}
+		}
+
+		const bool isEveryAllocationPlaced = allocations.size() == 200u && liveBlockCount == static_cast<int32_t>(heapPool.GetBlockCount()) && liveBlockCount > 1;
+
+		std::shuffle(allocations.begin(), allocations.end(), randomEngine);
+		for (const gfx::TlsfHeapPoolAllocation& allocation : allocations)
+		{
+			heapPool.Free(allocation);
+		}
+
+		if (!Expect(SUITE_NAME, isEveryAllocationPlaced, "Heap pool", "every allocation placed, in blocks created through the callback") ||
+			!Expect(SUITE_NAME, liveBlockCount == 1 && heapPool.GetBlockCount() == 1u && heapPool.GetStatistics().usedBytes == 0u, "Heap pool",
+				"a single (empty) block retained once everything is freed"))
+		{
+			return false;
+		}
+	}
+
+	std::printf("TLSF allocator : all cases are valid\n");
+
+	return true;
+}
+
+void BenchmarkTlsfAllocator()
+{
+	static constexpr uint64_t CAPACITY_IN_BYTES = 256u * MB;
+	static constexpr uint32_t OPERATION_COUNT = 1'000'000u;
+
+	for (const uint32_t maxLiveAllocationCount : { 256u, 2048u })
+	{
+		std::mt19937 randomEngine(42u);
+		const std::vector<AllocatorOperation> operations = CreateAllocatorWorkload(OPERATION_COUNT, maxLiveAllocationCount, randomEngine);
+
+		// Failed allocations are kept in the live list (as std::nullopt), so both allocators replay exactly the same frees.
+		double tlsfTime{};
+		uint32_t tlsfFailedAllocationCount{};
+		uint32_t tlsfFreeBlockCount{};
+		{
+			gfx::TlsfAllocator allocator(CAPACITY_IN_BYTES);
+			std::vector<std::optional<gfx::TlsfAllocation>> liveAllocations{};
+
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			for (const AllocatorOperation& operation : operations)
+			{
+				if (operation.isAllocation)
+				{
+					liveAllocations.push_back(allocator.Allocate(operation.sizeInBytes, operation.alignment));
+					tlsfFailedAllocationCount += liveAllocations.back().has_value() ? 0u : 1u;
+				}
+				else
+				{
+					if (liveAllocations[operation.freeIndex])
+					{
+						allocator.Free(*liveAllocations[operation.freeIndex]);
+					}
+
+					liveAllocations[operation.freeIndex] = liveAllocations.back();
+					liveAllocations.pop_back();
+				}
+			}
+			tlsfTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+			tlsfFreeBlockCount = allocator.GetStatistics().freeBlockCount;
+		}
+
+		double bestFitTime{};
+		uint32_t bestFitFailedAllocationCount{};
+		uint32_t bestFitFreeRangeCount{};
+		{
+			struct BestFitAllocation
+			{
+				uint64_t offset{};
+				uint64_t sizeInBytes{};
+			};
+
+			BestFitAllocator allocator(CAPACITY_IN_BYTES);
+			std::vector<std::optional<BestFitAllocation>> liveAllocations{};
+
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			for (const AllocatorOperation& operation : operations)
+			{
+				if (operation.isAllocation)
+				{
+					const std::optional<uint64_t> offset = allocator.Allocate(operation.sizeInBytes, operation.alignment);
+					liveAllocations.push_back(offset ? std::optional<BestFitAllocation>({ .offset = *offset, .sizeInBytes = operation.sizeInBytes }) : std::nullopt);
+					bestFitFailedAllocationCount += offset.has_value() ? 0u : 1u;
+				}
+				else
+				{
+					if (liveAllocations[operation.freeIndex])
+					{
+						allocator.Free(liveAllocations[operation.freeIndex]->offset, liveAllocations[operation.freeIndex]->sizeInBytes);
+					}
+
+					liveAllocations[operation.freeIndex] = liveAllocations.back();
+					liveAllocations.pop_back();
+				}
+			}
+			bestFitTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+			bestFitFreeRangeCount = allocator.GetFreeRangeCount();
+		}
+
+		std::printf("TLSF allocator : %u operations, up to %u live allocations | TLSF %.1f ns / operation (%u failed, %u free blocks) | best fit %.1f ns / operation "
+			"(%u failed, %u free ranges) | %.2fx\n", OPERATION_COUNT, maxLiveAllocationCount, tlsfTime * 1e6 / OPERATION_COUNT, tlsfFailedAllocationCount, tlsfFreeBlockCount,
+			bestFitTime * 1e6 / OPERATION_COUNT, bestFitFailedAllocationCount, bestFitFreeRangeCount, bestFitTime / std::max(tlsfTime, 1e-9));
+	}
+}
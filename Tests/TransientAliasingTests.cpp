@@ -0,0 +1,212 @@
+#include "TestSuites.hpp"
+#include "TestSupport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Graphics/API/TransientAliasing.hpp"
+
+using namespace helios;
+
+namespace
+{
+	constexpr const char* SUITE_NAME = "Transient aliasing";
+
+	// Alignment of (non MSAA) textures placed in a heap.
+	constexpr uint64_t TEXTURE_ALIGNMENT = 64u * 1024u;
+
+	gfx::TransientResourceAliasingDesc CreateTextureDesc(const char* name, uint32_t width, uint32_t height, uint32_t bytesPerPixel, gfx::TransientResourceLifetime lifetime)
+	{
+		const uint64_t sizeInBytes = static_cast<uint64_t>(width) * height * bytesPerPixel;
+
+		return gfx::TransientResourceAliasingDesc
+		{
+			.name = name,
+			.sizeInBytes = (sizeInBytes + TEXTURE_ALIGNMENT - 1u) / TEXTURE_ALIGNMENT * TEXTURE_ALIGNMENT,
+			.alignment = TEXTURE_ALIGNMENT,
+			.lifetime = lifetime,
+		};
+	}
+
+	// The transient resources of the SandBox frame (see SandBox::SandBox), with the lifetimes given by the pass indices (shadow, deferred geometry, lighting,
+	// post process, final, copy to swap chain). The sizes are estimated from the formats, as the allocation info of the textures requires a device.
+	std::vector<gfx::TransientResourceAliasingDesc> CreateSandBoxFrameResources(uint32_t width, uint32_t height)
+	{
+		return std::vector<gfx::TransientResourceAliasingDesc>
+		{
+			CreateTextureDesc("Depth Stencil Texture", width, height, 4u, { 1u, 2u }),
+			CreateTextureDesc("Offscreen Render Texture", width, height, 8u, { 2u, 3u }),
+			CreateTextureDesc("Post Process Render Texture", width, height, 4u, { 3u, 4u }),
+			CreateTextureDesc("Final Render Texture", width, height, 4u, { 4u, 5u }),
+			CreateTextureDesc("Deferred Pass Albedo Texture", width, height, 4u, { 1u, 4u }),
+			CreateTextureDesc("Deferred Pass Position Emissive Texture", width, height, 8u, { 1u, 2u }),
+			CreateTextureDesc("Deferred Pass Normal Emissive Texture", width, height, 8u, { 1u, 2u }),
+			CreateTextureDesc("Deferred Pass AO Metal Roughness Emissive Texture", width, height, 8u, { 1u, 2u }),
+		};
+	}
+
+	bool AreMemoryRangesOverlapping(uint64_t offsetA, uint64_t sizeA, uint64_t offsetB, uint64_t sizeB)
+	{
+		return offsetA < offsetB + sizeB && offsetB < offsetA + sizeA;
+	}
+}
+
+bool VerifyTransientAliasing()
+{
+	// Resources alive at the same time never share memory, including when their lifetimes only share a pass (as lifetimes are inclusive).
+	{
+		const std::vector<gfx::TransientResourceAliasingDesc> resources
+		{
+			{ .name = "A", .sizeInBytes = 1000u, .alignment = 1u, .lifetime = { 0u, 2u } },
+			{ .name = "B", .sizeInBytes = 1000u, .alignment = 1u, .lifetime = { 2u, 3u } },
+		};
+
+		const gfx::TransientAliasingResult result = gfx::ComputeAliasedPlacements(resources);
+		if (!Expect(SUITE_NAME, !AreMemoryRangesOverlapping(result.offsets[0], 1000u, result.offsets[1], 1000u), "Lifetimes sharing a pass", "disjoint memory ranges") ||
+			!Expect(SUITE_NAME, result.heapSizeInBytes == 2000u && result.unaliasedSizeInBytes == 2000u, "Lifetimes sharing a pass", "a heap of the size of both resources") ||
+			!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(resources, result), "Lifetimes sharing a pass", "valid placements"))
+		{
+			return false;
+		}
+	}
+
+	// Resources whose lifetimes do not overlap are placed at the same offset, and the heap is as large as the largest one.
+	{
+		const std::vector<gfx::TransientResourceAliasingDesc> resources
+		{
+			{ .name = "A", .sizeInBytes = 4096u, .alignment = 256u, .lifetime = { 0u, 1u } },
+			{ .name = "B", .sizeInBytes = 8192u, .alignment = 256u, .lifetime = { 2u, 3u } },
+			{ .name = "C", .sizeInBytes = 2048u, .alignment = 256u, .lifetime = { 4u, 4u } },
+		};
+
+		const gfx::TransientAliasingResult result = gfx::ComputeAliasedPlacements(resources);
+		if (!Expect(SUITE_NAME, result.offsets == std::vector<uint64_t>{ 0u, 0u, 0u }, "Disjoint lifetimes", "all resources at offset 0") ||
+			!Expect(SUITE_NAME, result.heapSizeInBytes == 8192u && result.unaliasedSizeInBytes == 4096u + 8192u + 2048u, "Disjoint lifetimes", "a heap of the size of the largest resource") ||
+			!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(resources, result), "Disjoint lifetimes", "valid placements"))
+		{
+			return false;
+		}
+	}
+
+	// A resource placed after one of a smaller alignment starts at the next multiple of its own alignment, and the unaliased size counts the padding
+	// (which is larger than the size of the resources padded to their own alignment).
+	{
+		const std::vector<gfx::TransientResourceAliasingDesc> resources
+		{
+			{ .name = "Buffer", .sizeInBytes = 100000u, .alignment = 256u, .lifetime = { 0u, 3u } },
+			{ .name = "Texture", .sizeInBytes = 70000u, .alignment = TEXTURE_ALIGNMENT, .lifetime = { 1u, 2u } },
+		};
+
+		const gfx::TransientAliasingResult result = gfx::ComputeAliasedPlacements(resources);
+		if (!Expect(SUITE_NAME, result.offsets[0] == 0u && result.offsets[1] == 2u * TEXTURE_ALIGNMENT, "Mixed alignments", "the texture at the first 64 KB boundary after the buffer") ||
+			!Expect(SUITE_NAME, result.unaliasedSizeInBytes == 2u * TEXTURE_ALIGNMENT + 70000u, "Mixed alignments", "the unaliased size of the resources placed back to back") ||
+			!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(resources, result), "Mixed alignments", "valid placements"))
+		{
+			return false;
+		}
+	}
+
+	// First fit : a resource fills the gap left between two resources alive at the same time, once the resource that used it is dead.
+	{
+		const std::vector<gfx::TransientResourceAliasingDesc> resources
+		{
+			{ .name = "Long lived", .sizeInBytes = 3000u, .alignment = 1u, .lifetime = { 0u, 5u } },
+			{ .name = "Early", .sizeInBytes = 2000u, .alignment = 1u, .lifetime = { 0u, 1u } },
+			{ .name = "Long lived 2", .sizeInBytes = 1500u, .alignment = 1u, .lifetime = { 0u, 5u } },
+			{ .name = "Late", .sizeInBytes = 1000u, .alignment = 1u, .lifetime = { 3u, 4u } },
+		};
+
+		const gfx::TransientAliasingResult result = gfx::ComputeAliasedPlacements(resources);
+		if (!Expect(SUITE_NAME, result.offsets[3] == result.offsets[1], "Gap reuse", "the late resource in the memory of the early one") ||
+			!Expect(SUITE_NAME, result.heapSizeInBytes == 6500u, "Gap reuse", "a heap of the size of the resources alive in the first passes") ||
+			!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(resources, result), "Gap reuse", "valid placements"))
+		{
+			return false;
+		}
+	}
+
+	// The validation rejects memory shared by resources alive at the same time, misaligned offsets, and resources extending past the heap.
+	{
+		const std::vector<gfx::TransientResourceAliasingDesc> resources
+		{
+			{ .name = "A", .sizeInBytes = 1024u, .alignment = 512u, .lifetime = { 0u, 1u } },
+			{ .name = "B", .sizeInBytes = 1024u, .alignment = 512u, .lifetime = { 1u, 2u } },
+		};
+
+		const gfx::TransientAliasingResult overlappingResult{ .offsets = { 0u, 512u }, .heapSizeInBytes = 1536u };
+		const gfx::TransientAliasingResult misalignedResult{ .offsets = { 0u, 1280u }, .heapSizeInBytes = 2304u };
+		const gfx::TransientAliasingResult outOfHeapResult{ .offsets = { 0u, 1024u }, .heapSizeInBytes = 1536u };
+		const gfx::TransientAliasingResult validResult{ .offsets = { 0u, 1024u }, .heapSizeInBytes = 2048u };
+		const gfx::TransientAliasingResult missingOffsetResult{ .offsets = { 0u }, .heapSizeInBytes = 2048u };
+
+		if (!Expect(SUITE_NAME, !gfx::ValidateAliasedPlacements(resources, overlappingResult), "Validation", "overlapping memory of live resources to be rejected") ||
+			!Expect(SUITE_NAME, !gfx::ValidateAliasedPlacements(resources, misalignedResult), "Validation", "a misaligned offset to be rejected") ||
+			!Expect(SUITE_NAME, !gfx::ValidateAliasedPlacements(resources, outOfHeapResult), "Validation", "a resource past the end of the heap to be rejected") ||
+			!Expect(SUITE_NAME, !gfx::ValidateAliasedPlacements(resources, missingOffsetResult), "Validation", "a result without an offset per resource to be rejected") ||
+			!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(resources, validResult), "Validation", "disjoint aligned placements to be accepted"))
+		{
+			return false;
+		}
+	}
+
+	// Random resources : the placements are valid, and the heap is at least as large as the memory alive in any pass, and at most the unaliased size.
+	std::mt19937 randomEngine(42u);
+	std::uniform_int_distribution<uint64_t> sizeDistribution(1u, 8u * 1024u * 1024u);
+	std::uniform_int_distribution<uint32_t> alignmentDistribution(0u, 3u);
+	std::uniform_int_distribution<uint32_t> passDistribution(0u, 15u);
+
+	for (const uint32_t resourceCount : { 0u, 1u, 2u, 7u, 32u, 128u })
+	{
+		for (uint32_t iteration = 0u; iteration < 50u; ++iteration)
+		{
+			std::vector<gfx::TransientResourceAliasingDesc> resources(resourceCount);
+			for (gfx::TransientResourceAliasingDesc& resource : resources)
+			{
+				const uint32_t firstPass = passDistribution(randomEngine);
+				const uint32_t lastPass = passDistribution(randomEngine);
+
+				resource.sizeInBytes = sizeDistribution(randomEngine);
+				resource.alignment = std::array<uint64_t, 4u>{ 1u, 256u, 4096u, TEXTURE_ALIGNMENT }[alignmentDistribution(randomEngine)];
+				resource.lifetime = { std::min(firstPass, lastPass), std::max(firstPass, lastPass) };
+			}
+
+			const gfx::TransientAliasingResult result = gfx::ComputeAliasedPlacements(resources);
+
+			uint64_t maximumLiveSize{};
+			for (uint32_t pass = 0u; pass <= 15u; ++pass)
+			{
+				uint64_t liveSize{};
+				for (const gfx::TransientResourceAliasingDesc& resource : resources)
+				{
+					liveSize += resource.lifetime.firstPass <= pass && pass <= resource.lifetime.lastPass ? resource.sizeInBytes : 0u;
+				}
+
+				maximumLiveSize = std::max(maximumLiveSize, liveSize);
+			}
+
+			const std::string caseName = std::to_string(resourceCount) + " random resources";
+			if (!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(resources, result), caseName.c_str(), "valid placements") ||
+				!Expect(SUITE_NAME, result.heapSizeInBytes >= maximumLiveSize && result.heapSizeInBytes <= result.unaliasedSizeInBytes, caseName.c_str(),
+					"a heap between the memory alive in the busiest pass and the unaliased size"))
+			{
+				return false;
+			}
+		}
+	}
+
+	const std::vector<gfx::TransientResourceAliasingDesc> sandBoxResources = CreateSandBoxFrameResources(1920u, 1080u);
+	const gfx::TransientAliasingResult sandBoxResult = gfx::ComputeAliasedPlacements(sandBoxResources);
+	if (!Expect(SUITE_NAME, gfx::ValidateAliasedPlacements(sandBoxResources, sandBoxResult), "SandBox frame", "valid placements"))
+	{
+		return false;
+	}
+
+	std::printf("Transient aliasing : all cases are valid. SandBox frame at 1920x1080 :\n%s", gfx::GenerateMemorySavingsReport(sandBoxResources, sandBoxResult).c_str());
+
+	return true;
+}